@@ -0,0 +1,188 @@
+/**
+ * @file DelayRelay.cpp
+ *
+ * This module implements the Benchmark::DelayRelay class.
+ *
+ * © 2025 by Hatem Nabli
+ */
+
+#include "DelayRelay.hpp"
+#include <deque>
+#include <thread>
+#include <utility>
+#include <vector>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+
+namespace
+{
+    /**
+     * This function opens a TCP socket on the loopback interface, either
+     * listening on an ephemeral port or connected to the given port.
+     *
+     * @param[in] port
+     *      This is the port to connect to, or zero to listen.
+     * @return
+     *      The socket is returned, or -1 if it couldn't be opened.
+     */
+    int OpenLoopbackSocket(uint16_t port) {
+        const int sock = socket(AF_INET, SOCK_STREAM, 0);
+        if (sock < 0)
+        { return -1; }
+        struct sockaddr_in address = {};
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        address.sin_port = htons(port);
+        const bool opened =
+            ((port == 0)
+                 ? ((bind(sock, (const struct sockaddr*)&address, sizeof(address)) == 0) &&
+                    (listen(sock, SOMAXCONN) == 0))
+                 : (connect(sock, (const struct sockaddr*)&address, sizeof(address)) == 0));
+        if (!opened)
+        {
+            (void)close(sock);
+            return -1;
+        }
+        const int noDelay = 1;
+        (void)setsockopt(sock, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+        return sock;
+    }
+
+    /**
+     * This function relays data from one socket to another, holding back
+     * each chunk for the given time, until the first socket is closed
+     * and everything read from it has been relayed.
+     *
+     * @param[in] from
+     *      This is the socket from which to read.
+     * @param[in] to
+     *      This is the socket to which to write.
+     * @param[in] delay
+     *      This is how long each chunk is held back.
+     */
+    void Pump(int from, int to, std::chrono::microseconds delay) {
+        std::deque<std::pair<std::chrono::steady_clock::time_point, std::vector<uint8_t>>> queue;
+        bool open = true;
+        while (open || !queue.empty())
+        {
+            auto now = std::chrono::steady_clock::now();
+            while (!queue.empty() && (queue.front().first <= now))
+            {
+                const auto& chunk = queue.front().second;
+                size_t sent = 0;
+                while (sent < chunk.size())
+                {
+                    const auto amount = send(to, chunk.data() + sent, chunk.size() - sent,
+                                             MSG_NOSIGNAL);
+                    if (amount <= 0)
+                    { return; }
+                    sent += (size_t)amount;
+                }
+                queue.pop_front();
+            }
+            struct timespec timeout;
+            struct timespec* timeoutPointer = nullptr;
+            if (!queue.empty())
+            {
+                const auto wait = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    queue.front().first - now);
+                timeout.tv_sec = (time_t)(wait.count() / 1000000000);
+                timeout.tv_nsec = (long)(wait.count() % 1000000000);
+                timeoutPointer = &timeout;
+            }
+            if (!open)
+            {
+                (void)nanosleep(timeoutPointer, nullptr);
+                continue;
+            }
+            struct pollfd pending = {from, POLLIN, 0};
+            if (ppoll(&pending, 1, timeoutPointer, nullptr) <= 0)
+            { continue; }
+            std::vector<uint8_t> chunk(65536);
+            const auto amount = recv(from, chunk.data(), chunk.size(), 0);
+            if (amount <= 0)
+            {
+                open = false;
+                continue;
+            }
+            chunk.resize((size_t)amount);
+            queue.emplace_back(std::chrono::steady_clock::now() + delay, std::move(chunk));
+        }
+        (void)shutdown(to, SHUT_WR);
+    }
+}  // namespace
+
+namespace Benchmark
+{
+    struct DelayRelay::Impl
+    {
+        /**
+         * This is the socket on which the relay accepts connections.
+         */
+        int listener = -1;
+
+        /**
+         * This is the port on which the relay accepts connections.
+         */
+        uint16_t port = 0;
+
+        /**
+         * This is the thread accepting connections.
+         */
+        std::thread acceptThread;
+    };
+
+    DelayRelay::~DelayRelay() noexcept {
+        if (impl_->listener >= 0)
+        { (void)shutdown(impl_->listener, SHUT_RDWR); }
+        if (impl_->acceptThread.joinable())
+        { impl_->acceptThread.join(); }
+        if (impl_->listener >= 0)
+        { (void)close(impl_->listener); }
+    }
+
+    DelayRelay::DelayRelay(uint16_t targetPort, std::chrono::microseconds oneWayDelay) :
+        impl_(new Impl) {
+        impl_->listener = OpenLoopbackSocket(0);
+        if (impl_->listener < 0)
+        { return; }
+        struct sockaddr_in address = {};
+        socklen_t addressLength = sizeof(address);
+        (void)getsockname(impl_->listener, (struct sockaddr*)&address, &addressLength);
+        impl_->port = ntohs(address.sin_port);
+        const int listener = impl_->listener;
+        impl_->acceptThread = std::thread(
+            [listener, targetPort, oneWayDelay]
+            {
+                for (;;)
+                {
+                    const int client = accept(listener, nullptr, nullptr);
+                    if (client < 0)
+                    { return; }
+                    std::thread(
+                        [client, targetPort, oneWayDelay]
+                        {
+                            const int server = OpenLoopbackSocket(targetPort);
+                            if (server >= 0)
+                            {
+                                std::thread upstream(
+                                    [client, server, oneWayDelay]
+                                    { Pump(client, server, oneWayDelay); });
+                                Pump(server, client, oneWayDelay);
+                                upstream.join();
+                                (void)close(server);
+                            }
+                            (void)close(client);
+                        })
+                        .detach();
+                }
+            });
+    }
+
+    uint16_t DelayRelay::GetPort() const { return impl_->port; }
+}  // namespace Benchmark
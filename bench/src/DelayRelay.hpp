@@ -0,0 +1,70 @@
+#ifndef MQTT_NETWORK_TRANSPORT_BENCHMARK_DELAY_RELAY_HPP
+#define MQTT_NETWORK_TRANSPORT_BENCHMARK_DELAY_RELAY_HPP
+/**
+ * @file DelayRelay.hpp
+ *
+ * This module declares the Benchmark::DelayRelay class.
+ *
+ * © 2025 by Hatem Nabli
+ */
+
+#include <chrono>
+#include <memory>
+#include <stdint.h>
+
+namespace Benchmark
+{
+    /**
+     * This relays TCP connections made to a loopback port on to another
+     * loopback port, holding back the data relayed in each direction for
+     * a fixed time, so that local stand-ins can be measured as if they
+     * were across a network with the corresponding round trip time.
+     */
+    class DelayRelay
+    {
+        // Lifecycle management
+    public:
+        ~DelayRelay() noexcept;
+        DelayRelay(const DelayRelay&) = delete;
+        DelayRelay(DelayRelay&&) noexcept = delete;
+        DelayRelay& operator=(const DelayRelay&) = delete;
+        DelayRelay& operator=(DelayRelay&&) noexcept = delete;
+
+        // Public methods
+    public:
+        /**
+         * This is the constructor.
+         *
+         * @param[in] targetPort
+         *      This is the loopback port to which to relay connections.
+         * @param[in] oneWayDelay
+         *      This is how long data is held back in each direction.
+         */
+        DelayRelay(uint16_t targetPort, std::chrono::microseconds oneWayDelay);
+
+        /**
+         * This method returns the loopback port on which
+         * the relay accepts connections.
+         *
+         * @return
+         *      The port of the relay is returned.
+         */
+        uint16_t GetPort() const;
+
+        // Private properties
+    private:
+        /**
+         * This is the type of structure that contains the private
+         * properties of the instance.  It is defined in the implementation
+         * and declared here to ensure that it is scoped inside the class.
+         */
+        struct Impl;
+
+        /**
+         * This contains the private properties of the instance.
+         */
+        std::unique_ptr<Impl> impl_;
+    };
+}  // namespace Benchmark
+
+#endif /** MQTT_NETWORK_TRANSPORT_BENCHMARK_DELAY_RELAY_HPP */
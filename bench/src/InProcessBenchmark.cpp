@@ -0,0 +1,360 @@
+/**
+ * @file InProcessBenchmark.cpp
+ *
+ * This module contains a benchmark of "inproc" connections, compared with
+ * "unix" and "mqtt" connections to the same host.  Each connects to a
+ * local echo stand-in: for "inproc", one listening in the same process
+ * with ListenInProcess, and for the others, one on a socket.  The
+ * round-trip time of small messages is measured, and then the rate at
+ * which small messages are echoed when sent back to back.  Over sockets,
+ * messages sent back to back are read many at once, while "inproc"
+ * connections deliver each one separately, as sent.
+ *
+ * Usage: InProcessBenchmark [round trips] [messages]
+ *
+ * © 2025 by Hatem Nabli
+ */
+
+#include "Measurements.hpp"
+#include "SocketAddress.hpp"
+#include <MqttNetworkTransport/MqttClientNetworkTransport.hpp>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+#include <thread>
+#include <vector>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace
+{
+    /**
+     * This is the size of the messages sent.
+     */
+    constexpr size_t MESSAGE_SIZE = 64;
+
+    /**
+     * This is the name under which the in-process stand-in listens.
+     */
+    const std::string IN_PROCESS_NAME = "InProcessBenchmark";
+
+    /**
+     * This function writes all the given bytes.
+     *
+     * @param[in] sock
+     *      This is the socket to which to write.
+     * @param[in] buffer
+     *      This points to the bytes to write.
+     * @param[in] size
+     *      This is the number of bytes to write.
+     * @return
+     *      An indication of whether or not all the bytes were written
+     *      is returned.
+     */
+    bool WriteAll(int sock, const uint8_t* buffer, size_t size) {
+        while (size > 0)
+        {
+            const auto amount = send(sock, buffer, size, MSG_NOSIGNAL);
+            if (amount <= 0)
+            { return false; }
+            buffer += amount;
+            size -= (size_t)amount;
+        }
+        return true;
+    }
+
+    /**
+     * This function serves one connection of a socket echo stand-in,
+     * sending back everything received.
+     *
+     * @param[in] sock
+     *      This is the socket of the connection.
+     */
+    void ServeSocketEcho(int sock) {
+        std::vector<uint8_t> buffer(65536);
+        for (;;)
+        {
+            const auto amount = recv(sock, buffer.data(), buffer.size(), 0);
+            if ((amount <= 0) || !WriteAll(sock, buffer.data(), (size_t)amount))
+            { break; }
+        }
+        (void)close(sock);
+    }
+
+    /**
+     * This function starts accepting connections on the given socket,
+     * serving each with a socket echo stand-in.
+     *
+     * @param[in] listener
+     *      This is the socket on which the stand-in listens.
+     * @param[in] tcp
+     *      This indicates whether or not the socket is a TCP socket,
+     *      on which to disable Nagle's algorithm.
+     */
+    void StartSocketEcho(int listener, bool tcp) {
+        std::thread(
+            [listener, tcp]
+            {
+                for (;;)
+                {
+                    const int sock = accept(listener, nullptr, nullptr);
+                    if (sock < 0)
+                    { return; }
+                    if (tcp)
+                    {
+                        const int noDelay = 1;
+                        (void)setsockopt(sock, IPPROTO_TCP, TCP_NODELAY, &noDelay,
+                                         sizeof(noDelay));
+                    }
+                    std::thread(ServeSocketEcho, sock).detach();
+                }
+            })
+            .detach();
+    }
+
+    /**
+     * This function starts a socket echo stand-in on a loopback TCP port.
+     *
+     * @return
+     *      The port of the stand-in is returned,
+     *      or zero if it couldn't be started.
+     */
+    uint16_t StartTcpEcho() {
+        const int listener = socket(AF_INET, SOCK_STREAM, 0);
+        struct sockaddr_in address = {};
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        socklen_t addressLength = sizeof(address);
+        if ((bind(listener, (const struct sockaddr*)&address, sizeof(address)) != 0) ||
+            (listen(listener, SOMAXCONN) != 0) ||
+            (getsockname(listener, (struct sockaddr*)&address, &addressLength) != 0))
+        { return 0; }
+        StartSocketEcho(listener, true);
+        return ntohs(address.sin_port);
+    }
+
+    /**
+     * This function starts a socket echo stand-in on a Unix domain
+     * socket in the Linux abstract namespace.
+     *
+     * @param[in] path
+     *      This is the path of the socket, starting with '@'.
+     * @return
+     *      An indication of whether or not the stand-in
+     *      was started is returned.
+     */
+    bool StartUnixEcho(const std::string& path) {
+        const int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+        const auto address = MqttNetworkTransport::SocketAddress::FromUnixPath(path);
+        if ((bind(listener, address.Get(), address.length) != 0) ||
+            (listen(listener, SOMAXCONN) != 0))
+        { return false; }
+        StartSocketEcho(listener, false);
+        return true;
+    }
+
+    /**
+     * This holds what an echo stand-in has sent back so far.
+     */
+    struct Echoes
+    {
+        std::mutex mutex;
+        std::condition_variable condition;
+        size_t received = 0;
+    };
+
+    /**
+     * This holds the connections accepted by the in-process stand-in,
+     * which the stand-in keeps until they are broken.
+     */
+    struct InProcessEcho
+    {
+        std::mutex mutex;
+        std::vector<std::shared_ptr<MqttNetworkTransport::ZeroCopyConnection>> connections;
+    };
+
+    /**
+     * This function connects to an echo stand-in.
+     *
+     * @param[in] transport
+     *      This is the transport through which to connect.
+     * @param[in] scheme
+     *      This is the scheme with which to connect.
+     * @param[in] target
+     *      This is the address, path or name of the stand-in.
+     * @param[in] port
+     *      This is the port of the stand-in, if it is reached over TCP.
+     * @param[in] echoes
+     *      This is where to count what the stand-in sends back.
+     * @return
+     *      The connection is returned, or nullptr if it failed.
+     */
+    std::shared_ptr<MqttNetworkTransport::ZeroCopyConnection> ConnectToEcho(
+        MqttNetworkTransport::MqttClientNetworkTransport& transport, const char* scheme,
+        const std::string& target, uint16_t port, std::shared_ptr<Echoes> echoes) {
+        return std::dynamic_pointer_cast<MqttNetworkTransport::ZeroCopyConnection>(
+            transport.Connect(
+                scheme, target, port,
+                [echoes](const std::vector<uint8_t>& data)
+                {
+                    std::lock_guard<decltype(echoes->mutex)> lock(echoes->mutex);
+                    echoes->received += data.size();
+                    echoes->condition.notify_all();
+                },
+                [](bool graceful) {}));
+    }
+
+    /**
+     * This function times round trips of small messages through
+     * an echo stand-in, and reports them.
+     *
+     * @param[in] transport
+     *      This is the transport through which to connect.
+     * @param[in] scheme
+     *      This is the scheme with which to connect.
+     * @param[in] target
+     *      This is the address, path or name of the stand-in.
+     * @param[in] port
+     *      This is the port of the stand-in, if it is reached over TCP.
+     * @param[in] roundTrips
+     *      This is the number of round trips to time.
+     */
+    void MeasureRoundTrips(MqttNetworkTransport::MqttClientNetworkTransport& transport,
+                           const char* scheme, const std::string& target, uint16_t port,
+                           size_t roundTrips) {
+        const auto echoes = std::make_shared<Echoes>();
+        const auto connection = ConnectToEcho(transport, scheme, target, port, echoes);
+        if (connection == nullptr)
+        {
+            printf("%-32s unable to connect\n", scheme);
+            return;
+        }
+        std::vector<double> samples;
+        samples.reserve(roundTrips);
+        for (size_t i = 0; i < roundTrips; ++i)
+        {
+            const auto start = std::chrono::steady_clock::now();
+            connection->SendData(std::vector<uint8_t>(MESSAGE_SIZE, 0x5A));
+            std::unique_lock<decltype(echoes->mutex)> lock(echoes->mutex);
+            echoes->condition.wait(lock, [&echoes, i]
+                                   { return (echoes->received >= (i + 1) * MESSAGE_SIZE); });
+            samples.push_back(Benchmark::MicrosecondsSince(start));
+        }
+        connection->Break(true);
+        Benchmark::Report(scheme, samples);
+    }
+
+    /**
+     * This function sends small messages back to back through an echo
+     * stand-in, and reports the rate at which they are echoed.
+     *
+     * @param[in] transport
+     *      This is the transport through which to connect.
+     * @param[in] scheme
+     *      This is the scheme with which to connect.
+     * @param[in] target
+     *      This is the address, path or name of the stand-in.
+     * @param[in] port
+     *      This is the port of the stand-in, if it is reached over TCP.
+     * @param[in] messages
+     *      This is the number of messages to send.
+     */
+    void MeasureMessageRate(MqttNetworkTransport::MqttClientNetworkTransport& transport,
+                            const char* scheme, const std::string& target, uint16_t port,
+                            size_t messages) {
+        const auto echoes = std::make_shared<Echoes>();
+        const auto connection = ConnectToEcho(transport, scheme, target, port, echoes);
+        if (connection == nullptr)
+        {
+            printf("%-32s unable to connect\n", scheme);
+            return;
+        }
+        const size_t expected = messages * MESSAGE_SIZE;
+        const auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < messages; ++i)
+        { connection->SendData(std::vector<uint8_t>(MESSAGE_SIZE, 0x5A)); }
+        std::unique_lock<decltype(echoes->mutex)> lock(echoes->mutex);
+        if (echoes->condition.wait_for(lock, std::chrono::seconds(60),
+                                       [&echoes, expected]
+                                       { return (echoes->received >= expected); }))
+        {
+            printf("%-32s %10.0f messages/s\n", scheme,
+                   messages * 1e6 / Benchmark::MicrosecondsSince(start));
+        } else
+        { printf("%-32s echoes didn't all arrive\n", scheme); }
+        lock.unlock();
+        connection->Break(true);
+    }
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    const size_t roundTrips = ((argc > 1) ? (size_t)atoi(argv[1]) : 20000);
+    const size_t messages = ((argc > 2) ? (size_t)atoi(argv[2]) : 200000);
+    (void)signal(SIGPIPE, SIG_IGN);
+    const std::string unixPath = "@InProcessBenchmark-" + std::to_string(getpid());
+    const auto tcpPort = StartTcpEcho();
+    if ((tcpPort == 0) || !StartUnixEcho(unixPath))
+    {
+        fprintf(stderr, "unable to start the stand-ins\n");
+        return EXIT_FAILURE;
+    }
+    MqttNetworkTransport::MqttClientNetworkTransport broker;
+    MqttNetworkTransport::MqttClientNetworkTransport transport;
+    MqttNetworkTransport::MqttClientNetworkTransport::Configuration configuration;
+    configuration.reactorLoopCount = 1;
+    broker.Configure(configuration);
+    transport.Configure(configuration);
+    const auto inProcessEcho = std::make_shared<InProcessEcho>();
+    const auto stopListening = broker.ListenInProcess(
+        IN_PROCESS_NAME,
+        [inProcessEcho](std::shared_ptr<MqttNetworkTransport::ZeroCopyConnection> connection)
+        {
+            std::weak_ptr<MqttNetworkTransport::ZeroCopyConnection> connectionWeak(connection);
+            connection->SetDataReceivedDelegate(
+                [connectionWeak](const std::vector<uint8_t>& data)
+                {
+                    const auto connection = connectionWeak.lock();
+                    if (connection != nullptr)
+                    { connection->SendData(std::vector<uint8_t>(data)); }
+                });
+            connection->SetConnectionBrokenDelegate(
+                [inProcessEcho, connectionWeak](bool graceful)
+                {
+                    std::lock_guard<decltype(inProcessEcho->mutex)> lock(inProcessEcho->mutex);
+                    auto& connections = inProcessEcho->connections;
+                    for (auto it = connections.begin(); it != connections.end(); ++it)
+                    {
+                        if (*it == connectionWeak.lock())
+                        {
+                            (void)connections.erase(it);
+                            break;
+                        }
+                    }
+                });
+            std::lock_guard<decltype(inProcessEcho->mutex)> lock(inProcessEcho->mutex);
+            inProcessEcho->connections.push_back(connection);
+        });
+    if (stopListening == nullptr)
+    {
+        fprintf(stderr, "unable to listen in process\n");
+        return EXIT_FAILURE;
+    }
+    printf("round trips of %zu-byte messages\n", MESSAGE_SIZE);
+    MeasureRoundTrips(transport, "inproc", IN_PROCESS_NAME, 0, roundTrips);
+    MeasureRoundTrips(transport, "unix", unixPath, 0, roundTrips);
+    MeasureRoundTrips(transport, "mqtt", "127.0.0.1", tcpPort, roundTrips);
+    printf("%zu %zu-byte messages echoed back to back\n", messages, MESSAGE_SIZE);
+    MeasureMessageRate(transport, "inproc", IN_PROCESS_NAME, 0, messages);
+    MeasureMessageRate(transport, "unix", unixPath, 0, messages);
+    MeasureMessageRate(transport, "mqtt", "127.0.0.1", tcpPort, messages);
+    stopListening();
+    return EXIT_SUCCESS;
+}
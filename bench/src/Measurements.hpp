@@ -0,0 +1,61 @@
+#ifndef MQTT_NETWORK_TRANSPORT_BENCHMARK_MEASUREMENTS_HPP
+#define MQTT_NETWORK_TRANSPORT_BENCHMARK_MEASUREMENTS_HPP
+/**
+ * @file Measurements.hpp
+ *
+ * This module declares helpers shared by the benchmarks for
+ * summarizing and reporting what they measure.
+ *
+ * © 2025 by Hatem Nabli
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <stddef.h>
+#include <stdio.h>
+#include <vector>
+
+namespace Benchmark
+{
+    /**
+     * This returns the number of microseconds elapsed since the given time.
+     *
+     * @param[in] start
+     *      This is the time from which to measure.
+     * @return
+     *      The number of microseconds elapsed is returned.
+     */
+    inline double MicrosecondsSince(std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() -
+                                                         start)
+            .count();
+    }
+
+    /**
+     * This prints one line summarizing the given samples:
+     * their count, mean, median, 99th percentile and maximum.
+     *
+     * @param[in] label
+     *      This identifies what was measured.
+     * @param[in] samples
+     *      These are the measurements, in microseconds.
+     */
+    inline void Report(const char* label, std::vector<double> samples) {
+        if (samples.empty())
+        {
+            printf("%-32s no samples\n", label);
+            return;
+        }
+        std::sort(samples.begin(), samples.end());
+        double total = 0.0;
+        for (const auto sample : samples)
+        { total += sample; }
+        const auto percentile = [&samples](double fraction)
+        { return samples[std::min(samples.size() - 1, (size_t)(fraction * samples.size()))]; };
+        printf("%-32s n=%-6zu mean=%10.1f us  p50=%10.1f us  p99=%10.1f us  max=%10.1f us\n",
+               label, samples.size(), total / samples.size(), percentile(0.50),
+               percentile(0.99), samples.back());
+    }
+}  // namespace Benchmark
+
+#endif /** MQTT_NETWORK_TRANSPORT_BENCHMARK_MEASUREMENTS_HPP */
@@ -0,0 +1,300 @@
+/**
+ * @file ProbingBenchmark.cpp
+ *
+ * This module contains a benchmark of latency-aware broker selection by
+ * FailoverTransport.  A group of brokers of equal priority is set up,
+ * each a local stand-in reached through a relay with a different round
+ * trip time.  Sessions are connected to the group repeatedly, each
+ * sending CONNECT and then a PINGREQ, and the time until the CONNACK
+ * arrives and the PINGREQ round trip are measured, first with the
+ * brokers chosen by weighted round robin and then with PINGREQ round
+ * trips measured to steer the choice.  The relays complete TCP
+ * handshakes locally, so background TCP probes can't tell the brokers
+ * apart here and aren't measured.
+ *
+ * Usage: ProbingBenchmark [sessions] [fastest round trip ms]
+ *
+ * © 2025 by Hatem Nabli
+ */
+
+#include "DelayRelay.hpp"
+#include "Measurements.hpp"
+#include <MqttNetworkTransport/FailoverTransport.hpp>
+#include <MqttNetworkTransport/MqttClientNetworkTransport.hpp>
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+#include <thread>
+#include <vector>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace
+{
+    /**
+     * This is a minimal MQTT 5 CONNECT packet.
+     */
+    const std::vector<uint8_t> CONNECT{0x10, 0x0D, 0x00, 0x04, 'M',  'Q',  'T', 'T',
+                                       0x05, 0x02, 0x00, 0x3C, 0x00, 0x00, 0x00};
+
+    /**
+     * This is the CONNACK packet with which the stand-in broker
+     * answers every CONNECT.
+     */
+    const std::vector<uint8_t> CONNACK{0x20, 0x03, 0x00, 0x00, 0x00};
+
+    /**
+     * These are the PINGREQ packet and the PINGRESP packet
+     * with which the stand-in broker answers it.
+     */
+    const std::vector<uint8_t> PINGREQ{0xC0, 0x00};
+    const std::vector<uint8_t> PINGRESP{0xD0, 0x00};
+
+    /**
+     * These are the round trip times of the brokers, as multiples of
+     * the fastest one.  The slowest broker is listed first.
+     */
+    const std::vector<int> ROUND_TRIP_MULTIPLES{4, 2, 1};
+
+    /**
+     * This function serves one connection of the stand-in broker,
+     * answering each CONNECT with a CONNACK and each PINGREQ with
+     * a PINGRESP.  Packets are assumed to be shorter than 128 bytes.
+     *
+     * @param[in] sock
+     *      This is the socket of the connection.
+     */
+    void ServeBrokerConnection(int sock) {
+        std::vector<uint8_t> received;
+        uint8_t buffer[256];
+        ssize_t amount;
+        while ((amount = recv(sock, buffer, sizeof(buffer), 0)) > 0)
+        {
+            received.insert(received.end(), buffer, buffer + amount);
+            while ((received.size() >= 2) && (received.size() >= 2 + (size_t)received[1]))
+            {
+                const auto type = received[0];
+                received.erase(received.begin(), received.begin() + 2 + received[1]);
+                const auto& answer = ((type == CONNECT[0]) ? CONNACK : PINGRESP);
+                if ((type == CONNECT[0]) || (type == PINGREQ[0]))
+                { (void)send(sock, answer.data(), answer.size(), MSG_NOSIGNAL); }
+            }
+        }
+        (void)close(sock);
+    }
+
+    /**
+     * This function starts the stand-in broker on a loopback port.
+     *
+     * @return
+     *      The port of the stand-in broker is returned,
+     *      or zero if it couldn't be started.
+     */
+    uint16_t StartBroker() {
+        const int listener = socket(AF_INET, SOCK_STREAM, 0);
+        struct sockaddr_in address = {};
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        socklen_t addressLength = sizeof(address);
+        if ((bind(listener, (const struct sockaddr*)&address, sizeof(address)) != 0) ||
+            (listen(listener, SOMAXCONN) != 0) ||
+            (getsockname(listener, (struct sockaddr*)&address, &addressLength) != 0))
+        { return 0; }
+        std::thread(
+            [listener]
+            {
+                for (;;)
+                {
+                    const int sock = accept(listener, nullptr, nullptr);
+                    if (sock < 0)
+                    { return; }
+                    std::thread(ServeBrokerConnection, sock).detach();
+                }
+            })
+            .detach();
+        return ntohs(address.sin_port);
+    }
+
+    /**
+     * This holds the packets received on a session, for the benchmark
+     * to wait for them.
+     */
+    struct Inbox
+    {
+        /**
+         * This is used to synchronize access to the inbox.
+         */
+        std::mutex mutex;
+
+        /**
+         * This is used to wait for packets to arrive.
+         */
+        std::condition_variable wakeCondition;
+
+        /**
+         * These are the first bytes of the packets received, in order.
+         */
+        std::vector<uint8_t> types;
+
+        /**
+         * This method waits for a packet of the given type to arrive.
+         *
+         * @param[in] type
+         *      This is the first byte of the packet for which to wait.
+         * @return
+         *      An indication of whether or not the packet arrived
+         *      is returned.
+         */
+        bool WaitFor(uint8_t type) {
+            std::unique_lock<decltype(mutex)> lock(mutex);
+            return wakeCondition.wait_for(
+                lock, std::chrono::seconds(5),
+                [this, type]
+                {
+                    for (size_t i = 0; i < types.size(); ++i)
+                    {
+                        if (types[i] == type)
+                        {
+                            (void)types.erase(types.begin() + i);
+                            return true;
+                        }
+                    }
+                    return false;
+                });
+        }
+    };
+
+    /**
+     * This function connects a session to the group of brokers, sends
+     * CONNECT and waits for the CONNACK, sends PINGREQ and waits for
+     * the PINGRESP, and then closes the session.
+     *
+     * @param[in] transport
+     *      This is the transport through which to connect.
+     * @param[out] connectTime
+     *      This is where to store the number of microseconds from
+     *      starting to connect until the CONNACK arrived.
+     * @param[out] pingTime
+     *      This is where to store the number of microseconds from
+     *      sending PINGREQ until the PINGRESP arrived.
+     * @return
+     *      The identifier of the broker to which the session connected
+     *      is returned, or an empty string if the session failed.
+     */
+    std::string RunSession(MqttNetworkTransport::FailoverTransport& transport,
+                           double& connectTime, double& pingTime) {
+        const auto inbox = std::make_shared<Inbox>();
+        const auto start = std::chrono::steady_clock::now();
+        const auto connection = transport.Connect(
+            "mqtt", "brokers", 0,
+            [inbox](const std::vector<uint8_t>& data)
+            {
+                if (data.empty())
+                { return; }
+                std::lock_guard<decltype(inbox->mutex)> lock(inbox->mutex);
+                inbox->types.push_back(data[0]);
+                inbox->wakeCondition.notify_all();
+            },
+            [](bool) {});
+        if (connection == nullptr)
+        { return ""; }
+        connection->SendData(CONNECT);
+        if (!inbox->WaitFor(CONNACK[0]))
+        { return ""; }
+        connectTime = Benchmark::MicrosecondsSince(start);
+        const auto pingStart = std::chrono::steady_clock::now();
+        connection->SendData(PINGREQ);
+        if (!inbox->WaitFor(PINGRESP[0]))
+        { return ""; }
+        pingTime = Benchmark::MicrosecondsSince(pingStart);
+        const auto peerId = connection->GetPeerId();
+        connection->Break(true);
+        return peerId;
+    }
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    const int sessions = ((argc > 1) ? atoi(argv[1]) : 60);
+    const int roundTripMilliseconds = ((argc > 2) ? atoi(argv[2]) : 5);
+    (void)signal(SIGPIPE, SIG_IGN);
+    const auto brokerPort = StartBroker();
+    if (brokerPort == 0)
+    {
+        fprintf(stderr, "unable to start the stand-in broker\n");
+        return EXIT_FAILURE;
+    }
+    std::vector<std::unique_ptr<Benchmark::DelayRelay>> relays;
+    std::vector<MqttNetworkTransport::FailoverTransport::Endpoint> endpoints;
+    std::map<std::string, int> roundTripsByPeer;
+    for (const auto multiple : ROUND_TRIP_MULTIPLES)
+    {
+        relays.emplace_back(new Benchmark::DelayRelay(
+            brokerPort, std::chrono::microseconds(roundTripMilliseconds * multiple * 1000 / 2)));
+        MqttNetworkTransport::FailoverTransport::Endpoint endpoint;
+        endpoint.hostNameOrAddress = "127.0.0.1";
+        endpoint.port = relays.back()->GetPort();
+        endpoints.push_back(endpoint);
+        roundTripsByPeer["127.0.0.1:" + std::to_string(endpoint.port)] =
+            roundTripMilliseconds * multiple;
+    }
+    printf("%d sessions, brokers with %d, %d and %d ms round trips\n", sessions,
+           roundTripMilliseconds * ROUND_TRIP_MULTIPLES[0],
+           roundTripMilliseconds * ROUND_TRIP_MULTIPLES[1],
+           roundTripMilliseconds * ROUND_TRIP_MULTIPLES[2]);
+    const auto inner = std::make_shared<MqttNetworkTransport::MqttClientNetworkTransport>();
+    MqttNetworkTransport::MqttClientNetworkTransport::Configuration innerConfiguration;
+    innerConfiguration.reactorLoopCount = 1;
+    innerConfiguration.receiveFraming =
+        MqttNetworkTransport::MqttClientNetworkTransport::ReceiveFraming::Packet;
+    inner->Configure(innerConfiguration);
+    for (const bool sessionPings : {false, true})
+    {
+        MqttNetworkTransport::FailoverTransport transport(inner);
+        MqttNetworkTransport::FailoverTransport::Configuration configuration;
+        configuration.probeSessionPings = sessionPings;
+        transport.Configure(configuration);
+        transport.SetEndpoints("brokers", endpoints);
+        std::vector<double> connectTimes;
+        std::vector<double> pingTimes;
+        std::map<int, int> sessionsByRoundTrip;
+        for (int i = 0; i < sessions; ++i)
+        {
+            double connectTime = 0.0;
+            double pingTime = 0.0;
+            const auto peerId = RunSession(transport, connectTime, pingTime);
+            if (peerId.empty())
+            { continue; }
+            connectTimes.push_back(connectTime);
+            pingTimes.push_back(pingTime);
+            ++sessionsByRoundTrip[roundTripsByPeer[peerId]];
+        }
+        const auto label = (sessionPings ? "session pings" : "round robin");
+        printf("%s:\n", label);
+        Benchmark::Report("  connect to CONNACK", connectTimes);
+        Benchmark::Report("  PINGREQ round trip", pingTimes);
+        for (const auto& sessionsForRoundTrip : sessionsByRoundTrip)
+        {
+            printf("  %d ms broker chosen %d times\n", sessionsForRoundTrip.first,
+                   sessionsForRoundTrip.second);
+        }
+        if (sessionPings)
+        {
+            for (const auto& status : transport.GetEndpointStatus("brokers"))
+            {
+                printf("  %d ms broker smoothed round trip %llu us from %llu samples\n",
+                       roundTripsByPeer["127.0.0.1:" + std::to_string(status.endpoint.port)],
+                       (unsigned long long)status.smoothedRttMicroseconds,
+                       (unsigned long long)status.rttSamples);
+            }
+        }
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,470 @@
+/**
+ * @file SharedMemoryBenchmark.cpp
+ *
+ * This module contains a benchmark of "shm" connections, compared with
+ * "unix" and "mqtt" connections to the same host.  Each connects to a
+ * local echo stand-in; the round-trip time of small messages is
+ * measured, and then the throughput of large ones.  The "shm" stand-in
+ * implements the peer side of the protocol described in
+ * SharedMemoryNetworkConnection.hpp, polling its ring for a while
+ * before sleeping, as a broker might.
+ *
+ * Usage: SharedMemoryBenchmark [round trips] [megabytes]
+ *
+ * © 2025 by Hatem Nabli
+ */
+
+#include "Measurements.hpp"
+#include "SharedMemoryRing.hpp"
+#include "SocketAddress.hpp"
+#include <MqttNetworkTransport/MqttClientNetworkTransport.hpp>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <thread>
+#include <vector>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace
+{
+    /**
+     * This is the size of the messages whose round trips are timed.
+     */
+    constexpr size_t SMALL_MESSAGE_SIZE = 64;
+
+    /**
+     * This is the size of the messages whose throughput is measured.
+     */
+    constexpr size_t LARGE_MESSAGE_SIZE = 16384;
+
+    /**
+     * This is how long the "shm" stand-in, and the connections made to
+     * it when polling is measured, keep polling before sleeping,
+     * in microseconds.
+     */
+    constexpr uint32_t SPIN_MICROSECONDS = 20;
+
+    /**
+     * This function writes all the given bytes.
+     *
+     * @param[in] sock
+     *      This is the socket to which to write.
+     * @param[in] buffer
+     *      This points to the bytes to write.
+     * @param[in] size
+     *      This is the number of bytes to write.
+     * @return
+     *      An indication of whether or not all the bytes were written
+     *      is returned.
+     */
+    bool WriteAll(int sock, const uint8_t* buffer, size_t size) {
+        while (size > 0)
+        {
+            const auto amount = send(sock, buffer, size, MSG_NOSIGNAL);
+            if (amount <= 0)
+            { return false; }
+            buffer += amount;
+            size -= (size_t)amount;
+        }
+        return true;
+    }
+
+    /**
+     * This function serves one connection of a socket echo stand-in,
+     * sending back everything received.
+     *
+     * @param[in] sock
+     *      This is the socket of the connection.
+     */
+    void ServeSocketEcho(int sock) {
+        std::vector<uint8_t> buffer(65536);
+        for (;;)
+        {
+            const auto amount = recv(sock, buffer.data(), buffer.size(), 0);
+            if ((amount <= 0) || !WriteAll(sock, buffer.data(), (size_t)amount))
+            { break; }
+        }
+        (void)close(sock);
+    }
+
+    /**
+     * This function receives the handshake of a "shm" connection
+     * and accepts it.
+     *
+     * @param[in] sock
+     *      This is the socket of the connection.
+     * @param[out] fds
+     *      This is where to store the memory file and the eventfd
+     *      objects received.
+     * @param[out] capacity
+     *      This is where to store the capacity of each ring.
+     * @return
+     *      An indication of whether or not the handshake
+     *      was well formed is returned.
+     */
+    bool AcceptSharedMemory(int sock, int fds[3], uint32_t& capacity) {
+        uint8_t request[12];
+        struct iovec vector;
+        vector.iov_base = request;
+        vector.iov_len = sizeof(request);
+        union
+        {
+            struct cmsghdr header;
+            char buffer[CMSG_SPACE(3 * sizeof(int))];
+        } control;
+        struct msghdr header;
+        (void)memset(&header, 0, sizeof(header));
+        header.msg_iov = &vector;
+        header.msg_iovlen = 1;
+        header.msg_control = control.buffer;
+        header.msg_controllen = sizeof(control.buffer);
+        if ((recvmsg(sock, &header, 0) != (ssize_t)sizeof(request)) ||
+            (memcmp(request, "MQTTSHM1", 8) != 0))
+        { return false; }
+        (void)memcpy(&capacity, request + 8, sizeof(capacity));
+        const auto rights = CMSG_FIRSTHDR(&header);
+        if ((rights == nullptr) || (rights->cmsg_type != SCM_RIGHTS) ||
+            (rights->cmsg_len != CMSG_LEN(3 * sizeof(int))))
+        { return false; }
+        (void)memcpy(fds, CMSG_DATA(rights), 3 * sizeof(int));
+        const uint8_t accepted = 1;
+        return WriteAll(sock, &accepted, sizeof(accepted));
+    }
+
+    /**
+     * This function serves one connection of the "shm" echo stand-in,
+     * copying everything from the ring of data received into the ring
+     * of data sent, until the connection is closed.
+     *
+     * @param[in] sock
+     *      This is the socket of the connection.
+     */
+    void ServeSharedMemoryEcho(int sock) {
+        int fds[3] = {-1, -1, -1};
+        uint32_t capacity = 0;
+        if (!AcceptSharedMemory(sock, fds, capacity))
+        {
+            (void)close(sock);
+            return;
+        }
+        const auto ringSize = MqttNetworkTransport::SharedMemoryRing::GetSize(capacity);
+        const auto memory =
+            mmap(nullptr, 2 * ringSize, PROT_READ | PROT_WRITE, MAP_SHARED, fds[0], 0);
+        if (memory != MAP_FAILED)
+        {
+            MqttNetworkTransport::SharedMemoryRing in(memory, capacity, false);
+            MqttNetworkTransport::SharedMemoryRing out((uint8_t*)memory + ringSize, capacity,
+                                                       false);
+            const uint64_t increment = 1;
+            std::vector<uint8_t> buffer(capacity);
+            size_t pending = 0;
+            size_t offset = 0;
+            auto idleSince = std::chrono::steady_clock::now();
+            for (;;)
+            {
+                bool progress = false;
+                if (pending == 0)
+                {
+                    pending = std::min(in.GetAvailable(), buffer.size());
+                    if (pending > 0)
+                    {
+                        in.Read(buffer.data(), pending);
+                        offset = 0;
+                        progress = true;
+                        if (in.ShouldWakeProducer())
+                        { (void)write(fds[2], &increment, sizeof(increment)); }
+                    }
+                }
+                if (pending > 0)
+                {
+                    const auto written = out.Write(buffer.data() + offset, pending);
+                    if (written > 0)
+                    {
+                        offset += written;
+                        pending -= written;
+                        progress = true;
+                        if (out.ShouldWakeConsumer())
+                        { (void)write(fds[2], &increment, sizeof(increment)); }
+                    }
+                }
+                if (progress)
+                {
+                    idleSince = std::chrono::steady_clock::now();
+                    continue;
+                }
+                if (Benchmark::MicrosecondsSince(idleSince) < SPIN_MICROSECONDS)
+                { continue; }
+                const bool waitForData = ((pending > 0) || in.PrepareToWaitForData());
+                const bool waitForSpace = ((pending == 0) || out.PrepareToWaitForSpace());
+                if (!waitForData || !waitForSpace)
+                { continue; }
+                struct pollfd events[2] = {{fds[1], POLLIN, 0}, {sock, POLLIN | POLLRDHUP, 0}};
+                (void)poll(events, 2, -1);
+                if (events[0].revents != 0)
+                {
+                    uint64_t count;
+                    (void)read(fds[1], &count, sizeof(count));
+                }
+                if (events[1].revents != 0)
+                { break; }
+                idleSince = std::chrono::steady_clock::now();
+            }
+            (void)munmap(memory, 2 * ringSize);
+        }
+        for (const auto fd : fds)
+        { (void)close(fd); }
+        (void)close(sock);
+    }
+
+    /**
+     * This function starts a stand-in listening on the given socket.
+     *
+     * @param[in] listener
+     *      This is the socket on which the stand-in listens.
+     * @param[in] serve
+     *      This is the function which serves each connection.
+     */
+    void StartStandIn(int listener, void (*serve)(int sock)) {
+        std::thread(
+            [listener, serve]
+            {
+                for (;;)
+                {
+                    const int sock = accept(listener, nullptr, nullptr);
+                    if (sock < 0)
+                    { return; }
+                    std::thread(serve, sock).detach();
+                }
+            })
+            .detach();
+    }
+
+    /**
+     * This function starts a socket echo stand-in on a loopback TCP port.
+     *
+     * @return
+     *      The port of the stand-in is returned,
+     *      or zero if it couldn't be started.
+     */
+    uint16_t StartTcpStandIn() {
+        const int listener = socket(AF_INET, SOCK_STREAM, 0);
+        struct sockaddr_in address = {};
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        socklen_t addressLength = sizeof(address);
+        if ((bind(listener, (const struct sockaddr*)&address, sizeof(address)) != 0) ||
+            (listen(listener, SOMAXCONN) != 0) ||
+            (getsockname(listener, (struct sockaddr*)&address, &addressLength) != 0))
+        { return 0; }
+        StartStandIn(listener,
+                     [](int sock)
+                     {
+                         const int noDelay = 1;
+                         (void)setsockopt(sock, IPPROTO_TCP, TCP_NODELAY, &noDelay,
+                                          sizeof(noDelay));
+                         ServeSocketEcho(sock);
+                     });
+        return ntohs(address.sin_port);
+    }
+
+    /**
+     * This function starts a stand-in on a Unix domain socket in the
+     * Linux abstract namespace.
+     *
+     * @param[in] path
+     *      This is the path of the socket, starting with '@'.
+     * @param[in] serve
+     *      This is the function which serves each connection.
+     * @return
+     *      An indication of whether or not the stand-in
+     *      was started is returned.
+     */
+    bool StartUnixStandIn(const std::string& path, void (*serve)(int sock)) {
+        const int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+        const auto address = MqttNetworkTransport::SocketAddress::FromUnixPath(path);
+        if ((bind(listener, address.Get(), address.length) != 0) ||
+            (listen(listener, SOMAXCONN) != 0))
+        { return false; }
+        StartStandIn(listener, serve);
+        return true;
+    }
+
+    /**
+     * This holds what an echo stand-in has sent back so far.
+     */
+    struct Echoes
+    {
+        std::mutex mutex;
+        std::condition_variable condition;
+        size_t received = 0;
+    };
+
+    /**
+     * This function connects to an echo stand-in.
+     *
+     * @param[in] transport
+     *      This is the transport through which to connect.
+     * @param[in] scheme
+     *      This is the scheme with which to connect.
+     * @param[in] target
+     *      This is the address or path of the stand-in.
+     * @param[in] port
+     *      This is the port of the stand-in, if it is reached over TCP.
+     * @param[in] echoes
+     *      This is where to count what the stand-in sends back.
+     * @return
+     *      The connection is returned, or nullptr if it failed.
+     */
+    std::shared_ptr<MqttV5::Connection> ConnectToEcho(
+        MqttNetworkTransport::MqttClientNetworkTransport& transport, const char* scheme,
+        const std::string& target, uint16_t port, std::shared_ptr<Echoes> echoes) {
+        return transport.Connect(
+            scheme, target, port,
+            [echoes](const std::vector<uint8_t>& data)
+            {
+                std::lock_guard<decltype(echoes->mutex)> lock(echoes->mutex);
+                echoes->received += data.size();
+                echoes->condition.notify_all();
+            },
+            [](bool graceful) {});
+    }
+
+    /**
+     * This function times round trips of small messages through
+     * an echo stand-in, and reports them.
+     *
+     * @param[in] label
+     *      This identifies what is measured.
+     * @param[in] transport
+     *      This is the transport through which to connect.
+     * @param[in] scheme
+     *      This is the scheme with which to connect.
+     * @param[in] target
+     *      This is the address or path of the stand-in.
+     * @param[in] port
+     *      This is the port of the stand-in, if it is reached over TCP.
+     * @param[in] roundTrips
+     *      This is the number of round trips to time.
+     */
+    void MeasureRoundTrips(const char* label,
+                           MqttNetworkTransport::MqttClientNetworkTransport& transport,
+                           const char* scheme, const std::string& target, uint16_t port,
+                           size_t roundTrips) {
+        const auto echoes = std::make_shared<Echoes>();
+        const auto connection = ConnectToEcho(transport, scheme, target, port, echoes);
+        if (connection == nullptr)
+        {
+            printf("%-32s unable to connect\n", label);
+            return;
+        }
+        const std::vector<uint8_t> message(SMALL_MESSAGE_SIZE, 0x5A);
+        std::vector<double> samples;
+        samples.reserve(roundTrips);
+        for (size_t i = 0; i < roundTrips; ++i)
+        {
+            const auto start = std::chrono::steady_clock::now();
+            connection->SendData(message);
+            std::unique_lock<decltype(echoes->mutex)> lock(echoes->mutex);
+            echoes->condition.wait(lock, [&echoes, i]
+                                   { return (echoes->received >= (i + 1) * SMALL_MESSAGE_SIZE); });
+            samples.push_back(Benchmark::MicrosecondsSince(start));
+        }
+        connection->Break(true);
+        Benchmark::Report(label, samples);
+    }
+
+    /**
+     * This function sends large messages through an echo stand-in
+     * until the given number of bytes has gone both ways, and
+     * reports the throughput.
+     *
+     * @param[in] label
+     *      This identifies what is measured.
+     * @param[in] transport
+     *      This is the transport through which to connect.
+     * @param[in] scheme
+     *      This is the scheme with which to connect.
+     * @param[in] target
+     *      This is the address or path of the stand-in.
+     * @param[in] port
+     *      This is the port of the stand-in, if it is reached over TCP.
+     * @param[in] totalBytes
+     *      This is the number of bytes to send in all.
+     */
+    void MeasureThroughput(const char* label,
+                           MqttNetworkTransport::MqttClientNetworkTransport& transport,
+                           const char* scheme, const std::string& target, uint16_t port,
+                           size_t totalBytes) {
+        const auto echoes = std::make_shared<Echoes>();
+        const auto connection = ConnectToEcho(transport, scheme, target, port, echoes);
+        if (connection == nullptr)
+        {
+            printf("%-32s unable to connect\n", label);
+            return;
+        }
+        const size_t messages = std::max<size_t>(1, totalBytes / LARGE_MESSAGE_SIZE);
+        const size_t expected = messages * LARGE_MESSAGE_SIZE;
+        const std::vector<uint8_t> message(LARGE_MESSAGE_SIZE, 0x5A);
+        const auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < messages; ++i)
+        { connection->SendData(message); }
+        std::unique_lock<decltype(echoes->mutex)> lock(echoes->mutex);
+        if (echoes->condition.wait_for(lock, std::chrono::seconds(60),
+                                       [&echoes, expected]
+                                       { return (echoes->received >= expected); }))
+        { printf("%-32s %10.1f MB/s\n", label, expected / Benchmark::MicrosecondsSince(start)); } else
+        { printf("%-32s echoes didn't all arrive\n", label); }
+        lock.unlock();
+        connection->Break(true);
+    }
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    const size_t roundTrips = ((argc > 1) ? (size_t)atoi(argv[1]) : 20000);
+    const size_t megabytes = ((argc > 2) ? (size_t)atoi(argv[2]) : 256);
+    (void)signal(SIGPIPE, SIG_IGN);
+    const std::string suffix = std::to_string(getpid());
+    const std::string unixPath = "@SharedMemoryBenchmark-unix-" + suffix;
+    const std::string sharedMemoryPath = "@SharedMemoryBenchmark-shm-" + suffix;
+    const auto tcpPort = StartTcpStandIn();
+    if ((tcpPort == 0) || !StartUnixStandIn(unixPath, ServeSocketEcho) ||
+        !StartUnixStandIn(sharedMemoryPath, ServeSharedMemoryEcho))
+    {
+        fprintf(stderr, "unable to start the stand-ins\n");
+        return EXIT_FAILURE;
+    }
+    MqttNetworkTransport::MqttClientNetworkTransport sleeping;
+    MqttNetworkTransport::MqttClientNetworkTransport spinning;
+    MqttNetworkTransport::MqttClientNetworkTransport::Configuration configuration;
+    configuration.reactorLoopCount = 1;
+    configuration.sharedMemorySpinMicroseconds = 0;
+    sleeping.Configure(configuration);
+    configuration.sharedMemorySpinMicroseconds = SPIN_MICROSECONDS;
+    spinning.Configure(configuration);
+    printf("round trips of %zu-byte messages\n", SMALL_MESSAGE_SIZE);
+    MeasureRoundTrips("mqtt", sleeping, "mqtt", "127.0.0.1", tcpPort, roundTrips);
+    MeasureRoundTrips("unix", sleeping, "unix", unixPath, 0, roundTrips);
+    MeasureRoundTrips("shm (no polling)", sleeping, "shm", sharedMemoryPath, 0, roundTrips);
+    MeasureRoundTrips("shm (polling)", spinning, "shm", sharedMemoryPath, 0, roundTrips);
+    printf("throughput of %zu-byte messages, %zu MB echoed\n", LARGE_MESSAGE_SIZE, megabytes);
+    MeasureThroughput("mqtt", sleeping, "mqtt", "127.0.0.1", tcpPort, megabytes << 20);
+    MeasureThroughput("unix", sleeping, "unix", unixPath, 0, megabytes << 20);
+    MeasureThroughput("shm (no polling)", sleeping, "shm", sharedMemoryPath, 0,
+                      megabytes << 20);
+    MeasureThroughput("shm (polling)", spinning, "shm", sharedMemoryPath, 0, megabytes << 20);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,292 @@
+/**
+ * @file TlsEarlyDataBenchmark.cpp
+ *
+ * This module contains a benchmark of reconnecting to a broker over TLS,
+ * measuring the time from starting to connect until the CONNACK arrives,
+ * with and without the CONNECT packet sent as TLS 1.3 early data.  The
+ * broker is a local stand-in which answers each CONNECT with a CONNACK,
+ * reached through a relay which delays traffic to simulate a network
+ * round trip.
+ *
+ * Usage: TlsEarlyDataBenchmark [reconnects] [round trip milliseconds]
+ *
+ * © 2025 by Hatem Nabli
+ */
+
+#include "DelayRelay.hpp"
+#include "Measurements.hpp"
+#include <MqttNetworkTransport/MqttClientNetworkTransport.hpp>
+#include <chrono>
+#include <future>
+#include <memory>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+#include <thread>
+#include <vector>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <openssl/ec.h>
+#include <openssl/evp.h>
+#include <openssl/pem.h>
+#include <openssl/ssl.h>
+#include <openssl/x509v3.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace
+{
+    /**
+     * This is a minimal MQTT 5 CONNECT packet.
+     */
+    const std::vector<uint8_t> CONNECT{0x10, 0x0D, 0x00, 0x04, 'M',  'Q',  'T', 'T',
+                                       0x05, 0x02, 0x00, 0x3C, 0x00, 0x00, 0x00};
+
+    /**
+     * This is the CONNACK packet with which the stand-in broker
+     * answers every CONNECT.
+     */
+    const std::vector<uint8_t> CONNACK{0x20, 0x03, 0x00, 0x00, 0x00};
+
+    /**
+     * This function makes a self-signed certificate for "localhost".
+     *
+     * @param[out] key
+     *      This is where to store the private key of the certificate.
+     * @return
+     *      The certificate is returned, or nullptr if it couldn't be made.
+     */
+    X509* MakeCertificate(EVP_PKEY*& key) {
+        key = nullptr;
+        const auto keyContext = EVP_PKEY_CTX_new_id(EVP_PKEY_EC, nullptr);
+        if ((EVP_PKEY_keygen_init(keyContext) != 1) ||
+            (EVP_PKEY_CTX_set_ec_paramgen_curve_nid(keyContext, NID_X9_62_prime256v1) != 1) ||
+            (EVP_PKEY_keygen(keyContext, &key) != 1))
+        { key = nullptr; }
+        EVP_PKEY_CTX_free(keyContext);
+        if (key == nullptr)
+        { return nullptr; }
+        const auto certificate = X509_new();
+        (void)X509_set_version(certificate, 2);
+        (void)ASN1_INTEGER_set(X509_get_serialNumber(certificate), 1);
+        (void)X509_gmtime_adj(X509_getm_notBefore(certificate), 0);
+        (void)X509_gmtime_adj(X509_getm_notAfter(certificate), 86400);
+        (void)X509_set_pubkey(certificate, key);
+        const auto name = X509_get_subject_name(certificate);
+        (void)X509_NAME_add_entry_by_txt(name, "CN", MBSTRING_ASC,
+                                         (const unsigned char*)"localhost", -1, -1, 0);
+        (void)X509_set_issuer_name(certificate, name);
+        X509V3_CTX extensionContext;
+        X509V3_set_ctx_nodb(&extensionContext);
+        X509V3_set_ctx(&extensionContext, certificate, certificate, nullptr, nullptr, 0);
+        const auto alternativeNames = X509V3_EXT_conf_nid(
+            nullptr, &extensionContext, NID_subject_alt_name, (char*)"DNS:localhost");
+        if (alternativeNames != nullptr)
+        {
+            (void)X509_add_ext(certificate, alternativeNames, -1);
+            X509_EXTENSION_free(alternativeNames);
+        }
+        if (X509_sign(certificate, key, EVP_sha256()) == 0)
+        {
+            X509_free(certificate);
+            EVP_PKEY_free(key);
+            key = nullptr;
+            return nullptr;
+        }
+        return certificate;
+    }
+
+    /**
+     * This function serves one connection of the stand-in broker,
+     * answering the first data received, whether early or not,
+     * with a CONNACK.
+     *
+     * @param[in] context
+     *      This is the TLS context of the stand-in broker.
+     * @param[in] sock
+     *      This is the socket of the connection.
+     */
+    void ServeBrokerConnection(SSL_CTX* context, int sock) {
+        const auto ssl = SSL_new(context);
+        (void)SSL_set_fd(ssl, sock);
+        bool answered = false;
+        uint8_t buffer[4096];
+        size_t amount = 0;
+        int status;
+        while ((status = SSL_read_early_data(ssl, buffer, sizeof(buffer), &amount)) ==
+               SSL_READ_EARLY_DATA_SUCCESS)
+        {
+            if ((amount > 0) && !answered)
+            {
+                size_t written;
+                (void)SSL_write_early_data(ssl, CONNACK.data(), CONNACK.size(), &written);
+                answered = true;
+            }
+        }
+        if ((status == SSL_READ_EARLY_DATA_FINISH) && (SSL_do_handshake(ssl) == 1))
+        {
+            int received;
+            while ((received = SSL_read(ssl, buffer, sizeof(buffer))) > 0)
+            {
+                if (!answered)
+                {
+                    (void)SSL_write(ssl, CONNACK.data(), (int)CONNACK.size());
+                    answered = true;
+                }
+            }
+            (void)SSL_shutdown(ssl);
+        }
+        SSL_free(ssl);
+        (void)close(sock);
+    }
+
+    /**
+     * This function starts the stand-in broker on a loopback port.
+     *
+     * @param[in] context
+     *      This is the TLS context of the stand-in broker.
+     * @return
+     *      The port of the stand-in broker is returned,
+     *      or zero if it couldn't be started.
+     */
+    uint16_t StartBroker(SSL_CTX* context) {
+        const int listener = socket(AF_INET, SOCK_STREAM, 0);
+        struct sockaddr_in address = {};
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        socklen_t addressLength = sizeof(address);
+        if ((bind(listener, (const struct sockaddr*)&address, sizeof(address)) != 0) ||
+            (listen(listener, SOMAXCONN) != 0) ||
+            (getsockname(listener, (struct sockaddr*)&address, &addressLength) != 0))
+        { return 0; }
+        std::thread(
+            [context, listener]
+            {
+                for (;;)
+                {
+                    const int sock = accept(listener, nullptr, nullptr);
+                    if (sock < 0)
+                    { return; }
+                    std::thread(ServeBrokerConnection, context, sock).detach();
+                }
+            })
+            .detach();
+        return ntohs(address.sin_port);
+    }
+
+    /**
+     * This function connects to the stand-in broker, sends CONNECT,
+     * waits for the CONNACK, keeps the connection open for a while, as
+     * a session would be, so that the session tickets issued after the
+     * handshake arrive, and then closes the connection.
+     *
+     * @param[in] transport
+     *      This is the transport through which to connect.
+     * @param[in] port
+     *      This is the port through which to reach the stand-in broker.
+     * @param[in] hold
+     *      This is how long to keep the connection open after
+     *      the CONNACK arrives.
+     * @return
+     *      The number of microseconds from starting to connect until the
+     *      CONNACK arrived is returned, or a negative number if no
+     *      CONNACK arrived.
+     */
+    double Reconnect(MqttNetworkTransport::MqttClientNetworkTransport& transport, uint16_t port,
+                     std::chrono::milliseconds hold) {
+        const auto connack = std::make_shared<std::promise<void>>();
+        auto connackFuture = connack->get_future();
+        const auto connected =
+            std::make_shared<std::promise<std::shared_ptr<MqttV5::Connection>>>();
+        auto connectedFuture = connected->get_future();
+        const auto start = std::chrono::steady_clock::now();
+        transport.ConnectAsync(
+            "mqtts", "localhost", port,
+            [connack](const std::vector<uint8_t>& data)
+            {
+                if (!data.empty())
+                {
+                    try
+                    { connack->set_value(); }
+                    catch (const std::future_error&)
+                    {}
+                }
+            },
+            [](bool graceful) {},
+            [connected](std::shared_ptr<MqttV5::Connection> connection)
+            { connected->set_value(connection); });
+        const auto connection = connectedFuture.get();
+        if (connection == nullptr)
+        { return -1.0; }
+        connection->SendData(CONNECT);
+        double elapsed = -1.0;
+        if (connackFuture.wait_for(std::chrono::seconds(5)) == std::future_status::ready)
+        { elapsed = Benchmark::MicrosecondsSince(start); }
+        std::this_thread::sleep_for(hold);
+        connection->Break(true);
+        return elapsed;
+    }
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    const int reconnects = ((argc > 1) ? atoi(argv[1]) : 100);
+    const int roundTripMilliseconds = ((argc > 2) ? atoi(argv[2]) : 20);
+    (void)signal(SIGPIPE, SIG_IGN);
+    EVP_PKEY* key;
+    const auto certificate = MakeCertificate(key);
+    if (certificate == nullptr)
+    {
+        fprintf(stderr, "unable to make a certificate\n");
+        return EXIT_FAILURE;
+    }
+    char certificateFile[] = "/tmp/TlsEarlyDataBenchmarkXXXXXX";
+    const int certificateFd = mkstemp(certificateFile);
+    const auto certificateStream = ((certificateFd < 0) ? nullptr : fdopen(certificateFd, "w"));
+    if ((certificateStream == nullptr) || (PEM_write_X509(certificateStream, certificate) != 1))
+    {
+        fprintf(stderr, "unable to write the certificate\n");
+        return EXIT_FAILURE;
+    }
+    (void)fclose(certificateStream);
+    const auto brokerContext = SSL_CTX_new(TLS_server_method());
+    (void)SSL_CTX_use_certificate(brokerContext, certificate);
+    (void)SSL_CTX_use_PrivateKey(brokerContext, key);
+    (void)SSL_CTX_set_max_early_data(brokerContext, 16384);
+    const auto brokerPort = StartBroker(brokerContext);
+    if (brokerPort == 0)
+    {
+        fprintf(stderr, "unable to start the stand-in broker\n");
+        return EXIT_FAILURE;
+    }
+    Benchmark::DelayRelay relay(brokerPort,
+                                std::chrono::microseconds(roundTripMilliseconds * 1000 / 2));
+    printf("%d reconnects, %d ms round trip\n", reconnects, roundTripMilliseconds);
+    for (const bool earlyData : {false, true})
+    {
+        MqttNetworkTransport::MqttClientNetworkTransport transport;
+        MqttNetworkTransport::MqttClientNetworkTransport::Configuration configuration;
+        configuration.reactorLoopCount = 1;
+        configuration.tlsCaFile = certificateFile;
+        configuration.tlsEarlyData = earlyData;
+        transport.Configure(configuration);
+        const auto hold = std::chrono::milliseconds(roundTripMilliseconds * 2 + 10);
+        (void)Reconnect(transport, relay.GetPort(), hold);
+        std::vector<double> samples;
+        for (int i = 0; i < reconnects; ++i)
+        {
+            const auto elapsed = Reconnect(transport, relay.GetPort(), hold);
+            if (elapsed >= 0.0)
+            { samples.push_back(elapsed); }
+        }
+        const auto statistics = transport.GetStatistics();
+        Benchmark::Report((earlyData ? "connect to CONNACK, early data" : "connect to CONNACK"),
+                          samples);
+        printf("  resumed handshakes %llu, early data accepted %llu, rejected %llu\n",
+               (unsigned long long)statistics.tlsResumedHandshakes,
+               (unsigned long long)statistics.tlsEarlyDataAccepted,
+               (unsigned long long)statistics.tlsEarlyDataRejected);
+    }
+    (void)unlink(certificateFile);
+    return EXIT_SUCCESS;
+}
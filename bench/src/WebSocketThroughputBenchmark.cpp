@@ -0,0 +1,319 @@
+/**
+ * @file WebSocketThroughputBenchmark.cpp
+ *
+ * This module contains a benchmark of the throughput of connections
+ * over WebSockets.  Messages of various sizes are sent through a local
+ * WebSocket echo stand-in and the echoes are awaited, and the same is
+ * done through a plain TCP echo stand-in for comparison.  The speed of
+ * frame masking alone is measured too.
+ *
+ * Usage: WebSocketThroughputBenchmark [megabytes per size]
+ *
+ * © 2025 by Hatem Nabli
+ */
+
+#include "Measurements.hpp"
+#include "WebSocketFramer.hpp"
+#include <MqttNetworkTransport/MqttClientNetworkTransport.hpp>
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <memory>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+#include <thread>
+#include <vector>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <openssl/evp.h>
+#include <openssl/sha.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace
+{
+    /**
+     * This is the GUID the server appends to the key of
+     * the upgrade request to compute Sec-WebSocket-Accept.
+     */
+    const std::string WEBSOCKET_GUID = "258EAFA5-E914-47DA-95CA-C5AB0DC85B11";
+
+    /**
+     * This function reads exactly the given number of bytes.
+     *
+     * @param[in] sock
+     *      This is the socket from which to read.
+     * @param[out] buffer
+     *      This is where to store the bytes read.
+     * @param[in] size
+     *      This is the number of bytes to read.
+     * @return
+     *      An indication of whether or not all the bytes were read
+     *      is returned.
+     */
+    bool ReadAll(int sock, uint8_t* buffer, size_t size) {
+        while (size > 0)
+        {
+            const auto amount = recv(sock, buffer, size, 0);
+            if (amount <= 0)
+            { return false; }
+            buffer += amount;
+            size -= (size_t)amount;
+        }
+        return true;
+    }
+
+    /**
+     * This function writes all the given bytes.
+     *
+     * @param[in] sock
+     *      This is the socket to which to write.
+     * @param[in] buffer
+     *      This points to the bytes to write.
+     * @param[in] size
+     *      This is the number of bytes to write.
+     * @return
+     *      An indication of whether or not all the bytes were written
+     *      is returned.
+     */
+    bool WriteAll(int sock, const uint8_t* buffer, size_t size) {
+        while (size > 0)
+        {
+            const auto amount = send(sock, buffer, size, MSG_NOSIGNAL);
+            if (amount <= 0)
+            { return false; }
+            buffer += amount;
+            size -= (size_t)amount;
+        }
+        return true;
+    }
+
+    /**
+     * This function serves one connection of the plain echo stand-in,
+     * sending back everything received.
+     *
+     * @param[in] sock
+     *      This is the socket of the connection.
+     */
+    void ServePlainEcho(int sock) {
+        std::vector<uint8_t> buffer(65536);
+        for (;;)
+        {
+            const auto amount = recv(sock, buffer.data(), buffer.size(), 0);
+            if ((amount <= 0) || !WriteAll(sock, buffer.data(), (size_t)amount))
+            { break; }
+        }
+        (void)close(sock);
+    }
+
+    /**
+     * This function serves one connection of the WebSocket echo stand-in:
+     * it accepts the upgrade, and then sends back the payload of every
+     * data frame received in an unmasked frame of its own.
+     *
+     * @param[in] sock
+     *      This is the socket of the connection.
+     */
+    void ServeWebSocketEcho(int sock) {
+        std::string request;
+        uint8_t byte;
+        while (request.find("\r\n\r\n") == std::string::npos)
+        {
+            if (!ReadAll(sock, &byte, 1))
+            {
+                (void)close(sock);
+                return;
+            }
+            request += (char)byte;
+        }
+        const std::string keyHeader = "Sec-WebSocket-Key: ";
+        const auto keyStart = request.find(keyHeader) + keyHeader.size();
+        const auto key = request.substr(keyStart, request.find("\r\n", keyStart) - keyStart);
+        const auto hashed = key + WEBSOCKET_GUID;
+        uint8_t digest[SHA_DIGEST_LENGTH];
+        (void)SHA1((const uint8_t*)hashed.data(), hashed.size(), digest);
+        char accept[64];
+        (void)EVP_EncodeBlock((uint8_t*)accept, digest, SHA_DIGEST_LENGTH);
+        const auto response = std::string("HTTP/1.1 101 Switching Protocols\r\n"
+                                          "Upgrade: websocket\r\n"
+                                          "Connection: Upgrade\r\n"
+                                          "Sec-WebSocket-Protocol: mqtt\r\n"
+                                          "Sec-WebSocket-Accept: ") +
+                              accept + "\r\n\r\n";
+        if (!WriteAll(sock, (const uint8_t*)response.data(), response.size()))
+        {
+            (void)close(sock);
+            return;
+        }
+        std::vector<uint8_t> frame;
+        for (;;)
+        {
+            uint8_t header[14];
+            if (!ReadAll(sock, header, 2))
+            { break; }
+            uint64_t length = (header[1] & 0x7F);
+            size_t lengthSize = ((length == 126) ? 2 : ((length == 127) ? 8 : 0));
+            if (!ReadAll(sock, header + 2, lengthSize + 4))
+            { break; }
+            if (lengthSize > 0)
+            {
+                length = 0;
+                for (size_t i = 0; i < lengthSize; ++i)
+                { length = (length << 8) | header[2 + i]; }
+            }
+            const uint8_t* key = header + 2 + lengthSize;
+            frame.resize(2 + lengthSize + length);
+            frame[0] = header[0];
+            frame[1] = (uint8_t)(header[1] & 0x7F);
+            for (size_t i = 0; i < lengthSize; ++i)
+            { frame[2 + i] = header[2 + i]; }
+            const auto payload = frame.data() + 2 + lengthSize;
+            if (!ReadAll(sock, payload, length))
+            { break; }
+            MqttNetworkTransport::WebSocketFramer::Mask(payload, payload, length, key);
+            if ((header[0] & 0x0F) == MqttNetworkTransport::WebSocketFramer::OPCODE_CLOSE)
+            {
+                (void)WriteAll(sock, frame.data(), frame.size());
+                break;
+            }
+            if (!WriteAll(sock, frame.data(), frame.size()))
+            { break; }
+        }
+        (void)close(sock);
+    }
+
+    /**
+     * This function starts a stand-in on a loopback port.
+     *
+     * @param[in] serve
+     *      This is the function which serves each connection.
+     * @return
+     *      The port of the stand-in is returned,
+     *      or zero if it couldn't be started.
+     */
+    uint16_t StartStandIn(void (*serve)(int sock)) {
+        const int listener = socket(AF_INET, SOCK_STREAM, 0);
+        struct sockaddr_in address = {};
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        socklen_t addressLength = sizeof(address);
+        if ((bind(listener, (const struct sockaddr*)&address, sizeof(address)) != 0) ||
+            (listen(listener, SOMAXCONN) != 0) ||
+            (getsockname(listener, (struct sockaddr*)&address, &addressLength) != 0))
+        { return 0; }
+        std::thread(
+            [listener, serve]
+            {
+                for (;;)
+                {
+                    const int sock = accept(listener, nullptr, nullptr);
+                    if (sock < 0)
+                    { return; }
+                    const int noDelay = 1;
+                    (void)setsockopt(sock, IPPROTO_TCP, TCP_NODELAY, &noDelay,
+                                     sizeof(noDelay));
+                    std::thread(serve, sock).detach();
+                }
+            })
+            .detach();
+        return ntohs(address.sin_port);
+    }
+
+    /**
+     * This function sends messages of the given size through an echo
+     * stand-in until the given number of bytes has gone both ways.
+     *
+     * @param[in] transport
+     *      This is the transport through which to connect.
+     * @param[in] scheme
+     *      This is the scheme with which to connect.
+     * @param[in] port
+     *      This is the port of the echo stand-in.
+     * @param[in] messageSize
+     *      This is the size of each message sent.
+     * @param[in] totalBytes
+     *      This is the number of bytes to send in all.
+     * @return
+     *      The throughput, in megabytes per second echoed, is returned,
+     *      or a negative number if the echoes didn't all arrive.
+     */
+    double MeasureThroughput(MqttNetworkTransport::MqttClientNetworkTransport& transport,
+                             const char* scheme, uint16_t port, size_t messageSize,
+                             size_t totalBytes) {
+        const size_t messages = std::max<size_t>(1, totalBytes / messageSize);
+        const size_t expected = messages * messageSize;
+        const auto received = std::make_shared<std::atomic<size_t>>(0);
+        const auto done = std::make_shared<std::promise<void>>();
+        auto doneFuture = done->get_future();
+        const auto connection = transport.Connect(
+            scheme, "127.0.0.1", port,
+            [received, done, expected](const std::vector<uint8_t>& data)
+            {
+                if ((*received += data.size()) == expected)
+                { done->set_value(); }
+            },
+            [](bool graceful) {});
+        if (connection == nullptr)
+        { return -1.0; }
+        const std::vector<uint8_t> message(messageSize, 0x5A);
+        const auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < messages; ++i)
+        { connection->SendData(message); }
+        double megabytesPerSecond = -1.0;
+        if (doneFuture.wait_for(std::chrono::seconds(60)) == std::future_status::ready)
+        { megabytesPerSecond = expected / Benchmark::MicrosecondsSince(start); }
+        connection->Break(true);
+        return megabytesPerSecond;
+    }
+
+    /**
+     * This function measures how fast frame payloads are masked.
+     *
+     * @param[in] size
+     *      This is the number of bytes masked at once.
+     * @return
+     *      The speed of masking, in megabytes per second, is returned.
+     */
+    double MeasureMasking(size_t size) {
+        std::vector<uint8_t> input(size, 0x5A);
+        std::vector<uint8_t> output(size);
+        const uint8_t key[4] = {0x12, 0x34, 0x56, 0x78};
+        const size_t rounds = std::max<size_t>(1, ((size_t)256 << 20) / size);
+        const auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < rounds; ++i)
+        {
+            MqttNetworkTransport::WebSocketFramer::Mask(input.data(), output.data(), size, key);
+            input[i % size] ^= output[(i * 7) % size];
+        }
+        return (double)(rounds * size) / Benchmark::MicrosecondsSince(start);
+    }
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    const size_t megabytes = ((argc > 1) ? (size_t)atoi(argv[1]) : 64);
+    (void)signal(SIGPIPE, SIG_IGN);
+    const auto plainPort = StartStandIn(ServePlainEcho);
+    const auto webSocketPort = StartStandIn(ServeWebSocketEcho);
+    if ((plainPort == 0) || (webSocketPort == 0))
+    {
+        fprintf(stderr, "unable to start the stand-ins\n");
+        return EXIT_FAILURE;
+    }
+    MqttNetworkTransport::MqttClientNetworkTransport transport;
+    MqttNetworkTransport::MqttClientNetworkTransport::Configuration configuration;
+    configuration.reactorLoopCount = 1;
+    transport.Configure(configuration);
+    printf("%zu MB echoed per message size, MB/s\n", megabytes);
+    printf("%10s %12s %12s %14s\n", "size", "mqtt", "ws", "masking only");
+    for (const size_t size : {64, 1024, 16384, 262144})
+    {
+        const auto plain = MeasureThroughput(transport, "mqtt", plainPort, size, megabytes << 20);
+        const auto webSocket =
+            MeasureThroughput(transport, "ws", webSocketPort, size, megabytes << 20);
+        printf("%10zu %12.1f %12.1f %14.1f\n", size, plain, webSocket, MeasureMasking(size));
+    }
+    return EXIT_SUCCESS;
+}
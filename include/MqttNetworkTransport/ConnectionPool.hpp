@@ -0,0 +1,212 @@
+#ifndef MQTT_NETWORK_TRANSPORT_CONNECTION_POOL_HPP
+#define MQTT_NETWORK_TRANSPORT_CONNECTION_POOL_HPP
+/**
+ * @file ConnectionPool.hpp
+ *
+ * This module declares the MqttNetworkTransport::ConnectionPool class.
+ *
+ * © 2025 by Hatem Nabli
+ */
+
+#include <memory>
+#include <stdint.h>
+#include <string>
+#include <MqttNetworkTransport/MqttClientNetworkTransport.hpp>
+#include <MqttV5/ClientTransportLayer.hpp>
+#include <SystemUtils/DiagnosticsSender.hpp>
+
+namespace MqttNetworkTransport
+{
+    /**
+     * This is an implementation of MqttV5::ClientTransportLayer which
+     * keeps connections established in advance, through an
+     * MqttClientNetworkTransport, to each target (scheme, host and port)
+     * it is asked for, so that Connect can hand one out at once, without
+     * waiting for a host lookup, TCP connect, TLS handshake or WebSocket
+     * upgrade.  Connections handed out are replaced in the background.
+     *
+     * Warm connections have sent nothing yet, so the first packet sent
+     * on one handed out (normally CONNECT) is the first the broker sees.
+     * Brokers which close connections that take too long to send CONNECT
+     * will close warm connections; they are replaced, and warm
+     * connections can be retired before that happens.
+     */
+    class ConnectionPool : public MqttV5::ClientTransportLayer
+    {
+    public:
+        /**
+         * This holds the settings of the pool.
+         */
+        struct Configuration
+        {
+            /**
+             * This is the number of warm connections to keep to each
+             * target.  Zero turns the pool off, closing its warm
+             * connections and passing every connect through.
+             */
+            size_t warmConnections = 2;
+
+            /**
+             * This indicates whether or not a target is pooled from the
+             * first time Connect is called for it, rather than only once
+             * Prewarm is called for it.
+             */
+            bool warmOnConnect = true;
+
+            /**
+             * This is how long, in milliseconds, to wait before opening
+             * warm connections to a target again after one failed to
+             * open or broke before being handed out.
+             */
+            unsigned replenishRetryMilliseconds = 1000;
+
+            /**
+             * This is the longest time, in milliseconds, a connection is
+             * kept warm before being closed and replaced, or zero for
+             * no limit.  It should be shorter than the time brokers
+             * allow between connecting and sending CONNECT.
+             */
+            unsigned maxWarmMilliseconds = 10000;
+
+            /**
+             * This is how long, in milliseconds, a target may go without
+             * being connected to before its warm connections are closed
+             * and it stops being pooled, or zero to never evict targets.
+             */
+            unsigned idleEvictionMilliseconds = 60000;
+        };
+
+        /**
+         * This holds counters describing the operation of the pool.
+         */
+        struct Statistics
+        {
+            /**
+             * These are the numbers of connects which were handed
+             * a warm connection, and of those which weren't.
+             */
+            uint64_t hits = 0;
+            uint64_t misses = 0;
+
+            /**
+             * These are the numbers of warm connections opened,
+             * and of attempts to open one which failed.
+             */
+            uint64_t opened = 0;
+            uint64_t openFailures = 0;
+
+            /**
+             * These are the numbers of warm connections which broke
+             * before being handed out, and of those closed because
+             * they were kept warm for too long.
+             */
+            uint64_t broken = 0;
+            uint64_t expired = 0;
+
+            /**
+             * This is the number of targets evicted from the pool
+             * for not being connected to.
+             */
+            uint64_t evictedTargets = 0;
+
+            /**
+             * These are the numbers of targets currently pooled,
+             * and of warm connections currently open to them.
+             */
+            size_t targets = 0;
+            size_t warm = 0;
+        };
+
+        // Lifecycle management
+    public:
+        ~ConnectionPool() noexcept;
+        ConnectionPool(const ConnectionPool&) = delete;
+        ConnectionPool(ConnectionPool&&) noexcept = delete;
+        ConnectionPool& operator=(const ConnectionPool&) = delete;
+        ConnectionPool& operator=(ConnectionPool&&) noexcept = delete;
+
+        // Public methods
+    public:
+        /**
+         * This is the constructor.
+         *
+         * @param[in] transport
+         *      This is the transport used to establish connections.
+         */
+        explicit ConnectionPool(std::shared_ptr<MqttClientNetworkTransport> transport);
+
+        /**
+         * This method forms a new subscription to diagnostic messages
+         * published by the pool.
+         *
+         * @param[in] delegate
+         *      This is the function to call to deliver messages
+         *      to the subscriber.
+         * @param[in] minLevel
+         *      This is the minimum level of message that this subscriber
+         *      desires to receive.
+         * @return
+         *      A function is returned which may be called
+         *      to terminate the subscription.
+         */
+        SystemUtils::DiagnosticsSender::UnsubscribeDelegate SubscribeToDiagnostics(
+            SystemUtils::DiagnosticsSender::DiagnosticMessageDelegate delegate,
+            size_t minLevel = 0);
+
+        /**
+         * This method changes the settings of the pool.
+         *
+         * @param[in] configuration
+         *      These are the settings to apply.
+         */
+        void Configure(const Configuration& configuration);
+
+        /**
+         * This method starts pooling the given target, if it isn't
+         * already, and opening its warm connections, returning without
+         * waiting for them to open.
+         *
+         * @param[in] scheme
+         *      This is the scheme indicated in the URI of the target.
+         * @param[in] hostNameOrAddress
+         *      This is the name or address of the host of the target.
+         * @param[in] port
+         *      This is the port number of the target.
+         */
+        void Prewarm(const std::string& scheme, const std::string& hostNameOrAddress,
+                     uint16_t port);
+
+        /**
+         * This method returns the current counters of the pool.
+         *
+         * @return
+         *      The statistics of the pool are returned.
+         */
+        Statistics GetStatistics() const;
+
+        // MqttV5::ClientTransportLayer
+    public:
+        virtual std::shared_ptr<MqttV5::Connection> Connect(
+            const std::string& scheme, const std::string& hostNameOrAddress, uint16_t port,
+            MqttV5::Connection::DataReceivedDelegate dataReceivedDelegate,
+            MqttV5::Connection::BrokenDelegate brokenDelegate) override;
+
+        // Private properties
+    private:
+        /**
+         * This is the type of structure that contains the private
+         * properties of the instance.  It is defined in the implementation
+         * and declared here to ensure that it is scoped inside the class.
+         */
+        struct Impl;
+
+        /**
+         * This contains the private properties of the instance.  It is
+         * shared with warm connections and the attempts opening them,
+         * which may outlive the pool.
+         */
+        std::shared_ptr<Impl> impl_;
+    };
+}  // namespace MqttNetworkTransport
+
+#endif /** MQTT_NETWORK_TRANSPORT_CONNECTION_POOL_HPP */
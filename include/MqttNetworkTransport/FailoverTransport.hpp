@@ -0,0 +1,287 @@
+#ifndef MQTT_NETWORK_TRANSPORT_FAILOVER_TRANSPORT_HPP
+#define MQTT_NETWORK_TRANSPORT_FAILOVER_TRANSPORT_HPP
+/**
+ * @file FailoverTransport.hpp
+ *
+ * This module declares the MqttNetworkTransport::FailoverTransport class.
+ *
+ * © 2025 by Hatem Nabli
+ */
+
+#include <memory>
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <MqttNetworkTransport/MqttClientNetworkTransport.hpp>
+#include <MqttV5/ClientTransportLayer.hpp>
+#include <SystemUtils/DiagnosticsSender.hpp>
+
+namespace MqttNetworkTransport
+{
+    /**
+     * This is an implementation of MqttV5::ClientTransportLayer which
+     * connects to one of a group of brokers, such as a highly available
+     * pair, through an MqttClientNetworkTransport.  Each group has a name,
+     * which is given as the host when connecting.  The brokers of the
+     * group are tried in order of priority, and of weight among brokers
+     * of equal priority, skipping those which recently failed, until a
+     * connection is established or the failover budget is spent.
+     *
+     * Optionally, a standby connection is kept open to the broker which
+     * would be used next, so that the connection made after the current
+     * one breaks is handed out at once.
+     *
+     * Optionally also, the round-trip time to each broker is probed in
+     * the background, and healthy brokers of equal priority are tried
+     * from the fastest.
+     */
+    class FailoverTransport : public MqttV5::ClientTransportLayer
+    {
+    public:
+        /**
+         * This describes one broker of a group.
+         */
+        struct Endpoint
+        {
+            /**
+             * This is the scheme to use to connect to the broker.  When
+             * it is empty, the scheme given when connecting is used.
+             */
+            std::string scheme;
+
+            /**
+             * This is the name or address of the host of the broker.
+             */
+            std::string hostNameOrAddress;
+
+            /**
+             * This is the port number of the broker.  When it is zero,
+             * the port given when connecting is used.
+             */
+            uint16_t port = 0;
+
+            /**
+             * This is the priority of the broker.  Brokers with lower
+             * values are tried first.
+             */
+            unsigned priority = 0;
+
+            /**
+             * This is the share of the connections the broker gets
+             * among healthy brokers of the same priority.
+             */
+            unsigned weight = 1;
+        };
+
+        /**
+         * This holds the settings of the transport.
+         */
+        struct Configuration
+        {
+            /**
+             * This is the longest time, in milliseconds, that Connect
+             * spends trying the brokers of a group before giving up.
+             */
+            unsigned failoverBudgetMilliseconds = 1000;
+
+            /**
+             * This is the longest time, in milliseconds, that Connect
+             * waits for any one broker before trying the next one.
+             */
+            unsigned attemptTimeoutMilliseconds = 300;
+
+            /**
+             * This is how long, in milliseconds, a broker which failed
+             * to connect, or whose connection broke, is only tried
+             * once the healthy brokers of its group have been tried.
+             */
+            unsigned holdDownMilliseconds = 5000;
+
+            /**
+             * This indicates whether or not to keep a standby connection
+             * open to the broker of each group which would be used if
+             * the current one failed.
+             */
+            bool standby = false;
+
+            /**
+             * This is how long, in milliseconds, to wait before opening
+             * a standby connection again after one failed or broke.
+             */
+            unsigned standbyRetryMilliseconds = 1000;
+
+            /**
+             * This is how often, in milliseconds, to measure the time
+             * taken to establish a TCP connection to each broker, or
+             * zero not to.  When measurements are made, healthy brokers
+             * of equal priority are tried from the one with the lowest
+             * smoothed round-trip time, rather than by weight, after
+             * any not measured yet.  Brokers reached with the "unix",
+             * "shm" and "inproc" schemes, or whose port isn't known yet,
+             * are not probed.
+             */
+            unsigned probeIntervalMilliseconds = 0;
+
+            /**
+             * This is the weight, in percent, of each new round-trip
+             * time measured for a broker in its exponentially weighted
+             * moving average.
+             */
+            unsigned rttSmoothingPercent = 20;
+
+            /**
+             * This indicates whether or not to also measure round-trip
+             * times from the PINGREQ packets sent on connections handed
+             * out and the PINGRESP packets answering them.  It requires
+             * the wrapped transport to frame what it receives into
+             * packets, as it does unless receiveFraming is None.
+             */
+            bool probeSessionPings = false;
+        };
+
+        /**
+         * This describes the health of one broker of a group.
+         */
+        struct EndpointStatus
+        {
+            /**
+             * This is the broker described.
+             */
+            Endpoint endpoint;
+
+            /**
+             * This indicates whether or not the broker is healthy,
+             * rather than held down after a failure.
+             */
+            bool healthy = true;
+
+            /**
+             * This is the number of failures of the broker
+             * since it last connected.
+             */
+            unsigned consecutiveFailures = 0;
+
+            /**
+             * These are the numbers of connections established to the
+             * broker, and of connect attempts and connections to it
+             * which failed.
+             */
+            uint64_t connects = 0;
+            uint64_t failures = 0;
+
+            /**
+             * This indicates whether or not a standby connection
+             * to the broker is open.
+             */
+            bool standby = false;
+
+            /**
+             * This is the smoothed round-trip time to the broker, in
+             * microseconds, or zero if it hasn't been measured.
+             */
+            uint64_t smoothedRttMicroseconds = 0;
+
+            /**
+             * This is the number of round-trip times
+             * measured for the broker.
+             */
+            uint64_t rttSamples = 0;
+        };
+
+        // Lifecycle management
+    public:
+        ~FailoverTransport() noexcept;
+        FailoverTransport(const FailoverTransport&) = delete;
+        FailoverTransport(FailoverTransport&&) noexcept = delete;
+        FailoverTransport& operator=(const FailoverTransport&) = delete;
+        FailoverTransport& operator=(FailoverTransport&&) noexcept = delete;
+
+        // Public methods
+    public:
+        /**
+         * This is the constructor.
+         *
+         * @param[in] transport
+         *      This is the transport used to connect to the brokers.
+         */
+        explicit FailoverTransport(std::shared_ptr<MqttClientNetworkTransport> transport);
+
+        /**
+         * This method forms a new subscription to diagnostic messages
+         * published by the transport.
+         *
+         * @param[in] delegate
+         *      This is the function to call to deliver messages
+         *      to the subscriber.
+         * @param[in] minLevel
+         *      This is the minimum level of message that this subscriber
+         *      desires to receive.
+         * @return
+         *      A function is returned which may be called
+         *      to terminate the subscription.
+         */
+        SystemUtils::DiagnosticsSender::UnsubscribeDelegate SubscribeToDiagnostics(
+            SystemUtils::DiagnosticsSender::DiagnosticMessageDelegate delegate,
+            size_t minLevel = 0);
+
+        /**
+         * This method changes the settings of the transport.
+         *
+         * @param[in] configuration
+         *      These are the settings to apply.
+         */
+        void Configure(const Configuration& configuration);
+
+        /**
+         * This method sets the brokers of the group with the given name,
+         * replacing those it had before, if any.  Connections made with
+         * the name as the host go to one of them.  Connections made
+         * with any other host are made directly by the wrapped transport.
+         *
+         * @param[in] name
+         *      This is the name of the group.
+         * @param[in] endpoints
+         *      These are the brokers of the group.  When the list is
+         *      empty, the group is removed.
+         */
+        void SetEndpoints(const std::string& name, const std::vector<Endpoint>& endpoints);
+
+        /**
+         * This method returns the health of the brokers of the
+         * group with the given name.
+         *
+         * @param[in] name
+         *      This is the name of the group.
+         * @return
+         *      The health of each broker of the group is returned, in
+         *      the order in which they were set, or an empty list if
+         *      there is no such group.
+         */
+        std::vector<EndpointStatus> GetEndpointStatus(const std::string& name) const;
+
+        // MqttV5::ClientTransportLayer
+    public:
+        virtual std::shared_ptr<MqttV5::Connection> Connect(
+            const std::string& scheme, const std::string& hostNameOrAddress, uint16_t port,
+            MqttV5::Connection::DataReceivedDelegate dataReceivedDelegate,
+            MqttV5::Connection::BrokenDelegate brokenDelegate) override;
+
+        // Private properties
+    private:
+        /**
+         * This is the type of structure that contains the private
+         * properties of the instance.  It is defined in the implementation
+         * and declared here to ensure that it is scoped inside the class.
+         */
+        struct Impl;
+
+        /**
+         * This contains the private properties of the instance.  It is
+         * shared with connections and connect attempts, which may
+         * outlive the transport.
+         */
+        std::shared_ptr<Impl> impl_;
+    };
+}  // namespace MqttNetworkTransport
+
+#endif /** MQTT_NETWORK_TRANSPORT_FAILOVER_TRANSPORT_HPP */
@@ -10,6 +10,9 @@
  */
 #include <functional>
 #include <memory>
+#include <string>
+#include <vector>
+#include <MqttNetworkTransport/ZeroCopyConnection.hpp>
 #include <MqttV5/ClientTransportLayer.hpp>
 #include <SystemUtils/INetworkConnection.hpp>
 #include <SystemUtils/NetworkConnection.hpp>
@@ -36,6 +39,587 @@ namespace MqttNetworkTransport
             const std::string& scheme, const std::string& serverName)>
             ConnectionFactoryFunction;
 
+        /**
+         * This is the type of function called once an asynchronous
+         * connect attempt completes.
+         *
+         * @param[in] connection
+         *      This is the established connection, or nullptr if the
+         *      attempt failed, timed out or was cancelled.
+         */
+        typedef std::function<void(std::shared_ptr<MqttV5::Connection> connection)>
+            ConnectCompletionDelegate;
+
+        /**
+         * This is the type of function returned by ConnectAsync which may
+         * be called to cancel the attempt, if it hasn't completed yet.
+         */
+        typedef std::function<void()> CancelDelegate;
+
+        /**
+         * This is the type of function called when a connection is made
+         * to a name listened to with ListenInProcess.
+         *
+         * @param[in] connection
+         *      This is the listener's side of the new connection.  Its
+         *      delegates should be set before the function returns.
+         */
+        typedef std::function<void(std::shared_ptr<ZeroCopyConnection> connection)>
+            InProcessAcceptDelegate;
+
+        /**
+         * This is the type of function returned by ListenInProcess which
+         * may be called to stop accepting connections.
+         */
+        typedef std::function<void()> StopListeningDelegate;
+
+        /**
+         * This describes one of the connections to establish with ConnectMany.
+         */
+        struct ConnectTarget
+        {
+            /**
+             * This is the scheme indicated in the URI of the target
+             * to which to establish a connection.
+             */
+            std::string scheme;
+
+            /**
+             * This is the name or address (IPv4 or IPv6) of the host to
+             * connect to, the path of its socket for the "unix" and "shm"
+             * schemes, or its name for the "inproc" scheme.
+             */
+            std::string hostNameOrAddress;
+
+            /**
+             * This is the port number of the host to connect to.
+             */
+            uint16_t port = 0;
+
+            /**
+             * This is the function to call to deliver data
+             * received on the connection.
+             */
+            MqttV5::Connection::DataReceivedDelegate dataReceivedDelegate;
+
+            /**
+             * This is the function to call once the connection is broken.
+             */
+            MqttV5::Connection::BrokenDelegate brokenDelegate;
+
+            /**
+             * If not null, this is the function to call as soon as
+             * the attempt to connect to this target completes.
+             */
+            ConnectCompletionDelegate completionDelegate;
+        };
+
+        /**
+         * This holds the result of the attempt to connect to one target.
+         */
+        struct ConnectOutcome
+        {
+            /**
+             * This is the established connection, or nullptr if the
+             * attempt failed, timed out, or was cancelled or never made.
+             */
+            std::shared_ptr<MqttV5::Connection> connection;
+
+            /**
+             * This is the number of microseconds from the start of the
+             * attempt until it completed, or zero if it was never made.
+             */
+            uint64_t connectMicroseconds = 0;
+        };
+
+        /**
+         * This holds the results of establishing a batch of
+         * connections with ConnectMany.
+         */
+        struct ConnectManyReport
+        {
+            /**
+             * These are the results for each target, in the order
+             * in which the targets were given.
+             */
+            std::vector<ConnectOutcome> outcomes;
+
+            /**
+             * This is the number of connections established.
+             */
+            size_t connected = 0;
+
+            /**
+             * These are percentiles, and the maximum, of the connect
+             * times, in microseconds, of the connections established.
+             */
+            uint64_t connectMicrosecondsP50 = 0;
+            uint64_t connectMicrosecondsP90 = 0;
+            uint64_t connectMicrosecondsP99 = 0;
+            uint64_t connectMicrosecondsMax = 0;
+        };
+
+        /**
+         * This is the type of function called once every attempt
+         * of a ConnectMany batch has completed.
+         *
+         * @param[in] report
+         *      These are the results of the batch.
+         */
+        typedef std::function<void(const ConnectManyReport& report)> ConnectManyCompletionDelegate;
+
+        /**
+         * These are the ways in which data received on a connection
+         * may be delivered to its data received delegate.
+         */
+        enum class ReceiveFraming
+        {
+            /**
+             * Data is delivered as it is read, with no regard
+             * for packet boundaries.
+             */
+            None,
+
+            /**
+             * Each complete MQTT control packet is delivered
+             * in a call of its own.
+             */
+            Packet,
+
+            /**
+             * All the complete MQTT control packets available after
+             * a read are delivered together in a single call.
+             */
+            Batch,
+        };
+
+        /**
+         * This holds the settings that tune how the transport
+         * establishes and operates its connections.
+         */
+        struct Configuration
+        {
+            /**
+             * This is the number of epoll event-loop threads over which
+             * all connections are multiplexed (reactor mode).  When zero,
+             * each connection is processed by its own worker, as provided
+             * by SystemUtils::NetworkConnection.  Reactor mode is only
+             * available on Linux; elsewhere this setting is ignored.
+             */
+            size_t reactorLoopCount = 0;
+
+            /**
+             * This is the submission queue depth of the io_uring instance
+             * shared by all connections.  When non-zero, the default
+             * connection factory makes connections which submit their
+             * sends and receives to io_uring (multishot receives into
+             * registered buffers), taking precedence over reactor mode.
+             * If io_uring is unavailable, the factory falls back to the
+             * other modes.  It is only available on Linux.
+             */
+            unsigned ioUringQueueDepth = 0;
+
+            /**
+             * This indicates whether or not the io_uring instance should
+             * be set up with a kernel thread polling its submission queue,
+             * so that submitting sends requires no system call while the
+             * poller is awake.
+             */
+            bool ioUringSubmissionPolling = false;
+
+            /**
+             * This is the longest time, in microseconds, an outgoing packet
+             * may be held back so that packets sent shortly after it are
+             * written along with it.  Zero disables write coalescing.
+             * CONNECT, PINGREQ, DISCONNECT and AUTH packets are always
+             * written immediately, along with anything held before them.
+             */
+            unsigned coalescingWindowMicroseconds = 0;
+
+            /**
+             * This is the number of held back bytes at which coalesced
+             * packets are written without waiting for the window to end.
+             */
+            size_t coalescingThresholdBytes = 16384;
+
+            /**
+             * This is the most buffers kept by the transport, and shared
+             * by its receiving threads, for reuse in delivering received
+             * data, so that reads don't allocate and free a buffer each.
+             * Each receiving thread also keeps a few buffers of its own.
+             * Zero disables pooling.  Pooling applies to reactor and
+             * io_uring connections.
+             */
+            size_t receiveBufferPoolSize = 0;
+
+            /**
+             * This selects whether received data is split into whole
+             * MQTT control packets, using their fixed headers, before
+             * being delivered.  A connection whose data is malformed
+             * is broken.
+             */
+            ReceiveFraming receiveFraming = ReceiveFraming::None;
+
+            /**
+             * This is the most bytes a received MQTT control packet may
+             * take when received data is split into packets, either
+             * because of receiveFraming or to resume broken connections.
+             * A larger packet is treated as malformed data.
+             */
+            size_t maximumReceivedPacketSize = 1048576;
+
+            /**
+             * This is the number of seconds for which the address found
+             * for a host is remembered and reused by later connections.
+             * Zero disables caching addresses.
+             */
+            unsigned hostCacheSeconds = 60;
+
+            /**
+             * This is the number of seconds for which a failure to find
+             * the address of a host is remembered, so that connections
+             * to it fail without another lookup.  Zero disables
+             * caching failures.
+             */
+            unsigned hostNegativeCacheSeconds = 5;
+
+            /**
+             * This is the number of milliseconds after which a connect
+             * attempt started by ConnectAsync gives up, if it hasn't
+             * completed by then.  Zero means attempts have no deadline
+             * other than that of the operating system.
+             */
+            unsigned connectTimeoutMilliseconds = 0;
+
+            /**
+             * This is the number of threads which connect, on behalf of
+             * ConnectAsync and ConnectMany, network connections which can
+             * only connect by blocking.  These are the connections made
+             * when neither reactor nor io_uring mode is enabled.  Such a
+             * connect keeps its thread until the operating system gives
+             * up on it, even after the attempt has timed out or been
+             * cancelled, so brokers which never answer can hold all of
+             * these threads and delay later attempts.  Reactor and
+             * io_uring connections connect without any of these threads,
+             * and their deadlines and cancellation stop the connect.
+             */
+            size_t connectWorkerCount = 4;
+
+            /**
+             * This is the number of milliseconds to wait for a connect
+             * attempt to one address of a host with several addresses,
+             * before also trying the next one (the "Connection Attempt
+             * Delay" of RFC 8305).  Zero means each address is only tried
+             * once the one before it has failed.
+             */
+            unsigned happyEyeballsDelayMilliseconds = 250;
+
+            /**
+             * This indicates whether or not, on Linux, connections in
+             * reactor or io_uring mode are established with TCP Fast
+             * Open.  When the operating system holds a Fast Open cookie
+             * from an earlier connection to the broker, the connect
+             * attempt completes at once, and the first packet sent
+             * (normally CONNECT) goes out in the SYN segment, saving a
+             * round trip.  A connect failure is then reported as the
+             * connection breaking, rather than by the connect attempt.
+             * Whether Fast Open was used is reported by the
+             * statistics of each connection.  Client support must be
+             * enabled in the net.ipv4.tcp_fastopen setting (it is by
+             * default), and the broker must support it.
+             */
+            bool tcpFastOpen = false;
+
+            /**
+             * This is the most connect attempts of a ConnectMany batch
+             * which may be in progress at once.
+             */
+            size_t connectManyConcurrency = 256;
+
+            /**
+             * This is the least number of microseconds between the starts
+             * of consecutive connect attempts of a ConnectMany batch,
+             * used to pace the load on brokers.  Zero means attempts
+             * start as fast as the concurrency cap allows.
+             */
+            unsigned connectManyIntervalMicroseconds = 0;
+
+            /**
+             * This is the most connect attempts started per second by
+             * Connect, ConnectAsync and ConnectMany together, or zero for
+             * no limit.  Attempts beyond the limit aren't refused; they
+             * wait for their turn, and their deadlines are counted from
+             * when they start.
+             */
+            unsigned connectAttemptsPerSecond = 0;
+
+            /**
+             * This is the number of connect attempts which may start at
+             * once, after a quiet spell, before the limit on the rate of
+             * attempts applies.
+             */
+            unsigned connectAttemptBurst = 10;
+
+            /**
+             * This is the least number of milliseconds for which connect
+             * attempts to a broker wait after an attempt to connect to it
+             * failed, or zero not to back off.  Each later failure picks
+             * a backoff at random between this and three times the one
+             * before it ("decorrelated jitter"), so that clients which
+             * failed together don't retry together.  A successful
+             * attempt clears the backoff.
+             */
+            unsigned reconnectBackoffBaseMilliseconds = 0;
+
+            /**
+             * This is the greatest number of milliseconds for which connect
+             * attempts to a broker wait after a failure.
+             */
+            unsigned reconnectBackoffCapMilliseconds = 30000;
+
+            /**
+             * This indicates whether or not connections made by Connect
+             * and ConnectAsync outlive the network connections under
+             * them.  When the network connection breaks without being
+             * asked to, a new one is established and the MQTT session
+             * is resumed on it, rather than the break being reported.
+             * This only happens for sessions the broker keeps: CONNECT
+             * must give a Client Identifier and a non-zero Session
+             * Expiry Interval, and not use enhanced authentication.
+             * Sessions aren't resumed if the broker allows topic aliases,
+             * or if it changes the limits it set in the first CONNACK.
+             */
+            bool resumeBrokenConnections = false;
+
+            /**
+             * This is the most bytes of packets sent while a connection
+             * is being resumed which are held to be sent once it is.
+             * Sending more gives up resuming and reports the break.
+             */
+            size_t resumeBufferBytes = 65536;
+
+            /**
+             * This is the number of attempts made to reconnect after a
+             * break before giving up resuming and reporting the break.
+             * The attempts are governed like any other, so the reconnect
+             * backoff spaces them out further.
+             */
+            unsigned resumeAttempts = 5;
+
+            /**
+             * This is the least number of milliseconds between the starts
+             * of successive attempts to reconnect after a break.
+             */
+            unsigned resumeRetryMilliseconds = 100;
+
+            /**
+             * This is the path of a PEM file holding the certificates of
+             * the authorities trusted to sign the certificates of brokers
+             * reached with the "mqtts" and "wss" schemes.  When empty, the
+             * system's default trusted authorities are used.
+             */
+            std::string tlsCaFile;
+
+            /**
+             * This indicates whether or not the certificates of brokers
+             * reached with the "mqtts" and "wss" schemes, and the names
+             * in them, are verified.
+             */
+            bool tlsVerifyPeer = true;
+
+            /**
+             * This is the number of threads which perform TLS handshakes
+             * for all "mqtts" connections, so that a burst of reconnects
+             * neither spends the I/O threads on cryptography nor starts
+             * a thread per handshake.
+             */
+            size_t tlsHandshakeWorkerCount = 2;
+
+            /**
+             * This indicates whether or not "mqtts" connections resuming a
+             * TLS 1.3 session whose server permits it send their first
+             * packet (the CONNECT packet) as early data, along with the
+             * client hello, saving a round trip before the first publish.
+             * Such connect attempts complete as soon as the underlying
+             * connection is established, before the handshake.
+             *
+             * Early data is not protected against replay: an attacker who
+             * records it may send it to the broker again, and the broker
+             * will process the CONNECT packet again.  A replayed CONNECT
+             * can take over (and, with Clean Start, discard) the session of
+             * the client, so this must only be enabled where that is
+             * acceptable, or where the broker rejects replayed early data.
+             * Each cached session ticket is used for early data only once.
+             */
+            bool tlsEarlyData = false;
+
+            /**
+             * This indicates whether or not, on Linux, the encryption of
+             * what "mqtts" connections send is handed to the kernel (kernel
+             * TLS) once their TLS 1.3 handshake completes, so that
+             * outgoing packets are written to the socket without being
+             * copied and encrypted in user space.  Received data is still
+             * decrypted by OpenSSL.  Connections for which the kernel
+             * can't take over (for example, because its "tls" module isn't
+             * loaded, the cipher isn't supported, TLS 1.2 was negotiated,
+             * or handshake records are still being written) keep
+             * encrypting in user space.  Offloaded connections close
+             * without sending a TLS close_notify alert.
+             */
+            bool tlsKernelOffload = false;
+
+            /**
+             * This is the path of the resource requested when upgrading
+             * "ws" and "wss" connections to WebSocket.  Packets are then
+             * carried in binary frames, with the "mqtt" subprotocol.
+             */
+            std::string webSocketPath = "/mqtt";
+
+            /**
+             * This indicates whether or not "ws" and "wss" connections
+             * offer the permessage-deflate extension, which compresses
+             * the packets sent and received, if the broker accepts it.
+             * Packets smaller than 32 bytes are sent uncompressed.  It
+             * is only offered if the library is built with zlib.
+             */
+            bool webSocketDeflate = false;
+
+            /**
+             * This is the zlib compression level (1 to 9) of the
+             * packets sent with permessage-deflate.
+             */
+            int webSocketDeflateLevel = 6;
+
+            /**
+             * This is the base-two logarithm (9 to 15) of the size of
+             * the window used to compress the packets sent with
+             * permessage-deflate.  The broker may ask for a smaller one.
+             */
+            int webSocketDeflateWindowBits = 15;
+
+            /**
+             * This indicates whether or not each packet sent with
+             * permessage-deflate is compressed using those sent before
+             * it on the connection (context takeover).  This compresses
+             * repetitive traffic much better, at the cost of keeping a
+             * compression window per connection.
+             */
+            bool webSocketDeflateContextTakeover = true;
+
+            /**
+             * This is the number of bytes each of the two rings of an
+             * "shm" connection holds.  It is rounded up to a power of two.
+             */
+            size_t sharedMemoryRingSize = 262144;
+
+            /**
+             * This is how long, in microseconds, "shm" connections keep
+             * polling for data from the broker, once they've read it all,
+             * before sleeping until the broker signals.  Polling cuts the
+             * latency of replies arriving within this time, at the cost
+             * of keeping an event loop thread busy meanwhile.
+             */
+            uint32_t sharedMemorySpinMicroseconds = 20;
+        };
+
+        /**
+         * This holds counters describing the operation of the transport.
+         */
+        struct Statistics
+        {
+            /**
+             * This is the number of outgoing packets which went
+             * through write coalescing.
+             */
+            uint64_t coalescedPackets = 0;
+
+            /**
+             * This is the number of writes into which the coalesced
+             * packets were gathered.
+             */
+            uint64_t coalescedWrites = 0;
+
+            /**
+             * This is the number of receive buffers reused from the pool.
+             */
+            uint64_t receiveBufferHits = 0;
+
+            /**
+             * This is the number of receive buffers newly made
+             * because the pool was empty.
+             */
+            uint64_t receiveBufferMisses = 0;
+
+            /**
+             * This is the number of TLS handshakes completed since
+             * the TLS settings were last changed.
+             */
+            uint64_t tlsHandshakes = 0;
+
+            /**
+             * This is the number of completed TLS handshakes which
+             * resumed a cached session rather than performing a
+             * full handshake.
+             */
+            uint64_t tlsResumedHandshakes = 0;
+
+            /**
+             * These are the numbers of TLS handshakes in which early data
+             * was sent and accepted, or rejected and sent again after
+             * the handshake, by the broker.
+             */
+            uint64_t tlsEarlyDataAccepted = 0;
+            uint64_t tlsEarlyDataRejected = 0;
+
+            /**
+             * This is the number of TLS connections whose encryption
+             * was handed to the kernel.
+             */
+            uint64_t tlsKernelOffloads = 0;
+
+            /**
+             * These are the numbers of bytes of packets sent compressed
+             * with permessage-deflate, before and after compression.
+             * Their ratio is the compression ratio of what is sent.
+             */
+            uint64_t webSocketUncompressedBytesSent = 0;
+            uint64_t webSocketCompressedBytesSent = 0;
+
+            /**
+             * These are the numbers of bytes of data received compressed
+             * with permessage-deflate, before and after decompression.
+             */
+            uint64_t webSocketCompressedBytesReceived = 0;
+            uint64_t webSocketUncompressedBytesReceived = 0;
+
+            /**
+             * This is the time spent compressing and decompressing
+             * with permessage-deflate, in microseconds.
+             */
+            uint64_t webSocketDeflateMicroseconds = 0;
+
+            /**
+             * These are the numbers of connect attempts which had to wait
+             * for the backoff of their broker, and for their turn under
+             * the limit on the rate of attempts.
+             */
+            uint64_t connectAttemptsBackedOff = 0;
+            uint64_t connectAttemptsRateLimited = 0;
+
+            /**
+             * This is the total time, in microseconds, connect attempts
+             * waited for the backoff or the limit on the rate of attempts.
+             */
+            uint64_t connectThrottleMicroseconds = 0;
+
+            /**
+             * These are the numbers of broken connections whose session
+             * was resumed, and of those given up on and reported.
+             */
+            uint64_t connectionsResumed = 0;
+            uint64_t connectionResumeFailures = 0;
+        };
+
         // Lifecycle management
     public:
         ~MqttClientNetworkTransport() noexcept;
@@ -68,6 +652,109 @@ namespace MqttNetworkTransport
             SystemUtils::DiagnosticsSender::DiagnosticMessageDelegate delegate,
             size_t minLevel = 0);
 
+        /**
+         * This method changes the settings of the transport.  The new
+         * settings apply to connections established afterwards.
+         *
+         * @param[in] configuration
+         *      These are the settings to apply.
+         */
+        void Configure(const Configuration& configuration);
+
+        /**
+         * This method changes the function used to create new network
+         * connections, replacing the default factory, which makes
+         * connections according to the configuration of the transport.
+         *
+         * @param[in] connectionFactory
+         *      This is the function to call to create new connections.
+         */
+        void SetConnectionFactory(ConnectionFactoryFunction connectionFactory);
+
+        /**
+         * This method starts accepting connections made for the "inproc"
+         * scheme, from any transport in this process, to the given name.
+         * The packets sent on either side of such connections are handed
+         * to the other side without being copied, and delivered to it
+         * by workers of the transport which made the connection.
+         *
+         * @param[in] name
+         *      This is the name under which to listen.  It is the host
+         *      given when connecting.
+         * @param[in] acceptDelegate
+         *      This is the function to call, on the thread connecting,
+         *      whenever a connection is made to the name.
+         * @return
+         *      A function is returned which may be called to stop
+         *      listening, or nullptr if something in this process
+         *      already listens under the name.
+         */
+        StopListeningDelegate ListenInProcess(const std::string& name,
+                                              InProcessAcceptDelegate acceptDelegate);
+
+        /**
+         * This method returns the current counters of the transport.
+         *
+         * @return
+         *      The statistics of the transport are returned.
+         */
+        Statistics GetStatistics() const;
+
+        /**
+         * This method starts establishing a new connection to a broker,
+         * returning without waiting for it to complete.  Host lookup
+         * and connection happen on threads shared by all attempts,
+         * so many attempts may be under way at once.  Connections which
+         * can only connect by blocking are connected by a pool of
+         * connectWorkerCount threads, which an attempt keeps until the
+         * connect returns, even if it times out or is cancelled first.
+         *
+         * @param[in] scheme
+         *      This is the scheme indicated in the URI of the target
+         *      to which to establish a connection.
+         * @param[in] hostNameOrAddress
+         *      This is the name or address of the host to connect to.
+         * @param[in] port
+         *      This is the port number of the host to connect to.
+         * @param[in] dataReceivedDelegate
+         *      This is the function to call to deliver data received
+         *      on the connection.
+         * @param[in] brokenDelegate
+         *      This is the function to call once the connection is broken.
+         * @param[in] completionDelegate
+         *      This is the function to call, exactly once, when the
+         *      attempt completes.  It may be called before this
+         *      method returns.
+         * @return
+         *      A function is returned which may be called
+         *      to cancel the attempt.
+         */
+        CancelDelegate ConnectAsync(const std::string& scheme,
+                                    const std::string& hostNameOrAddress, uint16_t port,
+                                    MqttV5::Connection::DataReceivedDelegate dataReceivedDelegate,
+                                    MqttV5::Connection::BrokenDelegate brokenDelegate,
+                                    ConnectCompletionDelegate completionDelegate);
+
+        /**
+         * This method starts establishing connections to all of the given
+         * targets, returning without waiting for them to complete.  Each
+         * distinct host is resolved once, and then non-blocking connect
+         * attempts are pipelined, subject to the concurrency cap and
+         * pacing set in the configuration, and to its connect deadline.
+         *
+         * @param[in] targets
+         *      These describe the connections to establish.
+         * @param[in] completionDelegate
+         *      This is the function to call, exactly once, when every
+         *      attempt has completed.  It may be called before this
+         *      method returns.
+         * @return
+         *      A function is returned which may be called to cancel the
+         *      attempts in progress and those not yet started.
+         */
+        CancelDelegate ConnectMany(std::vector<ConnectTarget> targets,
+                                   ConnectManyCompletionDelegate completionDelegate);
+
     public:
         virtual std::shared_ptr<MqttV5::Connection> Connect(
             const std::string& sheme, const std::string& hostNameOrAddress, uint16_t port,
@@ -83,9 +770,11 @@ namespace MqttNetworkTransport
         struct Impl;
 
         /**
-         * This contains the private properties of the instance.
+         * This contains the private properties of the instance.  It is
+         * shared with connect attempts in progress, which may outlive
+         * the transport.
          */
-        std::unique_ptr<Impl> impl_;
+        std::shared_ptr<Impl> impl_;
     };
 }  // namespace MqttNetworkTransport
 
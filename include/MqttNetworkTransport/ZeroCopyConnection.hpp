@@ -0,0 +1,76 @@
+#ifndef MQTT_NETWORK_TRANSPORT_ZERO_COPY_CONNECTION_HPP
+#define MQTT_NETWORK_TRANSPORT_ZERO_COPY_CONNECTION_HPP
+/**
+ * @file ZeroCopyConnection.hpp
+ *
+ * This module declares the MqttNetworkTransport::ZeroCopyConnection
+ * interface.
+ *
+ * © 2025 by Hatem Nabli
+ */
+#include <memory>
+#include <vector>
+#include <MqttV5/ClientTransportLayer.hpp>
+namespace MqttNetworkTransport
+{
+    /**
+     * This is implemented by the connections made by
+     * MqttClientNetworkTransport.  Beyond the MqttV5::Connection
+     * interface, it accepts outgoing data whose ownership is handed
+     * over, so that large payloads are never duplicated in memory
+     * on their way to the socket, and it reports statistics about
+     * the connection.
+     */
+    class ZeroCopyConnection : public MqttV5::Connection
+    {
+    public:
+        /**
+         * This is the type of buffer shared, by reference count,
+         * between the sender and the connection.
+         */
+        typedef std::shared_ptr<const std::vector<uint8_t>> SharedBuffer;
+
+        /**
+         * This holds statistics about a single connection.
+         */
+        struct ConnectionStatistics
+        {
+            /**
+             * This indicates whether or not the connection was established
+             * with TCP Fast Open, its first data having been carried in
+             * the SYN segment and accepted by the broker.
+             */
+            bool fastOpenUsed = false;
+        };
+
+        using MqttV5::Connection::SendData;
+
+        /**
+         * This method sends the given data, taking ownership of it.
+         *
+         * @param[in] data
+         *      This is the data to send.
+         */
+        virtual void SendData(std::vector<uint8_t>&& data) = 0;
+
+        /**
+         * This method sends the given data, holding a reference to it
+         * until it has been written.  The data must not be changed
+         * while the connection holds a reference to it.
+         *
+         * @param[in] data
+         *      This is the data to send.
+         */
+        virtual void SendData(SharedBuffer data) = 0;
+
+        /**
+         * This method returns statistics about the connection.
+         *
+         * @return
+         *      The statistics of the connection are returned.
+         */
+        virtual ConnectionStatistics GetConnectionStatistics() = 0;
+    };
+}  // namespace MqttNetworkTransport
+
+#endif /** MQTT_NETWORK_TRANSPORT_ZERO_COPY_CONNECTION_HPP */
@@ -0,0 +1,55 @@
+#ifndef MQTT_NETWORK_TRANSPORT_ASYNC_NETWORK_CONNECTION_HPP
+#define MQTT_NETWORK_TRANSPORT_ASYNC_NETWORK_CONNECTION_HPP
+/**
+ * @file AsyncNetworkConnection.hpp
+ *
+ * This module declares the MqttNetworkTransport::AsyncNetworkConnection
+ * interface.
+ *
+ * © 2025 by Hatem Nabli
+ */
+
+#include "GatherNetworkConnection.hpp"
+#include <functional>
+#include <stdint.h>
+
+namespace MqttNetworkTransport
+{
+    /**
+     * This is implemented by gathering network connections which can
+     * also establish themselves without blocking the calling thread.
+     */
+    class AsyncNetworkConnection : public GatherNetworkConnection
+    {
+    public:
+        /**
+         * This is the type of function called once an asynchronous
+         * connect attempt completes.
+         *
+         * @param[in] connected
+         *      This indicates whether or not the connection
+         *      was established.
+         */
+        typedef std::function<void(bool connected)> ConnectDelegate;
+
+        /**
+         * This method starts establishing a connection to the given peer,
+         * returning without waiting for it to complete.  Closing the
+         * connection before then abandons the attempt, which then
+         * completes unsuccessfully.
+         *
+         * @param[in] peerAddress
+         *      This is the IPv4 address of the peer, in host byte order.
+         * @param[in] peerPort
+         *      This is the port number of the peer.
+         * @param[in] connectDelegate
+         *      This is the function to call, exactly once, when the
+         *      attempt completes.  It may be called before this
+         *      method returns.
+         */
+        virtual void ConnectAsync(uint32_t peerAddress, uint16_t peerPort,
+                                  ConnectDelegate connectDelegate) = 0;
+    };
+}  // namespace MqttNetworkTransport
+
+#endif /** MQTT_NETWORK_TRANSPORT_ASYNC_NETWORK_CONNECTION_HPP */
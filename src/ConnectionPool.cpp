@@ -0,0 +1,796 @@
+/**
+ * @file ConnectionPool.cpp
+ *
+ * This module implements the MqttNetworkTransport::ConnectionPool class.
+ *
+ * © 2025 by Hatem Nabli
+ */
+
+#include "MqttNetworkTransport/ConnectionPool.hpp"
+#include "TimerQueue.hpp"
+#include <chrono>
+#include <deque>
+#include <inttypes.h>
+#include <map>
+#include <mutex>
+#include <vector>
+
+namespace
+{
+    /**
+     * This holds what the pool needs to know about a warm connection
+     * in order to handle it breaking, before or after it is handed out.
+     */
+    struct Watch
+    {
+        /**
+         * This is used to synchronize access to the watch.
+         */
+        std::mutex mutex;
+
+        /**
+         * This indicates whether or not the connection has broken.
+         */
+        bool broken = false;
+
+        /**
+         * This indicates whether or not the connection
+         * has been handed out.
+         */
+        bool handedOut = false;
+
+        /**
+         * This is the function to call once the connection is broken,
+         * if it has been handed out.
+         */
+        MqttV5::Connection::BrokenDelegate brokenDelegate;
+    };
+
+    /**
+     * This holds a connection kept warm for a target.
+     */
+    struct WarmConnection
+    {
+        /**
+         * This is the connection.
+         */
+        std::shared_ptr<MqttV5::Connection> connection;
+
+        /**
+         * This is what the pool knows about the connection.
+         */
+        std::shared_ptr<Watch> watch;
+
+        /**
+         * This identifies the timer which closes the connection
+         * once it has been kept warm for too long, if any.
+         */
+        MqttNetworkTransport::TimerQueue::Token expiryTimer = 0;
+    };
+
+    /**
+     * This holds the state of a target to which connections are kept warm.
+     */
+    struct Target
+    {
+        /**
+         * This identifies the target, in the map of targets
+         * and in diagnostic messages.
+         */
+        std::string key;
+
+        /**
+         * These are the scheme, host and port of the target.
+         */
+        std::string scheme;
+        std::string host;
+        uint16_t port = 0;
+
+        /**
+         * These are the warm connections to the target,
+         * from the oldest to the newest.
+         */
+        std::deque<WarmConnection> warm;
+
+        /**
+         * These are the functions to call to stop opening each warm
+         * connection being opened to the target, keyed by what the pool
+         * knows about the connection.  A function is null until the
+         * attempt to open the connection has started.
+         */
+        std::map<std::shared_ptr<Watch>,
+                 MqttNetworkTransport::MqttClientNetworkTransport::CancelDelegate>
+            opening;
+
+        /**
+         * This indicates whether or not the target was evicted or the
+         * pool released, in which case nothing more is done for it.
+         */
+        bool retired = false;
+
+        /**
+         * This is when the target was last connected to or prewarmed.
+         */
+        std::chrono::steady_clock::time_point lastUsed;
+
+        /**
+         * This identifies the timer which evicts the target once
+         * it goes unused for long enough, if any.
+         */
+        MqttNetworkTransport::TimerQueue::Token idleTimer = 0;
+
+        /**
+         * This identifies the timer which opens warm connections to
+         * the target again after a failure, if any.  While it is
+         * pending, no warm connections are opened.
+         */
+        MqttNetworkTransport::TimerQueue::Token replenishTimer = 0;
+    };
+
+    /**
+     * This function returns the string which identifies
+     * the given target.
+     *
+     * @param[in] scheme
+     *      This is the scheme of the target.
+     * @param[in] hostNameOrAddress
+     *      This is the name or address of the host of the target.
+     * @param[in] port
+     *      This is the port number of the target.
+     * @return
+     *      The string which identifies the target is returned.
+     */
+    std::string MakeKey(const std::string& scheme, const std::string& hostNameOrAddress,
+                        uint16_t port) {
+        if (hostNameOrAddress.find(':') != std::string::npos)
+        {
+            return StringUtils::sprintf("%s://[%s]:%" PRIu16, scheme.c_str(),
+                                        hostNameOrAddress.c_str(), port);
+        }
+        return StringUtils::sprintf("%s://%s:%" PRIu16, scheme.c_str(),
+                                    hostNameOrAddress.c_str(), port);
+    }
+}  // namespace
+
+namespace MqttNetworkTransport
+{
+    /**
+     * This contains the private properties of a ConnectionPool instance.
+     */
+    struct ConnectionPool::Impl : public std::enable_shared_from_this<ConnectionPool::Impl>
+    {
+        /**
+         * This is a helper object used to generate and publish
+         * diagnostic messages.
+         */
+        std::shared_ptr<SystemUtils::DiagnosticsSender> diagnosticsSender =
+            std::make_shared<SystemUtils::DiagnosticsSender>("ConnectionPool");
+
+        /**
+         * This is the transport used to establish connections.
+         */
+        std::shared_ptr<MqttClientNetworkTransport> transport;
+
+        /**
+         * This is used to synchronize access to the settings,
+         * targets and counters of the pool.
+         */
+        std::mutex mutex;
+
+        /**
+         * These are the current settings of the pool.
+         */
+        Configuration configuration;
+
+        /**
+         * These are the targets pooled, keyed by the
+         * strings which identify them.
+         */
+        std::map<std::string, std::shared_ptr<Target>> targets;
+
+        /**
+         * These are the counters of the pool.  The numbers of targets
+         * and warm connections are filled in when they are read.
+         */
+        Statistics statistics;
+
+        /**
+         * This is used to retire warm connections and evict targets.
+         * It is made when first needed.
+         */
+        std::shared_ptr<TimerQueue> timerQueue;
+
+        /**
+         * This method returns the timer queue of the pool, making it
+         * if this is the first time it's needed.  The caller must
+         * hold the mutex.
+         *
+         * @return
+         *      The timer queue of the pool is returned.
+         */
+        std::shared_ptr<TimerQueue> GetTimerQueue() {
+            if (timerQueue == nullptr)
+            { timerQueue = std::make_shared<TimerQueue>(); }
+            return timerQueue;
+        }
+
+        /**
+         * This method cancels the given timer, if it's pending, and
+         * clears its token.  The caller must hold the mutex.
+         *
+         * @param[in,out] timer
+         *      This identifies the timer to cancel.
+         */
+        void CancelTimer(TimerQueue::Token& timer) {
+            if ((timer != 0) && (timerQueue != nullptr))
+            { timerQueue->Cancel(timer); }
+            timer = 0;
+        }
+
+        /**
+         * This method returns the given target, adding it to
+         * the pool if it isn't there yet.  The caller must
+         * hold the mutex.
+         *
+         * @param[in] scheme
+         *      This is the scheme of the target.
+         * @param[in] hostNameOrAddress
+         *      This is the name or address of the host of the target.
+         * @param[in] port
+         *      This is the port number of the target.
+         * @return
+         *      The target is returned.
+         */
+        std::shared_ptr<Target> AddTarget(const std::string& scheme,
+                                          const std::string& hostNameOrAddress, uint16_t port) {
+            const auto key = MakeKey(scheme, hostNameOrAddress, port);
+            auto& target = targets[key];
+            if (target == nullptr)
+            {
+                target = std::make_shared<Target>();
+                target->key = key;
+                target->scheme = scheme;
+                target->host = hostNameOrAddress;
+                target->port = port;
+            }
+            target->lastUsed = std::chrono::steady_clock::now();
+            ScheduleEviction(target);
+            return target;
+        }
+
+        /**
+         * This method schedules evicting the given target once it goes
+         * unused for long enough, unless eviction is off or already
+         * scheduled.  The caller must hold the mutex.
+         *
+         * @param[in] target
+         *      This is the target to evict.
+         */
+        void ScheduleEviction(const std::shared_ptr<Target>& target) {
+            if ((configuration.idleEvictionMilliseconds == 0) || (target->idleTimer != 0))
+            { return; }
+            std::weak_ptr<Impl> implWeak(shared_from_this());
+            target->idleTimer = GetTimerQueue()->Schedule(
+                target->lastUsed +
+                    std::chrono::milliseconds(configuration.idleEvictionMilliseconds),
+                [implWeak, target]
+                {
+                    const auto impl = implWeak.lock();
+                    if (impl != nullptr)
+                    { impl->OnIdle(target); }
+                });
+        }
+
+        /**
+         * This method is called once the given target may have gone
+         * unused for long enough to be evicted.  If it was used since
+         * the eviction was scheduled, the eviction is scheduled again.
+         *
+         * @param[in] target
+         *      This is the target to evict.
+         */
+        void OnIdle(const std::shared_ptr<Target>& target) {
+            std::vector<std::shared_ptr<MqttV5::Connection>> closed;
+            std::vector<MqttClientNetworkTransport::CancelDelegate> cancels;
+            {
+                std::lock_guard<decltype(mutex)> lock(mutex);
+                target->idleTimer = 0;
+                if (target->retired)
+                { return; }
+                if (configuration.idleEvictionMilliseconds == 0)
+                { return; }
+                const auto due =
+                    target->lastUsed +
+                    std::chrono::milliseconds(configuration.idleEvictionMilliseconds);
+                if (std::chrono::steady_clock::now() < due)
+                {
+                    ScheduleEviction(target);
+                    return;
+                }
+                Retire(*target, closed, cancels);
+                targets.erase(target->key);
+                ++statistics.evictedTargets;
+                diagnosticsSender->SendDiagnosticInformationFormatted(
+                    1, "Evicted '%s' from the pool", target->key.c_str());
+            }
+            Release(closed, cancels);
+        }
+
+        /**
+         * This method starts opening as many warm connections to the
+         * given target as it lacks, unless the target was retired or
+         * is waiting to retry after a failure.
+         *
+         * @param[in] target
+         *      This is the target to which to open warm connections.
+         */
+        void Replenish(const std::shared_ptr<Target>& target) {
+            std::vector<std::shared_ptr<Watch>> watches;
+            {
+                std::lock_guard<decltype(mutex)> lock(mutex);
+                if (target->retired || (target->replenishTimer != 0))
+                { return; }
+                const auto have = target->warm.size() + target->opening.size();
+                for (auto i = have; i < configuration.warmConnections; ++i)
+                {
+                    const auto watch = std::make_shared<Watch>();
+                    target->opening[watch] = nullptr;
+                    watches.push_back(watch);
+                }
+            }
+            std::weak_ptr<Impl> implWeak(shared_from_this());
+            for (const auto& watch : watches)
+            {
+                const auto cancel = transport->ConnectAsync(
+                    target->scheme, target->host, target->port,
+                    [](const std::vector<uint8_t>&) {}, MakeBrokenDelegate(target, watch),
+                    [implWeak, target, watch](std::shared_ptr<MqttV5::Connection> connection)
+                    {
+                        const auto impl = implWeak.lock();
+                        if (impl == nullptr)
+                        {
+                            if (connection != nullptr)
+                            { connection->Break(false); }
+                            return;
+                        }
+                        impl->OnOpened(target, watch, connection);
+                    });
+                std::lock_guard<decltype(mutex)> lock(mutex);
+                const auto opening = target->opening.find(watch);
+                if (opening != target->opening.end())
+                { opening->second = cancel; }
+            }
+        }
+
+        /**
+         * This method schedules opening as many warm connections to the
+         * given target as it lacks, on the thread of the timer queue,
+         * so that the caller doesn't wait for the attempts to start.
+         * The caller must hold the mutex.
+         *
+         * @param[in] target
+         *      This is the target to which to open warm connections.
+         */
+        void ReplenishLater(const std::shared_ptr<Target>& target) {
+            std::weak_ptr<Impl> implWeak(shared_from_this());
+            GetTimerQueue()->Schedule(std::chrono::steady_clock::now(),
+                                      [implWeak, target]
+                                      {
+                                          const auto impl = implWeak.lock();
+                                          if (impl != nullptr)
+                                          { impl->Replenish(target); }
+                                      });
+        }
+
+        /**
+         * This method schedules opening warm connections to the given
+         * target again, once the retry delay has passed.  The caller
+         * must hold the mutex.
+         *
+         * @param[in] target
+         *      This is the target to which to open warm connections.
+         */
+        void ScheduleReplenishRetry(const std::shared_ptr<Target>& target) {
+            if (target->replenishTimer != 0)
+            { return; }
+            std::weak_ptr<Impl> implWeak(shared_from_this());
+            target->replenishTimer = GetTimerQueue()->Schedule(
+                std::chrono::steady_clock::now() +
+                    std::chrono::milliseconds(configuration.replenishRetryMilliseconds),
+                [implWeak, target]
+                {
+                    const auto impl = implWeak.lock();
+                    if (impl == nullptr)
+                    { return; }
+                    {
+                        std::lock_guard<decltype(impl->mutex)> lock(impl->mutex);
+                        target->replenishTimer = 0;
+                    }
+                    impl->Replenish(target);
+                });
+        }
+
+        /**
+         * This method makes the function which a warm connection calls
+         * once it is broken.  Until the connection is handed out, this
+         * tells the pool to replace it.  Afterwards, it calls the broken
+         * delegate given when it was handed out.
+         *
+         * @param[in] target
+         *      This is the target of the connection.
+         * @param[in] watch
+         *      This is what the pool knows about the connection.
+         * @return
+         *      The function to give the connection is returned.
+         */
+        MqttV5::Connection::BrokenDelegate MakeBrokenDelegate(std::shared_ptr<Target> target,
+                                                              std::shared_ptr<Watch> watch) {
+            std::weak_ptr<Impl> implWeak(shared_from_this());
+            return [implWeak, target, watch](bool graceful)
+            {
+                bool handedOut;
+                MqttV5::Connection::BrokenDelegate brokenDelegate;
+                {
+                    std::lock_guard<decltype(watch->mutex)> lock(watch->mutex);
+                    if (watch->broken)
+                    { return; }
+                    watch->broken = true;
+                    handedOut = watch->handedOut;
+                    brokenDelegate = watch->brokenDelegate;
+                }
+                if (handedOut)
+                {
+                    if (brokenDelegate != nullptr)
+                    { brokenDelegate(graceful); }
+                    return;
+                }
+                const auto impl = implWeak.lock();
+                if (impl != nullptr)
+                { impl->OnWarmBroken(target, watch); }
+            };
+        }
+
+        /**
+         * This method is called once an attempt to open a warm
+         * connection completes.
+         *
+         * @param[in] target
+         *      This is the target of the connection.
+         * @param[in] watch
+         *      This is what the pool knows about the connection.
+         * @param[in] connection
+         *      This is the connection established, or nullptr
+         *      if the attempt failed.
+         */
+        void OnOpened(const std::shared_ptr<Target>& target, const std::shared_ptr<Watch>& watch,
+                      std::shared_ptr<MqttV5::Connection> connection) {
+            {
+                std::lock_guard<decltype(mutex)> lock(mutex);
+                const auto opening = target->opening.find(watch);
+                if (!target->retired && (opening != target->opening.end()))
+                {
+                    target->opening.erase(opening);
+                    if (connection == nullptr)
+                    {
+                        ++statistics.openFailures;
+                        diagnosticsSender->SendDiagnosticInformationFormatted(
+                            SystemUtils::DiagnosticsSender::Levels::WARNING,
+                            "Unable to open warm connection to '%s'", target->key.c_str());
+                        ScheduleReplenishRetry(target);
+                        return;
+                    }
+                    if (target->warm.size() < configuration.warmConnections)
+                    {
+                        ++statistics.opened;
+                        WarmConnection warm;
+                        warm.connection = connection;
+                        warm.watch = watch;
+                        if (configuration.maxWarmMilliseconds != 0)
+                        {
+                            std::weak_ptr<Impl> implWeak(shared_from_this());
+                            warm.expiryTimer = GetTimerQueue()->Schedule(
+                                std::chrono::steady_clock::now() +
+                                    std::chrono::milliseconds(configuration.maxWarmMilliseconds),
+                                [implWeak, target, watch]
+                                {
+                                    const auto impl = implWeak.lock();
+                                    if (impl != nullptr)
+                                    { impl->OnExpired(target, watch); }
+                                });
+                        }
+                        target->warm.push_back(warm);
+                        return;
+                    }
+                }
+            }
+            if (connection != nullptr)
+            { connection->Break(false); }
+        }
+
+        /**
+         * This method removes the given warm connection from those of
+         * the given target, if it's still there.  The caller must
+         * hold the mutex.
+         *
+         * @param[in] target
+         *      This is the target of the connection.
+         * @param[in] watch
+         *      This is what the pool knows about the connection.
+         * @return
+         *      The connection removed is returned, or nullptr if
+         *      it wasn't among the warm connections of the target.
+         */
+        std::shared_ptr<MqttV5::Connection> RemoveWarm(Target& target,
+                                                       const std::shared_ptr<Watch>& watch) {
+            for (auto warm = target.warm.begin(); warm != target.warm.end(); ++warm)
+            {
+                if (warm->watch == watch)
+                {
+                    const auto connection = warm->connection;
+                    CancelTimer(warm->expiryTimer);
+                    target.warm.erase(warm);
+                    return connection;
+                }
+            }
+            return nullptr;
+        }
+
+        /**
+         * This method is called once a warm connection breaks
+         * before being handed out.
+         *
+         * @param[in] target
+         *      This is the target of the connection.
+         * @param[in] watch
+         *      This is what the pool knows about the connection.
+         */
+        void OnWarmBroken(const std::shared_ptr<Target>& target,
+                          const std::shared_ptr<Watch>& watch) {
+            std::lock_guard<decltype(mutex)> lock(mutex);
+            if (target->retired || (RemoveWarm(*target, watch) == nullptr))
+            { return; }
+            ++statistics.broken;
+            diagnosticsSender->SendDiagnosticInformationFormatted(
+                SystemUtils::DiagnosticsSender::Levels::WARNING,
+                "Warm connection to '%s' broken", target->key.c_str());
+            ScheduleReplenishRetry(target);
+        }
+
+        /**
+         * This method is called once a warm connection has been
+         * kept warm for too long, to close and replace it.
+         *
+         * @param[in] target
+         *      This is the target of the connection.
+         * @param[in] watch
+         *      This is what the pool knows about the connection.
+         */
+        void OnExpired(const std::shared_ptr<Target>& target, const std::shared_ptr<Watch>& watch) {
+            std::shared_ptr<MqttV5::Connection> connection;
+            {
+                std::lock_guard<decltype(mutex)> lock(mutex);
+                if (target->retired)
+                { return; }
+                for (auto& warm : target->warm)
+                {
+                    if (warm.watch == watch)
+                    { warm.expiryTimer = 0; }
+                }
+                connection = RemoveWarm(*target, watch);
+                if (connection == nullptr)
+                { return; }
+                ++statistics.expired;
+            }
+            connection->Break(false);
+            Replenish(target);
+        }
+
+        /**
+         * This method hands out the oldest warm connection of the given
+         * target which hasn't broken, if any.  The caller must hold
+         * the mutex.
+         *
+         * @param[in] target
+         *      This is the target whose warm connection to hand out.
+         * @param[in] brokenDelegate
+         *      This is the function to call once the connection is broken.
+         * @return
+         *      The connection handed out is returned, or nullptr
+         *      if the target has no warm connection.
+         */
+        std::shared_ptr<MqttV5::Connection> TakeWarm(
+            Target& target, MqttV5::Connection::BrokenDelegate brokenDelegate) {
+            while (!target.warm.empty())
+            {
+                auto warm = target.warm.front();
+                target.warm.pop_front();
+                CancelTimer(warm.expiryTimer);
+                std::lock_guard<decltype(warm.watch->mutex)> lock(warm.watch->mutex);
+                if (warm.watch->broken)
+                { continue; }
+                warm.watch->handedOut = true;
+                warm.watch->brokenDelegate = brokenDelegate;
+                return warm.connection;
+            }
+            return nullptr;
+        }
+
+        /**
+         * This method closes the warm connections of the given target
+         * beyond the given number, starting from the newest.  The caller
+         * must hold the mutex.
+         *
+         * @param[in] target
+         *      This is the target whose warm connections to close.
+         * @param[in] keep
+         *      This is the number of warm connections to keep.
+         * @param[out] closed
+         *      The connections, which the caller should break once it
+         *      releases the mutex, are added here.
+         */
+        void Trim(Target& target, size_t keep,
+                  std::vector<std::shared_ptr<MqttV5::Connection>>& closed) {
+            while (target.warm.size() > keep)
+            {
+                auto& warm = target.warm.back();
+                CancelTimer(warm.expiryTimer);
+                closed.push_back(warm.connection);
+                target.warm.pop_back();
+            }
+        }
+
+        /**
+         * This method stops pooling the given target.  The caller
+         * must hold the mutex.
+         *
+         * @param[in] target
+         *      This is the target to stop pooling.
+         * @param[out] closed
+         *      The warm connections, which the caller should break
+         *      once it releases the mutex, are added here.
+         * @param[out] cancels
+         *      The functions which the caller should call to stop
+         *      opening warm connections, once it releases the
+         *      mutex, are added here.
+         */
+        void Retire(Target& target, std::vector<std::shared_ptr<MqttV5::Connection>>& closed,
+                    std::vector<MqttClientNetworkTransport::CancelDelegate>& cancels) {
+            target.retired = true;
+            CancelTimer(target.idleTimer);
+            CancelTimer(target.replenishTimer);
+            Trim(target, 0, closed);
+            for (const auto& opening : target.opening)
+            {
+                if (opening.second != nullptr)
+                { cancels.push_back(opening.second); }
+            }
+            target.opening.clear();
+        }
+
+        /**
+         * This method closes the given warm connections and stops
+         * opening others.  The caller must not hold the mutex.
+         *
+         * @param[in] closed
+         *      These are the warm connections to break.
+         * @param[in] cancels
+         *      These are the functions to call to stop
+         *      opening warm connections.
+         */
+        static void Release(
+            const std::vector<std::shared_ptr<MqttV5::Connection>>& closed,
+            const std::vector<MqttClientNetworkTransport::CancelDelegate>& cancels) {
+            for (const auto& cancel : cancels)
+            { cancel(); }
+            for (const auto& connection : closed)
+            { connection->Break(false); }
+        }
+    };
+
+    ConnectionPool::~ConnectionPool() noexcept {
+        std::vector<std::shared_ptr<MqttV5::Connection>> closed;
+        std::vector<MqttClientNetworkTransport::CancelDelegate> cancels;
+        {
+            std::lock_guard<decltype(impl_->mutex)> lock(impl_->mutex);
+            for (const auto& target : impl_->targets)
+            { impl_->Retire(*target.second, closed, cancels); }
+            impl_->targets.clear();
+        }
+        Impl::Release(closed, cancels);
+    }
+
+    ConnectionPool::ConnectionPool(std::shared_ptr<MqttClientNetworkTransport> transport) :
+        impl_(std::make_shared<Impl>()) {
+        impl_->transport = transport;
+    }
+
+    SystemUtils::DiagnosticsSender::UnsubscribeDelegate ConnectionPool::SubscribeToDiagnostics(
+        SystemUtils::DiagnosticsSender::DiagnosticMessageDelegate delegate, size_t minLevel) {
+        return impl_->diagnosticsSender->SubscribeToDiagnostics(delegate, minLevel);
+    }
+
+    void ConnectionPool::Configure(const Configuration& configuration) {
+        std::vector<std::shared_ptr<MqttV5::Connection>> closed;
+        std::vector<MqttClientNetworkTransport::CancelDelegate> cancels;
+        std::vector<std::shared_ptr<Target>> targets;
+        {
+            std::lock_guard<decltype(impl_->mutex)> lock(impl_->mutex);
+            impl_->configuration = configuration;
+            for (const auto& target : impl_->targets)
+            {
+                if (configuration.warmConnections == 0)
+                {
+                    impl_->Retire(*target.second, closed, cancels);
+                    continue;
+                }
+                impl_->Trim(*target.second, configuration.warmConnections, closed);
+                if (configuration.idleEvictionMilliseconds == 0)
+                { impl_->CancelTimer(target.second->idleTimer); } else
+                { impl_->ScheduleEviction(target.second); }
+                targets.push_back(target.second);
+            }
+            if (configuration.warmConnections == 0)
+            { impl_->targets.clear(); }
+        }
+        Impl::Release(closed, cancels);
+        for (const auto& target : targets)
+        { impl_->Replenish(target); }
+    }
+
+    void ConnectionPool::Prewarm(const std::string& scheme, const std::string& hostNameOrAddress,
+                                 uint16_t port) {
+        std::shared_ptr<Target> target;
+        {
+            std::lock_guard<decltype(impl_->mutex)> lock(impl_->mutex);
+            if (impl_->configuration.warmConnections == 0)
+            { return; }
+            target = impl_->AddTarget(scheme, hostNameOrAddress, port);
+        }
+        impl_->Replenish(target);
+    }
+
+    auto ConnectionPool::GetStatistics() const -> Statistics {
+        std::lock_guard<decltype(impl_->mutex)> lock(impl_->mutex);
+        auto statistics = impl_->statistics;
+        statistics.targets = impl_->targets.size();
+        for (const auto& target : impl_->targets)
+        { statistics.warm += target.second->warm.size(); }
+        return statistics;
+    }
+
+    std::shared_ptr<MqttV5::Connection> ConnectionPool::Connect(
+        const std::string& scheme, const std::string& hostNameOrAddress, uint16_t port,
+        MqttV5::Connection::DataReceivedDelegate dataReceivedDelegate,
+        MqttV5::Connection::BrokenDelegate brokenDelegate) {
+        std::shared_ptr<Target> target;
+        std::shared_ptr<MqttV5::Connection> connection;
+        {
+            std::lock_guard<decltype(impl_->mutex)> lock(impl_->mutex);
+            if (impl_->configuration.warmConnections != 0)
+            {
+                const auto found =
+                    impl_->targets.find(MakeKey(scheme, hostNameOrAddress, port));
+                if (found != impl_->targets.end())
+                {
+                    target = found->second;
+                    target->lastUsed = std::chrono::steady_clock::now();
+                } else if (impl_->configuration.warmOnConnect)
+                { target = impl_->AddTarget(scheme, hostNameOrAddress, port); }
+                if (target != nullptr)
+                { connection = impl_->TakeWarm(*target, brokenDelegate); }
+                if (connection == nullptr)
+                { ++impl_->statistics.misses; } else
+                { ++impl_->statistics.hits; }
+                if (target != nullptr)
+                { impl_->ReplenishLater(target); }
+            }
+        }
+        if (connection == nullptr)
+        {
+            return impl_->transport->Connect(scheme, hostNameOrAddress, port,
+                                             dataReceivedDelegate, brokenDelegate);
+        }
+        connection->SetDataReceivedDelegate(dataReceivedDelegate);
+        return connection;
+    }
+}  // namespace MqttNetworkTransport
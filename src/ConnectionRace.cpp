@@ -0,0 +1,244 @@
+/**
+ * @file ConnectionRace.cpp
+ *
+ * This module implements the MqttNetworkTransport::ConnectionRace class.
+ *
+ * © 2025 by Hatem Nabli
+ */
+
+#include "ConnectionRace.hpp"
+#include <mutex>
+#include <vector>
+
+namespace MqttNetworkTransport
+{
+    constexpr size_t ConnectionRace::NO_WINNER;
+
+    struct ConnectionRace::Impl : public std::enable_shared_from_this<Impl>
+    {
+        /**
+         * This is used to synchronize access to the state of the race.
+         */
+        std::mutex mutex;
+
+        /**
+         * This is the number of addresses to which to race.
+         */
+        size_t addressCount = 0;
+
+        /**
+         * This is how long to wait for an attempt before
+         * starting the next one.
+         */
+        std::chrono::milliseconds attemptDelay{0};
+
+        /**
+         * This is used to start attempts once the delay passes.
+         */
+        std::shared_ptr<TimerQueue> timerQueue;
+
+        /**
+         * This is the function to call to start each attempt.
+         * It is released once the race is over.
+         */
+        StartAttemptDelegate startAttempt;
+
+        /**
+         * This is the function to call to abandon each attempt
+         * which doesn't win.
+         */
+        AbandonAttemptDelegate abandonAttempt;
+
+        /**
+         * This is the function to call when the race is over.
+         */
+        CompletionDelegate completion;
+
+        /**
+         * This is the number of attempts started so far.
+         */
+        size_t started = 0;
+
+        /**
+         * This is the number of attempts which failed so far.
+         */
+        size_t failed = 0;
+
+        /**
+         * These indicate, for each address, whether or not
+         * its attempt has completed.
+         */
+        std::vector<bool> completed;
+
+        /**
+         * This indicates whether or not the race is over.
+         */
+        bool over = false;
+
+        /**
+         * This identifies the timer which starts the next attempt, if any.
+         */
+        TimerQueue::Token timer = 0;
+
+        /**
+         * This method starts the next attempt, if any remain
+         * and the race isn't over.
+         */
+        void StartNext() {
+            size_t index;
+            StartAttemptDelegate start;
+            std::shared_ptr<TimerQueue> delayTimerQueue;
+            {
+                std::lock_guard<decltype(mutex)> lock(mutex);
+                if (over || (started == addressCount))
+                { return; }
+                index = started++;
+                start = startAttempt;
+                if ((started < addressCount) && (attemptDelay.count() != 0))
+                { delayTimerQueue = timerQueue; }
+            }
+            if (delayTimerQueue != nullptr)
+            {
+                std::weak_ptr<Impl> selfWeak(shared_from_this());
+                const auto next = index + 1;
+                const auto token = delayTimerQueue->Schedule(
+                    std::chrono::steady_clock::now() + attemptDelay,
+                    [selfWeak, next]
+                    {
+                        const auto self = selfWeak.lock();
+                        if (self != nullptr)
+                        { self->OnDelayPassed(next); }
+                    });
+                std::lock_guard<decltype(mutex)> lock(mutex);
+                timer = token;
+            }
+            const auto self = shared_from_this();
+            start(index, [self, index](bool connected)
+                  { self->OnAttemptCompleted(index, connected); });
+        }
+
+        /**
+         * This method is called once the connection attempt delay has
+         * passed since an attempt started.
+         *
+         * @param[in] next
+         *      This is the number of attempts which had started when
+         *      the delay began, including the one which started it.
+         */
+        void OnDelayPassed(size_t next) {
+            {
+                std::lock_guard<decltype(mutex)> lock(mutex);
+                if (started != next)
+                { return; }
+            }
+            StartNext();
+        }
+
+        /**
+         * This method is called once an attempt completes.
+         *
+         * @param[in] index
+         *      This is the index of the address of the attempt.
+         * @param[in] connected
+         *      This indicates whether or not the attempt succeeded.
+         */
+        void OnAttemptCompleted(size_t index, bool connected) {
+            std::vector<size_t> losers;
+            CompletionDelegate finished;
+            size_t winner = NO_WINNER;
+            TimerQueue::Token pendingTimer = 0;
+            {
+                std::lock_guard<decltype(mutex)> lock(mutex);
+                if (over || completed[index])
+                {
+                    if (connected)
+                    { losers.push_back(index); }
+                } else
+                {
+                    completed[index] = true;
+                    if (connected)
+                    {
+                        winner = index;
+                        for (size_t i = 0; i < started; ++i)
+                        {
+                            if (!completed[i])
+                            { losers.push_back(i); }
+                        }
+                    } else
+                    { ++failed; }
+                    if (connected || (failed == addressCount))
+                    {
+                        over = true;
+                        startAttempt = nullptr;
+                        finished.swap(completion);
+                        pendingTimer = timer;
+                    }
+                }
+            }
+            if ((pendingTimer != 0) && (timerQueue != nullptr))
+            { timerQueue->Cancel(pendingTimer); }
+            for (const auto loser : losers)
+            { abandonAttempt(loser); }
+            if (finished != nullptr)
+            {
+                finished(winner);
+                return;
+            }
+            if (!connected)
+            { StartNext(); }
+        }
+    };
+
+    ConnectionRace::~ConnectionRace() noexcept = default;
+
+    ConnectionRace::ConnectionRace(size_t addressCount, std::chrono::milliseconds attemptDelay,
+                                   std::shared_ptr<TimerQueue> timerQueue) :
+        impl_(std::make_shared<Impl>()) {
+        impl_->addressCount = addressCount;
+        impl_->attemptDelay = attemptDelay;
+        impl_->timerQueue = timerQueue;
+        impl_->completed.resize(addressCount);
+    }
+
+    void ConnectionRace::Start(StartAttemptDelegate startAttempt,
+                               AbandonAttemptDelegate abandonAttempt,
+                               CompletionDelegate completion) {
+        {
+            std::lock_guard<decltype(impl_->mutex)> lock(impl_->mutex);
+            impl_->startAttempt = startAttempt;
+            impl_->abandonAttempt = abandonAttempt;
+            impl_->completion = completion;
+            if (impl_->addressCount == 0)
+            { impl_->over = true; }
+        }
+        if (impl_->addressCount == 0)
+        {
+            completion(NO_WINNER);
+            return;
+        }
+        impl_->StartNext();
+    }
+
+    void ConnectionRace::Cancel() {
+        std::vector<size_t> abandoned;
+        TimerQueue::Token pendingTimer = 0;
+        {
+            std::lock_guard<decltype(impl_->mutex)> lock(impl_->mutex);
+            if (impl_->over)
+            { return; }
+            impl_->over = true;
+            impl_->startAttempt = nullptr;
+            impl_->completion = nullptr;
+            pendingTimer = impl_->timer;
+            for (size_t i = 0; i < impl_->started; ++i)
+            {
+                if (!impl_->completed[i])
+                { abandoned.push_back(i); }
+            }
+        }
+        if ((pendingTimer != 0) && (impl_->timerQueue != nullptr))
+        { impl_->timerQueue->Cancel(pendingTimer); }
+        for (const auto index : abandoned)
+        { impl_->abandonAttempt(index); }
+    }
+}  // namespace MqttNetworkTransport
@@ -0,0 +1,143 @@
+#ifndef MQTT_NETWORK_TRANSPORT_CONNECTION_RACE_HPP
+#define MQTT_NETWORK_TRANSPORT_CONNECTION_RACE_HPP
+/**
+ * @file ConnectionRace.hpp
+ *
+ * This module declares the MqttNetworkTransport::ConnectionRace class.
+ *
+ * © 2025 by Hatem Nabli
+ */
+
+#include "TimerQueue.hpp"
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <stddef.h>
+
+namespace MqttNetworkTransport
+{
+    /**
+     * This races connect attempts to the addresses of a host, as
+     * described in RFC 8305 ("Happy Eyeballs"): attempts are started in
+     * order, each one once the one before it has failed or once the
+     * connection attempt delay has passed since the last one started,
+     * whichever comes first.  The first attempt to succeed wins, and
+     * the others are abandoned.
+     */
+    class ConnectionRace
+    {
+    public:
+        /**
+         * This is the type of function called once a connect attempt
+         * completes.
+         *
+         * @param[in] connected
+         *      This indicates whether or not the attempt succeeded.
+         */
+        typedef std::function<void(bool connected)> AttemptCompletionDelegate;
+
+        /**
+         * This is the type of function called to start a connect attempt.
+         *
+         * @param[in] index
+         *      This is the index of the address to which to connect.
+         * @param[in] completion
+         *      This is the function to call, exactly once, when the
+         *      attempt completes.  It may be called before the
+         *      function returns.
+         */
+        typedef std::function<void(size_t index, AttemptCompletionDelegate completion)>
+            StartAttemptDelegate;
+
+        /**
+         * This is the type of function called to abandon a connect attempt
+         * which is still in progress, or which succeeded too late.
+         *
+         * @param[in] index
+         *      This is the index of the address of the attempt.
+         */
+        typedef std::function<void(size_t index)> AbandonAttemptDelegate;
+
+        /**
+         * This is the type of function called once the race is over.
+         *
+         * @param[in] winner
+         *      This is the index of the address of the attempt which
+         *      succeeded, or NO_WINNER if every attempt failed.
+         */
+        typedef std::function<void(size_t winner)> CompletionDelegate;
+
+        /**
+         * This is the index given to the completion delegate
+         * when every attempt failed.
+         */
+        static constexpr size_t NO_WINNER = (size_t)-1;
+
+        // Lifecycle management
+    public:
+        ~ConnectionRace() noexcept;
+        ConnectionRace(const ConnectionRace&) = delete;
+        ConnectionRace(ConnectionRace&&) noexcept = delete;
+        ConnectionRace& operator=(const ConnectionRace&) = delete;
+        ConnectionRace& operator=(ConnectionRace&&) noexcept = delete;
+
+        // Public methods
+    public:
+        /**
+         * This is the constructor.
+         *
+         * @param[in] addressCount
+         *      This is the number of addresses to which to race.
+         * @param[in] attemptDelay
+         *      This is how long to wait for an attempt before starting
+         *      the next one.  When it is zero, or there is no timer
+         *      queue, each attempt starts only once the one before
+         *      it has failed.
+         * @param[in] timerQueue
+         *      This is used to start attempts once the delay passes.
+         */
+        ConnectionRace(size_t addressCount, std::chrono::milliseconds attemptDelay,
+                       std::shared_ptr<TimerQueue> timerQueue);
+
+        /**
+         * This method starts the race with the first attempt.
+         *
+         * @param[in] startAttempt
+         *      This is the function to call to start each attempt.
+         * @param[in] abandonAttempt
+         *      This is the function to call to abandon each attempt
+         *      which doesn't win.
+         * @param[in] completion
+         *      This is the function to call, exactly once, when the race
+         *      is over, unless it is cancelled.  It may be called before
+         *      this method returns.
+         */
+        void Start(StartAttemptDelegate startAttempt, AbandonAttemptDelegate abandonAttempt,
+                   CompletionDelegate completion);
+
+        /**
+         * This method ends the race without a winner, abandoning the
+         * attempts in progress and not starting any more.  The completion
+         * delegate is not called.
+         */
+        void Cancel();
+
+        // Private properties
+    private:
+        /**
+         * This is the type of structure that contains the private
+         * properties of the instance.  It is defined in the implementation
+         * and declared here to ensure that it is scoped inside the class.
+         */
+        struct Impl;
+
+        /**
+         * This contains the private properties of the instance.  It is
+         * shared with the attempts and timers, which may complete after
+         * the race is destroyed.
+         */
+        std::shared_ptr<Impl> impl_;
+    };
+}  // namespace MqttNetworkTransport
+
+#endif /** MQTT_NETWORK_TRANSPORT_CONNECTION_RACE_HPP */
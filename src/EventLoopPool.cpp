@@ -0,0 +1,243 @@
+/**
+ * @file EventLoopPool.cpp
+ *
+ * This module implements the MqttNetworkTransport::EventLoopPool class.
+ *
+ * © 2025 by Hatem Nabli
+ */
+
+#include "EventLoopPool.hpp"
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+namespace
+{
+    /**
+     * This is the maximum number of events collected by one wait.
+     */
+    constexpr int MAXIMUM_EVENTS_PER_WAIT = 256;
+
+    /**
+     * This is the epoll data value reserved for a loop's wake-up descriptor.
+     */
+    constexpr uint64_t WAKE_ID = 0;
+
+    /**
+     * This holds the state of one event loop of the pool.
+     */
+    struct Loop
+    {
+        /**
+         * This is the epoll instance of the loop.
+         */
+        int epollFd = -1;
+
+        /**
+         * This is used to wake the loop up when it has tasks
+         * to run or should stop.
+         */
+        int wakeFd = -1;
+
+        /**
+         * This is the thread running the loop.
+         */
+        std::thread thread;
+
+        /**
+         * This is used to synchronize access to the handlers and tasks.
+         */
+        std::mutex mutex;
+
+        /**
+         * These are the delegates of the registered descriptors,
+         * keyed by registration identifier.
+         */
+        std::map<uint64_t, std::shared_ptr<MqttNetworkTransport::EventLoopPool::EventDelegate>>
+            handlers;
+
+        /**
+         * These are the functions queued to be called from the loop thread.
+         */
+        std::vector<std::function<void()>> tasks;
+
+        /**
+         * This flag indicates whether or not the loop should stop.
+         */
+        std::atomic<bool> stop{false};
+
+        ~Loop() noexcept {
+            if (wakeFd >= 0)
+            { (void)close(wakeFd); }
+            if (epollFd >= 0)
+            { (void)close(epollFd); }
+        }
+
+        /**
+         * This method wakes up the loop thread.
+         */
+        void Wake() {
+            const uint64_t one = 1;
+            (void)write(wakeFd, &one, sizeof(one));
+        }
+
+        /**
+         * This is the body of the loop thread.
+         */
+        void Run() {
+            epoll_event events[MAXIMUM_EVENTS_PER_WAIT];
+            std::vector<std::pair<std::shared_ptr<MqttNetworkTransport::EventLoopPool::EventDelegate>,
+                                  uint32_t>>
+                ready;
+            std::vector<std::function<void()>> readyTasks;
+            while (!stop)
+            {
+                const int count = epoll_wait(epollFd, events, MAXIMUM_EVENTS_PER_WAIT, -1);
+                if (count < 0)
+                { continue; }
+                {
+                    std::lock_guard<decltype(mutex)> lock(mutex);
+                    for (int i = 0; i < count; ++i)
+                    {
+                        if (events[i].data.u64 == WAKE_ID)
+                        {
+                            uint64_t value;
+                            (void)read(wakeFd, &value, sizeof(value));
+                            continue;
+                        }
+                        const auto handler = handlers.find(events[i].data.u64);
+                        if (handler != handlers.end())
+                        { ready.emplace_back(handler->second, (uint32_t)events[i].events); }
+                    }
+                    readyTasks.swap(tasks);
+                }
+                for (const auto& entry : ready)
+                { (*entry.first)(entry.second); }
+                ready.clear();
+                for (const auto& task : readyTasks)
+                { task(); }
+                readyTasks.clear();
+            }
+        }
+    };
+}  // namespace
+
+namespace MqttNetworkTransport
+{
+    struct EventLoopPool::Impl
+    {
+        /**
+         * These are the loops of the pool.  Each loop thread holds its own
+         * reference, so that the pool can be released from within a loop.
+         */
+        std::vector<std::shared_ptr<Loop>> loops;
+
+        /**
+         * This is the identifier to give the next registration.
+         */
+        std::atomic<uint64_t> nextId{WAKE_ID + 1};
+
+        /**
+         * This is the number of descriptors registered with each loop.
+         */
+        std::unique_ptr<std::atomic<size_t>[]> loads;
+    };
+
+    EventLoopPool::~EventLoopPool() noexcept {
+        for (const auto& loop : impl_->loops)
+        {
+            loop->stop = true;
+            loop->Wake();
+        }
+        for (const auto& loop : impl_->loops)
+        {
+            if (!loop->thread.joinable())
+            { continue; }
+            if (loop->thread.get_id() == std::this_thread::get_id())
+            { loop->thread.detach(); } else
+            { loop->thread.join(); }
+        }
+    }
+
+    EventLoopPool::EventLoopPool(size_t loopCount) : impl_(new Impl) {
+        if (loopCount == 0)
+        { loopCount = 1; }
+        impl_->loads.reset(new std::atomic<size_t>[loopCount]);
+        for (size_t i = 0; i < loopCount; ++i)
+        {
+            impl_->loads[i] = 0;
+            const auto loop = std::make_shared<Loop>();
+            loop->epollFd = epoll_create1(EPOLL_CLOEXEC);
+            loop->wakeFd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+            epoll_event event = {};
+            event.events = EPOLLIN;
+            event.data.u64 = WAKE_ID;
+            (void)epoll_ctl(loop->epollFd, EPOLL_CTL_ADD, loop->wakeFd, &event);
+            loop->thread = std::thread([loop] { loop->Run(); });
+            impl_->loops.push_back(loop);
+        }
+    }
+
+    size_t EventLoopPool::GetLoopCount() const { return impl_->loops.size(); }
+
+    auto EventLoopPool::Add(int fd, uint32_t events, EventDelegate eventDelegate) -> Registration {
+        Registration registration;
+        for (size_t i = 1; i < impl_->loops.size(); ++i)
+        {
+            if (impl_->loads[i] < impl_->loads[registration.loop])
+            { registration.loop = i; }
+        }
+        const auto& loop = impl_->loops[registration.loop];
+        const auto id = impl_->nextId++;
+        {
+            std::lock_guard<decltype(loop->mutex)> lock(loop->mutex);
+            loop->handlers[id] = std::make_shared<EventDelegate>(std::move(eventDelegate));
+        }
+        epoll_event event = {};
+        event.events = events;
+        event.data.u64 = id;
+        if (epoll_ctl(loop->epollFd, EPOLL_CTL_ADD, fd, &event) != 0)
+        {
+            std::lock_guard<decltype(loop->mutex)> lock(loop->mutex);
+            (void)loop->handlers.erase(id);
+            return Registration();
+        }
+        ++impl_->loads[registration.loop];
+        registration.id = id;
+        return registration;
+    }
+
+    bool EventLoopPool::Modify(const Registration& registration, int fd, uint32_t events) {
+        if (registration.id == WAKE_ID)
+        { return false; }
+        epoll_event event = {};
+        event.events = events;
+        event.data.u64 = registration.id;
+        return (epoll_ctl(impl_->loops[registration.loop]->epollFd, EPOLL_CTL_MOD, fd, &event) == 0);
+    }
+
+    void EventLoopPool::Remove(const Registration& registration, int fd) {
+        if (registration.id == WAKE_ID)
+        { return; }
+        const auto& loop = impl_->loops[registration.loop];
+        (void)epoll_ctl(loop->epollFd, EPOLL_CTL_DEL, fd, nullptr);
+        std::lock_guard<decltype(loop->mutex)> lock(loop->mutex);
+        if (loop->handlers.erase(registration.id) > 0)
+        { --impl_->loads[registration.loop]; }
+    }
+
+    void EventLoopPool::Post(size_t loop, std::function<void()> task) {
+        const auto& target = impl_->loops[loop % impl_->loops.size()];
+        {
+            std::lock_guard<decltype(target->mutex)> lock(target->mutex);
+            target->tasks.push_back(std::move(task));
+        }
+        target->Wake();
+    }
+}  // namespace MqttNetworkTransport
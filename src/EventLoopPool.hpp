@@ -0,0 +1,151 @@
+#ifndef MQTT_NETWORK_TRANSPORT_EVENT_LOOP_POOL_HPP
+#define MQTT_NETWORK_TRANSPORT_EVENT_LOOP_POOL_HPP
+/**
+ * @file EventLoopPool.hpp
+ *
+ * This module declares the MqttNetworkTransport::EventLoopPool class.
+ *
+ * © 2025 by Hatem Nabli
+ */
+
+#include <functional>
+#include <memory>
+#include <stddef.h>
+#include <stdint.h>
+
+namespace MqttNetworkTransport
+{
+    /**
+     * This is a fixed-size pool of epoll event-loop threads, over which
+     * any number of file descriptors may be multiplexed.  Each registered
+     * descriptor is served by exactly one loop, so the events of a given
+     * descriptor are never dispatched concurrently.
+     */
+    class EventLoopPool
+    {
+    public:
+        /**
+         * This is the type of function called from a loop thread
+         * whenever a registered descriptor has pending events.
+         *
+         * @param[in] events
+         *      These are the epoll events that are pending.
+         */
+        typedef std::function<void(uint32_t events)> EventDelegate;
+
+        /**
+         * This identifies a descriptor registered with the pool.
+         */
+        struct Registration
+        {
+            /**
+             * This is the index of the loop serving the descriptor.
+             */
+            size_t loop = 0;
+
+            /**
+             * This is the unique identifier of the registration.
+             * Zero means the registration is not valid.
+             */
+            uint64_t id = 0;
+        };
+
+        // Lifecycle management
+    public:
+        ~EventLoopPool() noexcept;
+        EventLoopPool(const EventLoopPool&) = delete;
+        EventLoopPool(EventLoopPool&&) noexcept = delete;
+        EventLoopPool& operator=(const EventLoopPool&) = delete;
+        EventLoopPool& operator=(EventLoopPool&&) noexcept = delete;
+
+        // Public methods
+    public:
+        /**
+         * This constructor starts the loop threads.
+         *
+         * @param[in] loopCount
+         *      This is the number of loop threads to run.
+         *      At least one loop is always started.
+         */
+        explicit EventLoopPool(size_t loopCount);
+
+        /**
+         * This method returns the number of loops in the pool.
+         *
+         * @return
+         *      The number of loops in the pool is returned.
+         */
+        size_t GetLoopCount() const;
+
+        /**
+         * This method registers the given descriptor with the least
+         * loaded loop of the pool.
+         *
+         * @param[in] fd
+         *      This is the descriptor to watch.
+         * @param[in] events
+         *      These are the epoll events to watch for.
+         * @param[in] eventDelegate
+         *      This is the function to call from the loop thread
+         *      whenever the descriptor has pending events.
+         * @return
+         *      The registration of the descriptor is returned.
+         *      Its identifier is zero if the registration failed.
+         */
+        Registration Add(int fd, uint32_t events, EventDelegate eventDelegate);
+
+        /**
+         * This method changes the events watched for a registered descriptor.
+         *
+         * @param[in] registration
+         *      This is the registration of the descriptor.
+         * @param[in] fd
+         *      This is the registered descriptor.
+         * @param[in] events
+         *      These are the epoll events to watch for.
+         * @return
+         *      An indication of whether or not the change succeeded
+         *      is returned.
+         */
+        bool Modify(const Registration& registration, int fd, uint32_t events);
+
+        /**
+         * This method stops watching a registered descriptor.  Once it returns,
+         * no new dispatch of the descriptor's delegate starts, although one
+         * already started on the loop thread may still be running.
+         *
+         * @param[in] registration
+         *      This is the registration of the descriptor.
+         * @param[in] fd
+         *      This is the registered descriptor.
+         */
+        void Remove(const Registration& registration, int fd);
+
+        /**
+         * This method queues the given function to be called
+         * from the thread of the given loop.
+         *
+         * @param[in] loop
+         *      This is the index of the loop on which to call the function.
+         * @param[in] task
+         *      This is the function to call.
+         */
+        void Post(size_t loop, std::function<void()> task);
+
+        // Private properties
+    private:
+        /**
+         * This is the type of structure that contains the private
+         * properties of the instance.  It is defined in the implementation
+         * and declared here to ensure that it is scoped inside the class.
+         */
+        struct Impl;
+
+        /**
+         * This contains the private properties of the instance.
+         */
+        std::unique_ptr<Impl> impl_;
+    };
+}  // namespace MqttNetworkTransport
+
+#endif /** MQTT_NETWORK_TRANSPORT_EVENT_LOOP_POOL_HPP */
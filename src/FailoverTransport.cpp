@@ -0,0 +1,1386 @@
+/**
+ * @file FailoverTransport.cpp
+ *
+ * This module implements the MqttNetworkTransport::FailoverTransport class.
+ *
+ * © 2025 by Hatem Nabli
+ */
+
+#include "MqttNetworkTransport/FailoverTransport.hpp"
+#include "MqttNetworkTransport/ZeroCopyConnection.hpp"
+#include "TimerQueue.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <inttypes.h>
+#include <map>
+#include <mutex>
+
+namespace
+{
+    /**
+     * This is used to indicate that no broker of a group is meant.
+     */
+    constexpr size_t NO_ENDPOINT = (size_t)-1;
+
+    /**
+     * These are the first two bytes of the PINGREQ and PINGRESP
+     * packets of MQTT, which have no other bytes.
+     */
+    constexpr uint8_t PINGREQ_BYTE = 0xC0;
+    constexpr uint8_t PINGRESP_BYTE = 0xD0;
+
+    /**
+     * This function determines whether or not the given scheme is one
+     * for which the host is not reached over TCP, so round-trip times
+     * can't be probed.
+     *
+     * @param[in] scheme
+     *      This is the scheme to check.
+     * @return
+     *      An indication of whether or not the scheme
+     *      is local is returned.
+     */
+    bool IsLocalScheme(const std::string& scheme) {
+        return ((scheme == "unix") || (scheme == "shm") || (scheme == "inproc"));
+    }
+
+    /**
+     * This function determines whether or not the given data
+     * is a PINGREQ packet.
+     *
+     * @param[in] data
+     *      This is the data to check.
+     * @return
+     *      An indication of whether or not the data is
+     *      a PINGREQ packet is returned.
+     */
+    bool IsPingRequest(const std::vector<uint8_t>& data) {
+        return ((data.size() == 2) && (data[0] == PINGREQ_BYTE) && (data[1] == 0));
+    }
+
+    /**
+     * This is the scheme used to probe brokers, which makes
+     * the wrapped transport establish a plain TCP connection.
+     */
+    const std::string PROBE_SCHEME = "mqtt";
+
+    /**
+     * This holds the state of a probe of a broker in progress.
+     */
+    struct PendingProbe
+    {
+        /**
+         * This indicates whether or not the probe has completed.
+         */
+        bool done = false;
+
+        /**
+         * This is the function to call to cancel the probe.
+         */
+        MqttNetworkTransport::MqttClientNetworkTransport::CancelDelegate cancel;
+
+        /**
+         * This identifies the timer which cancels the probe
+         * if it takes too long, if any.
+         */
+        MqttNetworkTransport::TimerQueue::Token timer = 0;
+    };
+
+    /**
+     * This holds what the transport needs to know about a connection
+     * made to a broker of a group in order to handle it breaking.
+     */
+    struct Watch
+    {
+        /**
+         * This is used to synchronize access to the watch.
+         */
+        std::mutex mutex;
+
+        /**
+         * This indicates whether or not the connection is the standby
+         * connection of its group, rather than one handed out.
+         */
+        bool standby = false;
+
+        /**
+         * This indicates whether or not the connection has broken.
+         */
+        bool broken = false;
+
+        /**
+         * This indicates whether or not the connection was
+         * closed by its user.
+         */
+        bool closed = false;
+
+        /**
+         * This is the function to call once the connection is broken,
+         * if it has been handed out.
+         */
+        MqttV5::Connection::BrokenDelegate brokenDelegate;
+    };
+
+    /**
+     * This is the connection handed out by the transport.  It wraps the
+     * connection made to a broker, so that the transport learns when
+     * it breaks even if its user replaces its broken delegate.
+     */
+    struct FailoverConnection : public MqttNetworkTransport::ZeroCopyConnection
+    {
+        /**
+         * This is the connection made to the broker.
+         */
+        std::shared_ptr<MqttV5::Connection> connection;
+
+        /**
+         * This is the same object as connection, if it can send data
+         * without copying it, or else nullptr.
+         */
+        std::shared_ptr<MqttNetworkTransport::ZeroCopyConnection> zeroCopyConnection;
+
+        /**
+         * This is what the transport knows about the connection.
+         */
+        std::shared_ptr<Watch> watch;
+
+        /**
+         * This is the function to call with each round-trip time measured
+         * from a PINGREQ packet sent on the connection to the PINGRESP
+         * packet answering it, if they are measured.
+         */
+        std::function<void(std::chrono::microseconds rtt)> rttMeasured;
+
+        /**
+         * This is when the PINGREQ packet awaiting an answer was sent, in
+         * ticks of the steady clock, or zero if none is awaiting one.
+         */
+        std::shared_ptr<std::atomic<int64_t>> pingSentAt =
+            std::make_shared<std::atomic<int64_t>>(0);
+
+        /**
+         * This is the destructor.  Releasing the connection closes it,
+         * which is not a failure of the broker.
+         */
+        ~FailoverConnection() noexcept {
+            std::lock_guard<decltype(watch->mutex)> lock(watch->mutex);
+            watch->closed = true;
+        }
+
+        // MqttV5::Connection
+
+        virtual std::string GetPeerId() override { return connection->GetPeerId(); }
+
+        /**
+         * This method notes when the given packet is sent, if it
+         * is a PINGREQ packet and round-trip times are measured.
+         *
+         * @param[in] data
+         *      This is the packet sent.
+         */
+        void NoteSent(const std::vector<uint8_t>& data) {
+            if ((rttMeasured != nullptr) && IsPingRequest(data))
+            { pingSentAt->store(std::chrono::steady_clock::now().time_since_epoch().count()); }
+        }
+
+        virtual void SetDataReceivedDelegate(DataReceivedDelegate dataReceivedDelegate) override {
+            if (rttMeasured == nullptr)
+            {
+                connection->SetDataReceivedDelegate(dataReceivedDelegate);
+                return;
+            }
+            const auto sentAt = pingSentAt;
+            const auto measured = rttMeasured;
+            connection->SetDataReceivedDelegate(
+                [sentAt, measured, dataReceivedDelegate](const std::vector<uint8_t>& data)
+                {
+                    if ((data.size() >= 2) && (data[0] == PINGRESP_BYTE) && (data[1] == 0))
+                    {
+                        const auto sent = sentAt->exchange(0);
+                        if (sent != 0)
+                        {
+                            const auto now = std::chrono::steady_clock::now();
+                            measured(std::chrono::duration_cast<std::chrono::microseconds>(
+                                now.time_since_epoch() -
+                                std::chrono::steady_clock::duration(sent)));
+                        }
+                    }
+                    if (dataReceivedDelegate != nullptr)
+                    { dataReceivedDelegate(data); }
+                });
+        }
+
+        virtual void SetConnectionBrokenDelegate(BrokenDelegate brokenDelegate) override {
+            std::lock_guard<decltype(watch->mutex)> lock(watch->mutex);
+            watch->brokenDelegate = brokenDelegate;
+        }
+
+        virtual void SendData(const std::vector<uint8_t>& data) override {
+            NoteSent(data);
+            connection->SendData(data);
+        }
+
+        virtual void Break(const bool clean) override {
+            {
+                std::lock_guard<decltype(watch->mutex)> lock(watch->mutex);
+                watch->closed = true;
+            }
+            connection->Break(clean);
+        }
+
+        // MqttNetworkTransport::ZeroCopyConnection
+
+        virtual void SendData(std::vector<uint8_t>&& data) override {
+            NoteSent(data);
+            if (zeroCopyConnection != nullptr)
+            { zeroCopyConnection->SendData(std::move(data)); } else
+            { connection->SendData(data); }
+        }
+
+        virtual void SendData(SharedBuffer data) override {
+            NoteSent(*data);
+            if (zeroCopyConnection != nullptr)
+            { zeroCopyConnection->SendData(data); } else
+            { connection->SendData(*data); }
+        }
+
+        virtual ConnectionStatistics GetConnectionStatistics() override {
+            if (zeroCopyConnection != nullptr)
+            { return zeroCopyConnection->GetConnectionStatistics(); }
+            return ConnectionStatistics();
+        }
+    };
+
+    /**
+     * This holds the state of one broker of a group.
+     */
+    struct EndpointState
+    {
+        /**
+         * This describes the broker.
+         */
+        MqttNetworkTransport::FailoverTransport::Endpoint endpoint;
+
+        /**
+         * This is when the broker becomes healthy again, after a failure.
+         */
+        std::chrono::steady_clock::time_point heldDownUntil;
+
+        /**
+         * This is the number of failures of the broker
+         * since it last connected.
+         */
+        unsigned consecutiveFailures = 0;
+
+        /**
+         * These are the numbers of connections established to the broker,
+         * and of connect attempts and connections to it which failed.
+         */
+        uint64_t connects = 0;
+        uint64_t failures = 0;
+
+        /**
+         * This is the current weight of the broker in the smooth weighted
+         * round-robin choice among healthy brokers of equal priority.
+         */
+        int64_t currentWeight = 0;
+
+        /**
+         * This is the exponentially weighted moving average of the
+         * round-trip times measured for the broker, in microseconds.
+         */
+        double smoothedRtt = 0.0;
+
+        /**
+         * This is the number of round-trip times measured for the broker.
+         */
+        uint64_t rttSamples = 0;
+
+        /**
+         * This indicates whether or not a probe of
+         * the broker is in progress.
+         */
+        bool probing = false;
+    };
+
+    /**
+     * This holds the state of a group of brokers.
+     */
+    struct Group
+    {
+        /**
+         * This is the name of the group.
+         */
+        std::string name;
+
+        /**
+         * These are the brokers of the group.
+         */
+        std::vector<EndpointState> endpoints;
+
+        /**
+         * This indicates whether or not the group was replaced or the
+         * transport released, in which case nothing more is done for it.
+         */
+        bool retired = false;
+
+        /**
+         * These are the scheme and port given when last connecting,
+         * used for brokers which don't set their own.
+         */
+        std::string scheme;
+        uint16_t port = 0;
+
+        /**
+         * This is the index of the broker of the connection
+         * last handed out, if any.
+         */
+        size_t activeIndex = NO_ENDPOINT;
+
+        /**
+         * This is the index of the broker of the standby connection,
+         * if one is open or being opened.
+         */
+        size_t standbyIndex = NO_ENDPOINT;
+
+        /**
+         * This is the standby connection, once it is open.
+         */
+        std::shared_ptr<MqttV5::Connection> standby;
+
+        /**
+         * This is what the transport knows about the standby connection,
+         * if one is open or being opened.
+         */
+        std::shared_ptr<Watch> standbyWatch;
+
+        /**
+         * This is the function to call to cancel opening the
+         * standby connection, if it is being opened.
+         */
+        MqttNetworkTransport::MqttClientNetworkTransport::CancelDelegate cancelStandby;
+
+        /**
+         * This identifies the timer which opens the standby
+         * connection later, if any.
+         */
+        MqttNetworkTransport::TimerQueue::Token standbyTimer = 0;
+
+        /**
+         * This identifies the timer which next probes
+         * the brokers of the group, if any.
+         */
+        MqttNetworkTransport::TimerQueue::Token probeTimer = 0;
+
+        /**
+         * This method returns the scheme to use to connect
+         * to the given broker.
+         *
+         * @param[in] index
+         *      This is the index of the broker.
+         * @return
+         *      The scheme to use for the broker is returned.
+         */
+        const std::string& SchemeOf(size_t index) const {
+            const auto& endpoint = endpoints[index].endpoint;
+            return (endpoint.scheme.empty() ? scheme : endpoint.scheme);
+        }
+
+        /**
+         * This method returns the port to use to connect
+         * to the given broker.
+         *
+         * @param[in] index
+         *      This is the index of the broker.
+         * @return
+         *      The port to use for the broker is returned.
+         */
+        uint16_t PortOf(size_t index) const {
+            const auto& endpoint = endpoints[index].endpoint;
+            return ((endpoint.port == 0) ? port : endpoint.port);
+        }
+
+        /**
+         * This method returns a description of the given broker
+         * for diagnostic messages.
+         *
+         * @param[in] index
+         *      This is the index of the broker.
+         * @return
+         *      A description of the broker is returned.
+         */
+        std::string Describe(size_t index) const {
+            const auto& host = endpoints[index].endpoint.hostNameOrAddress;
+            if (host.find(':') != std::string::npos)
+            { return StringUtils::sprintf("[%s]:%" PRIu16, host.c_str(), PortOf(index)); }
+            return StringUtils::sprintf("%s:%" PRIu16, host.c_str(), PortOf(index));
+        }
+
+        /**
+         * This method determines whether or not the given broker is
+         * healthy, rather than held down after a failure.
+         *
+         * @param[in] index
+         *      This is the index of the broker.
+         * @param[in] now
+         *      This is the current time.
+         * @return
+         *      An indication of whether or not the broker
+         *      is healthy is returned.
+         */
+        bool IsHealthy(size_t index, std::chrono::steady_clock::time_point now) const {
+            return (endpoints[index].heldDownUntil <= now);
+        }
+
+        /**
+         * This method returns the order in which to try the brokers of
+         * the group: first the healthy ones, by priority, then those not
+         * yet measured, by weight, so that each is measured once, then
+         * those measured, by smoothed round-trip time, and then those
+         * held down, from the one which recovers first.
+         *
+         * @param[in] now
+         *      This is the current time.
+         * @param[in] balance
+         *      This indicates whether or not to pick the first broker
+         *      among the healthy ones of the best priority by smooth
+         *      weighted round-robin, spreading connections over them,
+         *      if their round-trip times aren't measured yet.
+         * @param[in] excluded
+         *      This is the index of a broker to leave out, if any.
+         * @return
+         *      The indexes of the brokers, in the order in which
+         *      to try them, are returned.
+         */
+        std::vector<size_t> Order(std::chrono::steady_clock::time_point now, bool balance,
+                                  size_t excluded = NO_ENDPOINT) {
+            std::vector<size_t> healthy;
+            std::vector<size_t> heldDown;
+            for (size_t i = 0; i < endpoints.size(); ++i)
+            {
+                if (i == excluded)
+                { continue; }
+                if (IsHealthy(i, now))
+                { healthy.push_back(i); } else
+                { heldDown.push_back(i); }
+            }
+            std::stable_sort(healthy.begin(), healthy.end(),
+                             [this](size_t lhs, size_t rhs)
+                             {
+                                 const auto& left = endpoints[lhs];
+                                 const auto& right = endpoints[rhs];
+                                 if (left.endpoint.priority != right.endpoint.priority)
+                                 { return left.endpoint.priority < right.endpoint.priority; }
+                                 if ((left.rttSamples == 0) != (right.rttSamples == 0))
+                                 { return left.rttSamples == 0; }
+                                 if (left.smoothedRtt != right.smoothedRtt)
+                                 { return left.smoothedRtt < right.smoothedRtt; }
+                                 return left.endpoint.weight > right.endpoint.weight;
+                             });
+            if (balance && (healthy.size() > 1) && (endpoints[healthy[0]].rttSamples == 0))
+            {
+                const auto topPriority = endpoints[healthy[0]].endpoint.priority;
+                int64_t totalWeight = 0;
+                size_t chosen = 0;
+                for (size_t i = 0; i < healthy.size(); ++i)
+                {
+                    auto& state = endpoints[healthy[i]];
+                    if ((state.endpoint.priority != topPriority) || (state.rttSamples != 0))
+                    { break; }
+                    state.currentWeight += state.endpoint.weight;
+                    totalWeight += state.endpoint.weight;
+                    if (state.currentWeight > endpoints[healthy[chosen]].currentWeight)
+                    { chosen = i; }
+                }
+                endpoints[healthy[chosen]].currentWeight -= totalWeight;
+                std::rotate(healthy.begin(), healthy.begin() + chosen,
+                            healthy.begin() + chosen + 1);
+            }
+            std::stable_sort(heldDown.begin(), heldDown.end(),
+                             [this](size_t lhs, size_t rhs)
+                             {
+                                 return (endpoints[lhs].heldDownUntil <
+                                         endpoints[rhs].heldDownUntil);
+                             });
+            healthy.insert(healthy.end(), heldDown.begin(), heldDown.end());
+            return healthy;
+        }
+    };
+}  // namespace
+
+namespace MqttNetworkTransport
+{
+    /**
+     * This contains the private properties of a FailoverTransport instance.
+     */
+    struct FailoverTransport::Impl : public std::enable_shared_from_this<FailoverTransport::Impl>
+    {
+        /**
+         * This is a helper object used to generate and publish
+         * diagnostic messages.
+         */
+        std::shared_ptr<SystemUtils::DiagnosticsSender> diagnosticsSender =
+            std::make_shared<SystemUtils::DiagnosticsSender>("FailoverTransport");
+
+        /**
+         * This is the transport used to connect to the brokers.
+         */
+        std::shared_ptr<MqttClientNetworkTransport> transport;
+
+        /**
+         * This is used to synchronize access to the settings
+         * and the groups of the transport.
+         */
+        std::mutex mutex;
+
+        /**
+         * These are the current settings of the transport.
+         */
+        Configuration configuration;
+
+        /**
+         * These are the groups of brokers, keyed by name.
+         */
+        std::map<std::string, std::shared_ptr<Group>> groups;
+
+        /**
+         * This is used to open standby connections later.
+         * It is made when first needed.
+         */
+        std::shared_ptr<TimerQueue> timerQueue;
+
+        /**
+         * This method records a failure of the given broker, holding
+         * it down for a while.  The caller must hold the mutex.
+         *
+         * @param[in] group
+         *      This is the group of the broker.
+         * @param[in] index
+         *      This is the index of the broker.
+         */
+        void RecordFailure(Group& group, size_t index) {
+            auto& state = group.endpoints[index];
+            ++state.failures;
+            ++state.consecutiveFailures;
+            state.heldDownUntil =
+                std::chrono::steady_clock::now() +
+                std::chrono::milliseconds(configuration.holdDownMilliseconds);
+        }
+
+        /**
+         * This method records a connection established to the given
+         * broker and handed out.  The caller must hold the mutex.
+         *
+         * @param[in] group
+         *      This is the group of the broker.
+         * @param[in] index
+         *      This is the index of the broker.
+         */
+        void RecordConnect(Group& group, size_t index) {
+            auto& state = group.endpoints[index];
+            ++state.connects;
+            state.consecutiveFailures = 0;
+            state.heldDownUntil = std::chrono::steady_clock::time_point();
+            group.activeIndex = index;
+        }
+
+        /**
+         * This method schedules opening the standby connection of the
+         * given group at the given time, unless it is already scheduled.
+         * The caller must hold the mutex.
+         *
+         * @param[in] group
+         *      This is the group for which to open a standby connection.
+         * @param[in] due
+         *      This is when to open the standby connection.
+         */
+        void ScheduleStandby(const std::shared_ptr<Group>& group,
+                             std::chrono::steady_clock::time_point due) {
+            if (group->standbyTimer != 0)
+            { return; }
+            if (timerQueue == nullptr)
+            { timerQueue = std::make_shared<TimerQueue>(); }
+            std::weak_ptr<Impl> implWeak(shared_from_this());
+            group->standbyTimer = timerQueue->Schedule(
+                due,
+                [implWeak, group]
+                {
+                    const auto impl = implWeak.lock();
+                    if (impl == nullptr)
+                    { return; }
+                    {
+                        std::lock_guard<decltype(impl->mutex)> lock(impl->mutex);
+                        group->standbyTimer = 0;
+                    }
+                    impl->OpenStandby(group);
+                });
+        }
+
+        /**
+         * This method schedules opening the standby connection of the
+         * given group again, once the standby retry delay has passed.
+         * The caller must hold the mutex.
+         *
+         * @param[in] group
+         *      This is the group for which to open a standby connection.
+         */
+        void ScheduleStandbyRetry(const std::shared_ptr<Group>& group) {
+            ScheduleStandby(group,
+                            std::chrono::steady_clock::now() +
+                                std::chrono::milliseconds(configuration.standbyRetryMilliseconds));
+        }
+
+        /**
+         * This method closes the standby connection of the given group,
+         * if any, or stops opening it.  The caller must hold the mutex.
+         *
+         * @param[in] group
+         *      This is the group whose standby connection to close.
+         * @param[out] closed
+         *      The standby connection, which the caller should break
+         *      once it releases the mutex, is stored here.
+         * @param[out] cancel
+         *      The function which the caller should call to stop opening
+         *      the standby connection, once it releases the mutex,
+         *      is stored here.
+         */
+        void DropStandby(Group& group, std::shared_ptr<MqttV5::Connection>& closed,
+                         MqttClientNetworkTransport::CancelDelegate& cancel) {
+            closed.swap(group.standby);
+            cancel.swap(group.cancelStandby);
+            group.standbyWatch = nullptr;
+            group.standbyIndex = NO_ENDPOINT;
+            if ((group.standbyTimer != 0) && (timerQueue != nullptr))
+            { timerQueue->Cancel(group.standbyTimer); }
+            group.standbyTimer = 0;
+        }
+
+        /**
+         * This method makes the function which the connection made to the
+         * given broker calls once it is broken.
+         *
+         * @param[in] group
+         *      This is the group of the broker.
+         * @param[in] index
+         *      This is the index of the broker.
+         * @param[in] watch
+         *      This is what the transport knows about the connection.
+         * @return
+         *      The function to give the connection is returned.
+         */
+        MqttV5::Connection::BrokenDelegate MakeBrokenDelegate(std::shared_ptr<Group> group,
+                                                              size_t index,
+                                                              std::shared_ptr<Watch> watch) {
+            std::weak_ptr<Impl> implWeak(shared_from_this());
+            return [implWeak, group, index, watch](bool graceful)
+            {
+                bool wasStandby;
+                bool closed;
+                MqttV5::Connection::BrokenDelegate brokenDelegate;
+                {
+                    std::lock_guard<decltype(watch->mutex)> lock(watch->mutex);
+                    if (watch->broken)
+                    { return; }
+                    watch->broken = true;
+                    wasStandby = watch->standby;
+                    closed = watch->closed;
+                    brokenDelegate = watch->brokenDelegate;
+                }
+                const auto impl = implWeak.lock();
+                if (impl != nullptr)
+                { impl->OnBroken(group, index, watch, wasStandby, closed, graceful); }
+                if (!wasStandby && (brokenDelegate != nullptr))
+                { brokenDelegate(graceful); }
+            };
+        }
+
+        /**
+         * This method is called once a connection made to a broker breaks.
+         *
+         * @param[in] group
+         *      This is the group of the broker.
+         * @param[in] index
+         *      This is the index of the broker.
+         * @param[in] watch
+         *      This is what the transport knows about the connection.
+         * @param[in] wasStandby
+         *      This indicates whether or not the connection was the
+         *      standby connection of the group.
+         * @param[in] closed
+         *      This indicates whether or not the connection
+         *      was closed by its user.
+         * @param[in] graceful
+         *      This indicates whether or not the broker
+         *      closed the connection gracefully.
+         */
+        void OnBroken(const std::shared_ptr<Group>& group, size_t index,
+                      const std::shared_ptr<Watch>& watch, bool wasStandby, bool closed,
+                      bool graceful) {
+            std::shared_ptr<MqttV5::Connection> standby;
+            MqttClientNetworkTransport::CancelDelegate cancel;
+            {
+                std::lock_guard<decltype(mutex)> lock(mutex);
+                if (group->retired)
+                { return; }
+                if (wasStandby)
+                {
+                    if (group->standbyWatch != watch)
+                    { return; }
+                    DropStandby(*group, standby, cancel);
+                    if (!graceful)
+                    { RecordFailure(*group, index); }
+                    ScheduleStandbyRetry(group);
+                    diagnosticsSender->SendDiagnosticInformationFormatted(
+                        SystemUtils::DiagnosticsSender::Levels::WARNING,
+                        "Standby connection to broker '%s' of '%s' broken",
+                        group->Describe(index).c_str(), group->name.c_str());
+                    return;
+                }
+                if (!closed)
+                {
+                    RecordFailure(*group, index);
+                    diagnosticsSender->SendDiagnosticInformationFormatted(
+                        SystemUtils::DiagnosticsSender::Levels::WARNING,
+                        "Connection to broker '%s' of '%s' broken",
+                        group->Describe(index).c_str(), group->name.c_str());
+                }
+            }
+            OpenStandby(group);
+        }
+
+        /**
+         * This method starts opening the standby connection of the given
+         * group, to the healthy broker which would be tried first if the
+         * broker of the connection last handed out failed, unless standby
+         * connections are off or one is already open or being opened.
+         * If no such broker is healthy yet, opening the connection is
+         * scheduled for when the first one recovers.
+         *
+         * @param[in] group
+         *      This is the group for which to open a standby connection.
+         */
+        void OpenStandby(const std::shared_ptr<Group>& group) {
+            std::string scheme;
+            std::string host;
+            uint16_t port;
+            size_t target = NO_ENDPOINT;
+            const auto watch = std::make_shared<Watch>();
+            watch->standby = true;
+            {
+                std::lock_guard<decltype(mutex)> lock(mutex);
+                if (!configuration.standby || group->retired ||
+                    (group->activeIndex == NO_ENDPOINT) || (group->standbyWatch != nullptr) ||
+                    (group->standbyTimer != 0))
+                { return; }
+                const auto now = std::chrono::steady_clock::now();
+                const auto order = group->Order(now, false, group->activeIndex);
+                if (order.empty())
+                { return; }
+                if (!group->IsHealthy(order[0], now))
+                {
+                    ScheduleStandby(group, group->endpoints[order[0]].heldDownUntil);
+                    return;
+                }
+                target = order[0];
+                scheme = group->SchemeOf(target);
+                host = group->endpoints[target].endpoint.hostNameOrAddress;
+                port = group->PortOf(target);
+                group->standbyIndex = target;
+                group->standbyWatch = watch;
+            }
+            std::weak_ptr<Impl> implWeak(shared_from_this());
+            const auto cancel = transport->ConnectAsync(
+                scheme, host, port, [](const std::vector<uint8_t>&) {},
+                MakeBrokenDelegate(group, target, watch),
+                [implWeak, group, target, watch](std::shared_ptr<MqttV5::Connection> connection)
+                {
+                    const auto impl = implWeak.lock();
+                    if (impl == nullptr)
+                    {
+                        if (connection != nullptr)
+                        { connection->Break(false); }
+                        return;
+                    }
+                    impl->OnStandbyConnected(group, target, watch, connection);
+                });
+            std::lock_guard<decltype(mutex)> lock(mutex);
+            if ((group->standbyWatch == watch) && (group->standby == nullptr))
+            { group->cancelStandby = cancel; }
+        }
+
+        /**
+         * This method is called once an attempt to open the standby
+         * connection of a group completes.
+         *
+         * @param[in] group
+         *      This is the group of the standby connection.
+         * @param[in] index
+         *      This is the index of the broker to which
+         *      the connection was made.
+         * @param[in] watch
+         *      This is what the transport knows about the connection.
+         * @param[in] connection
+         *      This is the connection established, or nullptr
+         *      if the attempt failed.
+         */
+        void OnStandbyConnected(const std::shared_ptr<Group>& group, size_t index,
+                                const std::shared_ptr<Watch>& watch,
+                                std::shared_ptr<MqttV5::Connection> connection) {
+            {
+                std::lock_guard<decltype(mutex)> lock(mutex);
+                if (!group->retired && (group->standbyWatch == watch))
+                {
+                    group->cancelStandby = nullptr;
+                    if (connection != nullptr)
+                    {
+                        group->standby = connection;
+                        diagnosticsSender->SendDiagnosticInformationFormatted(
+                            1, "Standby connection to broker '%s' of '%s' open",
+                            group->Describe(index).c_str(), group->name.c_str());
+                        return;
+                    }
+                    group->standbyWatch = nullptr;
+                    group->standbyIndex = NO_ENDPOINT;
+                    RecordFailure(*group, index);
+                    ScheduleStandbyRetry(group);
+                    return;
+                }
+            }
+            if (connection != nullptr)
+            { connection->Break(false); }
+        }
+
+        /**
+         * This method hands out the standby connection of the given group,
+         * if it is open, to a broker which is healthy and of the best
+         * priority among the healthy brokers of the group.  The caller
+         * must hold the mutex.
+         *
+         * @param[in] group
+         *      This is the group whose standby connection to hand out.
+         * @param[in] brokenDelegate
+         *      This is the function to call once the connection is broken.
+         * @param[out] watch
+         *      What the transport knows about the connection handed
+         *      out is stored here.
+         * @param[out] index
+         *      The index of the broker of the connection handed
+         *      out is stored here.
+         * @return
+         *      The connection handed out is returned, or nullptr if
+         *      the standby connection can't be handed out.
+         */
+        std::shared_ptr<MqttV5::Connection> TakeStandby(
+            Group& group, MqttV5::Connection::BrokenDelegate brokenDelegate,
+            std::shared_ptr<Watch>& watch, size_t& index) {
+            if (group.standby == nullptr)
+            { return nullptr; }
+            const auto now = std::chrono::steady_clock::now();
+            index = group.standbyIndex;
+            if (!group.IsHealthy(index, now))
+            { return nullptr; }
+            const auto priority = group.endpoints[index].endpoint.priority;
+            for (size_t i = 0; i < group.endpoints.size(); ++i)
+            {
+                if (group.IsHealthy(i, now) && (group.endpoints[i].endpoint.priority < priority))
+                { return nullptr; }
+            }
+            const auto standbyWatch = group.standbyWatch;
+            {
+                std::lock_guard<decltype(standbyWatch->mutex)> lock(standbyWatch->mutex);
+                if (standbyWatch->broken)
+                { return nullptr; }
+                standbyWatch->standby = false;
+                standbyWatch->brokenDelegate = brokenDelegate;
+            }
+            std::shared_ptr<MqttV5::Connection> connection;
+            connection.swap(group.standby);
+            watch.swap(group.standbyWatch);
+            group.standbyIndex = NO_ENDPOINT;
+            RecordConnect(group, index);
+            diagnosticsSender->SendDiagnosticInformationFormatted(
+                1, "Handed out standby connection to broker '%s' of '%s'",
+                group.Describe(index).c_str(), group.name.c_str());
+            return connection;
+        }
+
+        /**
+         * This method adds the given round-trip time to those measured
+         * for the given broker.  The caller must hold the mutex.
+         *
+         * @param[in] group
+         *      This is the group of the broker.
+         * @param[in] index
+         *      This is the index of the broker.
+         * @param[in] rtt
+         *      This is the round-trip time measured.
+         */
+        void RecordRtt(Group& group, size_t index, std::chrono::microseconds rtt) {
+            auto& state = group.endpoints[index];
+            const auto sample = (double)rtt.count();
+            if (state.rttSamples == 0)
+            { state.smoothedRtt = sample; } else
+            {
+                state.smoothedRtt +=
+                    (sample - state.smoothedRtt) * configuration.rttSmoothingPercent / 100.0;
+            }
+            ++state.rttSamples;
+        }
+
+        /**
+         * This method makes the function which a connection made to the
+         * given broker calls with the round-trip times measured from its
+         * pings.
+         *
+         * @param[in] group
+         *      This is the group of the broker.
+         * @param[in] index
+         *      This is the index of the broker.
+         * @return
+         *      The function to give the connection is returned.
+         */
+        std::function<void(std::chrono::microseconds rtt)> MakeRttDelegate(
+            std::shared_ptr<Group> group, size_t index) {
+            std::weak_ptr<Impl> implWeak(shared_from_this());
+            return [implWeak, group, index](std::chrono::microseconds rtt)
+            {
+                const auto impl = implWeak.lock();
+                if (impl == nullptr)
+                { return; }
+                std::lock_guard<decltype(impl->mutex)> lock(impl->mutex);
+                if (!group->retired)
+                { impl->RecordRtt(*group, index, rtt); }
+            };
+        }
+
+        /**
+         * This method schedules probing the brokers of the given group at
+         * the given time, unless probing is off or already scheduled.
+         * The caller must hold the mutex.
+         *
+         * @param[in] group
+         *      This is the group whose brokers to probe.
+         * @param[in] due
+         *      This is when to probe the brokers.
+         */
+        void ScheduleProbes(const std::shared_ptr<Group>& group,
+                            std::chrono::steady_clock::time_point due) {
+            if ((configuration.probeIntervalMilliseconds == 0) || group->retired ||
+                (group->probeTimer != 0))
+            { return; }
+            if (timerQueue == nullptr)
+            { timerQueue = std::make_shared<TimerQueue>(); }
+            std::weak_ptr<Impl> implWeak(shared_from_this());
+            group->probeTimer = timerQueue->Schedule(
+                due,
+                [implWeak, group]
+                {
+                    const auto impl = implWeak.lock();
+                    if (impl == nullptr)
+                    { return; }
+                    {
+                        std::lock_guard<decltype(impl->mutex)> lock(impl->mutex);
+                        group->probeTimer = 0;
+                    }
+                    impl->Probe(group);
+                });
+        }
+
+        /**
+         * This method starts probing each broker of the given group which
+         * can be probed and isn't being probed already, and schedules
+         * probing them again.
+         *
+         * @param[in] group
+         *      This is the group whose brokers to probe.
+         */
+        void Probe(const std::shared_ptr<Group>& group) {
+            std::vector<size_t> indexes;
+            std::vector<std::string> hosts;
+            std::vector<uint16_t> ports;
+            std::chrono::milliseconds timeout;
+            {
+                std::lock_guard<decltype(mutex)> lock(mutex);
+                if ((configuration.probeIntervalMilliseconds == 0) || group->retired)
+                { return; }
+                for (size_t i = 0; i < group->endpoints.size(); ++i)
+                {
+                    auto& state = group->endpoints[i];
+                    if (state.probing || IsLocalScheme(group->SchemeOf(i)) ||
+                        (group->PortOf(i) == 0))
+                    { continue; }
+                    state.probing = true;
+                    indexes.push_back(i);
+                    hosts.push_back(state.endpoint.hostNameOrAddress);
+                    ports.push_back(group->PortOf(i));
+                }
+                timeout = std::chrono::milliseconds(configuration.attemptTimeoutMilliseconds);
+                ScheduleProbes(
+                    group, std::chrono::steady_clock::now() +
+                               std::chrono::milliseconds(configuration.probeIntervalMilliseconds));
+            }
+            for (size_t i = 0; i < indexes.size(); ++i)
+            { ProbeEndpoint(group, indexes[i], hosts[i], ports[i], timeout); }
+        }
+
+        /**
+         * This method measures the time taken to establish a TCP
+         * connection to the given broker, closing it at once.
+         *
+         * @param[in] group
+         *      This is the group of the broker.
+         * @param[in] index
+         *      This is the index of the broker.
+         * @param[in] host
+         *      This is the name or address of the host of the broker.
+         * @param[in] port
+         *      This is the port number of the broker.
+         * @param[in] timeout
+         *      This is how long to wait for the connection before
+         *      counting the probe as a failure.
+         */
+        void ProbeEndpoint(const std::shared_ptr<Group>& group, size_t index,
+                           const std::string& host, uint16_t port,
+                           std::chrono::milliseconds timeout) {
+            const auto probe = std::make_shared<PendingProbe>();
+            const auto start = std::chrono::steady_clock::now();
+            std::weak_ptr<Impl> implWeak(shared_from_this());
+            const auto cancel = transport->ConnectAsync(
+                PROBE_SCHEME, host, port, [](const std::vector<uint8_t>&) {}, [](bool) {},
+                [implWeak, group, index, probe,
+                 start](std::shared_ptr<MqttV5::Connection> connection)
+                {
+                    const auto rtt = std::chrono::duration_cast<std::chrono::microseconds>(
+                        std::chrono::steady_clock::now() - start);
+                    if (connection != nullptr)
+                    { connection->Break(false); }
+                    const auto impl = implWeak.lock();
+                    if (impl != nullptr)
+                    { impl->OnProbed(group, index, probe, (connection != nullptr), rtt); }
+                });
+            std::lock_guard<decltype(mutex)> lock(mutex);
+            if (probe->done)
+            { return; }
+            probe->cancel = cancel;
+            if ((timeout.count() == 0) || (timerQueue == nullptr))
+            { return; }
+            std::weak_ptr<PendingProbe> probeWeak(probe);
+            probe->timer = timerQueue->Schedule(
+                start + timeout,
+                [implWeak, probeWeak]
+                {
+                    const auto impl = implWeak.lock();
+                    const auto expired = probeWeak.lock();
+                    if ((impl == nullptr) || (expired == nullptr))
+                    { return; }
+                    MqttClientNetworkTransport::CancelDelegate expiredCancel;
+                    {
+                        std::lock_guard<decltype(impl->mutex)> lock(impl->mutex);
+                        expiredCancel = expired->cancel;
+                    }
+                    if (expiredCancel != nullptr)
+                    { expiredCancel(); }
+                });
+        }
+
+        /**
+         * This method is called once a probe of a broker completes.
+         *
+         * @param[in] group
+         *      This is the group of the broker.
+         * @param[in] index
+         *      This is the index of the broker.
+         * @param[in] probe
+         *      This is the state of the probe.
+         * @param[in] connected
+         *      This indicates whether or not the probe connected.
+         * @param[in] rtt
+         *      This is the time the probe took.
+         */
+        void OnProbed(const std::shared_ptr<Group>& group, size_t index,
+                      const std::shared_ptr<PendingProbe>& probe, bool connected,
+                      std::chrono::microseconds rtt) {
+            std::lock_guard<decltype(mutex)> lock(mutex);
+            probe->done = true;
+            probe->cancel = nullptr;
+            if ((probe->timer != 0) && (timerQueue != nullptr))
+            { timerQueue->Cancel(probe->timer); }
+            group->endpoints[index].probing = false;
+            if (group->retired)
+            { return; }
+            if (connected)
+            {
+                RecordRtt(*group, index, rtt);
+                return;
+            }
+            RecordFailure(*group, index);
+            diagnosticsSender->SendDiagnosticInformationFormatted(
+                SystemUtils::DiagnosticsSender::Levels::WARNING,
+                "Probe of broker '%s' of '%s' failed", group->Describe(index).c_str(),
+                group->name.c_str());
+        }
+
+        /**
+         * This method retires the given group, closing its standby
+         * connection, if any.  The caller must hold the mutex.
+         *
+         * @param[in] group
+         *      This is the group to retire.
+         * @param[out] closed
+         *      The standby connections, which the caller should break
+         *      once it releases the mutex, are added here.
+         * @param[out] cancels
+         *      The functions which the caller should call to stop
+         *      opening standby connections, once it releases the
+         *      mutex, are added here.
+         */
+        void Retire(Group& group, std::vector<std::shared_ptr<MqttV5::Connection>>& closed,
+                    std::vector<MqttClientNetworkTransport::CancelDelegate>& cancels) {
+            group.retired = true;
+            if ((group.probeTimer != 0) && (timerQueue != nullptr))
+            { timerQueue->Cancel(group.probeTimer); }
+            group.probeTimer = 0;
+            std::shared_ptr<MqttV5::Connection> standby;
+            MqttClientNetworkTransport::CancelDelegate cancel;
+            DropStandby(group, standby, cancel);
+            if (standby != nullptr)
+            { closed.push_back(standby); }
+            if (cancel != nullptr)
+            { cancels.push_back(cancel); }
+        }
+
+        /**
+         * This method closes the given standby connections and stops
+         * opening others.  The caller must not hold the mutex.
+         *
+         * @param[in] closed
+         *      These are the standby connections to break.
+         * @param[in] cancels
+         *      These are the functions to call to stop
+         *      opening standby connections.
+         */
+        static void Release(
+            const std::vector<std::shared_ptr<MqttV5::Connection>>& closed,
+            const std::vector<MqttClientNetworkTransport::CancelDelegate>& cancels) {
+            for (const auto& cancel : cancels)
+            { cancel(); }
+            for (const auto& connection : closed)
+            { connection->Break(false); }
+        }
+    };
+
+    FailoverTransport::~FailoverTransport() noexcept {
+        std::vector<std::shared_ptr<MqttV5::Connection>> closed;
+        std::vector<MqttClientNetworkTransport::CancelDelegate> cancels;
+        {
+            std::lock_guard<decltype(impl_->mutex)> lock(impl_->mutex);
+            for (const auto& group : impl_->groups)
+            { impl_->Retire(*group.second, closed, cancels); }
+            impl_->groups.clear();
+        }
+        Impl::Release(closed, cancels);
+    }
+
+    FailoverTransport::FailoverTransport(std::shared_ptr<MqttClientNetworkTransport> transport) :
+        impl_(std::make_shared<Impl>()) {
+        impl_->transport = transport;
+    }
+
+    SystemUtils::DiagnosticsSender::UnsubscribeDelegate FailoverTransport::SubscribeToDiagnostics(
+        SystemUtils::DiagnosticsSender::DiagnosticMessageDelegate delegate, size_t minLevel) {
+        return impl_->diagnosticsSender->SubscribeToDiagnostics(delegate, minLevel);
+    }
+
+    void FailoverTransport::Configure(const Configuration& configuration) {
+        std::vector<std::shared_ptr<MqttV5::Connection>> closed;
+        std::vector<MqttClientNetworkTransport::CancelDelegate> cancels;
+        std::vector<std::shared_ptr<Group>> groups;
+        {
+            std::lock_guard<decltype(impl_->mutex)> lock(impl_->mutex);
+            impl_->configuration = configuration;
+            for (const auto& group : impl_->groups)
+            {
+                if (configuration.probeIntervalMilliseconds == 0)
+                {
+                    if ((group.second->probeTimer != 0) && (impl_->timerQueue != nullptr))
+                    { impl_->timerQueue->Cancel(group.second->probeTimer); }
+                    group.second->probeTimer = 0;
+                } else
+                { impl_->ScheduleProbes(group.second, std::chrono::steady_clock::now()); }
+                if (configuration.standby)
+                {
+                    groups.push_back(group.second);
+                    continue;
+                }
+                std::shared_ptr<MqttV5::Connection> standby;
+                MqttClientNetworkTransport::CancelDelegate cancel;
+                impl_->DropStandby(*group.second, standby, cancel);
+                if (standby != nullptr)
+                { closed.push_back(standby); }
+                if (cancel != nullptr)
+                { cancels.push_back(cancel); }
+            }
+        }
+        Impl::Release(closed, cancels);
+        for (const auto& group : groups)
+        { impl_->OpenStandby(group); }
+    }
+
+    void FailoverTransport::SetEndpoints(const std::string& name,
+                                         const std::vector<Endpoint>& endpoints) {
+        std::vector<std::shared_ptr<MqttV5::Connection>> closed;
+        std::vector<MqttClientNetworkTransport::CancelDelegate> cancels;
+        {
+            std::lock_guard<decltype(impl_->mutex)> lock(impl_->mutex);
+            const auto existing = impl_->groups.find(name);
+            if (existing != impl_->groups.end())
+            {
+                impl_->Retire(*existing->second, closed, cancels);
+                impl_->groups.erase(existing);
+            }
+            if (!endpoints.empty())
+            {
+                const auto group = std::make_shared<Group>();
+                group->name = name;
+                group->endpoints.resize(endpoints.size());
+                for (size_t i = 0; i < endpoints.size(); ++i)
+                { group->endpoints[i].endpoint = endpoints[i]; }
+                impl_->groups[name] = group;
+                impl_->ScheduleProbes(group, std::chrono::steady_clock::now());
+            }
+        }
+        Impl::Release(closed, cancels);
+    }
+
+    auto FailoverTransport::GetEndpointStatus(const std::string& name) const
+        -> std::vector<EndpointStatus> {
+        std::vector<EndpointStatus> statuses;
+        std::lock_guard<decltype(impl_->mutex)> lock(impl_->mutex);
+        const auto group = impl_->groups.find(name);
+        if (group == impl_->groups.end())
+        { return statuses; }
+        const auto now = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < group->second->endpoints.size(); ++i)
+        {
+            const auto& state = group->second->endpoints[i];
+            EndpointStatus status;
+            status.endpoint = state.endpoint;
+            status.healthy = group->second->IsHealthy(i, now);
+            status.consecutiveFailures = state.consecutiveFailures;
+            status.connects = state.connects;
+            status.failures = state.failures;
+            status.standby =
+                ((group->second->standbyIndex == i) && (group->second->standby != nullptr));
+            status.smoothedRttMicroseconds = (uint64_t)state.smoothedRtt;
+            status.rttSamples = state.rttSamples;
+            statuses.push_back(status);
+        }
+        return statuses;
+    }
+
+    std::shared_ptr<MqttV5::Connection> FailoverTransport::Connect(
+        const std::string& scheme, const std::string& hostNameOrAddress, uint16_t port,
+        MqttV5::Connection::DataReceivedDelegate dataReceivedDelegate,
+        MqttV5::Connection::BrokenDelegate brokenDelegate) {
+        std::shared_ptr<Group> group;
+        Configuration configuration;
+        std::shared_ptr<Watch> watch;
+        std::shared_ptr<MqttV5::Connection> connection;
+        size_t connectedIndex = NO_ENDPOINT;
+        {
+            std::lock_guard<decltype(impl_->mutex)> lock(impl_->mutex);
+            const auto found = impl_->groups.find(hostNameOrAddress);
+            if (found != impl_->groups.end())
+            {
+                group = found->second;
+                configuration = impl_->configuration;
+                group->scheme = scheme;
+                group->port = port;
+                connection = impl_->TakeStandby(*group, brokenDelegate, watch, connectedIndex);
+            }
+        }
+        if (group == nullptr)
+        {
+            return impl_->transport->Connect(scheme, hostNameOrAddress, port,
+                                             dataReceivedDelegate, brokenDelegate);
+        }
+        const bool standby = (connection != nullptr);
+        const auto deadline = std::chrono::steady_clock::now() +
+                              std::chrono::milliseconds(configuration.failoverBudgetMilliseconds);
+        const auto attemptTimeout =
+            std::chrono::milliseconds(configuration.attemptTimeoutMilliseconds);
+        std::vector<size_t> order;
+        if (!standby)
+        {
+            std::lock_guard<decltype(impl_->mutex)> lock(impl_->mutex);
+            order = group->Order(std::chrono::steady_clock::now(), true);
+        }
+        for (const auto index : order)
+        {
+            const auto now = std::chrono::steady_clock::now();
+            if (now >= deadline)
+            { break; }
+            std::string endpointScheme;
+            std::string host;
+            uint16_t endpointPort;
+            std::string description;
+            {
+                std::lock_guard<decltype(impl_->mutex)> lock(impl_->mutex);
+                endpointScheme = group->SchemeOf(index);
+                host = group->endpoints[index].endpoint.hostNameOrAddress;
+                endpointPort = group->PortOf(index);
+                description = group->Describe(index);
+            }
+            watch = std::make_shared<Watch>();
+            watch->brokenDelegate = brokenDelegate;
+            const auto connected =
+                std::make_shared<std::promise<std::shared_ptr<MqttV5::Connection>>>();
+            auto outcome = connected->get_future();
+            const auto cancel = impl_->transport->ConnectAsync(
+                endpointScheme, host, endpointPort, dataReceivedDelegate,
+                impl_->MakeBrokenDelegate(group, index, watch),
+                [connected](std::shared_ptr<MqttV5::Connection> newConnection)
+                { connected->set_value(newConnection); });
+            const auto wait = std::min<std::chrono::steady_clock::duration>(
+                deadline - now, attemptTimeout);
+            if (outcome.wait_for(wait) != std::future_status::ready)
+            { cancel(); }
+            connection = outcome.get();
+            std::lock_guard<decltype(impl_->mutex)> lock(impl_->mutex);
+            if (connection != nullptr)
+            {
+                connectedIndex = index;
+                impl_->RecordConnect(*group, index);
+                impl_->diagnosticsSender->SendDiagnosticInformationFormatted(
+                    1, "Connected to broker '%s' of '%s'", description.c_str(),
+                    hostNameOrAddress.c_str());
+                break;
+            }
+            impl_->RecordFailure(*group, index);
+            impl_->diagnosticsSender->SendDiagnosticInformationFormatted(
+                SystemUtils::DiagnosticsSender::Levels::WARNING,
+                "Unable to connect to broker '%s' of '%s'; failing over", description.c_str(),
+                hostNameOrAddress.c_str());
+        }
+        if (connection == nullptr)
+        {
+            impl_->diagnosticsSender->SendDiagnosticInformationFormatted(
+                SystemUtils::DiagnosticsSender::Levels::ERROR,
+                "Unable to connect to any broker of '%s'", hostNameOrAddress.c_str());
+            return nullptr;
+        }
+        impl_->OpenStandby(group);
+        const auto failoverConnection = std::make_shared<FailoverConnection>();
+        failoverConnection->connection = connection;
+        failoverConnection->zeroCopyConnection =
+            std::dynamic_pointer_cast<ZeroCopyConnection>(connection);
+        failoverConnection->watch = watch;
+        if (configuration.probeSessionPings)
+        { failoverConnection->rttMeasured = impl_->MakeRttDelegate(group, connectedIndex); }
+        if (standby || configuration.probeSessionPings)
+        { failoverConnection->SetDataReceivedDelegate(dataReceivedDelegate); }
+        return failoverConnection;
+    }
+}  // namespace MqttNetworkTransport
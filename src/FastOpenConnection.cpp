@@ -0,0 +1,43 @@
+/**
+ * @file FastOpenConnection.cpp
+ *
+ * This module implements the helpers of the
+ * MqttNetworkTransport::FastOpenConnection interface.
+ *
+ * © 2025 by Hatem Nabli
+ */
+
+#include "FastOpenConnection.hpp"
+#include <errno.h>
+#include <string.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+
+#ifndef TCP_FASTOPEN_CONNECT
+#    define TCP_FASTOPEN_CONNECT 30
+#endif
+
+#ifndef TCPI_OPT_SYN_DATA
+#    define TCPI_OPT_SYN_DATA 32
+#endif
+
+namespace MqttNetworkTransport
+{
+    bool FastOpenConnection::SetUpSocket(int sock, std::string& error) {
+        const int enable = 1;
+        if (setsockopt(sock, IPPROTO_TCP, TCP_FASTOPEN_CONNECT, &enable, sizeof(enable)) == 0)
+        { return true; }
+        error = strerror(errno);
+        return false;
+    }
+
+    bool FastOpenConnection::WasUsed(int sock) {
+        struct tcp_info info;
+        socklen_t infoLength = sizeof(info);
+        (void)memset(&info, 0, sizeof(info));
+        if (getsockopt(sock, IPPROTO_TCP, TCP_INFO, &info, &infoLength) != 0)
+        { return false; }
+        return ((info.tcpi_options & TCPI_OPT_SYN_DATA) != 0);
+    }
+}  // namespace MqttNetworkTransport
@@ -0,0 +1,77 @@
+#ifndef MQTT_NETWORK_TRANSPORT_FAST_OPEN_CONNECTION_HPP
+#define MQTT_NETWORK_TRANSPORT_FAST_OPEN_CONNECTION_HPP
+/**
+ * @file FastOpenConnection.hpp
+ *
+ * This module declares the MqttNetworkTransport::FastOpenConnection
+ * interface.
+ *
+ * © 2025 by Hatem Nabli
+ */
+
+#include <string>
+
+namespace MqttNetworkTransport
+{
+    /**
+     * This is implemented by network connections which can be established
+     * with TCP Fast Open, so that the first data sent goes out in the SYN
+     * segment, saving a round trip, when reconnecting to a server which
+     * handed out a Fast Open cookie before.
+     */
+    class FastOpenConnection
+    {
+    public:
+        virtual ~FastOpenConnection() = default;
+
+        /**
+         * This method requests that the connection be established with
+         * TCP Fast Open.  It must be called before connecting.  When
+         * the operating system holds a cookie for the server, the connect
+         * attempt then completes at once, and the SYN segment is only
+         * sent, along with the first data, once data is sent.
+         */
+        virtual void EnableFastOpen() = 0;
+
+        /**
+         * This method returns whether or not the connection was
+         * established with TCP Fast Open, the server having accepted
+         * the data sent in the SYN segment.
+         *
+         * @return
+         *      An indication of whether or not TCP Fast Open
+         *      was used is returned.
+         */
+        virtual bool UsedFastOpen() = 0;
+
+        /**
+         * This function sets up the given socket, before it connects,
+         * to connect with TCP Fast Open.
+         *
+         * @param[in] sock
+         *      This is the socket to set up.
+         * @param[out] error
+         *      This is where to store a description of what went wrong,
+         *      if the socket could not be set up.
+         * @return
+         *      An indication of whether or not the socket
+         *      was set up is returned.
+         */
+        static bool SetUpSocket(int sock, std::string& error);
+
+        /**
+         * This function returns whether or not the given connected socket
+         * was established with data in its SYN segment which the
+         * server accepted.
+         *
+         * @param[in] sock
+         *      This is the socket to check.
+         * @return
+         *      An indication of whether or not TCP Fast Open
+         *      was used is returned.
+         */
+        static bool WasUsed(int sock);
+    };
+}  // namespace MqttNetworkTransport
+
+#endif /** MQTT_NETWORK_TRANSPORT_FAST_OPEN_CONNECTION_HPP */
@@ -0,0 +1,49 @@
+#ifndef MQTT_NETWORK_TRANSPORT_GATHER_NETWORK_CONNECTION_HPP
+#define MQTT_NETWORK_TRANSPORT_GATHER_NETWORK_CONNECTION_HPP
+/**
+ * @file GatherNetworkConnection.hpp
+ *
+ * This module declares the MqttNetworkTransport::GatherNetworkConnection
+ * interface.
+ *
+ * © 2025 by Hatem Nabli
+ */
+
+#include "OutgoingMessage.hpp"
+#include <vector>
+#include <SystemUtils/INetworkConnection.hpp>
+
+namespace MqttNetworkTransport
+{
+    /**
+     * This is implemented by network connections which take ownership of
+     * (or a reference to) the messages they send, rather than copying
+     * them, and which can hand several messages to the operating system
+     * with a single gathering write.
+     */
+    class GatherNetworkConnection : public SystemUtils::INetworkConnection
+    {
+    public:
+        using SystemUtils::INetworkConnection::SendMessage;
+
+        /**
+         * This method queues the given message to be sent,
+         * without copying it.
+         *
+         * @param[in] message
+         *      This is the message to send.
+         */
+        virtual void SendMessage(OutgoingMessage&& message) = 0;
+
+        /**
+         * This method queues the given messages to be sent, in order,
+         * gathering them into as few writes as possible.
+         *
+         * @param[in] messages
+         *      These are the messages to send.
+         */
+        virtual void SendMessages(std::vector<OutgoingMessage>&& messages) = 0;
+    };
+}  // namespace MqttNetworkTransport
+
+#endif /** MQTT_NETWORK_TRANSPORT_GATHER_NETWORK_CONNECTION_HPP */
@@ -0,0 +1,309 @@
+/**
+ * @file HostResolver.cpp
+ *
+ * This module implements the MqttNetworkTransport::HostResolver class.
+ *
+ * © 2025 by Hatem Nabli
+ */
+
+#include "HostResolver.hpp"
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    /**
+     * This is the number of cached hosts above which expired
+     * entries are swept out of the cache.
+     */
+    constexpr size_t CACHE_SWEEP_THRESHOLD = 1024;
+}  // namespace
+
+namespace MqttNetworkTransport
+{
+    struct HostResolver::Impl
+    {
+        /**
+         * This holds what is remembered about a host.
+         */
+        struct CacheEntry
+        {
+            /**
+             * These are the addresses of the host, or an empty
+             * list if it could not be resolved.
+             */
+            Addresses addresses;
+
+            /**
+             * This is the time at which the entry is no longer valid.
+             */
+            std::chrono::steady_clock::time_point expiration;
+        };
+
+        /**
+         * This is the function used to look up the addresses of a host.
+         */
+        LookupFunction lookup;
+
+        /**
+         * This is used to synchronize access to the state of the resolver.
+         */
+        std::mutex mutex;
+
+        /**
+         * This is used to wake the worker threads when there are
+         * hosts to look up or the resolver is stopping.
+         */
+        std::condition_variable wakeCondition;
+
+        /**
+         * This is how long a resolved address is remembered.
+         */
+        std::chrono::seconds positiveTtl{0};
+
+        /**
+         * This is how long a failure to resolve a host is remembered.
+         */
+        std::chrono::seconds negativeTtl{0};
+
+        /**
+         * These are the hosts remembered, keyed by name.
+         */
+        std::map<std::string, CacheEntry> cache;
+
+        /**
+         * These are the functions waiting for the result of looking
+         * up each host being looked up, keyed by name.
+         */
+        std::map<std::string, std::vector<ResultDelegate>> waiting;
+
+        /**
+         * These are the hosts waiting for a worker to look them up.
+         */
+        std::deque<std::string> queue;
+
+        /**
+         * This flag indicates whether or not the worker threads should stop.
+         */
+        bool stop = false;
+
+        /**
+         * These are the threads which look up hosts.
+         */
+        std::vector<std::thread> workers;
+
+        /**
+         * This method remembers the result of looking up a host.
+         *
+         * @param[in] host
+         *      This is the name of the host looked up.
+         * @param[in] addresses
+         *      These are the addresses found, if any.
+         */
+        void Remember(const std::string& host, const Addresses& addresses) {
+            const auto ttl = addresses.empty() ? negativeTtl : positiveTtl;
+            if (ttl.count() == 0)
+            { return; }
+            const auto now = std::chrono::steady_clock::now();
+            if (cache.size() >= CACHE_SWEEP_THRESHOLD)
+            {
+                for (auto entry = cache.begin(); entry != cache.end();)
+                {
+                    if (entry->second.expiration <= now)
+                    { entry = cache.erase(entry); } else
+                    { ++entry; }
+                }
+            }
+            auto& entry = cache[host];
+            entry.addresses = addresses;
+            entry.expiration = now + ttl;
+        }
+
+        /**
+         * This is the body of each worker thread.
+         */
+        void Run() {
+            std::unique_lock<decltype(mutex)> lock(mutex);
+            while (!stop)
+            {
+                if (queue.empty())
+                {
+                    wakeCondition.wait(lock);
+                    continue;
+                }
+                const auto host = std::move(queue.front());
+                queue.pop_front();
+                lock.unlock();
+                const auto addresses = lookup(host);
+                lock.lock();
+                Remember(host, addresses);
+                const auto waiters = waiting.find(host);
+                if (waiters == waiting.end())
+                { continue; }
+                {
+                    const auto delegates = std::move(waiters->second);
+                    (void)waiting.erase(waiters);
+                    lock.unlock();
+                    for (const auto& delegate : delegates)
+                    { delegate(addresses); }
+                }
+                lock.lock();
+            }
+        }
+    };
+
+    HostResolver::~HostResolver() noexcept {
+        std::vector<ResultDelegate> abandoned;
+        {
+            std::lock_guard<decltype(impl_->mutex)> lock(impl_->mutex);
+            impl_->stop = true;
+            for (const auto& host : impl_->queue)
+            {
+                const auto waiters = impl_->waiting.find(host);
+                if (waiters == impl_->waiting.end())
+                { continue; }
+                for (auto& delegate : waiters->second)
+                { abandoned.push_back(std::move(delegate)); }
+                (void)impl_->waiting.erase(waiters);
+            }
+            impl_->queue.clear();
+            impl_->wakeCondition.notify_all();
+        }
+        for (const auto& delegate : abandoned)
+        { delegate(Addresses()); }
+        for (auto& worker : impl_->workers)
+        {
+            if (worker.get_id() == std::this_thread::get_id())
+            { worker.detach(); } else
+            { worker.join(); }
+        }
+    }
+
+    HostResolver::HostResolver(size_t workerCount, LookupFunction lookup) :
+        impl_(std::make_shared<Impl>()) {
+        impl_->lookup = std::move(lookup);
+        const auto impl = impl_;
+        for (size_t i = 0; i < workerCount; ++i)
+        { impl_->workers.emplace_back([impl] { impl->Run(); }); }
+    }
+
+    void HostResolver::SetTimeToLive(std::chrono::seconds positiveTtl,
+                                     std::chrono::seconds negativeTtl) {
+        std::lock_guard<decltype(impl_->mutex)> lock(impl_->mutex);
+        impl_->positiveTtl = positiveTtl;
+        impl_->negativeTtl = negativeTtl;
+        if ((positiveTtl.count() == 0) && (negativeTtl.count() == 0))
+        { impl_->cache.clear(); }
+    }
+
+    auto HostResolver::Address::FromIpv4(uint32_t address) -> Address {
+        Address ipv4;
+        ipv4.bytes[0] = (uint8_t)(address >> 24);
+        ipv4.bytes[1] = (uint8_t)(address >> 16);
+        ipv4.bytes[2] = (uint8_t)(address >> 8);
+        ipv4.bytes[3] = (uint8_t)address;
+        return ipv4;
+    }
+
+    uint32_t HostResolver::Address::GetIpv4() const {
+        if (ipv6)
+        { return 0; }
+        return (((uint32_t)bytes[0] << 24) | ((uint32_t)bytes[1] << 16) |
+                ((uint32_t)bytes[2] << 8) | (uint32_t)bytes[3]);
+    }
+
+    void HostResolver::ResolveAsync(const std::string& host, ResultDelegate delegate) {
+        Addresses addresses;
+        uint32_t address = 0;
+        if (ParseDottedQuad(host, address))
+        {
+            addresses.push_back(Address::FromIpv4(address));
+            delegate(addresses);
+            return;
+        }
+        {
+            std::lock_guard<decltype(impl_->mutex)> lock(impl_->mutex);
+            const auto entry = impl_->cache.find(host);
+            if ((entry == impl_->cache.end()) ||
+                (entry->second.expiration <= std::chrono::steady_clock::now()))
+            {
+                if (!impl_->stop)
+                {
+                    auto& waiters = impl_->waiting[host];
+                    waiters.push_back(std::move(delegate));
+                    if (waiters.size() == 1)
+                    {
+                        impl_->queue.push_back(host);
+                        impl_->wakeCondition.notify_one();
+                    }
+                    return;
+                }
+            } else
+            { addresses = entry->second.addresses; }
+        }
+        delegate(addresses);
+    }
+
+    auto HostResolver::Resolve(const std::string& host) -> Addresses {
+        const auto result = std::make_shared<std::promise<Addresses>>();
+        auto addresses = result->get_future();
+        ResolveAsync(host,
+                     [result](const Addresses& addresses) { result->set_value(addresses); });
+        return addresses.get();
+    }
+
+    auto HostResolver::InterleaveFamilies(const Addresses& addresses) -> Addresses {
+        Addresses firstFamily;
+        Addresses otherFamily;
+        for (const auto& address : addresses)
+        {
+            if (address.ipv6 == addresses[0].ipv6)
+            { firstFamily.push_back(address); } else
+            { otherFamily.push_back(address); }
+        }
+        Addresses interleaved;
+        interleaved.reserve(addresses.size());
+        for (size_t i = 0; (i < firstFamily.size()) || (i < otherFamily.size()); ++i)
+        {
+            if (i < firstFamily.size())
+            { interleaved.push_back(firstFamily[i]); }
+            if (i < otherFamily.size())
+            { interleaved.push_back(otherFamily[i]); }
+        }
+        return interleaved;
+    }
+
+    bool HostResolver::ParseDottedQuad(const std::string& host, uint32_t& address) {
+        uint32_t value = 0;
+        size_t parts = 0;
+        size_t i = 0;
+        while (parts < 4)
+        {
+            uint32_t part = 0;
+            size_t digits = 0;
+            while ((i < host.length()) && (host[i] >= '0') && (host[i] <= '9'))
+            {
+                part = part * 10 + (uint32_t)(host[i++] - '0');
+                if ((++digits > 3) || (part > 255))
+                { return false; }
+            }
+            if (digits == 0)
+            { return false; }
+            value = (value << 8) | part;
+            if (++parts < 4)
+            {
+                if ((i >= host.length()) || (host[i++] != '.'))
+                { return false; }
+            }
+        }
+        if (i != host.length())
+        { return false; }
+        address = value;
+        return true;
+    }
+}  // namespace MqttNetworkTransport
@@ -0,0 +1,201 @@
+#ifndef MQTT_NETWORK_TRANSPORT_HOST_RESOLVER_HPP
+#define MQTT_NETWORK_TRANSPORT_HOST_RESOLVER_HPP
+/**
+ * @file HostResolver.hpp
+ *
+ * This module declares the MqttNetworkTransport::HostResolver class.
+ *
+ * © 2025 by Hatem Nabli
+ */
+
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+#include <stddef.h>
+#include <stdint.h>
+
+namespace MqttNetworkTransport
+{
+    /**
+     * This resolves host names to IPv4 and IPv6 addresses on worker threads,
+     * caching both the addresses found and the failures for a while, so
+     * that repeated connections to the same host don't each need a lookup.
+     * Concurrent requests for the same host share a single lookup.
+     */
+    class HostResolver
+    {
+    public:
+        /**
+         * This holds one address of a host.
+         */
+        struct Address
+        {
+            /**
+             * This indicates whether the address is an IPv6 address,
+             * rather than an IPv4 one.
+             */
+            bool ipv6 = false;
+
+            /**
+             * These are the bytes of the address, in network byte order.
+             * Only the first four are used by IPv4 addresses.
+             */
+            uint8_t bytes[16] = {0};
+
+            /**
+             * This is the scope (interface) of a link-local IPv6
+             * address, or zero.
+             */
+            uint32_t scopeId = 0;
+
+            /**
+             * This function makes an address from the given IPv4 address.
+             *
+             * @param[in] address
+             *      This is the IPv4 address, in host byte order.
+             * @return
+             *      The address is returned.
+             */
+            static Address FromIpv4(uint32_t address);
+
+            /**
+             * This method returns the address as an IPv4 address.
+             *
+             * @return
+             *      The IPv4 address, in host byte order, is returned,
+             *      or zero if this is an IPv6 address.
+             */
+            uint32_t GetIpv4() const;
+        };
+
+        /**
+         * This is the type of list of addresses of a host, in the order
+         * in which they should be tried.  It is empty if the host
+         * could not be resolved.
+         */
+        typedef std::vector<Address> Addresses;
+
+        /**
+         * This is the type of function used to look up the addresses of a host.
+         *
+         * @param[in] host
+         *      This is the name of the host to look up.
+         * @return
+         *      The addresses of the host are returned, or an empty
+         *      list if none could be found.
+         */
+        typedef std::function<Addresses(const std::string& host)> LookupFunction;
+
+        /**
+         * This is the type of function called with the result
+         * of resolving a host.
+         *
+         * @param[in] addresses
+         *      These are the addresses of the host, or an empty
+         *      list if it could not be resolved.
+         */
+        typedef std::function<void(const Addresses& addresses)> ResultDelegate;
+
+        // Lifecycle management
+    public:
+        ~HostResolver() noexcept;
+        HostResolver(const HostResolver&) = delete;
+        HostResolver(HostResolver&&) noexcept = delete;
+        HostResolver& operator=(const HostResolver&) = delete;
+        HostResolver& operator=(HostResolver&&) noexcept = delete;
+
+        // Public methods
+    public:
+        /**
+         * This is the constructor.
+         *
+         * @param[in] workerCount
+         *      This is the number of threads performing lookups.
+         * @param[in] lookup
+         *      This is the function used to look up the addresses of a host.
+         */
+        HostResolver(size_t workerCount, LookupFunction lookup);
+
+        /**
+         * This method sets how long resolved addresses and failures
+         * are remembered.  A time of zero disables caching them.
+         *
+         * @param[in] positiveTtl
+         *      This is how long a resolved address is remembered.
+         * @param[in] negativeTtl
+         *      This is how long a failure to resolve a host is remembered.
+         */
+        void SetTimeToLive(std::chrono::seconds positiveTtl, std::chrono::seconds negativeTtl);
+
+        /**
+         * This method resolves the given host without blocking.  If the
+         * host is an IPv4 literal, or its address is cached, the delegate
+         * is called before this method returns.  Otherwise, it is called
+         * by a worker thread once the lookup completes.
+         *
+         * @param[in] host
+         *      This is the name or IPv4 literal of the host to resolve.
+         * @param[in] delegate
+         *      This is the function to call with the result.
+         */
+        void ResolveAsync(const std::string& host, ResultDelegate delegate);
+
+        /**
+         * This method resolves the given host, waiting for the
+         * lookup to complete if needed.
+         *
+         * @param[in] host
+         *      This is the name or IPv4 literal of the host to resolve.
+         * @return
+         *      The addresses of the host are returned, or an empty
+         *      list if it could not be resolved.
+         */
+        Addresses Resolve(const std::string& host);
+
+        /**
+         * This function orders the given addresses for connecting, as
+         * recommended by RFC 8305 (section 4): the families alternate,
+         * starting with the family of the first address, and otherwise
+         * the addresses keep their order.
+         *
+         * @param[in] addresses
+         *      These are the addresses to order.
+         * @return
+         *      The ordered addresses are returned.
+         */
+        static Addresses InterleaveFamilies(const Addresses& addresses);
+
+        /**
+         * This function parses a dotted-quad IPv4 literal.
+         *
+         * @param[in] host
+         *      This is the text to parse.
+         * @param[out] address
+         *      This is where to store the address, in host byte order.
+         * @return
+         *      An indication of whether or not the text is a
+         *      dotted-quad IPv4 literal is returned.
+         */
+        static bool ParseDottedQuad(const std::string& host, uint32_t& address);
+
+        // Private properties
+    private:
+        /**
+         * This is the type of structure that contains the private
+         * properties of the instance.  It is defined in the implementation
+         * and declared here to ensure that it is scoped inside the class.
+         */
+        struct Impl;
+
+        /**
+         * This contains the private properties of the instance.  It is
+         * shared with the worker threads, one of which may be the thread
+         * destroying the resolver.
+         */
+        std::shared_ptr<Impl> impl_;
+    };
+}  // namespace MqttNetworkTransport
+
+#endif /** MQTT_NETWORK_TRANSPORT_HOST_RESOLVER_HPP */
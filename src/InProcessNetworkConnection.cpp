@@ -0,0 +1,453 @@
+/**
+ * @file InProcessNetworkConnection.cpp
+ *
+ * This module implements the
+ * MqttNetworkTransport::InProcessNetworkConnection class.
+ *
+ * © 2025 by Hatem Nabli
+ */
+
+#include "InProcessNetworkConnection.hpp"
+#include <deque>
+#include <map>
+#include <mutex>
+
+namespace
+{
+    /**
+     * This holds what is needed to accept connections to a name.
+     */
+    struct Listener
+    {
+        /**
+         * This is the function to call whenever a connection
+         * is made to the name.
+         */
+        MqttNetworkTransport::InProcessNetworkConnection::AcceptDelegate acceptDelegate;
+    };
+
+    /**
+     * This holds the names listened to in the process.
+     */
+    struct Registry
+    {
+        /**
+         * This is used to synchronize access to the listeners.
+         */
+        std::mutex mutex;
+
+        /**
+         * These are the listeners, keyed by the names they listen to.
+         */
+        std::map<std::string, std::shared_ptr<Listener>> listeners;
+    };
+
+    /**
+     * This function returns the registry of names listened to in the
+     * process.  It is never destroyed, so that listening may be stopped
+     * while static objects are being destroyed.
+     *
+     * @return
+     *      The registry of the process is returned.
+     */
+    Registry& GetRegistry() {
+        static Registry* const registry = new Registry();
+        return *registry;
+    }
+}  // namespace
+
+namespace MqttNetworkTransport
+{
+    struct InProcessNetworkConnection::Impl : public std::enable_shared_from_this<Impl>
+    {
+        /**
+         * These are the states the connection may be in.
+         */
+        enum class State
+        {
+            /**
+             * The connection hasn't been connected yet.
+             */
+            Idle,
+
+            /**
+             * The connection is paired with its other side.
+             */
+            Connected,
+
+            /**
+             * The connection was closed, by either side.
+             */
+            Closed,
+        };
+
+        /**
+         * This is the name under which the other side listens.
+         */
+        std::string name;
+
+        /**
+         * This is the pool of workers which deliver received messages.
+         */
+        std::shared_ptr<WorkerPool> workers;
+
+        /**
+         * This is a helper object used to generate and publish diagnostics messages.
+         */
+        std::shared_ptr<SystemUtils::DiagnosticsSender> diagnosticsSender;
+
+        /**
+         * This is used to synchronize access to the state of the connection.
+         */
+        mutable std::mutex mutex;
+
+        /**
+         * This is the state of the connection.
+         */
+        State state = State::Idle;
+
+        /**
+         * This is the other side of the connection, while connected.
+         */
+        std::weak_ptr<Impl> peer;
+
+        /**
+         * This is the function to call to deliver received messages.
+         */
+        MessageReceivedDelegate messageReceivedDelegate;
+
+        /**
+         * This is the function to call once the connection is broken.
+         */
+        BrokenDelegate brokenDelegate;
+
+        /**
+         * This indicates whether or not the connection is processing,
+         * and so delivering what it receives.
+         */
+        bool processing = false;
+
+        /**
+         * This indicates whether or not a worker is delivering
+         * received messages.
+         */
+        bool delivering = false;
+
+        /**
+         * This indicates whether or not a worker has been asked
+         * to deliver received messages.
+         */
+        bool scheduled = false;
+
+        /**
+         * These are the messages received but not yet delivered.
+         */
+        std::deque<OutgoingMessage> received;
+
+        /**
+         * This indicates whether or not the connection has been broken,
+         * after which nothing more is received.
+         */
+        bool broken = false;
+
+        /**
+         * This indicates whether or not the breakage of the connection
+         * has yet to be delivered, after the messages received before it.
+         */
+        bool brokenPending = false;
+
+        /**
+         * This indicates whether or not the connection
+         * was broken gracefully.
+         */
+        bool brokenGraceful = false;
+
+        /**
+         * This is the constructor for the structure.
+         */
+        Impl() :
+            diagnosticsSender(
+                std::make_shared<SystemUtils::DiagnosticsSender>("InProcessNetworkConnection")) {}
+
+        /**
+         * This method asks a worker to deliver received messages, and the
+         * breakage of the connection, unless one is already doing so or
+         * processing hasn't started.  The caller must hold the mutex.
+         */
+        void Schedule() {
+            if (!processing || delivering || scheduled)
+            { return; }
+            scheduled = true;
+            const auto self = shared_from_this();
+            workers->Post([self] { self->Deliver(); });
+        }
+
+        /**
+         * This method delivers the messages received, and then the breakage
+         * of the connection, if it is broken.  Only one worker delivers at
+         * a time, so that messages are delivered in order.  The caller
+         * must not hold the mutex.
+         */
+        void Deliver() {
+            std::unique_lock<decltype(mutex)> lock(mutex);
+            scheduled = false;
+            delivering = true;
+            const auto delegate = messageReceivedDelegate;
+            for (;;)
+            {
+                if (!received.empty())
+                {
+                    const auto message = std::move(received.front());
+                    received.pop_front();
+                    lock.unlock();
+                    if (delegate != nullptr)
+                    { delegate(message.Bytes()); }
+                    lock.lock();
+                    continue;
+                }
+                if (brokenPending)
+                {
+                    brokenPending = false;
+                    BrokenDelegate brokenDelegateCopy;
+                    brokenDelegateCopy.swap(brokenDelegate);
+                    const bool graceful = brokenGraceful;
+                    lock.unlock();
+                    if (brokenDelegateCopy != nullptr)
+                    { brokenDelegateCopy(graceful); }
+                    lock.lock();
+                    continue;
+                }
+                break;
+            }
+            delivering = false;
+        }
+
+        /**
+         * This method hands the given message over to the connection,
+         * as sent by its other side.
+         *
+         * @param[in] message
+         *      This is the message received.
+         */
+        void Receive(OutgoingMessage&& message) {
+            std::lock_guard<decltype(mutex)> lock(mutex);
+            if (broken)
+            { return; }
+            received.push_back(std::move(message));
+            Schedule();
+        }
+
+        /**
+         * This method hands the given messages over to the connection,
+         * as sent by its other side.
+         *
+         * @param[in] messages
+         *      These are the messages received, in order.
+         */
+        void Receive(std::vector<OutgoingMessage>&& messages) {
+            std::lock_guard<decltype(mutex)> lock(mutex);
+            if (broken)
+            { return; }
+            for (auto& message : messages)
+            { received.push_back(std::move(message)); }
+            Schedule();
+        }
+
+        /**
+         * This method marks the connection as broken, the messages already
+         * received being delivered before the breakage.  The caller
+         * must hold the mutex.
+         *
+         * @param[in] graceful
+         *      This indicates whether or not the connection
+         *      was closed cleanly.
+         */
+        void Break(bool graceful) {
+            state = State::Closed;
+            peer.reset();
+            if (broken)
+            { return; }
+            broken = true;
+            brokenPending = true;
+            brokenGraceful = graceful;
+            Schedule();
+        }
+
+        /**
+         * This method tells the connection that its other side was closed.
+         *
+         * @param[in] graceful
+         *      This indicates whether or not the other side
+         *      was closed cleanly.
+         */
+        void OnPeerClosed(bool graceful) {
+            std::lock_guard<decltype(mutex)> lock(mutex);
+            if (state == State::Connected)
+            { Break(graceful); }
+        }
+
+        /**
+         * This method closes the connection, telling its other side.
+         *
+         * @param[in] clean
+         *      This indicates whether or not the messages already received
+         *      are delivered before the breakage of the connection.
+         * @param[in] notify
+         *      This indicates whether or not the breakage of the
+         *      connection is delivered to this side too.
+         */
+        void Disconnect(bool clean, bool notify) {
+            std::shared_ptr<Impl> other;
+            {
+                std::lock_guard<decltype(mutex)> lock(mutex);
+                if (state != State::Connected)
+                { return; }
+                other = peer.lock();
+                if (!clean || !notify)
+                { received.clear(); }
+                if (!notify)
+                {
+                    messageReceivedDelegate = nullptr;
+                    brokenDelegate = nullptr;
+                }
+                Break(clean);
+            }
+            if (other != nullptr)
+            { other->OnPeerClosed(clean); }
+        }
+
+        /**
+         * This method returns the other side of the connection,
+         * if it is connected.
+         *
+         * @return
+         *      The other side of the connection is returned,
+         *      or nullptr if it isn't connected.
+         */
+        std::shared_ptr<Impl> GetPeer() const {
+            std::lock_guard<decltype(mutex)> lock(mutex);
+            if (state != State::Connected)
+            { return nullptr; }
+            return peer.lock();
+        }
+    };
+
+    InProcessNetworkConnection::~InProcessNetworkConnection() noexcept {
+        impl_->Disconnect(false, false);
+    }
+
+    InProcessNetworkConnection::InProcessNetworkConnection(const std::string& name,
+                                                           std::shared_ptr<WorkerPool> workers) :
+        impl_(std::make_shared<Impl>()) {
+        impl_->name = name;
+        impl_->workers = workers;
+    }
+
+    auto InProcessNetworkConnection::Listen(const std::string& name,
+                                            AcceptDelegate acceptDelegate)
+        -> StopListeningDelegate {
+        auto& registry = GetRegistry();
+        const auto listener = std::make_shared<Listener>();
+        listener->acceptDelegate = acceptDelegate;
+        {
+            std::lock_guard<decltype(registry.mutex)> lock(registry.mutex);
+            if (!registry.listeners.emplace(name, listener).second)
+            { return nullptr; }
+        }
+        std::weak_ptr<Listener> listenerWeak(listener);
+        return [name, listenerWeak]
+        {
+            auto& registry = GetRegistry();
+            std::lock_guard<decltype(registry.mutex)> lock(registry.mutex);
+            const auto entry = registry.listeners.find(name);
+            if ((entry != registry.listeners.end()) && (entry->second == listenerWeak.lock()))
+            { (void)registry.listeners.erase(entry); }
+        };
+    }
+
+    const std::string& InProcessNetworkConnection::GetName() const { return impl_->name; }
+
+    SystemUtils::DiagnosticsSender::UnsubscribeDelegate
+    InProcessNetworkConnection::SubscribeToDiagnostics(
+        SystemUtils::DiagnosticsSender::DiagnosticMessageDelegate delegate, size_t minLevel) {
+        return impl_->diagnosticsSender->SubscribeToDiagnostics(delegate, minLevel);
+    }
+
+    bool InProcessNetworkConnection::Connect(uint32_t, uint16_t) {
+        std::shared_ptr<Listener> listener;
+        {
+            auto& registry = GetRegistry();
+            std::lock_guard<decltype(registry.mutex)> lock(registry.mutex);
+            const auto entry = registry.listeners.find(impl_->name);
+            if (entry != registry.listeners.end())
+            { listener = entry->second; }
+        }
+        if (listener == nullptr)
+        {
+            impl_->diagnosticsSender->SendDiagnosticInformationFormatted(
+                SystemUtils::DiagnosticsSender::Levels::ERROR,
+                "nothing is listening in process under the name '%s'", impl_->name.c_str());
+            return false;
+        }
+        const auto other =
+            std::make_shared<InProcessNetworkConnection>(impl_->name, impl_->workers);
+        {
+            std::lock_guard<decltype(impl_->mutex)> lock(impl_->mutex);
+            if (impl_->state != Impl::State::Idle)
+            { return false; }
+            impl_->state = Impl::State::Connected;
+            impl_->peer = other->impl_;
+        }
+        {
+            std::lock_guard<decltype(other->impl_->mutex)> lock(other->impl_->mutex);
+            other->impl_->state = Impl::State::Connected;
+            other->impl_->peer = impl_;
+        }
+        listener->acceptDelegate(other);
+        return true;
+    }
+
+    bool InProcessNetworkConnection::Process(MessageReceivedDelegate messageReceivedDelegate,
+                                             BrokenDelegate brokenDelegate) {
+        std::lock_guard<decltype(impl_->mutex)> lock(impl_->mutex);
+        if ((impl_->state == Impl::State::Idle) || impl_->processing)
+        { return false; }
+        impl_->messageReceivedDelegate = messageReceivedDelegate;
+        impl_->brokenDelegate = brokenDelegate;
+        impl_->processing = true;
+        if (!impl_->received.empty() || impl_->brokenPending)
+        { impl_->Schedule(); }
+        return true;
+    }
+
+    uint32_t InProcessNetworkConnection::GetPeerAddress() const { return 0; }
+
+    uint16_t InProcessNetworkConnection::GetPeerPort() const { return 0; }
+
+    bool InProcessNetworkConnection::IsConnected() const {
+        std::lock_guard<decltype(impl_->mutex)> lock(impl_->mutex);
+        return (impl_->state == Impl::State::Connected);
+    }
+
+    uint32_t InProcessNetworkConnection::GetBoundAddress() const { return 0; }
+
+    uint16_t InProcessNetworkConnection::GetBoundPort() const { return 0; }
+
+    void InProcessNetworkConnection::SendMessage(const std::vector<uint8_t>& message) {
+        SendMessage(OutgoingMessage(std::vector<uint8_t>(message)));
+    }
+
+    void InProcessNetworkConnection::Close(bool clean) { impl_->Disconnect(clean, true); }
+
+    void InProcessNetworkConnection::SendMessage(OutgoingMessage&& message) {
+        const auto other = impl_->GetPeer();
+        if (other != nullptr)
+        { other->Receive(std::move(message)); }
+    }
+
+    void InProcessNetworkConnection::SendMessages(std::vector<OutgoingMessage>&& messages) {
+        const auto other = impl_->GetPeer();
+        if (other != nullptr)
+        { other->Receive(std::move(messages)); }
+    }
+}  // namespace MqttNetworkTransport
@@ -0,0 +1,138 @@
+#ifndef MQTT_NETWORK_TRANSPORT_IN_PROCESS_NETWORK_CONNECTION_HPP
+#define MQTT_NETWORK_TRANSPORT_IN_PROCESS_NETWORK_CONNECTION_HPP
+/**
+ * @file InProcessNetworkConnection.hpp
+ *
+ * This module declares the
+ * MqttNetworkTransport::InProcessNetworkConnection class.
+ *
+ * © 2025 by Hatem Nabli
+ */
+
+#include "GatherNetworkConnection.hpp"
+#include "WorkerPool.hpp"
+#include <functional>
+#include <memory>
+#include <string>
+
+namespace MqttNetworkTransport
+{
+    /**
+     * This is an implementation of SystemUtils::INetworkConnection which
+     * is paired with another one in the same process, listening under a
+     * name, rather than with a socket.  The messages sent are handed
+     * over to the other side as they are, without being copied, and
+     * delivered to it by a pool of workers.  Each side delivers the
+     * messages it receives in order, one at a time.
+     */
+    class InProcessNetworkConnection : public GatherNetworkConnection
+    {
+    public:
+        /**
+         * This is the type of function called when a connection is made
+         * to a name listened to with Listen.
+         *
+         * @param[in] connection
+         *      This is the listener's side of the new connection.  It
+         *      is connected, but not processing yet.
+         */
+        typedef std::function<void(std::shared_ptr<InProcessNetworkConnection> connection)>
+            AcceptDelegate;
+
+        /**
+         * This is the type of function returned by Listen which may be
+         * called to stop accepting connections.
+         */
+        typedef std::function<void()> StopListeningDelegate;
+
+        // Lifecycle management
+    public:
+        /**
+         * This is the destructor.  If the connection is still connected,
+         * the other side is told it is broken.
+         */
+        ~InProcessNetworkConnection() noexcept;
+        InProcessNetworkConnection(const InProcessNetworkConnection&) = delete;
+        InProcessNetworkConnection(InProcessNetworkConnection&&) noexcept = delete;
+        InProcessNetworkConnection& operator=(const InProcessNetworkConnection&) = delete;
+        InProcessNetworkConnection& operator=(InProcessNetworkConnection&&) noexcept = delete;
+
+        // Public methods
+    public:
+        /**
+         * This is the constructor.
+         *
+         * @param[in] name
+         *      This is the name under which the other side of
+         *      the connection listens.
+         * @param[in] workers
+         *      This is the pool of workers which deliver the messages
+         *      received by both sides of the connection.
+         */
+        InProcessNetworkConnection(const std::string& name, std::shared_ptr<WorkerPool> workers);
+
+        /**
+         * This function starts accepting connections to the given name,
+         * from anywhere in the process.
+         *
+         * @param[in] name
+         *      This is the name under which to listen.
+         * @param[in] acceptDelegate
+         *      This is the function to call, on the thread connecting,
+         *      whenever a connection is made to the name.
+         * @return
+         *      A function is returned which may be called to stop
+         *      listening, or nullptr if the name is already in use.
+         */
+        static StopListeningDelegate Listen(const std::string& name,
+                                            AcceptDelegate acceptDelegate);
+
+        /**
+         * This method returns the name under which the other side
+         * of the connection listens.
+         *
+         * @return
+         *      The name of the listening side is returned.
+         */
+        const std::string& GetName() const;
+
+        // SystemUtils::INetworkConnection
+    public:
+        virtual SystemUtils::DiagnosticsSender::UnsubscribeDelegate SubscribeToDiagnostics(
+            SystemUtils::DiagnosticsSender::DiagnosticMessageDelegate delegate,
+            size_t minLevel = 0) override;
+        virtual bool Connect(uint32_t peerAddress, uint16_t peerPort) override;
+        virtual bool Process(MessageReceivedDelegate messageReceivedDelegate,
+                             BrokenDelegate brokenDelegate) override;
+        virtual uint32_t GetPeerAddress() const override;
+        virtual uint16_t GetPeerPort() const override;
+        virtual bool IsConnected() const override;
+        virtual uint32_t GetBoundAddress() const override;
+        virtual uint16_t GetBoundPort() const override;
+        virtual void SendMessage(const std::vector<uint8_t>& message) override;
+        virtual void Close(bool clean = false) override;
+
+        // GatherNetworkConnection
+    public:
+        virtual void SendMessage(OutgoingMessage&& message) override;
+        virtual void SendMessages(std::vector<OutgoingMessage>&& messages) override;
+
+        // Private properties
+    private:
+        /**
+         * This is the type of structure that contains the private
+         * properties of the instance.  It is defined in the implementation
+         * and declared here to ensure that it is scoped inside the class.
+         */
+        struct Impl;
+
+        /**
+         * This contains the private properties of the instance.  It is
+         * shared with the workers, which may still be delivering to the
+         * connection while it is destroyed.
+         */
+        std::shared_ptr<Impl> impl_;
+    };
+}  // namespace MqttNetworkTransport
+
+#endif /** MQTT_NETWORK_TRANSPORT_IN_PROCESS_NETWORK_CONNECTION_HPP */
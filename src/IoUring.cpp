@@ -0,0 +1,613 @@
+/**
+ * @file IoUring.cpp
+ *
+ * This module implements the MqttNetworkTransport::IoUring class.
+ *
+ * © 2025 by Hatem Nabli
+ */
+
+#include "IoUring.hpp"
+#include <algorithm>
+#include <atomic>
+#include <errno.h>
+#include <map>
+#include <mutex>
+#include <poll.h>
+#include <string.h>
+#include <thread>
+#include <vector>
+#include <linux/io_uring.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace
+{
+    /**
+     * This is the number of buffers in the provided buffer ring.
+     * It must be a power of two.
+     */
+    constexpr unsigned RECEIVE_BUFFER_COUNT = 256;
+
+    /**
+     * This is the size of each buffer in the provided buffer ring.
+     */
+    constexpr size_t RECEIVE_BUFFER_SIZE = 16384;
+
+    /**
+     * This is the group identifier of the provided buffer ring.
+     */
+    constexpr uint16_t RECEIVE_BUFFER_GROUP = 0;
+
+    /**
+     * This is the number of low bits of each operation's user data which
+     * hold the kind of operation.  The remaining bits hold the identifier
+     * of the handler to call when the operation completes.
+     */
+    constexpr unsigned OPERATION_BITS = 2;
+
+    /**
+     * These are the kinds of operations submitted to the ring.
+     */
+    enum Operation : uint64_t
+    {
+        OPERATION_WAKE = 0,
+        OPERATION_RECEIVE = 1,
+        OPERATION_SEND = 2,
+        OPERATION_CONNECT = 3,
+    };
+
+    /**
+     * This is the handler identifier given to the poll of the wake-up
+     * event, to tell its completions apart from other wake-ups.
+     */
+    constexpr uint64_t WAKE_POLL_ID = 1;
+
+    /**
+     * This is how long, in milliseconds, the kernel submission queue
+     * poller spins without work before going to sleep.
+     */
+    constexpr unsigned SUBMISSION_POLLING_IDLE_MILLISECONDS = 100;
+
+    /**
+     * This is the instance whose completion thread is the calling thread,
+     * if any.  Submissions made from a completion thread are left for it
+     * to submit together once it runs out of completions.
+     */
+    thread_local const void* currentCompletionThreadRing = nullptr;
+
+    int SetUp(unsigned entries, io_uring_params* params) {
+        return (int)syscall(__NR_io_uring_setup, entries, params);
+    }
+
+    int Enter(int ringFd, unsigned toSubmit, unsigned minComplete, unsigned flags) {
+        return (int)syscall(__NR_io_uring_enter, ringFd, toSubmit, minComplete, flags, nullptr, 0);
+    }
+
+    int RegisterWithRing(int ringFd, unsigned opcode, void* arg, unsigned count) {
+        return (int)syscall(__NR_io_uring_register, ringFd, opcode, arg, count);
+    }
+
+    /**
+     * This returns the address of the ring field at the given offset.
+     */
+    template <typename T> T* RingField(void* ring, uint32_t offset) {
+        return (T*)((uint8_t*)ring + offset);
+    }
+}  // namespace
+
+namespace MqttNetworkTransport
+{
+    struct IoUring::Impl
+    {
+        /**
+         * This is the io_uring instance.
+         */
+        int ringFd = -1;
+
+        /**
+         * This indicates whether or not the kernel polls the submission queue.
+         */
+        bool submissionPolling = false;
+
+        /**
+         * These are the mappings of the submission queue ring,
+         * the completion queue ring, and the submission queue entries.
+         */
+        void* sqRing = MAP_FAILED;
+        size_t sqRingSize = 0;
+        void* cqRing = MAP_FAILED;
+        size_t cqRingSize = 0;
+        io_uring_sqe* sqes = (io_uring_sqe*)MAP_FAILED;
+        size_t sqesSize = 0;
+
+        /**
+         * These are the fields of the submission queue ring.
+         */
+        unsigned* sqHead = nullptr;
+        unsigned* sqTail = nullptr;
+        unsigned* sqMask = nullptr;
+        unsigned* sqEntries = nullptr;
+        unsigned* sqFlags = nullptr;
+        unsigned* sqArray = nullptr;
+
+        /**
+         * These are the fields of the completion queue ring.
+         */
+        unsigned* cqHead = nullptr;
+        unsigned* cqTail = nullptr;
+        unsigned* cqMask = nullptr;
+        io_uring_cqe* cqes = nullptr;
+
+        /**
+         * This is the provided buffer ring registered with the kernel.
+         */
+        io_uring_buf* bufferRing = (io_uring_buf*)MAP_FAILED;
+        size_t bufferRingSize = 0;
+
+        /**
+         * This is the local copy of the provided buffer ring tail.
+         * Only the completion thread changes it after set up.
+         */
+        uint16_t bufferRingTail = 0;
+
+        /**
+         * These are the provided buffers, indexed by buffer identifier.
+         */
+        std::vector<std::vector<uint8_t>> buffers;
+
+        /**
+         * This is used to serialize submissions.
+         */
+        std::mutex submissionMutex;
+
+        /**
+         * This is the event which other threads signal to have the
+         * completion thread submit the entries they added to the
+         * submission queue, unless the kernel polls the queue.
+         */
+        int wakeFd = -1;
+
+        /**
+         * This indicates whether or not the wake-up event has been
+         * signaled and the completion thread hasn't picked it up yet.
+         * It is guarded by the submission mutex.
+         */
+        bool wakePending = false;
+
+        /**
+         * This is used to synchronize access to the handlers and tasks.
+         */
+        std::mutex mutex;
+
+        /**
+         * These are the registered handlers, keyed by identifier.
+         */
+        std::map<uint64_t, std::shared_ptr<Handler>> handlers;
+
+        /**
+         * This is the identifier to give the next registered handler.
+         */
+        uint64_t nextId = 1;
+
+        /**
+         * These are the functions queued to be called
+         * from the completion thread.
+         */
+        std::vector<std::function<void()>> tasks;
+
+        /**
+         * This is the thread which reaps and dispatches completions.
+         */
+        std::thread completionThread;
+
+        /**
+         * This flag indicates whether or not the completion thread should stop.
+         */
+        std::atomic<bool> stop{false};
+
+        ~Impl() noexcept {
+            if (bufferRing != MAP_FAILED)
+            { (void)munmap(bufferRing, bufferRingSize); }
+            if (sqes != MAP_FAILED)
+            { (void)munmap(sqes, sqesSize); }
+            if ((cqRing != MAP_FAILED) && (cqRing != sqRing))
+            { (void)munmap(cqRing, cqRingSize); }
+            if (sqRing != MAP_FAILED)
+            { (void)munmap(sqRing, sqRingSize); }
+            if (ringFd >= 0)
+            { (void)close(ringFd); }
+            if (wakeFd >= 0)
+            { (void)close(wakeFd); }
+        }
+
+        /**
+         * This method maps the rings of the io_uring instance.
+         *
+         * @param[in] params
+         *      These are the parameters returned when setting up the instance.
+         * @return
+         *      An indication of whether or not the rings were mapped
+         *      is returned.
+         */
+        bool MapRings(const io_uring_params& params) {
+            sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+            cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+            if ((params.features & IORING_FEAT_SINGLE_MMAP) != 0)
+            {
+                sqRingSize = std::max(sqRingSize, cqRingSize);
+                cqRingSize = sqRingSize;
+            }
+            sqRing = mmap(nullptr, sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                          ringFd, IORING_OFF_SQ_RING);
+            if (sqRing == MAP_FAILED)
+            { return false; }
+            if ((params.features & IORING_FEAT_SINGLE_MMAP) != 0)
+            { cqRing = sqRing; } else
+            {
+                cqRing = mmap(nullptr, cqRingSize, PROT_READ | PROT_WRITE,
+                              MAP_SHARED | MAP_POPULATE, ringFd, IORING_OFF_CQ_RING);
+                if (cqRing == MAP_FAILED)
+                { return false; }
+            }
+            sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+            sqes = (io_uring_sqe*)mmap(nullptr, sqesSize, PROT_READ | PROT_WRITE,
+                                       MAP_SHARED | MAP_POPULATE, ringFd, IORING_OFF_SQES);
+            if (sqes == MAP_FAILED)
+            { return false; }
+            sqHead = RingField<unsigned>(sqRing, params.sq_off.head);
+            sqTail = RingField<unsigned>(sqRing, params.sq_off.tail);
+            sqMask = RingField<unsigned>(sqRing, params.sq_off.ring_mask);
+            sqEntries = RingField<unsigned>(sqRing, params.sq_off.ring_entries);
+            sqFlags = RingField<unsigned>(sqRing, params.sq_off.flags);
+            sqArray = RingField<unsigned>(sqRing, params.sq_off.array);
+            cqHead = RingField<unsigned>(cqRing, params.cq_off.head);
+            cqTail = RingField<unsigned>(cqRing, params.cq_off.tail);
+            cqMask = RingField<unsigned>(cqRing, params.cq_off.ring_mask);
+            cqes = RingField<io_uring_cqe>(cqRing, params.cq_off.cqes);
+            return true;
+        }
+
+        /**
+         * This method sets up and registers the provided buffer ring.
+         *
+         * @return
+         *      An indication of whether or not the buffer ring
+         *      was registered is returned.
+         */
+        bool RegisterBufferRing() {
+            bufferRingSize = RECEIVE_BUFFER_COUNT * sizeof(io_uring_buf);
+            bufferRing = (io_uring_buf*)mmap(nullptr, bufferRingSize, PROT_READ | PROT_WRITE,
+                                             MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (bufferRing == MAP_FAILED)
+            { return false; }
+            io_uring_buf_reg registration;
+            (void)memset(&registration, 0, sizeof(registration));
+            registration.ring_addr = (uint64_t)(uintptr_t)bufferRing;
+            registration.ring_entries = RECEIVE_BUFFER_COUNT;
+            registration.bgid = RECEIVE_BUFFER_GROUP;
+            if (RegisterWithRing(ringFd, IORING_REGISTER_PBUF_RING, &registration, 1) != 0)
+            { return false; }
+            buffers.resize(RECEIVE_BUFFER_COUNT);
+            for (unsigned i = 0; i < RECEIVE_BUFFER_COUNT; ++i)
+            {
+                buffers[i].resize(RECEIVE_BUFFER_SIZE);
+                RecycleBuffer((uint16_t)i);
+            }
+            return true;
+        }
+
+        /**
+         * This method hands the given provided buffer back to the kernel.
+         * Only the completion thread calls it once the ring is set up.
+         *
+         * @param[in] bufferId
+         *      This identifies the buffer to hand back.
+         */
+        void RecycleBuffer(uint16_t bufferId) {
+            auto& buffer = buffers[bufferId];
+            if (buffer.size() != RECEIVE_BUFFER_SIZE)
+            { buffer.resize(RECEIVE_BUFFER_SIZE); }
+            auto& entry = bufferRing[bufferRingTail & (RECEIVE_BUFFER_COUNT - 1)];
+            entry.addr = (uint64_t)(uintptr_t)buffer.data();
+            entry.len = (uint32_t)RECEIVE_BUFFER_SIZE;
+            entry.bid = bufferId;
+            ++bufferRingTail;
+            __atomic_store_n(&bufferRing[0].resv, bufferRingTail, __ATOMIC_RELEASE);
+        }
+
+        /**
+         * This method adds the given entry to the submission queue and,
+         * unless the kernel is polling the queue while awake, arranges
+         * for the completion thread to submit it.
+         *
+         * Entries are submitted by the completion thread with the same
+         * system call with which it waits for more completions.  Entries
+         * added from the completion thread itself, such as rearmed
+         * receives and sends following completed ones, are simply left
+         * for it.  Entries added from other threads signal the wake-up
+         * event, but only the first one of each burst does, so that a
+         * burst of sends costs one system call rather than one each.
+         *
+         * @param[in] entry
+         *      This is the submission queue entry to submit.
+         */
+        void Submit(const io_uring_sqe& entry) {
+            std::lock_guard<decltype(submissionMutex)> lock(submissionMutex);
+            unsigned tail = *sqTail;
+            while (tail - __atomic_load_n(sqHead, __ATOMIC_ACQUIRE) >= *sqEntries)
+            {
+                if (submissionPolling)
+                { (void)Enter(ringFd, 0, 0, IORING_ENTER_SQ_WAIT); } else
+                { (void)Enter(ringFd, CountUnsubmitted(), 0, 0); }
+            }
+            const auto index = tail & *sqMask;
+            sqes[index] = entry;
+            sqArray[index] = index;
+            __atomic_store_n(sqTail, tail + 1, __ATOMIC_RELEASE);
+            if (submissionPolling)
+            {
+                __atomic_thread_fence(__ATOMIC_SEQ_CST);
+                if ((__atomic_load_n(sqFlags, __ATOMIC_RELAXED) & IORING_SQ_NEED_WAKEUP) != 0)
+                { (void)Enter(ringFd, 0, 0, IORING_ENTER_SQ_WAKEUP); }
+                return;
+            }
+            if ((currentCompletionThreadRing == this) || wakePending)
+            { return; }
+            wakePending = true;
+            const uint64_t increment = 1;
+            (void)write(wakeFd, &increment, sizeof(increment));
+        }
+
+        /**
+         * This method adds a multishot poll of the wake-up event
+         * to the submission queue.
+         */
+        void ArmWakePoll() {
+            io_uring_sqe entry;
+            (void)memset(&entry, 0, sizeof(entry));
+            entry.opcode = IORING_OP_POLL_ADD;
+            entry.fd = wakeFd;
+            entry.poll32_events = POLLIN;
+            entry.len = IORING_POLL_ADD_MULTI;
+            entry.user_data = (WAKE_POLL_ID << OPERATION_BITS) | OPERATION_WAKE;
+            Submit(entry);
+        }
+
+        /**
+         * This method is called from the completion thread whenever
+         * the wake-up event has been signaled.  It resets the event so
+         * that the next burst of submissions signals it again.  The
+         * entries added so far are submitted by the completion thread
+         * once it is done dispatching completions.
+         *
+         * @param[in] completion
+         *      This is the completion of the poll of the wake-up event.
+         */
+        void OnWake(const io_uring_cqe& completion) {
+            uint64_t count;
+            (void)read(wakeFd, &count, sizeof(count));
+            {
+                std::lock_guard<decltype(submissionMutex)> lock(submissionMutex);
+                wakePending = false;
+            }
+            if ((completion.flags & IORING_CQE_F_MORE) == 0)
+            { ArmWakePoll(); }
+        }
+
+        /**
+         * This method returns the number of entries added to the
+         * submission queue which the kernel hasn't consumed yet.
+         *
+         * @return
+         *      The number of entries not yet submitted is returned.
+         */
+        unsigned CountUnsubmitted() const {
+            return __atomic_load_n(sqTail, __ATOMIC_ACQUIRE) -
+                   __atomic_load_n(sqHead, __ATOMIC_ACQUIRE);
+        }
+
+        /**
+         * This method dispatches the given completion to its handler.
+         *
+         * @param[in] completion
+         *      This is the completion to dispatch.
+         */
+        void Dispatch(const io_uring_cqe& completion) {
+            const auto operation = completion.user_data & ((1 << OPERATION_BITS) - 1);
+            const auto id = completion.user_data >> OPERATION_BITS;
+            if (operation == OPERATION_WAKE)
+            {
+                if (id == WAKE_POLL_ID)
+                { OnWake(completion); }
+                std::vector<std::function<void()>> readyTasks;
+                {
+                    std::lock_guard<decltype(mutex)> lock(mutex);
+                    readyTasks.swap(tasks);
+                }
+                for (const auto& task : readyTasks)
+                { task(); }
+                return;
+            }
+            std::shared_ptr<Handler> handler;
+            {
+                std::lock_guard<decltype(mutex)> lock(mutex);
+                const auto entry = handlers.find(id);
+                if (entry != handlers.end())
+                { handler = entry->second; }
+            }
+            if (operation == OPERATION_RECEIVE)
+            {
+                std::vector<uint8_t> noBuffer;
+                const bool hasBuffer = ((completion.flags & IORING_CQE_F_BUFFER) != 0);
+                const auto bufferId = (uint16_t)(completion.flags >> IORING_CQE_BUFFER_SHIFT);
+                auto& buffer = (hasBuffer ? buffers[bufferId] : noBuffer);
+                if ((handler != nullptr) && (handler->received != nullptr))
+                {
+                    handler->received(buffer, completion.res,
+                                      ((completion.flags & IORING_CQE_F_MORE) != 0));
+                }
+                if (hasBuffer)
+                { RecycleBuffer(bufferId); }
+            } else if (operation == OPERATION_SEND)
+            {
+                if ((handler != nullptr) && (handler->sent != nullptr))
+                { handler->sent(completion.res); }
+            } else if (operation == OPERATION_CONNECT)
+            {
+                if ((handler != nullptr) && (handler->connected != nullptr))
+                { handler->connected(completion.res); }
+            }
+        }
+
+        /**
+         * This is the body of the completion thread.
+         */
+        void Run() {
+            currentCompletionThreadRing = this;
+            while (!stop)
+            {
+                const auto head = *cqHead;
+                if (head == __atomic_load_n(cqTail, __ATOMIC_ACQUIRE))
+                {
+                    (void)Enter(ringFd, (submissionPolling ? 0 : CountUnsubmitted()), 1,
+                                IORING_ENTER_GETEVENTS);
+                    continue;
+                }
+                const auto completion = cqes[head & *cqMask];
+                __atomic_store_n(cqHead, head + 1, __ATOMIC_RELEASE);
+                Dispatch(completion);
+            }
+        }
+    };
+
+    IoUring::~IoUring() noexcept {
+        if (!impl_->completionThread.joinable())
+        { return; }
+        impl_->stop = true;
+        Post(nullptr);
+        if (impl_->completionThread.get_id() == std::this_thread::get_id())
+        { impl_->completionThread.detach(); } else
+        { impl_->completionThread.join(); }
+    }
+
+    IoUring::IoUring() : impl_(std::make_shared<Impl>()) {}
+
+    std::shared_ptr<IoUring> IoUring::Create(unsigned queueDepth, bool submissionPolling,
+                                             std::string& error) {
+        std::shared_ptr<IoUring> ring(new IoUring());
+        const auto impl = ring->impl_;
+        io_uring_params params;
+        (void)memset(&params, 0, sizeof(params));
+        if (submissionPolling)
+        {
+            params.flags |= IORING_SETUP_SQPOLL;
+            params.sq_thread_idle = SUBMISSION_POLLING_IDLE_MILLISECONDS;
+        }
+        impl->ringFd = SetUp(queueDepth, &params);
+        if ((impl->ringFd < 0) && submissionPolling)
+        {
+            (void)memset(&params, 0, sizeof(params));
+            impl->ringFd = SetUp(queueDepth, &params);
+        }
+        if (impl->ringFd < 0)
+        {
+            error = std::string("io_uring_setup failed (") + strerror(errno) + ")";
+            return nullptr;
+        }
+        impl->submissionPolling = ((params.flags & IORING_SETUP_SQPOLL) != 0);
+        impl->wakeFd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+        if (impl->wakeFd < 0)
+        {
+            error = std::string("unable to create wake-up event (") + strerror(errno) + ")";
+            return nullptr;
+        }
+        if (!impl->MapRings(params))
+        {
+            error = std::string("unable to map io_uring rings (") + strerror(errno) + ")";
+            return nullptr;
+        }
+        if (!impl->RegisterBufferRing())
+        {
+            error = std::string("unable to register provided buffer ring (") + strerror(errno) +
+                    ")";
+            return nullptr;
+        }
+        if (!impl->submissionPolling)
+        { impl->ArmWakePoll(); }
+        impl->completionThread = std::thread([impl] { impl->Run(); });
+        return ring;
+    }
+
+    uint64_t IoUring::Register(std::shared_ptr<Handler> handler) {
+        std::lock_guard<decltype(impl_->mutex)> lock(impl_->mutex);
+        const auto id = impl_->nextId++;
+        impl_->handlers[id] = handler;
+        return id;
+    }
+
+    void IoUring::Unregister(uint64_t id) {
+        std::lock_guard<decltype(impl_->mutex)> lock(impl_->mutex);
+        (void)impl_->handlers.erase(id);
+    }
+
+    void IoUring::SubmitReceive(int fd, uint64_t id) {
+        io_uring_sqe entry;
+        (void)memset(&entry, 0, sizeof(entry));
+        entry.opcode = IORING_OP_RECV;
+        entry.fd = fd;
+        entry.ioprio = IORING_RECV_MULTISHOT;
+        entry.flags = IOSQE_BUFFER_SELECT;
+        entry.buf_group = RECEIVE_BUFFER_GROUP;
+        entry.user_data = (id << OPERATION_BITS) | OPERATION_RECEIVE;
+        impl_->Submit(entry);
+    }
+
+    void IoUring::SubmitSendMessage(int fd, const struct msghdr* message, uint64_t id) {
+        io_uring_sqe entry;
+        (void)memset(&entry, 0, sizeof(entry));
+        entry.opcode = IORING_OP_SENDMSG;
+        entry.fd = fd;
+        entry.addr = (uint64_t)(uintptr_t)message;
+        entry.len = 1;
+        entry.msg_flags = MSG_NOSIGNAL;
+        entry.user_data = (id << OPERATION_BITS) | OPERATION_SEND;
+        impl_->Submit(entry);
+    }
+
+    void IoUring::SubmitConnect(int fd, const struct sockaddr* address, uint32_t addressLength,
+                                uint64_t id) {
+        io_uring_sqe entry;
+        (void)memset(&entry, 0, sizeof(entry));
+        entry.opcode = IORING_OP_CONNECT;
+        entry.fd = fd;
+        entry.addr = (uint64_t)(uintptr_t)address;
+        entry.off = addressLength;
+        entry.user_data = (id << OPERATION_BITS) | OPERATION_CONNECT;
+        impl_->Submit(entry);
+    }
+
+    void IoUring::CancelConnect(uint64_t id) {
+        io_uring_sqe entry;
+        (void)memset(&entry, 0, sizeof(entry));
+        entry.opcode = IORING_OP_ASYNC_CANCEL;
+        entry.addr = (id << OPERATION_BITS) | OPERATION_CONNECT;
+        entry.user_data = OPERATION_WAKE;
+        impl_->Submit(entry);
+    }
+
+    void IoUring::Post(std::function<void()> task) {
+        if (task != nullptr)
+        {
+            std::lock_guard<decltype(impl_->mutex)> lock(impl_->mutex);
+            impl_->tasks.push_back(std::move(task));
+        }
+        io_uring_sqe entry;
+        (void)memset(&entry, 0, sizeof(entry));
+        entry.opcode = IORING_OP_NOP;
+        entry.user_data = OPERATION_WAKE;
+        impl_->Submit(entry);
+    }
+}  // namespace MqttNetworkTransport
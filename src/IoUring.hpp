@@ -0,0 +1,213 @@
+#ifndef MQTT_NETWORK_TRANSPORT_IO_URING_HPP
+#define MQTT_NETWORK_TRANSPORT_IO_URING_HPP
+/**
+ * @file IoUring.hpp
+ *
+ * This module declares the MqttNetworkTransport::IoUring class.
+ *
+ * © 2025 by Hatem Nabli
+ */
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+#include <stddef.h>
+#include <stdint.h>
+
+struct msghdr;
+struct sockaddr;
+
+namespace MqttNetworkTransport
+{
+    /**
+     * This is an io_uring instance shared by many sockets, with a
+     * registered ring of provided buffers used by multishot receives,
+     * and a thread which reaps completions and dispatches them.
+     */
+    class IoUring
+    {
+    public:
+        /**
+         * This holds the functions to call from the completion thread
+         * whenever an operation submitted for a socket completes.
+         */
+        struct Handler
+        {
+            /**
+             * This is called whenever a receive completes.
+             *
+             * @param[in,out] buffer
+             *      This is the provided buffer holding the received
+             *      data at its start, or an empty buffer if there is
+             *      no data.  The function may swap it for another buffer
+             *      of the same size, which takes its place in the buffer
+             *      ring, to keep the data without copying it.
+             * @param[in] result
+             *      This is the number of bytes received, zero if the
+             *      peer closed the connection, or a negated errno value.
+             * @param[in] armed
+             *      This indicates whether or not the multishot receive
+             *      is still armed.  If not, it must be submitted again
+             *      to receive more data.
+             */
+            std::function<void(std::vector<uint8_t>& buffer, int32_t result, bool armed)>
+                received;
+
+            /**
+             * This is called whenever a send completes.
+             *
+             * @param[in] result
+             *      This is the number of bytes sent,
+             *      or a negated errno value.
+             */
+            std::function<void(int32_t result)> sent;
+
+            /**
+             * This is called when a connect completes.
+             *
+             * @param[in] result
+             *      This is zero if the connection was established,
+             *      or a negated errno value.
+             */
+            std::function<void(int32_t result)> connected;
+        };
+
+        // Lifecycle management
+    public:
+        ~IoUring() noexcept;
+        IoUring(const IoUring&) = delete;
+        IoUring(IoUring&&) noexcept = delete;
+        IoUring& operator=(const IoUring&) = delete;
+        IoUring& operator=(IoUring&&) noexcept = delete;
+
+        // Public methods
+    public:
+        /**
+         * This method sets up a new io_uring instance and starts
+         * its completion thread.
+         *
+         * @param[in] queueDepth
+         *      This is the number of submission queue entries.
+         * @param[in] submissionPolling
+         *      This indicates whether or not the kernel should poll the
+         *      submission queue, so that submitting operations requires
+         *      no system call while the poller is awake.
+         * @param[out] error
+         *      This is where to store a description of why the
+         *      instance could not be set up.
+         * @return
+         *      The new instance is returned, or nullptr if io_uring, or
+         *      one of the features it requires, is unavailable.
+         */
+        static std::shared_ptr<IoUring> Create(unsigned queueDepth, bool submissionPolling,
+                                               std::string& error);
+
+        /**
+         * This method registers the handler of a socket's completions.
+         *
+         * @param[in] handler
+         *      This holds the functions to call on completions.
+         * @return
+         *      The identifier to give to submissions for the socket
+         *      is returned.
+         */
+        uint64_t Register(std::shared_ptr<Handler> handler);
+
+        /**
+         * This method stops dispatching completions to the handler
+         * registered with the given identifier.
+         *
+         * @param[in] id
+         *      This is the identifier returned when the handler
+         *      was registered.
+         */
+        void Unregister(uint64_t id);
+
+        /**
+         * This method submits a multishot receive on the given socket,
+         * drawing its buffers from the registered buffer ring.
+         *
+         * @param[in] fd
+         *      This is the socket from which to receive.
+         * @param[in] id
+         *      This identifies the handler to call on completion.
+         */
+        void SubmitReceive(int fd, uint64_t id);
+
+        /**
+         * This method submits a gathering send on the given socket.
+         *
+         * @param[in] fd
+         *      This is the socket on which to send.
+         * @param[in] message
+         *      This describes the data to send.  It, and the data it
+         *      refers to, must remain valid until the send completes.
+         * @param[in] id
+         *      This identifies the handler to call on completion.
+         */
+        void SubmitSendMessage(int fd, const struct msghdr* message, uint64_t id);
+
+        /**
+         * This method submits a connect of the given socket, whose
+         * completion is reported to the given handler.
+         *
+         * @param[in] fd
+         *      This is the socket to connect.
+         * @param[in] address
+         *      This is the address of the peer.  It must remain valid
+         *      until the connect completes.
+         * @param[in] addressLength
+         *      This is the size of the address of the peer.
+         * @param[in] id
+         *      This identifies the handler to call.
+         */
+        void SubmitConnect(int fd, const struct sockaddr* address, uint32_t addressLength,
+                           uint64_t id);
+
+        /**
+         * This method asks for the connect submitted for the given handler,
+         * if it is still in flight, to be cancelled.  The connect then
+         * completes with -ECANCELED.
+         *
+         * @param[in] id
+         *      This identifies the handler of the connect to cancel.
+         */
+        void CancelConnect(uint64_t id);
+
+        /**
+         * This method queues the given function to be called from
+         * the completion thread.
+         *
+         * @param[in] task
+         *      This is the function to call.
+         */
+        void Post(std::function<void()> task);
+
+        // Private methods
+    private:
+        /**
+         * This is the default constructor.  Instances
+         * are made by the Create method.
+         */
+        IoUring();
+
+        // Private properties
+    private:
+        /**
+         * This is the type of structure that contains the private
+         * properties of the instance.  It is defined in the implementation
+         * and declared here to ensure that it is scoped inside the class.
+         */
+        struct Impl;
+
+        /**
+         * This contains the private properties of the instance.  It is
+         * shared with the completion thread, so that the instance may
+         * be released from within a completion.
+         */
+        std::shared_ptr<Impl> impl_;
+    };
+}  // namespace MqttNetworkTransport
+
+#endif /** MQTT_NETWORK_TRANSPORT_IO_URING_HPP */
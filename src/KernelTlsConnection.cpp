@@ -0,0 +1,46 @@
+/**
+ * @file KernelTlsConnection.cpp
+ *
+ * This module implements the helpers of the
+ * MqttNetworkTransport::KernelTlsConnection interface.
+ *
+ * © 2025 by Hatem Nabli
+ */
+
+#include "KernelTlsConnection.hpp"
+#include <errno.h>
+#include <string.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <linux/tls.h>
+
+#ifndef SOL_TLS
+#    define SOL_TLS 282
+#endif
+
+#ifndef TCP_ULP
+#    define TCP_ULP 31
+#endif
+
+namespace MqttNetworkTransport
+{
+    bool KernelTlsConnection::EnableTransmit(int sock, const std::vector<uint8_t>& cryptoInfo,
+                                             std::string& error) {
+        static const char ulp[] = "tls";
+        if (setsockopt(sock, SOL_TCP, TCP_ULP, ulp, sizeof(ulp)) != 0)
+        {
+            error = ((errno == ENOENT) ? std::string("kernel TLS module not loaded")
+                                       : std::string("error attaching kernel TLS (") +
+                                             strerror(errno) + ")");
+            return false;
+        }
+        if (setsockopt(sock, SOL_TLS, TLS_TX, cryptoInfo.data(), (socklen_t)cryptoInfo.size()) !=
+            0)
+        {
+            error = std::string("error setting kernel TLS keys (") + strerror(errno) + ")";
+            return false;
+        }
+        return true;
+    }
+}  // namespace MqttNetworkTransport
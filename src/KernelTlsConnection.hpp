@@ -0,0 +1,70 @@
+#ifndef MQTT_NETWORK_TRANSPORT_KERNEL_TLS_CONNECTION_HPP
+#define MQTT_NETWORK_TRANSPORT_KERNEL_TLS_CONNECTION_HPP
+/**
+ * @file KernelTlsConnection.hpp
+ *
+ * This module declares the MqttNetworkTransport::KernelTlsConnection
+ * interface.
+ *
+ * © 2025 by Hatem Nabli
+ */
+
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+namespace MqttNetworkTransport
+{
+    /**
+     * This is implemented by socket-based network connections which can
+     * hand the encryption of the TLS records they send to the kernel
+     * (Linux kernel TLS), so that messages sent afterwards are written
+     * to the socket as plaintext, and encrypted by the kernel.
+     */
+    class KernelTlsConnection
+    {
+    public:
+        virtual ~KernelTlsConnection() = default;
+
+        /**
+         * This method hands the encryption of everything sent from now
+         * on to the kernel.  This is only possible while nothing is
+         * waiting to be written to the socket, since anything queued
+         * before is already encrypted.
+         *
+         * @param[in] cryptoInfo
+         *      This is the kernel's description of the cipher, keys and
+         *      record sequence number with which to encrypt
+         *      (a struct tls12_crypto_info_* from linux/tls.h).
+         * @return
+         *      An indication of whether or not the kernel is now
+         *      encrypting what is sent is returned.  If not, the
+         *      connection is unchanged.
+         */
+        virtual bool OffloadTlsTransmit(const std::vector<uint8_t>& cryptoInfo) = 0;
+
+        // Protected methods
+    protected:
+        /**
+         * This function attaches the kernel's TLS layer to the given
+         * socket and gives it the keys with which to encrypt what is
+         * sent on it.
+         *
+         * @param[in] sock
+         *      This is the connected TCP socket.
+         * @param[in] cryptoInfo
+         *      This is the kernel's description of the cipher, keys and
+         *      record sequence number with which to encrypt.
+         * @param[out] error
+         *      This is where to store a description of what went wrong,
+         *      if the kernel could not take over the encryption.
+         * @return
+         *      An indication of whether or not the kernel is now
+         *      encrypting what is sent on the socket is returned.
+         */
+        static bool EnableTransmit(int sock, const std::vector<uint8_t>& cryptoInfo,
+                                   std::string& error);
+    };
+}  // namespace MqttNetworkTransport
+
+#endif /** MQTT_NETWORK_TRANSPORT_KERNEL_TLS_CONNECTION_HPP */
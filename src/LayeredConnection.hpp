@@ -0,0 +1,39 @@
+#ifndef MQTT_NETWORK_TRANSPORT_LAYERED_CONNECTION_HPP
+#define MQTT_NETWORK_TRANSPORT_LAYERED_CONNECTION_HPP
+/**
+ * @file LayeredConnection.hpp
+ *
+ * This module declares the MqttNetworkTransport::LayeredConnection
+ * interface.
+ *
+ * © 2025 by Hatem Nabli
+ */
+
+#include <memory>
+#include <SystemUtils/INetworkConnection.hpp>
+
+namespace MqttNetworkTransport
+{
+    /**
+     * This is implemented by network connections which carry their data
+     * over another network connection, such as the TLS and WebSocket
+     * connections, so that settings of the underlying connection, such
+     * as the address of the peer, can be reached through them.
+     */
+    class LayeredConnection
+    {
+    public:
+        virtual ~LayeredConnection() = default;
+
+        /**
+         * This method returns the connection which carries the
+         * data of this one.
+         *
+         * @return
+         *      The inner connection is returned.
+         */
+        virtual std::shared_ptr<SystemUtils::INetworkConnection> GetInnerConnection() const = 0;
+    };
+}  // namespace MqttNetworkTransport
+
+#endif /** MQTT_NETWORK_TRANSPORT_LAYERED_CONNECTION_HPP */
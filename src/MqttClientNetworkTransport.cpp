@@ -8,31 +8,344 @@
  */
 
 #include "MqttNetworkTransport/MqttClientNetworkTransport.hpp"
+#include "MqttNetworkTransport/ZeroCopyConnection.hpp"
+#include "AsyncNetworkConnection.hpp"
+#include "ConnectionRace.hpp"
+#include "FastOpenConnection.hpp"
+#include "GatherNetworkConnection.hpp"
+#include "HostResolver.hpp"
+#include "InProcessNetworkConnection.hpp"
+#include "LayeredConnection.hpp"
+#include "OutgoingMessage.hpp"
+#include "PacketFramer.hpp"
+#include "ReceiveBufferPool.hpp"
+#include "ReconnectGovernor.hpp"
+#include "ResumingConnection.hpp"
+#include "TimerQueue.hpp"
+#include "WebSocketNetworkConnection.hpp"
+#include "WorkerPool.hpp"
+#include "WriteCoalescer.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <map>
+#include <memory>
 #include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if defined(__linux__)
+#    include "EventLoopPool.hpp"
+#    include "IoUring.hpp"
+#    include <netdb.h>
+#    include <netinet/in.h>
+#    include <string.h>
+#    include "ReactorNetworkConnection.hpp"
+#    include "SharedMemoryNetworkConnection.hpp"
+#    include "SocketAddressConnection.hpp"
+#    include "UringNetworkConnection.hpp"
+#endif /* __linux__ */
+
+#if defined(MQTT_NETWORK_TRANSPORT_TLS)
+#    include "TlsContext.hpp"
+#    include "TlsNetworkConnection.hpp"
+#endif /* MQTT_NETWORK_TRANSPORT_TLS */
 
 namespace
 {
+    /**
+     * These are the types of MQTT control packets which are
+     * written without being held back for coalescing.
+     */
+    constexpr uint8_t PACKET_TYPE_CONNECT = 1;
+    constexpr uint8_t PACKET_TYPE_PINGREQ = 12;
+    constexpr uint8_t PACKET_TYPE_DISCONNECT = 14;
+    constexpr uint8_t PACKET_TYPE_AUTH = 15;
+
+    /**
+     * This is the number of threads the transport uses
+     * to look up the addresses of hosts.
+     */
+    constexpr size_t RESOLVER_WORKER_COUNT = 2;
+
+    /**
+     * This is the number of threads the transport uses to deliver
+     * the messages received by "inproc" connections.
+     */
+    constexpr size_t IN_PROCESS_WORKER_COUNT = 2;
+
+    /**
+     * This is the scheme of targets reached over Unix domain sockets,
+     * whose host is the path of the socket.
+     */
+    const std::string UNIX_SCHEME = "unix";
+
+    /**
+     * This is the scheme of targets reached through rings in memory
+     * shared with the broker, set up over the Unix domain socket
+     * whose path is the host.
+     */
+    const std::string SHM_SCHEME = "shm";
+
+    /**
+     * This is the scheme of targets in this process, whose host
+     * is the name under which they listen.
+     */
+    const std::string INPROC_SCHEME = "inproc";
+
+    /**
+     * This holds the counters of the transport, which outlive it
+     * as long as any of its connections do.
+     */
+    struct TransportCounters
+    {
+        std::atomic<uint64_t> coalescedPackets{0};
+        std::atomic<uint64_t> coalescedWrites{0};
+        std::atomic<uint64_t> connectionsResumed{0};
+        std::atomic<uint64_t> connectionResumeFailures{0};
+    };
+
+    /**
+     * This function determines whether or not targets with the given
+     * scheme are on this host, named by the path of a Unix domain
+     * socket or by the name of an in-process endpoint, rather than
+     * by a host name or address.
+     *
+     * @param[in] scheme
+     *      This is the scheme indicated in the URI of the target.
+     * @return
+     *      An indication of whether or not the target
+     *      is local is returned.
+     */
+    bool IsLocalScheme(const std::string& scheme) {
+        return ((scheme == UNIX_SCHEME) || (scheme == SHM_SCHEME) || (scheme == INPROC_SCHEME));
+    }
+
+    /**
+     * This function returns the string which identifies a connection
+     * to the given target in diagnostic messages.
+     *
+     * @param[in] scheme
+     *      This is the scheme indicated in the URI of the target.
+     * @param[in] hostNameOrAddress
+     *      This is the name or address of the host of the target,
+     *      the path of its socket for the "unix" and "shm" schemes, or
+     *      its name for the "inproc" scheme.
+     * @param[in] port
+     *      This is the port number of the target.
+     * @return
+     *      The string which identifies the connection is returned.
+     */
+    std::string FormatPeerId(const std::string& scheme, const std::string& hostNameOrAddress,
+                             uint16_t port) {
+        if (IsLocalScheme(scheme))
+        { return hostNameOrAddress; }
+        if (hostNameOrAddress.find(':') != std::string::npos)
+        { return StringUtils::sprintf("[%s]:%" PRIu16, hostNameOrAddress.c_str(), port); }
+        return StringUtils::sprintf("%s:%" PRIu16, hostNameOrAddress.c_str(), port);
+    }
+
+    /**
+     * This function removes the square brackets, if any, around the
+     * given host, as an IPv6 literal is written in a URI.
+     *
+     * @param[in] hostNameOrAddress
+     *      This is the name or address of the host.
+     * @return
+     *      The name or address of the host, without brackets,
+     *      is returned.
+     */
+    std::string StripBrackets(const std::string& hostNameOrAddress) {
+        if ((hostNameOrAddress.length() >= 2) && (hostNameOrAddress.front() == '[') &&
+            (hostNameOrAddress.back() == ']'))
+        { return hostNameOrAddress.substr(1, hostNameOrAddress.length() - 2); }
+        return hostNameOrAddress;
+    }
+
+    /**
+     * This function looks up the addresses of the given host, in the order
+     * in which the system prefers them to be tried (RFC 6724).
+     *
+     * @param[in] host
+     *      This is the name or literal address of the host to look up.
+     * @return
+     *      The addresses of the host are returned, or an empty
+     *      list if none could be found.
+     */
+    MqttNetworkTransport::HostResolver::Addresses LookUpHost(const std::string& host) {
+        MqttNetworkTransport::HostResolver::Addresses addresses;
+#if defined(__linux__)
+        struct addrinfo hints;
+        (void)memset(&hints, 0, sizeof(hints));
+        hints.ai_family = AF_UNSPEC;
+        hints.ai_socktype = SOCK_STREAM;
+        hints.ai_flags = AI_ADDRCONFIG;
+        struct addrinfo* results = nullptr;
+        if (getaddrinfo(host.c_str(), nullptr, &hints, &results) != 0)
+        { return addresses; }
+        for (auto result = results; result != nullptr; result = result->ai_next)
+        {
+            MqttNetworkTransport::HostResolver::Address address;
+            if (result->ai_family == AF_INET)
+            {
+                const auto ipv4 = (const struct sockaddr_in*)result->ai_addr;
+                address = MqttNetworkTransport::HostResolver::Address::FromIpv4(
+                    ntohl(ipv4->sin_addr.s_addr));
+            } else if (result->ai_family == AF_INET6)
+            {
+                const auto ipv6 = (const struct sockaddr_in6*)result->ai_addr;
+                address.ipv6 = true;
+                (void)memcpy(address.bytes, ipv6->sin6_addr.s6_addr, sizeof(address.bytes));
+                address.scopeId = ipv6->sin6_scope_id;
+            } else
+            { continue; }
+            const auto duplicate = std::find_if(
+                addresses.begin(), addresses.end(),
+                [&address](const MqttNetworkTransport::HostResolver::Address& other)
+                {
+                    return ((other.ipv6 == address.ipv6) && (other.scopeId == address.scopeId) &&
+                            (memcmp(other.bytes, address.bytes, sizeof(other.bytes)) == 0));
+                });
+            if (duplicate == addresses.end())
+            { addresses.push_back(address); }
+        }
+        freeaddrinfo(results);
+#else
+        const auto address = SystemUtils::NetworkConnection::GetAddressOfHost(host);
+        if (address != 0)
+        { addresses.push_back(MqttNetworkTransport::HostResolver::Address::FromIpv4(address)); }
+#endif /* __linux__ */
+        return addresses;
+    }
+
+    /**
+     * This function determines whether or not the given outgoing packet
+     * is latency-critical, and so must be written immediately.
+     *
+     * @param[in] packet
+     *      This is the encoded MQTT control packet.
+     * @return
+     *      An indication of whether or not the packet is urgent
+     *      is returned.
+     */
+    bool IsUrgentPacket(const std::vector<uint8_t>& packet) {
+        if (packet.empty())
+        { return true; }
+        const uint8_t type = (packet[0] >> 4);
+        return ((type == PACKET_TYPE_CONNECT) || (type == PACKET_TYPE_PINGREQ) ||
+                (type == PACKET_TYPE_DISCONNECT) || (type == PACKET_TYPE_AUTH));
+    }
+
     struct ConnectionDelegates
     {
         /**
-         * This is used to synchronize access to the delegates.
+         * This is an immutable pairing of the user's delegates. A new
+         * snapshot is published whenever either delegate changes, so
+         * that the receive path never has to lock or copy them.
+         */
+        struct Snapshot
+        {
+            /**
+             * This is the delegate to call whenever data is received
+             * from the remote peer.
+             */
+            MqttV5::Connection::DataReceivedDelegate dataReceivedDelegate;
+
+            /**
+             * This is the delegate to call whenever the connection has
+             * been broken.
+             */
+            MqttV5::Connection::BrokenDelegate brokenDelegate;
+        };
+
+        /**
+         * This is used to serialize the publication of new snapshots
+         * and access to the list of retired ones.  Readers of the
+         * current snapshot don't take it.
+         */
+        std::mutex mutex;
+
+        /**
+         * This is the most recently published snapshot.  Readers load
+         * it with a single atomic load, without locking, allocating or
+         * touching a reference count.
+         */
+        std::atomic<const Snapshot*> current{new Snapshot()};
+
+        /**
+         * These are the snapshots which have been replaced.  A reader may
+         * still be using one of them, so they are kept, along with whatever
+         * their delegates captured, until these delegates are destroyed,
+         * which happens only after the last reader is done with them.
+         * Delegates are set only a few times over the life of a
+         * connection, so this list stays short.
          */
-        std::recursive_mutex mutex;
+        std::vector<std::unique_ptr<const Snapshot>> retired;
+
+        // Lifecycle management
+        ~ConnectionDelegates() noexcept { delete current.load(std::memory_order_relaxed); }
+        ConnectionDelegates() = default;
+        ConnectionDelegates(const ConnectionDelegates&) = delete;
+        ConnectionDelegates(ConnectionDelegates&&) noexcept = delete;
+        ConnectionDelegates& operator=(const ConnectionDelegates&) = delete;
+        ConnectionDelegates& operator=(ConnectionDelegates&&) noexcept = delete;
 
         /**
-         * This is the delegate to call whenever data is received
-         * from the remote peer.
+         * This method returns the currently published snapshot.  It doesn't
+         * lock or allocate.  The snapshot remains valid for as long as
+         * these delegates exist.
+         *
+         * @return
+         *      The current delegates snapshot is returned.
          */
-        MqttV5::Connection::DataReceivedDelegate dataReceivedDelegate;
+        const Snapshot* Load() const { return current.load(std::memory_order_acquire); }
 
         /**
-         * This is the delegate to call whenever the connection has
-         * been broken.
+         * This method publishes the given snapshot in place of the current
+         * one, which is retired.
+         *
+         * The caller must hold the mutex.
+         *
+         * @param[in] next
+         *      This is the snapshot to publish.
          */
-        MqttV5::Connection::BrokenDelegate brokenDelegate;
+        void Publish(std::unique_ptr<Snapshot> next) {
+            retired.emplace_back(current.exchange(next.release(), std::memory_order_acq_rel));
+        }
+
+        /**
+         * This method publishes a new snapshot holding the given delegate,
+         * keeping the other delegate of the current snapshot.
+         *
+         * @param[in] dataReceivedDelegate
+         *      This is the new delegate to call whenever data is received.
+         */
+        void SetDataReceivedDelegate(MqttV5::Connection::DataReceivedDelegate dataReceivedDelegate) {
+            std::lock_guard<decltype(mutex)> lock(mutex);
+            std::unique_ptr<Snapshot> next(new Snapshot(*Load()));
+            next->dataReceivedDelegate = std::move(dataReceivedDelegate);
+            Publish(std::move(next));
+        }
+
+        /**
+         * This method publishes a new snapshot holding the given delegate,
+         * keeping the other delegate of the current snapshot.
+         *
+         * @param[in] brokenDelegate
+         *      This is the new delegate to call whenever the connection
+         *      has been broken.
+         */
+        void SetBrokenDelegate(MqttV5::Connection::BrokenDelegate brokenDelegate) {
+            std::lock_guard<decltype(mutex)> lock(mutex);
+            std::unique_ptr<Snapshot> next(new Snapshot(*Load()));
+            next->brokenDelegate = std::move(brokenDelegate);
+            Publish(std::move(next));
+        }
     };
 
-    struct ConnectionAdapter : public MqttV5::Connection
+    struct ConnectionAdapter : public MqttNetworkTransport::ZeroCopyConnection
     {
         /**
          * This is the object wish implementing the network connection
@@ -40,6 +353,39 @@ namespace
          */
         std::shared_ptr<SystemUtils::INetworkConnection> networkConnectionadaptee;
 
+        /**
+         * If the network connection takes ownership of the messages it
+         * sends, this is the same object as networkConnectionadaptee.
+         */
+        std::shared_ptr<MqttNetworkTransport::GatherNetworkConnection> gatherConnection;
+
+        /**
+         * If the network connection can establish itself without blocking,
+         * this is the same object as networkConnectionadaptee.
+         */
+        std::shared_ptr<MqttNetworkTransport::AsyncNetworkConnection> asyncConnection;
+
+        /**
+         * If the network connection can be established with TCP Fast Open,
+         * this is the same object as networkConnectionadaptee.
+         */
+        std::shared_ptr<MqttNetworkTransport::FastOpenConnection> fastOpenConnection;
+
+        /**
+         * If the network connection is paired with an endpoint in this
+         * process, this is the same object as networkConnectionadaptee.
+         */
+        std::shared_ptr<MqttNetworkTransport::InProcessNetworkConnection> inProcessConnection;
+
+#if defined(__linux__)
+        /**
+         * If the network connection, or the connection which ultimately
+         * carries its data, can connect to peers other than IPv4 ones,
+         * this is that connection.
+         */
+        std::shared_ptr<MqttNetworkTransport::SocketAddressConnection> socketAddressConnection;
+#endif /* __linux__ */
+
         /**
          * This holds onto the user's delegate and makes their setting
          * and usage thread-safe.
@@ -47,11 +393,58 @@ namespace
         std::shared_ptr<ConnectionDelegates> connectionDelegates =
             std::make_shared<ConnectionDelegates>();
 
+        /**
+         * If write coalescing is enabled, this gathers outgoing packets
+         * submitted within a short window into single writes.
+         */
+        std::shared_ptr<MqttNetworkTransport::WriteCoalescer> writeCoalescer;
+
+        /**
+         * If received data is framed into whole packets,
+         * this is what frames it.
+         */
+        std::shared_ptr<MqttNetworkTransport::PacketFramer> framer;
+
+        /**
+         * This is used to report the coalescing ratio of the connection,
+         * and the use of the receive buffer pool, once it is released.
+         */
+        std::shared_ptr<SystemUtils::DiagnosticsSender> diagnosticsSender;
+
+        /**
+         * This identifies the connection in diagnostic messages.
+         */
+        std::string peerId;
+
+        ~ConnectionAdapter() noexcept {
+            if (writeCoalescer == nullptr)
+            { return; }
+            writeCoalescer->Flush();
+            const auto statistics = writeCoalescer->GetStatistics();
+            if (statistics.writes > 0)
+            {
+                diagnosticsSender->SendDiagnosticInformationFormatted(
+                    1, "%s: coalesced %" PRIu64 " packets into %" PRIu64 " writes (ratio %.2f)",
+                    peerId.c_str(), statistics.packets, statistics.writes,
+                    (double)statistics.packets / (double)statistics.writes);
+            }
+        }
+
         // Mqtt::Connection Methods
 
         virtual std::string GetPeerId() override {
+            if (inProcessConnection != nullptr)
+            { return inProcessConnection->GetName(); }
+#if defined(__linux__)
+            if (socketAddressConnection != nullptr)
+            {
+                const auto address = socketAddressConnection->GetPeerSocketAddress();
+                if (!address.IsEmpty())
+                { return address.ToString(); }
+            }
+#endif /* __linux__ */
             return StringUtils::sprintf(
-                "%" PRIu8 ".%" PRIu8 ".%" PRIu8 ":%" PRIu16,
+                "%" PRIu8 ".%" PRIu8 ".%" PRIu8 ".%" PRIu8 ":%" PRIu16,
                 (uint8_t)((networkConnectionadaptee->GetPeerAddress() >> 24) & 0xFF),
                 (uint8_t)((networkConnectionadaptee->GetPeerAddress() >> 16) & 0xFF),
                 (uint8_t)((networkConnectionadaptee->GetPeerAddress() >> 8) & 0xFF),
@@ -61,26 +454,545 @@ namespace
 
         virtual void SetDataReceivedDelegate(
             DataReceivedDelegate newDataReceivedDelegate) override {
-            std::lock_guard<decltype(connectionDelegates->mutex)> lock(connectionDelegates->mutex);
-            connectionDelegates->dataReceivedDelegate = newDataReceivedDelegate;
+            connectionDelegates->SetDataReceivedDelegate(newDataReceivedDelegate);
         }
 
         virtual void SetConnectionBrokenDelegate(BrokenDelegate brokenDelegate) override {
-            std::lock_guard<decltype(connectionDelegates->mutex)> lock(connectionDelegates->mutex);
-            connectionDelegates->brokenDelegate = brokenDelegate;
+            connectionDelegates->SetBrokenDelegate(brokenDelegate);
         }
 
         virtual void SendData(const std::vector<uint8_t>& data) override {
-            networkConnectionadaptee->SendMessage(data);
+            if ((writeCoalescer == nullptr) && (gatherConnection == nullptr))
+            { networkConnectionadaptee->SendMessage(data); } else
+            { Send(MqttNetworkTransport::OutgoingMessage(std::vector<uint8_t>(data))); }
+        }
+
+        // MqttNetworkTransport::ZeroCopyConnection Methods
+
+        virtual void SendData(std::vector<uint8_t>&& data) override {
+            Send(MqttNetworkTransport::OutgoingMessage(std::move(data)));
+        }
+
+        virtual void SendData(SharedBuffer data) override {
+            if (data == nullptr)
+            { return; }
+            Send(MqttNetworkTransport::OutgoingMessage(std::move(data)));
+        }
+
+        virtual ConnectionStatistics GetConnectionStatistics() override {
+            ConnectionStatistics statistics;
+            if (fastOpenConnection != nullptr)
+            { statistics.fastOpenUsed = fastOpenConnection->UsedFastOpen(); }
+            return statistics;
+        }
+
+        virtual void Break(const bool clean) override {
+            if (writeCoalescer != nullptr)
+            { writeCoalescer->Flush(); }
+            networkConnectionadaptee->Close(clean);
+        }
+
+        /**
+         * This method hands the given message to the write coalescer, if
+         * any, or else to the network connection, without copying it
+         * unless the network connection can only borrow messages.
+         *
+         * @param[in] message
+         *      This is the message to send.
+         */
+        void Send(MqttNetworkTransport::OutgoingMessage&& message) {
+            if (writeCoalescer != nullptr)
+            {
+                const bool urgent = IsUrgentPacket(message.Bytes());
+                writeCoalescer->Submit(std::move(message), urgent);
+            } else if (gatherConnection != nullptr)
+            { gatherConnection->SendMessage(std::move(message)); } else
+            { networkConnectionadaptee->SendMessage(message.Bytes()); }
+        }
+
+        /**
+         * This method starts processing the established network
+         * connection, delivering received data and breakage to
+         * the given delegates.
+         *
+         * @param[in] dataReceivedDelegate
+         *      This is the function to call to deliver received data.
+         * @param[in] brokenDelegate
+         *      This is the function to call once the connection is broken.
+         * @return
+         *      An indication of whether or not processing
+         *      was started is returned.
+         */
+        bool Start(MqttV5::Connection::DataReceivedDelegate dataReceivedDelegate,
+                   MqttV5::Connection::BrokenDelegate brokenDelegate) {
+            connectionDelegates->SetDataReceivedDelegate(dataReceivedDelegate);
+            connectionDelegates->SetBrokenDelegate(brokenDelegate);
+            const auto delegatesCopy = connectionDelegates;
+            const auto framerCopy = framer;
+            const auto diagnosticsSenderCopy = diagnosticsSender;
+            const auto peerIdCopy = peerId;
+            std::weak_ptr<SystemUtils::INetworkConnection> connectionWeak(
+                networkConnectionadaptee);
+            if (!networkConnectionadaptee->Process(
+                    [delegatesCopy, framerCopy, connectionWeak, diagnosticsSenderCopy,
+                     peerIdCopy](const std::vector<uint8_t>& message)
+                    {
+                        const auto delegates = delegatesCopy->Load();
+                        if (delegates->dataReceivedDelegate == nullptr)
+                        { return; }
+                        if (framerCopy == nullptr)
+                        {
+                            delegates->dataReceivedDelegate(message);
+                            return;
+                        }
+                        if (framerCopy->Feed(message, delegates->dataReceivedDelegate))
+                        { return; }
+                        diagnosticsSenderCopy->SendDiagnosticInformationFormatted(
+                            SystemUtils::DiagnosticsSender::Levels::ERROR,
+                            "Malformed packet received from '%s'", peerIdCopy.c_str());
+                        const auto connection = connectionWeak.lock();
+                        if (connection != nullptr)
+                        { connection->Close(false); }
+                    },
+                    [delegatesCopy](bool graceful)
+                    {
+                        const auto delegates = delegatesCopy->Load();
+                        if (delegates->brokenDelegate != nullptr)
+                        { delegates->brokenDelegate(graceful); }
+                    }))
+            {
+                diagnosticsSender->SendDiagnosticInformationString(
+                    SystemUtils::DiagnosticsSender::Levels::ERROR,
+                    " Error to start to process listening for incoming and sending outgoing "
+                    "messages. ");
+                return false;
+            }
+            return true;
         }
 
-        virtual void Break(const bool clean) override { networkConnectionadaptee->Close(clean); }
+        /**
+         * This method sets up write coalescing for the connection.
+         *
+         * @param[in] timerQueue
+         *      This is used to flush held back packets.
+         * @param[in] configuration
+         *      This holds the coalescing window and byte threshold.
+         * @param[in] counters
+         *      These are the transport counters to update.
+         */
+        void EnableWriteCoalescing(
+            std::shared_ptr<MqttNetworkTransport::TimerQueue> timerQueue,
+            const MqttNetworkTransport::MqttClientNetworkTransport::Configuration& configuration,
+            std::shared_ptr<TransportCounters> counters) {
+            const auto connection = networkConnectionadaptee;
+            const auto gather = gatherConnection;
+            writeCoalescer = std::make_shared<MqttNetworkTransport::WriteCoalescer>(
+                timerQueue, std::chrono::microseconds(configuration.coalescingWindowMicroseconds),
+                configuration.coalescingThresholdBytes,
+                [connection, gather,
+                 counters](std::vector<MqttNetworkTransport::OutgoingMessage>&& packets)
+                {
+                    counters->coalescedPackets += packets.size();
+                    ++counters->coalescedWrites;
+                    if (gather != nullptr)
+                    { gather->SendMessages(std::move(packets)); } else if (packets.size() == 1)
+                    { connection->SendMessage(packets[0].Bytes()); } else
+                    {
+                        size_t size = 0;
+                        for (const auto& packet : packets)
+                        { size += packet.Bytes().size(); }
+                        std::vector<uint8_t> message;
+                        message.reserve(size);
+                        for (const auto& packet : packets)
+                        {
+                            const auto& bytes = packet.Bytes();
+                            message.insert(message.end(), bytes.begin(), bytes.end());
+                        }
+                        connection->SendMessage(message);
+                    }
+                });
+        }
+    };
+
+    /**
+     * This holds what is needed to tell the reconnect governor
+     * how a connect attempt it admitted turns out.
+     */
+    struct GovernedAttempt
+    {
+        /**
+         * This is the governor which admitted the attempt, or nullptr
+         * if connect attempts aren't governed.
+         */
+        std::shared_ptr<MqttNetworkTransport::ReconnectGovernor> governor;
+
+        /**
+         * This identifies, to the governor, the endpoint
+         * to which the attempt is made.
+         */
+        std::string endpoint;
+
+        /**
+         * This is when the attempt may start.
+         */
+        std::chrono::steady_clock::time_point start;
+
+        /**
+         * This method tells the governor, if any, how the attempt turned out.
+         *
+         * @param[in] connected
+         *      This indicates whether or not the attempt succeeded.
+         */
+        void RecordOutcome(bool connected) const {
+            if (governor == nullptr)
+            { return; }
+            if (connected)
+            { governor->RecordSuccess(endpoint); } else
+            { governor->RecordFailure(endpoint, start, std::chrono::steady_clock::now()); }
+        }
+    };
+
+    /**
+     * This holds the state of a connection being established by
+     * ConnectAsync.  The attempt completes exactly once: when the
+     * connection is established, when it fails, times out or is cancelled,
+     * or, unsuccessfully, when the attempt is abandoned.
+     */
+    struct PendingConnect
+    {
+        /**
+         * This is used to synchronize access to the state of the attempt.
+         */
+        std::mutex mutex;
+
+        /**
+         * This is the function to call when the attempt completes.
+         */
+        MqttNetworkTransport::MqttClientNetworkTransport::ConnectCompletionDelegate completion;
+
+        /**
+         * This is the connection being established, once it is made.
+         */
+        std::shared_ptr<ConnectionAdapter> adapter;
+
+        /**
+         * If the host has several addresses, this races the
+         * connections being established to them.
+         */
+        std::shared_ptr<MqttNetworkTransport::ConnectionRace> race;
+
+        /**
+         * If the attempt has a deadline, this is where its timer is scheduled.
+         */
+        std::shared_ptr<MqttNetworkTransport::TimerQueue> timerQueue;
+
+        /**
+         * This identifies the timer of the deadline of the attempt, if any.
+         */
+        MqttNetworkTransport::TimerQueue::Token timer = 0;
+
+        /**
+         * This identifies the timer which starts the attempt once the
+         * reconnect governor admits it, if it has to wait.
+         */
+        MqttNetworkTransport::TimerQueue::Token startTimer = 0;
+
+        /**
+         * This is used to tell the reconnect governor how
+         * the attempt turns out.
+         */
+        GovernedAttempt governed;
+
+        /**
+         * This indicates whether or not the attempt has completed.
+         */
+        bool done = false;
+
+        /**
+         * This indicates whether or not the attempt was cancelled,
+         * which the reconnect governor doesn't count as a failure.
+         */
+        bool cancelled = false;
+
+        /**
+         * This is used to report why attempts fail.
+         */
+        std::shared_ptr<SystemUtils::DiagnosticsSender> diagnosticsSender;
+
+        /**
+         * This identifies the connection in diagnostic messages.
+         */
+        std::string peerId;
+
+        ~PendingConnect() noexcept {
+            if (completion != nullptr)
+            { completion(nullptr); }
+        }
+
+        /**
+         * This method marks the attempt as completed, unless it already is.
+         *
+         * @return
+         *      The function to call to complete the attempt is returned,
+         *      or nullptr if the attempt was already completed.
+         */
+        MqttNetworkTransport::MqttClientNetworkTransport::ConnectCompletionDelegate Claim() {
+            MqttNetworkTransport::MqttClientNetworkTransport::ConnectCompletionDelegate claimed;
+            std::shared_ptr<MqttNetworkTransport::TimerQueue> deadlineTimerQueue;
+            MqttNetworkTransport::TimerQueue::Token pendingStartTimer;
+            {
+                std::lock_guard<decltype(mutex)> lock(mutex);
+                if (done)
+                { return claimed; }
+                done = true;
+                claimed.swap(completion);
+                deadlineTimerQueue = timerQueue;
+                pendingStartTimer = startTimer;
+            }
+            if (deadlineTimerQueue != nullptr)
+            {
+                deadlineTimerQueue->Cancel(timer);
+                deadlineTimerQueue->Cancel(pendingStartTimer);
+            }
+            return claimed;
+        }
+
+        /**
+         * This method records the connection being established, unless
+         * the attempt has already completed.
+         *
+         * @param[in] newAdapter
+         *      This is the connection being established.
+         * @return
+         *      An indication of whether or not the attempt
+         *      should go on is returned.
+         */
+        bool SetAdapter(std::shared_ptr<ConnectionAdapter> newAdapter) {
+            std::lock_guard<decltype(mutex)> lock(mutex);
+            if (done)
+            { return false; }
+            adapter = newAdapter;
+            return true;
+        }
+
+        /**
+         * This method records the race of the connections being
+         * established, unless the attempt has already completed.
+         *
+         * @param[in] newRace
+         *      This is the race of the connections being established.
+         * @return
+         *      An indication of whether or not the attempt
+         *      should go on is returned.
+         */
+        bool SetRace(std::shared_ptr<MqttNetworkTransport::ConnectionRace> newRace) {
+            std::lock_guard<decltype(mutex)> lock(mutex);
+            if (done)
+            { return false; }
+            race = newRace;
+            return true;
+        }
+
+        /**
+         * This method completes the attempt unsuccessfully, unless it has
+         * already completed, closing the connection being established.
+         *
+         * @param[in] level
+         *      This is the level of the diagnostic message to publish.
+         * @param[in] reason
+         *      This explains why the attempt failed.
+         */
+        void Fail(size_t level, const char* reason) {
+            const auto claimed = Claim();
+            if (claimed == nullptr)
+            { return; }
+            std::shared_ptr<ConnectionAdapter> abandoned;
+            std::shared_ptr<MqttNetworkTransport::ConnectionRace> abandonedRace;
+            bool wasCancelled;
+            {
+                std::lock_guard<decltype(mutex)> lock(mutex);
+                abandoned.swap(adapter);
+                abandonedRace.swap(race);
+                wasCancelled = cancelled;
+            }
+            if (!wasCancelled)
+            { governed.RecordOutcome(false); }
+            if (abandoned != nullptr)
+            { abandoned->networkConnectionadaptee->Close(false); }
+            if (abandonedRace != nullptr)
+            { abandonedRace->Cancel(); }
+            diagnosticsSender->SendDiagnosticInformationFormatted(level, "%s '%s'", reason,
+                                                                  peerId.c_str());
+            claimed(nullptr);
+        }
+
+        /**
+         * This method cancels the attempt, unless it has already completed.
+         */
+        void Cancel() {
+            {
+                std::lock_guard<decltype(mutex)> lock(mutex);
+                cancelled = true;
+            }
+            Fail(1, "Cancelled connecting to");
+        }
+    };
+
+    /**
+     * This holds the state of a batch of connections being
+     * established by ConnectMany.
+     */
+    struct BulkConnect
+    {
+        /**
+         * This is used to synchronize access to the state of the batch.
+         */
+        std::mutex mutex;
+
+        /**
+         * These describe the connections to establish.
+         */
+        std::vector<MqttNetworkTransport::MqttClientNetworkTransport::ConnectTarget> targets;
+
+        /**
+         * These are the addresses of the distinct hosts of the targets,
+         * other than local ones.
+         */
+        std::map<std::string, MqttNetworkTransport::HostResolver::Addresses> addresses;
+
+        /**
+         * This is the number of distinct hosts not yet resolved.
+         */
+        size_t unresolvedHosts = 0;
+
+        /**
+         * This is the most attempts which may be in progress at once.
+         */
+        size_t concurrency = 1;
+
+        /**
+         * This is the least time between the starts of consecutive attempts.
+         */
+        std::chrono::microseconds interval{0};
+
+        /**
+         * This is the time before which the next attempt may not start.
+         */
+        std::chrono::steady_clock::time_point nextStart;
+
+        /**
+         * This is the index of the next target to connect to.
+         */
+        size_t next = 0;
+
+        /**
+         * This is the number of attempts in progress.
+         */
+        size_t inFlight = 0;
+
+        /**
+         * This is the number of targets whose attempts have completed,
+         * or which were skipped because the batch was cancelled.
+         */
+        size_t completed = 0;
+
+        /**
+         * This indicates whether or not a thread is starting an attempt.
+         */
+        bool starting = false;
+
+        /**
+         * This indicates whether or not a timer is scheduled
+         * to start the next attempt.
+         */
+        bool startScheduled = false;
+
+        /**
+         * This indicates whether or not the batch was cancelled.
+         */
+        bool cancelled = false;
+
+        /**
+         * These are the attempts started, by target.
+         */
+        std::vector<std::weak_ptr<PendingConnect>> attempts;
+
+        /**
+         * These are the times at which the attempts started, by target.
+         */
+        std::vector<std::chrono::steady_clock::time_point> startTimes;
+
+        /**
+         * This holds the results of the batch.
+         */
+        MqttNetworkTransport::MqttClientNetworkTransport::ConnectManyReport report;
+
+        /**
+         * This is the function to call once the batch completes.
+         */
+        MqttNetworkTransport::MqttClientNetworkTransport::ConnectManyCompletionDelegate completion;
+
+        ~BulkConnect() noexcept { Finish(); }
+
+        /**
+         * This method completes the batch, computing the connect time
+         * percentiles and delivering the report, unless this was
+         * already done.
+         */
+        void Finish() {
+            MqttNetworkTransport::MqttClientNetworkTransport::ConnectManyCompletionDelegate
+                finished;
+            {
+                std::lock_guard<decltype(mutex)> lock(mutex);
+                finished.swap(completion);
+                if (finished == nullptr)
+                { return; }
+                std::vector<uint64_t> connectTimes;
+                for (const auto& outcome : report.outcomes)
+                {
+                    if (outcome.connection != nullptr)
+                    { connectTimes.push_back(outcome.connectMicroseconds); }
+                }
+                std::sort(connectTimes.begin(), connectTimes.end());
+                report.connected = connectTimes.size();
+                if (!connectTimes.empty())
+                {
+                    const auto percentile = [&connectTimes](size_t percent)
+                    {
+                        const auto rank = (connectTimes.size() * percent + 99) / 100;
+                        return connectTimes[(rank == 0) ? 0 : (rank - 1)];
+                    };
+                    report.connectMicrosecondsP50 = percentile(50);
+                    report.connectMicrosecondsP90 = percentile(90);
+                    report.connectMicrosecondsP99 = percentile(99);
+                    report.connectMicrosecondsMax = connectTimes.back();
+                }
+            }
+            finished(report);
+        }
+    };
+
+    /**
+     * This holds the connections being raced to the addresses of a host.
+     */
+    struct RacingConnections
+    {
+        /**
+         * This is used to synchronize access to the connections.
+         */
+        std::mutex mutex;
+
+        /**
+         * These are the connections to each address, once they are made.
+         */
+        std::vector<std::shared_ptr<ConnectionAdapter>> adapters;
     };
 }  // namespace
 
 namespace MqttNetworkTransport
 {
     struct MqttClientNetworkTransport::Impl
+        : public std::enable_shared_from_this<MqttClientNetworkTransport::Impl>
     {
         /**
          * This is a helper object used to generate and publish diagnostics messages.
@@ -92,6 +1004,104 @@ namespace MqttNetworkTransport
          */
         ConnectionFactoryFunction connectionFactory;
 
+        /**
+         * This is used to synchronize access to the configuration
+         * and the resources derived from it.
+         */
+        std::mutex mutex;
+
+        /**
+         * These are the current settings of the transport.
+         */
+        Configuration configuration;
+
+        /**
+         * These are the counters of the transport.
+         */
+        std::shared_ptr<TransportCounters> counters = std::make_shared<TransportCounters>();
+
+        /**
+         * This is used to flush coalesced writes, to enforce connect
+         * deadlines and to pace bulk connects.  It is made when any
+         * of these is first enabled.
+         */
+        std::shared_ptr<MqttNetworkTransport::TimerQueue> timerQueue;
+
+        /**
+         * This is used to look up, and remember, the addresses
+         * of the hosts to which connections are made.
+         */
+        std::shared_ptr<MqttNetworkTransport::HostResolver> resolver;
+
+        /**
+         * This decides when connect attempts may start, when the
+         * configuration backs off or limits the rate of attempts.
+         */
+        std::shared_ptr<MqttNetworkTransport::ReconnectGovernor> governor =
+            std::make_shared<MqttNetworkTransport::ReconnectGovernor>();
+
+        /**
+         * This is used to establish connections asynchronously when
+         * they can only connect by blocking.  It is made when first needed.
+         */
+        std::shared_ptr<MqttNetworkTransport::WorkerPool> connectWorkers;
+
+        /**
+         * This is used to deliver the messages received by "inproc"
+         * connections.  It is made when first needed.
+         */
+        std::shared_ptr<MqttNetworkTransport::WorkerPool> inProcessWorkers;
+
+        /**
+         * If receive buffers are pooled, this is where they are kept.
+         */
+        std::shared_ptr<MqttNetworkTransport::ReceiveBufferPool> receiveBufferPool;
+
+        /**
+         * This is where "ws" and "wss" connections count the work of
+         * compressing and decompressing with permessage-deflate.
+         */
+        std::shared_ptr<MqttNetworkTransport::WebSocketNetworkConnection::DeflateCounters>
+            deflateCounters = std::make_shared<
+                MqttNetworkTransport::WebSocketNetworkConnection::DeflateCounters>();
+
+#if defined(__linux__)
+        /**
+         * This is the pool of event loops shared by all connections
+         * when the transport operates in reactor mode.
+         */
+        std::shared_ptr<MqttNetworkTransport::EventLoopPool> eventLoopPool;
+
+        /**
+         * This is the io_uring instance shared by all connections
+         * when the transport operates in io_uring mode.
+         */
+        std::shared_ptr<MqttNetworkTransport::IoUring> ring;
+
+        /**
+         * This is the event loop which services "unix" and "shm"
+         * connections when the transport doesn't operate in a mode
+         * which provides one.  It is made when first needed.
+         */
+        std::shared_ptr<MqttNetworkTransport::EventLoopPool> localEventLoopPool;
+#endif /* __linux__ */
+
+#if defined(MQTT_NETWORK_TRANSPORT_TLS)
+        /**
+         * This is the client context shared by all "mqtts" and "wss"
+         * connections.  It is made when first needed, and remade when
+         * the TLS settings change.
+         */
+        std::shared_ptr<MqttNetworkTransport::TlsContext> tlsContext;
+
+        /**
+         * This is the pool of workers which perform the handshakes
+         * of all "mqtts" and "wss" connections.  It is made when
+         * first needed.
+         */
+        std::shared_ptr<MqttNetworkTransport::WorkerPool> tlsHandshakeWorkers;
+#endif /* MQTT_NETWORK_TRANSPORT_TLS */
+
         /**
          * This is the constructor for the structure.
          */
@@ -100,15 +1110,1022 @@ namespace MqttNetworkTransport
             diagnosticsSender(
                 std::make_shared<SystemUtils::DiagnosticsSender>("MqttClientNetworkTransport")),
             connectionFactory(
-                [](const std::string&, const std::string&)
+                [this](const std::string& scheme, const std::string& serverName)
+                { return MakeDefaultConnection(scheme, serverName); }),
+            resolver(std::make_shared<MqttNetworkTransport::HostResolver>(RESOLVER_WORKER_COUNT,
+                                                                          LookUpHost)) {
+            resolver->SetTimeToLive(std::chrono::seconds(configuration.hostCacheSeconds),
+                                    std::chrono::seconds(configuration.hostNegativeCacheSeconds));
+        }
+
+        /**
+         * This method returns the pool of workers used to establish
+         * connections which can only connect by blocking, making it if
+         * this is the first time it's needed.  The caller must
+         * hold the mutex.
+         *
+         * @return
+         *      The pool of connect workers is returned.
+         */
+        std::shared_ptr<MqttNetworkTransport::WorkerPool> GetConnectWorkers() {
+            if (connectWorkers == nullptr)
+            {
+                connectWorkers = std::make_shared<MqttNetworkTransport::WorkerPool>(
+                    std::max<size_t>(1, configuration.connectWorkerCount));
+            }
+            return connectWorkers;
+        }
+
+        /**
+         * This method returns the pool of workers used to deliver the
+         * messages received by "inproc" connections, making it if this
+         * is the first time it's needed.  The caller must hold the mutex.
+         *
+         * @return
+         *      The pool of in-process workers is returned.
+         */
+        std::shared_ptr<MqttNetworkTransport::WorkerPool> GetInProcessWorkers() {
+            if (inProcessWorkers == nullptr)
+            {
+                inProcessWorkers =
+                    std::make_shared<MqttNetworkTransport::WorkerPool>(IN_PROCESS_WORKER_COUNT);
+            }
+            return inProcessWorkers;
+        }
+
+        /**
+         * This method returns the queue of timers used by the transport,
+         * making it if this is the first time it's needed.  The caller
+         * must hold the mutex.
+         *
+         * @return
+         *      The queue of timers is returned.
+         */
+        std::shared_ptr<MqttNetworkTransport::TimerQueue> GetTimerQueue() {
+            if (timerQueue == nullptr)
+            { timerQueue = std::make_shared<MqttNetworkTransport::TimerQueue>(); }
+            return timerQueue;
+        }
+
+        /**
+         * This method makes a new connection according to the
+         * current configuration of the transport.
+         *
+         * @param[in] scheme
+         *      This is the scheme indicated in the URI of the target
+         *      to which to establish a connection.  Connections for the
+         *      "mqtts" and "wss" schemes are secured with TLS, and those
+         *      for the "ws" and "wss" schemes carry packets in
+         *      WebSocket frames.  Those for the "unix" scheme are made
+         *      over Unix domain sockets, those for the "shm" scheme
+         *      through memory shared with the broker, and those for the
+         *      "inproc" scheme with an endpoint in this process.
+         * @param[in] serverName
+         *      This is the name of the server to which the transport
+         *      wishes to connect, the path of its socket for the
+         *      "unix" and "shm" schemes, or the name of the endpoint
+         *      for the "inproc" scheme.
+         * @return
+         *      The new connection object is returned, or nullptr
+         *      if it could not be made.
+         */
+        std::shared_ptr<SystemUtils::INetworkConnection> MakeDefaultConnection(
+            const std::string& scheme, const std::string& serverName) {
+            std::lock_guard<decltype(mutex)> lock(mutex);
+            if (scheme == UNIX_SCHEME)
+            { return MakeUnixConnection(serverName); }
+            if (scheme == SHM_SCHEME)
+            { return MakeSharedMemoryConnection(serverName); }
+            if (scheme == INPROC_SCHEME)
+            {
+                return std::make_shared<MqttNetworkTransport::InProcessNetworkConnection>(
+                    serverName, GetInProcessWorkers());
+            }
+            std::shared_ptr<SystemUtils::INetworkConnection> connection;
+#if defined(__linux__)
+            if (ring != nullptr)
+            {
+                connection = std::make_shared<MqttNetworkTransport::UringNetworkConnection>(
+                    ring, receiveBufferPool);
+            } else if (eventLoopPool != nullptr)
+            {
+                connection = std::make_shared<MqttNetworkTransport::ReactorNetworkConnection>(
+                    eventLoopPool, receiveBufferPool);
+            }
+#endif /* __linux__ */
+            if (connection == nullptr)
+            { connection = std::make_shared<SystemUtils::NetworkConnection>(); }
+            if ((scheme == "mqtts") || (scheme == "wss"))
+            {
+#if defined(MQTT_NETWORK_TRANSPORT_TLS)
+                if (tlsContext == nullptr)
+                {
+                    std::string error;
+                    tlsContext = MqttNetworkTransport::TlsContext::Create(
+                        configuration.tlsCaFile, configuration.tlsVerifyPeer,
+                        configuration.tlsKernelOffload, error);
+                    if (tlsContext == nullptr)
+                    {
+                        diagnosticsSender->SendDiagnosticInformationFormatted(
+                            SystemUtils::DiagnosticsSender::Levels::ERROR,
+                            "TLS is not available (%s)", error.c_str());
+                        return nullptr;
+                    }
+                }
+                if (tlsHandshakeWorkers == nullptr)
+                {
+                    tlsHandshakeWorkers = std::make_shared<MqttNetworkTransport::WorkerPool>(
+                        std::max<size_t>(1, configuration.tlsHandshakeWorkerCount));
+                }
+                connection = std::make_shared<MqttNetworkTransport::TlsNetworkConnection>(
+                    connection, tlsContext, serverName, tlsHandshakeWorkers, GetConnectWorkers(),
+                    configuration.tlsEarlyData);
+#else
+                diagnosticsSender->SendDiagnosticInformationFormatted(
+                    SystemUtils::DiagnosticsSender::Levels::ERROR,
+                    "TLS is not available in this build; unable to make \"%s\" connection",
+                    scheme.c_str());
+                return nullptr;
+#endif /* MQTT_NETWORK_TRANSPORT_TLS */
+            }
+            if ((scheme == "ws") || (scheme == "wss"))
+            {
+#if !defined(MQTT_NETWORK_TRANSPORT_DEFLATE)
+                if (configuration.webSocketDeflate)
+                {
+                    diagnosticsSender->SendDiagnosticInformationString(
+                        SystemUtils::DiagnosticsSender::Levels::WARNING,
+                        "permessage-deflate is not available in this build");
+                }
+#endif /* MQTT_NETWORK_TRANSPORT_DEFLATE */
+                MqttNetworkTransport::WebSocketNetworkConnection::DeflateSettings deflateSettings;
+                deflateSettings.enable = configuration.webSocketDeflate;
+                deflateSettings.level = configuration.webSocketDeflateLevel;
+                deflateSettings.windowBits = configuration.webSocketDeflateWindowBits;
+                deflateSettings.contextTakeover = configuration.webSocketDeflateContextTakeover;
+                deflateSettings.maximumMessageSize = configuration.maximumReceivedPacketSize;
+                connection = std::make_shared<MqttNetworkTransport::WebSocketNetworkConnection>(
+                    connection, serverName, configuration.webSocketPath, GetConnectWorkers(),
+                    deflateSettings, deflateCounters);
+            }
+            return connection;
+        }
+
+#if defined(__linux__)
+        /**
+         * This method returns the pool of event loops which services
+         * "unix" and "shm" connections: that of reactor mode, if the
+         * transport operates in it, or otherwise a single loop made
+         * the first time it's needed.  The caller must hold the mutex.
+         *
+         * @return
+         *      The pool of event loops is returned.
+         */
+        std::shared_ptr<MqttNetworkTransport::EventLoopPool> GetLocalEventLoops() {
+            if (eventLoopPool != nullptr)
+            { return eventLoopPool; }
+            if (localEventLoopPool == nullptr)
+            { localEventLoopPool = std::make_shared<MqttNetworkTransport::EventLoopPool>(1); }
+            return localEventLoopPool;
+        }
+#endif /* __linux__ */
+
+        /**
+         * This method makes a new connection to the Unix domain socket at
+         * the given path, serviced by the io_uring instance or event loops
+         * of the transport.  The caller must hold the mutex.
+         *
+         * @param[in] path
+         *      This is the path of the socket.  A path starting with '@'
+         *      names a socket in the Linux abstract namespace.
+         * @return
+         *      The new connection object is returned, or nullptr
+         *      if it could not be made.
+         */
+        std::shared_ptr<SystemUtils::INetworkConnection> MakeUnixConnection(
+            const std::string& path) {
+#if defined(__linux__)
+            const auto address = MqttNetworkTransport::SocketAddress::FromUnixPath(path);
+            if (address.IsEmpty())
+            {
+                diagnosticsSender->SendDiagnosticInformationFormatted(
+                    SystemUtils::DiagnosticsSender::Levels::ERROR,
+                    "'%s' is not a valid Unix domain socket path", path.c_str());
+                return nullptr;
+            }
+            std::shared_ptr<MqttNetworkTransport::SocketAddressConnection> connection;
+            if (ring != nullptr)
+            {
+                connection = std::make_shared<MqttNetworkTransport::UringNetworkConnection>(
+                    ring, receiveBufferPool);
+            } else
+            {
+                connection = std::make_shared<MqttNetworkTransport::ReactorNetworkConnection>(
+                    GetLocalEventLoops(), receiveBufferPool);
+            }
+            connection->SetPeerSocketAddress(address);
+            return std::dynamic_pointer_cast<SystemUtils::INetworkConnection>(connection);
+#else
+            diagnosticsSender->SendDiagnosticInformationFormatted(
+                SystemUtils::DiagnosticsSender::Levels::ERROR,
+                "Unix domain sockets are not available on this platform; "
+                "unable to connect to '%s'",
+                path.c_str());
+            return nullptr;
+#endif /* __linux__ */
+        }
+
+        /**
+         * This method makes a new connection which exchanges data with
+         * the broker through rings in shared memory, set up over the
+         * Unix domain socket at the given path.  The caller must
+         * hold the mutex.
+         *
+         * @param[in] path
+         *      This is the path of the socket.  A path starting with '@'
+         *      names a socket in the Linux abstract namespace.
+         * @return
+         *      The new connection object is returned, or nullptr
+         *      if it could not be made.
+         */
+        std::shared_ptr<SystemUtils::INetworkConnection> MakeSharedMemoryConnection(
+            const std::string& path) {
+#if defined(__linux__)
+            const auto address = MqttNetworkTransport::SocketAddress::FromUnixPath(path);
+            if (address.IsEmpty())
+            {
+                diagnosticsSender->SendDiagnosticInformationFormatted(
+                    SystemUtils::DiagnosticsSender::Levels::ERROR,
+                    "'%s' is not a valid Unix domain socket path", path.c_str());
+                return nullptr;
+            }
+            const auto connection =
+                std::make_shared<MqttNetworkTransport::SharedMemoryNetworkConnection>(
+                    GetLocalEventLoops(), configuration.sharedMemoryRingSize,
+                    std::chrono::microseconds(configuration.sharedMemorySpinMicroseconds),
+                    receiveBufferPool);
+            connection->SetPeerSocketAddress(address);
+            return connection;
+#else
+            diagnosticsSender->SendDiagnosticInformationFormatted(
+                SystemUtils::DiagnosticsSender::Levels::ERROR,
+                "shared memory connections are not available on this platform; "
+                "unable to connect to '%s'",
+                path.c_str());
+            return nullptr;
+#endif /* __linux__ */
+        }
+
+        /**
+         * This method makes the network connection for a new connection,
+         * wrapped in an adapter set up according to the current settings
+         * of the transport, but not yet connected.
+         *
+         * @param[in] scheme
+         *      This is the scheme indicated in the URI of the target
+         *      to which to establish a connection.
+         * @param[in] hostNameOrAddress
+         *      This is the name or address of the host to connect to.
+         * @param[in] peerId
+         *      This identifies the connection in diagnostic messages.
+         * @return
+         *      The new connection adapter is returned, or nullptr
+         *      if the network connection could not be made.
+         */
+        std::shared_ptr<ConnectionAdapter> NewAdapter(const std::string& scheme,
+                                                      const std::string& hostNameOrAddress,
+                                                      const std::string& peerId) {
+            ConnectionFactoryFunction factory;
+            {
+                std::lock_guard<decltype(mutex)> lock(mutex);
+                factory = connectionFactory;
+            }
+            const auto networkConnection = factory(scheme, hostNameOrAddress);
+            if (networkConnection == nullptr)
+            {
+                diagnosticsSender->SendDiagnosticInformationFormatted(
+                    SystemUtils::DiagnosticsSender::Levels::ERROR,
+                    "Unabale to create connection to '%s'", peerId.c_str());
+                return nullptr;
+            }
+            return WrapConnection(networkConnection, peerId);
+        }
+
+        /**
+         * This method wraps the given network connection in an adapter
+         * set up according to the current settings of the transport.
+         *
+         * @param[in] networkConnection
+         *      This is the network connection to wrap.
+         * @param[in] peerId
+         *      This identifies the connection in diagnostic messages.
+         * @return
+         *      The new connection adapter is returned.
+         */
+        std::shared_ptr<ConnectionAdapter> WrapConnection(
+            std::shared_ptr<SystemUtils::INetworkConnection> networkConnection,
+            const std::string& peerId) {
+            Configuration currentConfiguration;
+            std::shared_ptr<MqttNetworkTransport::TimerQueue> currentTimerQueue;
+            {
+                std::lock_guard<decltype(mutex)> lock(mutex);
+                currentConfiguration = configuration;
+                currentTimerQueue = timerQueue;
+            }
+            const auto adapter = std::make_shared<ConnectionAdapter>();
+            adapter->diagnosticsSender = diagnosticsSender;
+            adapter->peerId = peerId;
+            adapter->networkConnectionadaptee = networkConnection;
+            adapter->gatherConnection =
+                std::dynamic_pointer_cast<MqttNetworkTransport::GatherNetworkConnection>(
+                    adapter->networkConnectionadaptee);
+            adapter->asyncConnection =
+                std::dynamic_pointer_cast<MqttNetworkTransport::AsyncNetworkConnection>(
+                    adapter->networkConnectionadaptee);
+            adapter->fastOpenConnection =
+                std::dynamic_pointer_cast<MqttNetworkTransport::FastOpenConnection>(
+                    adapter->networkConnectionadaptee);
+            if (currentConfiguration.tcpFastOpen && (adapter->fastOpenConnection != nullptr))
+            { adapter->fastOpenConnection->EnableFastOpen(); }
+            adapter->inProcessConnection =
+                std::dynamic_pointer_cast<MqttNetworkTransport::InProcessNetworkConnection>(
+                    adapter->networkConnectionadaptee);
+#if defined(__linux__)
+            auto innermost = adapter->networkConnectionadaptee;
+            for (;;)
+            {
+                const auto layered =
+                    std::dynamic_pointer_cast<MqttNetworkTransport::LayeredConnection>(innermost);
+                if (layered == nullptr)
+                { break; }
+                innermost = layered->GetInnerConnection();
+            }
+            adapter->socketAddressConnection =
+                std::dynamic_pointer_cast<MqttNetworkTransport::SocketAddressConnection>(
+                    innermost);
+#endif /* __linux__ */
+            const auto diagnosticsSenderCopy = diagnosticsSender;
+            adapter->networkConnectionadaptee->SubscribeToDiagnostics(
+                [diagnosticsSenderCopy, peerId](std::string senderName, size_t level,
+                                                std::string message) {
+                    diagnosticsSenderCopy->SendDiagnosticInformationString(
+                        level, peerId + ": " + message);
+                },
+                1);
+            if (currentConfiguration.coalescingWindowMicroseconds != 0)
+            { adapter->EnableWriteCoalescing(currentTimerQueue, currentConfiguration, counters); }
+            if (currentConfiguration.receiveFraming != ReceiveFraming::None)
+            {
+                adapter->framer = std::make_shared<MqttNetworkTransport::PacketFramer>(
+                    currentConfiguration.receiveFraming == ReceiveFraming::Batch,
+                    currentConfiguration.maximumReceivedPacketSize);
+            }
+            return adapter;
+        }
+
+        /**
+         * This method admits a new connect attempt through the reconnect
+         * governor, if the configuration governs connect attempts.
+         *
+         * @param[in] scheme
+         *      This is the scheme indicated in the URI of the target
+         *      to which to establish a connection.
+         * @param[in] peerId
+         *      This identifies the connection in diagnostic messages.
+         * @return
+         *      What is needed to tell the governor how the attempt turns
+         *      out, and when the attempt may start, is returned.
+         */
+        GovernedAttempt Govern(const std::string& scheme, const std::string& peerId) {
+            GovernedAttempt governed;
+            governed.start = std::chrono::steady_clock::now();
+            {
+                std::lock_guard<decltype(mutex)> lock(mutex);
+                if ((configuration.connectAttemptsPerSecond == 0) &&
+                    (configuration.reconnectBackoffBaseMilliseconds == 0))
+                { return governed; }
+            }
+            governed.governor = governor;
+            governed.endpoint = scheme + "://" + peerId;
+            governed.start = governor->Admit(governed.endpoint, governed.start);
+            return governed;
+        }
+
+        /**
+         * This method sets up the state of a new asynchronous connect
+         * attempt, admitting it through the reconnect governor and
+         * scheduling its deadline if the configuration sets one.
+         * The deadline is counted from when the attempt may start.
+         *
+         * @param[in] scheme
+         *      This is the scheme indicated in the URI of the target
+         *      to which to establish a connection.
+         * @param[in] peerId
+         *      This identifies the connection in diagnostic messages.
+         * @param[in] completionDelegate
+         *      This is the function to call when the attempt completes.
+         * @return
+         *      The state of the attempt is returned.
+         */
+        std::shared_ptr<PendingConnect> NewPendingConnect(
+            const std::string& scheme, const std::string& peerId,
+            ConnectCompletionDelegate completionDelegate) {
+            const auto pending = std::make_shared<PendingConnect>();
+            pending->completion = completionDelegate;
+            pending->diagnosticsSender = diagnosticsSender;
+            pending->peerId = peerId;
+            pending->governed = Govern(scheme, peerId);
+            std::weak_ptr<PendingConnect> pendingWeak(pending);
+            std::lock_guard<decltype(mutex)> lock(mutex);
+            const auto timeout = std::chrono::milliseconds(configuration.connectTimeoutMilliseconds);
+            if ((timeout.count() != 0) && (timerQueue != nullptr))
+            {
+                std::lock_guard<decltype(pending->mutex)> pendingLock(pending->mutex);
+                pending->timerQueue = timerQueue;
+                pending->timer = timerQueue->Schedule(
+                    pending->governed.start + timeout,
+                    [pendingWeak]
+                    {
+                        const auto expired = pendingWeak.lock();
+                        if (expired != nullptr)
+                        {
+                            expired->Fail(SystemUtils::DiagnosticsSender::Levels::WARNING,
+                                          "Timed out connecting to");
+                        }
+                    });
+            }
+            return pending;
+        }
+
+        /**
+         * This method starts establishing a new connection to a broker,
+         * returning without waiting for it to complete.
+         *
+         * @param[in] scheme
+         *      This is the scheme indicated in the URI of the target
+         *      to which to establish a connection.
+         * @param[in] hostNameOrAddress
+         *      This is the name or address of the host to connect to.
+         * @param[in] port
+         *      This is the port number of the host to connect to.
+         * @param[in] dataReceivedDelegate
+         *      This is the function to call to deliver data received.
+         * @param[in] brokenDelegate
+         *      This is the function to call once the connection is broken.
+         * @param[in] completionDelegate
+         *      This is the function to call, exactly once,
+         *      when the attempt completes.
+         * @return
+         *      A function which cancels the attempt is returned.
+         */
+        CancelDelegate ConnectAsync(const std::string& scheme,
+                                    const std::string& hostNameOrAddress, uint16_t port,
+                                    MqttV5::Connection::DataReceivedDelegate dataReceivedDelegate,
+                                    MqttV5::Connection::BrokenDelegate brokenDelegate,
+                                    ConnectCompletionDelegate completionDelegate) {
+            const bool local = IsLocalScheme(scheme);
+            const auto host = (local ? hostNameOrAddress : StripBrackets(hostNameOrAddress));
+            const auto pending =
+                NewPendingConnect(scheme, FormatPeerId(scheme, host, port), completionDelegate);
+            std::weak_ptr<PendingConnect> pendingWeak(pending);
+            std::weak_ptr<Impl> implWeak(shared_from_this());
+            if (local)
+            {
+                ConnectResolved(pending, MqttNetworkTransport::HostResolver::Addresses(), scheme,
+                                host, port, dataReceivedDelegate, brokenDelegate);
+            } else
+            {
+                resolver->ResolveAsync(
+                    host,
+                    [implWeak, pending, scheme, host, port, dataReceivedDelegate,
+                     brokenDelegate](const MqttNetworkTransport::HostResolver::Addresses& addresses)
+                    {
+                        const auto impl = implWeak.lock();
+                        if (impl == nullptr)
+                        {
+                            pending->Fail(SystemUtils::DiagnosticsSender::Levels::WARNING,
+                                          "Transport released while connecting to");
+                            return;
+                        }
+                        impl->ConnectResolved(pending, addresses, scheme, host, port,
+                                              dataReceivedDelegate, brokenDelegate);
+                    });
+            }
+            return [pendingWeak]
+            {
+                const auto cancelled = pendingWeak.lock();
+                if (cancelled != nullptr)
+                { cancelled->Cancel(); }
+            };
+        }
+
+        /**
+         * This method makes the connection which outlives the network
+         * connections to the given target, if the configuration resumes
+         * broken connections.  Its network connections are established
+         * by ConnectAsync, so they are governed like any other.
+         *
+         * @param[in] scheme
+         *      This is the scheme indicated in the URI of the target.
+         * @param[in] hostNameOrAddress
+         *      This is the name or address of the host of the target.
+         * @param[in] port
+         *      This is the port number of the target.
+         * @return
+         *      The new resuming connection is returned, or nullptr
+         *      if broken connections aren't resumed.
+         */
+        std::shared_ptr<MqttNetworkTransport::ResumingConnection> NewResumingConnection(
+            const std::string& scheme, const std::string& hostNameOrAddress, uint16_t port) {
+            MqttNetworkTransport::ResumingConnection::Settings settings;
+            std::shared_ptr<MqttNetworkTransport::TimerQueue> retryTimerQueue;
+            {
+                std::lock_guard<decltype(mutex)> lock(mutex);
+                if (!configuration.resumeBrokenConnections || (configuration.resumeAttempts == 0))
+                { return nullptr; }
+                settings.bufferBytes = configuration.resumeBufferBytes;
+                settings.attempts = configuration.resumeAttempts;
+                settings.retryDelay =
+                    std::chrono::milliseconds(configuration.resumeRetryMilliseconds);
+                settings.maximumPacketSize = configuration.maximumReceivedPacketSize;
+                if (configuration.resumeRetryMilliseconds != 0)
+                { retryTimerQueue = GetTimerQueue(); }
+            }
+            std::weak_ptr<Impl> implWeak(shared_from_this());
+            const auto countersCopy = counters;
+            const auto host =
+                (IsLocalScheme(scheme) ? hostNameOrAddress : StripBrackets(hostNameOrAddress));
+            return std::make_shared<MqttNetworkTransport::ResumingConnection>(
+                settings, retryTimerQueue,
+                [implWeak, scheme, hostNameOrAddress, port](
+                    MqttV5::Connection::DataReceivedDelegate dataReceivedDelegate,
+                    MqttV5::Connection::BrokenDelegate brokenDelegate,
+                    MqttNetworkTransport::ResumingConnection::ReconnectCompletionDelegate
+                        completionDelegate) -> CancelDelegate
+                {
+                    const auto impl = implWeak.lock();
+                    if (impl == nullptr)
+                    {
+                        completionDelegate(nullptr);
+                        return nullptr;
+                    }
+                    return impl->ConnectAsync(scheme, hostNameOrAddress, port,
+                                              dataReceivedDelegate, brokenDelegate,
+                                              completionDelegate);
+                },
+                [countersCopy](bool resumed)
                 {
-                    const auto connection = std::make_shared<SystemUtils::NetworkConnection>();
-                    return connection;
-                }) {}
+                    if (resumed)
+                    { ++countersCopy->connectionsResumed; } else
+                    { ++countersCopy->connectionResumeFailures; }
+                },
+                diagnosticsSender, FormatPeerId(scheme, host, port));
+        }
+
+        /**
+         * This method starts as many attempts of the given batch as its
+         * concurrency cap and pacing allow.  If pacing holds back the
+         * next attempt, a timer is scheduled to start it later.
+         *
+         * @param[in] bulk
+         *      This is the state of the batch.
+         */
+        void StartBulkAttempts(const std::shared_ptr<BulkConnect>& bulk) {
+            std::weak_ptr<Impl> implWeak(shared_from_this());
+            for (;;)
+            {
+                size_t index;
+                {
+                    std::lock_guard<decltype(bulk->mutex)> lock(bulk->mutex);
+                    if (bulk->starting || bulk->cancelled || (bulk->unresolvedHosts != 0) ||
+                        (bulk->next == bulk->targets.size()) ||
+                        (bulk->inFlight >= bulk->concurrency))
+                    { return; }
+                    const auto now = std::chrono::steady_clock::now();
+                    if (bulk->interval.count() != 0)
+                    {
+                        if (now < bulk->nextStart)
+                        {
+                            std::shared_ptr<MqttNetworkTransport::TimerQueue> timers;
+                            {
+                                std::lock_guard<decltype(mutex)> transportLock(mutex);
+                                timers = timerQueue;
+                            }
+                            if (bulk->startScheduled || (timers == nullptr))
+                            { return; }
+                            bulk->startScheduled = true;
+                            (void)timers->Schedule(bulk->nextStart,
+                                                   [implWeak, bulk]
+                                                   {
+                                                       {
+                                                           std::lock_guard<decltype(bulk->mutex)>
+                                                               lock(bulk->mutex);
+                                                           bulk->startScheduled = false;
+                                                       }
+                                                       const auto impl = implWeak.lock();
+                                                       if (impl != nullptr)
+                                                       { impl->StartBulkAttempts(bulk); }
+                                                   });
+                            return;
+                        }
+                        bulk->nextStart = now + bulk->interval;
+                    }
+                    index = bulk->next++;
+                    ++bulk->inFlight;
+                    bulk->starting = true;
+                    bulk->startTimes[index] = now;
+                }
+                StartBulkAttempt(bulk, index);
+                std::lock_guard<decltype(bulk->mutex)> lock(bulk->mutex);
+                bulk->starting = false;
+            }
+        }
+
+        /**
+         * This method starts the attempt to connect to one target of a batch.
+         * If the batch is cancelled before the attempt is recorded where
+         * cancelling would find it, the attempt is cancelled here instead.
+         *
+         * @param[in] bulk
+         *      This is the state of the batch.
+         * @param[in] index
+         *      This is the index of the target to connect to.
+         */
+        void StartBulkAttempt(const std::shared_ptr<BulkConnect>& bulk, size_t index) {
+            const auto& target = bulk->targets[index];
+            std::weak_ptr<Impl> implWeak(shared_from_this());
+            const auto pending = NewPendingConnect(
+                target.scheme, FormatPeerId(target.scheme, target.hostNameOrAddress, target.port),
+                [implWeak, bulk, index](std::shared_ptr<MqttV5::Connection> connection)
+                {
+                    ConnectCompletionDelegate targetCompletion;
+                    bool finished;
+                    {
+                        std::lock_guard<decltype(bulk->mutex)> lock(bulk->mutex);
+                        auto& outcome = bulk->report.outcomes[index];
+                        outcome.connection = connection;
+                        outcome.connectMicroseconds =
+                            (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(
+                                std::chrono::steady_clock::now() - bulk->startTimes[index])
+                                .count();
+                        --bulk->inFlight;
+                        finished = (++bulk->completed == bulk->targets.size());
+                        targetCompletion = bulk->targets[index].completionDelegate;
+                    }
+                    if (targetCompletion != nullptr)
+                    { targetCompletion(connection); }
+                    if (finished)
+                    {
+                        bulk->Finish();
+                        return;
+                    }
+                    const auto impl = implWeak.lock();
+                    if (impl != nullptr)
+                    { impl->StartBulkAttempts(bulk); }
+                });
+            bool cancelled;
+            {
+                std::lock_guard<decltype(bulk->mutex)> lock(bulk->mutex);
+                bulk->attempts[index] = pending;
+                cancelled = bulk->cancelled;
+            }
+            if (cancelled)
+            {
+                pending->Cancel();
+                return;
+            }
+            MqttNetworkTransport::HostResolver::Addresses addresses;
+            {
+                std::lock_guard<decltype(bulk->mutex)> lock(bulk->mutex);
+                const auto found = bulk->addresses.find(target.hostNameOrAddress);
+                if (found != bulk->addresses.end())
+                { addresses = found->second; }
+            }
+            ConnectResolved(pending, addresses, target.scheme, target.hostNameOrAddress,
+                            target.port, target.dataReceivedDelegate, target.brokenDelegate);
+        }
+
+        /**
+         * This method makes the network connection for a new connection to
+         * the given address of a host, wrapped in an adapter, but not yet
+         * connected.
+         *
+         * @param[in] scheme
+         *      This is the scheme indicated in the URI of the target
+         *      to which to establish a connection.
+         * @param[in] hostNameOrAddress
+         *      This is the name or address of the host to connect to.
+         * @param[in] peerId
+         *      This identifies the connection in diagnostic messages.
+         * @param[in] address
+         *      This is the address of the host to which to connect,
+         *      or nullptr for local schemes.
+         * @param[in] port
+         *      This is the port number of the host to connect to.
+         * @return
+         *      The new connection adapter is returned, or nullptr if the
+         *      network connection could not be made, or can't
+         *      connect to the address.
+         */
+        std::shared_ptr<ConnectionAdapter> NewAttemptAdapter(
+            const std::string& scheme, const std::string& hostNameOrAddress,
+            const std::string& peerId, const MqttNetworkTransport::HostResolver::Address* address,
+            uint16_t port) {
+            const auto adapter = NewAdapter(scheme, hostNameOrAddress, peerId);
+            if ((adapter == nullptr) || (address == nullptr) || !address->ipv6)
+            { return adapter; }
+#if defined(__linux__)
+            if (adapter->socketAddressConnection != nullptr)
+            {
+                adapter->socketAddressConnection->SetPeerSocketAddress(
+                    MqttNetworkTransport::SocketAddress::FromIpv6(address->bytes, port,
+                                                                  address->scopeId));
+                return adapter;
+            }
+#endif /* __linux__ */
+            diagnosticsSender->SendDiagnosticInformationFormatted(
+                SystemUtils::DiagnosticsSender::Levels::WARNING,
+                "Connections made for '%s' can't reach IPv6 addresses", peerId.c_str());
+            return nullptr;
+        }
+
+        /**
+         * This method starts connecting the given connection, without
+         * blocking the caller.
+         *
+         * @param[in] adapter
+         *      This is the connection to connect.
+         * @param[in] address
+         *      This is the IPv4 address of the host, in host byte order,
+         *      or zero if the connection has the address of its peer.
+         * @param[in] port
+         *      This is the port number of the host to connect to.
+         * @param[in] onConnected
+         *      This is the function to call once the connection
+         *      is established or has failed.
+         */
+        void BeginConnect(std::shared_ptr<ConnectionAdapter> adapter, uint32_t address,
+                          uint16_t port, std::function<void(bool connected)> onConnected) {
+            if (adapter->asyncConnection != nullptr)
+            {
+                adapter->asyncConnection->ConnectAsync(address, port, onConnected);
+                return;
+            }
+            std::shared_ptr<MqttNetworkTransport::WorkerPool> workers;
+            {
+                std::lock_guard<decltype(mutex)> lock(mutex);
+                workers = GetConnectWorkers();
+            }
+            const auto connection = adapter->networkConnectionadaptee;
+            workers->Post([connection, address, port, onConnected]
+                          { onConnected(connection->Connect(address, port)); });
+        }
+
+        /**
+         * This method schedules going on with an asynchronous connect
+         * attempt once the reconnect governor lets it start.
+         *
+         * @param[in] pending
+         *      This is the state of the attempt.
+         * @param[in] addresses
+         *      These are the addresses of the host.
+         * @param[in] scheme
+         *      This is the scheme indicated in the URI of the target
+         *      to which to establish a connection.
+         * @param[in] hostNameOrAddress
+         *      This is the name or address of the host to connect to.
+         * @param[in] port
+         *      This is the port number of the host to connect to.
+         * @param[in] dataReceivedDelegate
+         *      This is the function to call to deliver received data.
+         * @param[in] brokenDelegate
+         *      This is the function to call once the connection is broken.
+         */
+        void WaitForAdmission(std::shared_ptr<PendingConnect> pending,
+                              const MqttNetworkTransport::HostResolver::Addresses& addresses,
+                              const std::string& scheme, const std::string& hostNameOrAddress,
+                              uint16_t port,
+                              MqttV5::Connection::DataReceivedDelegate dataReceivedDelegate,
+                              MqttV5::Connection::BrokenDelegate brokenDelegate) {
+            std::shared_ptr<MqttNetworkTransport::TimerQueue> admissionTimerQueue;
+            {
+                std::lock_guard<decltype(mutex)> lock(mutex);
+                admissionTimerQueue = GetTimerQueue();
+            }
+            std::weak_ptr<Impl> implWeak(shared_from_this());
+            std::lock_guard<decltype(pending->mutex)> lock(pending->mutex);
+            if (pending->done)
+            { return; }
+            pending->timerQueue = admissionTimerQueue;
+            pending->startTimer = admissionTimerQueue->Schedule(
+                pending->governed.start,
+                [implWeak, pending, addresses, scheme, hostNameOrAddress, port,
+                 dataReceivedDelegate, brokenDelegate]
+                {
+                    const auto impl = implWeak.lock();
+                    if (impl == nullptr)
+                    {
+                        pending->Fail(SystemUtils::DiagnosticsSender::Levels::WARNING,
+                                      "Transport released while connecting to");
+                        return;
+                    }
+                    impl->ConnectResolved(pending, addresses, scheme, hostNameOrAddress, port,
+                                          dataReceivedDelegate, brokenDelegate);
+                });
+        }
+
+        /**
+         * This method goes on with an asynchronous connect attempt
+         * once the addresses of the host are known.
+         *
+         * @param[in] pending
+         *      This is the state of the attempt.
+         * @param[in] addresses
+         *      These are the addresses of the host, or an empty list if
+         *      it could not be resolved.  They are not used for
+         *      local schemes.
+         * @param[in] scheme
+         *      This is the scheme indicated in the URI of the target
+         *      to which to establish a connection.
+         * @param[in] hostNameOrAddress
+         *      This is the name or address of the host to connect to.
+         * @param[in] port
+         *      This is the port number of the host to connect to.
+         * @param[in] dataReceivedDelegate
+         *      This is the function to call to deliver received data.
+         * @param[in] brokenDelegate
+         *      This is the function to call once the connection is broken.
+         */
+        void ConnectResolved(std::shared_ptr<PendingConnect> pending,
+                             const MqttNetworkTransport::HostResolver::Addresses& addresses,
+                             const std::string& scheme, const std::string& hostNameOrAddress,
+                             uint16_t port,
+                             MqttV5::Connection::DataReceivedDelegate dataReceivedDelegate,
+                             MqttV5::Connection::BrokenDelegate brokenDelegate) {
+            const bool local = IsLocalScheme(scheme);
+            if (addresses.empty() && !local)
+            {
+                pending->Fail(SystemUtils::DiagnosticsSender::Levels::ERROR,
+                              "There is no address to get for");
+                return;
+            }
+            if (pending->governed.start > std::chrono::steady_clock::now())
+            {
+                WaitForAdmission(pending, addresses, scheme, hostNameOrAddress, port,
+                                 dataReceivedDelegate, brokenDelegate);
+                return;
+            }
+            if (!local && (addresses.size() > 1))
+            {
+                const auto ordered =
+                    MqttNetworkTransport::HostResolver::InterleaveFamilies(addresses);
+                RaceConnect(pending, ordered, scheme, hostNameOrAddress, port,
+                            dataReceivedDelegate, brokenDelegate);
+                return;
+            }
+            const auto address = (local ? nullptr : &addresses[0]);
+            const auto adapter =
+                NewAttemptAdapter(scheme, hostNameOrAddress, pending->peerId, address, port);
+            if (adapter == nullptr)
+            {
+                pending->Fail(SystemUtils::DiagnosticsSender::Levels::ERROR,
+                              "Unable to connect to");
+                return;
+            }
+            if (!pending->SetAdapter(adapter))
+            { return; }
+            BeginConnect(adapter, (local ? 0 : address->GetIpv4()), port,
+                         [pending, adapter, dataReceivedDelegate, brokenDelegate](bool connected)
+                         {
+                             if (!connected)
+                             {
+                                 pending->Fail(SystemUtils::DiagnosticsSender::Levels::ERROR,
+                                               "Unable to connect to");
+                                 return;
+                             }
+                             pending->governed.RecordOutcome(true);
+                             const auto completion = pending->Claim();
+                             if (completion == nullptr)
+                             {
+                                 adapter->networkConnectionadaptee->Close(false);
+                                 return;
+                             }
+                             if (adapter->Start(dataReceivedDelegate, brokenDelegate))
+                             { completion(adapter); } else
+                             { completion(nullptr); }
+                         });
+        }
+
+        /**
+         * This method races connections to the given addresses of a host,
+         * as recommended by RFC 8305, completing the attempt with the
+         * first one established.
+         *
+         * @param[in] pending
+         *      This is the state of the attempt.
+         * @param[in] addresses
+         *      These are the addresses of the host, in the order
+         *      in which to try them.
+         * @param[in] scheme
+         *      This is the scheme indicated in the URI of the target
+         *      to which to establish a connection.
+         * @param[in] hostNameOrAddress
+         *      This is the name or address of the host to connect to.
+         * @param[in] port
+         *      This is the port number of the host to connect to.
+         * @param[in] dataReceivedDelegate
+         *      This is the function to call to deliver received data.
+         * @param[in] brokenDelegate
+         *      This is the function to call once the connection is broken.
+         */
+        void RaceConnect(std::shared_ptr<PendingConnect> pending,
+                         const MqttNetworkTransport::HostResolver::Addresses& addresses,
+                         const std::string& scheme, const std::string& hostNameOrAddress,
+                         uint16_t port,
+                         MqttV5::Connection::DataReceivedDelegate dataReceivedDelegate,
+                         MqttV5::Connection::BrokenDelegate brokenDelegate) {
+            std::chrono::milliseconds attemptDelay;
+            std::shared_ptr<MqttNetworkTransport::TimerQueue> raceTimerQueue;
+            {
+                std::lock_guard<decltype(mutex)> lock(mutex);
+                attemptDelay =
+                    std::chrono::milliseconds(configuration.happyEyeballsDelayMilliseconds);
+                if (attemptDelay.count() != 0)
+                { raceTimerQueue = GetTimerQueue(); }
+            }
+            const auto race = std::make_shared<MqttNetworkTransport::ConnectionRace>(
+                addresses.size(), attemptDelay, raceTimerQueue);
+            if (!pending->SetRace(race))
+            { return; }
+            const auto racing = std::make_shared<RacingConnections>();
+            racing->adapters.resize(addresses.size());
+            std::weak_ptr<Impl> implWeak(shared_from_this());
+            const auto peerId = pending->peerId;
+            race->Start(
+                [implWeak, racing, addresses, scheme, hostNameOrAddress, port, peerId](
+                    size_t index,
+                    MqttNetworkTransport::ConnectionRace::AttemptCompletionDelegate completion)
+                {
+                    const auto impl = implWeak.lock();
+                    if (impl == nullptr)
+                    {
+                        completion(false);
+                        return;
+                    }
+                    const auto& address = addresses[index];
+                    const auto adapter =
+                        impl->NewAttemptAdapter(scheme, hostNameOrAddress, peerId, &address, port);
+                    if (adapter == nullptr)
+                    {
+                        completion(false);
+                        return;
+                    }
+                    {
+                        std::lock_guard<decltype(racing->mutex)> lock(racing->mutex);
+                        racing->adapters[index] = adapter;
+                    }
+                    impl->BeginConnect(adapter, address.GetIpv4(), port, completion);
+                },
+                [racing](size_t index)
+                {
+                    std::shared_ptr<ConnectionAdapter> loser;
+                    {
+                        std::lock_guard<decltype(racing->mutex)> lock(racing->mutex);
+                        if (index < racing->adapters.size())
+                        { loser = racing->adapters[index]; }
+                    }
+                    if (loser != nullptr)
+                    { loser->networkConnectionadaptee->Close(false); }
+                },
+                [pending, racing, dataReceivedDelegate, brokenDelegate](size_t winner)
+                {
+                    if (winner == MqttNetworkTransport::ConnectionRace::NO_WINNER)
+                    {
+                        pending->Fail(SystemUtils::DiagnosticsSender::Levels::ERROR,
+                                      "Unable to connect to");
+                        return;
+                    }
+                    std::shared_ptr<ConnectionAdapter> adapter;
+                    {
+                        std::lock_guard<decltype(racing->mutex)> lock(racing->mutex);
+                        adapter = racing->adapters[winner];
+                    }
+                    pending->governed.RecordOutcome(true);
+                    const auto completion = pending->Claim();
+                    if (completion == nullptr)
+                    {
+                        adapter->networkConnectionadaptee->Close(false);
+                        return;
+                    }
+                    if (adapter->Start(dataReceivedDelegate, brokenDelegate))
+                    { completion(adapter); } else
+                    { completion(nullptr); }
+                });
+        }
     };
 
     MqttClientNetworkTransport::~MqttClientNetworkTransport() noexcept = default;
-    MqttClientNetworkTransport::MqttClientNetworkTransport() : impl_(new Impl) {}
+    MqttClientNetworkTransport::MqttClientNetworkTransport() : impl_(std::make_shared<Impl>()) {}
 
     SystemUtils::DiagnosticsSender::UnsubscribeDelegate
     MqttClientNetworkTransport::SubscribeTodiagnostics(
@@ -116,77 +2133,342 @@ namespace MqttNetworkTransport
         return impl_->diagnosticsSender->SubscribeToDiagnostics(delegate, minLevel);
     }
 
-    // void MqttClientNetworkTransport::SetConnectionFactory(
-    //     ConnectionFactoryFunction connectionFactory) {
-    //     impl_->connectionFactory = connectionFactory;
-    // }
+    void MqttClientNetworkTransport::Configure(const Configuration& configuration) {
+        // Connect workers being replaced are only joined once the mutex
+        // is released, since they may be blocked connecting.
+        std::shared_ptr<MqttNetworkTransport::WorkerPool> replacedConnectWorkers;
+        std::lock_guard<decltype(impl_->mutex)> lock(impl_->mutex);
+#if defined(__linux__)
+        if (configuration.reactorLoopCount == 0)
+        { impl_->eventLoopPool = nullptr; } else if (
+            (impl_->eventLoopPool == nullptr) ||
+            (impl_->eventLoopPool->GetLoopCount() != configuration.reactorLoopCount))
+        {
+            impl_->eventLoopPool = std::make_shared<MqttNetworkTransport::EventLoopPool>(
+                configuration.reactorLoopCount);
+        }
+        if (configuration.ioUringQueueDepth == 0)
+        { impl_->ring = nullptr; } else if (
+            (impl_->ring == nullptr) ||
+            (configuration.ioUringQueueDepth != impl_->configuration.ioUringQueueDepth) ||
+            (configuration.ioUringSubmissionPolling !=
+             impl_->configuration.ioUringSubmissionPolling))
+        {
+            std::string error;
+            impl_->ring = MqttNetworkTransport::IoUring::Create(
+                configuration.ioUringQueueDepth, configuration.ioUringSubmissionPolling, error);
+            if (impl_->ring == nullptr)
+            {
+                impl_->diagnosticsSender->SendDiagnosticInformationFormatted(
+                    SystemUtils::DiagnosticsSender::Levels::WARNING,
+                    "io_uring is not available (%s); falling back to other modes",
+                    error.c_str());
+            }
+        }
+#else
+        if ((configuration.reactorLoopCount != 0) || (configuration.ioUringQueueDepth != 0))
+        {
+            impl_->diagnosticsSender->SendDiagnosticInformationString(
+                SystemUtils::DiagnosticsSender::Levels::WARNING,
+                "reactor and io_uring modes are not available on this platform; "
+                "connections will be processed individually");
+        }
+#endif /* __linux__ */
+        if (configuration.receiveBufferPoolSize == 0)
+        { impl_->receiveBufferPool = nullptr; } else if (
+            (impl_->receiveBufferPool == nullptr) ||
+            (configuration.receiveBufferPoolSize != impl_->configuration.receiveBufferPoolSize))
+        {
+            impl_->receiveBufferPool = std::make_shared<MqttNetworkTransport::ReceiveBufferPool>(
+                configuration.receiveBufferPoolSize, impl_->diagnosticsSender);
+        }
+        if (((configuration.coalescingWindowMicroseconds != 0) ||
+             (configuration.connectTimeoutMilliseconds != 0) ||
+             (configuration.connectManyIntervalMicroseconds != 0)) &&
+            (impl_->timerQueue == nullptr))
+        { impl_->timerQueue = std::make_shared<MqttNetworkTransport::TimerQueue>(); }
+        if (configuration.connectWorkerCount != impl_->configuration.connectWorkerCount)
+        { replacedConnectWorkers.swap(impl_->connectWorkers); }
+#if defined(MQTT_NETWORK_TRANSPORT_TLS)
+        if ((configuration.tlsCaFile != impl_->configuration.tlsCaFile) ||
+            (configuration.tlsVerifyPeer != impl_->configuration.tlsVerifyPeer) ||
+            (configuration.tlsKernelOffload != impl_->configuration.tlsKernelOffload))
+        { impl_->tlsContext = nullptr; }
+        if (configuration.tlsHandshakeWorkerCount != impl_->configuration.tlsHandshakeWorkerCount)
+        { impl_->tlsHandshakeWorkers = nullptr; }
+#endif /* MQTT_NETWORK_TRANSPORT_TLS */
+        impl_->resolver->SetTimeToLive(
+            std::chrono::seconds(configuration.hostCacheSeconds),
+            std::chrono::seconds(configuration.hostNegativeCacheSeconds));
+        MqttNetworkTransport::ReconnectGovernor::Settings governorSettings;
+        governorSettings.attemptsPerSecond = configuration.connectAttemptsPerSecond;
+        governorSettings.burst = configuration.connectAttemptBurst;
+        governorSettings.backoffBase =
+            std::chrono::milliseconds(configuration.reconnectBackoffBaseMilliseconds);
+        governorSettings.backoffCap =
+            std::chrono::milliseconds(configuration.reconnectBackoffCapMilliseconds);
+        impl_->governor->Configure(governorSettings);
+        impl_->configuration = configuration;
+    }
+
+    void MqttClientNetworkTransport::SetConnectionFactory(
+        ConnectionFactoryFunction connectionFactory) {
+        std::lock_guard<decltype(impl_->mutex)> lock(impl_->mutex);
+        impl_->connectionFactory = connectionFactory;
+    }
+
+    auto MqttClientNetworkTransport::ListenInProcess(const std::string& name,
+                                                     InProcessAcceptDelegate acceptDelegate)
+        -> StopListeningDelegate {
+        std::weak_ptr<Impl> implWeak(impl_);
+        const auto stopListening = MqttNetworkTransport::InProcessNetworkConnection::Listen(
+            name,
+            [implWeak, acceptDelegate](
+                std::shared_ptr<MqttNetworkTransport::InProcessNetworkConnection> connection)
+            {
+                const auto impl = implWeak.lock();
+                if (impl == nullptr)
+                { return; }
+                const auto adapter = impl->WrapConnection(connection, connection->GetName());
+                if (!adapter->Start(nullptr, nullptr))
+                { return; }
+                acceptDelegate(adapter);
+            });
+        if (stopListening == nullptr)
+        {
+            impl_->diagnosticsSender->SendDiagnosticInformationFormatted(
+                SystemUtils::DiagnosticsSender::Levels::ERROR,
+                "Something in this process already listens under the name '%s'", name.c_str());
+        }
+        return stopListening;
+    }
+
+    auto MqttClientNetworkTransport::GetStatistics() const -> Statistics {
+        Statistics statistics;
+        statistics.coalescedPackets = impl_->counters->coalescedPackets;
+        statistics.coalescedWrites = impl_->counters->coalescedWrites;
+        statistics.webSocketUncompressedBytesSent =
+            impl_->deflateCounters->uncompressedBytesSent;
+        statistics.webSocketCompressedBytesSent = impl_->deflateCounters->compressedBytesSent;
+        statistics.webSocketCompressedBytesReceived =
+            impl_->deflateCounters->compressedBytesReceived;
+        statistics.webSocketUncompressedBytesReceived =
+            impl_->deflateCounters->uncompressedBytesReceived;
+        statistics.webSocketDeflateMicroseconds = impl_->deflateCounters->nanoseconds / 1000;
+        const auto governorStatistics = impl_->governor->GetStatistics();
+        statistics.connectAttemptsBackedOff = governorStatistics.backedOff;
+        statistics.connectAttemptsRateLimited = governorStatistics.rateLimited;
+        statistics.connectThrottleMicroseconds = governorStatistics.delayMicroseconds;
+        statistics.connectionsResumed = impl_->counters->connectionsResumed;
+        statistics.connectionResumeFailures = impl_->counters->connectionResumeFailures;
+        std::shared_ptr<MqttNetworkTransport::ReceiveBufferPool> receiveBufferPool;
+        {
+            std::lock_guard<decltype(impl_->mutex)> lock(impl_->mutex);
+            receiveBufferPool = impl_->receiveBufferPool;
+#if defined(MQTT_NETWORK_TRANSPORT_TLS)
+            if (impl_->tlsContext != nullptr)
+            {
+                const auto tlsStatistics = impl_->tlsContext->GetStatistics();
+                statistics.tlsHandshakes = tlsStatistics.handshakes;
+                statistics.tlsResumedHandshakes = tlsStatistics.resumedHandshakes;
+                statistics.tlsEarlyDataAccepted = tlsStatistics.earlyDataAccepted;
+                statistics.tlsEarlyDataRejected = tlsStatistics.earlyDataRejected;
+                statistics.tlsKernelOffloads = tlsStatistics.kernelOffloads;
+            }
+#endif /* MQTT_NETWORK_TRANSPORT_TLS */
+        }
+        if (receiveBufferPool != nullptr)
+        {
+            const auto poolStatistics = receiveBufferPool->GetStatistics();
+            statistics.receiveBufferHits = poolStatistics.hits;
+            statistics.receiveBufferMisses = poolStatistics.misses;
+        }
+        return statistics;
+    }
 
     std::shared_ptr<MqttV5::Connection> MqttClientNetworkTransport::Connect(
         const std::string& scheme, const std::string& hostNameOrAdrress, uint16_t port,
         MqttV5::Connection::DataReceivedDelegate dataReceivedDelegate,
         MqttV5::Connection::BrokenDelegate brokenDelegate) {
-        const auto adapter = std::make_shared<ConnectionAdapter>();
-        const auto peerId = StringUtils::sprintf("%s:%" PRIu16, hostNameOrAdrress.c_str(), port);
-        adapter->networkConnectionadaptee = impl_->connectionFactory(scheme, hostNameOrAdrress);
-        if (adapter->networkConnectionadaptee == nullptr)
+        const auto resuming = impl_->NewResumingConnection(scheme, hostNameOrAdrress, port);
+        if (resuming != nullptr)
         {
-            impl_->diagnosticsSender->SendDiagnosticInformationFormatted(
-                SystemUtils::DiagnosticsSender::Levels::ERROR,
-                "Unabale to create connection to '%s'", peerId.c_str());
-            return nullptr;
+            resuming->SetDataReceivedDelegate(dataReceivedDelegate);
+            resuming->SetConnectionBrokenDelegate(brokenDelegate);
+            const auto connected =
+                std::make_shared<std::promise<std::shared_ptr<MqttV5::Connection>>>();
+            (void)impl_->ConnectAsync(
+                scheme, hostNameOrAdrress, port, resuming->GetDataReceivedDelegate(),
+                resuming->GetBrokenDelegate(),
+                [connected](std::shared_ptr<MqttV5::Connection> connection)
+                { connected->set_value(connection); });
+            const auto connection = connected->get_future().get();
+            if (connection == nullptr)
+            { return nullptr; }
+            resuming->Attach(connection);
+            return resuming;
         }
-        auto diagnosticsSender = impl_->diagnosticsSender;
-        adapter->networkConnectionadaptee->SubscribeToDiagnostics(
-            [diagnosticsSender, peerId](std::string senderName, size_t level, std::string message)
-            { diagnosticsSender->SendDiagnosticInformationString(level, peerId + ": " + message); },
-            1);
-        const uint32_t address =
-            SystemUtils::NetworkConnection::GetAddressOfHost(hostNameOrAdrress);
-        if (address == 0)
+        const bool local = IsLocalScheme(scheme);
+        const auto host = (local ? hostNameOrAdrress : StripBrackets(hostNameOrAdrress));
+        const auto peerId = FormatPeerId(scheme, host, port);
+        MqttNetworkTransport::HostResolver::Addresses addresses;
+        if (!local)
         {
-            impl_->diagnosticsSender->SendDiagnosticInformationFormatted(
-                SystemUtils::DiagnosticsSender::Levels::ERROR,
-                "There is no address to get from '%s'", hostNameOrAdrress.c_str());
+            addresses = impl_->resolver->Resolve(host);
+            if (addresses.empty())
+            {
+                impl_->diagnosticsSender->SendDiagnosticInformationFormatted(
+                    SystemUtils::DiagnosticsSender::Levels::ERROR,
+                    "There is no address to get from '%s'", host.c_str());
+                return nullptr;
+            }
+        }
+        if (addresses.size() > 1)
+        {
+            const auto connected =
+                std::make_shared<std::promise<std::shared_ptr<MqttV5::Connection>>>();
+            const auto pending = std::make_shared<PendingConnect>();
+            pending->completion = [connected](std::shared_ptr<MqttV5::Connection> connection)
+            { connected->set_value(connection); };
+            pending->diagnosticsSender = impl_->diagnosticsSender;
+            pending->peerId = peerId;
+            pending->governed = impl_->Govern(scheme, peerId);
+            impl_->ConnectResolved(pending, addresses, scheme, host, port, dataReceivedDelegate,
+                                   brokenDelegate);
+            return connected->get_future().get();
+        }
+        const auto governed = impl_->Govern(scheme, peerId);
+        std::this_thread::sleep_until(governed.start);
+        const auto adapter = impl_->NewAttemptAdapter(scheme, host, peerId,
+                                                      (local ? nullptr : &addresses[0]), port);
+        if (adapter == nullptr)
+        {
+            governed.RecordOutcome(false);
             return nullptr;
         }
-        if (!adapter->networkConnectionadaptee->Connect(address, port))
+        if (!adapter->networkConnectionadaptee->Connect((local ? 0 : addresses[0].GetIpv4()),
+                                                        port))
         {
+            governed.RecordOutcome(false);
             impl_->diagnosticsSender->SendDiagnosticInformationFormatted(
                 SystemUtils::DiagnosticsSender::Levels::ERROR, "Unable to connect to '%s'",
                 peerId.c_str());
             return nullptr;
         }
-        adapter->connectionDelegates->dataReceivedDelegate = dataReceivedDelegate;
-        adapter->connectionDelegates->brokenDelegate = brokenDelegate;
-        const auto delegatesCopy = adapter->connectionDelegates;
-        if (!adapter->networkConnectionadaptee->Process(
-                [delegatesCopy](const std::vector<uint8_t>& message)
+        governed.RecordOutcome(true);
+        if (!adapter->Start(dataReceivedDelegate, brokenDelegate))
+        { return nullptr; }
+        return adapter;
+    }
+
+    auto MqttClientNetworkTransport::ConnectAsync(
+        const std::string& scheme, const std::string& hostNameOrAddress, uint16_t port,
+        MqttV5::Connection::DataReceivedDelegate dataReceivedDelegate,
+        MqttV5::Connection::BrokenDelegate brokenDelegate,
+        ConnectCompletionDelegate completionDelegate) -> CancelDelegate {
+        const auto resuming = impl_->NewResumingConnection(scheme, hostNameOrAddress, port);
+        if (resuming == nullptr)
+        {
+            return impl_->ConnectAsync(scheme, hostNameOrAddress, port, dataReceivedDelegate,
+                                       brokenDelegate, completionDelegate);
+        }
+        resuming->SetDataReceivedDelegate(dataReceivedDelegate);
+        resuming->SetConnectionBrokenDelegate(brokenDelegate);
+        return impl_->ConnectAsync(
+            scheme, hostNameOrAddress, port, resuming->GetDataReceivedDelegate(),
+            resuming->GetBrokenDelegate(),
+            [resuming, completionDelegate](std::shared_ptr<MqttV5::Connection> connection)
+            {
+                if (connection == nullptr)
                 {
-                    MqttV5::Connection::DataReceivedDelegate dataReceivedDelegate;
-                    {
-                        std::lock_guard<decltype(delegatesCopy->mutex)> lock(delegatesCopy->mutex);
-                        dataReceivedDelegate = delegatesCopy->dataReceivedDelegate;
-                    }
-                    if (dataReceivedDelegate != nullptr)
-                    { dataReceivedDelegate(message); }
-                },
-                [delegatesCopy](bool graceful)
+                    completionDelegate(nullptr);
+                    return;
+                }
+                resuming->Attach(connection);
+                completionDelegate(resuming);
+            });
+    }
+
+    auto MqttClientNetworkTransport::ConnectMany(std::vector<ConnectTarget> targets,
+                                                 ConnectManyCompletionDelegate completionDelegate)
+        -> CancelDelegate {
+        const auto bulk = std::make_shared<BulkConnect>();
+        bulk->targets = std::move(targets);
+        bulk->completion = completionDelegate;
+        bulk->report.outcomes.resize(bulk->targets.size());
+        bulk->attempts.resize(bulk->targets.size());
+        bulk->startTimes.resize(bulk->targets.size());
+        {
+            std::lock_guard<decltype(impl_->mutex)> lock(impl_->mutex);
+            bulk->concurrency = std::max<size_t>(1, impl_->configuration.connectManyConcurrency);
+            bulk->interval =
+                std::chrono::microseconds(impl_->configuration.connectManyIntervalMicroseconds);
+        }
+        for (auto& target : bulk->targets)
+        {
+            if (!IsLocalScheme(target.scheme))
+            {
+                target.hostNameOrAddress = StripBrackets(target.hostNameOrAddress);
+                bulk->addresses[target.hostNameOrAddress].clear();
+            }
+        }
+        bulk->unresolvedHosts = bulk->addresses.size();
+        std::weak_ptr<BulkConnect> bulkWeak(bulk);
+        if (bulk->targets.empty())
+        {
+            bulk->Finish();
+            return [] {};
+        }
+        std::vector<std::string> hosts;
+        for (const auto& address : bulk->addresses)
+        { hosts.push_back(address.first); }
+        if (hosts.empty())
+        { impl_->StartBulkAttempts(bulk); }
+        std::weak_ptr<Impl> implWeak(impl_);
+        for (const auto& host : hosts)
+        {
+            impl_->resolver->ResolveAsync(
+                host,
+                [implWeak, bulk,
+                 host](const MqttNetworkTransport::HostResolver::Addresses& addresses)
                 {
-                    MqttV5::Connection::BrokenDelegate brokenDelegate;
                     {
-                        std::lock_guard<decltype(delegatesCopy->mutex)> lock(delegatesCopy->mutex);
-                        brokenDelegate = delegatesCopy->brokenDelegate;
+                        std::lock_guard<decltype(bulk->mutex)> lock(bulk->mutex);
+                        bulk->addresses[host] = addresses;
+                        if (--bulk->unresolvedHosts != 0)
+                        { return; }
                     }
-                    if (brokenDelegate != nullptr)
-                    { brokenDelegate(graceful); }
-                }))
-        {
-            impl_->diagnosticsSender->SendDiagnosticInformationString(
-                SystemUtils::DiagnosticsSender::Levels::ERROR,
-                " Error to start to process listening for incoming and sending outgoing "
-                "messages. ");
-            return nullptr;
+                    const auto impl = implWeak.lock();
+                    if (impl != nullptr)
+                    { impl->StartBulkAttempts(bulk); }
+                });
         }
-        return adapter;
+        return [bulkWeak]
+        {
+            const auto cancelled = bulkWeak.lock();
+            if (cancelled == nullptr)
+            { return; }
+            std::vector<std::shared_ptr<PendingConnect>> attempts;
+            bool finished;
+            {
+                std::lock_guard<decltype(cancelled->mutex)> lock(cancelled->mutex);
+                if (cancelled->cancelled)
+                { return; }
+                cancelled->cancelled = true;
+                cancelled->completed += cancelled->targets.size() - cancelled->next;
+                cancelled->next = cancelled->targets.size();
+                finished = (cancelled->completed == cancelled->targets.size());
+                for (const auto& attemptWeak : cancelled->attempts)
+                {
+                    const auto attempt = attemptWeak.lock();
+                    if (attempt != nullptr)
+                    { attempts.push_back(attempt); }
+                }
+            }
+            for (const auto& attempt : attempts)
+            { attempt->Cancel(); }
+            if (finished)
+            { cancelled->Finish(); }
+        };
     }
 }  // namespace MqttNetworkTransport
\ No newline at end of file
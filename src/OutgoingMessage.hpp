@@ -0,0 +1,67 @@
+#ifndef MQTT_NETWORK_TRANSPORT_OUTGOING_MESSAGE_HPP
+#define MQTT_NETWORK_TRANSPORT_OUTGOING_MESSAGE_HPP
+/**
+ * @file OutgoingMessage.hpp
+ *
+ * This module declares the MqttNetworkTransport::OutgoingMessage structure.
+ *
+ * © 2025 by Hatem Nabli
+ */
+
+#include <memory>
+#include <utility>
+#include <vector>
+#include <stddef.h>
+#include <stdint.h>
+
+namespace MqttNetworkTransport
+{
+    /**
+     * This is a message queued to be sent, whose bytes are either owned
+     * outright or shared, by reference count, with whoever produced them.
+     * Either way, the bytes are never copied on their way to the socket.
+     */
+    struct OutgoingMessage
+    {
+        /**
+         * These are the bytes of the message, if owned outright.
+         */
+        std::vector<uint8_t> owned;
+
+        /**
+         * These are the bytes of the message, if shared.
+         */
+        std::shared_ptr<const std::vector<uint8_t>> shared;
+
+        OutgoingMessage() = default;
+
+        /**
+         * This constructor takes ownership of the given bytes.
+         *
+         * @param[in] message
+         *      These are the bytes of the message.
+         */
+        explicit OutgoingMessage(std::vector<uint8_t>&& message) : owned(std::move(message)) {}
+
+        /**
+         * This constructor shares the given bytes.
+         *
+         * @param[in] message
+         *      These are the bytes of the message.
+         */
+        explicit OutgoingMessage(std::shared_ptr<const std::vector<uint8_t>> message) :
+            shared(std::move(message)) {}
+
+        /**
+         * This method returns the bytes of the message.
+         *
+         * @return
+         *      The bytes of the message are returned.
+         */
+        const std::vector<uint8_t>& Bytes() const {
+            return ((shared == nullptr) ? owned : *shared);
+        }
+    };
+}  // namespace MqttNetworkTransport
+
+#endif /** MQTT_NETWORK_TRANSPORT_OUTGOING_MESSAGE_HPP */
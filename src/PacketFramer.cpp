@@ -0,0 +1,202 @@
+/**
+ * @file PacketFramer.cpp
+ *
+ * This module implements the MqttNetworkTransport::PacketFramer class.
+ *
+ * © 2025 by Hatem Nabli
+ */
+
+#include "PacketFramer.hpp"
+
+namespace
+{
+    /**
+     * This is the most bytes the Remaining Length of a fixed header
+     * may be encoded in.
+     */
+    constexpr size_t MAXIMUM_REMAINING_LENGTH_BYTES = 4;
+
+    /**
+     * These are the possible outcomes of parsing a fixed header.
+     */
+    enum class HeaderStatus
+    {
+        Complete,
+        Incomplete,
+        Malformed,
+    };
+
+    /**
+     * This function parses the fixed header at the start of the given data
+     * to determine the total size of the packet it begins.
+     *
+     * @param[in] data
+     *      This points to the start of the packet.
+     * @param[in] size
+     *      This is the number of bytes available.
+     * @param[out] packetSize
+     *      This is where to store the total size of the packet,
+     *      if the header is complete.
+     * @return
+     *      The outcome of parsing the header is returned.
+     */
+    HeaderStatus ParseFixedHeader(const uint8_t* data, size_t size, size_t& packetSize) {
+        size_t remainingLength = 0;
+        for (size_t i = 0; i < MAXIMUM_REMAINING_LENGTH_BYTES; ++i)
+        {
+            if (1 + i >= size)
+            { return HeaderStatus::Incomplete; }
+            const uint8_t encoded = data[1 + i];
+            remainingLength |= ((size_t)(encoded & 0x7F) << (7 * i));
+            if ((encoded & 0x80) == 0)
+            {
+                packetSize = 2 + i + remainingLength;
+                return HeaderStatus::Complete;
+            }
+        }
+        return HeaderStatus::Malformed;
+    }
+
+    /**
+     * This function finds the complete packets at the start of the given data.
+     *
+     * @param[in] data
+     *      This points to the data to scan.
+     * @param[in] size
+     *      This is the number of bytes to scan.
+     * @param[in] maximumPacketSize
+     *      This is the most bytes a packet may take.
+     * @param[out] ends
+     *      This is where to store the offset just past each complete packet.
+     * @return
+     *      An indication of whether or not the data is well formed
+     *      is returned.
+     */
+    bool FindPackets(const uint8_t* data, size_t size, size_t maximumPacketSize,
+                     std::vector<size_t>& ends) {
+        size_t offset = 0;
+        for (;;)
+        {
+            size_t packetSize = 0;
+            switch (ParseFixedHeader(data + offset, size - offset, packetSize))
+            {
+            case HeaderStatus::Malformed: return false;
+            case HeaderStatus::Incomplete: return true;
+            case HeaderStatus::Complete: break;
+            }
+            if (packetSize > maximumPacketSize)
+            { return false; }
+            if (packetSize > size - offset)
+            { return true; }
+            offset += packetSize;
+            ends.push_back(offset);
+        }
+    }
+}  // namespace
+
+namespace MqttNetworkTransport
+{
+    struct PacketFramer::Impl
+    {
+        /**
+         * This indicates whether all complete packets are
+         * delivered together in one call.
+         */
+        bool batch = false;
+
+        /**
+         * This is the most bytes a packet may take.
+         */
+        size_t maximumPacketSize = 0;
+
+        /**
+         * This indicates whether malformed data has been seen, after
+         * which no more data is delivered.
+         */
+        bool malformed = false;
+
+        /**
+         * This holds received data which doesn't yet make
+         * up a complete packet.
+         */
+        std::vector<uint8_t> partial;
+
+        /**
+         * This holds the offsets just past each complete packet found
+         * by the last scan.  It is kept to reuse its capacity.
+         */
+        std::vector<size_t> ends;
+
+        /**
+         * This method delivers the complete packets found at the
+         * start of the given data.
+         *
+         * @param[in] data
+         *      This is the data scanned.
+         * @param[in] delegate
+         *      This is the function to call to deliver complete packets.
+         * @return
+         *      The number of bytes delivered is returned.
+         */
+        size_t Deliver(const std::vector<uint8_t>& data,
+                       const MqttV5::Connection::DataReceivedDelegate& delegate) {
+            if (ends.empty())
+            { return 0; }
+            const auto delivered = ends.back();
+            if ((ends.size() == 1) || batch)
+            {
+                if (delivered == data.size())
+                { delegate(data); } else
+                { delegate(std::vector<uint8_t>(data.begin(), data.begin() + delivered)); }
+                return delivered;
+            }
+            size_t begin = 0;
+            for (const auto end : ends)
+            {
+                delegate(std::vector<uint8_t>(data.begin() + begin, data.begin() + end));
+                begin = end;
+            }
+            return delivered;
+        }
+    };
+
+    PacketFramer::~PacketFramer() noexcept = default;
+
+    PacketFramer::PacketFramer(bool batch, size_t maximumPacketSize) : impl_(new Impl) {
+        impl_->batch = batch;
+        impl_->maximumPacketSize = maximumPacketSize;
+    }
+
+    bool PacketFramer::Feed(const std::vector<uint8_t>& data,
+                            const MqttV5::Connection::DataReceivedDelegate& delegate) {
+        if (impl_->malformed)
+        { return false; }
+        impl_->ends.clear();
+        if (impl_->partial.empty())
+        {
+            if (!FindPackets(data.data(), data.size(), impl_->maximumPacketSize, impl_->ends))
+            {
+                impl_->malformed = true;
+                return false;
+            }
+            const auto delivered = impl_->Deliver(data, delegate);
+            impl_->partial.assign(data.begin() + delivered, data.end());
+            return true;
+        }
+        impl_->partial.insert(impl_->partial.end(), data.begin(), data.end());
+        if (!FindPackets(impl_->partial.data(), impl_->partial.size(), impl_->maximumPacketSize,
+                         impl_->ends))
+        {
+            impl_->malformed = true;
+            impl_->partial.clear();
+            return false;
+        }
+        if (impl_->ends.empty())
+        { return true; }
+        std::vector<uint8_t> pending;
+        pending.swap(impl_->partial);
+        const auto delivered = impl_->Deliver(pending, delegate);
+        impl_->partial.assign(pending.begin() + delivered, pending.end());
+        return true;
+    }
+}  // namespace MqttNetworkTransport
@@ -0,0 +1,91 @@
+#ifndef MQTT_NETWORK_TRANSPORT_PACKET_FRAMER_HPP
+#define MQTT_NETWORK_TRANSPORT_PACKET_FRAMER_HPP
+/**
+ * @file PacketFramer.hpp
+ *
+ * This module declares the MqttNetworkTransport::PacketFramer class.
+ *
+ * © 2025 by Hatem Nabli
+ */
+
+#include <memory>
+#include <vector>
+#include <stddef.h>
+#include <stdint.h>
+#include <MqttV5/ClientTransportLayer.hpp>
+
+namespace MqttNetworkTransport
+{
+    /**
+     * This splits the stream of data received on a connection into whole
+     * MQTT control packets, using the fixed header and its variable-length
+     * Remaining Length, so that the protocol layer never sees a partial
+     * packet.
+     *
+     * Received data is delivered as it is when it holds exactly one packet
+     * or, when packets are batched, exactly whole packets.  Otherwise the
+     * packets delivered are copied out of it, and so is the start of any
+     * packet which straddles reads, until the rest of it is received.
+     *
+     * A packet larger than a given maximum is treated as malformed, so
+     * that no more than that is ever held waiting for a packet to end.
+     */
+    class PacketFramer
+    {
+        // Lifecycle management
+    public:
+        ~PacketFramer() noexcept;
+        PacketFramer(const PacketFramer&) = delete;
+        PacketFramer(PacketFramer&&) noexcept = delete;
+        PacketFramer& operator=(const PacketFramer&) = delete;
+        PacketFramer& operator=(PacketFramer&&) noexcept = delete;
+
+        // Public methods
+    public:
+        /**
+         * This is the constructor.
+         *
+         * @param[in] batch
+         *      This indicates whether all the complete packets available
+         *      after a read are delivered together in one call (true),
+         *      or each packet is delivered in a call of its own (false).
+         * @param[in] maximumPacketSize
+         *      This is the most bytes a packet may take, fixed header
+         *      included.  A larger packet makes the data malformed.
+         */
+        PacketFramer(bool batch, size_t maximumPacketSize);
+
+        /**
+         * This method takes in data received on the connection and
+         * delivers the packets it completes.
+         *
+         * @param[in] data
+         *      This is the data received.
+         * @param[in] delegate
+         *      This is the function to call to deliver complete packets.
+         * @return
+         *      An indication of whether or not the data was well formed
+         *      is returned.  Once malformed data is seen, the stream
+         *      cannot be framed anymore and the connection should
+         *      be broken.
+         */
+        bool Feed(const std::vector<uint8_t>& data,
+                  const MqttV5::Connection::DataReceivedDelegate& delegate);
+
+        // Private properties
+    private:
+        /**
+         * This is the type of structure that contains the private
+         * properties of the instance.  It is defined in the implementation
+         * and declared here to ensure that it is scoped inside the class.
+         */
+        struct Impl;
+
+        /**
+         * This contains the private properties of the instance.
+         */
+        std::unique_ptr<Impl> impl_;
+    };
+}  // namespace MqttNetworkTransport
+
+#endif /** MQTT_NETWORK_TRANSPORT_PACKET_FRAMER_HPP */
@@ -0,0 +1,738 @@
+/**
+ * @file ReactorNetworkConnection.cpp
+ *
+ * This module implements the MqttNetworkTransport::ReactorNetworkConnection
+ * class.
+ *
+ * © 2025 by Hatem Nabli
+ */
+
+#include "ReactorNetworkConnection.hpp"
+#include <deque>
+#include <errno.h>
+#include <fcntl.h>
+#include <mutex>
+#include <string.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+namespace
+{
+    /**
+     * This is the maximum number of bytes read from the socket at once.
+     */
+    constexpr size_t MAXIMUM_READ_SIZE = 65536;
+
+    /**
+     * This is the maximum number of queued messages gathered into one write.
+     */
+    constexpr size_t MAXIMUM_GATHER_COUNT = 64;
+
+    /**
+     * This returns the buffer into which the calling loop thread reads
+     * from sockets.  There is one per loop thread, shared by every
+     * connection the thread services, rather than one per connection.
+     *
+     * @return
+     *      The read buffer of the calling thread is returned.
+     */
+    std::vector<uint8_t>& GetReadBuffer() {
+        thread_local std::vector<uint8_t> readBuffer(MAXIMUM_READ_SIZE);
+        return readBuffer;
+    }
+}  // namespace
+
+namespace MqttNetworkTransport
+{
+    struct ReactorNetworkConnection::Impl
+    {
+        /**
+         * This is the pool of event loops servicing the connection.
+         */
+        std::shared_ptr<EventLoopPool> eventLoopPool;
+
+        /**
+         * This is a helper object used to generate and publish diagnostics messages.
+         */
+        std::shared_ptr<SystemUtils::DiagnosticsSender> diagnosticsSender;
+
+        /**
+         * This is used to synchronize access to the connection state.
+         */
+        std::recursive_mutex mutex;
+
+        /**
+         * This is the socket of the connection, or -1 if there is none.
+         */
+        int sock = -1;
+
+        /**
+         * This is the registration of the socket with the event loop pool.
+         */
+        EventLoopPool::Registration registration;
+
+        /**
+         * These are the address and port of the peer.
+         */
+        uint32_t peerAddress = 0;
+        uint16_t peerPort = 0;
+
+        /**
+         * If not empty, this is the address to which the connection is
+         * made, in place of the IPv4 address and port of the peer.
+         */
+        SocketAddress peerSocketAddress;
+
+        /**
+         * These are the address and port of the local end of the connection.
+         */
+        uint32_t boundAddress = 0;
+        uint16_t boundPort = 0;
+
+        /**
+         * If not null, this is where to take the buffers in which
+         * received data is delivered.
+         */
+        std::shared_ptr<ReceiveBufferPool> receiveBufferPool;
+
+        /**
+         * This is the delegate to call whenever data is received.
+         * It is only set before the socket is registered with
+         * the event loop, so the loop reads it without locking.
+         */
+        MessageReceivedDelegate messageReceivedDelegate;
+
+        /**
+         * This is the delegate to call once the connection is broken.
+         */
+        BrokenDelegate brokenDelegate;
+
+        /**
+         * This is the delegate to call once an asynchronous connect
+         * attempt completes, while one is in progress.
+         */
+        ConnectDelegate connectDelegate;
+
+        /**
+         * This indicates whether or not an asynchronous connect
+         * attempt is in progress.
+         */
+        bool connecting = false;
+
+        /**
+         * These are the messages waiting to be written to the socket.
+         */
+        std::deque<OutgoingMessage> outputQueue;
+
+        /**
+         * This is the number of bytes of the front message of the
+         * output queue which have already been written.
+         */
+        size_t outputOffset = 0;
+
+        /**
+         * This indicates whether or not the socket is watched for writability.
+         */
+        bool watchingOutput = false;
+
+        /**
+         * This indicates whether or not a clean close was requested, in which
+         * case the write side is shut down once the output queue drains.
+         */
+        bool closing = false;
+
+        /**
+         * This indicates whether or not the connection is to be
+         * established with TCP Fast Open.
+         */
+        bool fastOpen = false;
+
+        /**
+         * This indicates whether or not the connection was established
+         * with TCP Fast Open.  It is recorded before the socket is closed.
+         */
+        bool fastOpenUsed = false;
+
+        /**
+         * This is the constructor for the structure.
+         */
+        Impl() :
+            diagnosticsSender(
+                std::make_shared<SystemUtils::DiagnosticsSender>("ReactorNetworkConnection")) {}
+
+        /**
+         * This method is called from the loop thread whenever
+         * the socket has pending events.
+         *
+         * @param[in] events
+         *      These are the pending epoll events.
+         */
+        void OnEvents(uint32_t events) {
+            if ((events & EPOLLOUT) != 0)
+            {
+                std::lock_guard<decltype(mutex)> lock(mutex);
+                Flush();
+            }
+            if ((events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR)) != 0)
+            { Receive(); }
+        }
+
+        /**
+         * This method is called from the loop thread once the socket
+         * of an asynchronous connect attempt becomes writable, which
+         * means the attempt has completed.
+         */
+        void OnConnectEvents() {
+            ConnectDelegate delegate;
+            bool connected = false;
+            {
+                std::lock_guard<decltype(mutex)> lock(mutex);
+                if (!connecting)
+                { return; }
+                connecting = false;
+                delegate.swap(connectDelegate);
+                int error = 0;
+                socklen_t errorLength = sizeof(error);
+                if (getsockopt(sock, SOL_SOCKET, SO_ERROR, &error, &errorLength) != 0)
+                { error = errno; }
+                eventLoopPool->Remove(registration, sock);
+                registration = EventLoopPool::Registration();
+                if (error == 0)
+                {
+                    RecordBoundAddress();
+                    connected = true;
+                } else
+                {
+                    diagnosticsSender->SendDiagnosticInformationFormatted(
+                        SystemUtils::DiagnosticsSender::Levels::ERROR, "error in connect (%s)",
+                        strerror(error));
+                    (void)close(sock);
+                    sock = -1;
+                }
+            }
+            delegate(connected);
+        }
+
+        /**
+         * This method records whether or not the connection was established
+         * with TCP Fast Open, if it was requested and hasn't been found
+         * to be used yet.  The caller must hold the mutex.
+         */
+        void RecordFastOpen() {
+            if (fastOpen && !fastOpenUsed && (sock >= 0))
+            { fastOpenUsed = FastOpenConnection::WasUsed(sock); }
+        }
+
+        /**
+         * This method sets up the given socket to connect with TCP Fast
+         * Open, if requested.  The connection is made without it if the
+         * socket can't be set up.  The caller must hold the mutex.
+         *
+         * @param[in] newSock
+         *      This is the socket to set up.
+         * @param[in] address
+         *      This is the address to which the socket is to connect.
+         *      TCP Fast Open is not used for Unix domain sockets.
+         */
+        void SetUpFastOpen(int newSock, const SocketAddress& address) {
+            std::string error;
+            if (fastOpen && (address.GetFamily() != AF_UNIX) &&
+                !FastOpenConnection::SetUpSocket(newSock, error))
+            {
+                diagnosticsSender->SendDiagnosticInformationFormatted(
+                    SystemUtils::DiagnosticsSender::Levels::WARNING,
+                    "unable to use TCP Fast Open (%s)", error.c_str());
+            }
+        }
+
+        /**
+         * This method returns the address to which to connect, given the
+         * IPv4 address and port of the peer.  The caller must hold the mutex.
+         *
+         * @param[in] address
+         *      This is the IPv4 address of the peer.
+         * @param[in] port
+         *      This is the TCP port of the peer.
+         * @return
+         *      The address set for the peer, if any, is returned.
+         *      Otherwise, the address of the given IPv4 address
+         *      and port is returned.
+         */
+        SocketAddress TargetAddress(uint32_t address, uint16_t port) const {
+            if (peerSocketAddress.IsEmpty())
+            { return SocketAddress::FromIpv4(address, port); }
+            return peerSocketAddress;
+        }
+
+        /**
+         * This method stores the address and port to which the socket
+         * is bound.  Only the port is stored for IPv6 sockets.  The
+         * caller must hold the mutex.
+         */
+        void RecordBoundAddress() {
+            struct sockaddr_storage address;
+            socklen_t addressLength = sizeof(address);
+            if (getsockname(sock, (struct sockaddr*)&address, &addressLength) != 0)
+            { return; }
+            if (address.ss_family == AF_INET)
+            {
+                const auto ipv4 = (const struct sockaddr_in*)&address;
+                boundAddress = ntohl(ipv4->sin_addr.s_addr);
+                boundPort = ntohs(ipv4->sin_port);
+            } else if (address.ss_family == AF_INET6)
+            { boundPort = ntohs(((const struct sockaddr_in6*)&address)->sin6_port); }
+        }
+
+        /**
+         * This method reads everything available from the socket and
+         * delivers it to the message received delegate.
+         *
+         * If there is a pool, data is read straight into a pooled buffer,
+         * as far as the size it kept from its last use goes, and only the
+         * rest is read into the loop thread's buffer and appended, so
+         * that pooled buffers are neither initialized nor copied into
+         * when reads are of similar sizes.
+         */
+        void Receive() {
+            auto& readBuffer = GetReadBuffer();
+            for (;;)
+            {
+                std::vector<uint8_t> buffer;
+                if (receiveBufferPool != nullptr)
+                {
+                    buffer = receiveBufferPool->Acquire();
+                    if (buffer.size() > MAXIMUM_READ_SIZE)
+                    { buffer.resize(MAXIMUM_READ_SIZE); }
+                }
+                struct iovec parts[2];
+                int partCount = 0;
+                if (!buffer.empty())
+                {
+                    parts[partCount].iov_base = buffer.data();
+                    parts[partCount].iov_len = buffer.size();
+                    ++partCount;
+                }
+                if (buffer.size() < MAXIMUM_READ_SIZE)
+                {
+                    parts[partCount].iov_base = readBuffer.data();
+                    parts[partCount].iov_len = MAXIMUM_READ_SIZE - buffer.size();
+                    ++partCount;
+                }
+                ssize_t amount;
+                int error;
+                {
+                    std::lock_guard<decltype(mutex)> lock(mutex);
+                    if (sock < 0)
+                    { return; }
+                    amount = readv(sock, parts, partCount);
+                    error = errno;
+                }
+                if (amount > 0)
+                {
+                    if ((size_t)amount <= buffer.size())
+                    {
+                        buffer.resize((size_t)amount);
+                    } else
+                    {
+                        buffer.insert(buffer.end(), readBuffer.data(),
+                                      readBuffer.data() + ((size_t)amount - buffer.size()));
+                    }
+                    Deliver(std::move(buffer));
+                    continue;
+                }
+                if (receiveBufferPool != nullptr)
+                { receiveBufferPool->Release(std::move(buffer)); }
+                if (amount == 0)
+                {
+                    diagnosticsSender->SendDiagnosticInformationString(
+                        1, "connection closed gracefully by peer");
+                    Shutdown(true);
+                } else if ((error != EAGAIN) && (error != EWOULDBLOCK) && (error != EINTR))
+                {
+                    diagnosticsSender->SendDiagnosticInformationFormatted(
+                        1, "connection closed abruptly by peer (%s)", strerror(error));
+                    Shutdown(false);
+                }
+                return;
+            }
+        }
+
+        /**
+         * This method delivers received data to the message received
+         * delegate, and then gives its buffer back to the pool if there
+         * is one.
+         *
+         * @param[in] buffer
+         *      This holds the received data.
+         */
+        void Deliver(std::vector<uint8_t>&& buffer) {
+            if (messageReceivedDelegate != nullptr)
+            { messageReceivedDelegate(buffer); }
+            if (receiveBufferPool != nullptr)
+            { receiveBufferPool->Release(std::move(buffer)); }
+        }
+
+        /**
+         * This method writes as much of the output queue as the socket
+         * accepts, gathering queued messages into as few writes as possible,
+         * and watches the socket for writability if any remains.
+         * The caller must hold the mutex.
+         */
+        void Flush() {
+            while (!outputQueue.empty() && (sock >= 0))
+            {
+                struct iovec vectors[MAXIMUM_GATHER_COUNT];
+                size_t count = 0;
+                for (auto message = outputQueue.begin();
+                     (message != outputQueue.end()) && (count < MAXIMUM_GATHER_COUNT);
+                     ++message, ++count)
+                {
+                    const auto& bytes = message->Bytes();
+                    const size_t offset = ((count == 0) ? outputOffset : 0);
+                    vectors[count].iov_base = (void*)(bytes.data() + offset);
+                    vectors[count].iov_len = bytes.size() - offset;
+                }
+                struct msghdr header;
+                (void)memset(&header, 0, sizeof(header));
+                header.msg_iov = vectors;
+                header.msg_iovlen = count;
+                const auto amount = sendmsg(sock, &header, MSG_NOSIGNAL);
+                if (amount < 0)
+                {
+                    if ((errno == EAGAIN) || (errno == EWOULDBLOCK) || (errno == EINTR))
+                    { break; }
+                    diagnosticsSender->SendDiagnosticInformationFormatted(
+                        SystemUtils::DiagnosticsSender::Levels::ERROR,
+                        "error sending message (%s)", strerror(errno));
+                    Shutdown(false);
+                    return;
+                }
+                Consume((size_t)amount);
+            }
+            if (sock < 0)
+            { return; }
+            WatchOutput(!outputQueue.empty());
+            if (outputQueue.empty() && closing)
+            { (void)shutdown(sock, SHUT_WR); }
+        }
+
+        /**
+         * This method removes the given number of written bytes from the
+         * front of the output queue.  The caller must hold the mutex.
+         *
+         * @param[in] amount
+         *      This is the number of bytes written.
+         */
+        void Consume(size_t amount) {
+            while (!outputQueue.empty())
+            {
+                const auto remaining = outputQueue.front().Bytes().size() - outputOffset;
+                if (remaining > amount)
+                {
+                    outputOffset += amount;
+                    return;
+                }
+                amount -= remaining;
+                outputQueue.pop_front();
+                outputOffset = 0;
+            }
+        }
+
+        /**
+         * This method starts or stops watching the socket for writability.
+         * The caller must hold the mutex.
+         *
+         * @param[in] watch
+         *      This indicates whether or not to watch for writability.
+         */
+        void WatchOutput(bool watch) {
+            if ((watch == watchingOutput) || (registration.id == 0))
+            { return; }
+            watchingOutput = watch;
+            (void)eventLoopPool->Modify(registration, sock,
+                                        EPOLLIN | EPOLLRDHUP | (watch ? (uint32_t)EPOLLOUT : 0));
+        }
+
+        /**
+         * This method closes the socket, if it is still open, and arranges
+         * for the broken delegate to be called from the loop thread.
+         *
+         * @param[in] graceful
+         *      This indicates whether or not the connection was
+         *      closed gracefully.
+         */
+        void Shutdown(bool graceful) {
+            std::lock_guard<decltype(mutex)> lock(mutex);
+            if (sock < 0)
+            { return; }
+            const bool processing = (registration.id != 0);
+            if (processing)
+            { eventLoopPool->Remove(registration, sock); }
+            RecordFastOpen();
+            (void)close(sock);
+            sock = -1;
+            outputQueue.clear();
+            BrokenDelegate delegate;
+            delegate.swap(brokenDelegate);
+            if (processing && (delegate != nullptr))
+            {
+                eventLoopPool->Post(registration.loop,
+                                    [delegate, graceful] { delegate(graceful); });
+            }
+            if (connecting)
+            {
+                connecting = false;
+                ConnectDelegate abandoned;
+                abandoned.swap(connectDelegate);
+                if (abandoned != nullptr)
+                { eventLoopPool->Post(registration.loop, [abandoned] { abandoned(false); }); }
+            }
+            registration = EventLoopPool::Registration();
+        }
+    };
+
+    ReactorNetworkConnection::~ReactorNetworkConnection() noexcept {
+        {
+            // The owner has let go of the connection, so it no longer
+            // expects to hear from it.
+            std::lock_guard<decltype(impl_->mutex)> lock(impl_->mutex);
+            impl_->brokenDelegate = nullptr;
+            impl_->connectDelegate = nullptr;
+        }
+        impl_->Shutdown(false);
+    }
+
+    ReactorNetworkConnection::ReactorNetworkConnection(
+        std::shared_ptr<EventLoopPool> eventLoopPool,
+        std::shared_ptr<ReceiveBufferPool> receiveBufferPool) :
+        impl_(std::make_shared<Impl>()) {
+        impl_->eventLoopPool = eventLoopPool;
+        impl_->receiveBufferPool = receiveBufferPool;
+    }
+
+    SystemUtils::DiagnosticsSender::UnsubscribeDelegate
+    ReactorNetworkConnection::SubscribeToDiagnostics(
+        SystemUtils::DiagnosticsSender::DiagnosticMessageDelegate delegate, size_t minLevel) {
+        return impl_->diagnosticsSender->SubscribeToDiagnostics(delegate, minLevel);
+    }
+
+    bool ReactorNetworkConnection::Connect(uint32_t peerAddress, uint16_t peerPort) {
+        std::lock_guard<decltype(impl_->mutex)> lock(impl_->mutex);
+        if (impl_->sock >= 0)
+        { return false; }
+        const auto address = impl_->TargetAddress(peerAddress, peerPort);
+        const int sock = socket(address.GetFamily(), SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (sock < 0)
+        {
+            impl_->diagnosticsSender->SendDiagnosticInformationFormatted(
+                SystemUtils::DiagnosticsSender::Levels::ERROR, "error creating socket (%s)",
+                strerror(errno));
+            return false;
+        }
+        impl_->SetUpFastOpen(sock, address);
+        if (connect(sock, address.Get(), address.length) != 0)
+        {
+            impl_->diagnosticsSender->SendDiagnosticInformationFormatted(
+                SystemUtils::DiagnosticsSender::Levels::ERROR, "error in connect (%s)",
+                strerror(errno));
+            (void)close(sock);
+            return false;
+        }
+        impl_->sock = sock;
+        impl_->peerAddress = peerAddress;
+        impl_->peerPort = peerPort;
+        impl_->RecordBoundAddress();
+        return true;
+    }
+
+    bool ReactorNetworkConnection::Process(MessageReceivedDelegate messageReceivedDelegate,
+                                           BrokenDelegate brokenDelegate) {
+        std::lock_guard<decltype(impl_->mutex)> lock(impl_->mutex);
+        if ((impl_->sock < 0) || (impl_->registration.id != 0))
+        { return false; }
+        const int flags = fcntl(impl_->sock, F_GETFL, 0);
+        if ((flags < 0) || (fcntl(impl_->sock, F_SETFL, flags | O_NONBLOCK) < 0))
+        {
+            impl_->diagnosticsSender->SendDiagnosticInformationFormatted(
+                SystemUtils::DiagnosticsSender::Levels::ERROR,
+                "error making socket non-blocking (%s)", strerror(errno));
+            return false;
+        }
+        impl_->messageReceivedDelegate = messageReceivedDelegate;
+        impl_->brokenDelegate = brokenDelegate;
+        std::weak_ptr<Impl> implWeak(impl_);
+        impl_->registration = impl_->eventLoopPool->Add(
+            impl_->sock, EPOLLIN | EPOLLRDHUP,
+            [implWeak](uint32_t events)
+            {
+                const auto impl = implWeak.lock();
+                if (impl != nullptr)
+                { impl->OnEvents(events); }
+            });
+        if (impl_->registration.id == 0)
+        {
+            impl_->diagnosticsSender->SendDiagnosticInformationString(
+                SystemUtils::DiagnosticsSender::Levels::ERROR,
+                "unable to register socket with event loop");
+            return false;
+        }
+        impl_->Flush();
+        return true;
+    }
+
+    uint32_t ReactorNetworkConnection::GetPeerAddress() const { return impl_->peerAddress; }
+
+    uint16_t ReactorNetworkConnection::GetPeerPort() const { return impl_->peerPort; }
+
+    bool ReactorNetworkConnection::IsConnected() const {
+        std::lock_guard<decltype(impl_->mutex)> lock(impl_->mutex);
+        return (impl_->sock >= 0);
+    }
+
+    uint32_t ReactorNetworkConnection::GetBoundAddress() const { return impl_->boundAddress; }
+
+    uint16_t ReactorNetworkConnection::GetBoundPort() const { return impl_->boundPort; }
+
+    void ReactorNetworkConnection::SendMessage(const std::vector<uint8_t>& message) {
+        SendMessage(OutgoingMessage(std::vector<uint8_t>(message)));
+    }
+
+    void ReactorNetworkConnection::SendMessage(OutgoingMessage&& message) {
+        std::lock_guard<decltype(impl_->mutex)> lock(impl_->mutex);
+        if ((impl_->sock < 0) || impl_->closing)
+        { return; }
+        impl_->outputQueue.push_back(std::move(message));
+        if ((impl_->registration.id == 0) || impl_->connecting)
+        { return; }
+        if (impl_->outputQueue.size() == 1)
+        { impl_->Flush(); }
+    }
+
+    void ReactorNetworkConnection::SendMessages(std::vector<OutgoingMessage>&& messages) {
+        std::lock_guard<decltype(impl_->mutex)> lock(impl_->mutex);
+        if ((impl_->sock < 0) || impl_->closing)
+        { return; }
+        const bool idle = impl_->outputQueue.empty();
+        for (auto& message : messages)
+        { impl_->outputQueue.push_back(std::move(message)); }
+        if ((impl_->registration.id != 0) && !impl_->connecting && idle)
+        { impl_->Flush(); }
+    }
+
+    void ReactorNetworkConnection::ConnectAsync(uint32_t peerAddress, uint16_t peerPort,
+                                                ConnectDelegate connectDelegate) {
+        std::unique_lock<decltype(impl_->mutex)> lock(impl_->mutex);
+        if (impl_->sock >= 0)
+        {
+            lock.unlock();
+            connectDelegate(false);
+            return;
+        }
+        const auto address = impl_->TargetAddress(peerAddress, peerPort);
+        const int sock = socket(address.GetFamily(), SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (sock < 0)
+        {
+            impl_->diagnosticsSender->SendDiagnosticInformationFormatted(
+                SystemUtils::DiagnosticsSender::Levels::ERROR, "error creating socket (%s)",
+                strerror(errno));
+            lock.unlock();
+            connectDelegate(false);
+            return;
+        }
+        impl_->SetUpFastOpen(sock, address);
+        impl_->sock = sock;
+        impl_->peerAddress = peerAddress;
+        impl_->peerPort = peerPort;
+        if (connect(sock, address.Get(), address.length) == 0)
+        {
+            impl_->RecordBoundAddress();
+            lock.unlock();
+            connectDelegate(true);
+            return;
+        }
+        if (errno == EINPROGRESS)
+        {
+            impl_->connecting = true;
+            impl_->connectDelegate = std::move(connectDelegate);
+            std::weak_ptr<Impl> implWeak(impl_);
+            impl_->registration = impl_->eventLoopPool->Add(
+                sock, EPOLLOUT,
+                [implWeak](uint32_t)
+                {
+                    const auto impl = implWeak.lock();
+                    if (impl != nullptr)
+                    { impl->OnConnectEvents(); }
+                });
+            if (impl_->registration.id != 0)
+            { return; }
+            impl_->connecting = false;
+            connectDelegate = std::move(impl_->connectDelegate);
+            impl_->connectDelegate = nullptr;
+            impl_->diagnosticsSender->SendDiagnosticInformationString(
+                SystemUtils::DiagnosticsSender::Levels::ERROR,
+                "unable to register socket with event loop");
+        } else
+        {
+            impl_->diagnosticsSender->SendDiagnosticInformationFormatted(
+                SystemUtils::DiagnosticsSender::Levels::ERROR, "error in connect (%s)",
+                strerror(errno));
+        }
+        (void)close(sock);
+        impl_->sock = -1;
+        lock.unlock();
+        connectDelegate(false);
+    }
+
+    void ReactorNetworkConnection::EnableFastOpen() {
+        std::lock_guard<decltype(impl_->mutex)> lock(impl_->mutex);
+        impl_->fastOpen = true;
+    }
+
+    bool ReactorNetworkConnection::UsedFastOpen() {
+        std::lock_guard<decltype(impl_->mutex)> lock(impl_->mutex);
+        impl_->RecordFastOpen();
+        return impl_->fastOpenUsed;
+    }
+
+    bool ReactorNetworkConnection::OffloadTlsTransmit(const std::vector<uint8_t>& cryptoInfo) {
+        std::lock_guard<decltype(impl_->mutex)> lock(impl_->mutex);
+        if ((impl_->sock < 0) || impl_->connecting || impl_->closing ||
+            !impl_->outputQueue.empty())
+        { return false; }
+        std::string error;
+        if (!EnableTransmit(impl_->sock, cryptoInfo, error))
+        {
+            impl_->diagnosticsSender->SendDiagnosticInformationFormatted(
+                SystemUtils::DiagnosticsSender::Levels::WARNING,
+                "unable to offload TLS encryption to kernel: %s", error.c_str());
+            return false;
+        }
+        return true;
+    }
+
+    void ReactorNetworkConnection::Close(bool clean) {
+        std::lock_guard<decltype(impl_->mutex)> lock(impl_->mutex);
+        if (clean && (impl_->registration.id != 0) && !impl_->connecting)
+        {
+            if (impl_->closing)
+            { return; }
+            impl_->closing = true;
+            impl_->Flush();
+        } else
+        { impl_->Shutdown(false); }
+    }
+
+    void ReactorNetworkConnection::SetPeerSocketAddress(const SocketAddress& address) {
+        std::lock_guard<decltype(impl_->mutex)> lock(impl_->mutex);
+        impl_->peerSocketAddress = address;
+    }
+
+    SocketAddress ReactorNetworkConnection::GetPeerSocketAddress() const {
+        std::lock_guard<decltype(impl_->mutex)> lock(impl_->mutex);
+        return impl_->peerSocketAddress;
+    }
+}  // namespace MqttNetworkTransport
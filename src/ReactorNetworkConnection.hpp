@@ -0,0 +1,115 @@
+#ifndef MQTT_NETWORK_TRANSPORT_REACTOR_NETWORK_CONNECTION_HPP
+#define MQTT_NETWORK_TRANSPORT_REACTOR_NETWORK_CONNECTION_HPP
+/**
+ * @file ReactorNetworkConnection.hpp
+ *
+ * This module declares the MqttNetworkTransport::ReactorNetworkConnection
+ * class.
+ *
+ * © 2025 by Hatem Nabli
+ */
+
+#include "AsyncNetworkConnection.hpp"
+#include "FastOpenConnection.hpp"
+#include "KernelTlsConnection.hpp"
+#include "EventLoopPool.hpp"
+#include "ReceiveBufferPool.hpp"
+#include "SocketAddressConnection.hpp"
+#include <memory>
+
+namespace MqttNetworkTransport
+{
+    /**
+     * This is an implementation of SystemUtils::INetworkConnection whose
+     * socket is serviced by one of the loops of a shared EventLoopPool,
+     * rather than by a processing worker of its own.  Queued outgoing
+     * messages are gathered into as few writes as possible.
+     */
+    class ReactorNetworkConnection : public AsyncNetworkConnection,
+                                     public FastOpenConnection,
+                                     public KernelTlsConnection,
+                                     public SocketAddressConnection
+    {
+        // Lifecycle management
+    public:
+        ~ReactorNetworkConnection() noexcept;
+        ReactorNetworkConnection(const ReactorNetworkConnection&) = delete;
+        ReactorNetworkConnection(ReactorNetworkConnection&&) noexcept = delete;
+        ReactorNetworkConnection& operator=(const ReactorNetworkConnection&) = delete;
+        ReactorNetworkConnection& operator=(ReactorNetworkConnection&&) noexcept = delete;
+
+        // Public methods
+    public:
+        /**
+         * This is the constructor.
+         *
+         * @param[in] eventLoopPool
+         *      This is the pool of event loops which will service
+         *      the connection once it is processing.
+         * @param[in] receiveBufferPool
+         *      If not null, this is where to take the buffers in which
+         *      received data is delivered, and where they are given
+         *      back once delivered.
+         */
+        ReactorNetworkConnection(std::shared_ptr<EventLoopPool> eventLoopPool,
+                               std::shared_ptr<ReceiveBufferPool> receiveBufferPool = nullptr);
+
+        // SystemUtils::INetworkConnection
+    public:
+        virtual SystemUtils::DiagnosticsSender::UnsubscribeDelegate SubscribeToDiagnostics(
+            SystemUtils::DiagnosticsSender::DiagnosticMessageDelegate delegate,
+            size_t minLevel = 0) override;
+        virtual bool Connect(uint32_t peerAddress, uint16_t peerPort) override;
+        virtual bool Process(MessageReceivedDelegate messageReceivedDelegate,
+                             BrokenDelegate brokenDelegate) override;
+        virtual uint32_t GetPeerAddress() const override;
+        virtual uint16_t GetPeerPort() const override;
+        virtual bool IsConnected() const override;
+        virtual uint32_t GetBoundAddress() const override;
+        virtual uint16_t GetBoundPort() const override;
+        virtual void SendMessage(const std::vector<uint8_t>& message) override;
+        virtual void Close(bool clean = false) override;
+
+        // GatherNetworkConnection
+    public:
+        virtual void SendMessage(OutgoingMessage&& message) override;
+        virtual void SendMessages(std::vector<OutgoingMessage>&& messages) override;
+
+        // AsyncNetworkConnection
+    public:
+        virtual void ConnectAsync(uint32_t peerAddress, uint16_t peerPort,
+                                  ConnectDelegate connectDelegate) override;
+
+        // FastOpenConnection
+    public:
+        virtual void EnableFastOpen() override;
+        virtual bool UsedFastOpen() override;
+
+        // KernelTlsConnection
+    public:
+        virtual bool OffloadTlsTransmit(const std::vector<uint8_t>& cryptoInfo) override;
+
+        // SocketAddressConnection
+    public:
+        virtual void SetPeerSocketAddress(const SocketAddress& address) override;
+        virtual SocketAddress GetPeerSocketAddress() const override;
+
+        // Private properties
+    private:
+        /**
+         * This is the type of structure that contains the private
+         * properties of the instance.  It is defined in the implementation
+         * and declared here to ensure that it is scoped inside the class.
+         */
+        struct Impl;
+
+        /**
+         * This contains the private properties of the instance.  It is
+         * shared with the event loop, which may still be dispatching an
+         * event for the connection while the connection is destroyed.
+         */
+        std::shared_ptr<Impl> impl_;
+    };
+}  // namespace MqttNetworkTransport
+
+#endif /** MQTT_NETWORK_TRANSPORT_REACTOR_NETWORK_CONNECTION_HPP */
@@ -0,0 +1,304 @@
+/**
+ * @file ReceiveBufferPool.cpp
+ *
+ * This module implements the MqttNetworkTransport::ReceiveBufferPool class.
+ *
+ * © 2025 by Hatem Nabli
+ */
+
+#include "ReceiveBufferPool.hpp"
+#include <algorithm>
+#include <atomic>
+#include <inttypes.h>
+#include <mutex>
+
+namespace
+{
+    /**
+     * This is the most buffers each thread using a pool keeps of its own.
+     */
+    constexpr size_t THREAD_BUFFERS = 16;
+
+    /**
+     * This is used to give each pool an identifier, by which threads
+     * find the buffers they keep for it.  Identifiers aren't reused.
+     */
+    std::atomic<uint64_t> nextPoolId{1};
+}  // namespace
+
+namespace MqttNetworkTransport
+{
+    struct ReceiveBufferPool::Impl : public std::enable_shared_from_this<Impl>
+    {
+        /**
+         * This holds the buffers one thread keeps of its own.
+         */
+        struct ThreadList
+        {
+            /**
+             * These are the buffers available for reuse.  Only the thread
+             * owning the list touches them while the pool is in use.
+             */
+            std::vector<std::vector<uint8_t>> buffers;
+
+            /**
+             * This is the number of buffers handed out from the list.
+             */
+            std::atomic<uint64_t> hits{0};
+
+            /**
+             * This is the number of buffers in the list.
+             */
+            std::atomic<size_t> pooled{0};
+        };
+
+        /**
+         * This holds the lists a thread keeps, one for each pool it uses,
+         * and hands them back to their pools when the thread exits.
+         */
+        struct ThreadLists
+        {
+            /**
+             * This pairs a list with the pool for which it is kept.
+             */
+            struct Entry
+            {
+                uint64_t poolId = 0;
+                std::weak_ptr<Impl> pool;
+                std::shared_ptr<ThreadList> list;
+            };
+
+            /**
+             * These are the lists kept by the thread.
+             */
+            std::vector<Entry> entries;
+
+            ~ThreadLists() noexcept {
+                for (const auto& entry : entries)
+                {
+                    const auto pool = entry.pool.lock();
+                    if (pool != nullptr)
+                    { pool->Retire(entry.list); }
+                }
+            }
+        };
+
+        /**
+         * These are the lists kept by the calling thread.
+         */
+        static thread_local ThreadLists threadLists;
+
+        /**
+         * This identifies the pool in the lists kept by threads.
+         */
+        const uint64_t id = nextPoolId++;
+
+        /**
+         * This is the most buffers the shared overflow keeps.
+         */
+        size_t maximumBuffers = 0;
+
+        /**
+         * This is the most buffers each thread keeps of its own.
+         */
+        size_t threadBuffers = 0;
+
+        /**
+         * This is the number of buffers moved at once between
+         * a thread's list and the shared overflow.
+         */
+        size_t transferBuffers = 0;
+
+        /**
+         * This is used to report the counters of the pool, if not nullptr.
+         */
+        std::shared_ptr<SystemUtils::DiagnosticsSender> diagnosticsSender;
+
+        /**
+         * This is used to synchronize access to the shared overflow,
+         * the registered thread lists, and the counters below.
+         */
+        mutable std::mutex mutex;
+
+        /**
+         * These are the buffers available for reuse by any thread.
+         */
+        std::vector<std::vector<uint8_t>> overflow;
+
+        /**
+         * These are the lists kept by the threads using the pool.
+         */
+        std::vector<std::shared_ptr<ThreadList>> lists;
+
+        /**
+         * This is the number of buffers handed out from the lists
+         * of threads which have since exited.
+         */
+        uint64_t retiredHits = 0;
+
+        /**
+         * This is the number of buffers newly made because
+         * the pool was empty.
+         */
+        uint64_t misses = 0;
+
+        /**
+         * This is the number of misses at which the counters
+         * of the pool are next reported.
+         */
+        uint64_t nextMissReport = 1;
+
+        ~Impl() noexcept {
+            // Nothing uses the pool anymore, so the buffers the threads
+            // still keep for it can be freed.
+            for (const auto& list : lists)
+            {
+                list->buffers.clear();
+                list->buffers.shrink_to_fit();
+            }
+        }
+
+        /**
+         * This method returns the list the calling thread keeps
+         * for the pool, registering a new one if there is none yet.
+         *
+         * @return
+         *      The calling thread's list is returned.
+         */
+        ThreadList& GetThreadList() {
+            auto& entries = threadLists.entries;
+            for (const auto& entry : entries)
+            {
+                if (entry.poolId == id)
+                { return *entry.list; }
+            }
+            entries.erase(std::remove_if(entries.begin(), entries.end(),
+                                         [](const ThreadLists::Entry& entry)
+                                         { return entry.pool.expired(); }),
+                          entries.end());
+            ThreadLists::Entry entry;
+            entry.poolId = id;
+            entry.pool = shared_from_this();
+            entry.list = std::make_shared<ThreadList>();
+            entry.list->buffers.reserve(threadBuffers);
+            {
+                std::lock_guard<decltype(mutex)> lock(mutex);
+                lists.push_back(entry.list);
+            }
+            entries.push_back(entry);
+            return *entries.back().list;
+        }
+
+        /**
+         * This method takes back the buffers and counters of the list
+         * of a thread which is exiting.
+         *
+         * @param[in] list
+         *      This is the list to take back.
+         */
+        void Retire(const std::shared_ptr<ThreadList>& list) {
+            std::lock_guard<decltype(mutex)> lock(mutex);
+            retiredHits += list->hits;
+            for (auto& buffer : list->buffers)
+            {
+                if (overflow.size() < maximumBuffers)
+                { overflow.push_back(std::move(buffer)); }
+            }
+            list->buffers.clear();
+            list->pooled = 0;
+            lists.erase(std::remove(lists.begin(), lists.end(), list), lists.end());
+        }
+
+        /**
+         * This method returns the counters of the pool.
+         * The caller must hold the mutex.
+         *
+         * @return
+         *      The statistics of the pool are returned.
+         */
+        Statistics Count() const {
+            Statistics statistics;
+            statistics.hits = retiredHits;
+            statistics.misses = misses;
+            statistics.pooled = overflow.size();
+            for (const auto& list : lists)
+            {
+                statistics.hits += list->hits;
+                statistics.pooled += list->pooled;
+            }
+            return statistics;
+        }
+    };
+
+    thread_local ReceiveBufferPool::Impl::ThreadLists ReceiveBufferPool::Impl::threadLists;
+
+    ReceiveBufferPool::~ReceiveBufferPool() noexcept = default;
+
+    ReceiveBufferPool::ReceiveBufferPool(
+        size_t maximumBuffers, std::shared_ptr<SystemUtils::DiagnosticsSender> diagnosticsSender) :
+        impl_(std::make_shared<Impl>()) {
+        impl_->maximumBuffers = maximumBuffers;
+        impl_->threadBuffers = std::min(THREAD_BUFFERS, maximumBuffers);
+        impl_->transferBuffers = std::max((size_t)1, impl_->threadBuffers / 2);
+        impl_->diagnosticsSender = diagnosticsSender;
+        impl_->overflow.reserve(maximumBuffers);
+    }
+
+    std::vector<uint8_t> ReceiveBufferPool::Acquire() {
+        std::vector<uint8_t> buffer;
+        auto& list = impl_->GetThreadList();
+        if (list.buffers.empty())
+        {
+            std::unique_lock<decltype(impl_->mutex)> lock(impl_->mutex);
+            while (!impl_->overflow.empty() && (list.buffers.size() < impl_->transferBuffers))
+            {
+                list.buffers.push_back(std::move(impl_->overflow.back()));
+                impl_->overflow.pop_back();
+            }
+            if (list.buffers.empty())
+            {
+                if (++impl_->misses < impl_->nextMissReport)
+                { return buffer; }
+                impl_->nextMissReport *= 2;
+                const auto statistics = impl_->Count();
+                lock.unlock();
+                if (impl_->diagnosticsSender != nullptr)
+                {
+                    impl_->diagnosticsSender->SendDiagnosticInformationFormatted(
+                        1,
+                        "receive buffer pool: %" PRIu64 " hits, %" PRIu64 " misses, %zu pooled",
+                        statistics.hits, statistics.misses, statistics.pooled);
+                }
+                return buffer;
+            }
+        }
+        ++list.hits;
+        buffer.swap(list.buffers.back());
+        list.buffers.pop_back();
+        list.pooled = list.buffers.size();
+        return buffer;
+    }
+
+    void ReceiveBufferPool::Release(std::vector<uint8_t>&& buffer) {
+        if (impl_->threadBuffers == 0)
+        { return; }
+        auto& list = impl_->GetThreadList();
+        if (list.buffers.size() >= impl_->threadBuffers)
+        {
+            std::lock_guard<decltype(impl_->mutex)> lock(impl_->mutex);
+            for (size_t i = 0; i < impl_->transferBuffers; ++i)
+            {
+                if (impl_->overflow.size() < impl_->maximumBuffers)
+                { impl_->overflow.push_back(std::move(list.buffers.back())); }
+                list.buffers.pop_back();
+            }
+        }
+        list.buffers.push_back(std::move(buffer));
+        list.pooled = list.buffers.size();
+    }
+
+    auto ReceiveBufferPool::GetStatistics() const -> Statistics {
+        std::lock_guard<decltype(impl_->mutex)> lock(impl_->mutex);
+        return impl_->Count();
+    }
+}  // namespace MqttNetworkTransport
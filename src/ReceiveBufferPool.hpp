@@ -0,0 +1,123 @@
+#ifndef MQTT_NETWORK_TRANSPORT_RECEIVE_BUFFER_POOL_HPP
+#define MQTT_NETWORK_TRANSPORT_RECEIVE_BUFFER_POOL_HPP
+/**
+ * @file ReceiveBufferPool.hpp
+ *
+ * This module declares the MqttNetworkTransport::ReceiveBufferPool class.
+ *
+ * © 2025 by Hatem Nabli
+ */
+
+#include <memory>
+#include <vector>
+#include <stddef.h>
+#include <stdint.h>
+#include <SystemUtils/DiagnosticsSender.hpp>
+
+namespace MqttNetworkTransport
+{
+    /**
+     * This keeps the buffers in which received data is delivered, so that
+     * they can be reused, with their capacity, for later reads rather than
+     * being allocated and freed for every read.
+     *
+     * Each thread using the pool keeps a few buffers of its own, which it
+     * hands out and takes back without synchronizing with other threads.
+     * Only when a thread runs out of buffers, or has too many, does it
+     * move a batch of them from or to a shared overflow.
+     */
+    class ReceiveBufferPool
+    {
+    public:
+        /**
+         * This holds counters describing how well the pool is used.
+         */
+        struct Statistics
+        {
+            /**
+             * This is the number of buffers handed out from the pool.
+             */
+            uint64_t hits = 0;
+
+            /**
+             * This is the number of buffers newly made because
+             * the pool was empty.
+             */
+            uint64_t misses = 0;
+
+            /**
+             * This is the number of buffers currently in the pool,
+             * including those kept by the threads using it.
+             */
+            size_t pooled = 0;
+        };
+
+        // Lifecycle management
+    public:
+        ~ReceiveBufferPool() noexcept;
+        ReceiveBufferPool(const ReceiveBufferPool&) = delete;
+        ReceiveBufferPool(ReceiveBufferPool&&) noexcept = delete;
+        ReceiveBufferPool& operator=(const ReceiveBufferPool&) = delete;
+        ReceiveBufferPool& operator=(ReceiveBufferPool&&) noexcept = delete;
+
+        // Public methods
+    public:
+        /**
+         * This is the constructor.
+         *
+         * @param[in] maximumBuffers
+         *      This is the most buffers the shared overflow keeps.  Buffers
+         *      moved to it while it is full are freed.  Each thread using
+         *      the pool also keeps a few buffers of its own.
+         * @param[in] diagnosticsSender
+         *      If not nullptr, this is used to report the counters of the
+         *      pool each time the number of misses doubles.
+         */
+        explicit ReceiveBufferPool(
+            size_t maximumBuffers,
+            std::shared_ptr<SystemUtils::DiagnosticsSender> diagnosticsSender = nullptr);
+
+        /**
+         * This method hands out a buffer, reusing a pooled one if there
+         * is any.  A reused buffer keeps the size it was given back with,
+         * so that data can be read straight into it without it being
+         * initialized again; its contents are stale.
+         *
+         * @return
+         *      A buffer, empty unless it was reused, is returned.
+         */
+        std::vector<uint8_t> Acquire();
+
+        /**
+         * This method gives a buffer back to the pool.
+         *
+         * @param[in] buffer
+         *      This is the buffer to give back.
+         */
+        void Release(std::vector<uint8_t>&& buffer);
+
+        /**
+         * This method returns the counters of the pool.
+         *
+         * @return
+         *      The statistics of the pool are returned.
+         */
+        Statistics GetStatistics() const;
+
+        // Private properties
+    private:
+        /**
+         * This is the type of structure that contains the private
+         * properties of the instance.  It is defined in the implementation
+         * and declared here to ensure that it is scoped inside the class.
+         */
+        struct Impl;
+
+        /**
+         * This contains the private properties of the instance.
+         */
+        std::shared_ptr<Impl> impl_;
+    };
+}  // namespace MqttNetworkTransport
+
+#endif /** MQTT_NETWORK_TRANSPORT_RECEIVE_BUFFER_POOL_HPP */
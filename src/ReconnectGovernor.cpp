@@ -0,0 +1,148 @@
+/**
+ * @file ReconnectGovernor.cpp
+ *
+ * This module implements the MqttNetworkTransport::ReconnectGovernor class.
+ *
+ * © 2025 by Hatem Nabli
+ */
+
+#include "ReconnectGovernor.hpp"
+#include <algorithm>
+#include <map>
+#include <mutex>
+#include <random>
+
+namespace
+{
+    /**
+     * This holds the backoff of one endpoint.
+     */
+    struct Backoff
+    {
+        /**
+         * This is the backoff last picked for the endpoint.
+         */
+        std::chrono::steady_clock::duration sleep{0};
+
+        /**
+         * This is when the last failure of the endpoint was recorded.
+         */
+        std::chrono::steady_clock::time_point failedAt;
+
+        /**
+         * This is when attempts to the endpoint may start again.
+         */
+        std::chrono::steady_clock::time_point until;
+    };
+}  // namespace
+
+namespace MqttNetworkTransport
+{
+    struct ReconnectGovernor::Impl
+    {
+        /**
+         * This is used to synchronize access to the governor.
+         */
+        mutable std::mutex mutex;
+
+        /**
+         * These are the current settings of the governor.
+         */
+        Settings settings;
+
+        /**
+         * These are the backoffs of the endpoints whose
+         * last attempt failed, keyed by endpoint.
+         */
+        std::map<std::string, Backoff> backoffs;
+
+        /**
+         * This is the theoretical arrival time of the next attempt, as
+         * the token bucket is kept in the form of the generic cell rate
+         * algorithm: an attempt may start once this time, less the
+         * time taken to fill the bucket, has come.
+         */
+        std::chrono::steady_clock::time_point nextArrival;
+
+        /**
+         * This is used to pick backoffs at random.
+         */
+        std::mt19937 generator{std::random_device()()};
+
+        /**
+         * These are the counters of the governor.
+         */
+        Statistics statistics;
+    };
+
+    ReconnectGovernor::~ReconnectGovernor() noexcept = default;
+
+    ReconnectGovernor::ReconnectGovernor() : impl_(new Impl) {}
+
+    void ReconnectGovernor::Configure(const Settings& settings) {
+        std::lock_guard<decltype(impl_->mutex)> lock(impl_->mutex);
+        impl_->settings = settings;
+        if (settings.backoffBase.count() == 0)
+        { impl_->backoffs.clear(); }
+    }
+
+    std::chrono::steady_clock::time_point ReconnectGovernor::Admit(
+        const std::string& endpoint, std::chrono::steady_clock::time_point now) {
+        std::lock_guard<decltype(impl_->mutex)> lock(impl_->mutex);
+        auto start = now;
+        const auto backoff = impl_->backoffs.find(endpoint);
+        if ((backoff != impl_->backoffs.end()) && (backoff->second.until > start))
+        {
+            start = backoff->second.until;
+            ++impl_->statistics.backedOff;
+        }
+        if (impl_->settings.attemptsPerSecond != 0)
+        {
+            const auto interval = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                std::chrono::seconds(1)) /
+                impl_->settings.attemptsPerSecond;
+            const auto tolerance =
+                interval * (std::max<unsigned>(1, impl_->settings.burst) - 1);
+            const auto arrival = std::max(impl_->nextArrival, start);
+            if (arrival - tolerance > start)
+            {
+                start = arrival - tolerance;
+                ++impl_->statistics.rateLimited;
+            }
+            impl_->nextArrival = arrival + interval;
+        }
+        impl_->statistics.delayMicroseconds +=
+            (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(start - now).count();
+        return start;
+    }
+
+    void ReconnectGovernor::RecordSuccess(const std::string& endpoint) {
+        std::lock_guard<decltype(impl_->mutex)> lock(impl_->mutex);
+        (void)impl_->backoffs.erase(endpoint);
+    }
+
+    void ReconnectGovernor::RecordFailure(const std::string& endpoint,
+                                          std::chrono::steady_clock::time_point started,
+                                          std::chrono::steady_clock::time_point now) {
+        std::lock_guard<decltype(impl_->mutex)> lock(impl_->mutex);
+        if (impl_->settings.backoffBase.count() == 0)
+        { return; }
+        auto& backoff = impl_->backoffs[endpoint];
+        if ((backoff.sleep.count() != 0) && (started < backoff.failedAt))
+        { return; }
+        const std::chrono::steady_clock::duration base = impl_->settings.backoffBase;
+        const std::chrono::steady_clock::duration cap =
+            std::max(impl_->settings.backoffCap, impl_->settings.backoffBase);
+        const auto upper = std::max(base, backoff.sleep * 3);
+        std::uniform_int_distribution<std::chrono::steady_clock::rep> pick(base.count(),
+                                                                           upper.count());
+        backoff.sleep = std::min(cap, std::chrono::steady_clock::duration(pick(impl_->generator)));
+        backoff.failedAt = now;
+        backoff.until = now + backoff.sleep;
+    }
+
+    auto ReconnectGovernor::GetStatistics() const -> Statistics {
+        std::lock_guard<decltype(impl_->mutex)> lock(impl_->mutex);
+        return impl_->statistics;
+    }
+}  // namespace MqttNetworkTransport
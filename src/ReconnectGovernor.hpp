@@ -0,0 +1,178 @@
+#ifndef MQTT_NETWORK_TRANSPORT_RECONNECT_GOVERNOR_HPP
+#define MQTT_NETWORK_TRANSPORT_RECONNECT_GOVERNOR_HPP
+/**
+ * @file ReconnectGovernor.hpp
+ *
+ * This module declares the MqttNetworkTransport::ReconnectGovernor class.
+ *
+ * © 2025 by Hatem Nabli
+ */
+
+#include <chrono>
+#include <memory>
+#include <stdint.h>
+#include <string>
+
+namespace MqttNetworkTransport
+{
+    /**
+     * This decides when connect attempts may start, so that a crowd of
+     * clients reconnecting at once neither hammers a broker which is down
+     * nor knocks over one which has just come back up.
+     *
+     * After an attempt to connect to an endpoint fails, later attempts to
+     * it wait for a backoff with decorrelated jitter: each backoff is
+     * picked at random between the base and three times the one before
+     * it, up to the cap.  A successful attempt clears the backoff.
+     *
+     * Independently, attempts to all endpoints draw from a token bucket,
+     * which lets a burst of attempts start at once and then meters
+     * the rest out at a steady rate.  Attempts aren't refused; each is
+     * told how long to wait before starting, and the slot it waits for
+     * is reserved for it.
+     */
+    class ReconnectGovernor
+    {
+    public:
+        /**
+         * This holds the settings of the governor.
+         */
+        struct Settings
+        {
+            /**
+             * This is the rate at which tokens are added to the bucket,
+             * in attempts per second, or zero not to limit the rate.
+             */
+            unsigned attemptsPerSecond = 0;
+
+            /**
+             * This is the number of tokens the bucket holds, which is
+             * the number of attempts which may start at once.
+             */
+            unsigned burst = 1;
+
+            /**
+             * These are the least and greatest backoffs before another
+             * attempt to an endpoint whose last attempt failed.  A base
+             * of zero turns backoff off.
+             */
+            std::chrono::milliseconds backoffBase{0};
+            std::chrono::milliseconds backoffCap{0};
+        };
+
+        /**
+         * This holds counters describing the work of the governor.
+         */
+        struct Statistics
+        {
+            /**
+             * This is the number of attempts which had to wait for
+             * the backoff of their endpoint.
+             */
+            uint64_t backedOff = 0;
+
+            /**
+             * This is the number of attempts which had to wait for
+             * a token from the bucket.
+             */
+            uint64_t rateLimited = 0;
+
+            /**
+             * This is the total time, in microseconds,
+             * attempts were told to wait.
+             */
+            uint64_t delayMicroseconds = 0;
+        };
+
+        // Lifecycle management
+    public:
+        ~ReconnectGovernor() noexcept;
+        ReconnectGovernor(const ReconnectGovernor&) = delete;
+        ReconnectGovernor(ReconnectGovernor&&) noexcept = delete;
+        ReconnectGovernor& operator=(const ReconnectGovernor&) = delete;
+        ReconnectGovernor& operator=(ReconnectGovernor&&) noexcept = delete;
+
+        // Public methods
+    public:
+        /**
+         * This is the default constructor.
+         */
+        ReconnectGovernor();
+
+        /**
+         * This method changes the settings of the governor.  The backoffs
+         * already under way, and the attempts already admitted,
+         * are not affected.
+         *
+         * @param[in] settings
+         *      These are the settings to apply.
+         */
+        void Configure(const Settings& settings);
+
+        /**
+         * This method admits an attempt to connect to the given endpoint,
+         * returning how long it must wait before it starts.
+         *
+         * @param[in] endpoint
+         *      This identifies the endpoint to which to connect.
+         * @param[in] now
+         *      This is the current time.
+         * @return
+         *      The time at which the attempt may start is returned.
+         *      It is never earlier than the given current time.
+         */
+        std::chrono::steady_clock::time_point Admit(const std::string& endpoint,
+                                                    std::chrono::steady_clock::time_point now);
+
+        /**
+         * This method records that an attempt to connect to the given
+         * endpoint succeeded, clearing its backoff.
+         *
+         * @param[in] endpoint
+         *      This identifies the endpoint to which the attempt was made.
+         */
+        void RecordSuccess(const std::string& endpoint);
+
+        /**
+         * This method records that an attempt to connect to the given
+         * endpoint failed, backing it off further, unless a failure was
+         * already recorded for it after the attempt started.  This keeps
+         * a crowd of attempts which fail together from growing the
+         * backoff more than one failure would.
+         *
+         * @param[in] endpoint
+         *      This identifies the endpoint to which the attempt was made.
+         * @param[in] started
+         *      This is when the attempt started.
+         * @param[in] now
+         *      This is the current time.
+         */
+        void RecordFailure(const std::string& endpoint,
+                           std::chrono::steady_clock::time_point started,
+                           std::chrono::steady_clock::time_point now);
+
+        /**
+         * This method returns the counters of the governor.
+         *
+         * @return
+         *      The statistics of the governor are returned.
+         */
+        Statistics GetStatistics() const;
+
+        // Private properties
+    private:
+        /**
+         * This is the type of structure that contains the private
+         * properties of the instance.  It is defined in the implementation
+         * and declared here to ensure that it is scoped inside the class.
+         */
+        struct Impl;
+
+        /**
+         * This contains the private properties of the instance.
+         */
+        std::unique_ptr<Impl> impl_;
+    };
+}  // namespace MqttNetworkTransport
+
+#endif /** MQTT_NETWORK_TRANSPORT_RECONNECT_GOVERNOR_HPP */
@@ -0,0 +1,1219 @@
+/**
+ * @file ResumingConnection.cpp
+ *
+ * This module implements the MqttNetworkTransport::ResumingConnection class.
+ *
+ * © 2025 by Hatem Nabli
+ */
+
+#include "ResumingConnection.hpp"
+#include "PacketFramer.hpp"
+#include <algorithm>
+#include <deque>
+#include <mutex>
+
+namespace
+{
+    /**
+     * These are the types of MQTT control packets the connection
+     * looks into, to follow the state of the session.
+     */
+    constexpr uint8_t PACKET_TYPE_CONNECT = 1;
+    constexpr uint8_t PACKET_TYPE_CONNACK = 2;
+    constexpr uint8_t PACKET_TYPE_PUBLISH = 3;
+    constexpr uint8_t PACKET_TYPE_PUBACK = 4;
+    constexpr uint8_t PACKET_TYPE_PUBREC = 5;
+    constexpr uint8_t PACKET_TYPE_PUBREL = 6;
+    constexpr uint8_t PACKET_TYPE_PUBCOMP = 7;
+    constexpr uint8_t PACKET_TYPE_DISCONNECT = 14;
+
+    /**
+     * This is the protocol version of MQTT 5.0, the only
+     * one whose sessions are resumed.
+     */
+    constexpr uint8_t PROTOCOL_VERSION_5 = 5;
+
+    /**
+     * This is the bit of the connect flags of CONNECT which asks the
+     * broker to discard any session it has for the client.
+     */
+    constexpr uint8_t CONNECT_FLAG_CLEAN_START = 0x02;
+
+    /**
+     * This is the bit of the acknowledge flags of CONNACK which
+     * tells that the broker resumed the session of the client.
+     */
+    constexpr uint8_t CONNACK_FLAG_SESSION_PRESENT = 0x01;
+
+    /**
+     * This is the bit of the fixed header of PUBLISH which marks
+     * a packet sent again.
+     */
+    constexpr uint8_t PUBLISH_FLAG_DUP = 0x08;
+
+    /**
+     * These are the identifiers of the properties CONNECT
+     * and CONNACK may carry.
+     */
+    constexpr uint8_t PROPERTY_SESSION_EXPIRY_INTERVAL = 0x11;
+    constexpr uint8_t PROPERTY_ASSIGNED_CLIENT_IDENTIFIER = 0x12;
+    constexpr uint8_t PROPERTY_SERVER_KEEP_ALIVE = 0x13;
+    constexpr uint8_t PROPERTY_AUTHENTICATION_METHOD = 0x15;
+    constexpr uint8_t PROPERTY_AUTHENTICATION_DATA = 0x16;
+    constexpr uint8_t PROPERTY_REQUEST_PROBLEM_INFORMATION = 0x17;
+    constexpr uint8_t PROPERTY_REQUEST_RESPONSE_INFORMATION = 0x19;
+    constexpr uint8_t PROPERTY_RESPONSE_INFORMATION = 0x1A;
+    constexpr uint8_t PROPERTY_SERVER_REFERENCE = 0x1C;
+    constexpr uint8_t PROPERTY_REASON_STRING = 0x1F;
+    constexpr uint8_t PROPERTY_RECEIVE_MAXIMUM = 0x21;
+    constexpr uint8_t PROPERTY_TOPIC_ALIAS_MAXIMUM = 0x22;
+    constexpr uint8_t PROPERTY_MAXIMUM_QOS = 0x24;
+    constexpr uint8_t PROPERTY_RETAIN_AVAILABLE = 0x25;
+    constexpr uint8_t PROPERTY_USER_PROPERTY = 0x26;
+    constexpr uint8_t PROPERTY_MAXIMUM_PACKET_SIZE = 0x27;
+    constexpr uint8_t PROPERTY_WILDCARD_SUBSCRIPTION_AVAILABLE = 0x28;
+    constexpr uint8_t PROPERTY_SUBSCRIPTION_IDENTIFIER_AVAILABLE = 0x29;
+    constexpr uint8_t PROPERTY_SHARED_SUBSCRIPTION_AVAILABLE = 0x2A;
+
+    /**
+     * This is the Receive Maximum in effect when CONNACK doesn't give one.
+     */
+    constexpr uint16_t DEFAULT_RECEIVE_MAXIMUM = 65535;
+
+    /**
+     * This is the most bytes a Variable Byte Integer may be encoded in.
+     */
+    constexpr size_t MAXIMUM_VARIABLE_BYTE_INTEGER_BYTES = 4;
+
+    /**
+     * This function reads the Variable Byte Integer at the given offset
+     * of the given packet, moving the offset past it.
+     *
+     * @param[in] packet
+     *      This is the encoded MQTT control packet.
+     * @param[in,out] offset
+     *      This is the offset of the integer within the packet.
+     * @param[out] value
+     *      This is where to store the value of the integer.
+     * @return
+     *      An indication of whether or not the integer
+     *      could be read is returned.
+     */
+    bool ReadVariableByteInteger(const std::vector<uint8_t>& packet, size_t& offset,
+                                 size_t& value) {
+        value = 0;
+        for (size_t i = 0; i < MAXIMUM_VARIABLE_BYTE_INTEGER_BYTES; ++i)
+        {
+            if (offset >= packet.size())
+            { return false; }
+            const uint8_t encoded = packet[offset++];
+            value |= ((size_t)(encoded & 0x7F) << (7 * i));
+            if ((encoded & 0x80) == 0)
+            { return true; }
+        }
+        return false;
+    }
+
+    /**
+     * This function reads the Two Byte Integer at the given offset
+     * of the given packet, moving the offset past it.
+     *
+     * @param[in] packet
+     *      This is the encoded MQTT control packet.
+     * @param[in,out] offset
+     *      This is the offset of the integer within the packet.
+     * @param[out] value
+     *      This is where to store the value of the integer.
+     * @return
+     *      An indication of whether or not the integer
+     *      could be read is returned.
+     */
+    bool ReadTwoByteInteger(const std::vector<uint8_t>& packet, size_t& offset,
+                            uint16_t& value) {
+        if (packet.size() - std::min(offset, packet.size()) < 2)
+        { return false; }
+        value = (uint16_t)((packet[offset] << 8) | packet[offset + 1]);
+        offset += 2;
+        return true;
+    }
+
+    /**
+     * This function reads the Four Byte Integer at the given offset
+     * of the given packet, moving the offset past it.
+     *
+     * @param[in] packet
+     *      This is the encoded MQTT control packet.
+     * @param[in,out] offset
+     *      This is the offset of the integer within the packet.
+     * @param[out] value
+     *      This is where to store the value of the integer.
+     * @return
+     *      An indication of whether or not the integer
+     *      could be read is returned.
+     */
+    bool ReadFourByteInteger(const std::vector<uint8_t>& packet, size_t& offset,
+                             uint32_t& value) {
+        if (packet.size() - std::min(offset, packet.size()) < 4)
+        { return false; }
+        value = (((uint32_t)packet[offset] << 24) | ((uint32_t)packet[offset + 1] << 16) |
+                 ((uint32_t)packet[offset + 2] << 8) | (uint32_t)packet[offset + 3]);
+        offset += 4;
+        return true;
+    }
+
+    /**
+     * This function skips the Binary Data or UTF-8 Encoded String at the
+     * given offset of the given packet, moving the offset past it.
+     *
+     * @param[in] packet
+     *      This is the encoded MQTT control packet.
+     * @param[in,out] offset
+     *      This is the offset of the data within the packet.
+     * @return
+     *      An indication of whether or not the data
+     *      could be skipped is returned.
+     */
+    bool SkipBinaryData(const std::vector<uint8_t>& packet, size_t& offset) {
+        uint16_t length;
+        if (!ReadTwoByteInteger(packet, offset, length))
+        { return false; }
+        offset += length;
+        return (offset <= packet.size());
+    }
+
+    /**
+     * This function returns the offset of the variable header
+     * of the given packet, just past its fixed header.
+     *
+     * @param[in] packet
+     *      This is the encoded MQTT control packet.
+     * @param[out] offset
+     *      This is where to store the offset of the variable header.
+     * @return
+     *      An indication of whether or not the fixed header
+     *      could be read is returned.
+     */
+    bool SkipFixedHeader(const std::vector<uint8_t>& packet, size_t& offset) {
+        offset = 1;
+        size_t remainingLength;
+        return ReadVariableByteInteger(packet, offset, remainingLength);
+    }
+
+    /**
+     * This function reads the Packet Identifier of the given PUBLISH,
+     * PUBACK, PUBREC, PUBREL or PUBCOMP packet.
+     *
+     * @param[in] packet
+     *      This is the encoded MQTT control packet.
+     * @param[out] packetIdentifier
+     *      This is where to store the Packet Identifier.
+     * @return
+     *      An indication of whether or not the packet has
+     *      a Packet Identifier is returned.
+     */
+    bool ReadPacketIdentifier(const std::vector<uint8_t>& packet, uint16_t& packetIdentifier) {
+        size_t offset;
+        if (!SkipFixedHeader(packet, offset))
+        { return false; }
+        if ((packet[0] >> 4) == PACKET_TYPE_PUBLISH)
+        {
+            if (((packet[0] >> 1) & 0x03) == 0)
+            { return false; }
+            if (!SkipBinaryData(packet, offset))
+            { return false; }
+        }
+        return ReadTwoByteInteger(packet, offset, packetIdentifier);
+    }
+
+    /**
+     * This function determines whether or not the session begun by the
+     * given CONNECT packet can be resumed, and if so, makes the CONNECT
+     * packet which resumes it.
+     *
+     * @param[in] packet
+     *      This is the encoded CONNECT packet.
+     * @param[out] resume
+     *      This is where to store the CONNECT packet
+     *      which resumes the session.
+     * @return
+     *      An indication of whether or not the session
+     *      can be resumed is returned.
+     */
+    bool MakeResumingConnect(const std::vector<uint8_t>& packet, std::vector<uint8_t>& resume) {
+        size_t offset;
+        if (!SkipFixedHeader(packet, offset) || !SkipBinaryData(packet, offset) ||
+            (packet.size() - offset < 4) || (packet[offset] != PROTOCOL_VERSION_5))
+        { return false; }
+        const auto flagsOffset = offset + 1;
+        offset += 4;
+        size_t propertiesLength;
+        if (!ReadVariableByteInteger(packet, offset, propertiesLength) ||
+            (propertiesLength > packet.size() - offset))
+        { return false; }
+        const auto propertiesEnd = offset + propertiesLength;
+        uint32_t sessionExpiryInterval = 0;
+        while (offset < propertiesEnd)
+        {
+            switch (packet[offset++])
+            {
+            case PROPERTY_SESSION_EXPIRY_INTERVAL:
+            {
+                if (!ReadFourByteInteger(packet, offset, sessionExpiryInterval))
+                { return false; }
+            } break;
+            case PROPERTY_REQUEST_PROBLEM_INFORMATION:
+            case PROPERTY_REQUEST_RESPONSE_INFORMATION: offset += 1; break;
+            case PROPERTY_RECEIVE_MAXIMUM:
+            case PROPERTY_TOPIC_ALIAS_MAXIMUM: offset += 2; break;
+            case PROPERTY_MAXIMUM_PACKET_SIZE: offset += 4; break;
+            case PROPERTY_USER_PROPERTY:
+            {
+                if (!SkipBinaryData(packet, offset) || !SkipBinaryData(packet, offset))
+                { return false; }
+            } break;
+            case PROPERTY_AUTHENTICATION_DATA:
+            {
+                if (!SkipBinaryData(packet, offset))
+                { return false; }
+            } break;
+            case PROPERTY_AUTHENTICATION_METHOD:
+            default: return false;
+            }
+        }
+        uint16_t clientIdentifierLength;
+        if ((offset != propertiesEnd) ||
+            !ReadTwoByteInteger(packet, offset, clientIdentifierLength) ||
+            (clientIdentifierLength == 0) || (sessionExpiryInterval == 0))
+        { return false; }
+        resume = packet;
+        resume[flagsOffset] &= ~CONNECT_FLAG_CLEAN_START;
+        return true;
+    }
+
+    /**
+     * This holds the limits the broker sets in CONNACK for the network
+     * connection, which must not change when the session is resumed
+     * on a new one.
+     */
+    struct ConnectionLimits
+    {
+        /**
+         * This is the most PUBLISH packets of QoS 1 and 2
+         * the broker processes at once.
+         */
+        uint16_t receiveMaximum = DEFAULT_RECEIVE_MAXIMUM;
+
+        /**
+         * This is the most topic aliases the broker accepts.
+         */
+        uint16_t topicAliasMaximum = 0;
+
+        /**
+         * This is the most bytes of a packet the broker
+         * accepts, or zero if there is no limit.
+         */
+        uint32_t maximumPacketSize = 0;
+
+        /**
+         * This method determines whether or not these limits
+         * are the same as the given ones.
+         *
+         * @param[in] other
+         *      These are the limits to compare with these.
+         * @return
+         *      An indication of whether or not the limits
+         *      are the same is returned.
+         */
+        bool Matches(const ConnectionLimits& other) const {
+            return ((receiveMaximum == other.receiveMaximum) &&
+                    (topicAliasMaximum == other.topicAliasMaximum) &&
+                    (maximumPacketSize == other.maximumPacketSize));
+        }
+    };
+
+    /**
+     * This function reads the limits the broker sets
+     * in the given CONNACK packet.
+     *
+     * @param[in] packet
+     *      This is the encoded CONNACK packet.
+     * @param[out] limits
+     *      This is where to store the limits.
+     * @return
+     *      An indication of whether or not the properties
+     *      of the packet could be read is returned.
+     */
+    bool ReadConnectionLimits(const std::vector<uint8_t>& packet, ConnectionLimits& limits) {
+        limits = ConnectionLimits();
+        size_t offset;
+        if (!SkipFixedHeader(packet, offset) || (packet.size() - offset < 2))
+        { return false; }
+        offset += 2;
+        if (offset == packet.size())
+        { return true; }
+        size_t propertiesLength;
+        if (!ReadVariableByteInteger(packet, offset, propertiesLength) ||
+            (propertiesLength > packet.size() - offset))
+        { return false; }
+        const auto propertiesEnd = offset + propertiesLength;
+        while (offset < propertiesEnd)
+        {
+            switch (packet[offset++])
+            {
+            case PROPERTY_RECEIVE_MAXIMUM:
+            {
+                if (!ReadTwoByteInteger(packet, offset, limits.receiveMaximum))
+                { return false; }
+            } break;
+            case PROPERTY_TOPIC_ALIAS_MAXIMUM:
+            {
+                if (!ReadTwoByteInteger(packet, offset, limits.topicAliasMaximum))
+                { return false; }
+            } break;
+            case PROPERTY_MAXIMUM_PACKET_SIZE:
+            {
+                if (!ReadFourByteInteger(packet, offset, limits.maximumPacketSize))
+                { return false; }
+            } break;
+            case PROPERTY_MAXIMUM_QOS:
+            case PROPERTY_RETAIN_AVAILABLE:
+            case PROPERTY_WILDCARD_SUBSCRIPTION_AVAILABLE:
+            case PROPERTY_SUBSCRIPTION_IDENTIFIER_AVAILABLE:
+            case PROPERTY_SHARED_SUBSCRIPTION_AVAILABLE: offset += 1; break;
+            case PROPERTY_SERVER_KEEP_ALIVE: offset += 2; break;
+            case PROPERTY_SESSION_EXPIRY_INTERVAL: offset += 4; break;
+            case PROPERTY_ASSIGNED_CLIENT_IDENTIFIER:
+            case PROPERTY_AUTHENTICATION_METHOD:
+            case PROPERTY_AUTHENTICATION_DATA:
+            case PROPERTY_RESPONSE_INFORMATION:
+            case PROPERTY_SERVER_REFERENCE:
+            case PROPERTY_REASON_STRING:
+            {
+                if (!SkipBinaryData(packet, offset))
+                { return false; }
+            } break;
+            case PROPERTY_USER_PROPERTY:
+            {
+                if (!SkipBinaryData(packet, offset) || !SkipBinaryData(packet, offset))
+                { return false; }
+            } break;
+            default: return false;
+            }
+        }
+        return (offset == propertiesEnd);
+    }
+
+    /**
+     * This holds a packet sent in the session whose flow the
+     * broker has not yet completed.
+     */
+    struct InFlight
+    {
+        /**
+         * This is the type of the packet, either PUBLISH or PUBREL.
+         */
+        uint8_t type = 0;
+
+        /**
+         * This is the Packet Identifier of the packet.
+         */
+        uint16_t packetIdentifier = 0;
+
+        /**
+         * This is the encoded packet.
+         */
+        MqttNetworkTransport::ZeroCopyConnection::SharedBuffer packet;
+    };
+}  // namespace
+
+namespace MqttNetworkTransport
+{
+    struct ResumingConnection::Impl : public std::enable_shared_from_this<ResumingConnection::Impl>
+    {
+        /**
+         * These are the settings of the connection.
+         */
+        Settings settings;
+
+        /**
+         * This is used to delay attempts to reconnect.
+         */
+        std::shared_ptr<TimerQueue> timerQueue;
+
+        /**
+         * This is the function to call to establish a new network connection.
+         */
+        ReconnectDelegate reconnectDelegate;
+
+        /**
+         * This is the function to call each time a break is over.
+         */
+        OutcomeDelegate outcomeDelegate;
+
+        /**
+         * This is used to report breaks and their outcomes.
+         */
+        std::shared_ptr<SystemUtils::DiagnosticsSender> diagnosticsSender;
+
+        /**
+         * This identifies the connection in diagnostic messages.
+         */
+        std::string peerId;
+
+        /**
+         * This is used to synchronize access to the state of the connection.
+         */
+        std::mutex mutex;
+
+        /**
+         * These are the user's delegates.  They are shared, rather than
+         * copied, out of the lock when called.
+         */
+        std::shared_ptr<const DataReceivedDelegate> dataReceivedDelegate;
+        std::shared_ptr<const BrokenDelegate> brokenDelegate;
+
+        /**
+         * This is the current network connection, or nullptr
+         * while reconnecting.
+         */
+        std::shared_ptr<ZeroCopyConnection> connection;
+
+        /**
+         * This identifies the current network connection, or the attempt
+         * to establish it.  Delegates of earlier network connections
+         * carry an older generation, and are ignored.
+         */
+        unsigned generation = 1;
+
+        /**
+         * If the session can be resumed, this is the CONNECT
+         * packet which resumes it.
+         */
+        std::vector<uint8_t> resumingConnect;
+
+        /**
+         * This indicates whether or not the broker accepted
+         * the first CONNECT.
+         */
+        bool established = false;
+
+        /**
+         * These are the limits the broker set in the first CONNACK.
+         */
+        ConnectionLimits limits;
+
+        /**
+         * This indicates whether or not either side has ended the
+         * session, so that the next break is reported.
+         */
+        bool closing = false;
+
+        /**
+         * This indicates whether or not the session is being resumed,
+         * from the break until the packets held have been sent.
+         */
+        bool resuming = false;
+
+        /**
+         * This indicates whether or not the break has been reported,
+         * after which nothing more is done.
+         */
+        bool broken = false;
+
+        /**
+         * This is the number of attempts to reconnect left
+         * before the break is reported.
+         */
+        unsigned attemptsLeft = 0;
+
+        /**
+         * This is the function to call to abandon the
+         * current attempt to reconnect, if any.
+         */
+        CancelDelegate cancelAttempt;
+
+        /**
+         * This is when the last attempt to reconnect started.
+         */
+        std::chrono::steady_clock::time_point lastAttempt;
+
+        /**
+         * This identifies the timer which starts the next attempt
+         * to reconnect, if it has to wait, or is zero.
+         */
+        TimerQueue::Token retryTimer = 0;
+
+        /**
+         * These are the packets sent whose flow the broker has not
+         * yet completed, in the order in which they were sent.
+         */
+        std::vector<InFlight> inFlight;
+
+        /**
+         * These are the packets sent while the session is being
+         * resumed, and how many bytes they hold.
+         */
+        std::deque<SharedBuffer> held;
+        size_t heldBytes = 0;
+
+        /**
+         * This method makes the function to give a network connection
+         * of the given generation, to deliver the data it receives.
+         *
+         * @param[in] connectionGeneration
+         *      This identifies the network connection.
+         * @return
+         *      The delegate for the network connection is returned.
+         */
+        DataReceivedDelegate MakeDataReceivedDelegate(unsigned connectionGeneration) {
+            std::weak_ptr<Impl> selfWeak(shared_from_this());
+            const auto framer = std::make_shared<PacketFramer>(false, settings.maximumPacketSize);
+            return [selfWeak, framer, connectionGeneration](const std::vector<uint8_t>& data)
+            {
+                const auto self = selfWeak.lock();
+                if (self == nullptr)
+                { return; }
+                if (framer->Feed(data,
+                                 [&self, connectionGeneration](const std::vector<uint8_t>& packet)
+                                 { self->OnPacket(connectionGeneration, packet); }))
+                { return; }
+                self->OnMalformed(connectionGeneration);
+            };
+        }
+
+        /**
+         * This method makes the function to give a network connection
+         * of the given generation, to call once it is broken.
+         *
+         * @param[in] connectionGeneration
+         *      This identifies the network connection.
+         * @return
+         *      The delegate for the network connection is returned.
+         */
+        BrokenDelegate MakeBrokenDelegate(unsigned connectionGeneration) {
+            std::weak_ptr<Impl> selfWeak(shared_from_this());
+            return [selfWeak, connectionGeneration](bool graceful)
+            {
+                const auto self = selfWeak.lock();
+                if (self != nullptr)
+                { self->OnBroken(connectionGeneration, graceful); }
+            };
+        }
+
+        /**
+         * This method forgets the packet of the given type and Packet
+         * Identifier sent in the session, if any.  The caller must
+         * hold the mutex.
+         *
+         * @param[in] type
+         *      This is the type of the packet, either PUBLISH or PUBREL.
+         * @param[in] packetIdentifier
+         *      This is the Packet Identifier of the packet.
+         */
+        void Forget(uint8_t type, uint16_t packetIdentifier) {
+            inFlight.erase(std::remove_if(inFlight.begin(), inFlight.end(),
+                                          [type, packetIdentifier](const InFlight& sent)
+                                          {
+                                              return ((sent.type == type) &&
+                                                      (sent.packetIdentifier ==
+                                                       packetIdentifier));
+                                          }),
+                           inFlight.end());
+        }
+
+        /**
+         * This method follows the state of the session through
+         * the given packet, about to be sent on the current
+         * network connection.  The caller must hold the mutex.
+         *
+         * @param[in] packet
+         *      This is the packet to be sent.
+         * @param[in,out] shared
+         *      This is the packet, if already shared.  If the packet
+         *      needs to be kept and isn't, it is copied into here.
+         */
+        void Track(const std::vector<uint8_t>& packet, SharedBuffer& shared) {
+            if (packet.empty())
+            { return; }
+            const uint8_t type = (packet[0] >> 4);
+            if (type == PACKET_TYPE_CONNECT)
+            {
+                if (!established && !MakeResumingConnect(packet, resumingConnect))
+                { resumingConnect.clear(); }
+                return;
+            }
+            if (type == PACKET_TYPE_DISCONNECT)
+            {
+                closing = true;
+                return;
+            }
+            if (resumingConnect.empty() ||
+                ((type != PACKET_TYPE_PUBLISH) && (type != PACKET_TYPE_PUBREL)))
+            { return; }
+            InFlight sent;
+            if (!ReadPacketIdentifier(packet, sent.packetIdentifier))
+            { return; }
+            if (shared == nullptr)
+            { shared = std::make_shared<const std::vector<uint8_t>>(packet); }
+            sent.type = type;
+            sent.packet = shared;
+            Forget(PACKET_TYPE_PUBLISH, sent.packetIdentifier);
+            Forget(PACKET_TYPE_PUBREL, sent.packetIdentifier);
+            inFlight.push_back(std::move(sent));
+        }
+
+        /**
+         * This method keeps the limits the broker set in the first
+         * CONNACK, for comparing with those it sets when the session
+         * is resumed.  The caller must hold the mutex.
+         *
+         * @param[in] packet
+         *      This is the first CONNACK packet.
+         * @return
+         *      A description of why the session can't be resumed on
+         *      these terms is returned, or nullptr if it can.
+         */
+        const char* KeepLimits(const std::vector<uint8_t>& packet) {
+            if (!ReadConnectionLimits(packet, limits))
+            { return "malformed CONNACK properties"; }
+            if (limits.topicAliasMaximum != 0)
+            { return "the broker allows topic aliases"; }
+            return nullptr;
+        }
+
+        /**
+         * This method decides what becomes of a packet being sent.
+         *
+         * @param[in] packet
+         *      This is the packet to send.
+         * @param[in,out] shared
+         *      This is the packet, if already shared.  If the packet
+         *      needs to be kept and isn't, it is copied into here.
+         * @param[out] overflow
+         *      This is set if the packet had to be held,
+         *      but there was no room left for it.
+         * @return
+         *      The network connection on which to send the packet is
+         *      returned, or nullptr if the packet was held or dropped.
+         */
+        std::shared_ptr<ZeroCopyConnection> Route(const std::vector<uint8_t>& packet,
+                                                  SharedBuffer& shared, bool& overflow) {
+            std::lock_guard<decltype(mutex)> lock(mutex);
+            if (broken)
+            { return nullptr; }
+            if (!resuming && (connection != nullptr))
+            {
+                Track(packet, shared);
+                return connection;
+            }
+            if (packet.size() > settings.bufferBytes - std::min(heldBytes, settings.bufferBytes))
+            {
+                overflow = true;
+                return nullptr;
+            }
+            if (shared == nullptr)
+            { shared = std::make_shared<const std::vector<uint8_t>>(packet); }
+            held.push_back(shared);
+            heldBytes += packet.size();
+            return nullptr;
+        }
+
+        /**
+         * This method handles a packet received on the
+         * network connection of the given generation.
+         *
+         * @param[in] connectionGeneration
+         *      This identifies the network connection.
+         * @param[in] packet
+         *      This is the packet received.
+         */
+        void OnPacket(unsigned connectionGeneration, const std::vector<uint8_t>& packet) {
+            std::shared_ptr<const DataReceivedDelegate> delegate;
+            bool handshake = false;
+            const char* unresumable = nullptr;
+            const char* failure = nullptr;
+            {
+                std::lock_guard<decltype(mutex)> lock(mutex);
+                if ((connectionGeneration != generation) || broken)
+                { return; }
+                const uint8_t type = (packet[0] >> 4);
+                if (resuming)
+                {
+                    size_t offset;
+                    handshake = true;
+                    const bool present =
+                        ((type == PACKET_TYPE_CONNACK) && SkipFixedHeader(packet, offset) &&
+                         (packet.size() - offset >= 2) &&
+                         ((packet[offset] & CONNACK_FLAG_SESSION_PRESENT) != 0) &&
+                         (packet[offset + 1] == 0));
+                    ConnectionLimits resumedLimits;
+                    const bool unchanged =
+                        (present && ReadConnectionLimits(packet, resumedLimits) &&
+                         resumedLimits.Matches(limits));
+                    if (!present)
+                    { failure = "the broker did not resume the session"; } else if (!unchanged)
+                    { failure = "the broker changed the limits of the connection"; }
+                } else
+                {
+                    uint16_t packetIdentifier;
+                    switch (type)
+                    {
+                    case PACKET_TYPE_CONNACK:
+                    {
+                        size_t offset;
+                        if (!established && SkipFixedHeader(packet, offset) &&
+                            (packet.size() - offset >= 2) && (packet[offset + 1] == 0))
+                        {
+                            established = true;
+                            if (!resumingConnect.empty())
+                            { unresumable = KeepLimits(packet); }
+                            if (unresumable != nullptr)
+                            {
+                                resumingConnect.clear();
+                                inFlight.clear();
+                            }
+                        }
+                    } break;
+                    case PACKET_TYPE_PUBACK:
+                    case PACKET_TYPE_PUBREC:
+                    {
+                        if (ReadPacketIdentifier(packet, packetIdentifier))
+                        { Forget(PACKET_TYPE_PUBLISH, packetIdentifier); }
+                    } break;
+                    case PACKET_TYPE_PUBCOMP:
+                    {
+                        if (ReadPacketIdentifier(packet, packetIdentifier))
+                        { Forget(PACKET_TYPE_PUBREL, packetIdentifier); }
+                    } break;
+                    case PACKET_TYPE_DISCONNECT: closing = true; break;
+                    default: break;
+                    }
+                    delegate = dataReceivedDelegate;
+                }
+            }
+            if (unresumable != nullptr)
+            {
+                diagnosticsSender->SendDiagnosticInformationFormatted(
+                    1, "Session with '%s' won't be resumed: %s", peerId.c_str(), unresumable);
+            }
+            if (!handshake)
+            {
+                if ((delegate != nullptr) && (*delegate != nullptr))
+                { (*delegate)(packet); }
+            } else if (failure == nullptr)
+            { Resume(connectionGeneration); } else
+            { GiveUp(failure); }
+        }
+
+        /**
+         * This method handles malformed data received on the
+         * network connection of the given generation.
+         *
+         * @param[in] connectionGeneration
+         *      This identifies the network connection.
+         */
+        void OnMalformed(unsigned connectionGeneration) {
+            std::shared_ptr<ZeroCopyConnection> malformedConnection;
+            {
+                std::lock_guard<decltype(mutex)> lock(mutex);
+                if ((connectionGeneration != generation) || broken)
+                { return; }
+                closing = true;
+                malformedConnection = connection;
+            }
+            diagnosticsSender->SendDiagnosticInformationFormatted(
+                SystemUtils::DiagnosticsSender::Levels::ERROR,
+                "Malformed packet received from '%s'", peerId.c_str());
+            if (malformedConnection != nullptr)
+            { malformedConnection->Break(false); } else
+            { GiveUp("malformed packet received"); }
+        }
+
+        /**
+         * This method handles the break of the network connection
+         * of the given generation.
+         *
+         * @param[in] connectionGeneration
+         *      This identifies the network connection.
+         * @param[in] graceful
+         *      This indicates whether or not the peer closed
+         *      the connection gracefully.
+         */
+        void OnBroken(unsigned connectionGeneration, bool graceful) {
+            std::shared_ptr<const BrokenDelegate> delegate;
+            bool report = false;
+            bool start = false;
+            {
+                std::lock_guard<decltype(mutex)> lock(mutex);
+                if ((connectionGeneration != generation) || broken)
+                { return; }
+                connection = nullptr;
+                if (!resuming)
+                {
+                    if (closing || !established || resumingConnect.empty() ||
+                        (settings.attempts == 0))
+                    {
+                        broken = true;
+                        report = true;
+                        delegate = brokenDelegate;
+                    } else
+                    {
+                        resuming = true;
+                        start = true;
+                        attemptsLeft = settings.attempts;
+                    }
+                }
+            }
+            if (report)
+            {
+                if ((delegate != nullptr) && (*delegate != nullptr))
+                { (*delegate)(graceful); }
+                return;
+            }
+            if (start)
+            {
+                diagnosticsSender->SendDiagnosticInformationFormatted(
+                    SystemUtils::DiagnosticsSender::Levels::WARNING,
+                    "Connection to '%s' broken; resuming the session", peerId.c_str());
+            }
+            Reconnect();
+        }
+
+        /**
+         * This method cancels the timer which starts the next attempt
+         * to reconnect, if any.  The caller must hold the mutex.
+         */
+        void CancelRetry() {
+            if ((retryTimer != 0) && (timerQueue != nullptr))
+            { timerQueue->Cancel(retryTimer); }
+            retryTimer = 0;
+        }
+
+        /**
+         * This method starts the next attempt to reconnect, or schedules
+         * it if the last attempt started less than the retry delay ago,
+         * or reports the break if there are no attempts left.
+         */
+        void Reconnect() {
+            unsigned attemptGeneration;
+            {
+                std::lock_guard<decltype(mutex)> lock(mutex);
+                if (broken || !resuming || (retryTimer != 0))
+                { return; }
+                const auto now = std::chrono::steady_clock::now();
+                const auto due = lastAttempt + settings.retryDelay;
+                if (attemptsLeft == 0)
+                { attemptGeneration = 0; } else if ((due > now) && (timerQueue != nullptr))
+                {
+                    std::weak_ptr<Impl> selfWeak(shared_from_this());
+                    const auto retryGeneration = generation;
+                    retryTimer = timerQueue->Schedule(
+                        due,
+                        [selfWeak, retryGeneration]
+                        {
+                            const auto self = selfWeak.lock();
+                            if (self == nullptr)
+                            { return; }
+                            {
+                                std::lock_guard<decltype(self->mutex)> lock(self->mutex);
+                                if (self->generation != retryGeneration)
+                                { return; }
+                                self->retryTimer = 0;
+                            }
+                            self->Reconnect();
+                        });
+                    return;
+                } else
+                {
+                    lastAttempt = now;
+                    --attemptsLeft;
+                    attemptGeneration = ++generation;
+                }
+            }
+            if (attemptGeneration == 0)
+            {
+                GiveUp("every attempt to reconnect failed");
+                return;
+            }
+            std::weak_ptr<Impl> selfWeak(shared_from_this());
+            const auto cancel = reconnectDelegate(
+                MakeDataReceivedDelegate(attemptGeneration), MakeBrokenDelegate(attemptGeneration),
+                [selfWeak, attemptGeneration](std::shared_ptr<MqttV5::Connection> newConnection)
+                {
+                    const auto self = selfWeak.lock();
+                    if (self != nullptr)
+                    { self->OnReconnected(attemptGeneration, newConnection); }
+                });
+            std::lock_guard<decltype(mutex)> lock(mutex);
+            if ((attemptGeneration == generation) && (connection == nullptr) && !broken)
+            { cancelAttempt = cancel; }
+        }
+
+        /**
+         * This method handles the completion of the attempt
+         * to reconnect of the given generation.
+         *
+         * @param[in] attemptGeneration
+         *      This identifies the attempt.
+         * @param[in] newConnection
+         *      This is the network connection established,
+         *      or nullptr if the attempt failed.
+         */
+        void OnReconnected(unsigned attemptGeneration,
+                           std::shared_ptr<MqttV5::Connection> newConnection) {
+            const auto zeroCopyConnection =
+                std::dynamic_pointer_cast<ZeroCopyConnection>(newConnection);
+            std::vector<uint8_t> connect;
+            {
+                std::lock_guard<decltype(mutex)> lock(mutex);
+                if ((attemptGeneration == generation) && !broken)
+                {
+                    cancelAttempt = nullptr;
+                    connection = zeroCopyConnection;
+                    connect = resumingConnect;
+                }
+            }
+            if (connect.empty())
+            {
+                if (newConnection != nullptr)
+                { newConnection->Break(false); }
+                return;
+            }
+            if (zeroCopyConnection == nullptr)
+            {
+                if (newConnection != nullptr)
+                { newConnection->Break(false); }
+                Reconnect();
+                return;
+            }
+            zeroCopyConnection->SendData(std::move(connect));
+        }
+
+        /**
+         * This method completes the resumption of the session, once the
+         * broker has resumed it on the network connection of the given
+         * generation, by sending again the packets whose flow it hasn't
+         * completed, and then the packets held.
+         *
+         * @param[in] connectionGeneration
+         *      This identifies the network connection.
+         */
+        void Resume(unsigned connectionGeneration) {
+            std::shared_ptr<ZeroCopyConnection> resumedConnection;
+            std::vector<SharedBuffer> packets;
+            {
+                std::lock_guard<decltype(mutex)> lock(mutex);
+                if ((connectionGeneration != generation) || broken)
+                { return; }
+                resumedConnection = connection;
+                for (const auto& sent : inFlight)
+                {
+                    if (sent.type == PACKET_TYPE_PUBLISH)
+                    {
+                        std::vector<uint8_t> duplicate(*sent.packet);
+                        duplicate[0] |= PUBLISH_FLAG_DUP;
+                        packets.push_back(
+                            std::make_shared<const std::vector<uint8_t>>(std::move(duplicate)));
+                    } else
+                    { packets.push_back(sent.packet); }
+                }
+            }
+            diagnosticsSender->SendDiagnosticInformationFormatted(
+                1, "Session with '%s' resumed; sending %zu unacknowledged packets again",
+                peerId.c_str(), packets.size());
+            for (;;)
+            {
+                for (auto& packet : packets)
+                { resumedConnection->SendData(std::move(packet)); }
+                packets.clear();
+                std::lock_guard<decltype(mutex)> lock(mutex);
+                if ((connectionGeneration != generation) || broken)
+                { return; }
+                if (held.empty())
+                {
+                    resuming = false;
+                    break;
+                }
+                for (auto& packet : held)
+                {
+                    Track(*packet, packet);
+                    packets.push_back(std::move(packet));
+                }
+                held.clear();
+                heldBytes = 0;
+            }
+            if (outcomeDelegate != nullptr)
+            { outcomeDelegate(true); }
+        }
+
+        /**
+         * This method stops trying to resume the session,
+         * and reports the break.
+         *
+         * @param[in] reason
+         *      This describes why the session could not be resumed.
+         */
+        void GiveUp(const char* reason) {
+            std::shared_ptr<ZeroCopyConnection> abandonedConnection;
+            CancelDelegate cancel;
+            std::shared_ptr<const BrokenDelegate> delegate;
+            {
+                std::lock_guard<decltype(mutex)> lock(mutex);
+                if (broken)
+                { return; }
+                broken = true;
+                resuming = false;
+                ++generation;
+                CancelRetry();
+                abandonedConnection = std::move(connection);
+                cancel = std::move(cancelAttempt);
+                delegate = brokenDelegate;
+                inFlight.clear();
+                held.clear();
+                heldBytes = 0;
+            }
+            diagnosticsSender->SendDiagnosticInformationFormatted(
+                SystemUtils::DiagnosticsSender::Levels::WARNING,
+                "Unable to resume the session with '%s': %s", peerId.c_str(), reason);
+            if (cancel != nullptr)
+            { cancel(); }
+            if (abandonedConnection != nullptr)
+            { abandonedConnection->Break(false); }
+            if (outcomeDelegate != nullptr)
+            { outcomeDelegate(false); }
+            if ((delegate != nullptr) && (*delegate != nullptr))
+            { (*delegate)(false); }
+        }
+    };
+
+    ResumingConnection::~ResumingConnection() noexcept {
+        CancelDelegate cancel;
+        {
+            std::lock_guard<decltype(impl_->mutex)> lock(impl_->mutex);
+            impl_->broken = true;
+            ++impl_->generation;
+            impl_->CancelRetry();
+            cancel = std::move(impl_->cancelAttempt);
+        }
+        if (cancel != nullptr)
+        { cancel(); }
+    }
+
+    ResumingConnection::ResumingConnection(
+        const Settings& settings, std::shared_ptr<TimerQueue> timerQueue,
+        ReconnectDelegate reconnectDelegate, OutcomeDelegate outcomeDelegate,
+        std::shared_ptr<SystemUtils::DiagnosticsSender> diagnosticsSender,
+        const std::string& peerId) :
+        impl_(std::make_shared<Impl>()) {
+        impl_->settings = settings;
+        impl_->timerQueue = timerQueue;
+        impl_->reconnectDelegate = reconnectDelegate;
+        impl_->outcomeDelegate = outcomeDelegate;
+        impl_->diagnosticsSender = diagnosticsSender;
+        impl_->peerId = peerId;
+    }
+
+    MqttV5::Connection::DataReceivedDelegate ResumingConnection::GetDataReceivedDelegate() {
+        return impl_->MakeDataReceivedDelegate(1);
+    }
+
+    MqttV5::Connection::BrokenDelegate ResumingConnection::GetBrokenDelegate() {
+        return impl_->MakeBrokenDelegate(1);
+    }
+
+    void ResumingConnection::Attach(std::shared_ptr<MqttV5::Connection> connection) {
+        std::lock_guard<decltype(impl_->mutex)> lock(impl_->mutex);
+        if (impl_->generation == 1)
+        { impl_->connection = std::dynamic_pointer_cast<ZeroCopyConnection>(connection); }
+    }
+
+    std::string ResumingConnection::GetPeerId() {
+        std::shared_ptr<ZeroCopyConnection> connection;
+        {
+            std::lock_guard<decltype(impl_->mutex)> lock(impl_->mutex);
+            connection = impl_->connection;
+        }
+        return ((connection == nullptr) ? impl_->peerId : connection->GetPeerId());
+    }
+
+    void ResumingConnection::SetDataReceivedDelegate(DataReceivedDelegate dataReceivedDelegate) {
+        const auto delegate = std::make_shared<const DataReceivedDelegate>(dataReceivedDelegate);
+        std::lock_guard<decltype(impl_->mutex)> lock(impl_->mutex);
+        impl_->dataReceivedDelegate = delegate;
+    }
+
+    void ResumingConnection::SetConnectionBrokenDelegate(BrokenDelegate brokenDelegate) {
+        const auto delegate = std::make_shared<const BrokenDelegate>(brokenDelegate);
+        std::lock_guard<decltype(impl_->mutex)> lock(impl_->mutex);
+        impl_->brokenDelegate = delegate;
+    }
+
+    void ResumingConnection::SendData(const std::vector<uint8_t>& data) {
+        SharedBuffer shared;
+        bool overflow = false;
+        const auto connection = impl_->Route(data, shared, overflow);
+        if (connection != nullptr)
+        {
+            if (shared == nullptr)
+            { connection->SendData(data); } else
+            { connection->SendData(std::move(shared)); }
+        } else if (overflow)
+        { impl_->GiveUp("too much data sent while reconnecting"); }
+    }
+
+    void ResumingConnection::Break(bool clean) {
+        std::shared_ptr<ZeroCopyConnection> connection;
+        CancelDelegate cancel;
+        std::shared_ptr<const BrokenDelegate> delegate;
+        {
+            std::lock_guard<decltype(impl_->mutex)> lock(impl_->mutex);
+            impl_->closing = true;
+            if (impl_->broken)
+            { return; }
+            connection = impl_->connection;
+            if (impl_->resuming)
+            {
+                impl_->broken = true;
+                impl_->resuming = false;
+                ++impl_->generation;
+                impl_->CancelRetry();
+                impl_->connection = nullptr;
+                cancel = std::move(impl_->cancelAttempt);
+                delegate = impl_->brokenDelegate;
+                impl_->inFlight.clear();
+                impl_->held.clear();
+                impl_->heldBytes = 0;
+            }
+        }
+        if (cancel != nullptr)
+        { cancel(); }
+        if (connection != nullptr)
+        { connection->Break(clean); }
+        if ((delegate != nullptr) && (*delegate != nullptr))
+        { (*delegate)(false); }
+    }
+
+    void ResumingConnection::SendData(std::vector<uint8_t>&& data) {
+        SendData(std::make_shared<const std::vector<uint8_t>>(std::move(data)));
+    }
+
+    void ResumingConnection::SendData(SharedBuffer data) {
+        if (data == nullptr)
+        { return; }
+        bool overflow = false;
+        const auto connection = impl_->Route(*data, data, overflow);
+        if (connection != nullptr)
+        { connection->SendData(std::move(data)); } else if (overflow)
+        { impl_->GiveUp("too much data sent while reconnecting"); }
+    }
+
+    auto ResumingConnection::GetConnectionStatistics() -> ConnectionStatistics {
+        std::shared_ptr<ZeroCopyConnection> connection;
+        {
+            std::lock_guard<decltype(impl_->mutex)> lock(impl_->mutex);
+            connection = impl_->connection;
+        }
+        return ((connection == nullptr) ? ConnectionStatistics()
+                                        : connection->GetConnectionStatistics());
+    }
+}  // namespace MqttNetworkTransport
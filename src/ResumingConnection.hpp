@@ -0,0 +1,233 @@
+#ifndef MQTT_NETWORK_TRANSPORT_RESUMING_CONNECTION_HPP
+#define MQTT_NETWORK_TRANSPORT_RESUMING_CONNECTION_HPP
+/**
+ * @file ResumingConnection.hpp
+ *
+ * This module declares the MqttNetworkTransport::ResumingConnection class.
+ *
+ * © 2025 by Hatem Nabli
+ */
+
+#include "TimerQueue.hpp"
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+#include <stddef.h>
+#include <stdint.h>
+#include <MqttNetworkTransport/ZeroCopyConnection.hpp>
+#include <SystemUtils/DiagnosticsSender.hpp>
+
+namespace MqttNetworkTransport
+{
+    /**
+     * This is a connection which outlives the network connections under
+     * it.  When the network connection breaks without being asked to, a
+     * new one is established and the MQTT session is resumed on it,
+     * without the protocol layer noticing, rather than the break being
+     * reported.
+     *
+     * To resume the session, the CONNECT packet first sent is sent again
+     * with Clean Start cleared, and the CONNACK answering it is kept from
+     * the protocol layer.  Then the PUBLISH packets of QoS 1 and 2 not
+     * yet acknowledged are sent again with DUP set, followed by the PUBREL
+     * packets not yet completed, as MQTT requires of a client resuming a
+     * session, and finally the packets sent while there was no network
+     * connection, which are held in a bounded buffer.
+     *
+     * A session can only be resumed if the broker kept it, so only
+     * connections whose CONNECT gives a Client Identifier and a non-zero
+     * Session Expiry Interval, and doesn't use enhanced authentication,
+     * are resumed.  Topic aliases and the limits the broker sets in CONNACK
+     * belong to the network connection, not the session, so sessions are
+     * not resumed if the broker allows topic aliases, since the aliases
+     * the protocol layer has set up would be unknown to the broker after
+     * reconnecting.  The break is reported, as it would have been without
+     * resuming, if the broker doesn't report the session as present, if
+     * it sets a different Receive Maximum, Maximum Packet Size or Topic
+     * Alias Maximum than it did at first, if the buffer overflows, if
+     * every attempt to reconnect fails, or if either side sent DISCONNECT.
+     *
+     * Attempts to reconnect after a break start at least a retry delay
+     * apart, so that a broker which drops connections at once isn't
+     * hammered with them.
+     *
+     * Received data is delivered one whole packet at a time.
+     */
+    class ResumingConnection : public ZeroCopyConnection
+    {
+    public:
+        /**
+         * This is the type of function called to abandon
+         * an attempt to reconnect.
+         */
+        typedef std::function<void()> CancelDelegate;
+
+        /**
+         * This is the type of function called when an attempt to
+         * reconnect completes.
+         *
+         * @param[in] connection
+         *      This is the connection established, or nullptr
+         *      if the attempt failed.
+         */
+        typedef std::function<void(std::shared_ptr<MqttV5::Connection> connection)>
+            ReconnectCompletionDelegate;
+
+        /**
+         * This is the type of function called to start an attempt to
+         * establish a new network connection to the same target.
+         *
+         * @param[in] dataReceivedDelegate
+         *      This is the function to call to deliver data
+         *      received on the new connection.
+         * @param[in] brokenDelegate
+         *      This is the function to call once the new
+         *      connection is broken.
+         * @param[in] completionDelegate
+         *      This is the function to call, exactly once,
+         *      when the attempt completes.
+         * @return
+         *      A function which abandons the attempt is returned.
+         */
+        typedef std::function<CancelDelegate(
+            MqttV5::Connection::DataReceivedDelegate dataReceivedDelegate,
+            MqttV5::Connection::BrokenDelegate brokenDelegate,
+            ReconnectCompletionDelegate completionDelegate)>
+            ReconnectDelegate;
+
+        /**
+         * This is the type of function called each time a break is over,
+         * either because the session was resumed or because it
+         * had to be reported.
+         *
+         * @param[in] resumed
+         *      This indicates whether or not the session was resumed.
+         */
+        typedef std::function<void(bool resumed)> OutcomeDelegate;
+
+        /**
+         * This holds the settings of the connection.
+         */
+        struct Settings
+        {
+            /**
+             * This is the most bytes of packets held while there is
+             * no network connection.  Sending more reports the break.
+             */
+            size_t bufferBytes = 65536;
+
+            /**
+             * This is the number of attempts made to reconnect
+             * after each break before reporting it.
+             */
+            unsigned attempts = 5;
+
+            /**
+             * This is the least time between the starts of
+             * successive attempts to reconnect.
+             */
+            std::chrono::milliseconds retryDelay{100};
+
+            /**
+             * This is the most bytes a received packet may take.
+             * A larger packet is treated as malformed data.
+             */
+            size_t maximumPacketSize = 1048576;
+        };
+
+        // Lifecycle management
+    public:
+        ~ResumingConnection() noexcept;
+        ResumingConnection(const ResumingConnection&) = delete;
+        ResumingConnection(ResumingConnection&&) noexcept = delete;
+        ResumingConnection& operator=(const ResumingConnection&) = delete;
+        ResumingConnection& operator=(ResumingConnection&&) noexcept = delete;
+
+        // Public methods
+    public:
+        /**
+         * This is the constructor.
+         *
+         * @param[in] settings
+         *      These are the settings of the connection.
+         * @param[in] timerQueue
+         *      This is used to delay attempts to reconnect.  If it is
+         *      nullptr, attempts aren't delayed.
+         * @param[in] reconnectDelegate
+         *      This is the function to call to establish
+         *      a new network connection.
+         * @param[in] outcomeDelegate
+         *      This is the function to call each time a break is over.
+         * @param[in] diagnosticsSender
+         *      This is used to report breaks and their outcomes.
+         * @param[in] peerId
+         *      This identifies the connection in diagnostic messages.
+         */
+        ResumingConnection(const Settings& settings, std::shared_ptr<TimerQueue> timerQueue,
+                           ReconnectDelegate reconnectDelegate, OutcomeDelegate outcomeDelegate,
+                           std::shared_ptr<SystemUtils::DiagnosticsSender> diagnosticsSender,
+                           const std::string& peerId);
+
+        /**
+         * This method returns the function to give the first network
+         * connection, to deliver the data it receives.
+         *
+         * @return
+         *      The delegate for the first network connection is returned.
+         */
+        MqttV5::Connection::DataReceivedDelegate GetDataReceivedDelegate();
+
+        /**
+         * This method returns the function to give the first network
+         * connection, to call once it is broken.
+         *
+         * @return
+         *      The delegate for the first network connection is returned.
+         */
+        MqttV5::Connection::BrokenDelegate GetBrokenDelegate();
+
+        /**
+         * This method puts the first network connection, established
+         * with the delegates returned by GetDataReceivedDelegate and
+         * GetBrokenDelegate, under this connection.
+         *
+         * @param[in] connection
+         *      This is the first network connection.
+         */
+        void Attach(std::shared_ptr<MqttV5::Connection> connection);
+
+        // MqttV5::Connection
+    public:
+        virtual std::string GetPeerId() override;
+        virtual void SetDataReceivedDelegate(DataReceivedDelegate dataReceivedDelegate) override;
+        virtual void SetConnectionBrokenDelegate(BrokenDelegate brokenDelegate) override;
+        virtual void SendData(const std::vector<uint8_t>& data) override;
+        virtual void Break(bool clean) override;
+
+        // MqttNetworkTransport::ZeroCopyConnection
+    public:
+        virtual void SendData(std::vector<uint8_t>&& data) override;
+        virtual void SendData(SharedBuffer data) override;
+        virtual ConnectionStatistics GetConnectionStatistics() override;
+
+        // Private properties
+    private:
+        /**
+         * This is the type of structure that contains the private
+         * properties of the instance.  It is defined in the implementation
+         * and declared here to ensure that it is scoped inside the class.
+         */
+        struct Impl;
+
+        /**
+         * This contains the private properties of the instance.  It is
+         * shared with the delegates of the network connections and the
+         * attempts to reconnect, which may outlive the connection.
+         */
+        std::shared_ptr<Impl> impl_;
+    };
+}  // namespace MqttNetworkTransport
+
+#endif /** MQTT_NETWORK_TRANSPORT_RESUMING_CONNECTION_HPP */
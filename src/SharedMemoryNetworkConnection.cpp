@@ -0,0 +1,717 @@
+/**
+ * @file SharedMemoryNetworkConnection.cpp
+ *
+ * This module implements the
+ * MqttNetworkTransport::SharedMemoryNetworkConnection class.
+ *
+ * © 2025 by Hatem Nabli
+ */
+
+#include "SharedMemoryNetworkConnection.hpp"
+#include "SharedMemoryRing.hpp"
+#include <deque>
+#include <errno.h>
+#include <fcntl.h>
+#include <mutex>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+namespace
+{
+    /**
+     * This is the maximum number of bytes delivered at once.
+     */
+    constexpr size_t MAXIMUM_READ_SIZE = 65536;
+
+    /**
+     * This is the least number of bytes of data each ring holds.
+     */
+    constexpr size_t MINIMUM_RING_CAPACITY = 4096;
+
+    /**
+     * This is what the client sends first, when setting up the connection.
+     */
+    constexpr char HANDSHAKE_MAGIC[8] = {'M', 'Q', 'T', 'T', 'S', 'H', 'M', '1'};
+
+    /**
+     * This is what the peer replies to accept the connection.
+     */
+    constexpr uint8_t HANDSHAKE_ACCEPTED = 1;
+
+    /**
+     * This is how long to wait for the peer to accept the connection.
+     */
+    constexpr time_t HANDSHAKE_TIMEOUT_SECONDS = 5;
+
+    /**
+     * This function tells the processor that the calling thread
+     * is polling, so it can spare resources for other threads.
+     */
+    void CpuRelax() {
+#if defined(__x86_64__) || defined(__i386__)
+        __builtin_ia32_pause();
+#elif defined(__aarch64__)
+        __asm__ __volatile__("yield");
+#endif
+    }
+
+    /**
+     * This function returns the capacity of the rings to make,
+     * given the capacity requested.
+     *
+     * @param[in] requested
+     *      This is the capacity requested.
+     * @return
+     *      The least power of two which is at least the capacity
+     *      requested and MINIMUM_RING_CAPACITY is returned.
+     */
+    size_t RoundUpCapacity(size_t requested) {
+        size_t capacity = MINIMUM_RING_CAPACITY;
+        while ((capacity < requested) && (capacity <= (size_t)UINT32_MAX / 2))
+        { capacity *= 2; }
+        return capacity;
+    }
+}  // namespace
+
+namespace MqttNetworkTransport
+{
+    struct SharedMemoryNetworkConnection::Impl : public std::enable_shared_from_this<Impl>
+    {
+        /**
+         * This is the pool of event loops waiting for the peer's signals.
+         */
+        std::shared_ptr<EventLoopPool> eventLoopPool;
+
+        /**
+         * This is a helper object used to generate and publish diagnostics messages.
+         */
+        std::shared_ptr<SystemUtils::DiagnosticsSender> diagnosticsSender;
+
+        /**
+         * This is used to synchronize access to the connection state.
+         */
+        std::recursive_mutex mutex;
+
+        /**
+         * This is the address of the Unix domain socket
+         * at which the peer accepts connections.
+         */
+        SocketAddress peerSocketAddress;
+
+        /**
+         * This is the number of bytes of data each ring holds.
+         */
+        size_t ringCapacity = 0;
+
+        /**
+         * This is how long to keep polling the ring of data received,
+         * once it is empty, before sleeping until the peer signals.
+         */
+        std::chrono::microseconds spinTime;
+
+        /**
+         * If not null, this is where to take the buffers in which
+         * received data is delivered.
+         */
+        std::shared_ptr<ReceiveBufferPool> receiveBufferPool;
+
+        /**
+         * This is the socket over which the connection was set up, which
+         * stays open for as long as the connection, or -1 if there is none.
+         */
+        int sock = -1;
+
+        /**
+         * This is the eventfd object the peer signals
+         * and the connection waits on.
+         */
+        int waitFd = -1;
+
+        /**
+         * This is the eventfd object the connection signals
+         * and the peer waits on.
+         */
+        int signalFd = -1;
+
+        /**
+         * This is the memory shared with the peer, holding the rings.
+         * It stays mapped for as long as the instance.
+         */
+        void* memory = MAP_FAILED;
+
+        /**
+         * This is the number of bytes of memory shared with the peer.
+         */
+        size_t memorySize = 0;
+
+        /**
+         * This is the ring of data sent to the peer.
+         */
+        std::unique_ptr<SharedMemoryRing> sendRing;
+
+        /**
+         * This is the ring of data received from the peer.  Only the
+         * loop thread waiting for the peer's signals reads from it.
+         */
+        std::unique_ptr<SharedMemoryRing> receiveRing;
+
+        /**
+         * This is the registration of the eventfd object
+         * the connection waits on with the event loop pool.
+         */
+        EventLoopPool::Registration waitRegistration;
+
+        /**
+         * This is the registration of the socket with the event loop
+         * pool, which notices when the peer closes the connection.
+         */
+        EventLoopPool::Registration socketRegistration;
+
+        /**
+         * This is the delegate to call whenever data is received.
+         * It is only set before the connection is registered with
+         * the event loop, so the loop reads it without locking.
+         */
+        MessageReceivedDelegate messageReceivedDelegate;
+
+        /**
+         * This is the delegate to call once the connection is broken.
+         */
+        BrokenDelegate brokenDelegate;
+
+        /**
+         * These are the messages waiting for space in the ring
+         * of data sent.
+         */
+        std::deque<OutgoingMessage> outputQueue;
+
+        /**
+         * This is the number of bytes of the front message of the
+         * output queue which have already been written to the ring.
+         */
+        size_t outputOffset = 0;
+
+        /**
+         * This indicates whether or not a clean close was requested, in
+         * which case the connection is closed once the output queue drains.
+         */
+        bool closing = false;
+
+        /**
+         * This is the constructor for the structure.
+         */
+        Impl() :
+            diagnosticsSender(std::make_shared<SystemUtils::DiagnosticsSender>(
+                "SharedMemoryNetworkConnection")) {}
+
+        /**
+         * This is the destructor for the structure.
+         */
+        ~Impl() noexcept {
+            if (waitFd >= 0)
+            { (void)close(waitFd); }
+            if (signalFd >= 0)
+            { (void)close(signalFd); }
+            if (memory != MAP_FAILED)
+            { (void)munmap(memory, memorySize); }
+        }
+
+        /**
+         * This method makes the memory shared with the peer, along with
+         * the rings in it, and the eventfd objects used to signal.
+         * The caller must hold the mutex.
+         *
+         * @param[out] error
+         *      This is where to store a description of what went wrong,
+         *      if the memory or eventfd objects could not be made.
+         * @return
+         *      The descriptor of the memory file is returned,
+         *      or -1 if anything could not be made.
+         */
+        int MakeRings(std::string& error) {
+            const auto ringSize = SharedMemoryRing::GetSize(ringCapacity);
+            const int memoryFd = memfd_create("mqtt-shm", MFD_CLOEXEC);
+            if (memoryFd < 0)
+            {
+                error = std::string("memfd_create: ") + strerror(errno);
+                return -1;
+            }
+            if (ftruncate(memoryFd, (off_t)(2 * ringSize)) != 0)
+            {
+                error = std::string("ftruncate: ") + strerror(errno);
+                (void)close(memoryFd);
+                return -1;
+            }
+            memory = mmap(nullptr, 2 * ringSize, PROT_READ | PROT_WRITE, MAP_SHARED, memoryFd, 0);
+            if (memory == MAP_FAILED)
+            {
+                error = std::string("mmap: ") + strerror(errno);
+                (void)close(memoryFd);
+                return -1;
+            }
+            memorySize = 2 * ringSize;
+            sendRing.reset(new SharedMemoryRing(memory, ringCapacity, true));
+            receiveRing.reset(
+                new SharedMemoryRing((uint8_t*)memory + ringSize, ringCapacity, true));
+            waitFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+            signalFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+            if ((waitFd < 0) || (signalFd < 0))
+            {
+                error = std::string("eventfd: ") + strerror(errno);
+                (void)close(memoryFd);
+                return -1;
+            }
+            return memoryFd;
+        }
+
+        /**
+         * This method hands the memory file and eventfd objects to the
+         * peer over the given socket, and waits for the peer to accept
+         * the connection.
+         *
+         * @param[in] newSock
+         *      This is the socket connected to the peer.
+         * @param[in] memoryFd
+         *      This is the descriptor of the memory file.
+         * @param[out] error
+         *      This is where to store a description of what went wrong,
+         *      if the peer did not accept the connection.
+         * @return
+         *      An indication of whether or not the peer
+         *      accepted the connection is returned.
+         */
+        bool Handshake(int newSock, int memoryFd, std::string& error) {
+            struct timeval timeout;
+            timeout.tv_sec = HANDSHAKE_TIMEOUT_SECONDS;
+            timeout.tv_usec = 0;
+            (void)setsockopt(newSock, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+            (void)setsockopt(newSock, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+            uint8_t request[sizeof(HANDSHAKE_MAGIC) + sizeof(uint32_t)];
+            const uint32_t capacity = (uint32_t)ringCapacity;
+            (void)memcpy(request, HANDSHAKE_MAGIC, sizeof(HANDSHAKE_MAGIC));
+            (void)memcpy(request + sizeof(HANDSHAKE_MAGIC), &capacity, sizeof(capacity));
+            struct iovec vector;
+            vector.iov_base = request;
+            vector.iov_len = sizeof(request);
+            const int fds[3] = {memoryFd, signalFd, waitFd};
+            union
+            {
+                struct cmsghdr header;
+                char buffer[CMSG_SPACE(sizeof(fds))];
+            } control;
+            (void)memset(&control, 0, sizeof(control));
+            struct msghdr header;
+            (void)memset(&header, 0, sizeof(header));
+            header.msg_iov = &vector;
+            header.msg_iovlen = 1;
+            header.msg_control = control.buffer;
+            header.msg_controllen = sizeof(control.buffer);
+            const auto rights = CMSG_FIRSTHDR(&header);
+            rights->cmsg_level = SOL_SOCKET;
+            rights->cmsg_type = SCM_RIGHTS;
+            rights->cmsg_len = CMSG_LEN(sizeof(fds));
+            (void)memcpy(CMSG_DATA(rights), fds, sizeof(fds));
+            if (sendmsg(newSock, &header, MSG_NOSIGNAL) != (ssize_t)sizeof(request))
+            {
+                error = std::string("sendmsg: ") + strerror(errno);
+                return false;
+            }
+            uint8_t reply = 0;
+            const auto amount = recv(newSock, &reply, sizeof(reply), 0);
+            if (amount < 0)
+            {
+                error = std::string("recv: ") + strerror(errno);
+                return false;
+            }
+            if ((amount == 0) || (reply != HANDSHAKE_ACCEPTED))
+            {
+                error = "rejected by peer";
+                return false;
+            }
+            return true;
+        }
+
+        /**
+         * This method wakes up the peer, which is waiting on the
+         * eventfd object the connection signals.
+         */
+        void Signal() {
+            const uint64_t increment = 1;
+            (void)write(signalFd, &increment, sizeof(increment));
+        }
+
+        /**
+         * This method writes as much of the output queue to the ring
+         * of data sent as fits, waking the peer if it sleeps, and asks
+         * the peer to signal once there is space for any that remains.
+         * The caller must hold the mutex.
+         */
+        void Flush() {
+            for (;;)
+            {
+                bool wrote = false;
+                while (!outputQueue.empty())
+                {
+                    const auto& bytes = outputQueue.front().Bytes();
+                    const auto amount =
+                        sendRing->Write(bytes.data() + outputOffset, bytes.size() - outputOffset);
+                    wrote = (wrote || (amount > 0));
+                    outputOffset += amount;
+                    if (outputOffset < bytes.size())
+                    { break; }
+                    outputQueue.pop_front();
+                    outputOffset = 0;
+                }
+                if (wrote && sendRing->ShouldWakeConsumer())
+                { Signal(); }
+                if (outputQueue.empty() || sendRing->PrepareToWaitForSpace())
+                { break; }
+            }
+            if (sendRing->IsCorrupt())
+            {
+                diagnosticsSender->SendDiagnosticInformationString(
+                    SystemUtils::DiagnosticsSender::Levels::ERROR,
+                    "peer corrupted the ring of data sent");
+                Shutdown(false);
+            } else if (closing && outputQueue.empty())
+            { Shutdown(true); }
+        }
+
+        /**
+         * This method is called from the loop thread whenever the peer
+         * signals, which means it wrote data while the connection slept,
+         * or freed space while the connection waited for it.
+         */
+        void OnSignal() {
+            uint64_t count;
+            (void)read(waitFd, &count, sizeof(count));
+            {
+                std::lock_guard<decltype(mutex)> lock(mutex);
+                if (sock < 0)
+                { return; }
+                if (!outputQueue.empty())
+                { Flush(); }
+            }
+            Receive();
+        }
+
+        /**
+         * This method is called from a loop thread whenever the socket
+         * has pending events, which normally means the peer closed it.
+         *
+         * @param[in] events
+         *      These are the pending epoll events.
+         */
+        void OnSocketEvents(uint32_t events) {
+            std::lock_guard<decltype(mutex)> lock(mutex);
+            if ((sock < 0) || (socketRegistration.id == 0))
+            { return; }
+            if ((events & (EPOLLRDHUP | EPOLLHUP | EPOLLERR)) == 0)
+            {
+                uint8_t discard[64];
+                const auto amount = recv(sock, discard, sizeof(discard), 0);
+                if ((amount > 0) || ((amount < 0) && (errno == EAGAIN)))
+                { return; }
+            }
+            eventLoopPool->Remove(socketRegistration, sock);
+            socketRegistration = EventLoopPool::Registration();
+            diagnosticsSender->SendDiagnosticInformationString(
+                1, "connection closed gracefully by peer");
+            std::weak_ptr<Impl> implWeak(shared_from_this());
+            eventLoopPool->Post(waitRegistration.loop,
+                                [implWeak]
+                                {
+                                    const auto impl = implWeak.lock();
+                                    if (impl == nullptr)
+                                    { return; }
+                                    impl->Receive();
+                                    impl->Shutdown(true);
+                                });
+        }
+
+        /**
+         * This method delivers everything available in the ring of data
+         * received, polling it for a while once it is empty, and then
+         * asks the peer to signal once it writes more.  Only the loop
+         * thread waiting for the peer's signals calls it.
+         */
+        void Receive() {
+            bool spinning = false;
+            std::chrono::steady_clock::time_point spinDeadline;
+            for (;;)
+            {
+                const auto available = receiveRing->GetAvailable();
+                if (available > 0)
+                {
+                    const auto size = std::min(available, MAXIMUM_READ_SIZE);
+                    std::vector<uint8_t> buffer;
+                    if (receiveBufferPool != nullptr)
+                    { buffer = receiveBufferPool->Acquire(); }
+                    buffer.resize(size);
+                    receiveRing->Read(buffer.data(), size);
+                    if (receiveRing->ShouldWakeProducer())
+                    { Signal(); }
+                    {
+                        std::lock_guard<decltype(mutex)> lock(mutex);
+                        if (sock < 0)
+                        { return; }
+                    }
+                    if (messageReceivedDelegate != nullptr)
+                    { messageReceivedDelegate(buffer); }
+                    if (receiveBufferPool != nullptr)
+                    { receiveBufferPool->Release(std::move(buffer)); }
+                    spinning = false;
+                    continue;
+                }
+                if (receiveRing->IsCorrupt())
+                {
+                    diagnosticsSender->SendDiagnosticInformationString(
+                        SystemUtils::DiagnosticsSender::Levels::ERROR,
+                        "peer corrupted the ring of data received");
+                    Shutdown(false);
+                    return;
+                }
+                if (spinTime.count() != 0)
+                {
+                    const auto now = std::chrono::steady_clock::now();
+                    if (!spinning)
+                    {
+                        spinning = true;
+                        spinDeadline = now + spinTime;
+                    }
+                    if (now < spinDeadline)
+                    {
+                        CpuRelax();
+                        continue;
+                    }
+                }
+                if (receiveRing->PrepareToWaitForData())
+                { return; }
+            }
+        }
+
+        /**
+         * This method closes the socket, if it is still open, and arranges
+         * for the broken delegate to be called from the loop thread.
+         *
+         * @param[in] graceful
+         *      This indicates whether or not the connection was
+         *      closed gracefully.
+         */
+        void Shutdown(bool graceful) {
+            std::lock_guard<decltype(mutex)> lock(mutex);
+            if (sock < 0)
+            { return; }
+            const bool processing = (waitRegistration.id != 0);
+            if (processing)
+            { eventLoopPool->Remove(waitRegistration, waitFd); }
+            if (socketRegistration.id != 0)
+            { eventLoopPool->Remove(socketRegistration, sock); }
+            (void)close(sock);
+            sock = -1;
+            outputQueue.clear();
+            BrokenDelegate delegate;
+            delegate.swap(brokenDelegate);
+            if (processing && (delegate != nullptr))
+            {
+                eventLoopPool->Post(waitRegistration.loop,
+                                    [delegate, graceful] { delegate(graceful); });
+            }
+            waitRegistration = EventLoopPool::Registration();
+            socketRegistration = EventLoopPool::Registration();
+        }
+    };
+
+    SharedMemoryNetworkConnection::~SharedMemoryNetworkConnection() noexcept {
+        impl_->Shutdown(false);
+    }
+
+    SharedMemoryNetworkConnection::SharedMemoryNetworkConnection(
+        std::shared_ptr<EventLoopPool> eventLoopPool, size_t ringCapacity,
+        std::chrono::microseconds spinTime, std::shared_ptr<ReceiveBufferPool> receiveBufferPool) :
+        impl_(std::make_shared<Impl>()) {
+        impl_->eventLoopPool = eventLoopPool;
+        impl_->ringCapacity = RoundUpCapacity(ringCapacity);
+        impl_->spinTime = spinTime;
+        impl_->receiveBufferPool = receiveBufferPool;
+    }
+
+    SystemUtils::DiagnosticsSender::UnsubscribeDelegate
+    SharedMemoryNetworkConnection::SubscribeToDiagnostics(
+        SystemUtils::DiagnosticsSender::DiagnosticMessageDelegate delegate, size_t minLevel) {
+        return impl_->diagnosticsSender->SubscribeToDiagnostics(delegate, minLevel);
+    }
+
+    bool SharedMemoryNetworkConnection::Connect(uint32_t, uint16_t) {
+        std::lock_guard<decltype(impl_->mutex)> lock(impl_->mutex);
+        if ((impl_->sock >= 0) || (impl_->memory != MAP_FAILED))
+        { return false; }
+        if (impl_->peerSocketAddress.GetFamily() != AF_UNIX)
+        {
+            impl_->diagnosticsSender->SendDiagnosticInformationString(
+                SystemUtils::DiagnosticsSender::Levels::ERROR,
+                "no Unix domain socket address set for the peer");
+            return false;
+        }
+        std::string error;
+        const int memoryFd = impl_->MakeRings(error);
+        if (memoryFd < 0)
+        {
+            impl_->diagnosticsSender->SendDiagnosticInformationFormatted(
+                SystemUtils::DiagnosticsSender::Levels::ERROR,
+                "error making shared memory rings (%s)", error.c_str());
+            return false;
+        }
+        const int sock = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (sock < 0)
+        {
+            impl_->diagnosticsSender->SendDiagnosticInformationFormatted(
+                SystemUtils::DiagnosticsSender::Levels::ERROR, "error creating socket (%s)",
+                strerror(errno));
+            (void)close(memoryFd);
+            return false;
+        }
+        if (connect(sock, impl_->peerSocketAddress.Get(), impl_->peerSocketAddress.length) != 0)
+        {
+            impl_->diagnosticsSender->SendDiagnosticInformationFormatted(
+                SystemUtils::DiagnosticsSender::Levels::ERROR, "error in connect (%s)",
+                strerror(errno));
+            (void)close(memoryFd);
+            (void)close(sock);
+            return false;
+        }
+        const bool accepted = impl_->Handshake(sock, memoryFd, error);
+        (void)close(memoryFd);
+        if (!accepted)
+        {
+            impl_->diagnosticsSender->SendDiagnosticInformationFormatted(
+                SystemUtils::DiagnosticsSender::Levels::ERROR, "error in handshake (%s)",
+                error.c_str());
+            (void)close(sock);
+            return false;
+        }
+        impl_->sock = sock;
+        return true;
+    }
+
+    bool SharedMemoryNetworkConnection::Process(MessageReceivedDelegate messageReceivedDelegate,
+                                                BrokenDelegate brokenDelegate) {
+        std::lock_guard<decltype(impl_->mutex)> lock(impl_->mutex);
+        if ((impl_->sock < 0) || (impl_->waitRegistration.id != 0))
+        { return false; }
+        const int flags = fcntl(impl_->sock, F_GETFL, 0);
+        if ((flags < 0) || (fcntl(impl_->sock, F_SETFL, flags | O_NONBLOCK) < 0))
+        {
+            impl_->diagnosticsSender->SendDiagnosticInformationFormatted(
+                SystemUtils::DiagnosticsSender::Levels::ERROR,
+                "error making socket non-blocking (%s)", strerror(errno));
+            return false;
+        }
+        impl_->messageReceivedDelegate = messageReceivedDelegate;
+        impl_->brokenDelegate = brokenDelegate;
+        std::weak_ptr<Impl> implWeak(impl_);
+        impl_->waitRegistration = impl_->eventLoopPool->Add(
+            impl_->waitFd, EPOLLIN,
+            [implWeak](uint32_t)
+            {
+                const auto impl = implWeak.lock();
+                if (impl != nullptr)
+                { impl->OnSignal(); }
+            });
+        if (impl_->waitRegistration.id != 0)
+        {
+            impl_->socketRegistration = impl_->eventLoopPool->Add(
+                impl_->sock, EPOLLIN | EPOLLRDHUP,
+                [implWeak](uint32_t events)
+                {
+                    const auto impl = implWeak.lock();
+                    if (impl != nullptr)
+                    { impl->OnSocketEvents(events); }
+                });
+            if (impl_->socketRegistration.id == 0)
+            {
+                impl_->eventLoopPool->Remove(impl_->waitRegistration, impl_->waitFd);
+                impl_->waitRegistration = EventLoopPool::Registration();
+            }
+        }
+        if (impl_->waitRegistration.id == 0)
+        {
+            impl_->diagnosticsSender->SendDiagnosticInformationString(
+                SystemUtils::DiagnosticsSender::Levels::ERROR,
+                "unable to register connection with event loop");
+            return false;
+        }
+        impl_->eventLoopPool->Post(impl_->waitRegistration.loop,
+                                   [implWeak]
+                                   {
+                                       const auto impl = implWeak.lock();
+                                       if (impl != nullptr)
+                                       { impl->Receive(); }
+                                   });
+        return true;
+    }
+
+    uint32_t SharedMemoryNetworkConnection::GetPeerAddress() const { return 0; }
+
+    uint16_t SharedMemoryNetworkConnection::GetPeerPort() const { return 0; }
+
+    bool SharedMemoryNetworkConnection::IsConnected() const {
+        std::lock_guard<decltype(impl_->mutex)> lock(impl_->mutex);
+        return (impl_->sock >= 0);
+    }
+
+    uint32_t SharedMemoryNetworkConnection::GetBoundAddress() const { return 0; }
+
+    uint16_t SharedMemoryNetworkConnection::GetBoundPort() const { return 0; }
+
+    void SharedMemoryNetworkConnection::SendMessage(const std::vector<uint8_t>& message) {
+        SendMessage(OutgoingMessage(std::vector<uint8_t>(message)));
+    }
+
+    void SharedMemoryNetworkConnection::Close(bool clean) {
+        std::lock_guard<decltype(impl_->mutex)> lock(impl_->mutex);
+        if (clean && !impl_->outputQueue.empty())
+        {
+            impl_->closing = true;
+            impl_->Flush();
+        } else
+        { impl_->Shutdown(clean); }
+    }
+
+    void SharedMemoryNetworkConnection::SendMessage(OutgoingMessage&& message) {
+        std::lock_guard<decltype(impl_->mutex)> lock(impl_->mutex);
+        if ((impl_->sock < 0) || impl_->closing)
+        { return; }
+        const bool idle = impl_->outputQueue.empty();
+        impl_->outputQueue.push_back(std::move(message));
+        if (idle)
+        { impl_->Flush(); }
+    }
+
+    void SharedMemoryNetworkConnection::SendMessages(std::vector<OutgoingMessage>&& messages) {
+        std::lock_guard<decltype(impl_->mutex)> lock(impl_->mutex);
+        if ((impl_->sock < 0) || impl_->closing)
+        { return; }
+        const bool idle = impl_->outputQueue.empty();
+        for (auto& message : messages)
+        { impl_->outputQueue.push_back(std::move(message)); }
+        if (idle)
+        { impl_->Flush(); }
+    }
+
+    void SharedMemoryNetworkConnection::SetPeerSocketAddress(const SocketAddress& address) {
+        std::lock_guard<decltype(impl_->mutex)> lock(impl_->mutex);
+        impl_->peerSocketAddress = address;
+    }
+
+    SocketAddress SharedMemoryNetworkConnection::GetPeerSocketAddress() const {
+        std::lock_guard<decltype(impl_->mutex)> lock(impl_->mutex);
+        return impl_->peerSocketAddress;
+    }
+}  // namespace MqttNetworkTransport
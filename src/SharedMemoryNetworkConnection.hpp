@@ -0,0 +1,127 @@
+#ifndef MQTT_NETWORK_TRANSPORT_SHARED_MEMORY_NETWORK_CONNECTION_HPP
+#define MQTT_NETWORK_TRANSPORT_SHARED_MEMORY_NETWORK_CONNECTION_HPP
+/**
+ * @file SharedMemoryNetworkConnection.hpp
+ *
+ * This module declares the
+ * MqttNetworkTransport::SharedMemoryNetworkConnection class.
+ *
+ * © 2025 by Hatem Nabli
+ */
+
+#include "EventLoopPool.hpp"
+#include "GatherNetworkConnection.hpp"
+#include "ReceiveBufferPool.hpp"
+#include "SocketAddressConnection.hpp"
+#include <chrono>
+#include <memory>
+
+namespace MqttNetworkTransport
+{
+    /**
+     * This is an implementation of SystemUtils::INetworkConnection which
+     * exchanges data with a peer on the same host through a pair of
+     * SharedMemoryRing instances in a memory-mapped file, rather than
+     * through a socket.
+     *
+     * The connection is set up over a Unix domain stream socket, at the
+     * address set with SetPeerSocketAddress, as follows:
+     * - The client makes an anonymous memory file (memfd) holding two
+     *   rings with the same capacity: first the ring of data sent by the
+     *   client, then the ring of data sent by the peer.  Both rings
+     *   are empty.
+     * - The client makes two eventfd objects: one the peer waits on and
+     *   the client signals, then one the client waits on and the peer
+     *   signals.
+     * - The client sends the 8 bytes "MQTTSHM1" followed by the capacity
+     *   of each ring (32 bits, in the byte order of the host), along with
+     *   the memory file and the two eventfd objects, in that order,
+     *   as SCM_RIGHTS ancillary data.
+     * - The peer replies with the single byte 1 to accept.
+     *
+     * Each side signals the other's eventfd object only when it finds
+     * the other side sleeping, as flagged in the rings.  Either side
+     * closes the socket to close the connection, after which the other
+     * side reads what remains in its ring.
+     */
+    class SharedMemoryNetworkConnection : public GatherNetworkConnection,
+                                          public SocketAddressConnection
+    {
+        // Lifecycle management
+    public:
+        ~SharedMemoryNetworkConnection() noexcept;
+        SharedMemoryNetworkConnection(const SharedMemoryNetworkConnection&) = delete;
+        SharedMemoryNetworkConnection(SharedMemoryNetworkConnection&&) noexcept = delete;
+        SharedMemoryNetworkConnection& operator=(const SharedMemoryNetworkConnection&) = delete;
+        SharedMemoryNetworkConnection& operator=(SharedMemoryNetworkConnection&&) noexcept =
+            delete;
+
+        // Public methods
+    public:
+        /**
+         * This is the constructor.
+         *
+         * @param[in] eventLoopPool
+         *      This is the pool of event loops which will wait for
+         *      the peer's signals once the connection is processing.
+         * @param[in] ringCapacity
+         *      This is the number of bytes of data each ring holds.
+         *      It is rounded up to a power of two of at least 4096.
+         * @param[in] spinTime
+         *      This is how long to keep polling the ring of data received,
+         *      once it is empty, before sleeping until the peer signals.
+         * @param[in] receiveBufferPool
+         *      If not null, this is where to take the buffers in which
+         *      received data is delivered, and where they are given
+         *      back once delivered.
+         */
+        SharedMemoryNetworkConnection(std::shared_ptr<EventLoopPool> eventLoopPool,
+                                      size_t ringCapacity, std::chrono::microseconds spinTime,
+                                      std::shared_ptr<ReceiveBufferPool> receiveBufferPool =
+                                          nullptr);
+
+        // SystemUtils::INetworkConnection
+    public:
+        virtual SystemUtils::DiagnosticsSender::UnsubscribeDelegate SubscribeToDiagnostics(
+            SystemUtils::DiagnosticsSender::DiagnosticMessageDelegate delegate,
+            size_t minLevel = 0) override;
+        virtual bool Connect(uint32_t peerAddress, uint16_t peerPort) override;
+        virtual bool Process(MessageReceivedDelegate messageReceivedDelegate,
+                             BrokenDelegate brokenDelegate) override;
+        virtual uint32_t GetPeerAddress() const override;
+        virtual uint16_t GetPeerPort() const override;
+        virtual bool IsConnected() const override;
+        virtual uint32_t GetBoundAddress() const override;
+        virtual uint16_t GetBoundPort() const override;
+        virtual void SendMessage(const std::vector<uint8_t>& message) override;
+        virtual void Close(bool clean = false) override;
+
+        // GatherNetworkConnection
+    public:
+        virtual void SendMessage(OutgoingMessage&& message) override;
+        virtual void SendMessages(std::vector<OutgoingMessage>&& messages) override;
+
+        // SocketAddressConnection
+    public:
+        virtual void SetPeerSocketAddress(const SocketAddress& address) override;
+        virtual SocketAddress GetPeerSocketAddress() const override;
+
+        // Private properties
+    private:
+        /**
+         * This is the type of structure that contains the private
+         * properties of the instance.  It is defined in the implementation
+         * and declared here to ensure that it is scoped inside the class.
+         */
+        struct Impl;
+
+        /**
+         * This contains the private properties of the instance.  It is
+         * shared with the event loop, which may still be dispatching an
+         * event for the connection while the connection is destroyed.
+         */
+        std::shared_ptr<Impl> impl_;
+    };
+}  // namespace MqttNetworkTransport
+
+#endif /** MQTT_NETWORK_TRANSPORT_SHARED_MEMORY_NETWORK_CONNECTION_HPP */
@@ -0,0 +1,210 @@
+/**
+ * @file SharedMemoryRing.cpp
+ *
+ * This module implements the MqttNetworkTransport::SharedMemoryRing class.
+ *
+ * © 2025 by Hatem Nabli
+ */
+
+#include "SharedMemoryRing.hpp"
+#include <algorithm>
+#include <atomic>
+#include <new>
+#include <string.h>
+
+namespace
+{
+    /**
+     * This is the layout of the header of a ring, as described
+     * in SharedMemoryRing.hpp.
+     */
+    struct Header
+    {
+        alignas(64) std::atomic<uint64_t> head;
+        alignas(64) std::atomic<uint64_t> tail;
+        alignas(64) std::atomic<uint32_t> consumerWaiting;
+        std::atomic<uint32_t> producerWaiting;
+    };
+
+    static_assert(sizeof(Header) == MqttNetworkTransport::SharedMemoryRing::HEADER_SIZE,
+                  "shared memory ring header has the wrong size");
+    static_assert(ATOMIC_LLONG_LOCK_FREE == 2,
+                  "shared memory rings need lock-free 64-bit atomics");
+}  // namespace
+
+namespace MqttNetworkTransport
+{
+    constexpr size_t SharedMemoryRing::HEADER_SIZE;
+
+    struct SharedMemoryRing::Impl
+    {
+        /**
+         * This is the header of the ring.
+         */
+        Header* header = nullptr;
+
+        /**
+         * This is the data of the ring.
+         */
+        uint8_t* data = nullptr;
+
+        /**
+         * This is the number of bytes of data the ring holds.
+         */
+        size_t capacity = 0;
+
+        /**
+         * This is the producer's copy of the number of bytes it has
+         * written, and the last number of bytes read it saw, kept so
+         * that the producer touches the consumer's cache line only
+         * when the ring looks full.
+         */
+        uint64_t producerHead = 0;
+        uint64_t producerTail = 0;
+
+        /**
+         * This is the consumer's copy of the number of bytes it has
+         * read, and the last number of bytes written it saw, kept so
+         * that the consumer touches the producer's cache line only
+         * when the ring looks empty.
+         */
+        uint64_t consumerTail = 0;
+        uint64_t consumerHead = 0;
+
+        /**
+         * This indicates whether or not the other side was found to
+         * have left the header of the ring inconsistent.
+         */
+        bool corrupt = false;
+
+        /**
+         * This method updates the producer's copy of the number of
+         * bytes read, checking that it leaves the ring holding no more
+         * than its capacity.
+         *
+         * @return
+         *      An indication of whether or not the number of bytes
+         *      read is consistent is returned.
+         */
+        bool LoadTail() {
+            producerTail = header->tail.load(std::memory_order_acquire);
+            if (producerHead - producerTail > capacity)
+            { corrupt = true; }
+            return !corrupt;
+        }
+
+        /**
+         * This method updates the consumer's copy of the number of
+         * bytes written, checking that it leaves the ring holding no
+         * more than its capacity.
+         *
+         * @return
+         *      An indication of whether or not the number of bytes
+         *      written is consistent is returned.
+         */
+        bool LoadHead() {
+            consumerHead = header->head.load(std::memory_order_acquire);
+            if (consumerHead - consumerTail > capacity)
+            { corrupt = true; }
+            return !corrupt;
+        }
+    };
+
+    SharedMemoryRing::~SharedMemoryRing() noexcept = default;
+
+    SharedMemoryRing::SharedMemoryRing(void* memory, size_t capacity, bool initialize) :
+        impl_(new Impl) {
+        impl_->header = (Header*)memory;
+        impl_->data = (uint8_t*)memory + HEADER_SIZE;
+        impl_->capacity = capacity;
+        if (initialize)
+        {
+            (void)new (memory) Header();
+            impl_->header->head.store(0, std::memory_order_relaxed);
+            impl_->header->tail.store(0, std::memory_order_relaxed);
+            impl_->header->consumerWaiting.store(0, std::memory_order_relaxed);
+            impl_->header->producerWaiting.store(0, std::memory_order_release);
+        }
+        impl_->producerHead = impl_->header->head.load(std::memory_order_acquire);
+        impl_->producerTail = impl_->header->tail.load(std::memory_order_acquire);
+        impl_->consumerTail = impl_->producerTail;
+        impl_->consumerHead = impl_->producerHead;
+        impl_->corrupt = (impl_->producerHead - impl_->producerTail > capacity);
+    }
+
+    size_t SharedMemoryRing::GetSize(size_t capacity) { return HEADER_SIZE + capacity; }
+
+    size_t SharedMemoryRing::Write(const uint8_t* data, size_t size) {
+        if (impl_->corrupt)
+        { return 0; }
+        auto space = impl_->capacity - (size_t)(impl_->producerHead - impl_->producerTail);
+        if (space < size)
+        {
+            if (!impl_->LoadTail())
+            { return 0; }
+            space = impl_->capacity - (size_t)(impl_->producerHead - impl_->producerTail);
+        }
+        size = std::min(size, space);
+        if (size == 0)
+        { return 0; }
+        const auto offset = (size_t)(impl_->producerHead & (impl_->capacity - 1));
+        const auto first = std::min(size, impl_->capacity - offset);
+        (void)memcpy(impl_->data + offset, data, first);
+        (void)memcpy(impl_->data, data + first, size - first);
+        impl_->producerHead += size;
+        impl_->header->head.store(impl_->producerHead, std::memory_order_release);
+        return size;
+    }
+
+    bool SharedMemoryRing::IsCorrupt() const { return impl_->corrupt; }
+
+    size_t SharedMemoryRing::GetAvailable() {
+        if (impl_->corrupt)
+        { return 0; }
+        if ((impl_->consumerHead == impl_->consumerTail) && !impl_->LoadHead())
+        { return 0; }
+        return (size_t)(impl_->consumerHead - impl_->consumerTail);
+    }
+
+    void SharedMemoryRing::Read(uint8_t* buffer, size_t size) {
+        if (impl_->corrupt)
+        { return; }
+        size = std::min(size, (size_t)(impl_->consumerHead - impl_->consumerTail));
+        const auto offset = (size_t)(impl_->consumerTail & (impl_->capacity - 1));
+        const auto first = std::min(size, impl_->capacity - offset);
+        (void)memcpy(buffer, impl_->data + offset, first);
+        (void)memcpy(buffer + first, impl_->data, size - first);
+        impl_->consumerTail += size;
+        impl_->header->tail.store(impl_->consumerTail, std::memory_order_release);
+    }
+
+    bool SharedMemoryRing::PrepareToWaitForData() {
+        impl_->header->consumerWaiting.store(1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (!impl_->LoadHead() || (impl_->consumerHead == impl_->consumerTail))
+        { return true; }
+        (void)impl_->header->consumerWaiting.exchange(0, std::memory_order_seq_cst);
+        return false;
+    }
+
+    bool SharedMemoryRing::PrepareToWaitForSpace() {
+        impl_->header->producerWaiting.store(1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (!impl_->LoadTail() || (impl_->producerHead - impl_->producerTail == impl_->capacity))
+        { return true; }
+        (void)impl_->header->producerWaiting.exchange(0, std::memory_order_seq_cst);
+        return false;
+    }
+
+    bool SharedMemoryRing::ShouldWakeConsumer() {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        return ((impl_->header->consumerWaiting.load(std::memory_order_relaxed) != 0) &&
+                (impl_->header->consumerWaiting.exchange(0, std::memory_order_seq_cst) != 0));
+    }
+
+    bool SharedMemoryRing::ShouldWakeProducer() {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        return ((impl_->header->producerWaiting.load(std::memory_order_relaxed) != 0) &&
+                (impl_->header->producerWaiting.exchange(0, std::memory_order_seq_cst) != 0));
+    }
+}  // namespace MqttNetworkTransport
@@ -0,0 +1,195 @@
+#ifndef MQTT_NETWORK_TRANSPORT_SHARED_MEMORY_RING_HPP
+#define MQTT_NETWORK_TRANSPORT_SHARED_MEMORY_RING_HPP
+/**
+ * @file SharedMemoryRing.hpp
+ *
+ * This module declares the MqttNetworkTransport::SharedMemoryRing class.
+ *
+ * © 2025 by Hatem Nabli
+ */
+
+#include <memory>
+#include <stddef.h>
+#include <stdint.h>
+
+namespace MqttNetworkTransport
+{
+    /**
+     * This is a lock-free ring buffer of bytes, in memory which may be
+     * shared between processes, with a single producer and a single
+     * consumer.
+     *
+     * The ring starts with a header of HEADER_SIZE bytes, followed by
+     * the data.  The header holds, each on a cache line of its own:
+     * - at offset 0, the total number of bytes ever written (64 bits),
+     *   which only the producer changes;
+     * - at offset 64, the total number of bytes ever read (64 bits),
+     *   which only the consumer changes;
+     * - at offset 128, a flag (32 bits) set by the consumer when it is
+     *   about to sleep until data arrives, followed at offset 132 by a
+     *   flag (32 bits) set by the producer when it is about to sleep
+     *   until space is freed.
+     *
+     * Whoever sees the other side's flag set clears it, and is then
+     * responsible for waking the other side up, so that wakeups are
+     * only needed when a side is idle.
+     *
+     * The other side may be another process, which isn't trusted to keep
+     * the header consistent.  If the counts in the header ever differ by
+     * more than the capacity, the ring is corrupt: from then on nothing
+     * more is written to it or read from it.
+     */
+    class SharedMemoryRing
+    {
+    public:
+        /**
+         * This is the size of the header at the start of the ring.
+         */
+        static constexpr size_t HEADER_SIZE = 192;
+
+        // Lifecycle management
+    public:
+        ~SharedMemoryRing() noexcept;
+        SharedMemoryRing(const SharedMemoryRing&) = delete;
+        SharedMemoryRing(SharedMemoryRing&&) noexcept = delete;
+        SharedMemoryRing& operator=(const SharedMemoryRing&) = delete;
+        SharedMemoryRing& operator=(SharedMemoryRing&&) noexcept = delete;
+
+        // Public methods
+    public:
+        /**
+         * This is the constructor.
+         *
+         * @param[in] memory
+         *      This points to the start of the ring, which must be
+         *      aligned to a cache line and span GetSize(capacity) bytes.
+         *      It must outlive the instance.
+         * @param[in] capacity
+         *      This is the number of bytes of data the ring holds.
+         *      It must be a power of two.
+         * @param[in] initialize
+         *      This indicates whether or not to make the ring empty,
+         *      which must be done once, before either side uses it.
+         */
+        SharedMemoryRing(void* memory, size_t capacity, bool initialize);
+
+        /**
+         * This function returns the number of bytes spanned by a ring
+         * holding the given number of bytes of data.
+         *
+         * @param[in] capacity
+         *      This is the number of bytes of data the ring holds.
+         * @return
+         *      The number of bytes spanned by the ring is returned.
+         */
+        static size_t GetSize(size_t capacity);
+
+        /**
+         * This method copies as much of the given data into the ring as
+         * fits, and makes it available to the consumer.  It may only
+         * be called by the producer.
+         *
+         * @param[in] data
+         *      This points to the data to write.
+         * @param[in] size
+         *      This is the number of bytes to write.
+         * @return
+         *      The number of bytes written is returned.
+         */
+        size_t Write(const uint8_t* data, size_t size);
+
+        /**
+         * This method returns whether or not the other side was found
+         * to have left the header of the ring inconsistent.
+         *
+         * @return
+         *      An indication of whether or not the ring
+         *      is corrupt is returned.
+         */
+        bool IsCorrupt() const;
+
+        /**
+         * This method returns the number of bytes which may be read.
+         * It may only be called by the consumer.
+         *
+         * @return
+         *      The number of bytes which may be read is returned.
+         */
+        size_t GetAvailable();
+
+        /**
+         * This method copies data out of the ring, freeing the space
+         * it took for the producer.  It may only be called by the
+         * consumer.  No more than the number of bytes GetAvailable
+         * last returned are read.
+         *
+         * @param[out] buffer
+         *      This is where to copy the data.
+         * @param[in] size
+         *      This is the number of bytes to read.
+         */
+        void Read(uint8_t* buffer, size_t size);
+
+        /**
+         * This method lets the producer know that the consumer is about
+         * to sleep, unless data has arrived in the meantime.  It may
+         * only be called by the consumer.
+         *
+         * @return
+         *      An indication of whether or not the consumer may sleep is
+         *      returned.  If not, data arrived and should be read.  The
+         *      consumer may always sleep once the ring is corrupt.
+         */
+        bool PrepareToWaitForData();
+
+        /**
+         * This method lets the consumer know that the producer is about
+         * to sleep, unless space has been freed in the meantime.  It may
+         * only be called by the producer.
+         *
+         * @return
+         *      An indication of whether or not the producer may sleep is
+         *      returned.  If not, space was freed and should be used.  The
+         *      producer may always sleep once the ring is corrupt.
+         */
+        bool PrepareToWaitForSpace();
+
+        /**
+         * This method determines whether or not the consumer is sleeping
+         * and must be woken up, now that data was written, taking on the
+         * duty of waking it up.  It may only be called by the producer.
+         *
+         * @return
+         *      An indication of whether or not the consumer
+         *      must be woken up is returned.
+         */
+        bool ShouldWakeConsumer();
+
+        /**
+         * This method determines whether or not the producer is sleeping
+         * and must be woken up, now that space was freed, taking on the
+         * duty of waking it up.  It may only be called by the consumer.
+         *
+         * @return
+         *      An indication of whether or not the producer
+         *      must be woken up is returned.
+         */
+        bool ShouldWakeProducer();
+
+        // Private properties
+    private:
+        /**
+         * This is the type of structure that contains the private
+         * properties of the instance.  It is defined in the implementation
+         * and declared here to ensure that it is scoped inside the class.
+         */
+        struct Impl;
+
+        /**
+         * This contains the private properties of the instance.
+         */
+        std::unique_ptr<Impl> impl_;
+    };
+}  // namespace MqttNetworkTransport
+
+#endif /** MQTT_NETWORK_TRANSPORT_SHARED_MEMORY_RING_HPP */
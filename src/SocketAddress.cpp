@@ -0,0 +1,96 @@
+/**
+ * @file SocketAddress.cpp
+ *
+ * This module implements the MqttNetworkTransport::SocketAddress structure.
+ *
+ * © 2025 by Hatem Nabli
+ */
+
+#include "SocketAddress.hpp"
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/un.h>
+
+namespace MqttNetworkTransport
+{
+    SocketAddress::SocketAddress() { (void)memset(&storage, 0, sizeof(storage)); }
+
+    SocketAddress SocketAddress::FromIpv4(uint32_t address, uint16_t port) {
+        SocketAddress socketAddress;
+        const auto ipv4 = (struct sockaddr_in*)&socketAddress.storage;
+        ipv4->sin_family = AF_INET;
+        ipv4->sin_addr.s_addr = htonl(address);
+        ipv4->sin_port = htons(port);
+        socketAddress.length = sizeof(*ipv4);
+        return socketAddress;
+    }
+
+    SocketAddress SocketAddress::FromIpv6(const uint8_t address[16], uint16_t port,
+                                          uint32_t scopeId) {
+        SocketAddress socketAddress;
+        const auto ipv6 = (struct sockaddr_in6*)&socketAddress.storage;
+        ipv6->sin6_family = AF_INET6;
+        (void)memcpy(ipv6->sin6_addr.s6_addr, address, 16);
+        ipv6->sin6_port = htons(port);
+        ipv6->sin6_scope_id = scopeId;
+        socketAddress.length = sizeof(*ipv6);
+        return socketAddress;
+    }
+
+    SocketAddress SocketAddress::FromUnixPath(const std::string& path) {
+        SocketAddress socketAddress;
+        const auto local = (struct sockaddr_un*)&socketAddress.storage;
+        const bool abstract = (!path.empty() && (path[0] == '@'));
+        if (path.empty() || (path.length() >= sizeof(local->sun_path)) ||
+            (path.find('\0') != std::string::npos))
+        { return socketAddress; }
+        local->sun_family = AF_UNIX;
+        (void)memcpy(local->sun_path, path.data(), path.length());
+        if (abstract)
+        {
+            local->sun_path[0] = '\0';
+            socketAddress.length =
+                (socklen_t)(offsetof(struct sockaddr_un, sun_path) + path.length());
+        } else
+        { socketAddress.length = (socklen_t)sizeof(*local); }
+        return socketAddress;
+    }
+
+    std::string SocketAddress::ToString() const {
+        if (GetFamily() == AF_INET)
+        {
+            const auto ipv4 = (const struct sockaddr_in*)&storage;
+            const auto address = ntohl(ipv4->sin_addr.s_addr);
+            char buffer[22];
+            (void)snprintf(buffer, sizeof(buffer), "%u.%u.%u.%u:%u",
+                           (unsigned int)((address >> 24) & 0xFF),
+                           (unsigned int)((address >> 16) & 0xFF),
+                           (unsigned int)((address >> 8) & 0xFF), (unsigned int)(address & 0xFF),
+                           (unsigned int)ntohs(ipv4->sin_port));
+            return buffer;
+        } else if (GetFamily() == AF_INET6)
+        {
+            const auto ipv6 = (const struct sockaddr_in6*)&storage;
+            char buffer[INET6_ADDRSTRLEN];
+            if (inet_ntop(AF_INET6, &ipv6->sin6_addr, buffer, sizeof(buffer)) == nullptr)
+            { return ""; }
+            std::string text = "[" + std::string(buffer);
+            if (ipv6->sin6_scope_id != 0)
+            { text += "%" + std::to_string(ipv6->sin6_scope_id); }
+            return text + "]:" + std::to_string(ntohs(ipv6->sin6_port));
+        } else if (GetFamily() == AF_UNIX)
+        {
+            const auto local = (const struct sockaddr_un*)&storage;
+            if (local->sun_path[0] == '\0')
+            {
+                return "@" + std::string(local->sun_path + 1,
+                                         length - offsetof(struct sockaddr_un, sun_path) - 1);
+            }
+            return local->sun_path;
+        }
+        return "";
+    }
+}  // namespace MqttNetworkTransport
@@ -0,0 +1,121 @@
+#ifndef MQTT_NETWORK_TRANSPORT_SOCKET_ADDRESS_HPP
+#define MQTT_NETWORK_TRANSPORT_SOCKET_ADDRESS_HPP
+/**
+ * @file SocketAddress.hpp
+ *
+ * This module declares the MqttNetworkTransport::SocketAddress structure.
+ *
+ * © 2025 by Hatem Nabli
+ */
+
+#include <string>
+#include <stdint.h>
+#include <sys/socket.h>
+
+namespace MqttNetworkTransport
+{
+    /**
+     * This holds the address of a stream socket peer, of any family
+     * the connections support, in the form given to connect().
+     */
+    struct SocketAddress
+    {
+        /**
+         * This holds the address.
+         */
+        struct sockaddr_storage storage;
+
+        /**
+         * This is the number of bytes of the storage used by the
+         * address, or zero if there is no address.
+         */
+        socklen_t length = 0;
+
+        /**
+         * This is the default constructor, which makes an empty address.
+         */
+        SocketAddress();
+
+        /**
+         * This function makes the address of the given IPv4 address
+         * and TCP port.
+         *
+         * @param[in] address
+         *      This is the IPv4 address, in host byte order.
+         * @param[in] port
+         *      This is the TCP port.
+         * @return
+         *      The address is returned.
+         */
+        static SocketAddress FromIpv4(uint32_t address, uint16_t port);
+
+        /**
+         * This function makes the address of the given IPv6 address
+         * and TCP port.
+         *
+         * @param[in] address
+         *      These are the 16 bytes of the IPv6 address,
+         *      in network byte order.
+         * @param[in] port
+         *      This is the TCP port.
+         * @param[in] scopeId
+         *      This is the scope (interface) of a link-local
+         *      address, or zero.
+         * @return
+         *      The address is returned.
+         */
+        static SocketAddress FromIpv6(const uint8_t address[16], uint16_t port,
+                                      uint32_t scopeId = 0);
+
+        /**
+         * This function makes the address of the Unix domain socket at
+         * the given path.  A path starting with '@' names a socket in
+         * the Linux abstract namespace, without the '@'.
+         *
+         * @param[in] path
+         *      This is the path of the socket.
+         * @return
+         *      The address is returned.  It is empty if the path
+         *      is empty or too long.
+         */
+        static SocketAddress FromUnixPath(const std::string& path);
+
+        /**
+         * This method returns whether or not there is no address.
+         *
+         * @return
+         *      An indication of whether or not there is
+         *      no address is returned.
+         */
+        bool IsEmpty() const { return (length == 0); }
+
+        /**
+         * This method returns the address family of the address.
+         *
+         * @return
+         *      The address family (AF_INET, AF_INET6 or AF_UNIX) is returned,
+         *      or AF_UNSPEC if there is no address.
+         */
+        int GetFamily() const { return (IsEmpty() ? AF_UNSPEC : storage.ss_family); }
+
+        /**
+         * This method returns the address in the form given to connect().
+         *
+         * @return
+         *      The address is returned.
+         */
+        const struct sockaddr* Get() const { return (const struct sockaddr*)&storage; }
+
+        /**
+         * This method returns a human-readable form of the address: the
+         * path of a Unix domain socket, "a.b.c.d:port" for IPv4,
+         * or "[address]:port" for IPv6.
+         *
+         * @return
+         *      The human-readable form of the address is returned.
+         */
+        std::string ToString() const;
+    };
+}  // namespace MqttNetworkTransport
+
+#endif /** MQTT_NETWORK_TRANSPORT_SOCKET_ADDRESS_HPP */
@@ -0,0 +1,47 @@
+#ifndef MQTT_NETWORK_TRANSPORT_SOCKET_ADDRESS_CONNECTION_HPP
+#define MQTT_NETWORK_TRANSPORT_SOCKET_ADDRESS_CONNECTION_HPP
+/**
+ * @file SocketAddressConnection.hpp
+ *
+ * This module declares the MqttNetworkTransport::SocketAddressConnection
+ * interface.
+ *
+ * © 2025 by Hatem Nabli
+ */
+
+#include "SocketAddress.hpp"
+
+namespace MqttNetworkTransport
+{
+    /**
+     * This is implemented by socket-based network connections which can
+     * connect to peers other than those named by an IPv4 address and
+     * TCP port, such as Unix domain sockets.
+     */
+    class SocketAddressConnection
+    {
+    public:
+        virtual ~SocketAddressConnection() = default;
+
+        /**
+         * This method sets the address to which the connection is made.
+         * It must be called before connecting, and the address and port
+         * then given to Connect or ConnectAsync are ignored.
+         *
+         * @param[in] address
+         *      This is the address of the peer.
+         */
+        virtual void SetPeerSocketAddress(const SocketAddress& address) = 0;
+
+        /**
+         * This method returns the address set with SetPeerSocketAddress.
+         *
+         * @return
+         *      The address set for the peer is returned.  It is
+         *      empty if none was set.
+         */
+        virtual SocketAddress GetPeerSocketAddress() const = 0;
+    };
+}  // namespace MqttNetworkTransport
+
+#endif /** MQTT_NETWORK_TRANSPORT_SOCKET_ADDRESS_CONNECTION_HPP */
@@ -0,0 +1,123 @@
+/**
+ * @file TimerQueue.cpp
+ *
+ * This module implements the MqttNetworkTransport::TimerQueue class.
+ *
+ * © 2025 by Hatem Nabli
+ */
+
+#include "TimerQueue.hpp"
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+namespace MqttNetworkTransport
+{
+    struct TimerQueue::Impl
+    {
+        /**
+         * This is used to synchronize access to the timers.
+         */
+        std::mutex mutex;
+
+        /**
+         * This is used to wake the timer thread when the earliest
+         * timer changes or the queue is stopping.
+         */
+        std::condition_variable wakeCondition;
+
+        /**
+         * These are the scheduled timers, ordered by due time.
+         */
+        std::multimap<std::chrono::steady_clock::time_point, std::pair<Token, Callback>> timers;
+
+        /**
+         * This maps the token of each scheduled timer to its entry.
+         */
+        std::map<Token, decltype(timers)::iterator> timersByToken;
+
+        /**
+         * This is the token to give the next scheduled timer.
+         */
+        Token nextToken = 1;
+
+        /**
+         * This flag indicates whether or not the timer thread should stop.
+         */
+        bool stop = false;
+
+        /**
+         * This is the thread which calls the expired timers.
+         */
+        std::thread thread;
+
+        /**
+         * This is the body of the timer thread.
+         */
+        void Run() {
+            std::unique_lock<decltype(mutex)> lock(mutex);
+            while (!stop)
+            {
+                if (timers.empty())
+                {
+                    wakeCondition.wait(lock);
+                    continue;
+                }
+                const auto earliest = timers.begin();
+                const auto due = earliest->first;
+                if (due > std::chrono::steady_clock::now())
+                {
+                    wakeCondition.wait_until(lock, due);
+                    continue;
+                }
+                {
+                    const auto callback = std::move(earliest->second.second);
+                    (void)timersByToken.erase(earliest->second.first);
+                    (void)timers.erase(earliest);
+                    lock.unlock();
+                    callback();
+                }
+                lock.lock();
+            }
+        }
+    };
+
+    TimerQueue::~TimerQueue() noexcept {
+        {
+            std::lock_guard<decltype(impl_->mutex)> lock(impl_->mutex);
+            impl_->stop = true;
+            impl_->wakeCondition.notify_all();
+        }
+        if (impl_->thread.get_id() == std::this_thread::get_id())
+        { impl_->thread.detach(); } else
+        { impl_->thread.join(); }
+    }
+
+    TimerQueue::TimerQueue() : impl_(std::make_shared<Impl>()) {
+        const auto impl = impl_;
+        impl_->thread = std::thread([impl] { impl->Run(); });
+    }
+
+    auto TimerQueue::Schedule(std::chrono::steady_clock::time_point due, Callback callback)
+        -> Token {
+        std::lock_guard<decltype(impl_->mutex)> lock(impl_->mutex);
+        const auto token = impl_->nextToken++;
+        const auto timer =
+            impl_->timers.insert(std::make_pair(due, std::make_pair(token, std::move(callback))));
+        impl_->timersByToken[token] = timer;
+        if (timer == impl_->timers.begin())
+        { impl_->wakeCondition.notify_all(); }
+        return token;
+    }
+
+    void TimerQueue::Cancel(Token token) {
+        std::lock_guard<decltype(impl_->mutex)> lock(impl_->mutex);
+        const auto timer = impl_->timersByToken.find(token);
+        if (timer == impl_->timersByToken.end())
+        { return; }
+        (void)impl_->timers.erase(timer->second);
+        (void)impl_->timersByToken.erase(timer);
+    }
+}  // namespace MqttNetworkTransport
@@ -0,0 +1,90 @@
+#ifndef MQTT_NETWORK_TRANSPORT_TIMER_QUEUE_HPP
+#define MQTT_NETWORK_TRANSPORT_TIMER_QUEUE_HPP
+/**
+ * @file TimerQueue.hpp
+ *
+ * This module declares the MqttNetworkTransport::TimerQueue class.
+ *
+ * © 2025 by Hatem Nabli
+ */
+
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <stdint.h>
+
+namespace MqttNetworkTransport
+{
+    /**
+     * This calls functions at scheduled times, from a single thread
+     * shared by everything scheduled with the queue.
+     */
+    class TimerQueue
+    {
+    public:
+        /**
+         * This is the type of function called when a timer expires.
+         */
+        typedef std::function<void()> Callback;
+
+        /**
+         * This identifies a scheduled timer.  Zero is never used.
+         */
+        typedef uint64_t Token;
+
+        // Lifecycle management
+    public:
+        ~TimerQueue() noexcept;
+        TimerQueue(const TimerQueue&) = delete;
+        TimerQueue(TimerQueue&&) noexcept = delete;
+        TimerQueue& operator=(const TimerQueue&) = delete;
+        TimerQueue& operator=(TimerQueue&&) noexcept = delete;
+
+        // Public methods
+    public:
+        /**
+         * This is the default constructor.  It starts the timer thread.
+         */
+        TimerQueue();
+
+        /**
+         * This method schedules the given function to be called
+         * from the timer thread at the given time.
+         *
+         * @param[in] due
+         *      This is when to call the function.
+         * @param[in] callback
+         *      This is the function to call.
+         * @return
+         *      The token identifying the timer is returned.
+         */
+        Token Schedule(std::chrono::steady_clock::time_point due, Callback callback);
+
+        /**
+         * This method cancels the timer with the given token, if it
+         * hasn't expired yet.
+         *
+         * @param[in] token
+         *      This identifies the timer to cancel.
+         */
+        void Cancel(Token token);
+
+        // Private properties
+    private:
+        /**
+         * This is the type of structure that contains the private
+         * properties of the instance.  It is defined in the implementation
+         * and declared here to ensure that it is scoped inside the class.
+         */
+        struct Impl;
+
+        /**
+         * This contains the private properties of the instance.  It is
+         * shared with the timer thread, so that the queue may be
+         * released from within a callback.
+         */
+        std::shared_ptr<Impl> impl_;
+    };
+}  // namespace MqttNetworkTransport
+
+#endif /** MQTT_NETWORK_TRANSPORT_TIMER_QUEUE_HPP */
@@ -0,0 +1,544 @@
+/**
+ * @file TlsContext.cpp
+ *
+ * This module implements the MqttNetworkTransport::TlsContext class.
+ *
+ * © 2025 by Hatem Nabli
+ */
+
+#include "TlsContext.hpp"
+#include "HostResolver.hpp"
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <string.h>
+#include <time.h>
+#include <openssl/err.h>
+#include <openssl/kdf.h>
+#include <openssl/x509v3.h>
+
+#if defined(__linux__)
+#    include <linux/tls.h>
+#endif
+
+namespace
+{
+    /**
+     * This is the most sessions kept in the process-wide session cache.
+     */
+    constexpr size_t MAXIMUM_CACHED_SESSIONS = 1024;
+
+    /**
+     * This holds the sessions established by all TLS contexts of the
+     * process, keyed by server, so that they can be resumed by later
+     * connections to the same servers.
+     */
+    class SessionCache
+    {
+    public:
+        /**
+         * This method returns the session cached for the given server,
+         * if it is still resumable.
+         *
+         * @param[in] key
+         *      This identifies the server.
+         * @param[in] forEarlyData
+         *      This indicates whether or not the session will be used to
+         *      send early data.  If so, and the session permits early data,
+         *      it is taken out of the cache, because servers reject early
+         *      data sent more than once with the same session ticket.
+         * @return
+         *      The cached session, or a copy of it, is returned, which
+         *      the caller must free, or nullptr if there is none.
+         */
+        SSL_SESSION* Get(const std::string& key, bool forEarlyData) {
+            std::lock_guard<decltype(mutex_)> lock(mutex_);
+            const auto entry = sessions_.find(key);
+            if (entry == sessions_.end())
+            { return nullptr; }
+            const auto session = entry->second.session;
+            const auto expiration =
+                (time_t)SSL_SESSION_get_time(session) + (time_t)SSL_SESSION_get_timeout(session);
+            if ((SSL_SESSION_is_resumable(session) == 0) || (expiration <= time(nullptr)))
+            {
+                SSL_SESSION_free(session);
+                (void)sessions_.erase(entry);
+                return nullptr;
+            }
+            if (forEarlyData && (SSL_SESSION_get_max_early_data(session) > 0))
+            {
+                (void)sessions_.erase(entry);
+                return session;
+            }
+            return SSL_SESSION_dup(session);
+        }
+
+        /**
+         * This method caches the given session for the given server,
+         * replacing any session already cached for it.  If the cache is
+         * full, the least recently cached session is dropped.
+         *
+         * @param[in] key
+         *      This identifies the server.
+         * @param[in] session
+         *      This is the session to cache.  The cache takes
+         *      over the caller's reference to it.
+         */
+        void Put(const std::string& key, SSL_SESSION* session) {
+            std::lock_guard<decltype(mutex_)> lock(mutex_);
+            auto entry = sessions_.find(key);
+            if (entry == sessions_.end())
+            {
+                if (sessions_.size() >= MAXIMUM_CACHED_SESSIONS)
+                {
+                    auto oldest = sessions_.begin();
+                    for (auto candidate = sessions_.begin(); candidate != sessions_.end();
+                         ++candidate)
+                    {
+                        if (candidate->second.sequence < oldest->second.sequence)
+                        { oldest = candidate; }
+                    }
+                    SSL_SESSION_free(oldest->second.session);
+                    (void)sessions_.erase(oldest);
+                }
+                entry = sessions_.insert(std::make_pair(key, Entry())).first;
+            } else
+            { SSL_SESSION_free(entry->second.session); }
+            entry->second.session = session;
+            entry->second.sequence = nextSequence_++;
+        }
+
+    private:
+        /**
+         * This holds a cached session.
+         */
+        struct Entry
+        {
+            /**
+             * This is the cached session.
+             */
+            SSL_SESSION* session = nullptr;
+
+            /**
+             * This orders the entries by when they were cached.
+             */
+            uint64_t sequence = 0;
+        };
+
+        /**
+         * This is used to synchronize access to the cache.
+         */
+        std::mutex mutex_;
+
+        /**
+         * These are the cached sessions, keyed by server.
+         */
+        std::map<std::string, Entry> sessions_;
+
+        /**
+         * This is the sequence number to give the next cached session.
+         */
+        uint64_t nextSequence_ = 0;
+    };
+
+    /**
+     * This function returns the process-wide session cache.  It is never
+     * destroyed, so that it remains usable, and doesn't call into
+     * OpenSSL, while the process exits.
+     *
+     * @return
+     *      The process-wide session cache is returned.
+     */
+    SessionCache& GetSessionCache() {
+        static SessionCache* cache = new SessionCache();
+        return *cache;
+    }
+
+    /**
+     * This function frees the session key attached to an OpenSSL
+     * connection object when the object is freed.
+     */
+    void FreeSessionKey(void*, void* pointer, CRYPTO_EX_DATA*, int, long, void*) {
+        delete (std::string*)pointer;
+    }
+
+    /**
+     * This function returns the index under which the session key of
+     * each OpenSSL connection object is attached to it.
+     *
+     * @return
+     *      The index of the session key is returned.
+     */
+    int GetSessionKeyIndex() {
+        static const int index = SSL_get_ex_new_index(0, nullptr, nullptr, nullptr, FreeSessionKey);
+        return index;
+    }
+
+    /**
+     * This function is called by OpenSSL whenever a new session (or,
+     * with TLS 1.3, a new session ticket) is received from a server.
+     * A copy of the session is cached, because OpenSSL marks the session
+     * of a connection as not resumable if the connection is closed
+     * without a TLS shutdown, which would otherwise spoil the cached
+     * session each time a broken connection is released.
+     *
+     * @param[in] ssl
+     *      This is the OpenSSL connection object which received the session.
+     * @param[in] session
+     *      This is the new session.
+     * @return
+     *      Zero is returned, so that OpenSSL releases its own
+     *      reference to the session.
+     */
+    int OnNewSession(SSL* ssl, SSL_SESSION* session) {
+        const auto key = (const std::string*)SSL_get_ex_data(ssl, GetSessionKeyIndex());
+        if (key == nullptr)
+        { return 0; }
+        const auto copy = SSL_SESSION_dup(session);
+        if (copy != nullptr)
+        { GetSessionCache().Put(*key, copy); }
+        return 0;
+    }
+
+    /**
+     * This function frees the traffic secret attached to an OpenSSL
+     * connection object when the object is freed.
+     */
+    void FreeTrafficSecret(void*, void* pointer, CRYPTO_EX_DATA*, int, long, void*) {
+        const auto secret = (std::vector<uint8_t>*)pointer;
+        if (secret == nullptr)
+        { return; }
+        OPENSSL_cleanse(secret->data(), secret->size());
+        delete secret;
+    }
+
+    /**
+     * This function returns the index under which the secret from which
+     * the client's application data keys are derived is attached to each
+     * OpenSSL connection object of contexts which keep keys for
+     * kernel offload.
+     *
+     * @return
+     *      The index of the traffic secret is returned.
+     */
+    int GetTrafficSecretIndex() {
+        static const int index =
+            SSL_get_ex_new_index(0, nullptr, nullptr, nullptr, FreeTrafficSecret);
+        return index;
+    }
+
+    /**
+     * This function returns the value of the given hexadecimal digit.
+     *
+     * @param[in] digit
+     *      This is the digit to convert.
+     * @return
+     *      The value of the digit is returned, or -1 if
+     *      it isn't a hexadecimal digit.
+     */
+    int HexDigitValue(char digit) {
+        if ((digit >= '0') && (digit <= '9'))
+        { return digit - '0'; }
+        if ((digit >= 'a') && (digit <= 'f'))
+        { return digit - 'a' + 10; }
+        if ((digit >= 'A') && (digit <= 'F'))
+        { return digit - 'A' + 10; }
+        return -1;
+    }
+
+    /**
+     * This function is called by OpenSSL with each secret established
+     * by a handshake, in the NSS key log format.  The secret from which
+     * the client's first application data keys are derived is attached
+     * to the connection, so that the encryption of the connection can be
+     * handed to the kernel once the handshake completes.  Nothing is
+     * logged.
+     *
+     * @param[in] ssl
+     *      This is the OpenSSL connection object which
+     *      established the secret.
+     * @param[in] line
+     *      This is the key log line describing the secret.
+     */
+    void OnKeyLog(const SSL* ssl, const char* line) {
+        static const char label[] = "CLIENT_TRAFFIC_SECRET_0 ";
+        if (strncmp(line, label, sizeof(label) - 1) != 0)
+        { return; }
+        auto digits = strchr(line + sizeof(label) - 1, ' ');
+        if (digits == nullptr)
+        { return; }
+        ++digits;
+        const auto secret = new std::vector<uint8_t>();
+        for (; (HexDigitValue(digits[0]) >= 0) && (HexDigitValue(digits[1]) >= 0); digits += 2)
+        { secret->push_back((uint8_t)((HexDigitValue(digits[0]) << 4) | HexDigitValue(digits[1]))); }
+        const auto index = GetTrafficSecretIndex();
+        FreeTrafficSecret(nullptr, SSL_get_ex_data(ssl, index), nullptr, index, 0, nullptr);
+        (void)SSL_set_ex_data((SSL*)ssl, index, secret);
+    }
+
+#if defined(__linux__)
+    /**
+     * This function derives a key from the given TLS 1.3 traffic secret
+     * with the HKDF-Expand-Label function of RFC 8446.
+     *
+     * @param[in] digest
+     *      This is the hash function of the cipher suite.
+     * @param[in] secret
+     *      This is the traffic secret.
+     * @param[in] label
+     *      This is the label distinguishing the key to derive.
+     * @param[out] output
+     *      This is where to store the derived key.
+     * @param[in] outputSize
+     *      This is the number of bytes to derive.
+     * @return
+     *      An indication of whether or not the key
+     *      was derived is returned.
+     */
+    bool ExpandLabel(const EVP_MD* digest, const std::vector<uint8_t>& secret,
+                     const std::string& label, uint8_t* output, size_t outputSize) {
+        const auto fullLabel = "tls13 " + label;
+        std::vector<uint8_t> info;
+        info.push_back((uint8_t)(outputSize >> 8));
+        info.push_back((uint8_t)outputSize);
+        info.push_back((uint8_t)fullLabel.size());
+        info.insert(info.end(), fullLabel.begin(), fullLabel.end());
+        info.push_back(0);
+        const auto derivation = EVP_PKEY_CTX_new_id(EVP_PKEY_HKDF, nullptr);
+        if (derivation == nullptr)
+        { return false; }
+        size_t derived = outputSize;
+        const bool success =
+            ((EVP_PKEY_derive_init(derivation) > 0) &&
+             (EVP_PKEY_CTX_set_hkdf_mode(derivation, EVP_PKEY_HKDEF_MODE_EXPAND_ONLY) > 0) &&
+             (EVP_PKEY_CTX_set_hkdf_md(derivation, digest) > 0) &&
+             (EVP_PKEY_CTX_set1_hkdf_key(derivation, secret.data(), (int)secret.size()) > 0) &&
+             (EVP_PKEY_CTX_add1_hkdf_info(derivation, info.data(), (int)info.size()) > 0) &&
+             (EVP_PKEY_derive(derivation, output, &derived) > 0) && (derived == outputSize));
+        EVP_PKEY_CTX_free(derivation);
+        return success;
+    }
+
+    /**
+     * This function fills in the kernel's description of how to encrypt
+     * the records of a TLS 1.3 connection from its first application
+     * data record on.
+     *
+     * @param[out] info
+     *      This is the description to fill in.
+     * @param[in] cipherType
+     *      This identifies the cipher to the kernel.
+     * @param[in] key
+     *      This is the write key.
+     * @param[in] iv
+     *      This is the write initialization vector, which the kernel
+     *      splits into its salt and initialization vector.
+     * @param[out] cryptoInfo
+     *      This is where to store the description.
+     */
+    template <typename Info>
+    void MakeCryptoInfo(Info& info, uint16_t cipherType, const uint8_t* key, const uint8_t* iv,
+                        std::vector<uint8_t>& cryptoInfo) {
+        (void)memset(&info, 0, sizeof(info));
+        info.info.version = TLS_1_3_VERSION;
+        info.info.cipher_type = cipherType;
+        (void)memcpy(info.key, key, sizeof(info.key));
+        (void)memcpy(info.salt, iv, sizeof(info.salt));
+        (void)memcpy(info.iv, iv + sizeof(info.salt), sizeof(info.iv));
+        cryptoInfo.assign((const uint8_t*)&info, (const uint8_t*)&info + sizeof(info));
+        OPENSSL_cleanse(&info, sizeof(info));
+    }
+#endif
+}  // namespace
+
+namespace MqttNetworkTransport
+{
+    struct TlsContext::Impl
+    {
+        /**
+         * This is the OpenSSL client context.
+         */
+        SSL_CTX* context = nullptr;
+
+        /**
+         * This is prefixed to the keys of the sessions of the context in
+         * the session cache.  It distinguishes contexts with different
+         * trust settings, since a resumed session skips verifying the
+         * server's certificate, so a session must only be resumed by
+         * contexts which would have accepted its server.
+         */
+        std::string sessionScope;
+
+        /**
+         * These are the counters of the handshakes of the context.
+         */
+        std::atomic<uint64_t> handshakes{0};
+        std::atomic<uint64_t> resumedHandshakes{0};
+        std::atomic<uint64_t> earlyDataAccepted{0};
+        std::atomic<uint64_t> earlyDataRejected{0};
+        std::atomic<uint64_t> kernelOffloads{0};
+    };
+
+    TlsContext::~TlsContext() noexcept {
+        if (impl_->context != nullptr)
+        { SSL_CTX_free(impl_->context); }
+    }
+
+    TlsContext::TlsContext() : impl_(new Impl) {}
+
+    std::shared_ptr<TlsContext> TlsContext::Create(const std::string& caFile, bool verifyPeer,
+                                                   bool kernelOffload, std::string& error) {
+        std::shared_ptr<TlsContext> tlsContext(new TlsContext());
+        const auto context = SSL_CTX_new(TLS_client_method());
+        if (context == nullptr)
+        {
+            error = "unable to make TLS context";
+            return nullptr;
+        }
+        tlsContext->impl_->context = context;
+        tlsContext->impl_->sessionScope = (verifyPeer ? "verified:" + caFile : "unverified") + "|";
+        (void)SSL_CTX_set_min_proto_version(context, TLS1_2_VERSION);
+        (void)SSL_CTX_set_session_cache_mode(context, SSL_SESS_CACHE_CLIENT |
+                                                          SSL_SESS_CACHE_NO_INTERNAL_STORE);
+        SSL_CTX_sess_set_new_cb(context, OnNewSession);
+        if (kernelOffload)
+        { SSL_CTX_set_keylog_callback(context, OnKeyLog); }
+        if (verifyPeer)
+        {
+            const int loaded =
+                (caFile.empty() ? SSL_CTX_set_default_verify_paths(context)
+                                : SSL_CTX_load_verify_locations(context, caFile.c_str(), nullptr));
+            if (loaded != 1)
+            {
+                char reason[256];
+                ERR_error_string_n(ERR_get_error(), reason, sizeof(reason));
+                error = std::string("unable to load trusted certificates (") + reason + ")";
+                return nullptr;
+            }
+            SSL_CTX_set_verify(context, SSL_VERIFY_PEER, nullptr);
+        } else
+        { SSL_CTX_set_verify(context, SSL_VERIFY_NONE, nullptr); }
+        return tlsContext;
+    }
+
+    SSL* TlsContext::NewConnection(const std::string& serverName, const std::string& sessionKey,
+                                   bool earlyData) {
+        const auto ssl = SSL_new(impl_->context);
+        if (ssl == nullptr)
+        { return nullptr; }
+        const auto scopedSessionKey = impl_->sessionScope + sessionKey;
+        (void)SSL_set_ex_data(ssl, GetSessionKeyIndex(), new std::string(scopedSessionKey));
+        uint32_t address;
+        if (HostResolver::ParseDottedQuad(serverName, address) ||
+            (serverName.find(':') != std::string::npos))
+        { (void)X509_VERIFY_PARAM_set1_ip_asc(SSL_get0_param(ssl), serverName.c_str()); } else
+        {
+            (void)SSL_set_tlsext_host_name(ssl, serverName.c_str());
+            (void)SSL_set1_host(ssl, serverName.c_str());
+        }
+        SSL_set_connect_state(ssl);
+        const auto session = GetSessionCache().Get(scopedSessionKey, earlyData);
+        if (session != nullptr)
+        {
+            (void)SSL_set_session(ssl, session);
+            SSL_SESSION_free(session);
+        }
+        return ssl;
+    }
+
+    void TlsContext::CountHandshake(SSL* ssl) {
+        ++impl_->handshakes;
+        if (SSL_session_reused(ssl) != 0)
+        { ++impl_->resumedHandshakes; }
+        switch (SSL_get_early_data_status(ssl))
+        {
+            case SSL_EARLY_DATA_ACCEPTED:
+                ++impl_->earlyDataAccepted;
+                break;
+
+            case SSL_EARLY_DATA_REJECTED:
+                ++impl_->earlyDataRejected;
+                break;
+
+            default:
+                break;
+        }
+    }
+
+    bool TlsContext::MakeKernelTlsTransmitInfo(SSL* ssl, std::vector<uint8_t>& cryptoInfo) {
+#if defined(__linux__)
+        const auto index = GetTrafficSecretIndex();
+        const auto secret = (std::vector<uint8_t>*)SSL_get_ex_data(ssl, index);
+        const auto cipher = SSL_get_current_cipher(ssl);
+        if ((secret == nullptr) || (cipher == nullptr) || (SSL_version(ssl) != TLS1_3_VERSION))
+        { return false; }
+        const auto cipherId = (SSL_CIPHER_get_id(cipher) & 0xFFFF);
+        size_t keySize = 0;
+        switch (cipherId)
+        {
+            case 0x1301:  // TLS_AES_128_GCM_SHA256
+                keySize = TLS_CIPHER_AES_GCM_128_KEY_SIZE;
+                break;
+
+            case 0x1302:  // TLS_AES_256_GCM_SHA384
+                keySize = TLS_CIPHER_AES_GCM_256_KEY_SIZE;
+                break;
+
+#    if defined(TLS_CIPHER_CHACHA20_POLY1305)
+            case 0x1303:  // TLS_CHACHA20_POLY1305_SHA256
+                keySize = TLS_CIPHER_CHACHA20_POLY1305_KEY_SIZE;
+                break;
+#    endif
+
+            default:
+                return false;
+        }
+        uint8_t key[32];
+        uint8_t iv[12];
+        const auto digest = SSL_CIPHER_get_handshake_digest(cipher);
+        bool made = false;
+        if ((digest != nullptr) && ExpandLabel(digest, *secret, "key", key, keySize) &&
+            ExpandLabel(digest, *secret, "iv", iv, sizeof(iv)))
+        {
+            made = true;
+            if (cipherId == 0x1301)
+            {
+                struct tls12_crypto_info_aes_gcm_128 info;
+                MakeCryptoInfo(info, TLS_CIPHER_AES_GCM_128, key, iv, cryptoInfo);
+            } else if (cipherId == 0x1302)
+            {
+                struct tls12_crypto_info_aes_gcm_256 info;
+                MakeCryptoInfo(info, TLS_CIPHER_AES_GCM_256, key, iv, cryptoInfo);
+            }
+#    if defined(TLS_CIPHER_CHACHA20_POLY1305)
+            else
+            {
+                struct tls12_crypto_info_chacha20_poly1305 info;
+                MakeCryptoInfo(info, TLS_CIPHER_CHACHA20_POLY1305, key, iv, cryptoInfo);
+            }
+#    endif
+        }
+        OPENSSL_cleanse(key, sizeof(key));
+        OPENSSL_cleanse(iv, sizeof(iv));
+        FreeTrafficSecret(nullptr, secret, nullptr, index, 0, nullptr);
+        (void)SSL_set_ex_data(ssl, index, nullptr);
+        return made;
+#else
+        (void)ssl;
+        (void)cryptoInfo;
+        return false;
+#endif
+    }
+
+    void TlsContext::CountKernelOffload() { ++impl_->kernelOffloads; }
+
+    auto TlsContext::GetStatistics() const -> Statistics {
+        Statistics statistics;
+        statistics.handshakes = impl_->handshakes;
+        statistics.resumedHandshakes = impl_->resumedHandshakes;
+        statistics.earlyDataAccepted = impl_->earlyDataAccepted;
+        statistics.earlyDataRejected = impl_->earlyDataRejected;
+        statistics.kernelOffloads = impl_->kernelOffloads;
+        return statistics;
+    }
+}  // namespace MqttNetworkTransport
@@ -0,0 +1,181 @@
+#ifndef MQTT_NETWORK_TRANSPORT_TLS_CONTEXT_HPP
+#define MQTT_NETWORK_TRANSPORT_TLS_CONTEXT_HPP
+/**
+ * @file TlsContext.hpp
+ *
+ * This module declares the MqttNetworkTransport::TlsContext class.
+ *
+ * © 2025 by Hatem Nabli
+ */
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <stdint.h>
+#include <openssl/ssl.h>
+
+namespace MqttNetworkTransport
+{
+    /**
+     * This holds the OpenSSL client context shared by TLS connections
+     * made with the same settings.  Sessions established by any context
+     * are kept in a process-wide cache, keyed by trust settings, server
+     * name and port, so that later connections to the same server can
+     * resume them instead of performing a full handshake.
+     */
+    class TlsContext
+    {
+    public:
+        /**
+         * This holds the counters of the handshakes of a context.
+         */
+        struct Statistics
+        {
+            /**
+             * This is the number of handshakes completed.
+             */
+            uint64_t handshakes = 0;
+
+            /**
+             * This is the number of completed handshakes
+             * which resumed a cached session.
+             */
+            uint64_t resumedHandshakes = 0;
+
+            /**
+             * These are the numbers of completed handshakes in which
+             * early data was sent and accepted or rejected by the server.
+             */
+            uint64_t earlyDataAccepted = 0;
+            uint64_t earlyDataRejected = 0;
+
+            /**
+             * This is the number of connections whose encryption
+             * was handed to the kernel.
+             */
+            uint64_t kernelOffloads = 0;
+        };
+
+        // Lifecycle management
+    public:
+        ~TlsContext() noexcept;
+        TlsContext(const TlsContext&) = delete;
+        TlsContext(TlsContext&&) noexcept = delete;
+        TlsContext& operator=(const TlsContext&) = delete;
+        TlsContext& operator=(TlsContext&&) noexcept = delete;
+
+        // Public methods
+    public:
+        /**
+         * This function makes a new client context.
+         *
+         * @param[in] caFile
+         *      If not empty, this is the path of a PEM file holding the
+         *      certificates of the authorities trusted to sign server
+         *      certificates.  Otherwise, the system's default trusted
+         *      authorities are used.
+         * @param[in] verifyPeer
+         *      This indicates whether or not server certificates,
+         *      and the names in them, are verified.
+         * @param[in] kernelOffload
+         *      This indicates whether or not the keys with which the
+         *      client encrypts application data are kept, so that the
+         *      encryption can be handed to the kernel.
+         * @param[out] error
+         *      This is where to store a description of what went wrong,
+         *      if the context could not be made.
+         * @return
+         *      The new context is returned, or nullptr if it
+         *      could not be made.
+         */
+        static std::shared_ptr<TlsContext> Create(const std::string& caFile, bool verifyPeer,
+                                                  bool kernelOffload, std::string& error);
+
+        /**
+         * This method makes a new OpenSSL connection object set up to
+         * connect to the given server, resuming the session cached for it,
+         * if any.
+         *
+         * @param[in] serverName
+         *      This is the name or IPv4 literal of the server, which is
+         *      sent as the server name indication and checked against
+         *      its certificate.
+         * @param[in] sessionKey
+         *      This identifies the server in the session cache.
+         * @param[in] earlyData
+         *      This indicates whether or not the connection may send
+         *      early data, in which case a cached session permitting it
+         *      is taken out of the cache, so that it is used only once.
+         * @return
+         *      The new OpenSSL connection object is returned, or nullptr
+         *      if it could not be made.  The caller must free it
+         *      with SSL_free.
+         */
+        SSL* NewConnection(const std::string& serverName, const std::string& sessionKey,
+                           bool earlyData);
+
+        /**
+         * This method records the completion of a handshake.
+         *
+         * @param[in] ssl
+         *      This is the OpenSSL connection object whose
+         *      handshake completed.
+         */
+        void CountHandshake(SSL* ssl);
+
+        /**
+         * This method describes, in the form the Linux kernel TLS layer
+         * takes it, how to encrypt the application data the given
+         * connection sends from now on.  This is only possible for
+         * TLS 1.3 connections made by a context which keeps keys for
+         * kernel offload, whose handshake just completed, and which
+         * haven't sent any application data since.
+         *
+         * @param[in] ssl
+         *      This is the OpenSSL connection object whose
+         *      handshake completed.
+         * @param[out] cryptoInfo
+         *      This is where to store the kernel's description of the
+         *      cipher, keys and record sequence number to use.
+         * @return
+         *      An indication of whether or not the description
+         *      could be made is returned.
+         */
+        bool MakeKernelTlsTransmitInfo(SSL* ssl, std::vector<uint8_t>& cryptoInfo);
+
+        /**
+         * This method records that the encryption of a connection
+         * was handed to the kernel.
+         */
+        void CountKernelOffload();
+
+        /**
+         * This method returns the counters of the handshakes
+         * made with the context.
+         *
+         * @return
+         *      The statistics of the context are returned.
+         */
+        Statistics GetStatistics() const;
+
+        // Private methods
+    private:
+        TlsContext();
+
+        // Private properties
+    private:
+        /**
+         * This is the type of structure that contains the private
+         * properties of the instance.  It is defined in the implementation
+         * and declared here to ensure that it is scoped inside the class.
+         */
+        struct Impl;
+
+        /**
+         * This contains the private properties of the instance.
+         */
+        std::unique_ptr<Impl> impl_;
+    };
+}  // namespace MqttNetworkTransport
+
+#endif /** MQTT_NETWORK_TRANSPORT_TLS_CONTEXT_HPP */
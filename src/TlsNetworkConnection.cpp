@@ -0,0 +1,1044 @@
+/**
+ * @file TlsNetworkConnection.cpp
+ *
+ * This module implements the MqttNetworkTransport::TlsNetworkConnection
+ * class.
+ *
+ * © 2025 by Hatem Nabli
+ */
+
+#include "TlsNetworkConnection.hpp"
+#include "KernelTlsConnection.hpp"
+#include <deque>
+#include <future>
+#include <mutex>
+#include <openssl/err.h>
+#include <openssl/x509.h>
+
+namespace
+{
+    /**
+     * This is the maximum number of bytes decrypted at once.
+     */
+    constexpr size_t MAXIMUM_READ_SIZE = 16384;
+}  // namespace
+
+namespace MqttNetworkTransport
+{
+    struct TlsNetworkConnection::Impl : public std::enable_shared_from_this<Impl>
+    {
+        /**
+         * These are the stages through which the connection goes.
+         */
+        enum class State
+        {
+            /**
+             * No attempt to connect has been made yet.
+             */
+            Idle,
+
+            /**
+             * The inner connection is being established.
+             */
+            Connecting,
+
+            /**
+             * The TLS handshake is under way.
+             */
+            Handshaking,
+
+            /**
+             * The TLS handshake completed, and application
+             * data may be exchanged.
+             */
+            Established,
+
+            /**
+             * The connection was closed locally, and its breakage
+             * is delivered once the inner connection is broken.
+             */
+            Closing,
+
+            /**
+             * The connection failed or was broken.
+             */
+            Closed,
+        };
+
+        /**
+         * This is the connection which carries the TLS records.
+         */
+        std::shared_ptr<SystemUtils::INetworkConnection> inner;
+
+        /**
+         * If the inner connection takes ownership of the messages it
+         * sends, this is the same object as inner.
+         */
+        std::shared_ptr<GatherNetworkConnection> innerGather;
+
+        /**
+         * If the inner connection can establish itself without
+         * blocking, this is the same object as inner.
+         */
+        std::shared_ptr<AsyncNetworkConnection> innerAsync;
+
+        /**
+         * If the inner connection can hand the encryption of what it
+         * sends to the kernel, this is the same object as inner.
+         */
+        std::shared_ptr<KernelTlsConnection> innerKernelTls;
+
+        /**
+         * If the inner connection can be established with TCP Fast Open,
+         * this is the same object as inner.
+         */
+        std::shared_ptr<FastOpenConnection> innerFastOpen;
+
+        /**
+         * This indicates whether or not the encryption of what is sent
+         * was handed to the kernel, in which case messages are passed to
+         * the inner connection as they are, and OpenSSL is only used to
+         * decrypt what is received.
+         */
+        bool transmitOffloaded = false;
+
+        /**
+         * This is the client context with which the connection is secured.
+         */
+        std::shared_ptr<TlsContext> tlsContext;
+
+        /**
+         * This is the name or IPv4 literal of the server.
+         */
+        std::string serverName;
+
+        /**
+         * This is the pool of workers which perform handshakes.
+         */
+        std::shared_ptr<WorkerPool> handshakeWorkers;
+
+        /**
+         * This indicates whether or not the first message may be
+         * sent as TLS 1.3 early data.
+         */
+        bool earlyData = false;
+
+        /**
+         * This is the most bytes of early data the session being resumed
+         * permits, or zero if early data will not be sent.
+         */
+        size_t earlyDataLimit = 0;
+
+        /**
+         * This indicates whether or not the connect attempt completed
+         * before the handshake, so that the first message could be
+         * sent as early data.
+         */
+        bool connectedEarly = false;
+
+        /**
+         * This indicates whether or not the first handshake step
+         * has been queued.
+         */
+        bool handshakeStarted = false;
+
+        /**
+         * This is the message sent as early data, kept so that it can
+         * be sent again if the server rejects the early data.
+         */
+        OutgoingMessage earlyMessage;
+
+        /**
+         * This indicates whether or not a message was sent as early data.
+         */
+        bool earlyMessageSent = false;
+
+        /**
+         * This is the pool of workers which establish the inner
+         * connection, if it can only connect by blocking.
+         */
+        std::shared_ptr<WorkerPool> connectWorkers;
+
+        /**
+         * This is a helper object used to generate and publish diagnostics messages.
+         */
+        std::shared_ptr<SystemUtils::DiagnosticsSender> diagnosticsSender;
+
+        /**
+         * This is used to synchronize access to the TLS state
+         * of the connection.
+         */
+        std::recursive_mutex mutex;
+
+        /**
+         * This is the stage the connection has reached.
+         */
+        State state = State::Idle;
+
+        /**
+         * This is the OpenSSL connection object.
+         */
+        SSL* ssl = nullptr;
+
+        /**
+         * These are the memory buffers through which OpenSSL reads the
+         * records received, and writes the records to send.  They are
+         * owned by the OpenSSL connection object.
+         */
+        BIO* input = nullptr;
+        BIO* output = nullptr;
+
+        /**
+         * This is the delegate to call once the connect attempt completes,
+         * while one is in progress.
+         */
+        ConnectDelegate connectDelegate;
+
+        /**
+         * These are the messages sent before the handshake completed,
+         * which are encrypted and sent once it does.
+         */
+        std::deque<OutgoingMessage> earlySends;
+
+        /**
+         * This is the delegate to call whenever data is received.
+         * It is only set before processing starts, so it is
+         * read without locking afterwards.
+         */
+        MessageReceivedDelegate messageReceivedDelegate;
+
+        /**
+         * This is the delegate to call once the connection is broken.
+         */
+        BrokenDelegate brokenDelegate;
+
+        /**
+         * This indicates whether or not the user has
+         * started processing the connection.
+         */
+        bool processing = false;
+
+        /**
+         * This is the decrypted data not yet delivered.
+         */
+        std::deque<std::vector<uint8_t>> received;
+
+        /**
+         * This indicates whether or not a thread is delivering
+         * received data and breakage.
+         */
+        bool delivering = false;
+
+        /**
+         * This indicates whether or not the breakage of the
+         * connection has yet to be delivered.
+         */
+        bool brokenPending = false;
+
+        /**
+         * This indicates whether or not the connection was
+         * closed gracefully, once it is broken.
+         */
+        bool brokenGraceful = false;
+
+        /**
+         * This is where records are decrypted.
+         */
+        std::vector<uint8_t> readBuffer;
+
+        /**
+         * This is used to synchronize access to the records received
+         * but not yet handed to OpenSSL.  It is separate from the main
+         * mutex, so that the I/O thread of the inner connection never
+         * waits for a handshake step to finish.
+         */
+        std::mutex inputMutex;
+
+        /**
+         * These are the records received but not yet handed to OpenSSL.
+         */
+        std::vector<uint8_t> ciphertext;
+
+        /**
+         * This indicates whether or not the handshake is under way,
+         * in which case received records are left for the handshake
+         * workers.
+         */
+        bool handshaking = false;
+
+        /**
+         * This indicates whether or not a handshake step is
+         * queued or running.
+         */
+        bool handshakeScheduled = false;
+
+        /**
+         * This is the constructor for the structure.
+         */
+        Impl() :
+            diagnosticsSender(
+                std::make_shared<SystemUtils::DiagnosticsSender>("TlsNetworkConnection")),
+            readBuffer(MAXIMUM_READ_SIZE) {}
+
+        /**
+         * This is the destructor for the structure.
+         */
+        ~Impl() noexcept {
+            if (ssl != nullptr)
+            { SSL_free(ssl); }
+        }
+
+        /**
+         * This method completes the connect attempt in progress, if any.
+         * The caller must not hold the mutex.
+         *
+         * @param[in] connected
+         *      This indicates whether or not the connection
+         *      was established.
+         */
+        void CompleteConnect(bool connected) {
+            ConnectDelegate delegate;
+            {
+                std::lock_guard<decltype(mutex)> lock(mutex);
+                delegate.swap(connectDelegate);
+            }
+            if (delegate != nullptr)
+            { delegate(connected); }
+        }
+
+        /**
+         * This method is called once the inner connection is established,
+         * or fails to be, to start processing it and the handshake.
+         *
+         * @param[in] connected
+         *      This indicates whether or not the inner connection
+         *      was established.
+         */
+        void OnConnected(bool connected) {
+            {
+                std::lock_guard<decltype(mutex)> lock(mutex);
+                if (state != State::Connecting)
+                { return; }
+                if (connected)
+                {
+                    state = State::Handshaking;
+                    std::lock_guard<decltype(inputMutex)> inputLock(inputMutex);
+                    handshaking = true;
+                    handshakeScheduled = true;
+                } else
+                { state = State::Closed; }
+            }
+            if (!connected)
+            {
+                CompleteConnect(false);
+                return;
+            }
+            std::weak_ptr<Impl> implWeak(shared_from_this());
+            if (!inner->Process(
+                    [implWeak](const std::vector<uint8_t>& message)
+                    {
+                        const auto impl = implWeak.lock();
+                        if (impl != nullptr)
+                        { impl->OnCiphertext(message); }
+                    },
+                    [implWeak](bool graceful)
+                    {
+                        const auto impl = implWeak.lock();
+                        if (impl != nullptr)
+                        { impl->OnInnerBroken(graceful); }
+                    }))
+            {
+                diagnosticsSender->SendDiagnosticInformationString(
+                    SystemUtils::DiagnosticsSender::Levels::ERROR,
+                    "unable to process inner connection");
+                {
+                    std::lock_guard<decltype(mutex)> lock(mutex);
+                    state = State::Closed;
+                }
+                inner->Close(false);
+                CompleteConnect(false);
+                return;
+            }
+            bool completeEarly = false;
+            {
+                std::lock_guard<decltype(mutex)> lock(mutex);
+                if (state != State::Handshaking)
+                { return; }
+                if (earlyDataLimit > 0)
+                { completeEarly = connectedEarly = true; } else
+                { StartHandshake(); }
+            }
+            if (completeEarly)
+            { CompleteConnect(true); }
+        }
+
+        /**
+         * This method queues the first handshake step.  When early data
+         * may be sent, this waits until the first message is sent, so
+         * that it goes along with the client hello.  The caller must
+         * hold the mutex.
+         */
+        void StartHandshake() {
+            if (handshakeStarted)
+            { return; }
+            handshakeStarted = true;
+            std::weak_ptr<Impl> implWeak(shared_from_this());
+            handshakeWorkers->Post(
+                [implWeak]
+                {
+                    const auto impl = implWeak.lock();
+                    if (impl != nullptr)
+                    { impl->AdvanceHandshake(); }
+                });
+        }
+
+        /**
+         * This method sends the first message held for the handshake as
+         * early data, if it fits in the amount the session permits.
+         * The caller must hold the mutex.
+         */
+        void WriteEarlyData() {
+            if ((earlyDataLimit == 0) || earlyMessageSent || earlySends.empty() ||
+                (earlySends.front().Bytes().size() > earlyDataLimit))
+            { return; }
+            const auto& bytes = earlySends.front().Bytes();
+            size_t written = 0;
+            ERR_clear_error();
+            if (SSL_write_early_data(ssl, bytes.data(), bytes.size(), &written) != 1)
+            { return; }
+            earlyMessageSent = true;
+            earlyMessage = std::move(earlySends.front());
+            earlySends.pop_front();
+        }
+
+        /**
+         * This method is called from the I/O thread of the inner
+         * connection whenever records are received.  During the
+         * handshake, they are left for the handshake workers.
+         *
+         * @param[in] message
+         *      These are the records received.
+         */
+        void OnCiphertext(const std::vector<uint8_t>& message) {
+            bool schedule = false;
+            {
+                std::lock_guard<decltype(inputMutex)> inputLock(inputMutex);
+                ciphertext.insert(ciphertext.end(), message.begin(), message.end());
+                if (handshaking)
+                {
+                    if (handshakeScheduled)
+                    { return; }
+                    handshakeScheduled = true;
+                    schedule = true;
+                }
+            }
+            if (schedule)
+            {
+                std::weak_ptr<Impl> implWeak(shared_from_this());
+                handshakeWorkers->Post(
+                    [implWeak]
+                    {
+                        const auto impl = implWeak.lock();
+                        if (impl != nullptr)
+                        { impl->AdvanceHandshake(); }
+                    });
+                return;
+            }
+            {
+                std::lock_guard<decltype(mutex)> lock(mutex);
+                if (state != State::Established)
+                { return; }
+                TakeCiphertext();
+                ReadPlaintext();
+            }
+            Deliver();
+        }
+
+        /**
+         * This method is called once the inner connection is broken.
+         *
+         * @param[in] graceful
+         *      This indicates whether or not the inner connection
+         *      was closed gracefully.
+         */
+        void OnInnerBroken(bool graceful) {
+            bool abandoned = false;
+            {
+                std::lock_guard<decltype(mutex)> lock(mutex);
+                if (((state == State::Connecting) || (state == State::Handshaking)) &&
+                    !connectedEarly)
+                { abandoned = true; } else
+                { Break(graceful); }
+                state = State::Closed;
+            }
+            if (abandoned)
+            {
+                diagnosticsSender->SendDiagnosticInformationString(
+                    SystemUtils::DiagnosticsSender::Levels::WARNING,
+                    "connection broken during TLS handshake");
+                CompleteConnect(false);
+            } else
+            { Deliver(); }
+        }
+
+        /**
+         * This method runs handshake steps on a handshake worker for as
+         * long as there are records received for the handshake to consume.
+         */
+        void AdvanceHandshake() {
+            for (;;)
+            {
+                bool finished = false;
+                bool established = false;
+                {
+                    std::lock_guard<decltype(mutex)> lock(mutex);
+                    if (state != State::Handshaking)
+                    {
+                        std::lock_guard<decltype(inputMutex)> inputLock(inputMutex);
+                        handshaking = false;
+                        handshakeScheduled = false;
+                        return;
+                    }
+                    TakeCiphertext();
+                    WriteEarlyData();
+                    ERR_clear_error();
+                    const int result = SSL_do_handshake(ssl);
+                    if (result == 1)
+                    {
+                        finished = established = true;
+                        state = State::Established;
+                        tlsContext->CountHandshake(ssl);
+                        diagnosticsSender->SendDiagnosticInformationFormatted(
+                            1, "TLS handshake complete (%s, %s)", SSL_get_version(ssl),
+                            (SSL_session_reused(ssl) != 0) ? "resumed" : "full");
+                        {
+                            std::lock_guard<decltype(inputMutex)> inputLock(inputMutex);
+                            handshaking = false;
+                            handshakeScheduled = false;
+                        }
+                        TakeCiphertext();
+                        FlushOutput();
+                        OffloadTransmit();
+                        if (earlyMessageSent &&
+                            (SSL_get_early_data_status(ssl) != SSL_EARLY_DATA_ACCEPTED))
+                        {
+                            diagnosticsSender->SendDiagnosticInformationString(
+                                1, "TLS early data rejected; sending it again");
+                            (void)Transmit(std::move(earlyMessage));
+                        }
+                        earlyMessage = OutgoingMessage();
+                        while (!earlySends.empty() && (state == State::Established))
+                        {
+                            (void)Transmit(std::move(earlySends.front()));
+                            earlySends.pop_front();
+                        }
+                        if (state == State::Established)
+                        { ReadPlaintext(); }
+                    } else if (SSL_get_error(ssl, result) != SSL_ERROR_WANT_READ)
+                    {
+                        finished = true;
+                        ReportHandshakeFailure();
+                        Break(false);
+                        state = State::Closed;
+                        earlySends.clear();
+                        {
+                            std::lock_guard<decltype(inputMutex)> inputLock(inputMutex);
+                            handshaking = false;
+                            handshakeScheduled = false;
+                        }
+                    }
+                    FlushOutput();
+                    if (finished && !established)
+                    { inner->Close(false); }
+                }
+                if (finished)
+                {
+                    CompleteConnect(established);
+                    Deliver();
+                    return;
+                }
+                std::lock_guard<decltype(inputMutex)> inputLock(inputMutex);
+                if (ciphertext.empty())
+                {
+                    handshakeScheduled = false;
+                    return;
+                }
+            }
+        }
+
+        /**
+         * This method hands the encryption of everything sent from now on
+         * to the kernel, if the inner connection supports it and the
+         * context kept the keys needed.  It is called once the handshake
+         * completes, after the last handshake records are sent, and
+         * before any application data is encrypted.  The caller must
+         * hold the mutex.
+         */
+        void OffloadTransmit() {
+            std::vector<uint8_t> cryptoInfo;
+            if ((innerKernelTls == nullptr) ||
+                !tlsContext->MakeKernelTlsTransmitInfo(ssl, cryptoInfo))
+            { return; }
+            transmitOffloaded = innerKernelTls->OffloadTlsTransmit(cryptoInfo);
+            OPENSSL_cleanse(cryptoInfo.data(), cryptoInfo.size());
+            if (transmitOffloaded)
+            {
+                tlsContext->CountKernelOffload();
+                diagnosticsSender->SendDiagnosticInformationString(
+                    1, "TLS encryption handed to kernel");
+            } else
+            {
+                diagnosticsSender->SendDiagnosticInformationString(
+                    1, "TLS encryption kept in user space");
+            }
+        }
+
+        /**
+         * This method publishes why the handshake failed.
+         * The caller must hold the mutex.
+         */
+        void ReportHandshakeFailure() {
+            const auto verifyResult = SSL_get_verify_result(ssl);
+            if (verifyResult != X509_V_OK)
+            {
+                diagnosticsSender->SendDiagnosticInformationFormatted(
+                    SystemUtils::DiagnosticsSender::Levels::ERROR,
+                    "TLS handshake failed (certificate verification: %s)",
+                    X509_verify_cert_error_string(verifyResult));
+                return;
+            }
+            char reason[256];
+            ERR_error_string_n(ERR_get_error(), reason, sizeof(reason));
+            diagnosticsSender->SendDiagnosticInformationFormatted(
+                SystemUtils::DiagnosticsSender::Levels::ERROR, "TLS handshake failed (%s)",
+                reason);
+        }
+
+        /**
+         * This method hands the records received so far to OpenSSL.
+         * The caller must hold the mutex.
+         */
+        void TakeCiphertext() {
+            std::vector<uint8_t> records;
+            {
+                std::lock_guard<decltype(inputMutex)> inputLock(inputMutex);
+                records.swap(ciphertext);
+            }
+            if (!records.empty())
+            { (void)BIO_write(input, records.data(), (int)records.size()); }
+        }
+
+        /**
+         * This method decrypts everything OpenSSL can from the records
+         * handed to it, queuing the data for delivery.  The caller
+         * must hold the mutex.
+         */
+        void ReadPlaintext() {
+            std::vector<uint8_t> plaintext;
+            for (;;)
+            {
+                ERR_clear_error();
+                const int amount = SSL_read(ssl, readBuffer.data(), (int)readBuffer.size());
+                if (amount > 0)
+                {
+                    plaintext.insert(plaintext.end(), readBuffer.begin(),
+                                     readBuffer.begin() + amount);
+                    continue;
+                }
+                const int error = SSL_get_error(ssl, amount);
+                if (error == SSL_ERROR_ZERO_RETURN)
+                {
+                    diagnosticsSender->SendDiagnosticInformationString(
+                        1, "TLS connection closed gracefully by peer");
+                    Break(true);
+                    inner->Close(true);
+                } else if (error != SSL_ERROR_WANT_READ)
+                {
+                    char reason[256];
+                    ERR_error_string_n(ERR_get_error(), reason, sizeof(reason));
+                    diagnosticsSender->SendDiagnosticInformationFormatted(
+                        SystemUtils::DiagnosticsSender::Levels::ERROR,
+                        "error decrypting received data (%s)", reason);
+                    Break(false);
+                    inner->Close(false);
+                }
+                break;
+            }
+            if (!plaintext.empty())
+            { received.push_back(std::move(plaintext)); }
+            FlushOutput();
+        }
+
+        /**
+         * This method encrypts the given message into records
+         * to send.  The caller must hold the mutex.
+         *
+         * @param[in] message
+         *      This is the message to encrypt.
+         */
+        void Encrypt(const std::vector<uint8_t>& message) {
+            if (message.empty())
+            { return; }
+            ERR_clear_error();
+            if (SSL_write(ssl, message.data(), (int)message.size()) > 0)
+            { return; }
+            char reason[256];
+            ERR_error_string_n(ERR_get_error(), reason, sizeof(reason));
+            diagnosticsSender->SendDiagnosticInformationFormatted(
+                SystemUtils::DiagnosticsSender::Levels::ERROR, "error encrypting message (%s)",
+                reason);
+            Break(false);
+            inner->Close(false);
+        }
+
+        /**
+         * This method sends the records OpenSSL has written so far,
+         * in a single message.  The caller must hold the mutex,
+         * which keeps the records in order.
+         */
+        void FlushOutput() {
+            const auto pending = BIO_ctrl_pending(output);
+            if (pending == 0)
+            { return; }
+            if (transmitOffloaded)
+            {
+                // OpenSSL no longer knows the record sequence number the
+                // kernel is at, so it can't send anything more itself,
+                // such as the reply to a key update requested by the server.
+                (void)BIO_reset(output);
+                diagnosticsSender->SendDiagnosticInformationString(
+                    SystemUtils::DiagnosticsSender::Levels::ERROR,
+                    "TLS records to send after encryption was handed to kernel");
+                Break(false);
+                inner->Close(false);
+                return;
+            }
+            std::vector<uint8_t> records(pending);
+            (void)BIO_read(output, records.data(), (int)records.size());
+            if (innerGather != nullptr)
+            { innerGather->SendMessage(OutgoingMessage(std::move(records))); } else
+            { inner->SendMessage(records); }
+        }
+
+        /**
+         * This method returns whether or not the connection has been
+         * reported as connected and not yet closed.  The caller must
+         * hold the mutex.
+         *
+         * @return
+         *      An indication of whether or not the connection
+         *      is usable is returned.
+         */
+        bool IsUsable() const {
+            return ((state == State::Established) ||
+                    ((state == State::Handshaking) && connectedEarly));
+        }
+
+        /**
+         * This method marks the connection as broken, arranging for its
+         * breakage to be delivered after any data received before it.
+         * The caller must hold the mutex.
+         *
+         * @param[in] graceful
+         *      This indicates whether or not the connection
+         *      was closed gracefully.
+         */
+        void Break(bool graceful) {
+            if ((state == State::Closed) ||
+                ((state != State::Established) && (state != State::Closing) && !connectedEarly))
+            { return; }
+            state = State::Closed;
+            brokenPending = true;
+            brokenGraceful = graceful;
+        }
+
+        /**
+         * This method delivers received data, and then the breakage of
+         * the connection, if it is broken, once processing has started.
+         * Only one thread delivers at a time, so that data is delivered
+         * in order.  The caller must not hold the mutex.
+         */
+        void Deliver() {
+            std::unique_lock<decltype(mutex)> lock(mutex);
+            if (delivering || !processing)
+            { return; }
+            delivering = true;
+            for (;;)
+            {
+                if (!received.empty())
+                {
+                    const auto message = std::move(received.front());
+                    received.pop_front();
+                    lock.unlock();
+                    if (messageReceivedDelegate != nullptr)
+                    { messageReceivedDelegate(message); }
+                    lock.lock();
+                    continue;
+                }
+                if (brokenPending)
+                {
+                    brokenPending = false;
+                    BrokenDelegate delegate;
+                    delegate.swap(brokenDelegate);
+                    const bool graceful = brokenGraceful;
+                    lock.unlock();
+                    if (delegate != nullptr)
+                    { delegate(graceful); }
+                    lock.lock();
+                    continue;
+                }
+                break;
+            }
+            delivering = false;
+        }
+
+        /**
+         * This method encrypts the given message into records to send, or
+         * passes it to the inner connection as it is, if the kernel
+         * encrypts what is sent.  The caller must hold the mutex.
+         *
+         * @param[in] message
+         *      This is the message to send.
+         * @return
+         *      An indication of whether or not the message was
+         *      encrypted, and so records need to be flushed, is returned.
+         */
+        bool Transmit(OutgoingMessage&& message) {
+            if (!transmitOffloaded)
+            {
+                Encrypt(message.Bytes());
+                return true;
+            }
+            if (innerGather != nullptr)
+            { innerGather->SendMessage(std::move(message)); } else
+            { inner->SendMessage(message.Bytes()); }
+            return false;
+        }
+
+        /**
+         * This method queues the given message to be encrypted and sent,
+         * or holds it until the handshake completes.  The caller must
+         * hold the mutex.
+         *
+         * @param[in] message
+         *      This is the message to send.
+         * @return
+         *      An indication of whether or not the message was
+         *      encrypted, and so records need to be flushed, is returned.
+         */
+        bool Send(OutgoingMessage&& message) {
+            if (state == State::Established)
+            { return Transmit(std::move(message)); }
+            if ((state == State::Connecting) || (state == State::Handshaking))
+            {
+                earlySends.push_back(std::move(message));
+                if (connectedEarly)
+                { StartHandshake(); }
+            }
+            return false;
+        }
+    };
+
+    TlsNetworkConnection::~TlsNetworkConnection() noexcept { Close(false); }
+
+    TlsNetworkConnection::TlsNetworkConnection(
+        std::shared_ptr<SystemUtils::INetworkConnection> inner,
+        std::shared_ptr<TlsContext> tlsContext, const std::string& serverName,
+        std::shared_ptr<WorkerPool> handshakeWorkers, std::shared_ptr<WorkerPool> connectWorkers,
+        bool earlyData) :
+        impl_(std::make_shared<Impl>()) {
+        impl_->inner = inner;
+        impl_->innerGather = std::dynamic_pointer_cast<GatherNetworkConnection>(inner);
+        impl_->innerAsync = std::dynamic_pointer_cast<AsyncNetworkConnection>(inner);
+        impl_->innerKernelTls = std::dynamic_pointer_cast<KernelTlsConnection>(inner);
+        impl_->innerFastOpen = std::dynamic_pointer_cast<FastOpenConnection>(inner);
+        impl_->tlsContext = tlsContext;
+        impl_->serverName = serverName;
+        impl_->handshakeWorkers = handshakeWorkers;
+        impl_->connectWorkers = connectWorkers;
+        impl_->earlyData = earlyData;
+        const auto diagnosticsSender = impl_->diagnosticsSender;
+        (void)inner->SubscribeToDiagnostics(
+            [diagnosticsSender](std::string, size_t level, std::string message)
+            { diagnosticsSender->SendDiagnosticInformationString(level, message); });
+    }
+
+    SystemUtils::DiagnosticsSender::UnsubscribeDelegate TlsNetworkConnection::SubscribeToDiagnostics(
+        SystemUtils::DiagnosticsSender::DiagnosticMessageDelegate delegate, size_t minLevel) {
+        return impl_->diagnosticsSender->SubscribeToDiagnostics(delegate, minLevel);
+    }
+
+    bool TlsNetworkConnection::Connect(uint32_t peerAddress, uint16_t peerPort) {
+        const auto result = std::make_shared<std::promise<bool>>();
+        auto connected = result->get_future();
+        ConnectAsync(peerAddress, peerPort,
+                     [result](bool succeeded) { result->set_value(succeeded); });
+        return connected.get();
+    }
+
+    bool TlsNetworkConnection::Process(MessageReceivedDelegate messageReceivedDelegate,
+                                       BrokenDelegate brokenDelegate) {
+        {
+            std::lock_guard<decltype(impl_->mutex)> lock(impl_->mutex);
+            if (!impl_->IsUsable() || impl_->processing)
+            { return false; }
+            impl_->messageReceivedDelegate = messageReceivedDelegate;
+            impl_->brokenDelegate = brokenDelegate;
+            impl_->processing = true;
+        }
+        impl_->Deliver();
+        return true;
+    }
+
+    uint32_t TlsNetworkConnection::GetPeerAddress() const { return impl_->inner->GetPeerAddress(); }
+
+    uint16_t TlsNetworkConnection::GetPeerPort() const { return impl_->inner->GetPeerPort(); }
+
+    bool TlsNetworkConnection::IsConnected() const {
+        std::lock_guard<decltype(impl_->mutex)> lock(impl_->mutex);
+        return (impl_->IsUsable() && impl_->inner->IsConnected());
+    }
+
+    uint32_t TlsNetworkConnection::GetBoundAddress() const {
+        return impl_->inner->GetBoundAddress();
+    }
+
+    uint16_t TlsNetworkConnection::GetBoundPort() const { return impl_->inner->GetBoundPort(); }
+
+    void TlsNetworkConnection::SendMessage(const std::vector<uint8_t>& message) {
+        std::lock_guard<decltype(impl_->mutex)> lock(impl_->mutex);
+        if (impl_->state == Impl::State::Established)
+        {
+            if (impl_->transmitOffloaded)
+            { impl_->inner->SendMessage(message); } else
+            {
+                impl_->Encrypt(message);
+                impl_->FlushOutput();
+            }
+        } else
+        { (void)impl_->Send(OutgoingMessage(std::vector<uint8_t>(message))); }
+    }
+
+    void TlsNetworkConnection::SendMessage(OutgoingMessage&& message) {
+        std::lock_guard<decltype(impl_->mutex)> lock(impl_->mutex);
+        if (impl_->Send(std::move(message)))
+        { impl_->FlushOutput(); }
+    }
+
+    void TlsNetworkConnection::SendMessages(std::vector<OutgoingMessage>&& messages) {
+        std::lock_guard<decltype(impl_->mutex)> lock(impl_->mutex);
+        if ((impl_->state == Impl::State::Established) && impl_->transmitOffloaded &&
+            (impl_->innerGather != nullptr))
+        {
+            impl_->innerGather->SendMessages(std::move(messages));
+            return;
+        }
+        bool encrypted = false;
+        for (auto& message : messages)
+        { encrypted = (impl_->Send(std::move(message)) || encrypted); }
+        if (encrypted)
+        { impl_->FlushOutput(); }
+    }
+
+    void TlsNetworkConnection::ConnectAsync(uint32_t peerAddress, uint16_t peerPort,
+                                            ConnectDelegate connectDelegate) {
+        {
+            std::unique_lock<decltype(impl_->mutex)> lock(impl_->mutex);
+            if (impl_->state != Impl::State::Idle)
+            {
+                lock.unlock();
+                connectDelegate(false);
+                return;
+            }
+            impl_->ssl = impl_->tlsContext->NewConnection(
+                impl_->serverName, impl_->serverName + ":" + std::to_string(peerPort),
+                impl_->earlyData);
+            if (impl_->ssl == nullptr)
+            {
+                impl_->diagnosticsSender->SendDiagnosticInformationString(
+                    SystemUtils::DiagnosticsSender::Levels::ERROR,
+                    "unable to make TLS connection object");
+                impl_->state = Impl::State::Closed;
+                lock.unlock();
+                connectDelegate(false);
+                return;
+            }
+            impl_->input = BIO_new(BIO_s_mem());
+            impl_->output = BIO_new(BIO_s_mem());
+            BIO_set_mem_eof_return(impl_->input, -1);
+            SSL_set_bio(impl_->ssl, impl_->input, impl_->output);
+            if (impl_->earlyData)
+            {
+                const auto session = SSL_get0_session(impl_->ssl);
+                if (session != nullptr)
+                { impl_->earlyDataLimit = SSL_SESSION_get_max_early_data(session); }
+            }
+            impl_->state = Impl::State::Connecting;
+            impl_->connectDelegate = std::move(connectDelegate);
+        }
+        std::weak_ptr<Impl> implWeak(impl_);
+        const auto onConnected = [implWeak](bool connected)
+        {
+            const auto impl = implWeak.lock();
+            if (impl != nullptr)
+            { impl->OnConnected(connected); }
+        };
+        if (impl_->innerAsync != nullptr)
+        {
+            impl_->innerAsync->ConnectAsync(peerAddress, peerPort, onConnected);
+            return;
+        }
+        const auto inner = impl_->inner;
+        impl_->connectWorkers->Post([inner, peerAddress, peerPort, onConnected]
+                                    { onConnected(inner->Connect(peerAddress, peerPort)); });
+    }
+
+    void TlsNetworkConnection::Close(bool clean) {
+        bool abandoned = false;
+        {
+            std::lock_guard<decltype(impl_->mutex)> lock(impl_->mutex);
+            switch (impl_->state)
+            {
+                case Impl::State::Idle:
+                case Impl::State::Closing:
+                case Impl::State::Closed:
+                    return;
+
+                case Impl::State::Connecting:
+                case Impl::State::Handshaking:
+                    if (!impl_->connectedEarly)
+                    {
+                        abandoned = true;
+                        impl_->earlySends.clear();
+                    }
+                    break;
+
+                case Impl::State::Established:
+                    if (clean && !impl_->transmitOffloaded)
+                    {
+                        ERR_clear_error();
+                        (void)SSL_shutdown(impl_->ssl);
+                        impl_->FlushOutput();
+                    }
+                    break;
+            }
+            impl_->state = (abandoned ? Impl::State::Closed : Impl::State::Closing);
+            impl_->inner->Close(clean && !abandoned);
+        }
+        if (abandoned)
+        { impl_->CompleteConnect(false); }
+    }
+
+    void TlsNetworkConnection::EnableFastOpen() {
+        if (impl_->innerFastOpen != nullptr)
+        { impl_->innerFastOpen->EnableFastOpen(); }
+    }
+
+    bool TlsNetworkConnection::UsedFastOpen() {
+        return ((impl_->innerFastOpen != nullptr) && impl_->innerFastOpen->UsedFastOpen());
+    }
+
+    std::shared_ptr<SystemUtils::INetworkConnection> TlsNetworkConnection::GetInnerConnection() const {
+        return impl_->inner;
+    }
+}  // namespace MqttNetworkTransport
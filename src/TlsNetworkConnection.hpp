@@ -0,0 +1,130 @@
+#ifndef MQTT_NETWORK_TRANSPORT_TLS_NETWORK_CONNECTION_HPP
+#define MQTT_NETWORK_TRANSPORT_TLS_NETWORK_CONNECTION_HPP
+/**
+ * @file TlsNetworkConnection.hpp
+ *
+ * This module declares the MqttNetworkTransport::TlsNetworkConnection
+ * class.
+ *
+ * © 2025 by Hatem Nabli
+ */
+
+#include "AsyncNetworkConnection.hpp"
+#include "FastOpenConnection.hpp"
+#include "LayeredConnection.hpp"
+#include "TlsContext.hpp"
+#include "WorkerPool.hpp"
+#include <memory>
+#include <string>
+
+namespace MqttNetworkTransport
+{
+    /**
+     * This is an implementation of SystemUtils::INetworkConnection which
+     * secures another network connection with TLS.  The handshake is
+     * performed on a shared pool of workers, so that the I/O threads of
+     * the wrapped connection never spend time on its cryptography, while
+     * records received afterwards are decrypted on the I/O thread that
+     * received them.
+     */
+    class TlsNetworkConnection : public AsyncNetworkConnection,
+                                 public FastOpenConnection,
+                                 public LayeredConnection
+    {
+        // Lifecycle management
+    public:
+        ~TlsNetworkConnection() noexcept;
+        TlsNetworkConnection(const TlsNetworkConnection&) = delete;
+        TlsNetworkConnection(TlsNetworkConnection&&) noexcept = delete;
+        TlsNetworkConnection& operator=(const TlsNetworkConnection&) = delete;
+        TlsNetworkConnection& operator=(TlsNetworkConnection&&) noexcept = delete;
+
+        // Public methods
+    public:
+        /**
+         * This is the constructor.
+         *
+         * @param[in] inner
+         *      This is the connection which carries the TLS records.
+         * @param[in] tlsContext
+         *      This is the client context with which to secure
+         *      the connection.
+         * @param[in] serverName
+         *      This is the name or IPv4 literal of the server, which is
+         *      sent as the server name indication and checked against
+         *      its certificate.
+         * @param[in] handshakeWorkers
+         *      This is the pool of workers which perform handshakes.
+         * @param[in] connectWorkers
+         *      This is the pool of workers which establish the inner
+         *      connection, if it can only connect by blocking.
+         * @param[in] earlyData
+         *      This indicates whether or not, when resuming a session
+         *      which permits it, the connect attempt completes as soon as
+         *      the inner connection is established, and the first message
+         *      sent is carried as TLS 1.3 early data along with the client
+         *      hello.  Early data can be replayed by an attacker, so this
+         *      must only be enabled if the first message is safe to
+         *      process more than once.
+         */
+        TlsNetworkConnection(std::shared_ptr<SystemUtils::INetworkConnection> inner,
+                             std::shared_ptr<TlsContext> tlsContext,
+                             const std::string& serverName,
+                             std::shared_ptr<WorkerPool> handshakeWorkers,
+                             std::shared_ptr<WorkerPool> connectWorkers, bool earlyData = false);
+
+        // SystemUtils::INetworkConnection
+    public:
+        virtual SystemUtils::DiagnosticsSender::UnsubscribeDelegate SubscribeToDiagnostics(
+            SystemUtils::DiagnosticsSender::DiagnosticMessageDelegate delegate,
+            size_t minLevel = 0) override;
+        virtual bool Connect(uint32_t peerAddress, uint16_t peerPort) override;
+        virtual bool Process(MessageReceivedDelegate messageReceivedDelegate,
+                             BrokenDelegate brokenDelegate) override;
+        virtual uint32_t GetPeerAddress() const override;
+        virtual uint16_t GetPeerPort() const override;
+        virtual bool IsConnected() const override;
+        virtual uint32_t GetBoundAddress() const override;
+        virtual uint16_t GetBoundPort() const override;
+        virtual void SendMessage(const std::vector<uint8_t>& message) override;
+        virtual void Close(bool clean = false) override;
+
+        // GatherNetworkConnection
+    public:
+        virtual void SendMessage(OutgoingMessage&& message) override;
+        virtual void SendMessages(std::vector<OutgoingMessage>&& messages) override;
+
+        // AsyncNetworkConnection
+    public:
+        virtual void ConnectAsync(uint32_t peerAddress, uint16_t peerPort,
+                                  ConnectDelegate connectDelegate) override;
+
+        // FastOpenConnection
+    public:
+        virtual void EnableFastOpen() override;
+        virtual bool UsedFastOpen() override;
+
+        // LayeredConnection
+    public:
+        virtual std::shared_ptr<SystemUtils::INetworkConnection> GetInnerConnection()
+            const override;
+
+        // Private properties
+    private:
+        /**
+         * This is the type of structure that contains the private
+         * properties of the instance.  It is defined in the implementation
+         * and declared here to ensure that it is scoped inside the class.
+         */
+        struct Impl;
+
+        /**
+         * This contains the private properties of the instance.  It is
+         * shared with the inner connection and the handshake workers,
+         * which may still be using it while the connection is destroyed.
+         */
+        std::shared_ptr<Impl> impl_;
+    };
+}  // namespace MqttNetworkTransport
+
+#endif /** MQTT_NETWORK_TRANSPORT_TLS_NETWORK_CONNECTION_HPP */
@@ -0,0 +1,690 @@
+/**
+ * @file UringNetworkConnection.cpp
+ *
+ * This module implements the MqttNetworkTransport::UringNetworkConnection
+ * class.
+ *
+ * © 2025 by Hatem Nabli
+ */
+
+#include "UringNetworkConnection.hpp"
+#include <deque>
+#include <errno.h>
+#include <mutex>
+#include <string.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+namespace
+{
+    /**
+     * This is the maximum number of queued messages gathered into one send.
+     */
+    constexpr size_t MAXIMUM_GATHER_COUNT = 64;
+}  // namespace
+
+namespace MqttNetworkTransport
+{
+    struct UringNetworkConnection::Impl
+    {
+        /**
+         * This is the io_uring instance to which operations are submitted.
+         */
+        std::shared_ptr<IoUring> ring;
+
+        /**
+         * This is a helper object used to generate and publish diagnostics messages.
+         */
+        std::shared_ptr<SystemUtils::DiagnosticsSender> diagnosticsSender;
+
+        /**
+         * This is used to synchronize access to the connection state.
+         */
+        std::recursive_mutex mutex;
+
+        /**
+         * This is the socket of the connection, or -1 if there is none.
+         */
+        int sock = -1;
+
+        /**
+         * This identifies the connection's handler registered with the
+         * ring, or is zero if the connection is not processing.
+         */
+        uint64_t id = 0;
+
+        /**
+         * These are the address and port of the peer.
+         */
+        uint32_t peerAddress = 0;
+        uint16_t peerPort = 0;
+
+        /**
+         * If not empty, this is the address to which the connection is
+         * made, in place of the IPv4 address and port of the peer.
+         */
+        SocketAddress peerSocketAddress;
+
+        /**
+         * These are the address and port of the local end of the connection.
+         */
+        uint32_t boundAddress = 0;
+        uint16_t boundPort = 0;
+
+        /**
+         * If not null, this is where to take the buffers in which
+         * received data is delivered.
+         */
+        std::shared_ptr<ReceiveBufferPool> receiveBufferPool;
+
+        /**
+         * This is the delegate to call whenever data is received.
+         * It is only set before the receive is first submitted,
+         * so the completion thread reads it without locking.
+         */
+        MessageReceivedDelegate messageReceivedDelegate;
+
+        /**
+         * This is the delegate to call once the connection is broken.
+         */
+        BrokenDelegate brokenDelegate;
+
+        /**
+         * This is the delegate to call once an asynchronous connect
+         * attempt completes, while one is in progress.
+         */
+        ConnectDelegate connectDelegate;
+
+        /**
+         * This identifies the handler registered with the ring for
+         * an asynchronous connect attempt in progress, or is zero
+         * if there is none.
+         */
+        uint64_t connectId = 0;
+
+        /**
+         * This is the address of the peer of an asynchronous connect
+         * attempt, which must remain valid until the attempt completes.
+         */
+        SocketAddress connectAddress;
+
+        /**
+         * These are the messages waiting to be sent.  The messages at the
+         * front are the ones being sent, if a send is in flight, and must
+         * not be released until the send completes.
+         */
+        std::deque<OutgoingMessage> outputQueue;
+
+        /**
+         * This is the number of bytes of the front message of the
+         * output queue which have already been sent.
+         */
+        size_t outputOffset = 0;
+
+        /**
+         * These describe the data of the send in flight, if any.
+         */
+        struct iovec outputVectors[MAXIMUM_GATHER_COUNT];
+        struct msghdr outputHeader;
+
+        /**
+         * This indicates whether or not a send is in flight.
+         */
+        bool sending = false;
+
+        /**
+         * This indicates whether or not a receive is armed.
+         */
+        bool receiving = false;
+
+        /**
+         * This indicates whether or not a clean close was requested, in which
+         * case the write side is shut down once the output queue drains.
+         */
+        bool closing = false;
+
+        /**
+         * This indicates whether or not the connection is broken.
+         */
+        bool broken = false;
+
+        /**
+         * This indicates whether or not the connection is to be
+         * established with TCP Fast Open.
+         */
+        bool fastOpen = false;
+
+        /**
+         * This indicates whether or not the connection was established
+         * with TCP Fast Open.  It is recorded before the socket is closed.
+         */
+        bool fastOpenUsed = false;
+
+        /**
+         * This is the constructor for the structure.
+         */
+        Impl() :
+            diagnosticsSender(
+                std::make_shared<SystemUtils::DiagnosticsSender>("UringNetworkConnection")) {}
+
+        /**
+         * This method is called from the completion thread whenever
+         * a receive completes.
+         *
+         * @param[in,out] buffer
+         *      This is the provided buffer holding the received data.
+         * @param[in] result
+         *      This is the number of bytes received, zero if the peer
+         *      closed the connection, or a negated errno value.
+         * @param[in] armed
+         *      This indicates whether or not the receive is still armed.
+         */
+        void OnReceived(std::vector<uint8_t>& buffer, int32_t result, bool armed) {
+            if (result > 0)
+            {
+                Deliver(buffer, (size_t)result);
+                if (!armed)
+                { Rearm(); }
+                return;
+            }
+            std::lock_guard<decltype(mutex)> lock(mutex);
+            if (armed)
+            { return; }
+            if (result == -ENOBUFS)
+            {
+                Rearm();
+                return;
+            }
+            receiving = false;
+            if (result == 0)
+            {
+                if (!broken)
+                {
+                    diagnosticsSender->SendDiagnosticInformationString(
+                        1, "connection closed gracefully by peer");
+                }
+                Shutdown(true);
+            } else
+            {
+                if (!broken)
+                {
+                    diagnosticsSender->SendDiagnosticInformationFormatted(
+                        1, "connection closed abruptly by peer (%s)", strerror(-result));
+                }
+                Shutdown(false);
+            }
+            Release();
+        }
+
+        /**
+         * This method is called from the completion thread once
+         * an asynchronous connect attempt completes.
+         *
+         * @param[in] result
+         *      This is zero if the connection was established,
+         *      or a negated errno value.
+         */
+        void OnConnected(int32_t result) {
+            ConnectDelegate delegate;
+            bool connected = false;
+            {
+                std::lock_guard<decltype(mutex)> lock(mutex);
+                ring->Unregister(connectId);
+                connectId = 0;
+                delegate.swap(connectDelegate);
+                if (!broken && (result == 0))
+                {
+                    RecordBoundAddress();
+                    connected = true;
+                } else
+                {
+                    if (!broken)
+                    {
+                        diagnosticsSender->SendDiagnosticInformationFormatted(
+                            SystemUtils::DiagnosticsSender::Levels::ERROR,
+                            "error in connect (%s)", strerror(-result));
+                    }
+                    (void)close(sock);
+                    sock = -1;
+                }
+            }
+            if (delegate != nullptr)
+            { delegate(connected); }
+        }
+
+        /**
+         * This method records whether or not the connection was established
+         * with TCP Fast Open, if it was requested and hasn't been found
+         * to be used yet.  The caller must hold the mutex.
+         */
+        void RecordFastOpen() {
+            if (fastOpen && !fastOpenUsed && (sock >= 0))
+            { fastOpenUsed = FastOpenConnection::WasUsed(sock); }
+        }
+
+        /**
+         * This method sets up the given socket to connect with TCP Fast
+         * Open, if requested.  The connection is made without it if the
+         * socket can't be set up.  The caller must hold the mutex.
+         *
+         * @param[in] newSock
+         *      This is the socket to set up.
+         * @param[in] address
+         *      This is the address to which the socket is to connect.
+         *      TCP Fast Open is not used for Unix domain sockets.
+         */
+        void SetUpFastOpen(int newSock, const SocketAddress& address) {
+            std::string error;
+            if (fastOpen && (address.GetFamily() != AF_UNIX) &&
+                !FastOpenConnection::SetUpSocket(newSock, error))
+            {
+                diagnosticsSender->SendDiagnosticInformationFormatted(
+                    SystemUtils::DiagnosticsSender::Levels::WARNING,
+                    "unable to use TCP Fast Open (%s)", error.c_str());
+            }
+        }
+
+        /**
+         * This method returns the address to which to connect, given the
+         * IPv4 address and port of the peer.  The caller must hold the mutex.
+         *
+         * @param[in] address
+         *      This is the IPv4 address of the peer.
+         * @param[in] port
+         *      This is the TCP port of the peer.
+         * @return
+         *      The address set for the peer, if any, is returned.
+         *      Otherwise, the address of the given IPv4 address
+         *      and port is returned.
+         */
+        SocketAddress TargetAddress(uint32_t address, uint16_t port) const {
+            if (peerSocketAddress.IsEmpty())
+            { return SocketAddress::FromIpv4(address, port); }
+            return peerSocketAddress;
+        }
+
+        /**
+         * This method stores the address and port to which the socket
+         * is bound.  Only the port is stored for IPv6 sockets.  The
+         * caller must hold the mutex.
+         */
+        void RecordBoundAddress() {
+            struct sockaddr_storage address;
+            socklen_t addressLength = sizeof(address);
+            if (getsockname(sock, (struct sockaddr*)&address, &addressLength) != 0)
+            { return; }
+            if (address.ss_family == AF_INET)
+            {
+                const auto ipv4 = (const struct sockaddr_in*)&address;
+                boundAddress = ntohl(ipv4->sin_addr.s_addr);
+                boundPort = ntohs(ipv4->sin_port);
+            } else if (address.ss_family == AF_INET6)
+            { boundPort = ntohs(((const struct sockaddr_in6*)&address)->sin6_port); }
+        }
+
+        /**
+         * This method delivers received data to the message received
+         * delegate, in a pooled buffer if there is a pool.
+         *
+         * When most of the provided buffer was filled, the pooled buffer
+         * takes its place in the buffer ring instead of the data being
+         * copied into it.  Otherwise copying the few bytes received is
+         * cheaper than growing the pooled buffer to replace it.
+         *
+         * @param[in,out] buffer
+         *      This is the provided buffer holding the received data.
+         * @param[in] size
+         *      This is the number of bytes received.
+         */
+        void Deliver(std::vector<uint8_t>& buffer, size_t size) {
+            if (messageReceivedDelegate == nullptr)
+            { return; }
+            if (receiveBufferPool == nullptr)
+            {
+                messageReceivedDelegate(
+                    std::vector<uint8_t>(buffer.data(), buffer.data() + size));
+                return;
+            }
+            auto pooled = receiveBufferPool->Acquire();
+            if (size >= buffer.size() / 2)
+            {
+                pooled.resize(buffer.size());
+                pooled.swap(buffer);
+                pooled.resize(size);
+            } else
+            { pooled.assign(buffer.data(), buffer.data() + size); }
+            messageReceivedDelegate(pooled);
+            receiveBufferPool->Release(std::move(pooled));
+        }
+
+        /**
+         * This method is called from the completion thread whenever
+         * a send completes.
+         *
+         * @param[in] result
+         *      This is the number of bytes sent, or a negated errno value.
+         */
+        void OnSent(int32_t result) {
+            std::lock_guard<decltype(mutex)> lock(mutex);
+            sending = false;
+            if (broken)
+            {
+                outputQueue.clear();
+                Release();
+                return;
+            }
+            if (result < 0)
+            {
+                diagnosticsSender->SendDiagnosticInformationFormatted(
+                    SystemUtils::DiagnosticsSender::Levels::ERROR, "error sending message (%s)",
+                    strerror(-result));
+                Shutdown(false);
+                outputQueue.clear();
+                Release();
+                return;
+            }
+            auto amount = (size_t)result;
+            while (!outputQueue.empty())
+            {
+                const auto remaining = outputQueue.front().Bytes().size() - outputOffset;
+                if (remaining > amount)
+                {
+                    outputOffset += amount;
+                    break;
+                }
+                amount -= remaining;
+                outputQueue.pop_front();
+                outputOffset = 0;
+            }
+            SendNext();
+        }
+
+        /**
+         * This method submits the receive again, unless the
+         * connection is broken.
+         */
+        void Rearm() {
+            std::lock_guard<decltype(mutex)> lock(mutex);
+            if (broken)
+            {
+                receiving = false;
+                Release();
+                return;
+            }
+            ring->SubmitReceive(sock, id);
+        }
+
+        /**
+         * This method submits a send gathering whatever remains of the
+         * messages at the front of the output queue.  If the queue is empty
+         * and a clean close was requested, the write side of the socket
+         * is shut down.  The caller must hold the mutex.
+         */
+        void SendNext() {
+            if (sending || broken)
+            { return; }
+            if (outputQueue.empty())
+            {
+                if (closing)
+                { (void)shutdown(sock, SHUT_WR); }
+                return;
+            }
+            sending = true;
+            size_t count = 0;
+            for (auto message = outputQueue.begin();
+                 (message != outputQueue.end()) && (count < MAXIMUM_GATHER_COUNT);
+                 ++message, ++count)
+            {
+                const auto& bytes = message->Bytes();
+                const size_t offset = ((count == 0) ? outputOffset : 0);
+                outputVectors[count].iov_base = (void*)(bytes.data() + offset);
+                outputVectors[count].iov_len = bytes.size() - offset;
+            }
+            (void)memset(&outputHeader, 0, sizeof(outputHeader));
+            outputHeader.msg_iov = outputVectors;
+            outputHeader.msg_iovlen = count;
+            ring->SubmitSendMessage(sock, &outputHeader, id);
+        }
+
+        /**
+         * This method breaks the connection, if it isn't already broken,
+         * and arranges for the broken delegate to be called from the
+         * completion thread.  The caller must hold the mutex.
+         *
+         * @param[in] graceful
+         *      This indicates whether or not the connection was
+         *      closed gracefully.
+         */
+        void Shutdown(bool graceful) {
+            if (broken || (sock < 0))
+            { return; }
+            broken = true;
+            if (connectId != 0)
+            {
+                ring->CancelConnect(connectId);
+                return;
+            }
+            if (id == 0)
+            {
+                RecordFastOpen();
+                (void)close(sock);
+                sock = -1;
+                return;
+            }
+            (void)shutdown(sock, SHUT_RDWR);
+            BrokenDelegate delegate;
+            delegate.swap(brokenDelegate);
+            if (delegate != nullptr)
+            { ring->Post([delegate, graceful] { delegate(graceful); }); }
+            Release();
+        }
+
+        /**
+         * This method closes the socket and unregisters from the ring once
+         * the connection is broken and no operation is in flight anymore.
+         * The caller must hold the mutex.
+         */
+        void Release() {
+            if (!broken || receiving || sending || (id == 0))
+            { return; }
+            RecordFastOpen();
+            (void)close(sock);
+            sock = -1;
+            const auto registeredId = id;
+            id = 0;
+            ring->Unregister(registeredId);
+        }
+    };
+
+    UringNetworkConnection::~UringNetworkConnection() noexcept {
+        std::lock_guard<decltype(impl_->mutex)> lock(impl_->mutex);
+        // The owner has let go of the connection, so it no longer
+        // expects to hear from it.
+        impl_->brokenDelegate = nullptr;
+        impl_->connectDelegate = nullptr;
+        impl_->Shutdown(false);
+    }
+
+    UringNetworkConnection::UringNetworkConnection(
+        std::shared_ptr<IoUring> ring, std::shared_ptr<ReceiveBufferPool> receiveBufferPool) :
+        impl_(std::make_shared<Impl>()) {
+        impl_->ring = ring;
+        impl_->receiveBufferPool = receiveBufferPool;
+    }
+
+    SystemUtils::DiagnosticsSender::UnsubscribeDelegate
+    UringNetworkConnection::SubscribeToDiagnostics(
+        SystemUtils::DiagnosticsSender::DiagnosticMessageDelegate delegate, size_t minLevel) {
+        return impl_->diagnosticsSender->SubscribeToDiagnostics(delegate, minLevel);
+    }
+
+    bool UringNetworkConnection::Connect(uint32_t peerAddress, uint16_t peerPort) {
+        std::lock_guard<decltype(impl_->mutex)> lock(impl_->mutex);
+        if (impl_->sock >= 0)
+        { return false; }
+        const auto address = impl_->TargetAddress(peerAddress, peerPort);
+        const int sock = socket(address.GetFamily(), SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (sock < 0)
+        {
+            impl_->diagnosticsSender->SendDiagnosticInformationFormatted(
+                SystemUtils::DiagnosticsSender::Levels::ERROR, "error creating socket (%s)",
+                strerror(errno));
+            return false;
+        }
+        impl_->SetUpFastOpen(sock, address);
+        if (connect(sock, address.Get(), address.length) != 0)
+        {
+            impl_->diagnosticsSender->SendDiagnosticInformationFormatted(
+                SystemUtils::DiagnosticsSender::Levels::ERROR, "error in connect (%s)",
+                strerror(errno));
+            (void)close(sock);
+            return false;
+        }
+        impl_->sock = sock;
+        impl_->peerAddress = peerAddress;
+        impl_->peerPort = peerPort;
+        impl_->RecordBoundAddress();
+        return true;
+    }
+
+    bool UringNetworkConnection::Process(MessageReceivedDelegate messageReceivedDelegate,
+                                         BrokenDelegate brokenDelegate) {
+        std::lock_guard<decltype(impl_->mutex)> lock(impl_->mutex);
+        if ((impl_->sock < 0) || impl_->broken || (impl_->id != 0) ||
+            (impl_->connectId != 0))
+        { return false; }
+        impl_->messageReceivedDelegate = messageReceivedDelegate;
+        impl_->brokenDelegate = brokenDelegate;
+        const auto handler = std::make_shared<IoUring::Handler>();
+        const auto impl = impl_;
+        handler->received = [impl](std::vector<uint8_t>& buffer, int32_t result, bool armed)
+        { impl->OnReceived(buffer, result, armed); };
+        handler->sent = [impl](int32_t result) { impl->OnSent(result); };
+        impl_->id = impl_->ring->Register(handler);
+        impl_->receiving = true;
+        impl_->ring->SubmitReceive(impl_->sock, impl_->id);
+        impl_->SendNext();
+        return true;
+    }
+
+    uint32_t UringNetworkConnection::GetPeerAddress() const { return impl_->peerAddress; }
+
+    uint16_t UringNetworkConnection::GetPeerPort() const { return impl_->peerPort; }
+
+    bool UringNetworkConnection::IsConnected() const {
+        std::lock_guard<decltype(impl_->mutex)> lock(impl_->mutex);
+        return ((impl_->sock >= 0) && !impl_->broken);
+    }
+
+    uint32_t UringNetworkConnection::GetBoundAddress() const { return impl_->boundAddress; }
+
+    uint16_t UringNetworkConnection::GetBoundPort() const { return impl_->boundPort; }
+
+    void UringNetworkConnection::SendMessage(const std::vector<uint8_t>& message) {
+        SendMessage(OutgoingMessage(std::vector<uint8_t>(message)));
+    }
+
+    void UringNetworkConnection::SendMessage(OutgoingMessage&& message) {
+        std::lock_guard<decltype(impl_->mutex)> lock(impl_->mutex);
+        if ((impl_->sock < 0) || impl_->broken || impl_->closing)
+        { return; }
+        impl_->outputQueue.push_back(std::move(message));
+        if (impl_->id != 0)
+        { impl_->SendNext(); }
+    }
+
+    void UringNetworkConnection::SendMessages(std::vector<OutgoingMessage>&& messages) {
+        std::lock_guard<decltype(impl_->mutex)> lock(impl_->mutex);
+        if ((impl_->sock < 0) || impl_->broken || impl_->closing)
+        { return; }
+        for (auto& message : messages)
+        { impl_->outputQueue.push_back(std::move(message)); }
+        if (impl_->id != 0)
+        { impl_->SendNext(); }
+    }
+
+    void UringNetworkConnection::ConnectAsync(uint32_t peerAddress, uint16_t peerPort,
+                                              ConnectDelegate connectDelegate) {
+        std::unique_lock<decltype(impl_->mutex)> lock(impl_->mutex);
+        if (impl_->sock >= 0)
+        {
+            lock.unlock();
+            connectDelegate(false);
+            return;
+        }
+        impl_->connectAddress = impl_->TargetAddress(peerAddress, peerPort);
+        const int sock = socket(impl_->connectAddress.GetFamily(), SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (sock < 0)
+        {
+            impl_->diagnosticsSender->SendDiagnosticInformationFormatted(
+                SystemUtils::DiagnosticsSender::Levels::ERROR, "error creating socket (%s)",
+                strerror(errno));
+            lock.unlock();
+            connectDelegate(false);
+            return;
+        }
+        impl_->SetUpFastOpen(sock, impl_->connectAddress);
+        impl_->sock = sock;
+        impl_->peerAddress = peerAddress;
+        impl_->peerPort = peerPort;
+        impl_->connectDelegate = std::move(connectDelegate);
+        const auto handler = std::make_shared<IoUring::Handler>();
+        const auto impl = impl_;
+        handler->connected = [impl](int32_t result) { impl->OnConnected(result); };
+        impl_->connectId = impl_->ring->Register(handler);
+        impl_->ring->SubmitConnect(sock, impl_->connectAddress.Get(),
+                                   impl_->connectAddress.length, impl_->connectId);
+    }
+
+    void UringNetworkConnection::EnableFastOpen() {
+        std::lock_guard<decltype(impl_->mutex)> lock(impl_->mutex);
+        impl_->fastOpen = true;
+    }
+
+    bool UringNetworkConnection::UsedFastOpen() {
+        std::lock_guard<decltype(impl_->mutex)> lock(impl_->mutex);
+        impl_->RecordFastOpen();
+        return impl_->fastOpenUsed;
+    }
+
+    bool UringNetworkConnection::OffloadTlsTransmit(const std::vector<uint8_t>& cryptoInfo) {
+        std::lock_guard<decltype(impl_->mutex)> lock(impl_->mutex);
+        if ((impl_->sock < 0) || impl_->broken || impl_->closing || impl_->sending ||
+            !impl_->outputQueue.empty())
+        { return false; }
+        std::string error;
+        if (!EnableTransmit(impl_->sock, cryptoInfo, error))
+        {
+            impl_->diagnosticsSender->SendDiagnosticInformationFormatted(
+                SystemUtils::DiagnosticsSender::Levels::WARNING,
+                "unable to offload TLS encryption to kernel: %s", error.c_str());
+            return false;
+        }
+        return true;
+    }
+
+    void UringNetworkConnection::Close(bool clean) {
+        std::lock_guard<decltype(impl_->mutex)> lock(impl_->mutex);
+        if (clean && (impl_->id != 0))
+        {
+            if (impl_->closing)
+            { return; }
+            impl_->closing = true;
+            impl_->SendNext();
+        } else
+        { impl_->Shutdown(false); }
+    }
+
+    void UringNetworkConnection::SetPeerSocketAddress(const SocketAddress& address) {
+        std::lock_guard<decltype(impl_->mutex)> lock(impl_->mutex);
+        impl_->peerSocketAddress = address;
+    }
+
+    SocketAddress UringNetworkConnection::GetPeerSocketAddress() const {
+        std::lock_guard<decltype(impl_->mutex)> lock(impl_->mutex);
+        return impl_->peerSocketAddress;
+    }
+}  // namespace MqttNetworkTransport
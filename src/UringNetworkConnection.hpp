@@ -0,0 +1,115 @@
+#ifndef MQTT_NETWORK_TRANSPORT_URING_NETWORK_CONNECTION_HPP
+#define MQTT_NETWORK_TRANSPORT_URING_NETWORK_CONNECTION_HPP
+/**
+ * @file UringNetworkConnection.hpp
+ *
+ * This module declares the MqttNetworkTransport::UringNetworkConnection
+ * class.
+ *
+ * © 2025 by Hatem Nabli
+ */
+
+#include "AsyncNetworkConnection.hpp"
+#include "FastOpenConnection.hpp"
+#include "KernelTlsConnection.hpp"
+#include "ReceiveBufferPool.hpp"
+#include "SocketAddressConnection.hpp"
+#include "IoUring.hpp"
+#include <memory>
+
+namespace MqttNetworkTransport
+{
+    /**
+     * This is an implementation of SystemUtils::INetworkConnection whose
+     * sends and receives are submitted to a shared io_uring instance.
+     * Data is received by a multishot receive into registered buffers,
+     * and queued outgoing messages are gathered into one send at a time.
+     */
+    class UringNetworkConnection : public AsyncNetworkConnection,
+                                   public FastOpenConnection,
+                                   public KernelTlsConnection,
+                                   public SocketAddressConnection
+    {
+        // Lifecycle management
+    public:
+        ~UringNetworkConnection() noexcept;
+        UringNetworkConnection(const UringNetworkConnection&) = delete;
+        UringNetworkConnection(UringNetworkConnection&&) noexcept = delete;
+        UringNetworkConnection& operator=(const UringNetworkConnection&) = delete;
+        UringNetworkConnection& operator=(UringNetworkConnection&&) noexcept = delete;
+
+        // Public methods
+    public:
+        /**
+         * This is the constructor.
+         *
+         * @param[in] ring
+         *      This is the io_uring instance to which the connection
+         *      submits its operations once it is processing.
+         * @param[in] receiveBufferPool
+         *      If not null, this is where to take the buffers in which
+         *      received data is delivered, and where they are given
+         *      back once delivered.
+         */
+        UringNetworkConnection(std::shared_ptr<IoUring> ring,
+                               std::shared_ptr<ReceiveBufferPool> receiveBufferPool = nullptr);
+
+        // SystemUtils::INetworkConnection
+    public:
+        virtual SystemUtils::DiagnosticsSender::UnsubscribeDelegate SubscribeToDiagnostics(
+            SystemUtils::DiagnosticsSender::DiagnosticMessageDelegate delegate,
+            size_t minLevel = 0) override;
+        virtual bool Connect(uint32_t peerAddress, uint16_t peerPort) override;
+        virtual bool Process(MessageReceivedDelegate messageReceivedDelegate,
+                             BrokenDelegate brokenDelegate) override;
+        virtual uint32_t GetPeerAddress() const override;
+        virtual uint16_t GetPeerPort() const override;
+        virtual bool IsConnected() const override;
+        virtual uint32_t GetBoundAddress() const override;
+        virtual uint16_t GetBoundPort() const override;
+        virtual void SendMessage(const std::vector<uint8_t>& message) override;
+        virtual void Close(bool clean = false) override;
+
+        // GatherNetworkConnection
+    public:
+        virtual void SendMessage(OutgoingMessage&& message) override;
+        virtual void SendMessages(std::vector<OutgoingMessage>&& messages) override;
+
+        // AsyncNetworkConnection
+    public:
+        virtual void ConnectAsync(uint32_t peerAddress, uint16_t peerPort,
+                                  ConnectDelegate connectDelegate) override;
+
+        // FastOpenConnection
+    public:
+        virtual void EnableFastOpen() override;
+        virtual bool UsedFastOpen() override;
+
+        // KernelTlsConnection
+    public:
+        virtual bool OffloadTlsTransmit(const std::vector<uint8_t>& cryptoInfo) override;
+
+        // SocketAddressConnection
+    public:
+        virtual void SetPeerSocketAddress(const SocketAddress& address) override;
+        virtual SocketAddress GetPeerSocketAddress() const override;
+
+        // Private properties
+    private:
+        /**
+         * This is the type of structure that contains the private
+         * properties of the instance.  It is defined in the implementation
+         * and declared here to ensure that it is scoped inside the class.
+         */
+        struct Impl;
+
+        /**
+         * This contains the private properties of the instance.  It is
+         * kept alive by the ring until all operations submitted for the
+         * connection have completed.
+         */
+        std::shared_ptr<Impl> impl_;
+    };
+}  // namespace MqttNetworkTransport
+
+#endif /** MQTT_NETWORK_TRANSPORT_URING_NETWORK_CONNECTION_HPP */
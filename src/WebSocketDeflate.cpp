@@ -0,0 +1,185 @@
+/**
+ * @file WebSocketDeflate.cpp
+ *
+ * This module implements the MqttNetworkTransport::WebSocketDeflate class.
+ *
+ * © 2025 by Hatem Nabli
+ */
+
+#include "WebSocketDeflate.hpp"
+#include <algorithm>
+#include <zlib.h>
+
+namespace
+{
+    /**
+     * These are the bytes with which a sync flush ends the compressed
+     * data, and which are left out of the payloads of messages.
+     */
+    constexpr uint8_t MESSAGE_TAIL[] = {0x00, 0x00, 0xFF, 0xFF};
+
+    /**
+     * This is the number of bytes by which output buffers are
+     * grown at a time, at least.
+     */
+    constexpr size_t OUTPUT_CHUNK_SIZE = 4096;
+}  // namespace
+
+namespace MqttNetworkTransport
+{
+    struct WebSocketDeflate::Impl
+    {
+        /**
+         * These are the zlib streams which compress what is sent,
+         * and decompress what is received.
+         */
+        z_stream deflater;
+        z_stream inflater;
+
+        /**
+         * These indicate whether or not the zlib streams were set up.
+         */
+        bool deflaterReady = false;
+        bool inflaterReady = false;
+
+        /**
+         * These indicate whether or not the zlib streams keep their
+         * window from one message to the next.
+         */
+        bool compressTakeover = true;
+        bool decompressTakeover = true;
+
+        /**
+         * This is the most bytes to which the payload of a message
+         * received may decompress.
+         */
+        size_t maximumMessageSize = 0;
+
+        /**
+         * This is the number of bytes to which the payload of the
+         * message being received has decompressed so far.
+         */
+        size_t messageSize = 0;
+
+        /**
+         * This is the destructor for the structure.
+         */
+        ~Impl() noexcept {
+            if (deflaterReady)
+            { (void)deflateEnd(&deflater); }
+            if (inflaterReady)
+            { (void)inflateEnd(&inflater); }
+        }
+
+        /**
+         * This method runs the decompressor over the given data,
+         * appending what comes out to the given buffer.
+         *
+         * @param[in] data
+         *      This points to the compressed data.
+         * @param[in] size
+         *      This is the number of bytes of compressed data.
+         * @param[in,out] payload
+         *      This is where to append the decompressed data.
+         * @return
+         *      An indication of whether or not the compressed data was
+         *      well formed, and didn't decompress to more than the most
+         *      allowed for a message, is returned.
+         */
+        bool Inflate(const uint8_t* data, size_t size, std::vector<uint8_t>& payload) {
+            inflater.next_in = (Bytef*)data;
+            inflater.avail_in = (uInt)size;
+            for (;;)
+            {
+                const auto start = payload.size();
+                payload.resize(start + std::max(OUTPUT_CHUNK_SIZE, size * 2));
+                inflater.next_out = payload.data() + start;
+                inflater.avail_out = (uInt)(payload.size() - start);
+                const auto result = inflate(&inflater, Z_SYNC_FLUSH);
+                const bool outputFull = (inflater.avail_out == 0);
+                payload.resize(payload.size() - inflater.avail_out);
+                messageSize += (payload.size() - start);
+                if (messageSize > maximumMessageSize)
+                { return false; }
+                if (result == Z_STREAM_END)
+                {
+                    // The peer ended the stream with a final block, so
+                    // the next message starts a new one.
+                    (void)inflateReset(&inflater);
+                } else if ((result != Z_OK) && (result != Z_BUF_ERROR))
+                { return false; }
+                if ((inflater.avail_in == 0) && !outputFull)
+                { break; }
+            }
+            return true;
+        }
+    };
+
+    WebSocketDeflate::~WebSocketDeflate() noexcept = default;
+
+    WebSocketDeflate::WebSocketDeflate(int level, int windowBits, bool compressTakeover,
+                                       bool decompressTakeover, size_t maximumMessageSize) :
+        impl_(new Impl) {
+        impl_->compressTakeover = compressTakeover;
+        impl_->decompressTakeover = decompressTakeover;
+        impl_->maximumMessageSize = maximumMessageSize;
+        impl_->deflater = z_stream();
+        impl_->inflater = z_stream();
+        // A raw deflate stream can't be compressed with a window of 256
+        // bytes (zlib would use 512), so a server asking for one can't be
+        // obeyed, rather than being obeyed only in appearance.
+        if ((windowBits >= 9) && (windowBits <= 15))
+        {
+            impl_->deflaterReady =
+                (deflateInit2(&impl_->deflater, std::min(9, std::max(1, level)), Z_DEFLATED,
+                              -windowBits, 8, Z_DEFAULT_STRATEGY) == Z_OK);
+        }
+        impl_->inflaterReady = (inflateInit2(&impl_->inflater, -15) == Z_OK);
+    }
+
+    bool WebSocketDeflate::IsReady() const {
+        return (impl_->deflaterReady && impl_->inflaterReady);
+    }
+
+    bool WebSocketDeflate::Compress(const uint8_t* data, size_t size,
+                                    std::vector<uint8_t>& compressed) {
+        auto& deflater = impl_->deflater;
+        compressed.resize(deflateBound(&deflater, (uLong)size) + sizeof(MESSAGE_TAIL));
+        deflater.next_in = (Bytef*)data;
+        deflater.avail_in = (uInt)size;
+        size_t used = 0;
+        for (;;)
+        {
+            deflater.next_out = compressed.data() + used;
+            deflater.avail_out = (uInt)(compressed.size() - used);
+            const auto result = deflate(&deflater, Z_SYNC_FLUSH);
+            used = compressed.size() - deflater.avail_out;
+            if ((result != Z_OK) && (result != Z_BUF_ERROR))
+            { return false; }
+            if ((deflater.avail_in == 0) && (deflater.avail_out > 0))
+            { break; }
+            compressed.resize(compressed.size() + OUTPUT_CHUNK_SIZE);
+        }
+        if ((used >= sizeof(MESSAGE_TAIL)) &&
+            std::equal(MESSAGE_TAIL, MESSAGE_TAIL + sizeof(MESSAGE_TAIL),
+                       compressed.begin() + (used - sizeof(MESSAGE_TAIL))))
+        { used -= sizeof(MESSAGE_TAIL); }
+        compressed.resize(used);
+        if (!impl_->compressTakeover)
+        { (void)deflateReset(&deflater); }
+        return true;
+    }
+
+    bool WebSocketDeflate::Decompress(const uint8_t* data, size_t size, bool final,
+                                      std::vector<uint8_t>& payload) {
+        if (!final)
+        { return impl_->Inflate(data, size, payload); }
+        const bool wellFormed = impl_->Inflate(MESSAGE_TAIL, sizeof(MESSAGE_TAIL), payload);
+        impl_->messageSize = 0;
+        if (!wellFormed)
+        { return false; }
+        if (!impl_->decompressTakeover)
+        { (void)inflateReset(&impl_->inflater); }
+        return true;
+    }
+}  // namespace MqttNetworkTransport
@@ -0,0 +1,119 @@
+#ifndef MQTT_NETWORK_TRANSPORT_WEB_SOCKET_DEFLATE_HPP
+#define MQTT_NETWORK_TRANSPORT_WEB_SOCKET_DEFLATE_HPP
+/**
+ * @file WebSocketDeflate.hpp
+ *
+ * This module declares the MqttNetworkTransport::WebSocketDeflate class.
+ *
+ * © 2025 by Hatem Nabli
+ */
+
+#include <memory>
+#include <vector>
+#include <stddef.h>
+#include <stdint.h>
+
+namespace MqttNetworkTransport
+{
+    /**
+     * This compresses the payloads of the WebSocket messages a client
+     * sends, and decompresses those of the messages it receives, as
+     * described for the permessage-deflate extension in RFC 7692.
+     */
+    class WebSocketDeflate
+    {
+        // Lifecycle management
+    public:
+        ~WebSocketDeflate() noexcept;
+        WebSocketDeflate(const WebSocketDeflate&) = delete;
+        WebSocketDeflate(WebSocketDeflate&&) noexcept = delete;
+        WebSocketDeflate& operator=(const WebSocketDeflate&) = delete;
+        WebSocketDeflate& operator=(WebSocketDeflate&&) noexcept = delete;
+
+        // Public methods
+    public:
+        /**
+         * This is the constructor.
+         *
+         * @param[in] level
+         *      This is the zlib compression level (1 to 9) with
+         *      which to compress.
+         * @param[in] windowBits
+         *      This is the base-two logarithm of the size of the window
+         *      used to compress (9 to 15).  Other sizes leave the
+         *      object unusable.
+         * @param[in] compressTakeover
+         *      This indicates whether or not each message sent is
+         *      compressed using the messages sent before it.
+         * @param[in] decompressTakeover
+         *      This indicates whether or not each message received was
+         *      compressed using the messages received before it.
+         * @param[in] maximumMessageSize
+         *      This is the most bytes to which the payload of a message
+         *      received may decompress.
+         */
+        WebSocketDeflate(int level, int windowBits, bool compressTakeover,
+                         bool decompressTakeover, size_t maximumMessageSize);
+
+        /**
+         * This method returns whether or not the compressor and
+         * decompressor were set up.
+         *
+         * @return
+         *      An indication of whether or not the object
+         *      is usable is returned.
+         */
+        bool IsReady() const;
+
+        /**
+         * This method compresses the payload of a message to send.
+         *
+         * @param[in] data
+         *      This points to the payload to compress.
+         * @param[in] size
+         *      This is the number of bytes of payload.
+         * @param[out] compressed
+         *      This is where to store the compressed payload.
+         * @return
+         *      An indication of whether or not the payload
+         *      was compressed is returned.
+         */
+        bool Compress(const uint8_t* data, size_t size, std::vector<uint8_t>& compressed);
+
+        /**
+         * This method decompresses the next part of the payload of a
+         * message received.
+         *
+         * @param[in] data
+         *      This points to the next part of the compressed payload.
+         * @param[in] size
+         *      This is the number of bytes of compressed payload.
+         * @param[in] final
+         *      This indicates whether or not the message is complete.
+         * @param[in,out] payload
+         *      This is where to append the decompressed payload.
+         * @return
+         *      An indication of whether or not the compressed payload
+         *      was well formed, and didn't decompress to more than the
+         *      most allowed for a message, is returned.
+         */
+        bool Decompress(const uint8_t* data, size_t size, bool final,
+                        std::vector<uint8_t>& payload);
+
+        // Private properties
+    private:
+        /**
+         * This is the type of structure that contains the private
+         * properties of the instance.  It is defined in the implementation
+         * and declared here to ensure that it is scoped inside the class.
+         */
+        struct Impl;
+
+        /**
+         * This contains the private properties of the instance.
+         */
+        std::unique_ptr<Impl> impl_;
+    };
+}  // namespace MqttNetworkTransport
+
+#endif /** MQTT_NETWORK_TRANSPORT_WEB_SOCKET_DEFLATE_HPP */
@@ -0,0 +1,393 @@
+/**
+ * @file WebSocketFramer.cpp
+ *
+ * This module implements the MqttNetworkTransport::WebSocketFramer class.
+ *
+ * © 2025 by Hatem Nabli
+ */
+
+#include "WebSocketFramer.hpp"
+#include <random>
+#include <string.h>
+
+#if defined(MQTT_NETWORK_TRANSPORT_TLS)
+#    include <openssl/rand.h>
+#elif defined(__linux__)
+#    include <sys/random.h>
+#endif
+
+#if defined(__AVX2__)
+#    include <immintrin.h>
+#elif defined(__SSE2__)
+#    include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#    include <arm_neon.h>
+#endif
+
+namespace
+{
+    /**
+     * This is the largest payload of a control frame.
+     */
+    constexpr size_t MAXIMUM_CONTROL_PAYLOAD = 125;
+
+    /**
+     * This is the largest frame header: two bytes, eight bytes of
+     * extended payload length and four bytes of masking key.
+     */
+    constexpr size_t MAXIMUM_HEADER_SIZE = 14;
+
+    /**
+     * This is the number of random bytes fetched at once for masking keys.
+     */
+    constexpr size_t MASKING_KEY_BATCH_SIZE = 256;
+
+    /**
+     * This function fills the given buffer with bytes from a
+     * cryptographically secure random number generator: OpenSSL's when
+     * TLS is built in, otherwise the kernel's where it can be reached
+     * directly, falling back to std::random_device.
+     *
+     * @param[out] buffer
+     *      This is where to store the random bytes.
+     * @param[in] size
+     *      This is the number of random bytes to store.
+     */
+    void FillRandom(uint8_t* buffer, size_t size) {
+#if defined(MQTT_NETWORK_TRANSPORT_TLS)
+        if (RAND_bytes(buffer, (int)size) == 1)
+        { return; }
+#elif defined(__linux__)
+        size_t filled = 0;
+        while (filled < size)
+        {
+            const auto amount = getrandom(buffer + filled, size - filled, 0);
+            if (amount <= 0)
+            { break; }
+            filled += (size_t)amount;
+        }
+        if (filled == size)
+        { return; }
+#endif
+        std::random_device random;
+        for (size_t i = 0; i < size; ++i)
+        { buffer[i] = (uint8_t)random(); }
+    }
+}  // namespace
+
+namespace MqttNetworkTransport
+{
+    constexpr uint8_t WebSocketFramer::OPCODE_CONTINUATION;
+    constexpr uint8_t WebSocketFramer::OPCODE_TEXT;
+    constexpr uint8_t WebSocketFramer::OPCODE_BINARY;
+    constexpr uint8_t WebSocketFramer::OPCODE_CLOSE;
+    constexpr uint8_t WebSocketFramer::OPCODE_PING;
+    constexpr uint8_t WebSocketFramer::OPCODE_PONG;
+
+    struct WebSocketFramer::Impl
+    {
+        /**
+         * These are random bytes fetched for the masking keys
+         * of the frames sent.
+         */
+        uint8_t maskingKeys[MASKING_KEY_BATCH_SIZE];
+
+        /**
+         * This is the number of bytes of maskingKeys already used.
+         */
+        size_t maskingKeysUsed = MASKING_KEY_BATCH_SIZE;
+
+        /**
+         * This indicates whether malformed data has been seen, after
+         * which no more data is decoded.
+         */
+        bool malformed = false;
+
+        /**
+         * This holds the header of the frame being received,
+         * until it is complete.
+         */
+        uint8_t header[MAXIMUM_HEADER_SIZE];
+
+        /**
+         * This is the number of bytes of the header of the frame
+         * being received which have been received so far.
+         */
+        size_t headerReceived = 0;
+
+        /**
+         * This indicates whether or not the payload of a frame
+         * is being received, its header being complete.
+         */
+        bool inPayload = false;
+
+        /**
+         * This is the opcode of the frame whose payload is being received.
+         */
+        uint8_t opcode = 0;
+
+        /**
+         * This indicates whether or not the data frame whose payload is
+         * being received, or was last received, is the last frame
+         * of its message.
+         */
+        bool dataFinal = true;
+
+        /**
+         * This indicates whether or not the payload of the message
+         * being received is compressed.
+         */
+        bool messageCompressed = false;
+
+        /**
+         * This is the function to call to decompress the payloads of
+         * compressed messages, if they are expected.
+         */
+        InflateDelegate inflateDelegate;
+
+        /**
+         * This is the number of bytes of payload of the frame being
+         * received which have yet to be received.
+         */
+        uint64_t payloadRemaining = 0;
+
+        /**
+         * This holds the payload of the control frame being received.
+         */
+        std::vector<uint8_t> controlPayload;
+
+        /**
+         * This method stores a new, unpredictable masking key.  Random
+         * bytes are fetched in batches to spare a system call per frame.
+         *
+         * @param[out] key
+         *      This is where to store the masking key.
+         */
+        void NextMaskingKey(uint8_t key[4]) {
+            if (maskingKeysUsed + 4 > MASKING_KEY_BATCH_SIZE)
+            {
+                FillRandom(maskingKeys, MASKING_KEY_BATCH_SIZE);
+                maskingKeysUsed = 0;
+            }
+            (void)memcpy(key, maskingKeys + maskingKeysUsed, 4);
+            maskingKeysUsed += 4;
+        }
+
+        /**
+         * This method returns the size of the header of the frame being
+         * received, once enough of it has been received to tell.
+         *
+         * @return
+         *      The size of the header is returned, or zero if
+         *      it isn't known yet.
+         */
+        size_t HeaderSize() const {
+            if (headerReceived < 2)
+            { return 0; }
+            const auto length = (header[1] & 0x7F);
+            return (2 + ((length == 126) ? 2 : ((length == 127) ? 8 : 0)) +
+                    (((header[1] & 0x80) != 0) ? 4 : 0));
+        }
+
+        /**
+         * This method interprets the complete header of the
+         * frame being received.
+         *
+         * @param[in,out] controlFrames
+         *      This is where to append the frame, if it is a control
+         *      frame without payload.
+         * @param[in,out] payload
+         *      This is where to append what remains of the decompressed
+         *      payload, if the frame, without payload, completes a
+         *      compressed message.
+         * @return
+         *      An indication of whether or not the header
+         *      is well formed is returned.
+         */
+        bool StartFrame(std::vector<ControlFrame>& controlFrames, std::vector<uint8_t>& payload) {
+            const bool final = ((header[0] & 0x80) != 0);
+            const bool compressed = ((header[0] & 0x40) != 0);
+            opcode = (header[0] & 0x0F);
+            if (((header[0] & 0x30) != 0) || ((header[1] & 0x80) != 0))
+            { return false; }
+            const auto length = (header[1] & 0x7F);
+            if (length == 126)
+            { payloadRemaining = ((uint64_t)header[2] << 8) | header[3]; } else if (length == 127)
+            {
+                payloadRemaining = 0;
+                for (size_t i = 2; i < 10; ++i)
+                { payloadRemaining = (payloadRemaining << 8) | header[i]; }
+            } else
+            { payloadRemaining = length; }
+            if ((opcode & 0x08) != 0)
+            {
+                if (!final || compressed || (payloadRemaining > MAXIMUM_CONTROL_PAYLOAD))
+                { return false; }
+                controlPayload.clear();
+            } else if (opcode > OPCODE_BINARY)
+            { return false; } else
+            {
+                if ((opcode == OPCODE_CONTINUATION) == dataFinal)
+                { return false; }
+                if (compressed)
+                {
+                    if ((opcode == OPCODE_CONTINUATION) || (inflateDelegate == nullptr))
+                    { return false; }
+                    messageCompressed = true;
+                }
+                dataFinal = final;
+            }
+            headerReceived = 0;
+            inPayload = true;
+            if (payloadRemaining == 0)
+            { return FinishFrame(controlFrames, payload); }
+            return true;
+        }
+
+        /**
+         * This method completes the frame being received.
+         *
+         * @param[in,out] controlFrames
+         *      This is where to append the frame, if it is a control frame.
+         * @param[in,out] payload
+         *      This is where to append what remains of the decompressed
+         *      payload, if the frame completes a compressed message.
+         * @return
+         *      An indication of whether or not the frame
+         *      is well formed is returned.
+         */
+        bool FinishFrame(std::vector<ControlFrame>& controlFrames, std::vector<uint8_t>& payload) {
+            inPayload = false;
+            if ((opcode & 0x08) == 0)
+            {
+                if (!dataFinal || !messageCompressed)
+                { return true; }
+                messageCompressed = false;
+                return inflateDelegate(nullptr, 0, true, payload);
+            }
+            ControlFrame frame;
+            frame.opcode = opcode;
+            frame.payload.swap(controlPayload);
+            controlFrames.push_back(std::move(frame));
+            return true;
+        }
+    };
+
+    WebSocketFramer::~WebSocketFramer() noexcept = default;
+
+    WebSocketFramer::WebSocketFramer() : impl_(new Impl) {}
+
+    void WebSocketFramer::Mask(const uint8_t* input, uint8_t* output, size_t size,
+                               const uint8_t key[4]) {
+        uint32_t key32;
+        (void)memcpy(&key32, key, sizeof(key32));
+        size_t i = 0;
+#if defined(__AVX2__)
+        const __m256i key256 = _mm256_set1_epi32((int)key32);
+        for (; i + 32 <= size; i += 32)
+        {
+            const __m256i block = _mm256_loadu_si256((const __m256i*)(input + i));
+            _mm256_storeu_si256((__m256i*)(output + i), _mm256_xor_si256(block, key256));
+        }
+#elif defined(__SSE2__)
+        const __m128i key128 = _mm_set1_epi32((int)key32);
+        for (; i + 16 <= size; i += 16)
+        {
+            const __m128i block = _mm_loadu_si128((const __m128i*)(input + i));
+            _mm_storeu_si128((__m128i*)(output + i), _mm_xor_si128(block, key128));
+        }
+#elif defined(__ARM_NEON)
+        const uint8x16_t key128 = vreinterpretq_u8_u32(vdupq_n_u32(key32));
+        for (; i + 16 <= size; i += 16)
+        { vst1q_u8(output + i, veorq_u8(vld1q_u8(input + i), key128)); }
+#endif
+        const uint64_t key64 = (((uint64_t)key32 << 32) | key32);
+        for (; i + 8 <= size; i += 8)
+        {
+            uint64_t block;
+            (void)memcpy(&block, input + i, sizeof(block));
+            block ^= key64;
+            (void)memcpy(output + i, &block, sizeof(block));
+        }
+        for (; i < size; ++i)
+        { output[i] = (input[i] ^ key[i & 3]); }
+    }
+
+    void WebSocketFramer::Encode(uint8_t opcode, const uint8_t* payload, size_t size,
+                                 std::vector<uint8_t>& frames, bool compressed) {
+        const auto start = frames.size();
+        const size_t lengthSize = ((size < 126) ? 0 : ((size <= 0xFFFF) ? 2 : 8));
+        frames.resize(start + 2 + lengthSize + 4 + size);
+        auto frame = frames.data() + start;
+        *frame++ = (uint8_t)(0x80 | (compressed ? 0x40 : 0) | opcode);
+        if (lengthSize == 0)
+        { *frame++ = (uint8_t)(0x80 | size); } else if (lengthSize == 2)
+        {
+            *frame++ = (0x80 | 126);
+            *frame++ = (uint8_t)(size >> 8);
+            *frame++ = (uint8_t)size;
+        } else
+        {
+            *frame++ = (0x80 | 127);
+            for (int shift = 56; shift >= 0; shift -= 8)
+            { *frame++ = (uint8_t)((uint64_t)size >> shift); }
+        }
+        uint8_t key[4];
+        impl_->NextMaskingKey(key);
+        (void)memcpy(frame, key, sizeof(key));
+        frame += sizeof(key);
+        Mask(payload, frame, size, key);
+    }
+
+    void WebSocketFramer::SetInflateDelegate(InflateDelegate inflateDelegate) {
+        impl_->inflateDelegate = inflateDelegate;
+    }
+
+    bool WebSocketFramer::Decode(const uint8_t* data, size_t size, std::vector<uint8_t>& payload,
+                                 std::vector<ControlFrame>& controlFrames) {
+        if (impl_->malformed)
+        { return false; }
+        while (size > 0)
+        {
+            if (!impl_->inPayload)
+            {
+                auto needed = impl_->HeaderSize();
+                if (needed == 0)
+                { needed = 2; }
+                const auto amount = std::min(size, needed - impl_->headerReceived);
+                (void)memcpy(impl_->header + impl_->headerReceived, data, amount);
+                impl_->headerReceived += amount;
+                data += amount;
+                size -= amount;
+                if ((impl_->headerReceived < 2) || (impl_->headerReceived < impl_->HeaderSize()))
+                { continue; }
+                if (!impl_->StartFrame(controlFrames, payload))
+                {
+                    impl_->malformed = true;
+                    return false;
+                }
+                continue;
+            }
+            const auto amount = (size_t)std::min((uint64_t)size, impl_->payloadRemaining);
+            bool wellFormed = true;
+            if ((impl_->opcode & 0x08) != 0)
+            {
+                (void)impl_->controlPayload.insert(impl_->controlPayload.end(), data,
+                                                   data + amount);
+            } else if (impl_->messageCompressed)
+            { wellFormed = impl_->inflateDelegate(data, amount, false, payload); } else
+            { (void)payload.insert(payload.end(), data, data + amount); }
+            impl_->payloadRemaining -= amount;
+            data += amount;
+            size -= amount;
+            if (wellFormed && (impl_->payloadRemaining == 0))
+            { wellFormed = impl_->FinishFrame(controlFrames, payload); }
+            if (!wellFormed)
+            {
+                impl_->malformed = true;
+                return false;
+            }
+        }
+        return true;
+    }
+}  // namespace MqttNetworkTransport
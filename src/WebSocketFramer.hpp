@@ -0,0 +1,180 @@
+#ifndef MQTT_NETWORK_TRANSPORT_WEB_SOCKET_FRAMER_HPP
+#define MQTT_NETWORK_TRANSPORT_WEB_SOCKET_FRAMER_HPP
+/**
+ * @file WebSocketFramer.hpp
+ *
+ * This module declares the MqttNetworkTransport::WebSocketFramer class.
+ *
+ * © 2025 by Hatem Nabli
+ */
+
+#include <functional>
+#include <memory>
+#include <vector>
+#include <stddef.h>
+#include <stdint.h>
+
+namespace MqttNetworkTransport
+{
+    /**
+     * This encodes the frames a WebSocket client sends, and decodes the
+     * frames it receives, as described in RFC 6455.  Data frames are
+     * decoded as a stream: their payloads are gathered, without their
+     * headers, as the data arrives, without waiting for whole frames.
+     */
+    class WebSocketFramer
+    {
+    public:
+        /**
+         * These are the frame opcodes used by the client.
+         */
+        static constexpr uint8_t OPCODE_CONTINUATION = 0x0;
+        static constexpr uint8_t OPCODE_TEXT = 0x1;
+        static constexpr uint8_t OPCODE_BINARY = 0x2;
+        static constexpr uint8_t OPCODE_CLOSE = 0x8;
+        static constexpr uint8_t OPCODE_PING = 0x9;
+        static constexpr uint8_t OPCODE_PONG = 0xA;
+
+        /**
+         * This holds a control frame received.
+         */
+        struct ControlFrame
+        {
+            /**
+             * This is the opcode of the frame.
+             */
+            uint8_t opcode = 0;
+
+            /**
+             * This is the payload of the frame.
+             */
+            std::vector<uint8_t> payload;
+        };
+
+        /**
+         * This is the type of function used to decompress the payloads
+         * of messages received compressed (with the RSV1 bit set on their
+         * first frame, as negotiated by the permessage-deflate extension).
+         *
+         * @param[in] data
+         *      This points to the next part of the compressed payload.
+         * @param[in] size
+         *      This is the number of bytes of compressed payload.
+         * @param[in] final
+         *      This indicates whether or not the message is complete,
+         *      in which case no data is given.
+         * @param[in,out] payload
+         *      This is where to append the decompressed payload.
+         * @return
+         *      An indication of whether or not the compressed
+         *      payload was well formed is returned.
+         */
+        typedef std::function<bool(const uint8_t* data, size_t size, bool final,
+                                   std::vector<uint8_t>& payload)>
+            InflateDelegate;
+
+        // Lifecycle management
+    public:
+        ~WebSocketFramer() noexcept;
+        WebSocketFramer(const WebSocketFramer&) = delete;
+        WebSocketFramer(WebSocketFramer&&) noexcept = delete;
+        WebSocketFramer& operator=(const WebSocketFramer&) = delete;
+        WebSocketFramer& operator=(WebSocketFramer&&) noexcept = delete;
+
+        // Public methods
+    public:
+        /**
+         * This is the default constructor.
+         */
+        WebSocketFramer();
+
+        /**
+         * This function copies the given data while applying the given
+         * WebSocket masking key to it.  Large payloads are masked with
+         * vector instructions, when the target has them.
+         *
+         * @param[in] input
+         *      This points to the data to mask.
+         * @param[out] output
+         *      This points to where to store the masked data.
+         *      It may be the same as the input.
+         * @param[in] size
+         *      This is the number of bytes to mask.
+         * @param[in] key
+         *      This is the masking key, whose first byte
+         *      applies to the first byte of the data.
+         */
+        static void Mask(const uint8_t* input, uint8_t* output, size_t size,
+                         const uint8_t key[4]);
+
+        /**
+         * This method appends to the given buffer a final, masked frame
+         * with the given opcode and payload.  The masking key comes from
+         * a cryptographically secure random number generator, as
+         * RFC 6455 requires of clients.
+         *
+         * @param[in] opcode
+         *      This is the opcode of the frame.
+         * @param[in] payload
+         *      This points to the payload of the frame.
+         * @param[in] size
+         *      This is the number of bytes of payload.
+         * @param[in,out] frames
+         *      This is where to append the frame.
+         * @param[in] compressed
+         *      This indicates whether or not the payload is compressed,
+         *      in which case the RSV1 bit of the frame is set.
+         */
+        void Encode(uint8_t opcode, const uint8_t* payload, size_t size,
+                    std::vector<uint8_t>& frames, bool compressed = false);
+
+        /**
+         * This method sets up the decoding of messages received
+         * compressed, which are otherwise malformed.
+         *
+         * @param[in] inflateDelegate
+         *      This is the function to call to decompress the payloads
+         *      of compressed messages received.
+         */
+        void SetInflateDelegate(InflateDelegate inflateDelegate);
+
+        /**
+         * This method takes in data received on the connection, appending
+         * the payloads of the data frames in it to the given buffer
+         * (decompressed, if need be), and collecting the complete
+         * control frames in it.
+         *
+         * @param[in] data
+         *      This points to the data received.
+         * @param[in] size
+         *      This is the number of bytes received.
+         * @param[in,out] payload
+         *      This is where to append the payloads of data frames.
+         * @param[in,out] controlFrames
+         *      This is where to append the complete control frames.
+         * @return
+         *      An indication of whether or not the data was well formed
+         *      is returned.  Once malformed data is seen, the stream
+         *      cannot be decoded anymore and the connection should
+         *      be broken.
+         */
+        bool Decode(const uint8_t* data, size_t size, std::vector<uint8_t>& payload,
+                    std::vector<ControlFrame>& controlFrames);
+
+        // Private properties
+    private:
+        /**
+         * This is the type of structure that contains the private
+         * properties of the instance.  It is defined in the implementation
+         * and declared here to ensure that it is scoped inside the class.
+         */
+        struct Impl;
+
+        /**
+         * This contains the private properties of the instance.
+         */
+        std::unique_ptr<Impl> impl_;
+    };
+}  // namespace MqttNetworkTransport
+
+#endif /** MQTT_NETWORK_TRANSPORT_WEB_SOCKET_FRAMER_HPP */
@@ -0,0 +1,1151 @@
+/**
+ * @file WebSocketNetworkConnection.cpp
+ *
+ * This module implements the
+ * MqttNetworkTransport::WebSocketNetworkConnection class.
+ *
+ * © 2025 by Hatem Nabli
+ */
+
+#include "WebSocketNetworkConnection.hpp"
+#include "WebSocketFramer.hpp"
+#include <algorithm>
+#include <chrono>
+#include <deque>
+#include <future>
+#include <mutex>
+#include <random>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(MQTT_NETWORK_TRANSPORT_DEFLATE)
+#    include "WebSocketDeflate.hpp"
+#endif /* MQTT_NETWORK_TRANSPORT_DEFLATE */
+
+namespace
+{
+    /**
+     * This is the most bytes of response to the upgrade request
+     * accepted before the end of its headers.
+     */
+    constexpr size_t MAXIMUM_RESPONSE_SIZE = 8192;
+
+    /**
+     * This is appended to the key of the upgrade request to form what
+     * the server hashes into the Sec-WebSocket-Accept header.
+     */
+    const std::string WEBSOCKET_GUID = "258EAFA5-E914-47DA-95CA-C5AB0DC85B11";
+
+    /**
+     * This is the status code sent in the close frame of a
+     * connection closed normally.
+     */
+    constexpr uint16_t CLOSE_NORMAL = 1000;
+
+#if defined(MQTT_NETWORK_TRANSPORT_DEFLATE)
+    /**
+     * This is the smallest message sent compressed, when the
+     * permessage-deflate extension is in use.  Smaller messages,
+     * such as PINGREQ packets, would only grow.
+     */
+    constexpr size_t MINIMUM_COMPRESSED_SIZE = 32;
+#endif /* MQTT_NETWORK_TRANSPORT_DEFLATE */
+
+    /**
+     * This function computes the SHA-1 digest of the given data,
+     * which the upgrade handshake uses to prove the server
+     * understood the request.
+     *
+     * @param[in] data
+     *      This is the data to hash.
+     * @return
+     *      The 20-byte digest of the data is returned.
+     */
+    std::vector<uint8_t> Sha1(const std::string& data) {
+        uint32_t h[5] = {0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476, 0xC3D2E1F0};
+        std::vector<uint8_t> message(data.begin(), data.end());
+        const uint64_t bitLength = (uint64_t)data.size() * 8;
+        message.push_back(0x80);
+        while ((message.size() % 64) != 56)
+        { message.push_back(0); }
+        for (int shift = 56; shift >= 0; shift -= 8)
+        { message.push_back((uint8_t)(bitLength >> shift)); }
+        const auto rotate = [](uint32_t x, int n) { return ((x << n) | (x >> (32 - n))); };
+        for (size_t block = 0; block < message.size(); block += 64)
+        {
+            uint32_t w[80];
+            for (size_t i = 0; i < 16; ++i)
+            {
+                w[i] = (((uint32_t)message[block + i * 4] << 24) |
+                        ((uint32_t)message[block + i * 4 + 1] << 16) |
+                        ((uint32_t)message[block + i * 4 + 2] << 8) |
+                        (uint32_t)message[block + i * 4 + 3]);
+            }
+            for (size_t i = 16; i < 80; ++i)
+            { w[i] = rotate(w[i - 3] ^ w[i - 8] ^ w[i - 14] ^ w[i - 16], 1); }
+            uint32_t a = h[0], b = h[1], c = h[2], d = h[3], e = h[4];
+            for (size_t i = 0; i < 80; ++i)
+            {
+                uint32_t f, k;
+                if (i < 20)
+                {
+                    f = ((b & c) | (~b & d));
+                    k = 0x5A827999;
+                } else if (i < 40)
+                {
+                    f = (b ^ c ^ d);
+                    k = 0x6ED9EBA1;
+                } else if (i < 60)
+                {
+                    f = ((b & c) | (b & d) | (c & d));
+                    k = 0x8F1BBCDC;
+                } else
+                {
+                    f = (b ^ c ^ d);
+                    k = 0xCA62C1D6;
+                }
+                const uint32_t temp = rotate(a, 5) + f + e + k + w[i];
+                e = d;
+                d = c;
+                c = rotate(b, 30);
+                b = a;
+                a = temp;
+            }
+            h[0] += a;
+            h[1] += b;
+            h[2] += c;
+            h[3] += d;
+            h[4] += e;
+        }
+        std::vector<uint8_t> digest;
+        for (const auto word : h)
+        {
+            for (int shift = 24; shift >= 0; shift -= 8)
+            { digest.push_back((uint8_t)(word >> shift)); }
+        }
+        return digest;
+    }
+
+    /**
+     * This function encodes the given data in base64.
+     *
+     * @param[in] data
+     *      This is the data to encode.
+     * @return
+     *      The base64 encoding of the data is returned.
+     */
+    std::string Base64(const std::vector<uint8_t>& data) {
+        static const char alphabet[] =
+            "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+        std::string encoding;
+        for (size_t i = 0; i < data.size(); i += 3)
+        {
+            const size_t remaining = std::min<size_t>(3, data.size() - i);
+            uint32_t group = ((uint32_t)data[i] << 16);
+            if (remaining > 1)
+            { group |= ((uint32_t)data[i + 1] << 8); }
+            if (remaining > 2)
+            { group |= data[i + 2]; }
+            encoding += alphabet[(group >> 18) & 0x3F];
+            encoding += alphabet[(group >> 12) & 0x3F];
+            encoding += ((remaining > 1) ? alphabet[(group >> 6) & 0x3F] : '=');
+            encoding += ((remaining > 2) ? alphabet[group & 0x3F] : '=');
+        }
+        return encoding;
+    }
+
+    /**
+     * This function returns a copy of the given string, with its
+     * letters in lower case and surrounding whitespace removed.
+     *
+     * @param[in] s
+     *      This is the string to normalize.
+     * @return
+     *      The normalized string is returned.
+     */
+    std::string Normalize(const std::string& s) {
+        const auto first = s.find_first_not_of(" \t");
+        if (first == std::string::npos)
+        { return ""; }
+        const auto last = s.find_last_not_of(" \t");
+        std::string normalized = s.substr(first, last - first + 1);
+        for (auto& c : normalized)
+        {
+            if ((c >= 'A') && (c <= 'Z'))
+            { c = (char)(c - 'A' + 'a'); }
+        }
+        return normalized;
+    }
+
+    /**
+     * This function splits the given string at each
+     * occurrence of the given delimiter.
+     *
+     * @param[in] s
+     *      This is the string to split.
+     * @param[in] delimiter
+     *      This is the character at which to split the string.
+     * @return
+     *      The parts of the string are returned.
+     */
+    std::vector<std::string> Split(const std::string& s, char delimiter) {
+        std::vector<std::string> parts;
+        size_t start = 0;
+        for (;;)
+        {
+            const auto end = s.find(delimiter, start);
+            parts.push_back(s.substr(start, end - start));
+            if (end == std::string::npos)
+            { break; }
+            start = end + 1;
+        }
+        return parts;
+    }
+}  // namespace
+
+namespace MqttNetworkTransport
+{
+    struct WebSocketNetworkConnection::Impl : public std::enable_shared_from_this<Impl>
+    {
+        /**
+         * These are the stages through which the connection goes.
+         */
+        enum class State
+        {
+            /**
+             * No attempt to connect has been made yet.
+             */
+            Idle,
+
+            /**
+             * The inner connection is being established.
+             */
+            Connecting,
+
+            /**
+             * The upgrade request was sent, and its
+             * response is awaited.
+             */
+            Upgrading,
+
+            /**
+             * The connection was upgraded, and frames
+             * may be exchanged.
+             */
+            Established,
+
+            /**
+             * The connection was closed locally, and its breakage
+             * is delivered once the inner connection is broken.
+             */
+            Closing,
+
+            /**
+             * The connection failed or was broken.
+             */
+            Closed,
+        };
+
+        /**
+         * This is the connection which carries the frames.
+         */
+        std::shared_ptr<SystemUtils::INetworkConnection> inner;
+
+        /**
+         * If the inner connection takes ownership of the messages it
+         * sends, this is the same object as inner.
+         */
+        std::shared_ptr<GatherNetworkConnection> innerGather;
+
+        /**
+         * If the inner connection can establish itself without
+         * blocking, this is the same object as inner.
+         */
+        std::shared_ptr<AsyncNetworkConnection> innerAsync;
+
+        /**
+         * If the inner connection can be established with TCP Fast Open,
+         * this is the same object as inner.
+         */
+        std::shared_ptr<FastOpenConnection> innerFastOpen;
+
+        /**
+         * This is the name or IPv4 literal of the server.
+         */
+        std::string serverName;
+
+        /**
+         * This is the path of the resource requested for the upgrade.
+         */
+        std::string path;
+
+        /**
+         * This is the pool of workers which establish the inner
+         * connection, if it can only connect by blocking.
+         */
+        std::shared_ptr<WorkerPool> connectWorkers;
+
+        /**
+         * This is a helper object used to generate and publish diagnostics messages.
+         */
+        std::shared_ptr<SystemUtils::DiagnosticsSender> diagnosticsSender;
+
+        /**
+         * This is used to synchronize access to the state
+         * of the connection.
+         */
+        std::recursive_mutex mutex;
+
+        /**
+         * This is the stage the connection has reached.
+         */
+        State state = State::Idle;
+
+        /**
+         * This encodes the frames sent and decodes those received.
+         */
+        WebSocketFramer framer;
+
+        /**
+         * These are the settings with which the permessage-deflate
+         * extension is offered.
+         */
+        DeflateSettings deflateSettings;
+
+        /**
+         * If not null, this is where to count the work of
+         * compressing and decompressing messages.
+         */
+        std::shared_ptr<DeflateCounters> deflateCounters;
+
+        /**
+         * These are the parameters of the permessage-deflate extension
+         * which the server accepted, if it did.
+         */
+        bool deflateAccepted = false;
+        bool deflateServerTakeover = true;
+        int deflateWindowBits = 15;
+
+#if defined(MQTT_NETWORK_TRANSPORT_DEFLATE)
+        /**
+         * If the permessage-deflate extension is in use, this compresses
+         * the messages sent and decompresses those received.
+         */
+        std::shared_ptr<WebSocketDeflate> deflate;
+#endif /* MQTT_NETWORK_TRANSPORT_DEFLATE */
+
+        /**
+         * This is the port of the server, sent in the Host header
+         * of the upgrade request.
+         */
+        uint16_t peerPort = 0;
+
+        /**
+         * This is the Sec-WebSocket-Accept value the server
+         * must send back to accept the upgrade.
+         */
+        std::string expectedAccept;
+
+        /**
+         * This holds the response to the upgrade request,
+         * until the end of its headers is received.
+         */
+        std::string response;
+
+        /**
+         * This is the delegate to call once the connect attempt completes,
+         * while one is in progress.
+         */
+        ConnectDelegate connectDelegate;
+
+        /**
+         * These are the messages sent before the upgrade completed,
+         * which are framed and sent once it does.
+         */
+        std::vector<OutgoingMessage> earlySends;
+
+        /**
+         * This is the delegate to call whenever data is received.
+         * It is only set before processing starts, so it is
+         * read without locking afterwards.
+         */
+        MessageReceivedDelegate messageReceivedDelegate;
+
+        /**
+         * This is the delegate to call once the connection is broken.
+         */
+        BrokenDelegate brokenDelegate;
+
+        /**
+         * This indicates whether or not the user has
+         * started processing the connection.
+         */
+        bool processing = false;
+
+        /**
+         * This is the payload data received and not yet delivered.
+         */
+        std::deque<std::vector<uint8_t>> received;
+
+        /**
+         * This indicates whether or not a thread is delivering
+         * received data and breakage.
+         */
+        bool delivering = false;
+
+        /**
+         * This indicates whether or not the breakage of the
+         * connection has yet to be delivered.
+         */
+        bool brokenPending = false;
+
+        /**
+         * This indicates whether or not the connection was
+         * closed gracefully, once it is broken.
+         */
+        bool brokenGraceful = false;
+
+        /**
+         * This is the constructor for the structure.
+         */
+        Impl() :
+            diagnosticsSender(
+                std::make_shared<SystemUtils::DiagnosticsSender>("WebSocketNetworkConnection")) {}
+
+        /**
+         * This method completes the connect attempt in progress, if any.
+         * The caller must not hold the mutex.
+         *
+         * @param[in] connected
+         *      This indicates whether or not the connection
+         *      was established.
+         */
+        void CompleteConnect(bool connected) {
+            ConnectDelegate delegate;
+            {
+                std::lock_guard<decltype(mutex)> lock(mutex);
+                delegate.swap(connectDelegate);
+            }
+            if (delegate != nullptr)
+            { delegate(connected); }
+        }
+
+        /**
+         * This method is called once the inner connection is established,
+         * or fails to be, to start processing it and send the
+         * upgrade request.
+         *
+         * @param[in] connected
+         *      This indicates whether or not the inner connection
+         *      was established.
+         */
+        void OnConnected(bool connected) {
+            {
+                std::lock_guard<decltype(mutex)> lock(mutex);
+                if (state != State::Connecting)
+                { return; }
+                state = (connected ? State::Upgrading : State::Closed);
+            }
+            if (!connected)
+            {
+                CompleteConnect(false);
+                return;
+            }
+            std::weak_ptr<Impl> implWeak(shared_from_this());
+            if (!inner->Process(
+                    [implWeak](const std::vector<uint8_t>& message)
+                    {
+                        const auto impl = implWeak.lock();
+                        if (impl != nullptr)
+                        { impl->OnData(message); }
+                    },
+                    [implWeak](bool graceful)
+                    {
+                        const auto impl = implWeak.lock();
+                        if (impl != nullptr)
+                        { impl->OnInnerBroken(graceful); }
+                    }))
+            {
+                diagnosticsSender->SendDiagnosticInformationString(
+                    SystemUtils::DiagnosticsSender::Levels::ERROR,
+                    "unable to process inner connection");
+                {
+                    std::lock_guard<decltype(mutex)> lock(mutex);
+                    state = State::Closed;
+                }
+                inner->Close(false);
+                CompleteConnect(false);
+                return;
+            }
+            std::lock_guard<decltype(mutex)> lock(mutex);
+            if (state != State::Upgrading)
+            { return; }
+            std::random_device random;
+            std::vector<uint8_t> nonce(16);
+            for (auto& byte : nonce)
+            { byte = (uint8_t)random(); }
+            const auto key = Base64(nonce);
+            expectedAccept = Base64(Sha1(key + WEBSOCKET_GUID));
+            const bool ipv6Literal = (serverName.find(':') != std::string::npos);
+            std::string request = "GET " + path +
+                                  " HTTP/1.1\r\n"
+                                  "Host: " +
+                                  (ipv6Literal ? "[" + serverName + "]" : serverName) + ":" +
+                                  std::to_string(peerPort) +
+                                  "\r\n"
+                                  "Upgrade: websocket\r\n"
+                                  "Connection: Upgrade\r\n"
+                                  "Sec-WebSocket-Key: " +
+                                  key +
+                                  "\r\n"
+                                  "Sec-WebSocket-Version: 13\r\n"
+                                  "Sec-WebSocket-Protocol: mqtt\r\n";
+            if (OffersDeflate())
+            {
+                request += "Sec-WebSocket-Extensions: permessage-deflate; client_max_window_bits";
+                if (!deflateSettings.contextTakeover)
+                { request += "; client_no_context_takeover"; }
+                request += "\r\n";
+            }
+            request += "\r\n";
+            SendToInner(std::vector<uint8_t>(request.begin(), request.end()));
+        }
+
+        /**
+         * This method is called from the I/O thread of the inner
+         * connection whenever data is received.
+         *
+         * @param[in] message
+         *      This is the data received.
+         */
+        void OnData(const std::vector<uint8_t>& message) {
+            bool upgraded = false;
+            bool failed = false;
+            {
+                std::lock_guard<decltype(mutex)> lock(mutex);
+                if (state == State::Upgrading)
+                {
+                    response.append(message.begin(), message.end());
+                    const auto end = response.find("\r\n\r\n");
+                    if (end == std::string::npos)
+                    {
+                        if (response.size() <= MAXIMUM_RESPONSE_SIZE)
+                        { return; }
+                        diagnosticsSender->SendDiagnosticInformationString(
+                            SystemUtils::DiagnosticsSender::Levels::ERROR,
+                            "WebSocket upgrade failed (response too large)");
+                        failed = true;
+                    } else if (!CheckResponse(response.substr(0, end)))
+                    { failed = true; } else
+                    {
+                        upgraded = true;
+                        state = State::Established;
+                        diagnosticsSender->SendDiagnosticInformationString(
+                            1, "WebSocket upgrade complete");
+                        const auto rest = response.substr(end + 4);
+                        response.clear();
+                        response.shrink_to_fit();
+                        StartDeflate();
+                        std::vector<OutgoingMessage> messages;
+                        messages.swap(earlySends);
+                        if (!messages.empty())
+                        { SendFrames(messages); }
+                        TakeFrames((const uint8_t*)rest.data(), rest.size());
+                    }
+                    if (failed)
+                    {
+                        state = State::Closed;
+                        earlySends.clear();
+                        inner->Close(false);
+                    }
+                } else if ((state == State::Established) || (state == State::Closing))
+                { TakeFrames(message.data(), message.size()); } else
+                { return; }
+            }
+            if (upgraded || failed)
+            { CompleteConnect(upgraded); }
+            Deliver();
+        }
+
+        /**
+         * This method checks the headers of the response to the
+         * upgrade request, publishing why the upgrade failed, if
+         * they don't accept it.  The caller must hold the mutex.
+         *
+         * @param[in] headers
+         *      These are the status line and headers of the response,
+         *      without the empty line which ends them.
+         * @return
+         *      An indication of whether or not the server
+         *      accepted the upgrade is returned.
+         */
+        bool CheckResponse(const std::string& headers) {
+            std::string reason;
+            auto lineEnd = headers.find("\r\n");
+            const auto statusLine = headers.substr(0, lineEnd);
+            if (statusLine.compare(0, 13, "HTTP/1.1 101 ") != 0)
+            { reason = "unexpected status: " + statusLine; }
+            bool upgrade = false;
+            bool connection = false;
+            bool accepted = false;
+            while (reason.empty() && (lineEnd != std::string::npos))
+            {
+                const auto lineStart = lineEnd + 2;
+                lineEnd = headers.find("\r\n", lineStart);
+                const auto line = headers.substr(lineStart, lineEnd - lineStart);
+                const auto colon = line.find(':');
+                if (colon == std::string::npos)
+                { continue; }
+                const auto name = Normalize(line.substr(0, colon));
+                const auto value = line.substr(colon + 1);
+                if (name == "upgrade")
+                { upgrade = (Normalize(value) == "websocket"); } else if (name == "connection")
+                { connection = (Normalize(value).find("upgrade") != std::string::npos); } else if (
+                    name == "sec-websocket-accept")
+                { accepted = (Normalize(value) == Normalize(expectedAccept)); } else if (
+                    (name == "sec-websocket-protocol") && (Normalize(value) != "mqtt"))
+                { reason = "unexpected subprotocol: " + value; } else if (
+                    name == "sec-websocket-extensions")
+                { reason = CheckExtensions(value); }
+            }
+            if (reason.empty())
+            {
+                if (!upgrade || !connection)
+                { reason = "missing upgrade headers"; } else if (!accepted)
+                { reason = "wrong Sec-WebSocket-Accept"; }
+            }
+            if (reason.empty())
+            { return true; }
+            diagnosticsSender->SendDiagnosticInformationFormatted(
+                SystemUtils::DiagnosticsSender::Levels::ERROR, "WebSocket upgrade failed (%s)",
+                reason.c_str());
+            return false;
+        }
+
+        /**
+         * This method returns whether or not the permessage-deflate
+         * extension is offered to the server.
+         *
+         * @return
+         *      An indication of whether or not the extension
+         *      is offered is returned.
+         */
+        bool OffersDeflate() const {
+#if defined(MQTT_NETWORK_TRANSPORT_DEFLATE)
+            return deflateSettings.enable;
+#else
+            return false;
+#endif /* MQTT_NETWORK_TRANSPORT_DEFLATE */
+        }
+
+        /**
+         * This method checks the extensions the server accepted,
+         * noting the parameters of the permessage-deflate extension.
+         * The caller must hold the mutex.
+         *
+         * @param[in] value
+         *      This is the value of a Sec-WebSocket-Extensions header
+         *      of the response to the upgrade request.
+         * @return
+         *      A description of what is wrong with the extensions is
+         *      returned, or an empty string if they are acceptable.
+         */
+        std::string CheckExtensions(const std::string& value) {
+            for (const auto& extension : Split(value, ','))
+            {
+                const auto parameters = Split(extension, ';');
+                if ((Normalize(parameters[0]) != "permessage-deflate") || !OffersDeflate() ||
+                    deflateAccepted)
+                { return "unexpected extension: " + extension; }
+                deflateAccepted = true;
+                deflateWindowBits = deflateSettings.windowBits;
+                for (size_t i = 1; i < parameters.size(); ++i)
+                {
+                    const auto equals = parameters[i].find('=');
+                    const auto name = Normalize(parameters[i].substr(0, equals));
+                    if (name == "server_no_context_takeover")
+                    { deflateServerTakeover = false; } else if (name == "client_no_context_takeover")
+                    { deflateSettings.contextTakeover = false; } else if (name ==
+                                                                          "client_max_window_bits")
+                    {
+                        if (equals != std::string::npos)
+                        {
+                            const auto bits = atoi(Normalize(parameters[i].substr(equals + 1))
+                                                       .c_str());
+                            if ((bits < 8) || (bits > 15))
+                            { return "unexpected parameter: " + parameters[i]; }
+                            if (bits < 9)
+                            { return "unsupported parameter: " + parameters[i]; }
+                            deflateWindowBits = std::min(deflateWindowBits, bits);
+                        }
+                    } else if (name != "server_max_window_bits")
+                    { return "unexpected parameter: " + parameters[i]; }
+                }
+            }
+            return "";
+        }
+
+        /**
+         * This method sets up compression, if the server accepted the
+         * permessage-deflate extension.  The caller must hold the mutex.
+         */
+        void StartDeflate() {
+#if defined(MQTT_NETWORK_TRANSPORT_DEFLATE)
+            if (!deflateAccepted)
+            { return; }
+            deflate = std::make_shared<WebSocketDeflate>(
+                deflateSettings.level, deflateWindowBits, deflateSettings.contextTakeover,
+                deflateServerTakeover, deflateSettings.maximumMessageSize);
+            if (!deflate->IsReady())
+            {
+                diagnosticsSender->SendDiagnosticInformationString(
+                    SystemUtils::DiagnosticsSender::Levels::ERROR,
+                    "unable to set up WebSocket compression");
+                Break(false);
+                inner->Close(false);
+                return;
+            }
+            diagnosticsSender->SendDiagnosticInformationString(
+                1, "WebSocket permessage-deflate in use");
+            const auto deflateShared = deflate;
+            const auto counters = deflateCounters;
+            framer.SetInflateDelegate(
+                [deflateShared, counters](const uint8_t* data, size_t size, bool final,
+                                          std::vector<uint8_t>& payload)
+                {
+                    const auto start = std::chrono::steady_clock::now();
+                    const auto before = payload.size();
+                    const bool wellFormed = deflateShared->Decompress(data, size, final, payload);
+                    if (counters != nullptr)
+                    {
+                        counters->compressedBytesReceived += size;
+                        counters->uncompressedBytesReceived += (payload.size() - before);
+                        counters->nanoseconds +=
+                            (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                std::chrono::steady_clock::now() - start)
+                                .count();
+                    }
+                    return wellFormed;
+                });
+#endif /* MQTT_NETWORK_TRANSPORT_DEFLATE */
+        }
+
+        /**
+         * This method appends to the given buffer a binary frame carrying
+         * the given message, compressed if the permessage-deflate
+         * extension is in use.  The caller must hold the mutex.
+         *
+         * @param[in] data
+         *      This points to the message.
+         * @param[in] size
+         *      This is the number of bytes of the message.
+         * @param[in,out] frames
+         *      This is where to append the frame.
+         */
+        void EncodeMessage(const uint8_t* data, size_t size, std::vector<uint8_t>& frames) {
+#if defined(MQTT_NETWORK_TRANSPORT_DEFLATE)
+            if ((deflate != nullptr) && (size >= MINIMUM_COMPRESSED_SIZE))
+            {
+                const auto start = std::chrono::steady_clock::now();
+                std::vector<uint8_t> compressed;
+                if (deflate->Compress(data, size, compressed))
+                {
+                    if (deflateCounters != nullptr)
+                    {
+                        deflateCounters->uncompressedBytesSent += size;
+                        deflateCounters->compressedBytesSent += compressed.size();
+                        deflateCounters->nanoseconds +=
+                            (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                std::chrono::steady_clock::now() - start)
+                                .count();
+                    }
+                    framer.Encode(WebSocketFramer::OPCODE_BINARY, compressed.data(),
+                                  compressed.size(), frames, true);
+                    return;
+                }
+                diagnosticsSender->SendDiagnosticInformationString(
+                    SystemUtils::DiagnosticsSender::Levels::WARNING,
+                    "unable to compress message; sending it uncompressed");
+            }
+#endif /* MQTT_NETWORK_TRANSPORT_DEFLATE */
+            framer.Encode(WebSocketFramer::OPCODE_BINARY, data, size, frames);
+        }
+
+        /**
+         * This method decodes the given frame data, queuing the payload
+         * data in it for delivery and handling its control frames.
+         * The caller must hold the mutex.
+         *
+         * @param[in] data
+         *      This points to the frame data received.
+         * @param[in] size
+         *      This is the number of bytes received.
+         */
+        void TakeFrames(const uint8_t* data, size_t size) {
+            if (size == 0)
+            { return; }
+            std::vector<uint8_t> payload;
+            std::vector<WebSocketFramer::ControlFrame> controlFrames;
+            if (!framer.Decode(data, size, payload, controlFrames))
+            {
+                diagnosticsSender->SendDiagnosticInformationString(
+                    SystemUtils::DiagnosticsSender::Levels::ERROR,
+                    "malformed WebSocket frame received");
+                Break(false);
+                inner->Close(false);
+                return;
+            }
+            if (!payload.empty())
+            { received.push_back(std::move(payload)); }
+            for (const auto& frame : controlFrames)
+            {
+                if (frame.opcode == WebSocketFramer::OPCODE_PING)
+                {
+                    if (state == State::Established)
+                    { SendControlFrame(WebSocketFramer::OPCODE_PONG, frame.payload); }
+                } else if (frame.opcode == WebSocketFramer::OPCODE_CLOSE)
+                {
+                    diagnosticsSender->SendDiagnosticInformationString(
+                        1, "WebSocket closed by peer");
+                    if (state == State::Established)
+                    {
+                        std::vector<uint8_t> status(frame.payload.begin(),
+                                                    frame.payload.begin() +
+                                                        std::min<size_t>(2, frame.payload.size()));
+                        SendControlFrame(WebSocketFramer::OPCODE_CLOSE, status);
+                    }
+                    Break(true);
+                    inner->Close(true);
+                    return;
+                }
+            }
+        }
+
+        /**
+         * This method sends a control frame with the given opcode and
+         * payload.  The caller must hold the mutex.
+         *
+         * @param[in] opcode
+         *      This is the opcode of the frame.
+         * @param[in] payload
+         *      This is the payload of the frame.
+         */
+        void SendControlFrame(uint8_t opcode, const std::vector<uint8_t>& payload) {
+            std::vector<uint8_t> frame;
+            framer.Encode(opcode, payload.data(), payload.size(), frame);
+            SendToInner(std::move(frame));
+        }
+
+        /**
+         * This method frames the given messages, each in a binary frame
+         * of its own, and sends the frames together in a single message.
+         * The caller must hold the mutex, which keeps the frames
+         * in order.
+         *
+         * @param[in] messages
+         *      These are the messages to send.
+         */
+        void SendFrames(const std::vector<OutgoingMessage>& messages) {
+            size_t size = 0;
+            for (const auto& message : messages)
+            { size += message.Bytes().size() + 14; }
+            std::vector<uint8_t> frames;
+            frames.reserve(size);
+            for (const auto& message : messages)
+            {
+                const auto& bytes = message.Bytes();
+                EncodeMessage(bytes.data(), bytes.size(), frames);
+            }
+            SendToInner(std::move(frames));
+        }
+
+        /**
+         * This method passes the given data to the inner connection
+         * to send.  The caller must hold the mutex.
+         *
+         * @param[in] data
+         *      This is the data to send.
+         */
+        void SendToInner(std::vector<uint8_t>&& data) {
+            if (innerGather != nullptr)
+            { innerGather->SendMessage(OutgoingMessage(std::move(data))); } else
+            { inner->SendMessage(data); }
+        }
+
+        /**
+         * This method is called once the inner connection is broken.
+         *
+         * @param[in] graceful
+         *      This indicates whether or not the inner connection
+         *      was closed gracefully.
+         */
+        void OnInnerBroken(bool graceful) {
+            bool abandoned = false;
+            {
+                std::lock_guard<decltype(mutex)> lock(mutex);
+                if ((state == State::Connecting) || (state == State::Upgrading))
+                {
+                    abandoned = true;
+                    earlySends.clear();
+                } else
+                { Break(graceful); }
+                state = State::Closed;
+            }
+            if (abandoned)
+            {
+                diagnosticsSender->SendDiagnosticInformationString(
+                    SystemUtils::DiagnosticsSender::Levels::WARNING,
+                    "connection broken during WebSocket upgrade");
+                CompleteConnect(false);
+            } else
+            { Deliver(); }
+        }
+
+        /**
+         * This method marks the connection as broken, arranging for its
+         * breakage to be delivered after any data received before it.
+         * The caller must hold the mutex.
+         *
+         * @param[in] graceful
+         *      This indicates whether or not the connection
+         *      was closed gracefully.
+         */
+        void Break(bool graceful) {
+            if ((state != State::Established) && (state != State::Closing))
+            { return; }
+            state = State::Closed;
+            brokenPending = true;
+            brokenGraceful = graceful;
+        }
+
+        /**
+         * This method delivers received data, and then the breakage of
+         * the connection, if it is broken, once processing has started.
+         * Only one thread delivers at a time, so that data is delivered
+         * in order.  The caller must not hold the mutex.
+         */
+        void Deliver() {
+            std::unique_lock<decltype(mutex)> lock(mutex);
+            if (delivering || !processing)
+            { return; }
+            delivering = true;
+            for (;;)
+            {
+                if (!received.empty())
+                {
+                    const auto message = std::move(received.front());
+                    received.pop_front();
+                    lock.unlock();
+                    if (messageReceivedDelegate != nullptr)
+                    { messageReceivedDelegate(message); }
+                    lock.lock();
+                    continue;
+                }
+                if (brokenPending)
+                {
+                    brokenPending = false;
+                    BrokenDelegate delegate;
+                    delegate.swap(brokenDelegate);
+                    const bool graceful = brokenGraceful;
+                    lock.unlock();
+                    if (delegate != nullptr)
+                    { delegate(graceful); }
+                    lock.lock();
+                    continue;
+                }
+                break;
+            }
+            delivering = false;
+        }
+
+        /**
+         * This method frames and sends the given messages, or holds them
+         * until the upgrade completes.  The caller must hold the mutex.
+         *
+         * @param[in] messages
+         *      These are the messages to send.
+         */
+        void Send(std::vector<OutgoingMessage>&& messages) {
+            if (state == State::Established)
+            { SendFrames(messages); } else if ((state == State::Connecting) ||
+                                               (state == State::Upgrading))
+            {
+                for (auto& message : messages)
+                { earlySends.push_back(std::move(message)); }
+            }
+        }
+    };
+
+    WebSocketNetworkConnection::~WebSocketNetworkConnection() noexcept { Close(false); }
+
+    WebSocketNetworkConnection::WebSocketNetworkConnection(
+        std::shared_ptr<SystemUtils::INetworkConnection> inner, const std::string& serverName,
+        const std::string& path, std::shared_ptr<WorkerPool> connectWorkers,
+        const DeflateSettings& deflateSettings, std::shared_ptr<DeflateCounters> deflateCounters) :
+        impl_(std::make_shared<Impl>()) {
+        impl_->inner = inner;
+        impl_->innerGather = std::dynamic_pointer_cast<GatherNetworkConnection>(inner);
+        impl_->innerAsync = std::dynamic_pointer_cast<AsyncNetworkConnection>(inner);
+        impl_->innerFastOpen = std::dynamic_pointer_cast<FastOpenConnection>(inner);
+        impl_->serverName = serverName;
+        impl_->path = (path.empty() ? std::string("/") : path);
+        impl_->connectWorkers = connectWorkers;
+        impl_->deflateSettings = deflateSettings;
+        impl_->deflateCounters = deflateCounters;
+        const auto diagnosticsSender = impl_->diagnosticsSender;
+        (void)inner->SubscribeToDiagnostics(
+            [diagnosticsSender](std::string, size_t level, std::string message)
+            { diagnosticsSender->SendDiagnosticInformationString(level, message); });
+    }
+
+    SystemUtils::DiagnosticsSender::UnsubscribeDelegate
+    WebSocketNetworkConnection::SubscribeToDiagnostics(
+        SystemUtils::DiagnosticsSender::DiagnosticMessageDelegate delegate, size_t minLevel) {
+        return impl_->diagnosticsSender->SubscribeToDiagnostics(delegate, minLevel);
+    }
+
+    bool WebSocketNetworkConnection::Connect(uint32_t peerAddress, uint16_t peerPort) {
+        const auto result = std::make_shared<std::promise<bool>>();
+        auto connected = result->get_future();
+        ConnectAsync(peerAddress, peerPort,
+                     [result](bool succeeded) { result->set_value(succeeded); });
+        return connected.get();
+    }
+
+    bool WebSocketNetworkConnection::Process(MessageReceivedDelegate messageReceivedDelegate,
+                                             BrokenDelegate brokenDelegate) {
+        {
+            std::lock_guard<decltype(impl_->mutex)> lock(impl_->mutex);
+            if ((impl_->state != Impl::State::Established) || impl_->processing)
+            { return false; }
+            impl_->messageReceivedDelegate = messageReceivedDelegate;
+            impl_->brokenDelegate = brokenDelegate;
+            impl_->processing = true;
+        }
+        impl_->Deliver();
+        return true;
+    }
+
+    uint32_t WebSocketNetworkConnection::GetPeerAddress() const {
+        return impl_->inner->GetPeerAddress();
+    }
+
+    uint16_t WebSocketNetworkConnection::GetPeerPort() const { return impl_->inner->GetPeerPort(); }
+
+    bool WebSocketNetworkConnection::IsConnected() const {
+        std::lock_guard<decltype(impl_->mutex)> lock(impl_->mutex);
+        return ((impl_->state == Impl::State::Established) && impl_->inner->IsConnected());
+    }
+
+    uint32_t WebSocketNetworkConnection::GetBoundAddress() const {
+        return impl_->inner->GetBoundAddress();
+    }
+
+    uint16_t WebSocketNetworkConnection::GetBoundPort() const {
+        return impl_->inner->GetBoundPort();
+    }
+
+    void WebSocketNetworkConnection::SendMessage(const std::vector<uint8_t>& message) {
+        std::lock_guard<decltype(impl_->mutex)> lock(impl_->mutex);
+        if (impl_->state == Impl::State::Established)
+        {
+            std::vector<uint8_t> frame;
+            impl_->EncodeMessage(message.data(), message.size(), frame);
+            impl_->SendToInner(std::move(frame));
+        } else
+        {
+            std::vector<OutgoingMessage> messages;
+            messages.emplace_back(std::vector<uint8_t>(message));
+            impl_->Send(std::move(messages));
+        }
+    }
+
+    void WebSocketNetworkConnection::SendMessage(OutgoingMessage&& message) {
+        std::vector<OutgoingMessage> messages;
+        messages.push_back(std::move(message));
+        SendMessages(std::move(messages));
+    }
+
+    void WebSocketNetworkConnection::SendMessages(std::vector<OutgoingMessage>&& messages) {
+        std::lock_guard<decltype(impl_->mutex)> lock(impl_->mutex);
+        impl_->Send(std::move(messages));
+    }
+
+    void WebSocketNetworkConnection::ConnectAsync(uint32_t peerAddress, uint16_t peerPort,
+                                                  ConnectDelegate connectDelegate) {
+        {
+            std::unique_lock<decltype(impl_->mutex)> lock(impl_->mutex);
+            if (impl_->state != Impl::State::Idle)
+            {
+                lock.unlock();
+                connectDelegate(false);
+                return;
+            }
+            impl_->state = Impl::State::Connecting;
+            impl_->peerPort = peerPort;
+            impl_->connectDelegate = std::move(connectDelegate);
+        }
+        std::weak_ptr<Impl> implWeak(impl_);
+        const auto onConnected = [implWeak](bool connected)
+        {
+            const auto impl = implWeak.lock();
+            if (impl != nullptr)
+            { impl->OnConnected(connected); }
+        };
+        if (impl_->innerAsync != nullptr)
+        {
+            impl_->innerAsync->ConnectAsync(peerAddress, peerPort, onConnected);
+            return;
+        }
+        const auto inner = impl_->inner;
+        impl_->connectWorkers->Post([inner, peerAddress, peerPort, onConnected]
+                                    { onConnected(inner->Connect(peerAddress, peerPort)); });
+    }
+
+    void WebSocketNetworkConnection::Close(bool clean) {
+        bool abandoned = false;
+        {
+            std::lock_guard<decltype(impl_->mutex)> lock(impl_->mutex);
+            switch (impl_->state)
+            {
+                case Impl::State::Idle:
+                case Impl::State::Closing:
+                case Impl::State::Closed:
+                    return;
+
+                case Impl::State::Connecting:
+                case Impl::State::Upgrading:
+                    abandoned = true;
+                    impl_->earlySends.clear();
+                    break;
+
+                case Impl::State::Established:
+                    if (clean)
+                    {
+                        const uint8_t status[] = {(uint8_t)(CLOSE_NORMAL >> 8),
+                                                  (uint8_t)CLOSE_NORMAL};
+                        impl_->SendControlFrame(WebSocketFramer::OPCODE_CLOSE,
+                                                std::vector<uint8_t>(status, status + 2));
+                    }
+                    break;
+            }
+            impl_->state = (abandoned ? Impl::State::Closed : Impl::State::Closing);
+            impl_->inner->Close(clean && !abandoned);
+        }
+        if (abandoned)
+        { impl_->CompleteConnect(false); }
+    }
+
+    void WebSocketNetworkConnection::EnableFastOpen() {
+        if (impl_->innerFastOpen != nullptr)
+        { impl_->innerFastOpen->EnableFastOpen(); }
+    }
+
+    bool WebSocketNetworkConnection::UsedFastOpen() {
+        return ((impl_->innerFastOpen != nullptr) && impl_->innerFastOpen->UsedFastOpen());
+    }
+
+    std::shared_ptr<SystemUtils::INetworkConnection> WebSocketNetworkConnection::GetInnerConnection() const {
+        return impl_->inner;
+    }
+}  // namespace MqttNetworkTransport
@@ -0,0 +1,192 @@
+#ifndef MQTT_NETWORK_TRANSPORT_WEB_SOCKET_NETWORK_CONNECTION_HPP
+#define MQTT_NETWORK_TRANSPORT_WEB_SOCKET_NETWORK_CONNECTION_HPP
+/**
+ * @file WebSocketNetworkConnection.hpp
+ *
+ * This module declares the MqttNetworkTransport::WebSocketNetworkConnection
+ * class.
+ *
+ * © 2025 by Hatem Nabli
+ */
+
+#include "AsyncNetworkConnection.hpp"
+#include "FastOpenConnection.hpp"
+#include "LayeredConnection.hpp"
+#include "WorkerPool.hpp"
+#include <atomic>
+#include <memory>
+#include <string>
+#include <stddef.h>
+
+namespace MqttNetworkTransport
+{
+    /**
+     * This is an implementation of SystemUtils::INetworkConnection which
+     * carries messages in WebSocket binary frames (RFC 6455) over another
+     * network connection, after upgrading it from HTTP.  The messages
+     * sent each go in a frame of their own, and the payloads of the
+     * frames received are delivered as a stream, as they arrive.
+     */
+    class WebSocketNetworkConnection : public AsyncNetworkConnection,
+                                       public FastOpenConnection,
+                                       public LayeredConnection
+    {
+    public:
+        /**
+         * This holds the settings with which the permessage-deflate
+         * extension (RFC 7692) is offered to the server.
+         */
+        struct DeflateSettings
+        {
+            /**
+             * This indicates whether or not the extension is offered.
+             */
+            bool enable = false;
+
+            /**
+             * This is the zlib compression level (1 to 9) of
+             * the messages sent.
+             */
+            int level = 6;
+
+            /**
+             * This is the base-two logarithm of the size of the window
+             * used to compress the messages sent (9 to 15).
+             */
+            int windowBits = 15;
+
+            /**
+             * This indicates whether or not the messages sent are
+             * compressed using the messages sent before them, which
+             * compresses better, but keeps the window allocated for
+             * as long as the connection.
+             */
+            bool contextTakeover = true;
+
+            /**
+             * This is the most bytes to which the payload of a message
+             * received may decompress.  A message decompressing to more
+             * is treated as malformed.
+             */
+            size_t maximumMessageSize = 1048576;
+        };
+
+        /**
+         * This holds counters to which connections add, as they
+         * compress and decompress messages.
+         */
+        struct DeflateCounters
+        {
+            /**
+             * These are the numbers of payload bytes of messages sent
+             * compressed, before and after compression.
+             */
+            std::atomic<uint64_t> uncompressedBytesSent{0};
+            std::atomic<uint64_t> compressedBytesSent{0};
+
+            /**
+             * These are the numbers of payload bytes of messages received
+             * compressed, before and after decompression.
+             */
+            std::atomic<uint64_t> compressedBytesReceived{0};
+            std::atomic<uint64_t> uncompressedBytesReceived{0};
+
+            /**
+             * This is the time spent compressing and decompressing,
+             * in nanoseconds.
+             */
+            std::atomic<uint64_t> nanoseconds{0};
+        };
+
+        // Lifecycle management
+    public:
+        ~WebSocketNetworkConnection() noexcept;
+        WebSocketNetworkConnection(const WebSocketNetworkConnection&) = delete;
+        WebSocketNetworkConnection(WebSocketNetworkConnection&&) noexcept = delete;
+        WebSocketNetworkConnection& operator=(const WebSocketNetworkConnection&) = delete;
+        WebSocketNetworkConnection& operator=(WebSocketNetworkConnection&&) noexcept = delete;
+
+        // Public methods
+    public:
+        /**
+         * This is the constructor.
+         *
+         * @param[in] inner
+         *      This is the connection which carries the frames.
+         * @param[in] serverName
+         *      This is the name or IPv4 literal of the server, which is
+         *      sent in the Host header of the upgrade request.
+         * @param[in] path
+         *      This is the path of the resource requested for the upgrade.
+         * @param[in] connectWorkers
+         *      This is the pool of workers which establish the inner
+         *      connection, if it can only connect by blocking.
+         * @param[in] deflateSettings
+         *      These are the settings with which the permessage-deflate
+         *      extension is offered.  It is only offered if the library
+         *      is built with zlib.
+         * @param[in] deflateCounters
+         *      If not null, this is where to count the work of
+         *      compressing and decompressing messages.
+         */
+        WebSocketNetworkConnection(std::shared_ptr<SystemUtils::INetworkConnection> inner,
+                                   const std::string& serverName, const std::string& path,
+                                   std::shared_ptr<WorkerPool> connectWorkers,
+                                   const DeflateSettings& deflateSettings,
+                                   std::shared_ptr<DeflateCounters> deflateCounters);
+
+        // SystemUtils::INetworkConnection
+    public:
+        virtual SystemUtils::DiagnosticsSender::UnsubscribeDelegate SubscribeToDiagnostics(
+            SystemUtils::DiagnosticsSender::DiagnosticMessageDelegate delegate,
+            size_t minLevel = 0) override;
+        virtual bool Connect(uint32_t peerAddress, uint16_t peerPort) override;
+        virtual bool Process(MessageReceivedDelegate messageReceivedDelegate,
+                             BrokenDelegate brokenDelegate) override;
+        virtual uint32_t GetPeerAddress() const override;
+        virtual uint16_t GetPeerPort() const override;
+        virtual bool IsConnected() const override;
+        virtual uint32_t GetBoundAddress() const override;
+        virtual uint16_t GetBoundPort() const override;
+        virtual void SendMessage(const std::vector<uint8_t>& message) override;
+        virtual void Close(bool clean = false) override;
+
+        // GatherNetworkConnection
+    public:
+        virtual void SendMessage(OutgoingMessage&& message) override;
+        virtual void SendMessages(std::vector<OutgoingMessage>&& messages) override;
+
+        // AsyncNetworkConnection
+    public:
+        virtual void ConnectAsync(uint32_t peerAddress, uint16_t peerPort,
+                                  ConnectDelegate connectDelegate) override;
+
+        // FastOpenConnection
+    public:
+        virtual void EnableFastOpen() override;
+        virtual bool UsedFastOpen() override;
+
+        // LayeredConnection
+    public:
+        virtual std::shared_ptr<SystemUtils::INetworkConnection> GetInnerConnection()
+            const override;
+
+        // Private properties
+    private:
+        /**
+         * This is the type of structure that contains the private
+         * properties of the instance.  It is defined in the implementation
+         * and declared here to ensure that it is scoped inside the class.
+         */
+        struct Impl;
+
+        /**
+         * This contains the private properties of the instance.  It is
+         * shared with the inner connection, which may still be using it
+         * while the connection is destroyed.
+         */
+        std::shared_ptr<Impl> impl_;
+    };
+}  // namespace MqttNetworkTransport
+
+#endif /** MQTT_NETWORK_TRANSPORT_WEB_SOCKET_NETWORK_CONNECTION_HPP */
@@ -0,0 +1,99 @@
+/**
+ * @file WorkerPool.cpp
+ *
+ * This module implements the MqttNetworkTransport::WorkerPool class.
+ *
+ * © 2025 by Hatem Nabli
+ */
+
+#include "WorkerPool.hpp"
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace MqttNetworkTransport
+{
+    struct WorkerPool::Impl
+    {
+        /**
+         * This is used to synchronize access to the task queue.
+         */
+        std::mutex mutex;
+
+        /**
+         * This is used to wake the workers when there are
+         * tasks to run or the pool is stopping.
+         */
+        std::condition_variable wakeCondition;
+
+        /**
+         * These are the tasks waiting for a worker.
+         */
+        std::deque<Task> tasks;
+
+        /**
+         * This flag indicates whether or not the workers should stop.
+         */
+        bool stop = false;
+
+        /**
+         * These are the threads which run the tasks.
+         */
+        std::vector<std::thread> workers;
+
+        /**
+         * This is the body of each worker thread.
+         */
+        void Run() {
+            std::unique_lock<decltype(mutex)> lock(mutex);
+            while (!stop)
+            {
+                if (tasks.empty())
+                {
+                    wakeCondition.wait(lock);
+                    continue;
+                }
+                {
+                    const auto task = std::move(tasks.front());
+                    tasks.pop_front();
+                    lock.unlock();
+                    task();
+                }
+                lock.lock();
+            }
+        }
+    };
+
+    WorkerPool::~WorkerPool() noexcept {
+        std::deque<Task> discarded;
+        {
+            std::lock_guard<decltype(impl_->mutex)> lock(impl_->mutex);
+            impl_->stop = true;
+            discarded.swap(impl_->tasks);
+            impl_->wakeCondition.notify_all();
+        }
+        discarded.clear();
+        for (auto& worker : impl_->workers)
+        {
+            if (worker.get_id() == std::this_thread::get_id())
+            { worker.detach(); } else
+            { worker.join(); }
+        }
+    }
+
+    WorkerPool::WorkerPool(size_t workerCount) : impl_(std::make_shared<Impl>()) {
+        const auto impl = impl_;
+        for (size_t i = 0; i < workerCount; ++i)
+        { impl_->workers.emplace_back([impl] { impl->Run(); }); }
+    }
+
+    void WorkerPool::Post(Task task) {
+        std::lock_guard<decltype(impl_->mutex)> lock(impl_->mutex);
+        if (impl_->stop)
+        { return; }
+        impl_->tasks.push_back(std::move(task));
+        impl_->wakeCondition.notify_one();
+    }
+}  // namespace MqttNetworkTransport
@@ -0,0 +1,79 @@
+#ifndef MQTT_NETWORK_TRANSPORT_WORKER_POOL_HPP
+#define MQTT_NETWORK_TRANSPORT_WORKER_POOL_HPP
+/**
+ * @file WorkerPool.hpp
+ *
+ * This module declares the MqttNetworkTransport::WorkerPool class.
+ *
+ * © 2025 by Hatem Nabli
+ */
+
+#include <functional>
+#include <memory>
+#include <stddef.h>
+
+namespace MqttNetworkTransport
+{
+    /**
+     * This runs tasks which may block on a fixed number of threads,
+     * so that the number of threads stays bounded however many
+     * tasks are started.
+     */
+    class WorkerPool
+    {
+    public:
+        /**
+         * This is the type of function run by the pool.
+         */
+        typedef std::function<void()> Task;
+
+        // Lifecycle management
+    public:
+        /**
+         * This is the destructor.  Tasks not yet started
+         * are discarded without being run.
+         */
+        ~WorkerPool() noexcept;
+        WorkerPool(const WorkerPool&) = delete;
+        WorkerPool(WorkerPool&&) noexcept = delete;
+        WorkerPool& operator=(const WorkerPool&) = delete;
+        WorkerPool& operator=(WorkerPool&&) noexcept = delete;
+
+        // Public methods
+    public:
+        /**
+         * This is the constructor.
+         *
+         * @param[in] workerCount
+         *      This is the number of threads running tasks.
+         */
+        explicit WorkerPool(size_t workerCount);
+
+        /**
+         * This method queues the given task to be run
+         * by the next available worker.
+         *
+         * @param[in] task
+         *      This is the task to run.
+         */
+        void Post(Task task);
+
+        // Private properties
+    private:
+        /**
+         * This is the type of structure that contains the private
+         * properties of the instance.  It is defined in the implementation
+         * and declared here to ensure that it is scoped inside the class.
+         */
+        struct Impl;
+
+        /**
+         * This contains the private properties of the instance.  It is
+         * shared with the worker threads, one of which may be the thread
+         * destroying the pool.
+         */
+        std::shared_ptr<Impl> impl_;
+    };
+}  // namespace MqttNetworkTransport
+
+#endif /** MQTT_NETWORK_TRANSPORT_WORKER_POOL_HPP */
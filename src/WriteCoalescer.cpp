@@ -0,0 +1,133 @@
+/**
+ * @file WriteCoalescer.cpp
+ *
+ * This module implements the MqttNetworkTransport::WriteCoalescer class.
+ *
+ * © 2025 by Hatem Nabli
+ */
+
+#include "WriteCoalescer.hpp"
+#include <mutex>
+
+namespace MqttNetworkTransport
+{
+    struct WriteCoalescer::Impl
+    {
+        /**
+         * This is used to flush pending packets once the window has elapsed.
+         */
+        std::shared_ptr<TimerQueue> timerQueue;
+
+        /**
+         * This is the longest time a packet may wait for others.
+         */
+        std::chrono::microseconds window;
+
+        /**
+         * This is the number of pending bytes at which the packets
+         * are flushed without waiting.
+         */
+        size_t thresholdBytes = 0;
+
+        /**
+         * This is the function to call to write a batch of packets.
+         */
+        FlushDelegate flushDelegate;
+
+        /**
+         * This is used to synchronize access to the pending packets,
+         * and to keep batches in order.
+         */
+        mutable std::mutex mutex;
+
+        /**
+         * These are the packets waiting to be written.
+         */
+        std::vector<OutgoingMessage> pending;
+
+        /**
+         * This is the number of bytes waiting to be written.
+         */
+        size_t pendingBytes = 0;
+
+        /**
+         * This identifies the flush timer, or is zero if none is scheduled.
+         */
+        TimerQueue::Token flushTimer = 0;
+
+        /**
+         * These are the numbers of packets and writes so far.
+         */
+        Statistics statistics;
+
+        /**
+         * This method writes the pending packets, if any.
+         * The caller must hold the mutex.
+         */
+        void FlushPending() {
+            if (flushTimer != 0)
+            {
+                timerQueue->Cancel(flushTimer);
+                flushTimer = 0;
+            }
+            if (pending.empty())
+            { return; }
+            std::vector<OutgoingMessage> batch;
+            batch.swap(pending);
+            pendingBytes = 0;
+            ++statistics.writes;
+            flushDelegate(std::move(batch));
+        }
+    };
+
+    WriteCoalescer::~WriteCoalescer() noexcept {
+        std::lock_guard<decltype(impl_->mutex)> lock(impl_->mutex);
+        impl_->FlushPending();
+    }
+
+    WriteCoalescer::WriteCoalescer(std::shared_ptr<TimerQueue> timerQueue,
+                                   std::chrono::microseconds window, size_t thresholdBytes,
+                                   FlushDelegate flushDelegate) :
+        impl_(std::make_shared<Impl>()) {
+        impl_->timerQueue = timerQueue;
+        impl_->window = window;
+        impl_->thresholdBytes = thresholdBytes;
+        impl_->flushDelegate = flushDelegate;
+    }
+
+    void WriteCoalescer::Submit(OutgoingMessage&& packet, bool urgent) {
+        std::lock_guard<decltype(impl_->mutex)> lock(impl_->mutex);
+        ++impl_->statistics.packets;
+        impl_->pendingBytes += packet.Bytes().size();
+        impl_->pending.push_back(std::move(packet));
+        if (urgent || (impl_->pendingBytes >= impl_->thresholdBytes))
+        {
+            impl_->FlushPending();
+            return;
+        }
+        if (impl_->flushTimer != 0)
+        { return; }
+        std::weak_ptr<Impl> implWeak(impl_);
+        impl_->flushTimer = impl_->timerQueue->Schedule(
+            std::chrono::steady_clock::now() + impl_->window,
+            [implWeak]
+            {
+                const auto impl = implWeak.lock();
+                if (impl == nullptr)
+                { return; }
+                std::lock_guard<decltype(impl->mutex)> lock(impl->mutex);
+                impl->flushTimer = 0;
+                impl->FlushPending();
+            });
+    }
+
+    void WriteCoalescer::Flush() {
+        std::lock_guard<decltype(impl_->mutex)> lock(impl_->mutex);
+        impl_->FlushPending();
+    }
+
+    auto WriteCoalescer::GetStatistics() const -> Statistics {
+        std::lock_guard<decltype(impl_->mutex)> lock(impl_->mutex);
+        return impl_->statistics;
+    }
+}  // namespace MqttNetworkTransport
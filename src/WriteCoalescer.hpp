@@ -0,0 +1,126 @@
+#ifndef MQTT_NETWORK_TRANSPORT_WRITE_COALESCER_HPP
+#define MQTT_NETWORK_TRANSPORT_WRITE_COALESCER_HPP
+/**
+ * @file WriteCoalescer.hpp
+ *
+ * This module declares the MqttNetworkTransport::WriteCoalescer class.
+ *
+ * © 2025 by Hatem Nabli
+ */
+
+#include "OutgoingMessage.hpp"
+#include "TimerQueue.hpp"
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <vector>
+#include <stddef.h>
+#include <stdint.h>
+
+namespace MqttNetworkTransport
+{
+    /**
+     * This gathers the outgoing packets of one connection which are
+     * submitted within a short window, so that they can be written
+     * all at once.
+     */
+    class WriteCoalescer
+    {
+    public:
+        /**
+         * This is the type of function called to write a batch of packets.
+         * It is called with the coalescer's lock held, so that batches
+         * are always written in order.
+         *
+         * @param[in] packets
+         *      These are the packets to write, in order.
+         */
+        typedef std::function<void(std::vector<OutgoingMessage>&& packets)> FlushDelegate;
+
+        /**
+         * This holds the numbers of packets and writes of a coalescer.
+         */
+        struct Statistics
+        {
+            /**
+             * This is the number of packets submitted.
+             */
+            uint64_t packets = 0;
+
+            /**
+             * This is the number of writes the packets were gathered into.
+             */
+            uint64_t writes = 0;
+        };
+
+        // Lifecycle management
+    public:
+        ~WriteCoalescer() noexcept;
+        WriteCoalescer(const WriteCoalescer&) = delete;
+        WriteCoalescer(WriteCoalescer&&) noexcept = delete;
+        WriteCoalescer& operator=(const WriteCoalescer&) = delete;
+        WriteCoalescer& operator=(WriteCoalescer&&) noexcept = delete;
+
+        // Public methods
+    public:
+        /**
+         * This is the constructor.
+         *
+         * @param[in] timerQueue
+         *      This is used to flush pending packets once the
+         *      window has elapsed.
+         * @param[in] window
+         *      This is the longest time a packet may wait for others
+         *      to be gathered with it.
+         * @param[in] thresholdBytes
+         *      This is the number of pending bytes at which the
+         *      packets are flushed without waiting.
+         * @param[in] flushDelegate
+         *      This is the function to call to write a batch of packets.
+         */
+        WriteCoalescer(std::shared_ptr<TimerQueue> timerQueue, std::chrono::microseconds window,
+                       size_t thresholdBytes, FlushDelegate flushDelegate);
+
+        /**
+         * This method submits a packet to be written.
+         *
+         * @param[in] packet
+         *      This is the packet to write.
+         * @param[in] urgent
+         *      This indicates whether or not the packet, and any packets
+         *      pending before it, should be written immediately.
+         */
+        void Submit(OutgoingMessage&& packet, bool urgent);
+
+        /**
+         * This method writes any pending packets immediately.
+         */
+        void Flush();
+
+        /**
+         * This method returns the numbers of packets and writes so far.
+         *
+         * @return
+         *      The statistics of the coalescer are returned.
+         */
+        Statistics GetStatistics() const;
+
+        // Private properties
+    private:
+        /**
+         * This is the type of structure that contains the private
+         * properties of the instance.  It is defined in the implementation
+         * and declared here to ensure that it is scoped inside the class.
+         */
+        struct Impl;
+
+        /**
+         * This contains the private properties of the instance.  It is
+         * shared with the flush timer, which may expire while the
+         * coalescer is destroyed.
+         */
+        std::shared_ptr<Impl> impl_;
+    };
+}  // namespace MqttNetworkTransport
+
+#endif /** MQTT_NETWORK_TRANSPORT_WRITE_COALESCER_HPP */
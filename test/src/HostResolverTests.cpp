@@ -0,0 +1,162 @@
+/**
+ * @file HostResolverTests.cpp
+ *
+ * This module contains the unit tests of the
+ * MqttNetworkTransport::HostResolver class.
+ *
+ * © 2025 by Hatem Nabli
+ */
+
+#include <gtest/gtest.h>
+#include <HostResolver.hpp>
+#include <atomic>
+#include <chrono>
+#include <stdint.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    /**
+     * This function makes an IPv6 address whose last byte is given.
+     *
+     * @param[in] last
+     *      This is the last byte of the address.
+     * @return
+     *      The address is returned.
+     */
+    MqttNetworkTransport::HostResolver::Address MakeIpv6(uint8_t last) {
+        MqttNetworkTransport::HostResolver::Address address;
+        address.ipv6 = true;
+        address.bytes[15] = last;
+        return address;
+    }
+
+    /**
+     * This function makes an IPv4 address whose last byte is given.
+     *
+     * @param[in] last
+     *      This is the last byte of the address.
+     * @return
+     *      The address is returned.
+     */
+    MqttNetworkTransport::HostResolver::Address MakeIpv4(uint8_t last) {
+        return MqttNetworkTransport::HostResolver::Address::FromIpv4(0x0A000000 | last);
+    }
+
+    /**
+     * This function describes the given addresses compactly, as the
+     * family and last byte of each, for comparing orders.
+     *
+     * @param[in] addresses
+     *      These are the addresses to describe.
+     * @return
+     *      The description of the addresses is returned.
+     */
+    std::string Describe(const MqttNetworkTransport::HostResolver::Addresses& addresses) {
+        std::string description;
+        for (const auto& address : addresses)
+        {
+            if (!description.empty())
+            { description += ","; }
+            description += (address.ipv6 ? "6:" : "4:");
+            description += std::to_string(address.ipv6 ? address.bytes[15] : address.bytes[3]);
+        }
+        return description;
+    }
+}  // namespace
+
+TEST(HostResolverTests, InterleaveFamiliesStartsWithFirstFamily) {
+    EXPECT_EQ("6:1,4:1,6:2,4:2,6:3",
+              Describe(MqttNetworkTransport::HostResolver::InterleaveFamilies(
+                  {MakeIpv6(1), MakeIpv6(2), MakeIpv6(3), MakeIpv4(1), MakeIpv4(2)})));
+    EXPECT_EQ("4:1,6:1,4:2,6:2,6:3",
+              Describe(MqttNetworkTransport::HostResolver::InterleaveFamilies(
+                  {MakeIpv4(1), MakeIpv6(1), MakeIpv6(2), MakeIpv4(2), MakeIpv6(3)})));
+}
+
+TEST(HostResolverTests, InterleaveFamiliesKeepsOrderWithinFamily) {
+    EXPECT_EQ("4:3,6:9,4:1,6:5,4:2",
+              Describe(MqttNetworkTransport::HostResolver::InterleaveFamilies(
+                  {MakeIpv4(3), MakeIpv4(1), MakeIpv4(2), MakeIpv6(9), MakeIpv6(5)})));
+}
+
+TEST(HostResolverTests, InterleaveFamiliesLeavesSingleFamilyAlone) {
+    EXPECT_EQ("4:2,4:1,4:3", Describe(MqttNetworkTransport::HostResolver::InterleaveFamilies(
+                                 {MakeIpv4(2), MakeIpv4(1), MakeIpv4(3)})));
+    EXPECT_EQ("6:1", Describe(MqttNetworkTransport::HostResolver::InterleaveFamilies(
+                         {MakeIpv6(1)})));
+    EXPECT_TRUE(MqttNetworkTransport::HostResolver::InterleaveFamilies({}).empty());
+}
+
+TEST(HostResolverTests, InterleaveFamiliesKeepsScopes) {
+    auto linkLocal = MakeIpv6(1);
+    linkLocal.scopeId = 7;
+    const auto interleaved =
+        MqttNetworkTransport::HostResolver::InterleaveFamilies({MakeIpv4(1), linkLocal});
+    ASSERT_EQ(2, interleaved.size());
+    EXPECT_EQ(7, interleaved[1].scopeId);
+}
+
+TEST(HostResolverTests, ParseDottedQuad) {
+    uint32_t address = 0;
+    ASSERT_TRUE(MqttNetworkTransport::HostResolver::ParseDottedQuad("10.1.2.255", address));
+    EXPECT_EQ(0x0A0102FF, address);
+    for (const auto host : {"1.2.3", "1.2.3.4.", "256.1.1.1", "a.b.c.d", "1..2.3", "1.2.3.4x",
+                            "0001.2.3.4", ""})
+    {
+        EXPECT_FALSE(MqttNetworkTransport::HostResolver::ParseDottedQuad(host, address))
+            << host;
+    }
+}
+
+TEST(HostResolverTests, ConcurrentRequestsShareOneLookup) {
+    std::atomic<int> lookups{0};
+    MqttNetworkTransport::HostResolver resolver(
+        2,
+        [&lookups](const std::string& host)
+        {
+            ++lookups;
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+            MqttNetworkTransport::HostResolver::Addresses addresses;
+            if (host == "good")
+            { addresses.push_back(MakeIpv4(1)); }
+            return addresses;
+        });
+    resolver.SetTimeToLive(std::chrono::seconds(60), std::chrono::seconds(60));
+    std::vector<std::thread> threads;
+    std::atomic<int> resolved{0};
+    std::atomic<int> failed{0};
+    for (int i = 0; i < 10; ++i)
+    {
+        threads.emplace_back(
+            [&resolver, &resolved, &failed]
+            {
+                if (resolver.Resolve("good").size() == 1)
+                { ++resolved; }
+                if (resolver.Resolve("bad").empty())
+                { ++failed; }
+            });
+    }
+    for (auto& thread : threads)
+    { thread.join(); }
+    EXPECT_EQ(10, resolved);
+    EXPECT_EQ(10, failed);
+    EXPECT_EQ(2, lookups);
+}
+
+TEST(HostResolverTests, LiteralsAreNotLookedUp) {
+    std::atomic<int> lookups{0};
+    MqttNetworkTransport::HostResolver resolver(
+        1,
+        [&lookups](const std::string&)
+        {
+            ++lookups;
+            return MqttNetworkTransport::HostResolver::Addresses();
+        });
+    const auto addresses = resolver.Resolve("127.0.0.1");
+    ASSERT_EQ(1, addresses.size());
+    EXPECT_EQ(0x7F000001, addresses[0].GetIpv4());
+    EXPECT_EQ(0, lookups);
+}
@@ -0,0 +1,163 @@
+/**
+ * @file PacketFramerTests.cpp
+ *
+ * This module contains the unit tests of the
+ * MqttNetworkTransport::PacketFramer class.
+ *
+ * © 2025 by Hatem Nabli
+ */
+
+#include <gtest/gtest.h>
+#include <PacketFramer.hpp>
+#include <stdint.h>
+#include <vector>
+
+namespace
+{
+    /**
+     * This is a PINGRESP packet.
+     */
+    const std::vector<uint8_t> PINGRESP{0xD0, 0x00};
+
+    /**
+     * This is a PUBACK packet.
+     */
+    const std::vector<uint8_t> PUBACK{0x40, 0x02, 0x00, 0x01};
+
+    /**
+     * This function concatenates the given packets.
+     *
+     * @param[in] packets
+     *      These are the packets to concatenate.
+     * @return
+     *      The concatenated packets are returned.
+     */
+    std::vector<uint8_t> Concatenate(const std::vector<std::vector<uint8_t>>& packets) {
+        std::vector<uint8_t> data;
+        for (const auto& packet : packets)
+        { data.insert(data.end(), packet.begin(), packet.end()); }
+        return data;
+    }
+
+    /**
+     * This function makes a PUBLISH packet with a payload of the given
+     * size, so that its Remaining Length takes more than one byte when
+     * the payload is large enough.
+     *
+     * @param[in] payloadSize
+     *      This is the number of bytes of payload.
+     * @return
+     *      The packet is returned.
+     */
+    std::vector<uint8_t> MakePublish(size_t payloadSize) {
+        std::vector<uint8_t> packet{0x30};
+        size_t remainingLength = 3 + payloadSize;
+        do
+        {
+            uint8_t encoded = (uint8_t)(remainingLength & 0x7F);
+            remainingLength >>= 7;
+            if (remainingLength > 0)
+            { encoded |= 0x80; }
+            packet.push_back(encoded);
+        } while (remainingLength > 0);
+        packet.insert(packet.end(), {0x00, 0x01, 'a'});
+        packet.insert(packet.end(), payloadSize, 0x5A);
+        return packet;
+    }
+}  // namespace
+
+/**
+ * This is the test fixture for these tests, providing common
+ * setup and teardown for each test.
+ */
+struct PacketFramerTests : public ::testing::Test
+{
+    // Properties
+
+    /**
+     * These are the deliveries made by the framer under test.
+     */
+    std::vector<std::vector<uint8_t>> delivered;
+
+    /**
+     * This is the delegate given to the framer under test.
+     */
+    MqttV5::Connection::DataReceivedDelegate delegate =
+        [this](const std::vector<uint8_t>& data) { delivered.push_back(data); };
+};
+
+TEST_F(PacketFramerTests, WholePacketDeliveredAsIs) {
+    MqttNetworkTransport::PacketFramer framer(false, 1024);
+    EXPECT_TRUE(framer.Feed(PUBACK, delegate));
+    EXPECT_EQ((std::vector<std::vector<uint8_t>>{PUBACK}), delivered);
+}
+
+TEST_F(PacketFramerTests, PacketModeDeliversEachPacketSeparately) {
+    MqttNetworkTransport::PacketFramer framer(false, 1024);
+    const auto publish = MakePublish(10);
+    EXPECT_TRUE(framer.Feed(Concatenate({PUBACK, PINGRESP, publish}), delegate));
+    EXPECT_EQ((std::vector<std::vector<uint8_t>>{PUBACK, PINGRESP, publish}), delivered);
+}
+
+TEST_F(PacketFramerTests, BatchModeDeliversCompletePacketsTogether) {
+    MqttNetworkTransport::PacketFramer framer(true, 1024);
+    const auto publish = MakePublish(10);
+    const auto data = Concatenate({PUBACK, PINGRESP, publish});
+    EXPECT_TRUE(framer.Feed(
+        Concatenate({data, std::vector<uint8_t>(publish.begin(), publish.begin() + 3)}),
+        delegate));
+    EXPECT_EQ((std::vector<std::vector<uint8_t>>{data}), delivered);
+    delivered.clear();
+    EXPECT_TRUE(framer.Feed(std::vector<uint8_t>(publish.begin() + 3, publish.end()), delegate));
+    EXPECT_EQ((std::vector<std::vector<uint8_t>>{publish}), delivered);
+}
+
+TEST_F(PacketFramerTests, PacketStraddlingReadsIsHeldUntilComplete) {
+    MqttNetworkTransport::PacketFramer framer(false, 1024);
+    const auto publish = MakePublish(300);
+    const auto data = Concatenate({publish, PUBACK});
+    for (const auto byte : data)
+    { EXPECT_TRUE(framer.Feed({byte}, delegate)); }
+    EXPECT_EQ((std::vector<std::vector<uint8_t>>{publish, PUBACK}), delivered);
+}
+
+TEST_F(PacketFramerTests, PacketsSplitAcrossReadsInEveryWay) {
+    const auto publish = MakePublish(200);
+    const auto data = Concatenate({PUBACK, publish, PINGRESP});
+    for (size_t split = 1; split < data.size(); ++split)
+    {
+        delivered.clear();
+        MqttNetworkTransport::PacketFramer framer(false, 1024);
+        EXPECT_TRUE(framer.Feed(std::vector<uint8_t>(data.begin(), data.begin() + split),
+                                delegate));
+        EXPECT_TRUE(framer.Feed(std::vector<uint8_t>(data.begin() + split, data.end()),
+                                delegate));
+        EXPECT_EQ((std::vector<std::vector<uint8_t>>{PUBACK, publish, PINGRESP}), delivered)
+            << "split at " << split;
+    }
+}
+
+TEST_F(PacketFramerTests, RemainingLengthTooLongIsMalformed) {
+    MqttNetworkTransport::PacketFramer framer(false, 1024);
+    EXPECT_FALSE(framer.Feed({0x30, 0xFF, 0xFF, 0xFF, 0xFF, 0x01}, delegate));
+    EXPECT_TRUE(delivered.empty());
+    EXPECT_FALSE(framer.Feed(PUBACK, delegate));
+    EXPECT_TRUE(delivered.empty());
+}
+
+TEST_F(PacketFramerTests, PacketLargerThanMaximumIsMalformed) {
+    const auto publish = MakePublish(200);
+    MqttNetworkTransport::PacketFramer framer(false, publish.size() - 1);
+    EXPECT_TRUE(framer.Feed(PUBACK, delegate));
+    EXPECT_FALSE(framer.Feed(std::vector<uint8_t>(publish.begin(), publish.begin() + 3),
+                             delegate));
+    EXPECT_EQ((std::vector<std::vector<uint8_t>>{PUBACK}), delivered);
+    EXPECT_FALSE(framer.Feed(PUBACK, delegate));
+}
+
+TEST_F(PacketFramerTests, PacketOfMaximumSizeIsDelivered) {
+    const auto publish = MakePublish(200);
+    MqttNetworkTransport::PacketFramer framer(false, publish.size());
+    EXPECT_TRUE(framer.Feed(publish, delegate));
+    EXPECT_EQ((std::vector<std::vector<uint8_t>>{publish}), delivered);
+}
@@ -0,0 +1,112 @@
+/**
+ * @file ReceiveBufferPoolTests.cpp
+ *
+ * This module contains the unit tests of the
+ * MqttNetworkTransport::ReceiveBufferPool class.
+ *
+ * © 2025 by Hatem Nabli
+ */
+
+#include <gtest/gtest.h>
+#include <ReceiveBufferPool.hpp>
+#include <memory>
+#include <stdint.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    /**
+     * This function takes the given number of buffers from the given pool,
+     * giving each a distinct size, and then gives them all back.
+     *
+     * @param[in] pool
+     *      This is the pool to use.
+     * @param[in] count
+     *      This is the number of buffers to take and give back.
+     */
+    void Cycle(MqttNetworkTransport::ReceiveBufferPool& pool, size_t count) {
+        std::vector<std::vector<uint8_t>> buffers;
+        for (size_t i = 0; i < count; ++i)
+        {
+            buffers.push_back(pool.Acquire());
+            buffers.back().resize(i + 1);
+        }
+        for (auto& buffer : buffers)
+        { pool.Release(std::move(buffer)); }
+    }
+}  // namespace
+
+TEST(ReceiveBufferPoolTests, ReusesReleasedBuffers) {
+    MqttNetworkTransport::ReceiveBufferPool pool(4);
+    auto buffer = pool.Acquire();
+    EXPECT_TRUE(buffer.empty());
+    buffer.resize(100);
+    pool.Release(std::move(buffer));
+    EXPECT_EQ(100, pool.Acquire().size());
+    const auto statistics = pool.GetStatistics();
+    EXPECT_EQ(1, statistics.hits);
+    EXPECT_EQ(1, statistics.misses);
+    EXPECT_EQ(0, statistics.pooled);
+}
+
+TEST(ReceiveBufferPoolTests, KeepsThreadBuffersAndBoundedOverflow) {
+    MqttNetworkTransport::ReceiveBufferPool pool(4);
+    Cycle(pool, 100);
+    auto statistics = pool.GetStatistics();
+    EXPECT_EQ(0, statistics.hits);
+    EXPECT_EQ(100, statistics.misses);
+    EXPECT_EQ(8, statistics.pooled);
+    Cycle(pool, 8);
+    statistics = pool.GetStatistics();
+    EXPECT_EQ(8, statistics.hits);
+    EXPECT_EQ(100, statistics.misses);
+    EXPECT_EQ(8, statistics.pooled);
+}
+
+TEST(ReceiveBufferPoolTests, ThreadsShareOverflow) {
+    MqttNetworkTransport::ReceiveBufferPool pool(64);
+    std::thread([&pool] { Cycle(pool, 48); }).join();
+    const auto before = pool.GetStatistics();
+    EXPECT_EQ(48, before.misses);
+    EXPECT_EQ(48, before.pooled);
+    Cycle(pool, 48);
+    const auto after = pool.GetStatistics();
+    EXPECT_EQ(48, after.hits);
+    EXPECT_EQ(48, after.misses);
+}
+
+TEST(ReceiveBufferPoolTests, ConcurrentUseKeepsCountersConsistent) {
+    MqttNetworkTransport::ReceiveBufferPool pool(32);
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 4; ++i)
+    {
+        threads.emplace_back(
+            [&pool]
+            {
+                for (int j = 0; j < 1000; ++j)
+                { Cycle(pool, 1 + (j % 24)); }
+            });
+    }
+    for (auto& thread : threads)
+    { thread.join(); }
+    size_t expected = 0;
+    for (int j = 0; j < 1000; ++j)
+    { expected += 1 + (j % 24); }
+    const auto statistics = pool.GetStatistics();
+    EXPECT_EQ(4 * expected, statistics.hits + statistics.misses);
+    EXPECT_LE(statistics.pooled, 32);
+}
+
+TEST(ReceiveBufferPoolTests, ReportsCountersWhenMissesDouble) {
+    const auto diagnosticsSender = std::make_shared<SystemUtils::DiagnosticsSender>("test");
+    std::vector<std::string> messages;
+    const auto unsubscribe = diagnosticsSender->SubscribeToDiagnostics(
+        [&messages](std::string, size_t, std::string message) { messages.push_back(message); });
+    MqttNetworkTransport::ReceiveBufferPool pool(4, diagnosticsSender);
+    Cycle(pool, 5);
+    ASSERT_EQ(3, messages.size());
+    EXPECT_EQ("receive buffer pool: 0 hits, 4 misses, 0 pooled", messages[2]);
+    unsubscribe();
+}
@@ -0,0 +1,189 @@
+/**
+ * @file ReconnectGovernorTests.cpp
+ *
+ * This module contains the unit tests of the
+ * MqttNetworkTransport::ReconnectGovernor class.
+ *
+ * © 2025 by Hatem Nabli
+ */
+
+#include <gtest/gtest.h>
+#include <ReconnectGovernor.hpp>
+#include <algorithm>
+#include <chrono>
+#include <string>
+
+namespace
+{
+    /**
+     * This function makes settings for a governor which
+     * only backs off endpoints.
+     *
+     * @param[in] base
+     *      This is the least backoff, in milliseconds.
+     * @param[in] cap
+     *      This is the greatest backoff, in milliseconds.
+     * @return
+     *      The settings are returned.
+     */
+    MqttNetworkTransport::ReconnectGovernor::Settings MakeBackoffSettings(unsigned base,
+                                                                          unsigned cap) {
+        MqttNetworkTransport::ReconnectGovernor::Settings settings;
+        settings.backoffBase = std::chrono::milliseconds(base);
+        settings.backoffCap = std::chrono::milliseconds(cap);
+        return settings;
+    }
+
+    /**
+     * This function returns how long an attempt admitted by the given
+     * governor to the given endpoint at the given time has to wait.
+     *
+     * @param[in] governor
+     *      This is the governor to admit the attempt.
+     * @param[in] endpoint
+     *      This identifies the endpoint to which to connect.
+     * @param[in] now
+     *      This is the current time.
+     * @return
+     *      The wait, in milliseconds, is returned.
+     */
+    long long WaitMilliseconds(MqttNetworkTransport::ReconnectGovernor& governor,
+                               const std::string& endpoint,
+                               std::chrono::steady_clock::time_point now) {
+        return (long long)std::chrono::duration_cast<std::chrono::milliseconds>(
+                   governor.Admit(endpoint, now) - now)
+            .count();
+    }
+}  // namespace
+
+TEST(ReconnectGovernorTests, AdmitsAtOnceByDefault) {
+    MqttNetworkTransport::ReconnectGovernor governor;
+    const auto now = std::chrono::steady_clock::now();
+    for (int i = 0; i < 10; ++i)
+    { EXPECT_EQ(0, WaitMilliseconds(governor, "a", now)); }
+    governor.RecordFailure("a", now, now);
+    EXPECT_EQ(0, WaitMilliseconds(governor, "a", now));
+    const auto statistics = governor.GetStatistics();
+    EXPECT_EQ(0, statistics.backedOff);
+    EXPECT_EQ(0, statistics.rateLimited);
+    EXPECT_EQ(0, statistics.delayMicroseconds);
+}
+
+TEST(ReconnectGovernorTests, BurstStartsAtOnceAndTheRestAreMetered) {
+    MqttNetworkTransport::ReconnectGovernor governor;
+    MqttNetworkTransport::ReconnectGovernor::Settings settings;
+    settings.attemptsPerSecond = 10;
+    settings.burst = 3;
+    governor.Configure(settings);
+    const auto now = std::chrono::steady_clock::now();
+    EXPECT_EQ(0, WaitMilliseconds(governor, "a", now));
+    EXPECT_EQ(0, WaitMilliseconds(governor, "b", now));
+    EXPECT_EQ(0, WaitMilliseconds(governor, "c", now));
+    EXPECT_EQ(100, WaitMilliseconds(governor, "d", now));
+    EXPECT_EQ(200, WaitMilliseconds(governor, "e", now));
+    const auto statistics = governor.GetStatistics();
+    EXPECT_EQ(0, statistics.backedOff);
+    EXPECT_EQ(2, statistics.rateLimited);
+    EXPECT_EQ(300000, statistics.delayMicroseconds);
+}
+
+TEST(ReconnectGovernorTests, BurstRefillsWhileIdle) {
+    MqttNetworkTransport::ReconnectGovernor governor;
+    MqttNetworkTransport::ReconnectGovernor::Settings settings;
+    settings.attemptsPerSecond = 10;
+    settings.burst = 2;
+    governor.Configure(settings);
+    const auto now = std::chrono::steady_clock::now();
+    EXPECT_EQ(0, WaitMilliseconds(governor, "a", now));
+    EXPECT_EQ(0, WaitMilliseconds(governor, "a", now));
+    EXPECT_EQ(100, WaitMilliseconds(governor, "a", now));
+    const auto later = now + std::chrono::seconds(1);
+    EXPECT_EQ(0, WaitMilliseconds(governor, "a", later));
+    EXPECT_EQ(0, WaitMilliseconds(governor, "a", later));
+    EXPECT_EQ(100, WaitMilliseconds(governor, "a", later));
+}
+
+TEST(ReconnectGovernorTests, BackoffStaysBetweenBaseAndCap) {
+    MqttNetworkTransport::ReconnectGovernor governor;
+    governor.Configure(MakeBackoffSettings(100, 1000));
+    auto now = std::chrono::steady_clock::now();
+    long long previous = 100;
+    bool reachedCap = false;
+    for (int i = 0; i < 200; ++i)
+    {
+        governor.RecordFailure("a", now, now);
+        const auto wait = WaitMilliseconds(governor, "a", now);
+        EXPECT_GE(wait, 100);
+        EXPECT_LE(wait, std::min(1000LL, previous * 3 + 3));
+        reachedCap = (reachedCap || (wait > 900));
+        previous = wait;
+        now += std::chrono::milliseconds(wait);
+    }
+    EXPECT_TRUE(reachedCap);
+    EXPECT_EQ(200, governor.GetStatistics().backedOff);
+}
+
+TEST(ReconnectGovernorTests, BackoffIsPerEndpoint) {
+    MqttNetworkTransport::ReconnectGovernor governor;
+    governor.Configure(MakeBackoffSettings(100, 1000));
+    const auto now = std::chrono::steady_clock::now();
+    governor.RecordFailure("a", now, now);
+    EXPECT_GE(WaitMilliseconds(governor, "a", now), 100);
+    EXPECT_EQ(0, WaitMilliseconds(governor, "b", now));
+}
+
+TEST(ReconnectGovernorTests, SuccessClearsBackoff) {
+    MqttNetworkTransport::ReconnectGovernor governor;
+    governor.Configure(MakeBackoffSettings(100, 1000));
+    const auto now = std::chrono::steady_clock::now();
+    for (int i = 0; i < 5; ++i)
+    { governor.RecordFailure("a", now, now + std::chrono::milliseconds(i)); }
+    governor.RecordSuccess("a");
+    EXPECT_EQ(0, WaitMilliseconds(governor, "a", now));
+    governor.RecordFailure("a", now, now);
+    const auto wait = WaitMilliseconds(governor, "a", now);
+    EXPECT_GE(wait, 100);
+    EXPECT_LE(wait, 300);
+}
+
+TEST(ReconnectGovernorTests, CrowdFailingTogetherBacksOffOnce) {
+    MqttNetworkTransport::ReconnectGovernor governor;
+    governor.Configure(MakeBackoffSettings(100, 100000));
+    const auto started = std::chrono::steady_clock::now();
+    const auto failed = started + std::chrono::milliseconds(10);
+    governor.RecordFailure("a", started, failed);
+    const auto until = governor.Admit("a", failed);
+    for (int i = 0; i < 100; ++i)
+    { governor.RecordFailure("a", started, failed + std::chrono::milliseconds(i)); }
+    EXPECT_EQ(until, governor.Admit("a", failed));
+    governor.RecordFailure("a", failed + std::chrono::milliseconds(1), until);
+    EXPECT_LT(until, governor.Admit("a", until));
+}
+
+TEST(ReconnectGovernorTests, ZeroBaseClearsBackoff) {
+    MqttNetworkTransport::ReconnectGovernor governor;
+    governor.Configure(MakeBackoffSettings(100, 1000));
+    const auto now = std::chrono::steady_clock::now();
+    governor.RecordFailure("a", now, now);
+    EXPECT_GE(WaitMilliseconds(governor, "a", now), 100);
+    governor.Configure(MakeBackoffSettings(0, 1000));
+    EXPECT_EQ(0, WaitMilliseconds(governor, "a", now));
+    governor.RecordFailure("a", now, now);
+    EXPECT_EQ(0, WaitMilliseconds(governor, "a", now));
+}
+
+TEST(ReconnectGovernorTests, RateLimitAppliesAfterBackoff) {
+    MqttNetworkTransport::ReconnectGovernor governor;
+    auto settings = MakeBackoffSettings(500, 500);
+    settings.attemptsPerSecond = 10;
+    settings.burst = 1;
+    governor.Configure(settings);
+    const auto now = std::chrono::steady_clock::now();
+    governor.RecordFailure("a", now, now);
+    EXPECT_EQ(500, WaitMilliseconds(governor, "a", now));
+    EXPECT_EQ(600, WaitMilliseconds(governor, "a", now));
+    EXPECT_EQ(700, WaitMilliseconds(governor, "b", now));
+    const auto statistics = governor.GetStatistics();
+    EXPECT_EQ(2, statistics.backedOff);
+    EXPECT_EQ(2, statistics.rateLimited);
+}
@@ -0,0 +1,585 @@
+/**
+ * @file ResumingConnectionTests.cpp
+ *
+ * This module contains the unit tests of the
+ * MqttNetworkTransport::ResumingConnection class.
+ *
+ * © 2025 by Hatem Nabli
+ */
+
+#include <gtest/gtest.h>
+#include <ResumingConnection.hpp>
+#include <TimerQueue.hpp>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <stdint.h>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    /**
+     * This is the type of an encoded MQTT control packet.
+     */
+    typedef std::vector<uint8_t> Packet;
+
+    /**
+     * This is a stand-in for a network connection,
+     * which keeps what is sent on it.
+     */
+    class FakeConnection : public MqttNetworkTransport::ZeroCopyConnection
+    {
+    public:
+        /**
+         * This method returns the packets sent on the connection.
+         *
+         * @return
+         *      The packets sent on the connection are returned.
+         */
+        std::vector<Packet> GetSent() {
+            std::lock_guard<decltype(mutex_)> lock(mutex_);
+            return sent_;
+        }
+
+        /**
+         * This method returns whether or not the connection was broken.
+         *
+         * @return
+         *      An indication of whether or not the connection
+         *      was broken is returned.
+         */
+        bool IsBroken() {
+            std::lock_guard<decltype(mutex_)> lock(mutex_);
+            return broken_;
+        }
+
+        // MqttV5::Connection
+
+        virtual std::string GetPeerId() override { return "fake"; }
+        virtual void SetDataReceivedDelegate(DataReceivedDelegate) override {}
+        virtual void SetConnectionBrokenDelegate(BrokenDelegate) override {}
+
+        virtual void SendData(const std::vector<uint8_t>& data) override {
+            std::lock_guard<decltype(mutex_)> lock(mutex_);
+            sent_.push_back(data);
+        }
+
+        virtual void Break(bool) override {
+            std::lock_guard<decltype(mutex_)> lock(mutex_);
+            broken_ = true;
+        }
+
+        // MqttNetworkTransport::ZeroCopyConnection
+
+        virtual void SendData(std::vector<uint8_t>&& data) override { SendData(data); }
+        virtual void SendData(SharedBuffer data) override { SendData(*data); }
+
+        virtual ConnectionStatistics GetConnectionStatistics() override {
+            return ConnectionStatistics();
+        }
+
+    private:
+        /**
+         * This is used to synchronize access to the connection.
+         */
+        std::mutex mutex_;
+
+        /**
+         * These are the packets sent on the connection.
+         */
+        std::vector<Packet> sent_;
+
+        /**
+         * This indicates whether or not the connection was broken.
+         */
+        bool broken_ = false;
+    };
+
+    /**
+     * This function makes a CONNECT packet with a Client Identifier
+     * and Clean Start set.
+     *
+     * @param[in] sessionExpiry
+     *      This indicates whether or not to give a non-zero
+     *      Session Expiry Interval, so that the broker keeps
+     *      the session.
+     * @return
+     *      The packet is returned.
+     */
+    Packet MakeConnect(bool sessionExpiry) {
+        Packet packet{0x10, 0, 0, 4, 'M', 'Q', 'T', 'T', 5, 0x02, 0, 60};
+        if (sessionExpiry)
+        { packet.insert(packet.end(), {5, 0x11, 0, 0, 0, 60}); } else
+        { packet.push_back(0); }
+        packet.insert(packet.end(), {0, 2, 'c', '1'});
+        packet[1] = (uint8_t)(packet.size() - 2);
+        return packet;
+    }
+
+    /**
+     * This function makes a successful CONNACK packet.
+     *
+     * @param[in] sessionPresent
+     *      This indicates whether or not the broker
+     *      reports the session as present.
+     * @param[in] properties
+     *      These are the encoded properties of the packet.
+     * @return
+     *      The packet is returned.
+     */
+    Packet MakeConnack(bool sessionPresent, const Packet& properties = Packet()) {
+        Packet packet{0x20, 0, (uint8_t)(sessionPresent ? 1 : 0), 0, (uint8_t)properties.size()};
+        packet.insert(packet.end(), properties.begin(), properties.end());
+        packet[1] = (uint8_t)(packet.size() - 2);
+        return packet;
+    }
+
+    /**
+     * This function makes a PUBLISH packet to the topic "t".
+     *
+     * @param[in] qos
+     *      This is the quality of service of the packet.
+     * @param[in] packetIdentifier
+     *      This is the Packet Identifier of the packet,
+     *      used if the quality of service isn't zero.
+     * @param[in] payload
+     *      This is the single byte of payload of the packet.
+     * @return
+     *      The packet is returned.
+     */
+    Packet MakePublish(uint8_t qos, uint16_t packetIdentifier, uint8_t payload) {
+        Packet packet{(uint8_t)(0x30 | (qos << 1)), 0, 0, 1, 't'};
+        if (qos != 0)
+        {
+            packet.push_back((uint8_t)(packetIdentifier >> 8));
+            packet.push_back((uint8_t)packetIdentifier);
+        }
+        packet.push_back(0);
+        packet.push_back(payload);
+        packet[1] = (uint8_t)(packet.size() - 2);
+        return packet;
+    }
+
+    /**
+     * This function makes a PUBACK, PUBREC, PUBREL or PUBCOMP packet.
+     *
+     * @param[in] type
+     *      This is the type of the packet.
+     * @param[in] packetIdentifier
+     *      This is the Packet Identifier of the packet.
+     * @return
+     *      The packet is returned.
+     */
+    Packet MakeAcknowledgement(uint8_t type, uint16_t packetIdentifier) {
+        return Packet{(uint8_t)((type << 4) | ((type == 6) ? 0x02 : 0x00)), 2,
+                      (uint8_t)(packetIdentifier >> 8), (uint8_t)packetIdentifier};
+    }
+
+    /**
+     * These are the types of the acknowledgement packets used in the tests.
+     */
+    constexpr uint8_t PUBACK = 4;
+    constexpr uint8_t PUBREC = 5;
+    constexpr uint8_t PUBREL = 6;
+
+    /**
+     * These are CONNACK properties giving a Receive Maximum of 20,
+     * a Maximum Packet Size of 4096 and a Reason String.
+     */
+    const Packet LIMITS{0x21, 0, 20, 0x27, 0, 0, 0x10, 0, 0x1F, 0, 2, 'o', 'k'};
+}  // namespace
+
+/**
+ * This is the test fixture for these tests, providing a resuming
+ * connection over a fake first network connection, and keeping what
+ * the connection reports and the attempts it makes to reconnect.
+ */
+struct ResumingConnectionTests : public ::testing::Test
+{
+    // Types
+
+    /**
+     * This holds an attempt made by the connection to reconnect.
+     */
+    struct Attempt
+    {
+        MqttV5::Connection::DataReceivedDelegate dataReceivedDelegate;
+        MqttNetworkTransport::ResumingConnection::ReconnectCompletionDelegate
+            completionDelegate;
+        std::chrono::steady_clock::time_point start;
+    };
+
+    // Properties
+
+    /**
+     * This is used to delay attempts to reconnect.
+     */
+    std::shared_ptr<MqttNetworkTransport::TimerQueue> timerQueue =
+        std::make_shared<MqttNetworkTransport::TimerQueue>();
+
+    /**
+     * This is used to synchronize access to what the connection reports.
+     */
+    std::mutex mutex;
+
+    /**
+     * This is used to wait for the connection to report something.
+     */
+    std::condition_variable wakeCondition;
+
+    /**
+     * These are the attempts the connection made to reconnect.
+     */
+    std::vector<Attempt> attempts;
+
+    /**
+     * This is the number of attempts to reconnect abandoned.
+     */
+    size_t cancels = 0;
+
+    /**
+     * These are the outcomes of the breaks reported by the connection.
+     */
+    std::vector<bool> outcomes;
+
+    /**
+     * These are the packets the connection delivered.
+     */
+    std::vector<Packet> received;
+
+    /**
+     * This is the number of times the connection reported a break.
+     */
+    size_t breaks = 0;
+
+    /**
+     * This is the first network connection.
+     */
+    std::shared_ptr<FakeConnection> first = std::make_shared<FakeConnection>();
+
+    /**
+     * These are the delegates given to the first network connection.
+     */
+    MqttV5::Connection::DataReceivedDelegate firstDataReceivedDelegate;
+    MqttV5::Connection::BrokenDelegate firstBrokenDelegate;
+
+    /**
+     * This is the connection under test.
+     */
+    std::shared_ptr<MqttNetworkTransport::ResumingConnection> connection;
+
+    // Methods
+
+    /**
+     * This method makes the connection under test.
+     *
+     * @param[in] settings
+     *      These are the settings of the connection.
+     */
+    void MakeConnection(const MqttNetworkTransport::ResumingConnection::Settings& settings) {
+        connection = std::make_shared<MqttNetworkTransport::ResumingConnection>(
+            settings, timerQueue,
+            [this](MqttV5::Connection::DataReceivedDelegate dataReceivedDelegate,
+                   MqttV5::Connection::BrokenDelegate,
+                   MqttNetworkTransport::ResumingConnection::ReconnectCompletionDelegate
+                       completionDelegate)
+            {
+                std::lock_guard<decltype(mutex)> lock(mutex);
+                Attempt attempt;
+                attempt.dataReceivedDelegate = dataReceivedDelegate;
+                attempt.completionDelegate = completionDelegate;
+                attempt.start = std::chrono::steady_clock::now();
+                attempts.push_back(attempt);
+                wakeCondition.notify_all();
+                return [this]
+                {
+                    std::lock_guard<decltype(mutex)> lock(mutex);
+                    ++cancels;
+                };
+            },
+            [this](bool resumed)
+            {
+                std::lock_guard<decltype(mutex)> lock(mutex);
+                outcomes.push_back(resumed);
+            },
+            std::make_shared<SystemUtils::DiagnosticsSender>("ResumingConnectionTests"), "peer");
+        connection->SetDataReceivedDelegate(
+            [this](const std::vector<uint8_t>& data)
+            {
+                std::lock_guard<decltype(mutex)> lock(mutex);
+                received.push_back(data);
+            });
+        connection->SetConnectionBrokenDelegate(
+            [this](bool)
+            {
+                std::lock_guard<decltype(mutex)> lock(mutex);
+                ++breaks;
+            });
+        firstDataReceivedDelegate = connection->GetDataReceivedDelegate();
+        firstBrokenDelegate = connection->GetBrokenDelegate();
+        connection->Attach(first);
+    }
+
+    /**
+     * This method sends CONNECT on the connection, and has the
+     * broker accept it.
+     *
+     * @param[in] connack
+     *      This is the CONNACK with which the broker accepts CONNECT.
+     * @param[in] sessionExpiry
+     *      This indicates whether or not CONNECT gives a non-zero
+     *      Session Expiry Interval.
+     */
+    void Establish(const Packet& connack = MakeConnack(false), bool sessionExpiry = true) {
+        connection->SendData(MakeConnect(sessionExpiry));
+        firstDataReceivedDelegate(connack);
+    }
+
+    /**
+     * This method waits for the connection to have made
+     * the given number of attempts to reconnect.
+     *
+     * @param[in] count
+     *      This is the number of attempts for which to wait.
+     * @return
+     *      The attempt made last, if there were enough of them, is
+     *      returned.  Otherwise a default attempt is returned.
+     */
+    Attempt AwaitAttempt(size_t count) {
+        std::unique_lock<decltype(mutex)> lock(mutex);
+        if (!wakeCondition.wait_for(lock, std::chrono::seconds(2),
+                                    [this, count] { return (attempts.size() >= count); }))
+        { return Attempt(); }
+        return attempts[count - 1];
+    }
+
+    /**
+     * This method returns the number of attempts made to reconnect.
+     *
+     * @return
+     *      The number of attempts made to reconnect is returned.
+     */
+    size_t CountAttempts() {
+        std::lock_guard<decltype(mutex)> lock(mutex);
+        return attempts.size();
+    }
+
+    /**
+     * This method breaks the first network connection, and completes
+     * the attempt to reconnect with the given network connection.
+     *
+     * @param[in] second
+     *      This is the network connection established.
+     * @return
+     *      The attempt to reconnect is returned.
+     */
+    Attempt Reconnect(const std::shared_ptr<FakeConnection>& second) {
+        firstBrokenDelegate(false);
+        const auto attempt = AwaitAttempt(1);
+        if (attempt.completionDelegate != nullptr)
+        { attempt.completionDelegate(second); }
+        return attempt;
+    }
+
+    /**
+     * This method establishes the session, breaks the first network
+     * connection, reconnects, and has the broker resume the session.
+     *
+     * @param[in] properties
+     *      These are the properties of the first CONNACK.
+     * @param[in] resumedProperties
+     *      These are the properties of the CONNACK resuming the session.
+     * @return
+     *      The second network connection is returned.
+     */
+    std::shared_ptr<FakeConnection> ResumeWithLimits(const Packet& properties,
+                                                     const Packet& resumedProperties) {
+        Establish(MakeConnack(false, properties));
+        const auto second = std::make_shared<FakeConnection>();
+        const auto attempt = Reconnect(second);
+        EXPECT_TRUE(attempt.dataReceivedDelegate != nullptr);
+        if (attempt.dataReceivedDelegate != nullptr)
+        { attempt.dataReceivedDelegate(MakeConnack(true, resumedProperties)); }
+        return second;
+    }
+
+    // ::testing::Test
+
+    virtual void SetUp() override {
+        MakeConnection(MqttNetworkTransport::ResumingConnection::Settings());
+    }
+
+    virtual void TearDown() override { connection = nullptr; }
+};
+
+TEST_F(ResumingConnectionTests, ResumedSessionSendsUnfinishedFlowsAgain) {
+    Establish();
+    connection->SendData(MakePublish(1, 7, 'a'));
+    connection->SendData(MakePublish(1, 8, 'b'));
+    firstDataReceivedDelegate(MakeAcknowledgement(PUBACK, 8));
+    connection->SendData(MakePublish(2, 9, 'c'));
+    firstDataReceivedDelegate(MakeAcknowledgement(PUBREC, 9));
+    connection->SendData(MakeAcknowledgement(PUBREL, 9));
+    EXPECT_EQ(5, first->GetSent().size());
+    firstBrokenDelegate(false);
+    connection->SendData(MakePublish(0, 0, 'g'));
+    const auto second = std::make_shared<FakeConnection>();
+    const auto attempt = AwaitAttempt(1);
+    ASSERT_TRUE(attempt.completionDelegate != nullptr);
+    attempt.completionDelegate(second);
+    auto resumingConnect = MakeConnect(true);
+    resumingConnect[9] = 0x00;
+    EXPECT_EQ(std::vector<Packet>{resumingConnect}, second->GetSent());
+    attempt.dataReceivedDelegate(MakeConnack(true));
+    auto duplicate = MakePublish(1, 7, 'a');
+    duplicate[0] |= 0x08;
+    EXPECT_EQ((std::vector<Packet>{resumingConnect, duplicate,
+                                   MakeAcknowledgement(PUBREL, 9), MakePublish(0, 0, 'g')}),
+              second->GetSent());
+    connection->SendData(MakePublish(0, 0, 'h'));
+    EXPECT_EQ(MakePublish(0, 0, 'h'), second->GetSent().back());
+    std::lock_guard<decltype(mutex)> lock(mutex);
+    EXPECT_EQ((std::vector<Packet>{MakeConnack(false), MakeAcknowledgement(PUBACK, 8),
+                                   MakeAcknowledgement(PUBREC, 9)}),
+              received);
+    EXPECT_EQ(std::vector<bool>{true}, outcomes);
+    EXPECT_EQ(0, breaks);
+}
+
+TEST_F(ResumingConnectionTests, SessionWithoutExpiryIsNotResumed) {
+    Establish(MakeConnack(false), false);
+    firstBrokenDelegate(false);
+    EXPECT_EQ(0, CountAttempts());
+    std::lock_guard<decltype(mutex)> lock(mutex);
+    EXPECT_EQ(1, breaks);
+}
+
+TEST_F(ResumingConnectionTests, SessionIsNotResumedWhenBrokerAllowsTopicAliases) {
+    Establish(MakeConnack(false, {0x22, 0, 10}));
+    connection->SendData(MakePublish(1, 7, 'a'));
+    firstBrokenDelegate(false);
+    EXPECT_EQ(0, CountAttempts());
+    std::lock_guard<decltype(mutex)> lock(mutex);
+    EXPECT_EQ(1, breaks);
+    EXPECT_TRUE(outcomes.empty());
+}
+
+TEST_F(ResumingConnectionTests, SessionIsResumedWhenLimitsAreKept) {
+    const auto second = ResumeWithLimits(LIMITS, {0x27, 0, 0, 0x10, 0, 0x21, 0, 20, 0x24, 1});
+    EXPECT_FALSE(second->IsBroken());
+    std::lock_guard<decltype(mutex)> lock(mutex);
+    EXPECT_EQ(std::vector<bool>{true}, outcomes);
+    EXPECT_EQ(0, breaks);
+}
+
+TEST_F(ResumingConnectionTests, ResumeFailsWhenReceiveMaximumChanges) {
+    const auto second = ResumeWithLimits(LIMITS, {0x21, 0, 10, 0x27, 0, 0, 0x10, 0});
+    EXPECT_TRUE(second->IsBroken());
+    std::lock_guard<decltype(mutex)> lock(mutex);
+    EXPECT_EQ(std::vector<bool>{false}, outcomes);
+    EXPECT_EQ(1, breaks);
+}
+
+TEST_F(ResumingConnectionTests, ResumeFailsWhenMaximumPacketSizeChanges) {
+    const auto second = ResumeWithLimits(LIMITS, {0x21, 0, 20});
+    EXPECT_TRUE(second->IsBroken());
+    std::lock_guard<decltype(mutex)> lock(mutex);
+    EXPECT_EQ(std::vector<bool>{false}, outcomes);
+    EXPECT_EQ(1, breaks);
+}
+
+TEST_F(ResumingConnectionTests, ResumeFailsWhenTopicAliasMaximumChanges) {
+    const auto second = ResumeWithLimits({}, {0x22, 0, 1});
+    EXPECT_TRUE(second->IsBroken());
+    std::lock_guard<decltype(mutex)> lock(mutex);
+    EXPECT_EQ(std::vector<bool>{false}, outcomes);
+    EXPECT_EQ(1, breaks);
+}
+
+TEST_F(ResumingConnectionTests, ResumeFailsWithoutSessionPresent) {
+    Establish();
+    const auto second = std::make_shared<FakeConnection>();
+    const auto attempt = Reconnect(second);
+    ASSERT_TRUE(attempt.dataReceivedDelegate != nullptr);
+    attempt.dataReceivedDelegate(MakeConnack(false));
+    EXPECT_TRUE(second->IsBroken());
+    std::lock_guard<decltype(mutex)> lock(mutex);
+    EXPECT_EQ(std::vector<bool>{false}, outcomes);
+    EXPECT_EQ(1, breaks);
+    EXPECT_EQ(std::vector<Packet>{MakeConnack(false)}, received);
+}
+
+TEST_F(ResumingConnectionTests, TooMuchHeldReportsBreak) {
+    TearDown();
+    MqttNetworkTransport::ResumingConnection::Settings settings;
+    settings.bufferBytes = 16;
+    MakeConnection(settings);
+    Establish();
+    firstBrokenDelegate(false);
+    (void)AwaitAttempt(1);
+    connection->SendData(MakePublish(0, 0, 'a'));
+    connection->SendData(MakePublish(0, 0, 'b'));
+    {
+        std::lock_guard<decltype(mutex)> lock(mutex);
+        EXPECT_EQ(0, breaks);
+    }
+    connection->SendData(MakePublish(0, 0, 'c'));
+    std::lock_guard<decltype(mutex)> lock(mutex);
+    EXPECT_EQ(1, breaks);
+    EXPECT_EQ(1, cancels);
+    EXPECT_EQ(std::vector<bool>{false}, outcomes);
+}
+
+TEST_F(ResumingConnectionTests, AttemptsAreSpacedByRetryDelay) {
+    TearDown();
+    MqttNetworkTransport::ResumingConnection::Settings settings;
+    settings.attempts = 3;
+    settings.retryDelay = std::chrono::milliseconds(100);
+    MakeConnection(settings);
+    Establish();
+    firstBrokenDelegate(false);
+    auto previous = AwaitAttempt(1);
+    ASSERT_TRUE(previous.completionDelegate != nullptr);
+    for (size_t count = 2; count <= 3; ++count)
+    {
+        previous.completionDelegate(nullptr);
+        EXPECT_EQ(count - 1, CountAttempts());
+        const auto next = AwaitAttempt(count);
+        ASSERT_TRUE(next.completionDelegate != nullptr);
+        EXPECT_GE(next.start - previous.start, std::chrono::milliseconds(100));
+        previous = next;
+    }
+    previous.completionDelegate(nullptr);
+    std::lock_guard<decltype(mutex)> lock(mutex);
+    EXPECT_EQ(3, attempts.size());
+    EXPECT_EQ(1, breaks);
+    EXPECT_EQ(std::vector<bool>{false}, outcomes);
+}
+
+TEST_F(ResumingConnectionTests, BreakWhileWaitingToRetryStopsRetrying) {
+    TearDown();
+    MqttNetworkTransport::ResumingConnection::Settings settings;
+    settings.retryDelay = std::chrono::milliseconds(100);
+    MakeConnection(settings);
+    Establish();
+    firstBrokenDelegate(false);
+    const auto attempt = AwaitAttempt(1);
+    ASSERT_TRUE(attempt.completionDelegate != nullptr);
+    attempt.completionDelegate(nullptr);
+    connection->Break(true);
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    std::lock_guard<decltype(mutex)> lock(mutex);
+    EXPECT_EQ(1, attempts.size());
+    EXPECT_EQ(1, breaks);
+}
+
+TEST_F(ResumingConnectionTests, DisconnectEndsSession) {
+    Establish();
+    connection->SendData(Packet{0xE0, 0});
+    firstBrokenDelegate(true);
+    EXPECT_EQ(0, CountAttempts());
+    std::lock_guard<decltype(mutex)> lock(mutex);
+    EXPECT_EQ(1, breaks);
+}
@@ -0,0 +1,433 @@
+/**
+ * @file SharedMemoryNetworkConnectionTests.cpp
+ *
+ * This module contains the unit tests of the
+ * MqttNetworkTransport::SharedMemoryNetworkConnection class.
+ *
+ * © 2025 by Hatem Nabli
+ */
+
+#include <gtest/gtest.h>
+#include <EventLoopPool.hpp>
+#include <SharedMemoryNetworkConnection.hpp>
+#include <SharedMemoryRing.hpp>
+#include <SocketAddress.hpp>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <poll.h>
+#include <stdint.h>
+#include <string.h>
+#include <string>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+namespace
+{
+    /**
+     * This is the number of bytes of data each ring holds,
+     * small enough for both sides to fill their rings.
+     */
+    constexpr size_t RING_CAPACITY = 4096;
+
+    /**
+     * This is how long to wait for something expected to happen.
+     */
+    constexpr std::chrono::seconds TIMEOUT(5);
+
+    /**
+     * This is a stand-in for a broker accepting "shm" connections,
+     * which echoes back what it receives.
+     */
+    class Peer
+    {
+    public:
+        /**
+         * These are the ways the peer can behave.
+         */
+        enum class Behavior
+        {
+            /**
+             * The peer accepts the connection and echoes data.
+             */
+            Echo,
+
+            /**
+             * The peer rejects the connection.
+             */
+            Reject,
+
+            /**
+             * The peer accepts the connection, and then claims to
+             * have written more than its ring holds.
+             */
+            Corrupt,
+        };
+
+        /**
+         * This is the constructor, which starts listening at an
+         * address in the Linux abstract namespace.
+         *
+         * @param[in] behavior
+         *      This is how the peer behaves.
+         */
+        explicit Peer(Behavior behavior) :
+            behavior_(behavior),
+            path_("@MqttNetworkTransportTests-" + std::to_string(getpid()) + "-" +
+                  std::to_string(nextId_++)) {
+            listener_ = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+            const auto address = MqttNetworkTransport::SocketAddress::FromUnixPath(path_);
+            if ((bind(listener_, address.Get(), address.length) == 0) &&
+                (listen(listener_, 1) == 0))
+            { thread_ = std::thread(&Peer::Run, this); }
+        }
+
+        /**
+         * This is the destructor, which stops the peer.
+         */
+        ~Peer() noexcept {
+            stop_ = true;
+            (void)shutdown(listener_, SHUT_RDWR);
+            if (thread_.joinable())
+            { thread_.join(); }
+            (void)close(listener_);
+        }
+
+        /**
+         * This method returns the path at which the peer listens.
+         *
+         * @return
+         *      The path at which the peer listens is returned.
+         */
+        const std::string& GetPath() const { return path_; }
+
+        /**
+         * These are what the peer found in the handshake.
+         */
+        std::atomic<bool> magicMatched{false};
+        std::atomic<uint32_t> capacity{0};
+        std::atomic<size_t> descriptorCount{0};
+
+    private:
+        /**
+         * This method is the body of the thread of the peer, which
+         * accepts one connection and serves it.
+         */
+        void Run() {
+            const int sock = accept(listener_, nullptr, nullptr);
+            if (sock < 0)
+            { return; }
+            int fds[3] = {-1, -1, -1};
+            if (Handshake(sock, fds))
+            { Serve(sock, fds); }
+            for (auto fd : fds)
+            {
+                if (fd >= 0)
+                { (void)close(fd); }
+            }
+            (void)close(sock);
+        }
+
+        /**
+         * This method receives the handshake of the connection and
+         * replies to it.
+         *
+         * @param[in] sock
+         *      This is the socket connected to the client.
+         * @param[out] fds
+         *      This is where to store the memory file and the eventfd
+         *      objects received.
+         * @return
+         *      An indication of whether or not the connection
+         *      was accepted is returned.
+         */
+        bool Handshake(int sock, int fds[3]) {
+            uint8_t request[12];
+            struct iovec vector;
+            vector.iov_base = request;
+            vector.iov_len = sizeof(request);
+            union
+            {
+                struct cmsghdr header;
+                char buffer[CMSG_SPACE(3 * sizeof(int))];
+            } control;
+            struct msghdr header;
+            (void)memset(&header, 0, sizeof(header));
+            header.msg_iov = &vector;
+            header.msg_iovlen = 1;
+            header.msg_control = control.buffer;
+            header.msg_controllen = sizeof(control.buffer);
+            if (recvmsg(sock, &header, 0) != (ssize_t)sizeof(request))
+            { return false; }
+            magicMatched = (memcmp(request, "MQTTSHM1", 8) == 0);
+            uint32_t ringCapacity;
+            (void)memcpy(&ringCapacity, request + 8, sizeof(ringCapacity));
+            capacity = ringCapacity;
+            const auto rights = CMSG_FIRSTHDR(&header);
+            if ((rights != nullptr) && (rights->cmsg_type == SCM_RIGHTS))
+            {
+                descriptorCount = (rights->cmsg_len - CMSG_LEN(0)) / sizeof(int);
+                (void)memcpy(fds, CMSG_DATA(rights),
+                             std::min((size_t)descriptorCount, (size_t)3) * sizeof(int));
+            }
+            const uint8_t reply = ((behavior_ == Behavior::Reject) ? 0 : 1);
+            (void)send(sock, &reply, sizeof(reply), MSG_NOSIGNAL);
+            return (reply == 1) && (descriptorCount == 3);
+        }
+
+        /**
+         * This method serves an accepted connection until the
+         * client closes it.
+         *
+         * @param[in] sock
+         *      This is the socket connected to the client.
+         * @param[in] fds
+         *      These are the memory file and the eventfd objects
+         *      received in the handshake.
+         */
+        void Serve(int sock, const int fds[3]) {
+            const auto ringSize = MqttNetworkTransport::SharedMemoryRing::GetSize(capacity);
+            const auto memory =
+                mmap(nullptr, 2 * ringSize, PROT_READ | PROT_WRITE, MAP_SHARED, fds[0], 0);
+            if (memory == MAP_FAILED)
+            { return; }
+            MqttNetworkTransport::SharedMemoryRing in(memory, capacity, false);
+            MqttNetworkTransport::SharedMemoryRing out((uint8_t*)memory + ringSize, capacity,
+                                                       false);
+            const int waitFd = fds[1];
+            const int signalFd = fds[2];
+            const uint64_t increment = 1;
+            if (behavior_ == Behavior::Corrupt)
+            {
+                const uint64_t head = 2 * capacity;
+                (void)memcpy((uint8_t*)memory + ringSize, &head, sizeof(head));
+                (void)write(signalFd, &increment, sizeof(increment));
+            }
+            std::vector<uint8_t> pending;
+            std::vector<uint8_t> buffer(capacity);
+            while (!stop_)
+            {
+                bool progress = false;
+                const auto available = std::min(in.GetAvailable(), buffer.size());
+                if (available > 0)
+                {
+                    in.Read(buffer.data(), available);
+                    if (in.ShouldWakeProducer())
+                    { (void)write(signalFd, &increment, sizeof(increment)); }
+                    (void)pending.insert(pending.end(), buffer.begin(),
+                                         buffer.begin() + available);
+                    progress = true;
+                }
+                if (!pending.empty() && (behavior_ == Behavior::Echo))
+                {
+                    const auto written = out.Write(pending.data(), pending.size());
+                    if (written > 0)
+                    {
+                        (void)pending.erase(pending.begin(), pending.begin() + written);
+                        if (out.ShouldWakeConsumer())
+                        { (void)write(signalFd, &increment, sizeof(increment)); }
+                        progress = true;
+                    }
+                }
+                if (progress)
+                { continue; }
+                const bool waitForData = in.PrepareToWaitForData();
+                const bool waitForSpace = (pending.empty() || out.PrepareToWaitForSpace());
+                if (!waitForData || !waitForSpace)
+                { continue; }
+                struct pollfd events[2] = {{waitFd, POLLIN, 0}, {sock, POLLIN | POLLRDHUP, 0}};
+                if (poll(events, 2, 100) <= 0)
+                { continue; }
+                if (events[0].revents != 0)
+                {
+                    uint64_t count;
+                    (void)read(waitFd, &count, sizeof(count));
+                }
+                if (events[1].revents != 0)
+                { break; }
+            }
+            (void)munmap(memory, 2 * ringSize);
+        }
+
+        /**
+         * This is used to give each peer an address of its own.
+         */
+        static std::atomic<unsigned> nextId_;
+
+        /**
+         * This is how the peer behaves.
+         */
+        Behavior behavior_;
+
+        /**
+         * This is the path at which the peer listens.
+         */
+        std::string path_;
+
+        /**
+         * This is the socket on which the peer listens.
+         */
+        int listener_ = -1;
+
+        /**
+         * This is the thread of the peer.
+         */
+        std::thread thread_;
+
+        /**
+         * This is set to make the thread of the peer stop.
+         */
+        std::atomic<bool> stop_{false};
+    };
+
+    std::atomic<unsigned> Peer::nextId_{0};
+}  // namespace
+
+/**
+ * This is the test fixture for these tests, providing the event loops
+ * and a connection, and collecting what the connection delivers.
+ */
+struct SharedMemoryNetworkConnectionTests : public ::testing::Test
+{
+    // Properties
+
+    /**
+     * This is the pool of event loops serving the connection.
+     */
+    std::shared_ptr<MqttNetworkTransport::EventLoopPool> eventLoopPool =
+        std::make_shared<MqttNetworkTransport::EventLoopPool>(1);
+
+    /**
+     * This is the connection under test.
+     */
+    std::shared_ptr<MqttNetworkTransport::SharedMemoryNetworkConnection> connection =
+        std::make_shared<MqttNetworkTransport::SharedMemoryNetworkConnection>(
+            eventLoopPool, 1000, std::chrono::microseconds(0));
+
+    /**
+     * This is used to synchronize access to what the connection delivers.
+     */
+    std::mutex mutex;
+
+    /**
+     * This is used to wait for the connection to deliver something.
+     */
+    std::condition_variable condition;
+
+    /**
+     * This is the data received on the connection.
+     */
+    std::vector<uint8_t> received;
+
+    /**
+     * This indicates whether or not the connection was broken.
+     */
+    bool broken = false;
+
+    /**
+     * This indicates whether or not the connection was
+     * broken gracefully.
+     */
+    bool graceful = false;
+
+    // Methods
+
+    /**
+     * This method connects the connection to the given peer,
+     * and starts processing it.
+     *
+     * @param[in] peer
+     *      This is the peer to which to connect.
+     * @return
+     *      An indication of whether or not the connection
+     *      was established is returned.
+     */
+    bool Connect(const Peer& peer) {
+        connection->SetPeerSocketAddress(
+            MqttNetworkTransport::SocketAddress::FromUnixPath(peer.GetPath()));
+        if (!connection->Connect(0, 0))
+        { return false; }
+        return connection->Process(
+            [this](const std::vector<uint8_t>& message)
+            {
+                std::lock_guard<decltype(mutex)> lock(mutex);
+                (void)received.insert(received.end(), message.begin(), message.end());
+                condition.notify_all();
+            },
+            [this](bool wasGraceful)
+            {
+                std::lock_guard<decltype(mutex)> lock(mutex);
+                broken = true;
+                graceful = wasGraceful;
+                condition.notify_all();
+            });
+    }
+
+    // ::testing::Test
+
+    virtual void TearDown() override {
+        connection->Close(false);
+        connection.reset();
+        eventLoopPool.reset();
+    }
+};
+
+TEST_F(SharedMemoryNetworkConnectionTests, HandshakeHandsOverMemoryAndEventObjects) {
+    Peer peer(Peer::Behavior::Echo);
+    ASSERT_TRUE(Connect(peer));
+    EXPECT_TRUE(connection->IsConnected());
+    EXPECT_TRUE(peer.magicMatched);
+    EXPECT_EQ(RING_CAPACITY, peer.capacity);
+    EXPECT_EQ(3, peer.descriptorCount);
+}
+
+TEST_F(SharedMemoryNetworkConnectionTests, EchoKeepsOrderThroughFullRings) {
+    Peer peer(Peer::Behavior::Echo);
+    ASSERT_TRUE(Connect(peer));
+    std::vector<uint8_t> sent;
+    for (size_t i = 0; i < 300; ++i)
+    {
+        std::vector<uint8_t> message(10000);
+        for (size_t j = 0; j < message.size(); ++j)
+        { message[j] = (uint8_t)(i * 31 + j); }
+        (void)sent.insert(sent.end(), message.begin(), message.end());
+        connection->SendMessage(message);
+    }
+    std::unique_lock<decltype(mutex)> lock(mutex);
+    ASSERT_TRUE(
+        condition.wait_for(lock, TIMEOUT, [this, &sent] { return received.size() >= sent.size(); }));
+    EXPECT_EQ(sent, received);
+    EXPECT_FALSE(broken);
+}
+
+TEST_F(SharedMemoryNetworkConnectionTests, ManySmallRoundTrips) {
+    Peer peer(Peer::Behavior::Echo);
+    ASSERT_TRUE(Connect(peer));
+    for (size_t i = 0; i < 1000; ++i)
+    {
+        connection->SendMessage(std::vector<uint8_t>{(uint8_t)i, 0x42});
+        std::unique_lock<decltype(mutex)> lock(mutex);
+        ASSERT_TRUE(condition.wait_for(lock, TIMEOUT, [this] { return received.size() >= 2; }));
+        EXPECT_EQ(std::vector<uint8_t>({(uint8_t)i, 0x42}), received);
+        received.clear();
+    }
+}
+
+TEST_F(SharedMemoryNetworkConnectionTests, RejectedHandshakeFailsConnect) {
+    Peer peer(Peer::Behavior::Reject);
+    EXPECT_FALSE(Connect(peer));
+    EXPECT_FALSE(connection->IsConnected());
+}
+
+TEST_F(SharedMemoryNetworkConnectionTests, CorruptRingBreaksConnection) {
+    Peer peer(Peer::Behavior::Corrupt);
+    ASSERT_TRUE(Connect(peer));
+    std::unique_lock<decltype(mutex)> lock(mutex);
+    ASSERT_TRUE(condition.wait_for(lock, TIMEOUT, [this] { return broken; }));
+    EXPECT_FALSE(graceful);
+    EXPECT_TRUE(received.empty());
+}
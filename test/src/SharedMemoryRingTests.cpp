@@ -0,0 +1,232 @@
+/**
+ * @file SharedMemoryRingTests.cpp
+ *
+ * This module contains the unit tests of the
+ * MqttNetworkTransport::SharedMemoryRing class.
+ *
+ * © 2025 by Hatem Nabli
+ */
+
+#include <gtest/gtest.h>
+#include <SharedMemoryRing.hpp>
+#include <stdint.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    /**
+     * This is the number of bytes of data held by the rings
+     * in the tests, unless a test says otherwise.
+     */
+    constexpr size_t CAPACITY = 64;
+
+    /**
+     * These are the offsets in the header of a ring of the total
+     * numbers of bytes ever written and read.
+     */
+    constexpr size_t HEAD_OFFSET = 0;
+    constexpr size_t TAIL_OFFSET = 64;
+}  // namespace
+
+/**
+ * This is the test fixture for these tests, providing a ring made in
+ * memory mapped the way it is when shared with another process, and
+ * seen separately by its producer and its consumer.
+ */
+struct SharedMemoryRingTests : public ::testing::Test
+{
+    // Properties
+
+    /**
+     * This is the memory holding the ring.
+     */
+    void* memory = MAP_FAILED;
+
+    /**
+     * This is the number of bytes of memory holding the ring.
+     */
+    size_t memorySize = 0;
+
+    /**
+     * These are the producer's and the consumer's views of the ring.
+     */
+    std::unique_ptr<MqttNetworkTransport::SharedMemoryRing> producer;
+    std::unique_ptr<MqttNetworkTransport::SharedMemoryRing> consumer;
+
+    // Methods
+
+    /**
+     * This method makes the ring, holding the given number of bytes.
+     *
+     * @param[in] capacity
+     *      This is the number of bytes of data the ring holds.
+     */
+    void MakeRing(size_t capacity) {
+        memorySize = MqttNetworkTransport::SharedMemoryRing::GetSize(capacity);
+        memory = mmap(nullptr, memorySize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS,
+                      -1, 0);
+        ASSERT_NE(MAP_FAILED, memory);
+        producer.reset(new MqttNetworkTransport::SharedMemoryRing(memory, capacity, true));
+        consumer.reset(new MqttNetworkTransport::SharedMemoryRing(memory, capacity, false));
+    }
+
+    /**
+     * This method overwrites one of the counts in the header of the
+     * ring, as a misbehaving peer could.
+     *
+     * @param[in] offset
+     *      This is the offset of the count in the header.
+     * @param[in] value
+     *      This is the value to store.
+     */
+    void SetCount(size_t offset, uint64_t value) {
+        (void)memcpy((uint8_t*)memory + offset, &value, sizeof(value));
+    }
+
+    // ::testing::Test
+
+    virtual void SetUp() override { MakeRing(CAPACITY); }
+
+    virtual void TearDown() override {
+        producer.reset();
+        consumer.reset();
+        if (memory != MAP_FAILED)
+        { (void)munmap(memory, memorySize); }
+    }
+};
+
+TEST_F(SharedMemoryRingTests, DataComesOutInOrderAcrossTheWrap) {
+    uint8_t next = 0;
+    uint8_t expected = 0;
+    for (size_t round = 0; round < 100; ++round)
+    {
+        const size_t size = 1 + (round * 7) % CAPACITY;
+        std::vector<uint8_t> data(size);
+        for (auto& byte : data)
+        { byte = next++; }
+        ASSERT_EQ(size, producer->Write(data.data(), data.size()));
+        ASSERT_EQ(size, consumer->GetAvailable());
+        std::vector<uint8_t> received(size);
+        consumer->Read(received.data(), received.size());
+        for (auto byte : received)
+        { ASSERT_EQ(expected++, byte); }
+        EXPECT_EQ(0, consumer->GetAvailable());
+    }
+}
+
+TEST_F(SharedMemoryRingTests, WriteStopsWhenFull) {
+    const std::vector<uint8_t> data(CAPACITY + 10, 0x5A);
+    EXPECT_EQ(CAPACITY, producer->Write(data.data(), data.size()));
+    EXPECT_EQ(0, producer->Write(data.data(), data.size()));
+    std::vector<uint8_t> received(10);
+    ASSERT_EQ(CAPACITY, consumer->GetAvailable());
+    consumer->Read(received.data(), received.size());
+    EXPECT_EQ(10, producer->Write(data.data(), data.size()));
+    EXPECT_FALSE(producer->IsCorrupt());
+    EXPECT_FALSE(consumer->IsCorrupt());
+}
+
+TEST_F(SharedMemoryRingTests, ConsumerSleepsOnlyWhenEmpty) {
+    const uint8_t data[3] = {1, 2, 3};
+    EXPECT_FALSE(producer->ShouldWakeConsumer());
+    EXPECT_TRUE(consumer->PrepareToWaitForData());
+    ASSERT_EQ(sizeof(data), producer->Write(data, sizeof(data)));
+    EXPECT_TRUE(producer->ShouldWakeConsumer());
+    EXPECT_FALSE(producer->ShouldWakeConsumer());
+    EXPECT_FALSE(consumer->PrepareToWaitForData());
+    EXPECT_FALSE(producer->ShouldWakeConsumer());
+    EXPECT_EQ(sizeof(data), consumer->GetAvailable());
+}
+
+TEST_F(SharedMemoryRingTests, ProducerSleepsOnlyWhenFull) {
+    const std::vector<uint8_t> data(CAPACITY, 0xA5);
+    EXPECT_FALSE(producer->PrepareToWaitForSpace());
+    ASSERT_EQ(CAPACITY, producer->Write(data.data(), data.size()));
+    EXPECT_TRUE(producer->PrepareToWaitForSpace());
+    std::vector<uint8_t> received(1);
+    ASSERT_EQ(CAPACITY, consumer->GetAvailable());
+    consumer->Read(received.data(), received.size());
+    EXPECT_TRUE(consumer->ShouldWakeProducer());
+    EXPECT_FALSE(consumer->ShouldWakeProducer());
+    EXPECT_FALSE(producer->PrepareToWaitForSpace());
+}
+
+TEST_F(SharedMemoryRingTests, ReadIsLimitedToWhatIsAvailable) {
+    const uint8_t data[4] = {1, 2, 3, 4};
+    ASSERT_EQ(sizeof(data), producer->Write(data, sizeof(data)));
+    ASSERT_EQ(sizeof(data), consumer->GetAvailable());
+    std::vector<uint8_t> received(CAPACITY * 2, 0);
+    consumer->Read(received.data(), received.size());
+    EXPECT_EQ(std::vector<uint8_t>({1, 2, 3, 4, 0}),
+              std::vector<uint8_t>(received.begin(), received.begin() + 5));
+    EXPECT_EQ(0, consumer->GetAvailable());
+    EXPECT_EQ(CAPACITY, producer->Write(received.data(), received.size()));
+}
+
+TEST_F(SharedMemoryRingTests, TooMuchWrittenMakesRingCorrupt) {
+    SetCount(HEAD_OFFSET, CAPACITY + 1);
+    EXPECT_EQ(0, consumer->GetAvailable());
+    EXPECT_TRUE(consumer->IsCorrupt());
+    EXPECT_TRUE(consumer->PrepareToWaitForData());
+    SetCount(HEAD_OFFSET, 1);
+    EXPECT_EQ(0, consumer->GetAvailable());
+}
+
+TEST_F(SharedMemoryRingTests, TooMuchReadMakesRingCorrupt) {
+    const std::vector<uint8_t> data(CAPACITY, 0);
+    ASSERT_EQ(CAPACITY, producer->Write(data.data(), data.size()));
+    SetCount(TAIL_OFFSET, CAPACITY + 1);
+    EXPECT_EQ(0, producer->Write(data.data(), data.size()));
+    EXPECT_TRUE(producer->IsCorrupt());
+    EXPECT_TRUE(producer->PrepareToWaitForSpace());
+    SetCount(TAIL_OFFSET, CAPACITY);
+    EXPECT_EQ(0, producer->Write(data.data(), data.size()));
+}
+
+TEST_F(SharedMemoryRingTests, SingleProducerSingleConsumerKeepOrder) {
+    TearDown();
+    MakeRing(4096);
+    constexpr size_t total = 16 * 1048576;
+    std::thread producerThread(
+        [this]
+        {
+            std::vector<uint8_t> data(1000);
+            size_t written = 0;
+            while (written < total)
+            {
+                const auto size = std::min(data.size(), total - written);
+                for (size_t i = 0; i < size; ++i)
+                { data[i] = (uint8_t)((written + i) % 251); }
+                size_t offset = 0;
+                while (offset < size)
+                {
+                    offset += producer->Write(data.data() + offset, size - offset);
+                    if (offset < size)
+                    { std::this_thread::yield(); }
+                }
+                written += size;
+            }
+        });
+    std::vector<uint8_t> received(777);
+    size_t read = 0;
+    bool inOrder = true;
+    while (read < total)
+    {
+        const auto size = std::min(consumer->GetAvailable(), received.size());
+        if (size == 0)
+        {
+            std::this_thread::yield();
+            continue;
+        }
+        consumer->Read(received.data(), size);
+        for (size_t i = 0; i < size; ++i)
+        { inOrder = (inOrder && (received[i] == (uint8_t)((read + i) % 251))); }
+        read += size;
+    }
+    producerThread.join();
+    EXPECT_TRUE(inOrder);
+    EXPECT_FALSE(consumer->IsCorrupt());
+}
@@ -0,0 +1,122 @@
+/**
+ * @file WebSocketDeflateTests.cpp
+ *
+ * This module contains the unit tests of the
+ * MqttNetworkTransport::WebSocketDeflate class.
+ *
+ * © 2025 by Hatem Nabli
+ */
+
+#include <gtest/gtest.h>
+#include <WebSocketDeflate.hpp>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+namespace
+{
+    /**
+     * This is the most bytes to which the messages in the tests
+     * may decompress, unless a test says otherwise.
+     */
+    constexpr size_t MAXIMUM_MESSAGE_SIZE = 1048576;
+
+    /**
+     * This function makes a payload of the given size which
+     * compresses well, as JSON telemetry does.
+     *
+     * @param[in] size
+     *      This is the number of bytes of payload.
+     * @return
+     *      The payload is returned.
+     */
+    std::vector<uint8_t> MakePayload(size_t size) {
+        const std::string pattern = "{\"sensor\":\"temperature\",\"value\":21.5},";
+        std::vector<uint8_t> payload(size);
+        for (size_t i = 0; i < size; ++i)
+        { payload[i] = (uint8_t)pattern[i % pattern.size()]; }
+        return payload;
+    }
+}  // namespace
+
+TEST(WebSocketDeflateTests, RoundTrip) {
+    MqttNetworkTransport::WebSocketDeflate sender(6, 15, true, true, MAXIMUM_MESSAGE_SIZE);
+    MqttNetworkTransport::WebSocketDeflate receiver(6, 15, true, true, MAXIMUM_MESSAGE_SIZE);
+    ASSERT_TRUE(sender.IsReady());
+    ASSERT_TRUE(receiver.IsReady());
+    for (size_t size : {1, 100, 5000, 200000})
+    {
+        const auto payload = MakePayload(size);
+        std::vector<uint8_t> compressed;
+        ASSERT_TRUE(sender.Compress(payload.data(), payload.size(), compressed));
+        std::vector<uint8_t> decompressed;
+        ASSERT_TRUE(receiver.Decompress(compressed.data(), compressed.size(), false,
+                                        decompressed));
+        ASSERT_TRUE(receiver.Decompress(nullptr, 0, true, decompressed));
+        EXPECT_EQ(payload, decompressed) << "size " << size;
+    }
+}
+
+TEST(WebSocketDeflateTests, ContextTakeoverShrinksRepeatedMessages) {
+    MqttNetworkTransport::WebSocketDeflate withTakeover(6, 15, true, true,
+                                                        MAXIMUM_MESSAGE_SIZE);
+    MqttNetworkTransport::WebSocketDeflate withoutTakeover(6, 15, false, true,
+                                                           MAXIMUM_MESSAGE_SIZE);
+    const auto payload = MakePayload(300);
+    std::vector<uint8_t> first, second, fresh;
+    ASSERT_TRUE(withTakeover.Compress(payload.data(), payload.size(), first));
+    ASSERT_TRUE(withTakeover.Compress(payload.data(), payload.size(), second));
+    ASSERT_TRUE(withoutTakeover.Compress(payload.data(), payload.size(), fresh));
+    ASSERT_TRUE(withoutTakeover.Compress(payload.data(), payload.size(), fresh));
+    EXPECT_LT(second.size(), first.size());
+    EXPECT_EQ(first.size(), fresh.size());
+}
+
+TEST(WebSocketDeflateTests, MessageDecompressingPastMaximumIsMalformed) {
+    constexpr size_t maximumMessageSize = 65536;
+    MqttNetworkTransport::WebSocketDeflate sender(9, 15, true, true, MAXIMUM_MESSAGE_SIZE);
+    MqttNetworkTransport::WebSocketDeflate receiver(6, 15, true, true, maximumMessageSize);
+    const std::vector<uint8_t> bomb(16 * maximumMessageSize, 0);
+    std::vector<uint8_t> compressed;
+    ASSERT_TRUE(sender.Compress(bomb.data(), bomb.size(), compressed));
+    ASSERT_LT(compressed.size(), maximumMessageSize / 16);
+    std::vector<uint8_t> decompressed;
+    EXPECT_FALSE(
+        receiver.Decompress(compressed.data(), compressed.size(), false, decompressed));
+    EXPECT_LE(decompressed.size(), 2 * maximumMessageSize);
+}
+
+TEST(WebSocketDeflateTests, MaximumAppliesToEachMessage) {
+    constexpr size_t maximumMessageSize = 4096;
+    MqttNetworkTransport::WebSocketDeflate sender(6, 15, true, true, MAXIMUM_MESSAGE_SIZE);
+    MqttNetworkTransport::WebSocketDeflate receiver(6, 15, true, true, maximumMessageSize);
+    const auto payload = MakePayload(maximumMessageSize);
+    std::vector<uint8_t> decompressed;
+    for (int i = 0; i < 4; ++i)
+    {
+        std::vector<uint8_t> compressed;
+        ASSERT_TRUE(sender.Compress(payload.data(), payload.size(), compressed));
+        const auto half = compressed.size() / 2;
+        ASSERT_TRUE(receiver.Decompress(compressed.data(), half, false, decompressed));
+        ASSERT_TRUE(receiver.Decompress(compressed.data() + half, compressed.size() - half,
+                                        false, decompressed));
+        ASSERT_TRUE(receiver.Decompress(nullptr, 0, true, decompressed));
+    }
+    EXPECT_EQ(4 * maximumMessageSize, decompressed.size());
+}
+
+TEST(WebSocketDeflateTests, UnsupportedWindowSizeIsNotReady) {
+    MqttNetworkTransport::WebSocketDeflate tooSmall(6, 8, true, true, MAXIMUM_MESSAGE_SIZE);
+    MqttNetworkTransport::WebSocketDeflate tooLarge(6, 16, true, true, MAXIMUM_MESSAGE_SIZE);
+    MqttNetworkTransport::WebSocketDeflate smallest(6, 9, true, true, MAXIMUM_MESSAGE_SIZE);
+    EXPECT_FALSE(tooSmall.IsReady());
+    EXPECT_FALSE(tooLarge.IsReady());
+    EXPECT_TRUE(smallest.IsReady());
+}
+
+TEST(WebSocketDeflateTests, CorruptDataIsMalformed) {
+    MqttNetworkTransport::WebSocketDeflate receiver(6, 15, true, true, MAXIMUM_MESSAGE_SIZE);
+    const std::vector<uint8_t> garbage{0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
+    std::vector<uint8_t> decompressed;
+    EXPECT_FALSE(receiver.Decompress(garbage.data(), garbage.size(), false, decompressed));
+}
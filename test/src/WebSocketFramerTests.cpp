@@ -0,0 +1,251 @@
+/**
+ * @file WebSocketFramerTests.cpp
+ *
+ * This module contains the unit tests of the
+ * MqttNetworkTransport::WebSocketFramer class.
+ *
+ * © 2025 by Hatem Nabli
+ */
+
+#include <gtest/gtest.h>
+#include <WebSocketFramer.hpp>
+#include <set>
+#include <stdint.h>
+#include <vector>
+
+namespace
+{
+    /**
+     * This function makes an unmasked frame, as a server sends.
+     *
+     * @param[in] firstByte
+     *      This is the first byte of the frame: FIN, RSV and opcode.
+     * @param[in] payload
+     *      This is the payload of the frame.
+     * @return
+     *      The frame is returned.
+     */
+    std::vector<uint8_t> MakeServerFrame(uint8_t firstByte, const std::vector<uint8_t>& payload) {
+        std::vector<uint8_t> frame{firstByte};
+        if (payload.size() < 126)
+        { frame.push_back((uint8_t)payload.size()); } else if (payload.size() <= 0xFFFF)
+        {
+            frame.push_back(126);
+            frame.push_back((uint8_t)(payload.size() >> 8));
+            frame.push_back((uint8_t)payload.size());
+        } else
+        {
+            frame.push_back(127);
+            for (int shift = 56; shift >= 0; shift -= 8)
+            { frame.push_back((uint8_t)((uint64_t)payload.size() >> shift)); }
+        }
+        frame.insert(frame.end(), payload.begin(), payload.end());
+        return frame;
+    }
+
+    /**
+     * This function makes a payload of the given size
+     * with bytes which vary.
+     *
+     * @param[in] size
+     *      This is the number of bytes of payload.
+     * @return
+     *      The payload is returned.
+     */
+    std::vector<uint8_t> MakePayload(size_t size) {
+        std::vector<uint8_t> payload(size);
+        for (size_t i = 0; i < size; ++i)
+        { payload[i] = (uint8_t)(i * 7 + 3); }
+        return payload;
+    }
+
+    /**
+     * This function parses a frame made by the framer, unmasking it.
+     *
+     * @param[in] frame
+     *      This is the frame to parse.
+     * @param[out] firstByte
+     *      This is where to store the first byte of the frame.
+     * @param[out] key
+     *      This is where to store the masking key of the frame.
+     * @return
+     *      The unmasked payload of the frame is returned.
+     */
+    std::vector<uint8_t> ParseClientFrame(const std::vector<uint8_t>& frame, uint8_t& firstByte,
+                                          uint32_t& key) {
+        firstByte = frame[0];
+        EXPECT_NE(0, frame[1] & 0x80);
+        uint64_t length = (frame[1] & 0x7F);
+        size_t offset = 2;
+        if (length == 126)
+        {
+            length = ((uint64_t)frame[2] << 8) | frame[3];
+            offset = 4;
+        } else if (length == 127)
+        {
+            length = 0;
+            for (size_t i = 2; i < 10; ++i)
+            { length = (length << 8) | frame[i]; }
+            offset = 10;
+        }
+        const uint8_t* maskingKey = &frame[offset];
+        key = ((uint32_t)maskingKey[0] << 24) | ((uint32_t)maskingKey[1] << 16) |
+              ((uint32_t)maskingKey[2] << 8) | maskingKey[3];
+        offset += 4;
+        EXPECT_EQ(offset + length, frame.size());
+        std::vector<uint8_t> payload(frame.begin() + offset, frame.end());
+        for (size_t i = 0; i < payload.size(); ++i)
+        { payload[i] ^= maskingKey[i % 4]; }
+        return payload;
+    }
+}  // namespace
+
+TEST(WebSocketFramerTests, MaskMatchesBytewiseMasking) {
+    const uint8_t key[4] = {0x12, 0x34, 0x56, 0x78};
+    for (const size_t size : {0, 1, 3, 4, 15, 16, 17, 31, 32, 33, 63, 64, 65, 1000, 4099})
+    {
+        const auto input = MakePayload(size);
+        std::vector<uint8_t> output(size);
+        MqttNetworkTransport::WebSocketFramer::Mask(input.data(), output.data(), size, key);
+        for (size_t i = 0; i < size; ++i)
+        { ASSERT_EQ((uint8_t)(input[i] ^ key[i % 4]), output[i]) << "size " << size; }
+    }
+}
+
+TEST(WebSocketFramerTests, EncodeUsesEveryLengthForm) {
+    MqttNetworkTransport::WebSocketFramer framer;
+    for (const size_t size : {0, 125, 126, 65535, 65536})
+    {
+        const auto payload = MakePayload(size);
+        std::vector<uint8_t> frame;
+        framer.Encode(MqttNetworkTransport::WebSocketFramer::OPCODE_BINARY, payload.data(),
+                      payload.size(), frame);
+        uint8_t firstByte;
+        uint32_t key;
+        EXPECT_EQ(payload, ParseClientFrame(frame, firstByte, key)) << "size " << size;
+        EXPECT_EQ(0x82, firstByte);
+    }
+}
+
+TEST(WebSocketFramerTests, EncodeMarksCompressedFrames) {
+    MqttNetworkTransport::WebSocketFramer framer;
+    const auto payload = MakePayload(10);
+    std::vector<uint8_t> frame;
+    framer.Encode(MqttNetworkTransport::WebSocketFramer::OPCODE_BINARY, payload.data(),
+                  payload.size(), frame, true);
+    uint8_t firstByte;
+    uint32_t key;
+    (void)ParseClientFrame(frame, firstByte, key);
+    EXPECT_EQ(0xC2, firstByte);
+}
+
+TEST(WebSocketFramerTests, MaskingKeysVary) {
+    MqttNetworkTransport::WebSocketFramer framer;
+    std::set<uint32_t> keys;
+    const uint8_t payload[1] = {0};
+    for (size_t i = 0; i < 1000; ++i)
+    {
+        std::vector<uint8_t> frame;
+        framer.Encode(MqttNetworkTransport::WebSocketFramer::OPCODE_BINARY, payload, 1, frame);
+        uint8_t firstByte;
+        uint32_t key;
+        (void)ParseClientFrame(frame, firstByte, key);
+        (void)keys.insert(key);
+    }
+    EXPECT_GT(keys.size(), 990u);
+}
+
+TEST(WebSocketFramerTests, DecodeDataFramesSplitAnywhere) {
+    const auto first = MakePayload(300);
+    const auto second = MakePayload(70000);
+    auto data = MakeServerFrame(0x02, first);
+    const auto continuation = MakeServerFrame(0x80, second);
+    data.insert(data.end(), continuation.begin(), continuation.end());
+    auto expected = first;
+    expected.insert(expected.end(), second.begin(), second.end());
+    for (const size_t split : {1, 2, 3, 4, 302, 303, 304, 305, 306, 20000})
+    {
+        MqttNetworkTransport::WebSocketFramer framer;
+        std::vector<uint8_t> payload;
+        std::vector<MqttNetworkTransport::WebSocketFramer::ControlFrame> controlFrames;
+        EXPECT_TRUE(framer.Decode(data.data(), split, payload, controlFrames));
+        EXPECT_TRUE(
+            framer.Decode(data.data() + split, data.size() - split, payload, controlFrames));
+        EXPECT_EQ(expected, payload) << "split at " << split;
+        EXPECT_TRUE(controlFrames.empty());
+    }
+}
+
+TEST(WebSocketFramerTests, DecodeControlFramesBetweenFragments) {
+    MqttNetworkTransport::WebSocketFramer framer;
+    auto data = MakeServerFrame(0x02, {1, 2});
+    const auto ping = MakeServerFrame(0x89, {'h', 'i'});
+    const auto continuation = MakeServerFrame(0x80, {3});
+    data.insert(data.end(), ping.begin(), ping.end());
+    data.insert(data.end(), continuation.begin(), continuation.end());
+    std::vector<uint8_t> payload;
+    std::vector<MqttNetworkTransport::WebSocketFramer::ControlFrame> controlFrames;
+    for (const auto byte : data)
+    { EXPECT_TRUE(framer.Decode(&byte, 1, payload, controlFrames)); }
+    EXPECT_EQ((std::vector<uint8_t>{1, 2, 3}), payload);
+    ASSERT_EQ(1u, controlFrames.size());
+    EXPECT_EQ(MqttNetworkTransport::WebSocketFramer::OPCODE_PING, controlFrames[0].opcode);
+    EXPECT_EQ((std::vector<uint8_t>{'h', 'i'}), controlFrames[0].payload);
+}
+
+TEST(WebSocketFramerTests, DecodeRejectsMalformedFrames) {
+    const std::vector<std::vector<uint8_t>> malformed{
+        {0x82, 0x81, 0, 0, 0, 0, 0},
+        {0xA2, 0x00},
+        {0xC2, 0x00},
+        {0x83, 0x00},
+        {0x80, 0x00},
+        {0x09, 0x00},
+        MakeServerFrame(0x89, MakePayload(126)),
+    };
+    for (const auto& data : malformed)
+    {
+        MqttNetworkTransport::WebSocketFramer framer;
+        std::vector<uint8_t> payload;
+        std::vector<MqttNetworkTransport::WebSocketFramer::ControlFrame> controlFrames;
+        EXPECT_FALSE(framer.Decode(data.data(), data.size(), payload, controlFrames));
+        const auto valid = MakeServerFrame(0x82, {1});
+        EXPECT_FALSE(framer.Decode(valid.data(), valid.size(), payload, controlFrames));
+    }
+}
+
+TEST(WebSocketFramerTests, DecodeRejectsDataFrameDuringFragmentedMessage) {
+    MqttNetworkTransport::WebSocketFramer framer;
+    auto data = MakeServerFrame(0x02, {1});
+    const auto second = MakeServerFrame(0x82, {2});
+    data.insert(data.end(), second.begin(), second.end());
+    std::vector<uint8_t> payload;
+    std::vector<MqttNetworkTransport::WebSocketFramer::ControlFrame> controlFrames;
+    EXPECT_FALSE(framer.Decode(data.data(), data.size(), payload, controlFrames));
+}
+
+TEST(WebSocketFramerTests, DecodeInflatesCompressedMessages) {
+    MqttNetworkTransport::WebSocketFramer framer;
+    std::vector<uint8_t> compressed;
+    bool finished = false;
+    framer.SetInflateDelegate(
+        [&compressed, &finished](const uint8_t* data, size_t size, bool final,
+                                 std::vector<uint8_t>& payload)
+        {
+            if (final)
+            {
+                finished = true;
+                payload.insert(payload.end(), compressed.rbegin(), compressed.rend());
+            } else
+            { compressed.insert(compressed.end(), data, data + size); }
+            return true;
+        });
+    auto data = MakeServerFrame(0x42, {1, 2});
+    const auto continuation = MakeServerFrame(0x80, {3});
+    data.insert(data.end(), continuation.begin(), continuation.end());
+    std::vector<uint8_t> payload;
+    std::vector<MqttNetworkTransport::WebSocketFramer::ControlFrame> controlFrames;
+    EXPECT_TRUE(framer.Decode(data.data(), data.size(), payload, controlFrames));
+    EXPECT_TRUE(finished);
+    EXPECT_EQ((std::vector<uint8_t>{3, 2, 1}), payload);
+}